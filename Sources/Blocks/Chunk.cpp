@@ -29,6 +29,26 @@
 const float Chunk::BLOCK_RENDER_SIZE = 0.5f;
 // The chunk radius is an approximation of a sphere that will enclose totally our cuboid. (Used for culling)
 const float Chunk::CHUNK_RADIUS = sqrt(((CHUNK_SIZE * BLOCK_RENDER_SIZE * 2.0f) * (CHUNK_SIZE * BLOCK_RENDER_SIZE * 2.0f)) * 2.0f) / 2.0f + ((BLOCK_RENDER_SIZE * 2.0f) * 2.0f);
+// Every bit of a row of active blocks
+const unsigned int FULL_ACTIVE_ROW = (1 << Chunk::CHUNK_SIZE) - 1;
+
+static_assert(Chunk::CHUNK_SIZE <= 16, "A row of active blocks has to fit in an unsigned short");
+
+// The blocks of a neighbor's row that hide the faces against it. A missing neighbor hides them all, one not set up yet none.
+static unsigned int GetNeighborRowX(const Chunk* pChunk, int y, int z)
+{
+	if (pChunk == nullptr)
+	{
+		return FULL_ACTIVE_ROW;
+	}
+
+	if (pChunk->IsSetup() == false)
+	{
+		return 0;
+	}
+
+	return pChunk->GetActiveRowX(y, z);
+}
 
 // Constructor, Destructor
 Chunk::Chunk(Renderer* pRenderer, ChunkManager* pChunkManager, CubbySettings* pVoxSettings) :
@@ -104,6 +124,7 @@ void Chunk::Initialize()
 
 	// Counters
 	m_numRebuilds = 0;
+	m_numBlockChanges = 0;
 
 	// Mesh
 	m_pMesh = nullptr;
@@ -117,6 +138,12 @@ void Chunk::Initialize()
 		m_color[i] = 0;
 		m_blockType[i] = BlockType::Default;
 	}
+	for (int i = 0; i < CHUNK_SIZE_SQUARED; ++i)
+	{
+		m_activeRowsX[i] = 0;
+		m_activeColumnsY[i] = 0;
+		m_activeColumnsZ[i] = 0;
+	}
 }
 
 // Creation and destruction
@@ -452,15 +479,27 @@ void Chunk::StopBatchUpdate()
 // Active
 bool Chunk::GetActive(int x, int y, int z) const
 {
-	unsigned color = m_color[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED];
-	unsigned int alpha = (color & 0xFF000000) >> 24;
-	
-	if (alpha == 0)
-	{
-		return false;
-	}
+	return (m_activeRowsX[y + z * CHUNK_SIZE] & (1 << x)) != 0;
+}
 
-	return true;
+unsigned int Chunk::GetActiveRowX(int y, int z) const
+{
+	return m_activeRowsX[y + z * CHUNK_SIZE];
+}
+
+unsigned int Chunk::GetActiveColumnY(int x, int z) const
+{
+	return m_activeColumnsY[x + z * CHUNK_SIZE];
+}
+
+unsigned int Chunk::GetActiveColumnZ(int x, int y) const
+{
+	return m_activeColumnsZ[x + y * CHUNK_SIZE];
+}
+
+unsigned int Chunk::GetNumBlockChanges() const
+{
+	return m_numBlockChanges;
 }
 
 // Inside chunk
@@ -585,10 +624,25 @@ void Chunk::SetColor(int x, int y, int z, unsigned int color, bool setBlockType)
 	if (isChanged)
 	{
 		m_chunkChangedDuringBatchUpdate = true;
+		m_numBlockChanges++;
 	}
 
 	m_color[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQUARED] = color;
 
+	// A block is active while its alpha isn't zero
+	if ((color & 0xFF000000) != 0)
+	{
+		m_activeRowsX[y + z * CHUNK_SIZE] |= static_cast<unsigned short>(1 << x);
+		m_activeColumnsY[x + z * CHUNK_SIZE] |= static_cast<unsigned short>(1 << y);
+		m_activeColumnsZ[x + y * CHUNK_SIZE] |= static_cast<unsigned short>(1 << z);
+	}
+	else
+	{
+		m_activeRowsX[y + z * CHUNK_SIZE] &= static_cast<unsigned short>(~(1 << x));
+		m_activeColumnsY[x + z * CHUNK_SIZE] &= static_cast<unsigned short>(~(1 << y));
+		m_activeColumnsZ[x + y * CHUNK_SIZE] &= static_cast<unsigned short>(~(1 << z));
+	}
+
 	if (setBlockType)
 	{
 		unsigned int blockB = (color & 0x00FF0000) >> 16;
@@ -627,97 +681,32 @@ bool Chunk::IsSurrounded() const
 
 void Chunk::UpdateWallFlags()
 {
-	// Figure out if we have any full walls(sides) and are a completely surrounded chunk
-	int xMinus = 0;
-	int xPlus = 0;
-	int yMinus = 0;
-	int yPlus = 0;
-	int zMinus = 0;
-	int zPlus = 0;
-
-	for (int y = 0; y < CHUNK_SIZE; ++y)
-	{
-		for (int z = 0; z < CHUNK_SIZE; ++z)
-		{
-			if (GetActive(0, y, z) == true)
-			{
-				xMinus++;
-			}
-
-			if (GetActive(CHUNK_SIZE - 1, y, z) == true)
-			{
-				xPlus++;
-			}
-		}
-	}
-
-	for (int x = 0; x < CHUNK_SIZE; ++x)
+	// Figure out if we have any full walls(sides) and are a completely surrounded chunk. A side along x is full when the
+	// end bit is set in every row, the other sides when every row lying on them is full.
+	unsigned int xSides = FULL_ACTIVE_ROW;
+	for (int i = 0; i < CHUNK_SIZE_SQUARED; ++i)
 	{
-		for (int z = 0; z < CHUNK_SIZE; ++z)
-		{
-			if (GetActive(x, 0, z) == true)
-			{
-				yMinus++;
-			}
-
-			if (GetActive(x, CHUNK_SIZE - 1, z) == true)
-			{
-				yPlus++;
-			}
-		}
+		xSides &= m_activeRowsX[i];
 	}
 
-	for (int x = 0; x < CHUNK_SIZE; ++x)
+	unsigned int yMinus = FULL_ACTIVE_ROW;
+	unsigned int yPlus = FULL_ACTIVE_ROW;
+	unsigned int zMinus = FULL_ACTIVE_ROW;
+	unsigned int zPlus = FULL_ACTIVE_ROW;
+	for (int i = 0; i < CHUNK_SIZE; ++i)
 	{
-		for (int y = 0; y < CHUNK_SIZE; ++y)
-		{
-			if (GetActive(x, y, 0) == true)
-			{
-				zMinus++;
-			}
-
-			if (GetActive(x, y, CHUNK_SIZE - 1) == true)
-			{
-				zPlus++;
-			}
-		}
+		yMinus &= m_activeRowsX[0 + i * CHUNK_SIZE];
+		yPlus &= m_activeRowsX[(CHUNK_SIZE - 1) + i * CHUNK_SIZE];
+		zMinus &= m_activeRowsX[i + 0 * CHUNK_SIZE];
+		zPlus &= m_activeRowsX[i + (CHUNK_SIZE - 1) * CHUNK_SIZE];
 	}
 
-	// Reset the wall flags first
-	m_xMinusFull = false;
-	m_xPlusFull = false;
-	m_yMinusFull = false;
-	m_yPlusFull = false;
-	m_zMinusFull = false;
-	m_zPlusFull = false;
-
-	// Set the flags to show if we have any sides completely full
-	int wallsize = CHUNK_SIZE * CHUNK_SIZE;
-
-	if (xMinus == wallsize)
-	{
-		m_xMinusFull = true;
-	}
-	if (xPlus == wallsize)
-	{
-		m_xPlusFull = true;
-	}
-	if (yMinus == wallsize)
-	{
-		m_yMinusFull = true;
-	}
-	if (yPlus == wallsize)
-	{
-		m_yPlusFull = true;
-	}
-	if (zMinus == wallsize)
-	{
-		m_zMinusFull = true;
-	}
-	if (zPlus == wallsize)
-	{
-		m_zPlusFull = true;
-	}
+	m_xMinusFull = (xSides & 1) != 0;
+	m_xPlusFull = (xSides & (1 << (CHUNK_SIZE - 1))) != 0;
+	m_yMinusFull = yMinus == FULL_ACTIVE_ROW;
+	m_yPlusFull = yPlus == FULL_ACTIVE_ROW;
+	m_zMinusFull = zMinus == FULL_ACTIVE_ROW;
+	m_zPlusFull = zPlus == FULL_ACTIVE_ROW;
 }
 
 bool Chunk::UpdateSurroundedFlag()
@@ -785,6 +774,47 @@ void Chunk::CreateMesh()
 		merged[j] = static_cast<int>(MergedSide::None);
 	}
 
+	// The neighbors are looked up once, rather than for every block on the edge
+	Chunk* pChunkXMinus = m_pChunkManager->GetChunk(m_gridX - 1, m_gridY, m_gridZ);
+	Chunk* pChunkXPlus = m_pChunkManager->GetChunk(m_gridX + 1, m_gridY, m_gridZ);
+	Chunk* pChunkYMinus = m_pChunkManager->GetChunk(m_gridX, m_gridY - 1, m_gridZ);
+	Chunk* pChunkYPlus = m_pChunkManager->GetChunk(m_gridX, m_gridY + 1, m_gridZ);
+	Chunk* pChunkZMinus = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ - 1);
+	Chunk* pChunkZPlus = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ + 1);
+
+	// For each row along x, a bit for every active block with that side open, and one for blocks with any side open
+	unsigned short facesXPositive[CHUNK_SIZE_SQUARED];
+	unsigned short facesXNegative[CHUNK_SIZE_SQUARED];
+	unsigned short facesYPositive[CHUNK_SIZE_SQUARED];
+	unsigned short facesYNegative[CHUNK_SIZE_SQUARED];
+	unsigned short facesZPositive[CHUNK_SIZE_SQUARED];
+	unsigned short facesZNegative[CHUNK_SIZE_SQUARED];
+	unsigned short facesAny[CHUNK_SIZE_SQUARED];
+
+	for (int z = 0; z < CHUNK_SIZE; ++z)
+	{
+		for (int y = 0; y < CHUNK_SIZE; ++y)
+		{
+			int row = y + z * CHUNK_SIZE;
+			unsigned int active = m_activeRowsX[row];
+
+			unsigned int xPlusEdge = (GetNeighborRowX(pChunkXPlus, y, z) & 1) << (CHUNK_SIZE - 1);
+			unsigned int xMinusEdge = GetNeighborRowX(pChunkXMinus, y, z) >> (CHUNK_SIZE - 1);
+			unsigned int above = y < CHUNK_SIZE - 1 ? m_activeRowsX[row + 1] : GetNeighborRowX(pChunkYPlus, 0, z);
+			unsigned int below = y > 0 ? m_activeRowsX[row - 1] : GetNeighborRowX(pChunkYMinus, CHUNK_SIZE - 1, z);
+			unsigned int front = z < CHUNK_SIZE - 1 ? m_activeRowsX[row + CHUNK_SIZE] : GetNeighborRowX(pChunkZPlus, y, 0);
+			unsigned int back = z > 0 ? m_activeRowsX[row - CHUNK_SIZE] : GetNeighborRowX(pChunkZMinus, y, CHUNK_SIZE - 1);
+
+			facesXPositive[row] = static_cast<unsigned short>(active & ~((active >> 1) | xPlusEdge));
+			facesXNegative[row] = static_cast<unsigned short>(active & ~((active << 1) | xMinusEdge));
+			facesYPositive[row] = static_cast<unsigned short>(active & ~above);
+			facesYNegative[row] = static_cast<unsigned short>(active & ~below);
+			facesZPositive[row] = static_cast<unsigned short>(active & ~front);
+			facesZNegative[row] = static_cast<unsigned short>(active & ~back);
+			facesAny[row] = facesXPositive[row] | facesXNegative[row] | facesYPositive[row] | facesYNegative[row] | facesZPositive[row] | facesZNegative[row];
+		}
+	}
+
 	float r = 1.0f;
 	float g = 1.0f;
 	float b = 1.0f;
@@ -792,11 +822,16 @@ void Chunk::CreateMesh()
 
 	for (int x = 0; x < CHUNK_SIZE; ++x)
 	{
+		unsigned int bit = 1 << x;
+
 		for (int y = 0; y < CHUNK_SIZE; ++y)
 		{
 			for (int z = 0; z < CHUNK_SIZE; ++z)
 			{
-				if (GetActive(x, y, z) == true)
+				int row = y + z * CHUNK_SIZE;
+
+				// Blocks covered on every side add nothing
+				if ((facesAny[row] & bit) != 0)
 				{
 					GetColor(x, y, z, &r, &g, &b, &a);
 
@@ -822,43 +857,28 @@ void Chunk::CreateMesh()
 					bool doZNegative = IsMergedZNegative(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE) == false;
 
 					// Front
-					if (doZPositive && (z == CHUNK_SIZE - 1 || z < CHUNK_SIZE - 1 && GetActive(x, y, z + 1) == false))
+					if (doZPositive && (facesZPositive[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (z == CHUNK_SIZE - 1)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ + 1);
-
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(x, y, 0) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p1, &p2, &p3, &p4, x, y, endX, endY, true, true, false, false);
 						}
 
-						if (addSide)
-						{
-							int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p1, &p2, &p3, &p4, x, y, endX, endY, true, true, false, false);
-							}
-
-							n1 = glm::vec3(0.0f, 0.0f, 1.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(0.0f, 0.0f, 1.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 
 					p1 = glm::vec3(x - BLOCK_RENDER_SIZE, y - BLOCK_RENDER_SIZE, z + BLOCK_RENDER_SIZE);
@@ -871,43 +891,28 @@ void Chunk::CreateMesh()
 					p8 = glm::vec3(x + BLOCK_RENDER_SIZE, y + BLOCK_RENDER_SIZE, z - BLOCK_RENDER_SIZE);
 
 					// Back
-					if (doZNegative && (z == 0 || z > 0 && GetActive(x, y, z - 1) == false))
+					if (doZNegative && (facesZNegative[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (z == 0)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX, m_gridY, m_gridZ - 1);
-							
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(x, y, CHUNK_SIZE - 1) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p5, &p8, &p7, x, y, endX, endY, false, true, false, false);
 						}
 
-						if (addSide)
-						{
-							int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p5, &p8, &p7, x, y, endX, endY, false, true, false, false);
-							}
-
-							n1 = glm::vec3(0.0f, 0.0f, -1.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(0.0f, 0.0f, -1.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 
 					p1 = glm::vec3(x - BLOCK_RENDER_SIZE, y - BLOCK_RENDER_SIZE, z + BLOCK_RENDER_SIZE);
@@ -920,43 +925,28 @@ void Chunk::CreateMesh()
 					p8 = glm::vec3(x + BLOCK_RENDER_SIZE, y + BLOCK_RENDER_SIZE, z - BLOCK_RENDER_SIZE);
 
 					// Right
-					if (doXPositive && (x == CHUNK_SIZE - 1 || x < CHUNK_SIZE - 1 && GetActive(x + 1, y, z) == false))
+					if (doXPositive && (facesXPositive[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (x == CHUNK_SIZE - 1)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX + 1, m_gridY, m_gridZ);
-							
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(0, y, z) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p5, &p2, &p3, &p8, z, y, endZ, endY, true, false, true, false);
 						}
 
-						if (addSide)
-						{
-							int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p5, &p2, &p3, &p8, z, y, endZ, endY, true, false, true, false);
-							}
-
-							n1 = glm::vec3(1.0f, 0.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(1.0f, 0.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 
 					p1 = glm::vec3(x - BLOCK_RENDER_SIZE, y - BLOCK_RENDER_SIZE, z + BLOCK_RENDER_SIZE);
@@ -969,43 +959,28 @@ void Chunk::CreateMesh()
 					p8 = glm::vec3(x + BLOCK_RENDER_SIZE, y + BLOCK_RENDER_SIZE, z - BLOCK_RENDER_SIZE);
 
 					// Left
-					if (doXNegative && (x == 0 || x > 0 && GetActive(x - 1, y, z) == false))
+					if (doXNegative && (facesXNegative[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (x == 0)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX - 1, m_gridY, m_gridZ);
-							
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(CHUNK_SIZE - 1, y, z) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p1, &p4, &p7, z, y, endZ, endY, false, false, true, false);
 						}
 
-						if (addSide)
-						{
-							int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endY = (y / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p1, &p4, &p7, z, y, endZ, endY, false, false, true, false);
-							}
-
-							n1 = glm::vec3(-1.0f, 0.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(-1.0f, 0.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 
 					p1 = glm::vec3(x - BLOCK_RENDER_SIZE, y - BLOCK_RENDER_SIZE, z + BLOCK_RENDER_SIZE);
@@ -1018,43 +993,28 @@ void Chunk::CreateMesh()
 					p8 = glm::vec3(x + BLOCK_RENDER_SIZE, y + BLOCK_RENDER_SIZE, z - BLOCK_RENDER_SIZE);
 
 					// Top
-					if (doYPositive && (y == CHUNK_SIZE - 1 || y < CHUNK_SIZE - 1 && GetActive(x, y + 1, z) == false))
+					if (doYPositive && (facesYPositive[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (y == CHUNK_SIZE - 1)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX, m_gridY + 1, m_gridZ);
-							
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(x, 0, z) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p7, &p8, &p3, &p4, x, z, endX, endZ, true, false, false, true);
 						}
 
-						if (addSide)
-						{
-							int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p7, &p8, &p3, &p4, x, z, endX, endZ, true, false, false, true);
-							}
-
-							n1 = glm::vec3(0.0f, 1.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(0.0f, 1.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 
 					p1 = glm::vec3(x - BLOCK_RENDER_SIZE, y - BLOCK_RENDER_SIZE, z + BLOCK_RENDER_SIZE);
@@ -1067,43 +1027,28 @@ void Chunk::CreateMesh()
 					p8 = glm::vec3(x + BLOCK_RENDER_SIZE, y + BLOCK_RENDER_SIZE, z - BLOCK_RENDER_SIZE);
 
 					// Bottom
-					if (doYNegative && (y == 0 || y > 0 && GetActive(x, y - 1, z) == false))
+					if (doYNegative && (facesYNegative[row] & bit) != 0)
 					{
-						bool addSide = true;
+						int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
+						int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
 
-						if (y == 0)
+						if (m_pChunkManager->GetFaceMerging())
 						{
-							Chunk* pChunk = m_pChunkManager->GetChunk(m_gridX, m_gridY - 1, m_gridZ);
-						
-							if (pChunk == nullptr || pChunk->IsSetup())
-							{
-								addSide = pChunk != nullptr && (pChunk->GetActive(x, CHUNK_SIZE - 1, z) == false);
-							}
+							UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p5, &p2, &p1, x, z, endX, endZ, false, false, false, true);
 						}
 
-						if (addSide)
-						{
-							int endX = (x / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-							int endZ = (z / CHUNK_SIZE) * CHUNK_SIZE + CHUNK_SIZE;
-
-							if (m_pChunkManager->GetFaceMerging())
-							{
-								UpdateMergedSide(merged, x, y, z, CHUNK_SIZE, CHUNK_SIZE, &p6, &p5, &p2, &p1, x, z, endX, endZ, false, false, false, true);
-							}
-
-							n1 = glm::vec3(0.0f, -1.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
-							m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
-						}
+						n1 = glm::vec3(0.0f, -1.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, m_pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, m_pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, m_pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, m_pMesh);
+						m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, m_pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, m_pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, m_pMesh);
 					}
 				}
 			}
@@ -1604,6 +1549,34 @@ void Chunk::Render()
     */
 }
 
+void Chunk::SubmitRenderPacket(unsigned int passMask, bool isTransparent, const glm::vec3& center) const
+{
+	TriangleMesh* pMeshToUse = m_pMesh;
+
+	if (m_pCachedMesh != nullptr)
+	{
+		pMeshToUse = m_pCachedMesh;
+	}
+
+	if (pMeshToUse == nullptr)
+	{
+		return;
+	}
+
+	RenderPacket packet;
+	packet.m_staticBufferID = pMeshToUse->staticMeshID;
+	packet.m_materialID = pMeshToUse->materialID;
+	packet.m_shaderID = -1;
+	packet.m_passMask = passMask;
+	packet.m_worldMatrix.SetTranslation(m_position);
+	packet.m_isTransparent = isTransparent;
+	packet.m_isShadowReceiver = true;
+	packet.m_center = center;
+	packet.m_radius = CHUNK_RADIUS;
+
+	m_pRenderer->SubmitRenderPacket(packet);
+}
+
 void Chunk::RenderDebug() const
 {
 	float length = (CHUNK_SIZE * BLOCK_RENDER_SIZE) - 0.05f;
@@ -97,6 +97,12 @@ public:
 
 	// Active
 	bool GetActive(int x, int y, int z) const;
+	// One bit per block along the axis, bit x of the row at (y, z), bit y of the column at (x, z) and bit z of the column at (x, y)
+	unsigned int GetActiveRowX(int y, int z) const;
+	unsigned int GetActiveColumnY(int x, int z) const;
+	unsigned int GetActiveColumnZ(int x, int y) const;
+	// Counts the blocks changed to a different color, so copies of the blocks can tell when they are stale
+	unsigned int GetNumBlockChanges() const;
 
 	// Inside chunk
 	bool IsInsideChunk(glm::vec3 pos) const;
@@ -138,6 +144,7 @@ public:
 
 	// Rendering
 	void Render();
+	void SubmitRenderPacket(unsigned int passMask, bool isTransparent, const glm::vec3& center) const;
 	void RenderDebug() const;
 	void Render2D(Camera* pCamera, unsigned int viewport, unsigned int font) const;
 
@@ -191,6 +198,7 @@ private:
 
 	// Counters
 	int m_numRebuilds;
+	unsigned int m_numBlockChanges;
 
 	// Flags for empty chunk and completely surrounded
 	bool m_emptyChunk;
@@ -207,6 +215,12 @@ private:
 	// The blocks color data
 	unsigned int* m_color;
 
+	// Which blocks are active, kept with the colors by SetColor. The rows along x are the 4096 bit mask of the chunk, the
+	// columns along y and z hold the same bits turned, so any line of blocks through the chunk is a single read.
+	unsigned short m_activeRowsX[CHUNK_SIZE_SQUARED];
+	unsigned short m_activeColumnsY[CHUNK_SIZE_SQUARED];
+	unsigned short m_activeColumnsZ[CHUNK_SIZE_SQUARED];
+
 	// Block type
 	BlockType *m_blockType;
 
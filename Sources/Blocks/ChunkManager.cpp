@@ -17,15 +17,19 @@
 
 #include <Maths/3DMaths.h>
 #include <Models/QubicleBinaryManager.h>
+#include <NPC/NavigationGraph.h>
 #include <Renderer/Renderer.h>
 #include <Utils/Random.h>
 
 #include "BiomeManager.h"
 #include "ChunkManager.h"
 
+const float ChunkManager::WATER_RENDER_DISTANCE = 500.0f;
+
 // Constructor, Destructor
 ChunkManager::ChunkManager(Renderer* pRenderer, CubbySettings* pCubbySettings, QubicleBinaryManager* pQubicleBinaryManager) :
-	m_pRenderer(pRenderer), m_pPlayer(nullptr), m_pCubbySettings(pCubbySettings), m_pQubicleBinaryManager(pQubicleBinaryManager)
+	m_pRenderer(pRenderer), m_pPlayer(nullptr), m_pCubbySettings(pCubbySettings), m_pQubicleBinaryManager(pQubicleBinaryManager),
+	m_pNavigationGraph(nullptr)
 {
 	// Chunk material
 	m_chunkMaterialID = -1;
@@ -67,6 +71,7 @@ ChunkManager::ChunkManager(Renderer* pRenderer, CubbySettings* pCubbySettings, Q
 	// Chunk counters
 	m_numChunksLoaded = 0;
 	m_numChunksRender = 0;
+	m_chunkLoadVersion = 0;
 
 	// Threading
 	m_updateThreadActive = true;
@@ -131,6 +136,11 @@ void ChunkManager::SetItemManager(ItemManager* pItemManager)
 	m_pItemManager = pItemManager;
 }
 
+void ChunkManager::SetNavigationGraph(NavigationGraph* pNavigationGraph)
+{
+	m_pNavigationGraph = pNavigationGraph;
+}
+
 // Scenery manager pointer
 void ChunkManager::SetSceneryManager(SceneryManager* pSceneryManager)
 {
@@ -166,6 +176,11 @@ int ChunkManager::GetNumChunksRender() const
 	return m_numChunksRender;
 }
 
+unsigned int ChunkManager::GetChunkLoadVersion() const
+{
+	return m_chunkLoadVersion;
+}
+
 // Loader radius
 void ChunkManager::SetLoaderRadius(float radius)
 {
@@ -220,6 +235,13 @@ void ChunkManager::CreateNewChunk(int x, int y, int z)
 	pNewChunk->SetCreated(true);
 
 	UpdateChunkNeighbours(pNewChunk, x, y, z);
+
+	m_chunkLoadVersion++;
+
+	if (m_pNavigationGraph)
+	{
+		m_pNavigationGraph->QueueChunk(x, y, z);
+	}
 }
 
 void ChunkManager::UpdateChunkNeighbours(Chunk* pChunk, int x, int y, int z)
@@ -400,9 +422,17 @@ void ChunkManager::UnloadChunk(Chunk* pChunk)
 
 	m_updateThreadFlagLock.unlock();
 
+	// The chunk is out of the map, the navigation graph drops it when it finds it missing
+	if (m_pNavigationGraph)
+	{
+		m_pNavigationGraph->QueueChunk(coordKeys.x, coordKeys.y, coordKeys.z);
+	}
+
 	// Unload and delete
 	pChunk->Unload();
 	delete pChunk;
+
+	m_chunkLoadVersion++;
 }
 
 // Getting chunk and positional information
@@ -914,11 +944,15 @@ QubicleBinary* ChunkManager::ImportQubicleBinary(QubicleBinary* qubicleBinaryFil
 
 QubicleBinary* ChunkManager::ImportQubicleBinary(const char* fileName, glm::vec3 position, QubicleImportDirection direction)
 {
-	QubicleBinary* qubicleBinaryFile = m_pQubicleBinaryManager->GetQubicleBinaryFile(fileName, true);
+	// The voxel data is only read from, so the cached model doesn't need to be refreshed
+	QubicleBinary* qubicleBinaryFile = m_pQubicleBinaryManager->GetQubicleBinaryFile(fileName, false);
 	
 	if (qubicleBinaryFile != nullptr)
 	{
-		return ImportQubicleBinary(qubicleBinaryFile, position, direction);
+		ImportQubicleBinary(qubicleBinaryFile, position, direction);
+		m_pQubicleBinaryManager->ReleaseQubicleBinaryFile(qubicleBinaryFile);
+
+		return qubicleBinaryFile;
 	}
 
 	return nullptr;
@@ -1397,6 +1431,11 @@ void ChunkManager::UpdatingChunksThread()
 			pChunk->CompleteMesh();
 			pChunk->UndoCachedMesh();
 
+			if (m_pNavigationGraph)
+			{
+				m_pNavigationGraph->QueueChunk(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ());
+			}
+
 			numRebuildChunks++;
 		}
 
@@ -1418,13 +1457,55 @@ void ChunkManager::UpdatingChunksThread()
 }
 
 // Rendering
-void ChunkManager::Render(bool shadowRender)
+void ChunkManager::SubmitRenderPackets()
 {
-	if (shadowRender == false)
+	// Shadows and reflections draw every chunk, the normal pass culls them against the view
+	unsigned int passMask = RenderQueue::GetPassBit(RenderPass::Shadow) | RenderQueue::GetPassBit(RenderPass::Reflection) | RenderQueue::GetPassBit(RenderPass::Normal);
+
+	m_ChunkMapMutexLock.lock();
+
+	for (auto iter = m_chunksMap.begin(); iter != m_chunksMap.end(); ++iter)
 	{
-		m_numChunksRender = 0;
+		Chunk* pChunk = iter->second;
+
+		if (pChunk != nullptr && pChunk->IsCreated() && pChunk->IsSetup() && pChunk->IsUnloading() == false && pChunk->IsEmpty() == false && pChunk->IsSurrounded() == false)
+		{
+			glm::vec3 chunkCenter = pChunk->GetPosition() + glm::vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
+
+			// Fog
+			float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - chunkCenter);
+
+			if (toCamera > GetLoaderRadius() + (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 5.0f))
+			{
+				continue;
+			}
+
+			bool isFogged = toCamera > GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 3.0f;
+
+			pChunk->SubmitRenderPacket(passMask, isFogged, chunkCenter);
+		}
 	}
 
+	m_ChunkMapMutexLock.unlock();
+}
+
+void ChunkManager::Render(RenderPass pass)
+{
+	int numRendered = RenderPackets(pass, nullptr);
+
+	if (pass == RenderPass::Normal)
+	{
+		m_numChunksRender = numRendered;
+	}
+}
+
+int ChunkManager::Render(RenderPass pass, const RenderCullBox& cullBox)
+{
+	return RenderPackets(pass, &cullBox);
+}
+
+int ChunkManager::RenderPackets(RenderPass pass, const RenderCullBox* pCullBox)
+{
 	m_pRenderer->StartMeshRender();
 
 	// Store cull mode
@@ -1442,44 +1523,24 @@ void ChunkManager::Render(bool shadowRender)
 
 	m_pRenderer->PushMatrix();
 
-	m_ChunkMapMutexLock.lock();
-
-	for (auto iter = m_chunksMap.begin(); iter != m_chunksMap.end(); ++iter)
+	int numRendered;
+	if (pCullBox != nullptr)
 	{
-		Chunk* pChunk = iter->second;
-
-		if (pChunk != nullptr && pChunk->IsCreated() && pChunk->IsSetup() && pChunk->IsUnloading() == false && pChunk->IsEmpty() == false && pChunk->IsSurrounded() == false)
-		{
-			glm::vec3 chunkCenter = pChunk->GetPosition() + glm::vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
-
-			if (shadowRender == true || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), chunkCenter, Chunk::CHUNK_RADIUS))
-			{
-				// Fog
-				glm::vec3 fogChunkCenter = pChunk->GetPosition() + glm::vec3((Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE, (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE) - Chunk::BLOCK_RENDER_SIZE);
-				float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - fogChunkCenter);
-			
-				if (toCamera > GetLoaderRadius() + (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 5.0f))
-				{
-					continue;
-				}
-				if (toCamera > GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 3.0f)
-				{
-					m_pRenderer->EnableTransparency(BlendFunction::SRC_ALPHA, BlendFunction::ONE_MINUS_SRC_ALPHA);
-				}
-
-				pChunk->Render();
-
-				if (shadowRender == false)
-				{
-					m_numChunksRender++;
-				}
-
-				m_pRenderer->DisableTransparency();
-			}
-		}
+		numRendered = m_pRenderer->RenderQueuePass(pass, *pCullBox);
+	}
+	else if (pass == RenderPass::Normal)
+	{
+		numRendered = m_pRenderer->RenderQueuePass(pass, CubbyGame::GetInstance()->GetDefaultViewport());
+	}
+	else if (pass == RenderPass::Reflection)
+	{
+		// The reflection is drawn mirrored in the water, only the chunks seen in the water need drawing
+		numRendered = m_pRenderer->RenderQueueMirroredPass(pass, CubbyGame::GetInstance()->GetDefaultViewport(), m_waterHeight);
+	}
+	else
+	{
+		numRendered = m_pRenderer->RenderQueuePass(pass, -1);
 	}
-
-	m_ChunkMapMutexLock.unlock();
 
 	m_pRenderer->PopMatrix();
 
@@ -1487,6 +1548,8 @@ void ChunkManager::Render(bool shadowRender)
 	m_pRenderer->SetCullMode(cullMode);
 
 	m_pRenderer->EndMeshRender();
+
+	return numRendered;
 }
 
 void ChunkManager::RenderWater() const
@@ -1495,7 +1558,7 @@ void ChunkManager::RenderWater() const
 
 	m_pRenderer->EnableMaterial(m_chunkMaterialID);
 
-	float waterDistance = 500.0f;
+	float waterDistance = WATER_RENDER_DISTANCE;
 
 	m_pRenderer->SetCullMode(CullMode::NOCULL);
 
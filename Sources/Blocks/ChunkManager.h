@@ -13,6 +13,7 @@
 #ifndef CUBBY_CHUNK_MANAGER_H
 #define CUBBY_CHUNK_MANAGER_H
 
+#include <atomic>
 #include <map>
 #include <tinythread/tinythread.h>
 
@@ -31,6 +32,7 @@ class ItemManager;
 class SceneryManager;
 class QubicleBinaryManager;
 class BiomeManager;
+class NavigationGraph;
 
 struct CubbySettings;
 
@@ -164,6 +166,7 @@ public:
 	void SetEnemyManager(EnemyManager* pEnemyManager);
 	void SetBlockParticleManager(BlockParticleManager* pBlockParticleManager);
 	void SetItemManager(ItemManager* pItemManager);
+	void SetNavigationGraph(NavigationGraph* pNavigationGraph);
 
 	// Scenery manager pointer
 	void SetSceneryManager(SceneryManager* pSceneryManager);
@@ -180,6 +183,8 @@ public:
 	// Chunk counters
 	int GetNumChunksLoaded() const;
 	int GetNumChunksRender() const;
+	// Changes whenever a chunk is loaded or unloaded, so whatever depends on which chunks are loaded only looks again then
+	unsigned int GetChunkLoadVersion() const;
 
 	// Loader radius
 	void SetLoaderRadius(float radius);
@@ -229,6 +234,8 @@ public:
 	void SetWaterHeight(float height);
 	float GetWaterHeight() const;
 	bool IsUnderWater(glm::vec3 position);
+	// Half the size of the water plane, which is drawn around the player
+	static const float WATER_RENDER_DISTANCE;
 
 	// Rendering modes
 	void SetWireframeRender(bool wireframe);
@@ -240,13 +247,18 @@ public:
 	static void _UpdatingChunksThread(void* pData);
 	void UpdatingChunksThread();
 
-	// Rendering
-	void Render(bool shadowRender);
+	// Rendering, the chunks are submitted to the render queue once a frame and then drawn by each pass
+	void SubmitRenderPackets();
+	void Render(RenderPass pass);
+	// Only the chunks overlapping the box, returns how many were drawn
+	int Render(RenderPass pass, const RenderCullBox& cullBox);
 	void RenderWater() const;
 	void RenderDebug();
 	void Render2D(Camera* pCamera, unsigned int viewport, unsigned int font);
 
 private:
+	int RenderPackets(RenderPass pass, const RenderCullBox* pCullBox);
+
 	Renderer* m_pRenderer;
 	Player* m_pPlayer;
 	SceneryManager* m_pSceneryManager;
@@ -257,6 +269,7 @@ private:
 	BlockParticleManager* m_pBlockParticleManager;
 	EnemyManager* m_pEnemyManager;
 	NPCManager* m_pNPCManager;
+	NavigationGraph* m_pNavigationGraph;
 
 	// Chunk Material
 	unsigned int m_chunkMaterialID;
@@ -288,6 +301,7 @@ private:
 	// Chunk counters
 	int m_numChunksLoaded;
 	int m_numChunksRender;
+	std::atomic<unsigned int> m_chunkLoadVersion;
 
 	// Threading
 	tthread::thread* m_pUpdatingChunksThread;
@@ -0,0 +1,366 @@
+/*************************************************************************
+> File Name: VoxelCollision.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Collision of moving boxes and points against the blocks, shared by
+> 	 the player, NPCs, enemies, items and projectiles. Only the blocks a
+> 	 box overlaps are read, through the few chunks they are in.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Chunk.h"
+#include "ChunkManager.h"
+#include "VoxelCollision.h"
+
+// Half block steps FindClosestFloor looked down before giving up
+const int FLOOR_SEARCH_STEPS = 100;
+
+// Gap in blocks left between a box and the face it stops against
+const float COLLISION_SKIN = 0.001f;
+
+static int GetChunkCoordinate(int blockCoordinate)
+{
+	return blockCoordinate >= 0 ? blockCoordinate / Chunk::CHUNK_SIZE : (blockCoordinate + 1) / Chunk::CHUNK_SIZE - 1;
+}
+
+// Constructor, Destructor
+VoxelCollision::VoxelCollision(ChunkManager* pChunkManager) :
+	m_pChunkManager(pChunkManager), m_numCachedChunks(0), m_nextCachedChunk(0)
+{
+
+}
+
+VoxelCollision::~VoxelCollision()
+{
+
+}
+
+int VoxelCollision::GetBlockCoordinate(float value)
+{
+	return static_cast<int>(std::floor((value + Chunk::BLOCK_RENDER_SIZE) / (Chunk::BLOCK_RENDER_SIZE * 2.0f)));
+}
+
+Chunk* VoxelCollision::GetChunk(int chunkX, int chunkY, int chunkZ)
+{
+	for (int i = 0; i < m_numCachedChunks; ++i)
+	{
+		const CachedChunk& cachedChunk = m_cachedChunks[i];
+
+		if (cachedChunk.m_chunkX == chunkX && cachedChunk.m_chunkY == chunkY && cachedChunk.m_chunkZ == chunkZ)
+		{
+			return cachedChunk.m_pChunk;
+		}
+	}
+
+	CachedChunk* pCachedChunk;
+	if (m_numCachedChunks < NUM_CACHED_CHUNKS)
+	{
+		pCachedChunk = &m_cachedChunks[m_numCachedChunks];
+		m_numCachedChunks++;
+	}
+	else
+	{
+		pCachedChunk = &m_cachedChunks[m_nextCachedChunk];
+		m_nextCachedChunk = (m_nextCachedChunk + 1) % NUM_CACHED_CHUNKS;
+	}
+
+	pCachedChunk->m_chunkX = chunkX;
+	pCachedChunk->m_chunkY = chunkY;
+	pCachedChunk->m_chunkZ = chunkZ;
+	pCachedChunk->m_pChunk = m_pChunkManager->GetChunk(chunkX, chunkY, chunkZ);
+
+	return pCachedChunk->m_pChunk;
+}
+
+bool VoxelCollision::IsBlockSolid(int blockX, int blockY, int blockZ, bool* pIsLoaded)
+{
+	int chunkX = GetChunkCoordinate(blockX);
+	int chunkY = GetChunkCoordinate(blockY);
+	int chunkZ = GetChunkCoordinate(blockZ);
+
+	Chunk* pChunk = GetChunk(chunkX, chunkY, chunkZ);
+
+	if (pIsLoaded != nullptr)
+	{
+		*pIsLoaded = pChunk != nullptr && pChunk->IsSetup();
+	}
+
+	if (pChunk == nullptr)
+	{
+		return false;
+	}
+
+	return pChunk->GetActive(blockX - chunkX * Chunk::CHUNK_SIZE, blockY - chunkY * Chunk::CHUNK_SIZE, blockZ - chunkZ * Chunk::CHUNK_SIZE);
+}
+
+bool VoxelCollision::IsRowSolid(int minBlockX, int maxBlockX, int blockY, int blockZ, bool* pIsLoaded)
+{
+	int chunkY = GetChunkCoordinate(blockY);
+	int chunkZ = GetChunkCoordinate(blockZ);
+
+	bool isSolid = false;
+	*pIsLoaded = true;
+
+	for (int chunkX = GetChunkCoordinate(minBlockX); chunkX <= GetChunkCoordinate(maxBlockX); ++chunkX)
+	{
+		Chunk* pChunk = GetChunk(chunkX, chunkY, chunkZ);
+
+		if (pChunk == nullptr || pChunk->IsSetup() == false)
+		{
+			*pIsLoaded = false;
+			continue;
+		}
+
+		int firstX = std::max(minBlockX - chunkX * Chunk::CHUNK_SIZE, 0);
+		int lastX = std::min(maxBlockX - chunkX * Chunk::CHUNK_SIZE, Chunk::CHUNK_SIZE - 1);
+		unsigned int range = ((2u << lastX) - 1) & ~((1u << firstX) - 1);
+
+		if ((pChunk->GetActiveRowX(blockY - chunkY * Chunk::CHUNK_SIZE, blockZ - chunkZ * Chunk::CHUNK_SIZE) & range) != 0)
+		{
+			isSolid = true;
+		}
+	}
+
+	return isSolid;
+}
+
+bool VoxelCollision::HasFloor(const glm::vec3& position)
+{
+	int blockX = GetBlockCoordinate(position.x);
+	int blockZ = GetBlockCoordinate(position.z);
+	int chunkX = GetChunkCoordinate(blockX);
+	int chunkZ = GetChunkCoordinate(blockZ);
+
+	// The blocks the half block steps of FindClosestFloor pass through, each column of a chunk is read at once
+	int topBlockY = GetBlockCoordinate(position.y - Chunk::BLOCK_RENDER_SIZE);
+	int bottomBlockY = GetBlockCoordinate(position.y - Chunk::BLOCK_RENDER_SIZE * (FLOOR_SEARCH_STEPS - 1));
+
+	for (int chunkY = GetChunkCoordinate(topBlockY); chunkY >= GetChunkCoordinate(bottomBlockY); --chunkY)
+	{
+		Chunk* pChunk = GetChunk(chunkX, chunkY, chunkZ);
+
+		if (pChunk == nullptr || pChunk->IsSetup() == false || pChunk->NeedsRebuild())
+		{
+			continue;
+		}
+
+		int firstY = std::max(bottomBlockY - chunkY * Chunk::CHUNK_SIZE, 0);
+		int lastY = std::min(topBlockY - chunkY * Chunk::CHUNK_SIZE, Chunk::CHUNK_SIZE - 1);
+		unsigned int range = ((2u << lastY) - 1) & ~((1u << firstY) - 1);
+
+		if ((pChunk->GetActiveColumnY(blockX - chunkX * Chunk::CHUNK_SIZE, blockZ - chunkZ * Chunk::CHUNK_SIZE) & range) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool VoxelCollision::IsBoxSolid(const int* minBlock, const int* maxBlock, bool* pIsLoaded)
+{
+	bool isSolid = false;
+	*pIsLoaded = true;
+
+	for (int blockY = minBlock[1]; blockY <= maxBlock[1]; ++blockY)
+	{
+		for (int blockZ = minBlock[2]; blockZ <= maxBlock[2]; ++blockZ)
+		{
+			bool isLoaded;
+			isSolid |= IsRowSolid(minBlock[0], maxBlock[0], blockY, blockZ, &isLoaded);
+			*pIsLoaded &= isLoaded;
+		}
+	}
+
+	return isSolid;
+}
+
+bool VoxelCollision::CheckCharacter(const glm::vec3& positionCheck, const glm::vec3& previousPosition, float radius, glm::vec3* pNormal, glm::vec3* pMovement, bool* pStepUpBlock)
+{
+	*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	if (pStepUpBlock != nullptr)
+	{
+		*pStepUpBlock = false;
+	}
+
+	if (HasFloor(positionCheck) == false)
+	{
+		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
+		return true;
+	}
+
+	// In blocks, the box touches a block when it is within half a block plus the radius of the block's center on an axis
+	const float blockSize = Chunk::BLOCK_RENDER_SIZE * 2.0f;
+	float reach = (Chunk::BLOCK_RENDER_SIZE + radius) / blockSize;
+	glm::vec3 position = previousPosition / blockSize;
+	glm::vec3 target = positionCheck / blockSize;
+
+	int stepUpBlockY = GetBlockCoordinate(positionCheck.y);
+	bool worldCollision = false;
+
+	// The box is swept from the previous position to the checked one an axis at a time, falling and landing first, and each
+	// axis only reads the layers of blocks its leading face passes into. The first solid layer stops it against that face.
+	static const int SWEEP_AXES[3] = { 1, 0, 2 };
+	for (int i = 0; i < 3; ++i)
+	{
+		int axis = SWEEP_AXES[i];
+		float distance = target[axis] - position[axis];
+
+		if (distance == 0.0f)
+		{
+			continue;
+		}
+
+		// Blocks the box overlaps, a block it only touches the face of is not overlapped
+		int minBlock[3];
+		int maxBlock[3];
+		for (int boxAxis = 0; boxAxis < 3; ++boxAxis)
+		{
+			minBlock[boxAxis] = static_cast<int>(std::floor(position[boxAxis] - reach)) + 1;
+			maxBlock[boxAxis] = static_cast<int>(std::ceil(position[boxAxis] + reach)) - 1;
+		}
+
+		// The layers the leading face enters, blocks the box was already in are left alone
+		int step = distance > 0.0f ? 1 : -1;
+		int firstLayer = step > 0 ? static_cast<int>(std::ceil(position[axis] + reach)) : static_cast<int>(std::floor(position[axis] - reach));
+		int lastLayer = step > 0 ? static_cast<int>(std::ceil(target[axis] + reach)) - 1 : static_cast<int>(std::floor(target[axis] - reach)) + 1;
+
+		for (int layer = firstLayer; layer * step <= lastLayer * step; layer += step)
+		{
+			minBlock[axis] = layer;
+			maxBlock[axis] = layer;
+
+			bool isLoaded;
+			bool isSolid = IsBoxSolid(minBlock, maxBlock, &isLoaded);
+
+			// Nothing moves into chunks that are not there yet
+			if (isLoaded == false)
+			{
+				*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
+				return true;
+			}
+
+			if (isSolid == false)
+			{
+				continue;
+			}
+
+			// Walking into blocks that all have room above them, at the height of the checked position
+			if (pStepUpBlock != nullptr && axis != 1 && stepUpBlockY >= minBlock[1] && stepUpBlockY <= maxBlock[1])
+			{
+				bool canAllStepUp = false;
+				bool firstStepUp = true;
+
+				for (int blockX = minBlock[0]; blockX <= maxBlock[0]; ++blockX)
+				{
+					for (int blockZ = minBlock[2]; blockZ <= maxBlock[2]; ++blockZ)
+					{
+						if (IsBlockSolid(blockX, stepUpBlockY, blockZ) == false)
+						{
+							continue;
+						}
+
+						if (IsBlockSolid(blockX, stepUpBlockY + 1, blockZ) == false && IsBlockSolid(blockX, stepUpBlockY + 2, blockZ) == false)
+						{
+							canAllStepUp = canAllStepUp || firstStepUp;
+						}
+						else
+						{
+							canAllStepUp = false;
+						}
+
+						firstStepUp = false;
+					}
+				}
+
+				*pStepUpBlock = canAllStepUp;
+			}
+
+			// Against the face, with a little room so the next sweep along it doesn't catch the block
+			float contact = layer - step * (reach + COLLISION_SKIN);
+			target[axis] = step > 0 ? std::max(position[axis], contact) : std::min(position[axis], contact);
+
+			// The movement slides along the face
+			(*pNormal)[axis] = (*pMovement)[axis];
+			(*pMovement)[axis] = 0.0f;
+
+			worldCollision = true;
+
+			break;
+		}
+
+		position[axis] = target[axis];
+	}
+
+	return worldCollision;
+}
+
+bool VoxelCollision::SweepPoint(const glm::vec3& start, const glm::vec3& end, float* pFraction)
+{
+	int block[3] = { GetBlockCoordinate(start.x), GetBlockCoordinate(start.y), GetBlockCoordinate(start.z) };
+
+	if (IsBlockSolid(block[0], block[1], block[2]))
+	{
+		*pFraction = 0.0f;
+		return true;
+	}
+
+	glm::vec3 segment = end - start;
+
+	// Fraction of the segment to the next block boundary on each axis, and between boundaries
+	int step[3];
+	float next[3];
+	float delta[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		step[axis] = segment[axis] < 0.0f ? -1 : 1;
+
+		if (segment[axis] == 0.0f)
+		{
+			next[axis] = std::numeric_limits<float>::max();
+			delta[axis] = std::numeric_limits<float>::max();
+			continue;
+		}
+
+		float boundary = (block[axis] + step[axis] * 0.5f) * (Chunk::BLOCK_RENDER_SIZE * 2.0f);
+		next[axis] = (boundary - start[axis]) / segment[axis];
+		delta[axis] = (Chunk::BLOCK_RENDER_SIZE * 2.0f) / std::abs(segment[axis]);
+	}
+
+	for (;;)
+	{
+		int axis = 0;
+		if (next[1] < next[axis])
+		{
+			axis = 1;
+		}
+		if (next[2] < next[axis])
+		{
+			axis = 2;
+		}
+
+		float fraction = next[axis];
+		if (fraction > 1.0f)
+		{
+			return false;
+		}
+
+		block[axis] += step[axis];
+		next[axis] += delta[axis];
+
+		if (IsBlockSolid(block[0], block[1], block[2]))
+		{
+			*pFraction = fraction;
+			return true;
+		}
+	}
+}
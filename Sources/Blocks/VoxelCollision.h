@@ -0,0 +1,76 @@
+/*************************************************************************
+> File Name: VoxelCollision.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Collision of moving boxes and points against the blocks, shared by
+> 	 the player, NPCs, enemies, items and projectiles. Only the blocks a
+> 	 box overlaps are read, through the few chunks they are in.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_VOXEL_COLLISION_H
+#define CUBBY_VOXEL_COLLISION_H
+
+#include <glm/vec3.hpp>
+
+// Forward declaration
+class Chunk;
+class ChunkManager;
+
+// Made on the stack for each check, so the worker threads never share one
+class VoxelCollision
+{
+public:
+	// Constructor, Destructor
+	VoxelCollision(ChunkManager* pChunkManager);
+	~VoxelCollision();
+
+	// Block containing the world position on one axis
+	static int GetBlockCoordinate(float value);
+
+	// pIsLoaded is set to whether the block's chunk exists and is set up
+	bool IsBlockSolid(int blockX, int blockY, int blockZ, bool* pIsLoaded = nullptr);
+
+	// Whether there is a block in a built chunk below the position, close enough to land on
+	bool HasFloor(const glm::vec3& position);
+
+	// Sweeps the box of the radius from previousPosition to positionCheck one axis at a time, vertical first, reading only the
+	// layers of blocks its leading face passes into, so a fast box can't pass through a wall. An axis that hits a solid layer
+	// stops against its face and that axis of pMovement is zeroed, so the movement slides along it. Entering a chunk that is
+	// not set up, or having no floor below, stops the movement. pStepUpBlock, when given, is set to whether every block the
+	// box walked into at the height of positionCheck has two free blocks above it.
+	// Returns false and leaves pMovement as it was when nothing is hit.
+	bool CheckCharacter(const glm::vec3& positionCheck, const glm::vec3& previousPosition, float radius, glm::vec3* pNormal, glm::vec3* pMovement, bool* pStepUpBlock = nullptr);
+
+	// Walks the blocks the point passes through from start to end, and sets pFraction to how far along it enters the first solid one
+	bool SweepPoint(const glm::vec3& start, const glm::vec3& end, float* pFraction);
+
+private:
+	struct CachedChunk
+	{
+		int m_chunkX;
+		int m_chunkY;
+		int m_chunkZ;
+		Chunk* m_pChunk;
+	};
+
+	Chunk* GetChunk(int chunkX, int chunkY, int chunkZ);
+
+	// Whether any block from minBlockX to maxBlockX of the row is solid, from the active masks of the chunks it crosses
+	bool IsRowSolid(int minBlockX, int maxBlockX, int blockY, int blockZ, bool* pIsLoaded);
+
+	// Whether any block from minBlock to maxBlock is solid, a row at a time
+	bool IsBoxSolid(const int* minBlock, const int* maxBlock, bool* pIsLoaded);
+
+	ChunkManager* m_pChunkManager;
+
+	// The chunks read last, a box never overlaps more than eight but a few cover most checks
+	static const int NUM_CACHED_CHUNKS = 4;
+	CachedChunk m_cachedChunks[NUM_CACHED_CHUNKS];
+	int m_numCachedChunks;
+	int m_nextCachedChunk;
+};
+
+#endif
@@ -0,0 +1,1588 @@
+/*************************************************************************
+> File Name: CubbyBenchmark.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose: Implement CubbyGame's benchmarks, run from the debug console.
+> Created Time: 2016/09/04
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <Blocks/VoxelCollision.h>
+#include <Enemy/FlowField.h>
+#include <Maths/Bezier3.h>
+#include <Maths/Plane3D.h>
+#include <Models/MS3DAnimatorBatch.h>
+#include <Models/MS3DModelManager.h>
+#include <Models/QubicleBinary.h>
+#include <NPC/NavigationGraph.h>
+#include <Utils/AssetLoader.h>
+#include <Utils/FileUtils.h>
+#include <Utils/Interpolator.h>
+#include <Utils/PerformanceTimer.h>
+#include <Utils/Random.h>
+#include <Utils/SpatialGrid.h>
+#include <Utils/ThreadPool.h>
+#include <Utils/TimeManager.h>
+
+#include "CubbyGame.h"
+
+// Background load callbacks for the qubicle import benchmark
+static bool BenchmarkLoadQubicleBinary(void* pAsset)
+{
+	QubicleBinary* pQubicleBinary = static_cast<QubicleBinary*>(pAsset);
+	std::string fileName = pQubicleBinary->GetFileName();
+
+	return pQubicleBinary->PrepareImport(fileName.c_str(), true);
+}
+
+static void BenchmarkUploadQubicleBinary(void* pAsset, bool isLoaded)
+{
+	if (isLoaded)
+	{
+		static_cast<QubicleBinary*>(pAsset)->CompleteImport();
+	}
+}
+
+// Renders the text effects for a number of frames for the text benchmark, returns the time per frame
+static float BenchmarkTextFrames(Renderer* pRenderer, TextEffectsManager* pTextEffectsManager, int numFrames, bool clearTextCaches, int* pNumDrawCalls)
+{
+	// Waits for the GPU, so the time includes the draws and not just queuing them
+	glFinish();
+
+	int drawCallsBefore = pRenderer->GetNumDrawCalls();
+
+	PerformanceTimer timer;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		if (clearTextCaches)
+		{
+			pRenderer->ClearTextMeshCaches();
+		}
+
+		pTextEffectsManager->Render();
+	}
+	glFinish();
+	float frameTime = timer.GetElapsedTime() / numFrames;
+
+	*pNumDrawCalls = (pRenderer->GetNumDrawCalls() - drawCallsBefore) / numFrames;
+
+	return frameTime;
+}
+
+// Stand in for an enemy, NPC or projectile in the spatial grid benchmark, without loading any models
+struct BenchmarkSpatialObject
+{
+	glm::vec3 m_position;
+	glm::vec3 m_velocity;
+	float m_radius;
+};
+
+static void CreateBenchmarkSpatialObjects(int numObjects, float speed, float radius, float areaSize, std::vector<BenchmarkSpatialObject>* pObjects)
+{
+	pObjects->resize(numObjects);
+
+	for (int i = 0; i < numObjects; ++i)
+	{
+		BenchmarkSpatialObject* pObject = &(*pObjects)[i];
+		pObject->m_position = glm::vec3(GetRandomNumber(0, static_cast<int>(areaSize), 2), GetRandomNumber(0, 8, 2), GetRandomNumber(0, static_cast<int>(areaSize), 2));
+		pObject->m_velocity = glm::vec3(GetRandomNumber(-100, 100, 2), 0.0f, GetRandomNumber(-100, 100, 2)) * (speed * 0.01f);
+		pObject->m_radius = radius;
+	}
+}
+
+static void MoveBenchmarkSpatialObjects(std::vector<BenchmarkSpatialObject>* pObjects, float dt, float areaSize)
+{
+	for (size_t i = 0; i < pObjects->size(); ++i)
+	{
+		BenchmarkSpatialObject* pObject = &(*pObjects)[i];
+		pObject->m_position += pObject->m_velocity * dt;
+
+		// Wrap around the area, so the density stays the same
+		pObject->m_position.x = pObject->m_position.x - std::floor(pObject->m_position.x / areaSize) * areaSize;
+		pObject->m_position.z = pObject->m_position.z - std::floor(pObject->m_position.z / areaSize) * areaSize;
+	}
+}
+
+static bool IsBenchmarkSpatialContact(const BenchmarkSpatialObject& object1, const BenchmarkSpatialObject& object2)
+{
+	return length(object1.m_position - object2.m_position) < object1.m_radius + object2.m_radius;
+}
+
+// Rolling hills with long walls across them for the navigation benchmark, the walls have a gate every 48 blocks
+static int GetBenchmarkNavigationHeight(int x, int z)
+{
+	return 8 + static_cast<int>(4.0f * std::sin(x * 0.05f) * std::cos(z * 0.07f));
+}
+
+static bool IsBenchmarkNavigationBlockSolid(void* pData, int x, int y, int z)
+{
+	int worldSize = *static_cast<int*>(pData);
+	if (x < 0 || z < 0 || x >= worldSize || z >= worldSize || y < 0)
+	{
+		return false;
+	}
+
+	int height = GetBenchmarkNavigationHeight(x, z);
+	if (y <= height)
+	{
+		return true;
+	}
+
+	bool isWall = (x % 64 == 32 || z % 64 == 32) && (x + z) % 48 >= 4;
+
+	return isWall && y <= height + 3;
+}
+
+static glm::vec3 GetBenchmarkNavigationPosition(int worldSize)
+{
+	int x = GetRandomNumber(0, worldSize - 1);
+	int z = GetRandomNumber(0, worldSize - 1);
+
+	return glm::vec3(static_cast<float>(x), static_cast<float>(GetBenchmarkNavigationHeight(x, z) + 1), static_cast<float>(z));
+}
+
+// The collision each character used to have, testing only the cube of blocks around the checked position, kept to compare against
+static bool CheckCharacterDiscrete(ChunkManager* pChunkManager, const glm::vec3& positionCheck, const glm::vec3& previousPosition, float radius, glm::vec3* pNormal, glm::vec3* pMovement)
+{
+	glm::vec3 movementCache = *pMovement;
+	bool worldCollision = false;
+
+	glm::vec3 floorPosition;
+	if (pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
+	{
+		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
+		return true;
+	}
+
+	Plane3D planes[6];
+	planes[0] = Plane3D(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
+	planes[1] = Plane3D(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
+	planes[2] = Plane3D(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
+	planes[3] = Plane3D(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
+	planes[4] = Plane3D(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
+	planes[5] = Plane3D(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
+
+	int numChecks = 1 + static_cast<int>(radius / (Chunk::BLOCK_RENDER_SIZE * 2.0f));
+
+	for (int x = -numChecks; x <= numChecks; ++x)
+	{
+		for (int y = -numChecks; y <= numChecks; ++y)
+		{
+			for (int z = -numChecks; z <= numChecks; ++z)
+			{
+				*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
+
+				int blockX, blockY, blockZ;
+				glm::vec3 blockPos;
+				Chunk* pChunk = nullptr;
+				glm::vec3 position = positionCheck + glm::vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * (Chunk::BLOCK_RENDER_SIZE * 2.0f);
+
+				if (pChunkManager->GetBlockActiveFrom3DPosition(position.x, position.y, position.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk) == false)
+				{
+					if (pChunk == nullptr || pChunk->IsSetup() == false)
+					{
+						*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
+					}
+
+					continue;
+				}
+
+				int inside = 0;
+				for (int i = 0; i < 6; ++i)
+				{
+					bool wasInside = planes[i].GetPointDistance(blockPos - previousPosition) >= -radius;
+
+					if (planes[i].GetPointDistance(blockPos - positionCheck) >= -radius)
+					{
+						inside++;
+						if (wasInside == false)
+						{
+							*pNormal += planes[i].m_normal;
+						}
+					}
+				}
+
+				if (inside == 6 && length(*pNormal) <= 1.0f)
+				{
+					float dotResult = dot(*pNormal, *pMovement);
+					*pNormal *= dotResult;
+
+					*pMovement -= *pNormal;
+
+					worldCollision = true;
+				}
+			}
+		}
+	}
+
+	if (worldCollision)
+	{
+		return true;
+	}
+
+	*pMovement = movementCache;
+
+	return false;
+}
+
+// Counts the callbacks of the timer benchmark
+static void BenchmarkTimerFinished(void* pData)
+{
+	(*static_cast<int*>(pData))++;
+}
+
+// A timer checked every frame whether it is due or not, as the time manager used to go through them
+struct BenchmarkScanTimer
+{
+	float m_elapsedTime;
+	float m_timeOutTime;
+	bool m_looping;
+	bool m_finished;
+	std::function<void(void*)> m_callback;
+	void* m_pCallbackData;
+};
+
+// An interpolation on its own in the heap with its chain behind a pointer, as the interpolator used to keep them
+struct BenchmarkHeapTween
+{
+	float* m_pVariable;
+	float m_start;
+	float m_end;
+	float m_time;
+	float m_easing;
+	float m_elapsed;
+	BenchmarkHeapTween* m_pNext;
+};
+
+// Benchmarks
+void CubbyGame::RunBenchmark(std::string benchmarkName)
+{
+	if (benchmarkName == "animation")
+	{
+		BenchmarkAnimation();
+	}
+	else if (benchmarkName == "qb")
+	{
+		BenchmarkQubicleImport();
+	}
+	else if (benchmarkName == "text")
+	{
+		BenchmarkText();
+	}
+	else if (benchmarkName == "lights")
+	{
+		BenchmarkLights();
+	}
+	else if (benchmarkName == "spatial")
+	{
+		BenchmarkSpatialGrid();
+	}
+	else if (benchmarkName == "entities")
+	{
+		BenchmarkEntityUpdate();
+	}
+	else if (benchmarkName == "flowfield")
+	{
+		BenchmarkFlowField();
+	}
+	else if (benchmarkName == "navigation")
+	{
+		BenchmarkNavigation();
+	}
+	else if (benchmarkName == "picking")
+	{
+		BenchmarkPicking();
+	}
+	else if (benchmarkName == "collision")
+	{
+		BenchmarkCollision();
+	}
+	else if (benchmarkName == "chunks")
+	{
+		BenchmarkChunks();
+	}
+	else if (benchmarkName == "timers")
+	{
+		BenchmarkTimers();
+	}
+	else if (benchmarkName == "tweens")
+	{
+		BenchmarkInterpolator();
+	}
+	else
+	{
+		AddConsoleLabel("Unknown benchmark: " + benchmarkName);
+	}
+}
+
+void CubbyGame::BenchmarkAnimation()
+{
+	const int numCharacters = 500;
+	const int numFrames = 120;
+	const float dt = 1.0f / 60.0f;
+	const int numSections = static_cast<int>(AnimationSections::NumSections);
+
+	MS3DModel* pModel = MS3DModelManager::GetInstance()->GetMS3DModel(m_pRenderer, "Resources/gamedata/models/Human/Human.ms3d");
+
+	// Every character has one animator per animation section, the same as a VoxelCharacter
+	std::vector<MS3DAnimator*> vpAnimators;
+	for (int i = 0; i < numCharacters * numSections; ++i)
+	{
+		MS3DAnimator* pAnimator = new MS3DAnimator(m_pRenderer, pModel);
+		pAnimator->LoadAnimations("Resources/gamedata/models/Human/Human.animlist");
+		pAnimator->PlayAnimation("Run");
+
+		// Spread the characters over the animation, so they are not all sampling the same keyframes
+		pAnimator->Update(dt * (i / numSections % 60));
+
+		vpAnimators.push_back(pAnimator);
+	}
+
+	// Each pose evaluated straight away, one animator after the other
+	PerformanceTimer timer;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < vpAnimators.size(); ++i)
+		{
+			vpAnimators[i]->Update(dt);
+		}
+	}
+	float serialTime = timer.GetElapsedTime() / numFrames;
+
+	// Timers advanced per character, then all poses evaluated together on the worker threads
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < vpAnimators.size(); ++i)
+		{
+			vpAnimators[i]->UpdateDeferred(dt);
+		}
+
+		MS3DAnimatorBatch::GetInstance()->Flush();
+	}
+	float batchedTime = timer.GetElapsedTime() / numFrames;
+
+	for (size_t i = 0; i < vpAnimators.size(); ++i)
+	{
+		delete vpAnimators[i];
+		vpAnimators[i] = nullptr;
+	}
+	vpAnimators.clear();
+
+	int numJoints = numCharacters * numSections * pModel->GetNumJoints();
+	MS3DModelManager::GetInstance()->ReleaseMS3DModel(pModel);
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Animation benchmark: %i characters, %i animators, %i joints", numCharacters, numCharacters * numSections, numJoints);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Serial: %.3fms/frame, Batched (%i threads): %.3fms/frame", serialTime, ThreadPool::GetInstance()->GetNumThreads(), batchedTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkQubicleImport()
+{
+	std::vector<std::string> qbFiles = ListFilesInDirectoryRecursive("Resources", ".qb");
+
+	float decodeTime = 0.0f;
+	float meshTime = 0.0f;
+	float worstFileTime = 0.0f;
+	int numMatrices = 0;
+	int numFailed = 0;
+
+	PerformanceTimer timer;
+	for (size_t i = 0; i < qbFiles.size(); ++i)
+	{
+		QubicleBinary* pQubicleBinary = new QubicleBinary(m_pRenderer);
+
+		timer.Start();
+		bool isDecoded = pQubicleBinary->Decode(qbFiles[i].c_str());
+		float fileDecodeTime = timer.GetElapsedTime();
+		decodeTime += fileDecodeTime;
+
+		if (isDecoded)
+		{
+			timer.Start();
+			pQubicleBinary->FinishImport(true);
+			float fileMeshTime = timer.GetElapsedTime();
+			meshTime += fileMeshTime;
+
+			worstFileTime = std::max(worstFileTime, fileDecodeTime + fileMeshTime);
+			numMatrices += pQubicleBinary->GetNumMatrices();
+		}
+		else
+		{
+			numFailed++;
+		}
+
+		delete pQubicleBinary;
+	}
+
+	// The same files loaded in the background, with the main thread only uploading a bounded amount per simulated frame
+	const float maxUploadTime = 2.0f;
+
+	std::vector<QubicleBinary*> vpQubicleBinaries;
+	PerformanceTimer asyncTimer;
+	for (size_t i = 0; i < qbFiles.size(); ++i)
+	{
+		QubicleBinary* pQubicleBinary = new QubicleBinary(m_pRenderer);
+		pQubicleBinary->SetFileName(qbFiles[i].c_str());
+		AssetLoader::GetInstance()->QueueLoad(pQubicleBinary, BenchmarkLoadQubicleBinary, BenchmarkUploadQubicleBinary);
+
+		vpQubicleBinaries.push_back(pQubicleBinary);
+	}
+
+	int numAsyncFrames = 0;
+	float worstFrameTime = 0.0f;
+	while (AssetLoader::GetInstance()->GetNumPendingLoads() > 0 || AssetLoader::GetInstance()->GetNumPendingUploads() > 0)
+	{
+		timer.Start();
+		AssetLoader::GetInstance()->ProcessUploads(maxUploadTime);
+		worstFrameTime = std::max(worstFrameTime, timer.GetElapsedTime());
+
+		numAsyncFrames++;
+	}
+	float asyncTime = asyncTimer.GetElapsedTime();
+
+	for (size_t i = 0; i < vpQubicleBinaries.size(); ++i)
+	{
+		delete vpQubicleBinaries[i];
+		vpQubicleBinaries[i] = nullptr;
+	}
+	vpQubicleBinaries.clear();
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Qubicle import benchmark: %i files, %i matrices, %i failed", static_cast<int>(qbFiles.size()), numMatrices, numFailed);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Decode: %.3fms, Mesh: %.3fms, Total: %.3fms, Worst file: %.3fms", decodeTime, meshTime, decodeTime + meshTime, worstFileTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Background: %.3fms over %i frames, Worst main thread frame: %.3fms", asyncTime, numAsyncFrames, worstFrameTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkText()
+{
+	const int numTexts = 2000;
+	const int numFrames = 60;
+
+	// Floating combat text scattered around the player, the same as damage numbers in a big fight
+	TextEffectsManager textEffectsManager(m_pRenderer);
+	textEffectsManager.SetCamera(m_pGameCamera);
+
+	glm::vec3 center = m_pPlayer->GetCenter();
+	for (int i = 0; i < numTexts; ++i)
+	{
+		char damageText[16];
+		sprintf(damageText, "%i", GetRandomNumber(1, 999));
+
+		glm::vec3 position = center + glm::vec3(GetRandomNumber(-8, 8, 2), GetRandomNumber(0, 4, 2), GetRandomNumber(-8, 8, 2));
+		Color textColor = (i % 4 == 0) ? Color(1.0f, 1.0f, 0.0f) : Color(1.0f, 1.0f, 1.0f);
+
+		AnimatedText* pText = textEffectsManager.CreateTextEffect(m_pFrontendManager->GetTextEffectFont(), m_pFrontendManager->GetTextEffectOutlineFont(), m_defaultViewport, TextDrawMode::Screen3D, TextEffect::NoMovement, TextDrawStyle::Outline, position, textColor, Color(0.0f, 0.0f, 0.0f), damageText, 1.0f);
+		pText->SetAutoDelete(true);
+		pText->StartEffect();
+	}
+
+	// Every string laid out again each frame and drawn on its own, as the per-glyph display lists did
+	int uncachedDrawCalls;
+	textEffectsManager.SetBatching(false);
+	float uncachedTime = BenchmarkTextFrames(m_pRenderer, &textEffectsManager, numFrames, true, &uncachedDrawCalls);
+
+	int cachedDrawCalls;
+	float cachedTime = BenchmarkTextFrames(m_pRenderer, &textEffectsManager, numFrames, false, &cachedDrawCalls);
+
+	int batchedDrawCalls;
+	textEffectsManager.SetBatching(true);
+	float batchedTime = BenchmarkTextFrames(m_pRenderer, &textEffectsManager, numFrames, false, &batchedDrawCalls);
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Text benchmark: %i outlined texts, %i cached text meshes, %i glyphs", numTexts, m_pRenderer->GetNumCachedTextMeshes(), m_pRenderer->GetNumGlyphs());
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Uncached: %.3fms/frame (%i draws), Cached: %.3fms/frame (%i draws), Cached and batched: %.3fms/frame (%i draws)", uncachedTime, uncachedDrawCalls, cachedTime, cachedDrawCalls, batchedTime, batchedDrawCalls);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkLights()
+{
+	const int lightCounts[3] = { 16, 256, 1024 };
+	const int numFrames = 30;
+
+	bool clusteredLighting = m_pCubbySettings->m_clusteredLighting;
+	bool isClusteringSupported = m_clusteredLightingShader != -1;
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Lights benchmark: %i frames each, light clusters %s", numFrames, isClusteringSupported ? "supported" : "not supported");
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	for (int countIndex = 0; countIndex < 3; ++countIndex)
+	{
+		int numLights = lightCounts[countIndex];
+
+		// Weapon and projectile sized lights spread around the player, like a big fight
+		std::vector<unsigned int> lightIDs;
+		glm::vec3 center = m_pPlayer->GetCenter();
+		for (int i = 0; i < numLights; ++i)
+		{
+			glm::vec3 position = center + glm::vec3(GetRandomNumber(-32, 32, 2), GetRandomNumber(0, 8, 2), GetRandomNumber(-32, 32, 2));
+			Color color(GetRandomNumber(0, 1, 2), GetRandomNumber(0, 1, 2), GetRandomNumber(0, 1, 2), 1.0f);
+
+			unsigned int lightID;
+			m_pLightingManager->AddLight(position, GetRandomNumber(2, 6, 2), 1.0f, color, &lightID);
+			lightIDs.push_back(lightID);
+		}
+
+		// Moving every light by ID, as the weapon and projectile lights do each frame
+		PerformanceTimer timer;
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			for (size_t i = 0; i < lightIDs.size(); ++i)
+			{
+				DynamicLight* pLight = m_pLightingManager->GetLightFromID(lightIDs[i]);
+				m_pLightingManager->UpdateLightPosition(lightIDs[i], pLight->GetPosition() + glm::vec3(0.0f, 0.001f, 0.0f));
+			}
+		}
+		float updateTime = timer.GetElapsedTime() / numFrames;
+
+		// Waits for the GPU, so the times include the lighting pass and not just queuing it
+		m_pCubbySettings->m_clusteredLighting = false;
+		glFinish();
+		timer.Start();
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			RenderDeferredLighting();
+		}
+		glFinish();
+		float volumesTime = timer.GetElapsedTime() / numFrames;
+
+		float clusteredTime = 0.0f;
+		if (isClusteringSupported)
+		{
+			m_pCubbySettings->m_clusteredLighting = true;
+			glFinish();
+			timer.Start();
+			for (int frame = 0; frame < numFrames; ++frame)
+			{
+				RenderDeferredLighting();
+			}
+			glFinish();
+			clusteredTime = timer.GetElapsedTime() / numFrames;
+		}
+
+		const LightClusters* pLightClusters = m_pLightingManager->GetLightClusters();
+		sprintf(benchmarkBuff, "%i lights: Volumes: %.3fms/frame (%i draws), Clustered: %.3fms/frame (1 draw, %i clusters, %i light indices), Updates by ID: %.3fms/frame", numLights, volumesTime, numLights, clusteredTime, pLightClusters->GetNumOccupiedClusters(), pLightClusters->GetNumLightIndices(), updateTime);
+		AddConsoleLabel(benchmarkBuff);
+		std::cout << benchmarkBuff << std::endl;
+
+		for (size_t i = 0; i < lightIDs.size(); ++i)
+		{
+			m_pLightingManager->RemoveLight(lightIDs[i]);
+		}
+	}
+
+	m_pCubbySettings->m_clusteredLighting = clusteredLighting;
+}
+
+void CubbyGame::BenchmarkSpatialGrid()
+{
+	const int numEnemies = 1000;
+	const int numNPCs = 200;
+	const int numProjectiles = 500;
+	const int numFrames = 60;
+	const float dt = 1.0f / 60.0f;
+	const float areaSize = 256.0f;
+
+	std::vector<BenchmarkSpatialObject> enemies;
+	std::vector<BenchmarkSpatialObject> NPCs;
+	std::vector<BenchmarkSpatialObject> projectiles;
+	CreateBenchmarkSpatialObjects(numEnemies, 4.0f, 0.75f, areaSize, &enemies);
+	CreateBenchmarkSpatialObjects(numNPCs, 4.0f, 0.75f, areaSize, &NPCs);
+	CreateBenchmarkSpatialObjects(numProjectiles, 30.0f, 0.25f, areaSize, &projectiles);
+
+	// The same frames are run twice from the same start, once checking every pair as the managers used to and once through the grid
+	std::vector<BenchmarkSpatialObject> startEnemies = enemies;
+	std::vector<BenchmarkSpatialObject> startNPCs = NPCs;
+	std::vector<BenchmarkSpatialObject> startProjectiles = projectiles;
+
+	int bruteForceContacts = 0;
+	PerformanceTimer timer;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		MoveBenchmarkSpatialObjects(&enemies, dt, areaSize);
+		MoveBenchmarkSpatialObjects(&NPCs, dt, areaSize);
+		MoveBenchmarkSpatialObjects(&projectiles, dt, areaSize);
+
+		for (int i = 0; i < numEnemies; ++i)
+		{
+			for (int j = 0; j < numEnemies; ++j)
+			{
+				bruteForceContacts += (i != j && IsBenchmarkSpatialContact(enemies[i], enemies[j])) ? 1 : 0;
+			}
+
+			for (int j = 0; j < numProjectiles; ++j)
+			{
+				bruteForceContacts += IsBenchmarkSpatialContact(enemies[i], projectiles[j]) ? 1 : 0;
+			}
+		}
+
+		for (int i = 0; i < numNPCs; ++i)
+		{
+			for (int j = 0; j < numNPCs; ++j)
+			{
+				bruteForceContacts += (i != j && IsBenchmarkSpatialContact(NPCs[i], NPCs[j])) ? 1 : 0;
+			}
+
+			for (int j = 0; j < numProjectiles; ++j)
+			{
+				bruteForceContacts += IsBenchmarkSpatialContact(NPCs[i], projectiles[j]) ? 1 : 0;
+			}
+		}
+	}
+	float bruteForceTime = timer.GetElapsedTime() / numFrames;
+
+	enemies = startEnemies;
+	NPCs = startNPCs;
+	projectiles = startProjectiles;
+
+	SpatialGrid grid;
+	std::vector<void*> vpResults;
+
+	int gridContacts = 0;
+	float gridUpdateTime = 0.0f;
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		PerformanceTimer updateTimer;
+
+		MoveBenchmarkSpatialObjects(&enemies, dt, areaSize);
+		MoveBenchmarkSpatialObjects(&NPCs, dt, areaSize);
+		MoveBenchmarkSpatialObjects(&projectiles, dt, areaSize);
+
+		for (int i = 0; i < numEnemies; ++i)
+		{
+			grid.Update(&enemies[i], SpatialType::Enemy, enemies[i].m_position, enemies[i].m_radius);
+		}
+		for (int i = 0; i < numNPCs; ++i)
+		{
+			grid.Update(&NPCs[i], SpatialType::NPC, NPCs[i].m_position, NPCs[i].m_radius);
+		}
+		for (int i = 0; i < numProjectiles; ++i)
+		{
+			grid.Update(&projectiles[i], SpatialType::Projectile, projectiles[i].m_position, projectiles[i].m_radius);
+		}
+
+		gridUpdateTime += updateTimer.GetElapsedTime();
+
+		for (int i = 0; i < numEnemies; ++i)
+		{
+			grid.QueryRadius(enemies[i].m_position, enemies[i].m_radius, SpatialGrid::GetTypeBit(SpatialType::Enemy) | SpatialGrid::GetTypeBit(SpatialType::Projectile), &vpResults);
+
+			for (size_t j = 0; j < vpResults.size(); ++j)
+			{
+				const BenchmarkSpatialObject* pOther = static_cast<BenchmarkSpatialObject*>(vpResults[j]);
+				gridContacts += (pOther != &enemies[i] && IsBenchmarkSpatialContact(enemies[i], *pOther)) ? 1 : 0;
+			}
+		}
+
+		for (int i = 0; i < numNPCs; ++i)
+		{
+			grid.QueryRadius(NPCs[i].m_position, NPCs[i].m_radius, SpatialGrid::GetTypeBit(SpatialType::NPC) | SpatialGrid::GetTypeBit(SpatialType::Projectile), &vpResults);
+
+			for (size_t j = 0; j < vpResults.size(); ++j)
+			{
+				const BenchmarkSpatialObject* pOther = static_cast<BenchmarkSpatialObject*>(vpResults[j]);
+				gridContacts += (pOther != &NPCs[i] && IsBenchmarkSpatialContact(NPCs[i], *pOther)) ? 1 : 0;
+			}
+		}
+	}
+	float gridTime = timer.GetElapsedTime() / numFrames;
+	gridUpdateTime /= numFrames;
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Spatial benchmark: %i enemies, %i NPCs, %i projectiles, %i frames", numEnemies, numNPCs, numProjectiles, numFrames);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Every pair: %.3fms/frame (%i contacts), Grid: %.3fms/frame (%.3fms updating, %i contacts, %i cells)", bruteForceTime, bruteForceContacts, gridTime, gridUpdateTime, gridContacts, grid.GetNumCells());
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkPicking()
+{
+	const int numEnemies = 1000;
+	const int numNPCs = 200;
+	const int numRays = 10000;
+	const float areaSize = 256.0f;
+	const float maxDistance = 50.0f;
+
+	std::vector<BenchmarkSpatialObject> enemies;
+	std::vector<BenchmarkSpatialObject> NPCs;
+	CreateBenchmarkSpatialObjects(numEnemies, 0.0f, 0.75f, areaSize, &enemies);
+	CreateBenchmarkSpatialObjects(numNPCs, 0.0f, 0.75f, areaSize, &NPCs);
+
+	SpatialGrid grid;
+	for (int i = 0; i < numEnemies; ++i)
+	{
+		grid.Update(&enemies[i], SpatialType::Enemy, enemies[i].m_position, enemies[i].m_radius);
+	}
+	for (int i = 0; i < numNPCs; ++i)
+	{
+		grid.Update(&NPCs[i], SpatialType::NPC, NPCs[i].m_position, NPCs[i].m_radius);
+	}
+
+	// Cursor rays from a camera above the area, looking down at somewhere near it
+	std::vector<glm::vec3> rayOrigins(numRays);
+	std::vector<glm::vec3> rayDirections(numRays);
+	for (int i = 0; i < numRays; ++i)
+	{
+		rayOrigins[i] = glm::vec3(GetRandomNumber(0, static_cast<int>(areaSize), 2), 12.0f, GetRandomNumber(0, static_cast<int>(areaSize), 2));
+		glm::vec3 lookAt = rayOrigins[i] + glm::vec3(GetRandomNumber(-20, 20, 2), -12.0f, GetRandomNumber(-20, 20, 2));
+		rayDirections[i] = normalize(lookAt - rayOrigins[i]);
+	}
+
+	// Stepping along the ray and checking every enemy at each step, as the cursor targeting used to
+	int marchHits = 0;
+	PerformanceTimer timer;
+	for (int i = 0; i < numRays; ++i)
+	{
+		bool collides = false;
+		float increments = Chunk::BLOCK_RENDER_SIZE * 0.1f;
+
+		for (int step = 0; step < 100 && collides == false; ++step)
+		{
+			glm::vec3 position = rayOrigins[i] + rayDirections[i] * increments;
+
+			for (int j = 0; j < numEnemies && collides == false; ++j)
+			{
+				collides = length(enemies[j].m_position - position) < enemies[j].m_radius * 2.5f;
+			}
+
+			increments += Chunk::BLOCK_RENDER_SIZE;
+		}
+
+		marchHits += collides ? 1 : 0;
+	}
+	float marchTime = timer.GetElapsedTime() * 1000.0f / numRays;
+
+	int gridHits = 0;
+	timer.Start();
+	for (int i = 0; i < numRays; ++i)
+	{
+		gridHits += grid.QueryRay(rayOrigins[i], rayDirections[i], maxDistance, 0.5f, SpatialGrid::GetTypeBit(SpatialType::Enemy), nullptr, nullptr, nullptr) != nullptr ? 1 : 0;
+	}
+	float gridTime = timer.GetElapsedTime() * 1000.0f / numRays;
+
+	int gridNPCHits = 0;
+	timer.Start();
+	for (int i = 0; i < numRays; ++i)
+	{
+		gridNPCHits += grid.QueryRay(rayOrigins[i], rayDirections[i], maxDistance, 1.0f, SpatialGrid::GetTypeBit(SpatialType::NPC), nullptr, nullptr, nullptr) != nullptr ? 1 : 0;
+	}
+	float gridNPCTime = timer.GetElapsedTime() * 1000.0f / numRays;
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Picking benchmark: %i enemies, %i NPCs, %i cursor rays", numEnemies, numNPCs, numRays);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Stepping: %.2fus/pick (%i hits), Grid ray: %.2fus/pick (%i hits), NPC grid ray: %.2fus/pick (%i hits)", marchTime, marchHits, gridTime, gridHits, gridNPCTime, gridNPCHits);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkEntityUpdate()
+{
+	const int numEnemies = 200;
+	const int numNPCs = 100;
+	const int numFrames = 60;
+	const float dt = 1.0f / 60.0f;
+
+	// A crowd spread around the player
+	glm::vec3 center = m_pPlayer->GetCenter();
+	std::vector<Enemy*> vpEnemies;
+	for (int i = 0; i < numEnemies; ++i)
+	{
+		glm::vec3 position = center + glm::vec3(GetRandomNumber(-48, 48, 2), 2.0f, GetRandomNumber(-48, 48, 2));
+		vpEnemies.push_back(m_pEnemyManager->CreateEnemy(position, EnemyType::NormalSkeleton, 0.08f));
+	}
+
+	char benchmarkBuff[256];
+	for (int i = 0; i < numNPCs; ++i)
+	{
+		sprintf(benchmarkBuff, "Benchmark NPC %i", i);
+		glm::vec3 position = center + glm::vec3(GetRandomNumber(-48, 48, 2), 2.0f, GetRandomNumber(-48, 48, 2));
+		m_pNPCManager->CreateNPC(benchmarkBuff, "Human", "Priest", position, 0.08f, false, true);
+	}
+
+	// Moves the new enemies onto the update list
+	m_pEnemyManager->Update(dt);
+
+	sprintf(benchmarkBuff, "Entity update benchmark: %i enemies, %i NPCs, %i frames each", m_pEnemyManager->GetNumEnemies(), m_pNPCManager->GetNumNPCs(), numFrames);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	ThreadPool* pThreadPool = ThreadPool::GetInstance();
+	int maxThreads = pThreadPool->GetMaxThreads();
+
+	float singleThreadTime = 0.0f;
+	for (int numThreads = 1; ; numThreads *= 2)
+	{
+		numThreads = std::min(numThreads, pThreadPool->GetNumThreads());
+		pThreadPool->SetMaxThreads(numThreads);
+
+		PerformanceTimer timer;
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			m_pNPCManager->Update(dt);
+			m_pEnemyManager->Update(dt);
+		}
+		float updateTime = timer.GetElapsedTime() / numFrames;
+
+		if (numThreads == 1)
+		{
+			singleThreadTime = updateTime;
+		}
+
+		sprintf(benchmarkBuff, "%i threads: %.3fms/frame, %.2fx", numThreads, updateTime, updateTime > 0.0f ? singleThreadTime / updateTime : 0.0f);
+		AddConsoleLabel(benchmarkBuff);
+		std::cout << benchmarkBuff << std::endl;
+
+		if (numThreads == pThreadPool->GetNumThreads())
+		{
+			break;
+		}
+	}
+
+	pThreadPool->SetMaxThreads(maxThreads);
+
+	// Only the benchmark enemies still alive are erased, on the next update
+	for (int i = 0; i < m_pEnemyManager->GetNumEnemies(); ++i)
+	{
+		Enemy* pEnemy = m_pEnemyManager->GetEnemy(i);
+
+		if (std::find(vpEnemies.begin(), vpEnemies.end(), pEnemy) != vpEnemies.end())
+		{
+			pEnemy->SetErase(true);
+		}
+	}
+
+	for (int i = 0; i < numNPCs; ++i)
+	{
+		sprintf(benchmarkBuff, "Benchmark NPC %i", i);
+		m_pNPCManager->DeleteNPC(benchmarkBuff);
+	}
+}
+
+void CubbyGame::BenchmarkFlowField()
+{
+	const int numEnemies = 300;
+	const int numFrames = 600;
+	const float dt = 1.0f / 60.0f;
+	const float arriveDistance = 4.0f;
+	// Enemies moving less than this in a frame while still on their way are stuck
+	const float stuckDistance = 0.01f;
+
+	bool enemyFlowFields = m_pCubbySettings->m_enemyFlowFields;
+
+	// A ring of zombies around the player, on the ground
+	glm::vec3 center = m_pPlayer->GetCenter();
+	std::vector<glm::vec3> startPositions;
+	for (int i = 0; i < numEnemies; ++i)
+	{
+		float angle = GetRandomNumber(0, 360, 2) * 3.14159265f / 180.0f;
+		float distance = GetRandomNumber(16, 40, 2);
+		glm::vec3 position = center + glm::vec3(std::cos(angle) * distance, 8.0f, std::sin(angle) * distance);
+
+		glm::vec3 floorPosition;
+		if (m_pChunkManager->FindClosestFloor(position, &floorPosition))
+		{
+			position = floorPosition + glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+
+		startPositions.push_back(position);
+	}
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Flow field benchmark: %i enemies converging on the player, %i frames", numEnemies, numFrames);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	// The same crowd from the same start, first heading straight for the player and then following the flow field
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		m_pCubbySettings->m_enemyFlowFields = (pass == 1);
+
+		std::vector<Enemy*> vpEnemies;
+		for (int i = 0; i < numEnemies; ++i)
+		{
+			vpEnemies.push_back(m_pEnemyManager->CreateEnemy(startPositions[i], EnemyType::WalkingZombie, 0.08f));
+		}
+		std::sort(vpEnemies.begin(), vpEnemies.end());
+
+		std::vector<glm::vec3> lastPositions(startPositions);
+
+		float updateTime = 0.0f;
+		float flowFieldTime = 0.0f;
+		float stuckTime = 0.0f;
+		int numFlowFieldBuilds = 0;
+		float flowFieldBuildTime = 0.0f;
+
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			// The player only watches
+			m_pPlayer->GiveHealth(m_pPlayer->GetMaxHealth());
+
+			// Publishes the finished flow field searches, as the frame update does
+			AssetLoader::GetInstance()->ProcessUploads(2.0f);
+
+			for (int i = 0; i < m_pEnemyManager->GetNumEnemies(); ++i)
+			{
+				Enemy* pEnemy = m_pEnemyManager->GetEnemy(i);
+
+				if (std::binary_search(vpEnemies.begin(), vpEnemies.end(), pEnemy))
+				{
+					pEnemy->SetAggro(true);
+				}
+			}
+
+			PerformanceTimer timer;
+			m_pEnemyManager->Update(dt);
+			updateTime += timer.GetElapsedTime();
+			flowFieldTime += m_pEnemyManager->GetFlowFieldUpdateTime();
+
+			for (int i = 0; i < m_pEnemyManager->GetNumEnemies(); ++i)
+			{
+				Enemy* pEnemy = m_pEnemyManager->GetEnemy(i);
+
+				auto iter = std::lower_bound(vpEnemies.begin(), vpEnemies.end(), pEnemy);
+				if (iter == vpEnemies.end() || *iter != pEnemy)
+				{
+					continue;
+				}
+
+				glm::vec3 toPlayer = m_pPlayer->GetCenter() - pEnemy->GetCenter();
+				toPlayer.y = 0.0f;
+
+				glm::vec3& lastPosition = lastPositions[iter - vpEnemies.begin()];
+				if (length(toPlayer) > arriveDistance && length(pEnemy->GetCenter() - lastPosition) < stuckDistance)
+				{
+					stuckTime += dt;
+				}
+				lastPosition = pEnemy->GetCenter();
+			}
+
+			const FlowField* pFlowField = m_pEnemyManager->GetFlowField(nullptr);
+			if (pFlowField != nullptr)
+			{
+				numFlowFieldBuilds = pFlowField->GetNumBuilds();
+				flowFieldBuildTime = pFlowField->GetLastBuildTime();
+			}
+		}
+
+		int numArrived = 0;
+		for (int i = 0; i < m_pEnemyManager->GetNumEnemies(); ++i)
+		{
+			Enemy* pEnemy = m_pEnemyManager->GetEnemy(i);
+
+			if (std::binary_search(vpEnemies.begin(), vpEnemies.end(), pEnemy))
+			{
+				glm::vec3 toPlayer = m_pPlayer->GetCenter() - pEnemy->GetCenter();
+				toPlayer.y = 0.0f;
+
+				numArrived += (length(toPlayer) <= arriveDistance) ? 1 : 0;
+
+				pEnemy->SetErase(true);
+			}
+		}
+
+		sprintf(benchmarkBuff, "%s: Enemy update: %.3fms/frame (%.3fms copying chunks), Stuck: %.2fs per enemy, Reached the player: %i/%i", pass == 0 ? "Straight" : "Flow field", updateTime / numFrames, flowFieldTime / numFrames, stuckTime / numEnemies, numArrived, numEnemies);
+		AddConsoleLabel(benchmarkBuff);
+		std::cout << benchmarkBuff << std::endl;
+
+		if (pass == 1)
+		{
+			sprintf(benchmarkBuff, "Flow field searches: %i, %.3fms each on a loader thread", numFlowFieldBuilds, flowFieldBuildTime);
+			AddConsoleLabel(benchmarkBuff);
+			std::cout << benchmarkBuff << std::endl;
+		}
+
+		// Erases the crowd
+		m_pEnemyManager->Update(dt);
+	}
+
+	m_pCubbySettings->m_enemyFlowFields = enemyFlowFields;
+}
+
+void CubbyGame::BenchmarkCollision()
+{
+	const int numChecks = 100000;
+	const float checkRadius = 24.0f;
+	const float characterRadius = 0.5f;
+
+	// Characters standing and walking around the player, in the chunks that are loaded
+	glm::vec3 center = m_pPlayer->GetCenter();
+	std::vector<glm::vec3> positions(numChecks);
+	std::vector<glm::vec3> movements(numChecks);
+	for (int i = 0; i < numChecks; ++i)
+	{
+		positions[i] = center + glm::vec3(GetRandomNumber(-100, 100, 2) * 0.01f * checkRadius, GetRandomNumber(-100, 100, 2) * 0.04f, GetRandomNumber(-100, 100, 2) * 0.01f * checkRadius);
+		movements[i] = glm::vec3(GetRandomNumber(-100, 100, 2) * 0.002f, GetRandomNumber(-100, 100, 2) * 0.002f, GetRandomNumber(-100, 100, 2) * 0.002f);
+	}
+
+	// Walking steps, and the steps of a long frame that can be longer than a block
+	const float movementScales[2] = { 1.0f, 10.0f };
+	const char* movementNames[2] = { "Walking", "Long frames" };
+
+	PerformanceTimer timer;
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Collision benchmark: %i checks within %.0f of the player", numChecks, checkRadius);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	for (int scaleIndex = 0; scaleIndex < 2; ++scaleIndex)
+	{
+		// The cube of blocks around each character looked up through the chunk manager, as each character used to
+		std::vector<bool> discreteHits(numChecks);
+		int numDiscreteHits = 0;
+		timer.Start();
+		for (int i = 0; i < numChecks; ++i)
+		{
+			glm::vec3 normal;
+			glm::vec3 movement = movements[i] * movementScales[scaleIndex];
+
+			discreteHits[i] = CheckCharacterDiscrete(m_pChunkManager, positions[i] + movement, positions[i], characterRadius, &normal, &movement);
+			numDiscreteHits += discreteHits[i] ? 1 : 0;
+		}
+		float discreteTime = timer.GetElapsedTime();
+
+		// The same movements swept through the blocks, hits the discrete check missed are the ones it let through a block
+		int numSweptHits = 0;
+		int numMatching = 0;
+		int numMissedByDiscrete = 0;
+		timer.Start();
+		for (int i = 0; i < numChecks; ++i)
+		{
+			glm::vec3 normal;
+			glm::vec3 movement = movements[i] * movementScales[scaleIndex];
+			bool stepUpBlock;
+
+			VoxelCollision voxelCollision(m_pChunkManager);
+			bool isHit = voxelCollision.CheckCharacter(positions[i] + movement, positions[i], characterRadius, &normal, &movement, &stepUpBlock);
+
+			numSweptHits += isHit ? 1 : 0;
+			numMatching += isHit == discreteHits[i] ? 1 : 0;
+			numMissedByDiscrete += isHit && discreteHits[i] == false ? 1 : 0;
+		}
+		float sweptTime = timer.GetElapsedTime();
+
+		sprintf(benchmarkBuff, "%s: Discrete %.0f checks/sec (%i hit), Swept %.0f checks/sec (%i hit), %i matching, %i only hit when swept", movementNames[scaleIndex], numChecks * 1000.0f / std::max(discreteTime, 0.001f), numDiscreteHits, numChecks * 1000.0f / std::max(sweptTime, 0.001f), numSweptHits, numMatching, numMissedByDiscrete);
+		AddConsoleLabel(benchmarkBuff);
+		std::cout << benchmarkBuff << std::endl;
+	}
+
+	// Projectiles flying a few blocks each step
+	int numSweepHits = 0;
+	timer.Start();
+	for (int i = 0; i < numChecks; ++i)
+	{
+		float fraction;
+
+		VoxelCollision voxelCollision(m_pChunkManager);
+		numSweepHits += voxelCollision.SweepPoint(positions[i], positions[i] + movements[i] * 20.0f, &fraction) ? 1 : 0;
+	}
+	float sweepTime = timer.GetElapsedTime();
+
+	sprintf(benchmarkBuff, "Projectile sweeps: %.0f/sec (%i hit)", numChecks * 1000.0f / std::max(sweepTime, 0.001f), numSweepHits);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkChunks()
+{
+	const int maxChunks = 64;
+	const int chunkRange = 3;
+	const int numMeshRepeats = 10;
+	const int numWallRepeats = 1000;
+
+	// Copies of the loaded chunks around the player, at the same grid so they see the same neighbors when meshing
+	int playerGridX, playerGridY, playerGridZ;
+	m_pChunkManager->GetGridFromPosition(m_pPlayer->GetCenter(), &playerGridX, &playerGridY, &playerGridZ);
+
+	std::vector<Chunk*> chunks;
+	for (int x = -chunkRange; x <= chunkRange && static_cast<int>(chunks.size()) < maxChunks; ++x)
+	{
+		for (int y = -1; y <= 1 && static_cast<int>(chunks.size()) < maxChunks; ++y)
+		{
+			for (int z = -chunkRange; z <= chunkRange && static_cast<int>(chunks.size()) < maxChunks; ++z)
+			{
+				Chunk* pChunk = m_pChunkManager->GetChunk(playerGridX + x, playerGridY + y, playerGridZ + z);
+				if (pChunk == nullptr || pChunk->IsSetup() == false)
+				{
+					continue;
+				}
+
+				Chunk* pCopy = new Chunk(m_pRenderer, m_pChunkManager, m_pCubbySettings);
+				pCopy->SetGrid(pChunk->GetGridX(), pChunk->GetGridY(), pChunk->GetGridZ());
+				pCopy->SetPosition(pChunk->GetPosition());
+
+				for (int blockX = 0; blockX < Chunk::CHUNK_SIZE; ++blockX)
+				{
+					for (int blockY = 0; blockY < Chunk::CHUNK_SIZE; ++blockY)
+					{
+						for (int blockZ = 0; blockZ < Chunk::CHUNK_SIZE; ++blockZ)
+						{
+							pCopy->SetColor(blockX, blockY, blockZ, pChunk->GetColor(blockX, blockY, blockZ));
+						}
+					}
+				}
+
+				chunks.push_back(pCopy);
+			}
+		}
+	}
+
+	int numChunks = static_cast<int>(chunks.size());
+	if (numChunks == 0)
+	{
+		AddConsoleLabel("Chunks benchmark: no chunks loaded around the player");
+		return;
+	}
+
+	PerformanceTimer timer;
+	for (int i = 0; i < numMeshRepeats; ++i)
+	{
+		for (int j = 0; j < numChunks; ++j)
+		{
+			chunks[j]->CreateMesh();
+			chunks[j]->Unload();
+		}
+	}
+	float meshTime = timer.GetElapsedTime() * 1000.0f / (numMeshRepeats * numChunks);
+
+	// Counting the blocks of each side one at a time from the alpha of their color, as the wall flags used to
+	int numFullWalls = 0;
+	timer.Start();
+	for (int i = 0; i < numWallRepeats; ++i)
+	{
+		for (int j = 0; j < numChunks; ++j)
+		{
+			int sides[6] = { 0, 0, 0, 0, 0, 0 };
+
+			for (int a = 0; a < Chunk::CHUNK_SIZE; ++a)
+			{
+				for (int b = 0; b < Chunk::CHUNK_SIZE; ++b)
+				{
+					sides[0] += (chunks[j]->GetColor(0, a, b) & 0xFF000000) != 0 ? 1 : 0;
+					sides[1] += (chunks[j]->GetColor(Chunk::CHUNK_SIZE - 1, a, b) & 0xFF000000) != 0 ? 1 : 0;
+					sides[2] += (chunks[j]->GetColor(a, 0, b) & 0xFF000000) != 0 ? 1 : 0;
+					sides[3] += (chunks[j]->GetColor(a, Chunk::CHUNK_SIZE - 1, b) & 0xFF000000) != 0 ? 1 : 0;
+					sides[4] += (chunks[j]->GetColor(a, b, 0) & 0xFF000000) != 0 ? 1 : 0;
+					sides[5] += (chunks[j]->GetColor(a, b, Chunk::CHUNK_SIZE - 1) & 0xFF000000) != 0 ? 1 : 0;
+				}
+			}
+
+			for (int side = 0; side < 6; ++side)
+			{
+				numFullWalls += sides[side] == Chunk::CHUNK_SIZE_SQUARED ? 1 : 0;
+			}
+		}
+	}
+	float perBlockWallTime = timer.GetElapsedTime() * 1000000.0f / (numWallRepeats * numChunks);
+
+	timer.Start();
+	for (int i = 0; i < numWallRepeats; ++i)
+	{
+		for (int j = 0; j < numChunks; ++j)
+		{
+			chunks[j]->UpdateWallFlags();
+		}
+	}
+	float maskWallTime = timer.GetElapsedTime() * 1000000.0f / (numWallRepeats * numChunks);
+
+	for (int i = 0; i < numChunks; ++i)
+	{
+		delete chunks[i];
+	}
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Chunks benchmark: %i chunks around the player", numChunks);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "CreateMesh: %.1fus/chunk, Wall flags per block: %.2fns/chunk, Wall flags from masks: %.2fns/chunk (%i full sides)", meshTime, perBlockWallTime, maskWallTime, numFullWalls / numWallRepeats);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkNavigation()
+{
+	const int numChunks = 32;
+	const int numChunksY = 2;
+	const int numQueries = 2000;
+	const int numSharedGoals = 16;
+	int worldSize = numChunks * Chunk::CHUNK_SIZE;
+
+	// A world of its own, so the size doesn't depend on the loader radius
+	NavigationGraph graph(nullptr);
+	graph.SetBlockFunction(IsBenchmarkNavigationBlockSolid, &worldSize);
+
+	for (int x = 0; x < numChunks; ++x)
+	{
+		for (int z = 0; z < numChunks; ++z)
+		{
+			for (int y = 0; y < numChunksY; ++y)
+			{
+				graph.QueueChunk(x, y, z);
+			}
+		}
+	}
+
+	PerformanceTimer timer;
+	while (graph.Update(256) > 0)
+	{
+	}
+	float buildTime = timer.GetElapsedTime();
+
+	// Paths between random places, and from random places to the few towns every NPC heads to
+	std::vector<glm::vec3> starts;
+	std::vector<glm::vec3> goals;
+	std::vector<glm::vec3> sharedGoals;
+	for (int i = 0; i < numQueries; ++i)
+	{
+		starts.push_back(GetBenchmarkNavigationPosition(worldSize));
+		goals.push_back(GetBenchmarkNavigationPosition(worldSize));
+	}
+	for (int i = 0; i < numSharedGoals; ++i)
+	{
+		sharedGoals.push_back(GetBenchmarkNavigationPosition(worldSize));
+	}
+
+	std::vector<glm::vec3> path;
+	int numFound = 0;
+	int numPathPoints = 0;
+
+	timer.Start();
+	for (int i = 0; i < numQueries; ++i)
+	{
+		if (graph.FindPath(starts[i], goals[i], &path, false))
+		{
+			numFound++;
+			numPathPoints += static_cast<int>(path.size());
+		}
+	}
+	float randomTime = timer.GetElapsedTime();
+
+	timer.Start();
+	for (int i = 0; i < numQueries; ++i)
+	{
+		graph.FindPath(starts[i], sharedGoals[i % numSharedGoals], &path, false);
+	}
+	float sharedTime = timer.GetElapsedTime();
+
+	timer.Start();
+	for (int i = 0; i < numQueries; ++i)
+	{
+		graph.FindPath(starts[i], sharedGoals[i % numSharedGoals], &path, true);
+	}
+	float cachedTime = timer.GetElapsedTime();
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Navigation benchmark: %ix%i chunks, %i regions, %i edges, built in %.1fms", numChunks, numChunks, graph.GetNumNodes(), graph.GetNumEdges(), buildTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Random paths: %.0f queries/sec (%i of %i found, %.1f points each)", numQueries * 1000.0f / std::max(randomTime, 0.001f), numFound, numQueries, numPathPoints / static_cast<float>(std::max(numFound, 1)));
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Paths to %i shared goals: %.0f queries/sec searched, %.0f queries/sec cached (%i goals cached)", numSharedGoals, numQueries * 1000.0f / std::max(sharedTime, 0.001f), numQueries * 1000.0f / std::max(cachedTime, 0.001f), graph.GetNumCachedGoals());
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkTimers()
+{
+	const int numTimers = 100000;
+	const int numFrames = 600;
+	const float frameTime = 1.0f / 60.0f;
+
+	// Attack, cooldown and effect timers from a fraction of a second to half a minute, a third of them looping
+	std::vector<float> timeOuts;
+	std::vector<bool> loopings;
+	for (int i = 0; i < numTimers; ++i)
+	{
+		timeOuts.push_back(GetRandomNumber(10, 3000) * 0.01f);
+		loopings.push_back(i % 3 == 0);
+	}
+
+	// A time manager of its own, so the game's time doesn't move on and none of its timers fire
+	TimeManager timeManager;
+
+	int numFired = 0;
+	std::vector<CountdownTimerHandle> handles;
+	handles.reserve(numTimers);
+
+	PerformanceTimer timer;
+	for (int i = 0; i < numTimers; ++i)
+	{
+		CountdownTimerHandle handle = timeManager.CreateCountdownTimer();
+
+		CountdownTimerState* pState = timeManager.GetCountdownTimer(handle);
+		pState->m_timeOutTime = timeOuts[i];
+		pState->m_looping = loopings[i];
+		pState->m_callback = BenchmarkTimerFinished;
+		pState->m_pCallbackData = &numFired;
+		pState->m_elapsedTime = 0.0f;
+		pState->m_startTime = timeManager.GetTime();
+		pState->m_paused = false;
+		pState->m_started = true;
+		timeManager.RescheduleCountdownTimer(handle);
+
+		handles.push_back(handle);
+	}
+	float createTime = timer.GetElapsedTime();
+
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		timeManager.Update(frameTime);
+	}
+	float wheelTime = timer.GetElapsedTime() / numFrames;
+	int numScheduled = timeManager.GetNumScheduledCountdownTimers();
+
+	// Every other timer cancelled in turn, then the rest
+	timer.Start();
+	for (int i = 0; i < numTimers; i += 2)
+	{
+		timeManager.DestroyCountdownTimer(handles[i]);
+	}
+	for (int i = 1; i < numTimers; i += 2)
+	{
+		timeManager.DestroyCountdownTimer(handles[i]);
+	}
+	float destroyTime = timer.GetElapsedTime();
+
+	// The same timers on their own in the heap, each one looked at every frame
+	int numScanFired = 0;
+	std::vector<BenchmarkScanTimer*> vpScanTimers;
+	for (int i = 0; i < numTimers; ++i)
+	{
+		BenchmarkScanTimer* pScanTimer = new BenchmarkScanTimer();
+		pScanTimer->m_elapsedTime = 0.0f;
+		pScanTimer->m_timeOutTime = timeOuts[i];
+		pScanTimer->m_looping = loopings[i];
+		pScanTimer->m_finished = false;
+		pScanTimer->m_callback = BenchmarkTimerFinished;
+		pScanTimer->m_pCallbackData = &numScanFired;
+
+		vpScanTimers.push_back(pScanTimer);
+	}
+
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < vpScanTimers.size(); ++i)
+		{
+			BenchmarkScanTimer* pScanTimer = vpScanTimers[i];
+			pScanTimer->m_elapsedTime += frameTime;
+
+			if (pScanTimer->m_elapsedTime >= pScanTimer->m_timeOutTime && pScanTimer->m_finished == false)
+			{
+				pScanTimer->m_callback(pScanTimer->m_pCallbackData);
+
+				if (pScanTimer->m_looping)
+				{
+					pScanTimer->m_elapsedTime = 0.0f;
+				}
+				else
+				{
+					pScanTimer->m_finished = true;
+				}
+			}
+		}
+	}
+	float scanTime = timer.GetElapsedTime() / numFrames;
+
+	for (size_t i = 0; i < vpScanTimers.size(); ++i)
+	{
+		delete vpScanTimers[i];
+	}
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Timer benchmark: %i timers over %i frames, %i still counting down", numTimers, numFrames, numScheduled);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Timer wheel: %.3fms/frame (%i callbacks), created in %.2fms, destroyed in %.2fms", wheelTime, numFired, createTime, destroyTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Every timer every frame: %.3fms/frame (%i callbacks)", scanTime, numScanFired);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
+
+void CubbyGame::BenchmarkInterpolator()
+{
+	const int numTweens = 50000;
+	const int numFrames = 300;
+	const float frameTime = 1.0f / 60.0f;
+	const int numRemovedByVariable = 1000;
+
+	// Fades, bobs and attack swings, every fourth one a chain of three, all still going at the end
+	std::vector<float> starts;
+	std::vector<float> ends;
+	std::vector<float> times;
+	std::vector<float> easings;
+	for (int i = 0; i < numTweens; ++i)
+	{
+		starts.push_back(GetRandomNumber(0, 100) * 0.01f);
+		ends.push_back(GetRandomNumber(0, 100) * 0.01f);
+		times.push_back(i % 4 == 0 ? GetRandomNumber(200, 400) * 0.01f : GetRandomNumber(500, 1000) * 0.01f);
+		easings.push_back(static_cast<float>(GetRandomNumber(-100, 100)));
+	}
+
+	// An interpolator of its own, so the game's interpolations aren't moved on or removed
+	Interpolator interpolator;
+	Interpolator* pInterpolator = &interpolator;
+	std::vector<float> values(numTweens, 0.0f);
+	std::vector<InterpolationHandle> handles;
+	handles.reserve(numTweens);
+
+	PerformanceTimer timer;
+	for (int i = 0; i < numTweens; ++i)
+	{
+		if (i % 4 == 0)
+		{
+			InterpolationHandle interpolation1 = pInterpolator->CreateFloatInterpolation(&values[i], starts[i], ends[i], times[i], easings[i]);
+			InterpolationHandle interpolation2 = pInterpolator->CreateFloatInterpolation(&values[i], ends[i], starts[i], times[i], -easings[i]);
+			InterpolationHandle interpolation3 = pInterpolator->CreateFloatInterpolation(&values[i], starts[i], ends[i], times[i], easings[i]);
+			pInterpolator->LinkFloatInterpolation(interpolation1, interpolation2);
+			pInterpolator->LinkFloatInterpolation(interpolation2, interpolation3);
+			pInterpolator->AddFloatInterpolation(interpolation1);
+
+			handles.push_back(interpolation1);
+		}
+		else
+		{
+			handles.push_back(pInterpolator->AddFloatInterpolation(&values[i], starts[i], ends[i], times[i], easings[i]));
+		}
+	}
+	float createTime = timer.GetElapsedTime();
+
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		pInterpolator->Update(frameTime);
+	}
+	float poolTime = timer.GetElapsedTime() / numFrames;
+
+	int numRunning = 0;
+	for (int i = 0; i < numTweens; ++i)
+	{
+		numRunning += pInterpolator->IsInterpolating(handles[i]) ? 1 : 0;
+	}
+
+	// A few by their variable, which has to look through all of them, then the rest by their handles
+	timer.Start();
+	for (int i = 0; i < numRemovedByVariable; ++i)
+	{
+		pInterpolator->RemoveFloatInterpolationByVariable(&values[i * 2 + 1]);
+	}
+	float removeByVariableTime = timer.GetElapsedTime();
+
+	timer.Start();
+	for (int i = 0; i < numTweens; ++i)
+	{
+		pInterpolator->RemoveInterpolation(handles[i]);
+	}
+	float removeByHandleTime = timer.GetElapsedTime();
+
+	// The same interpolations on their own in the heap, each working out its bezier ease curve
+	std::vector<BenchmarkHeapTween*> vpHeapTweens;
+	for (int i = 0; i < numTweens; ++i)
+	{
+		BenchmarkHeapTween* pNext = nullptr;
+		if (i % 4 == 0)
+		{
+			pNext = new BenchmarkHeapTween();
+			*pNext = { &values[i], starts[i], ends[i], times[i], easings[i], 0.0f, nullptr };
+
+			BenchmarkHeapTween* pSecond = new BenchmarkHeapTween();
+			*pSecond = { &values[i], ends[i], starts[i], times[i], -easings[i], 0.0f, pNext };
+			pNext = pSecond;
+		}
+
+		BenchmarkHeapTween* pHeapTween = new BenchmarkHeapTween();
+		*pHeapTween = { &values[i], starts[i], ends[i], times[i], easings[i], 0.0f, pNext };
+
+		vpHeapTweens.push_back(pHeapTween);
+	}
+
+	timer.Start();
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < vpHeapTweens.size(); ++i)
+		{
+			BenchmarkHeapTween* pHeapTween = vpHeapTweens[i];
+			if (pHeapTween->m_elapsed < pHeapTween->m_time)
+			{
+				float x = (pHeapTween->m_easing * 0.005f) + 0.5f;
+				Bezier3 easeBezier = Bezier3(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(x, 1.0f - x, 0.0f));
+				glm::vec3 vectorT = easeBezier.GetInterpolatedPoint(pHeapTween->m_elapsed / pHeapTween->m_time);
+
+				*pHeapTween->m_pVariable = pHeapTween->m_start + ((pHeapTween->m_end - pHeapTween->m_start) * vectorT.y);
+				pHeapTween->m_elapsed += frameTime;
+			}
+			else
+			{
+				*pHeapTween->m_pVariable = pHeapTween->m_end;
+
+				if (pHeapTween->m_pNext != nullptr)
+				{
+					vpHeapTweens[i] = pHeapTween->m_pNext;
+					delete pHeapTween;
+				}
+			}
+		}
+	}
+	float heapTime = timer.GetElapsedTime() / numFrames;
+
+	for (size_t i = 0; i < vpHeapTweens.size(); ++i)
+	{
+		BenchmarkHeapTween* pHeapTween = vpHeapTweens[i];
+		while (pHeapTween != nullptr)
+		{
+			BenchmarkHeapTween* pNext = pHeapTween->m_pNext;
+			delete pHeapTween;
+			pHeapTween = pNext;
+		}
+	}
+
+	char benchmarkBuff[256];
+	sprintf(benchmarkBuff, "Interpolator benchmark: %i interpolations over %i frames, %i of them chained, %i still running", numTweens, numFrames, numTweens / 4, numRunning);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Pooled: %.3fms/frame, created in %.2fms, %i removed by variable in %.2fms, the rest by handle in %.2fms", poolTime, createTime, numRemovedByVariable, removeByVariableTime, removeByHandleTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+
+	sprintf(benchmarkBuff, "Each in the heap: %.3fms/frame", heapTime);
+	AddConsoleLabel(benchmarkBuff);
+	std::cout << benchmarkBuff << std::endl;
+}
@@ -891,4 +891,15 @@ void CubbyGame::ConsoleReturnPressed()
 	AddConsoleLabel(chatMessage);
 
 	m_pConsoleTextbox->SetText("");
+
+	// Debug commands
+	std::string benchmarkCommand = "/benchmark ";
+	if (chatMessage.compare(0, benchmarkCommand.length(), benchmarkCommand) == 0)
+	{
+		RunBenchmark(chatMessage.substr(benchmarkCommand.length()));
+	}
+	else if (chatMessage == "/resethitches")
+	{
+		m_hitchHistogram.Reset();
+	}
 }
\ No newline at end of file
@@ -19,12 +19,30 @@
 #include <glew/include/GL/glew.h>
 #include <glm/detail/func_geometric.hpp>
 
+#include <Models/MS3DAnimatorBatch.h>
+#include <Models/MS3DModelManager.h>
+#include <Utils/AssetLoader.h>
+#include <Utils/AssetPack.h>
 #include <Utils/Interpolator.h>
+#include <Utils/PerformanceTimer.h>
+#include <Utils/ThreadPool.h>
 
 #include "CubbyGame.h"
 
 extern std::string g_soundEffectFileNames[static_cast<int>(SoundEffect::NumSoundEffect)];
 
+// How far along the cursor ray enemies can be targeted
+const float ENEMY_TARGET_DISTANCE = 50.0f;
+
+// Models the chunk threads stamp into the terrain, everything else is streamed in when it is first used
+const char* PREFETCH_QUBICLE_BINARY_FILES[] =
+{
+	"Resources/gamedata/terrain/plains/smalltree.qb",
+	"Resources/gamedata/terrain/desert/cactus1.qb",
+	"Resources/gamedata/terrain/tundra/tundra_tree1.qb",
+	"Resources/gamedata/terrain/ashlands/ashtree1.qb",
+};
+
 // Initialize the singleton instance
 CubbyGame* CubbyGame::m_instance = nullptr;
 
@@ -41,6 +59,8 @@ CubbyGame* CubbyGame::GetInstance()
 // Creation
 void CubbyGame::Create(CubbySettings* pCubbySettings)
 {
+	PerformanceTimer startupTimer;
+
 	m_pRenderer = nullptr;
 	m_pGameCamera = nullptr;
 	m_pQubicleBinaryManager = nullptr;
@@ -57,8 +77,16 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pHUD = nullptr;
 
 	m_GUICreated = false;
+	m_numGUIDrawCalls = 0;
 
 	m_pCubbySettings = pCubbySettings;
+
+	// Open the baked asset pack before anything is loaded, loose files are used for whatever is not in it or was edited since
+	if (m_pCubbySettings->m_useAssetPack)
+	{
+		AssetPack::GetInstance()->Open("Resources/gamedata.pack");
+	}
+
 	m_pCubbyWindow = new CubbyWindow(this, m_pCubbySettings);
 
 	// Create the window
@@ -162,10 +190,9 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 
 	// Create the frame buffers
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "SSAO", &m_SSAOFrameBuffer);
-	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 5.0f, "Shadow", &m_shadowFrameBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Deferred Lighting", &m_lightingFrameBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Transparency", &m_transparencyFrameBuffer);
-	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Water Reflection", &m_waterReflectionFrameBuffer);
+	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, m_pCubbySettings->m_waterReflectionScale, "Water Reflection", &m_waterReflectionFrameBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FXAA", &m_FXAAFrameBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 1st Pass", &m_firstPassFullscreenBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 2nd Pass", &m_secondPassFullscreenBuffer);
@@ -174,6 +201,13 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, 800, 800, 1.0f, "Portrait", &m_portraitBuffer);
 	m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, 800, 800, 1.0f, "Portrait SSAO Texture", &m_portraitSSAOTextureBuffer);
 
+	// Create the shadow maps, these don't depend on the window size
+	m_pShadowCascades = new ShadowCascades(m_pRenderer);
+	m_pShadowCascades->Create(m_pCubbySettings->m_shadowCascades, m_pCubbySettings->m_shadowMapSize);
+
+	// Create the water reflection planner
+	m_pReflectionPlanner = new ReflectionPlanner(m_pRenderer);
+
 	// Create the shaders
 	m_defaultShader = -1;
 	m_phongShader = -1;
@@ -181,6 +215,7 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_shadowShader = -1;
 	m_waterShader = -1;
 	m_lightingShader = -1;
+	m_clusteredLightingShader = -1;
 	m_cubeMapShader = -1;
 	m_textureShader = -1;
 	m_fxaaShader = -1;
@@ -195,6 +230,10 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/SSAO.vertex", "Resources/shaders/fullscreen/SSAO.pixel", &m_SSAOShader);
 	m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/fxaa.vertex", "Resources/shaders/fullscreen/fxaa.pixel", &m_fxaaShader);
 	m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/lighting.vertex", "Resources/shaders/fullscreen/lighting.pixel", &m_lightingShader);
+	if (LightClusters::IsSupported())
+	{
+		m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/clustered_lighting.vertex", "Resources/shaders/fullscreen/clustered_lighting.pixel", &m_clusteredLightingShader);
+	}
 	m_pRenderer->LoadGLSLShader("Resources/shaders/cube_map.vertex", "Resources/shaders/cube_map.pixel", &m_cubeMapShader);
 	m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/blur_vertical.vertex", "Resources/shaders/fullscreen/blur_vertical.pixel", &m_blurVerticalShader);
 	m_pRenderer->LoadGLSLShader("Resources/shaders/fullscreen/blur_horizontal.vertex", "Resources/shaders/fullscreen/blur_horizontal.pixel", &m_blurHorizontalShader);
@@ -210,6 +249,15 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	// Create the qubicle binary file manager
 	m_pQubicleBinaryManager = new QubicleBinaryManager(m_pRenderer);
 
+	// The asset loader is created here, so the main thread is the one that uploads the loaded assets
+	AssetLoader::GetInstance();
+
+	// Start loading the terrain models in the background, so the first chunks don't stall loading them on the chunk threads
+	for (size_t i = 0; i < sizeof(PREFETCH_QUBICLE_BINARY_FILES) / sizeof(PREFETCH_QUBICLE_BINARY_FILES[0]); ++i)
+	{
+		m_pQubicleBinaryManager->PrefetchQubicleBinaryFile(PREFETCH_QUBICLE_BINARY_FILES[i]);
+	}
+
 	// Create the chunk manager
 	m_pChunkManager = new ChunkManager(m_pRenderer, m_pCubbySettings, m_pQubicleBinaryManager);
 	m_pChunkManager->SetStepLockEnabled(m_pCubbySettings->m_stepUpdating);
@@ -263,6 +311,12 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	// Create the projectile manager
 	m_pProjectileManager = new ProjectileManager(m_pRenderer, m_pChunkManager);
 
+	// Create the spatial grid shared by everything that moves
+	m_pSpatialGrid = new SpatialGrid();
+
+	// Create the navigation graph, filled in as the chunks are loaded
+	m_pNavigationGraph = new NavigationGraph(m_pChunkManager);
+
 	// Create the front-end manager
 	m_pFrontendManager = new FrontendManager(m_pRenderer, m_pGUI);
 	m_pFrontendManager->SetWindowDimensions(m_windowWidth, m_windowHeight);
@@ -285,6 +339,7 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pChunkManager->SetNPCManager(m_pNPCManager);
 	m_pChunkManager->SetBlockParticleManager(m_pBlockParticleManager);
 	m_pChunkManager->SetItemManager(m_pItemManager);
+	m_pChunkManager->SetNavigationGraph(m_pNavigationGraph);
 	m_pPlayer->SetInventoryManager(m_pInventoryManager);
 	m_pPlayer->SetItemManager(m_pItemManager);
 	m_pPlayer->SetProjectileManager(m_pProjectileManager);
@@ -303,6 +358,8 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pNPCManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pNPCManager->SetProjectileManager(m_pProjectileManager);
 	m_pNPCManager->SetEnemyManager(m_pEnemyManager);
+	m_pNPCManager->SetSpatialGrid(m_pSpatialGrid);
+	m_pNPCManager->SetNavigationGraph(m_pNavigationGraph);
 	m_pEnemyManager->SetLightingManager(m_pLightingManager);
 	m_pEnemyManager->SetBlockParticleManager(m_pBlockParticleManager);
 	m_pEnemyManager->SetTextEffectsManager(m_pTextEffectsManager);
@@ -311,6 +368,7 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pEnemyManager->SetHUD(m_pHUD);
 	m_pEnemyManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pEnemyManager->SetNPCManager(m_pNPCManager);
+	m_pEnemyManager->SetSpatialGrid(m_pSpatialGrid);
 	m_pInventoryManager->SetPlayer(m_pPlayer);
 	m_pInventoryManager->SetInventoryGUI(m_pInventoryGUI);
 	m_pInventoryManager->SetLootGUI(m_pLootGUI);
@@ -320,10 +378,12 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	m_pItemManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 	m_pItemManager->SetInventoryManager(m_pInventoryManager);
 	m_pItemManager->SetNPCManager(m_pNPCManager);
+	m_pItemManager->SetSpatialGrid(m_pSpatialGrid);
 	m_pProjectileManager->SetLightingManager(m_pLightingManager);
 	m_pProjectileManager->SetBlockParticleManager(m_pBlockParticleManager);
 	m_pProjectileManager->SetPlayer(m_pPlayer);
 	m_pProjectileManager->SetQubicleBinaryManager(m_pQubicleBinaryManager);
+	m_pProjectileManager->SetSpatialGrid(m_pSpatialGrid);
 	m_pQuestManager->SetNPCManager(m_pNPCManager);
 	m_pQuestManager->SetInventoryManager(m_pInventoryManager);
 	m_pQuestManager->SetQuestJournal(m_pQuestJournal);
@@ -446,6 +506,11 @@ void CubbyGame::Create(CubbySettings* pCubbySettings)
 	SetupGUI();
 	SkinGUI();
 	UpdateGUI(0.0f);
+
+	char startupText[128];
+	sprintf(startupText, "Startup took %.0fms, asset pack %s (%i files)", startupTimer.GetElapsedTime(), AssetPack::GetInstance()->IsOpen() ? "on" : "off", AssetPack::GetInstance()->GetNumFiles());
+	std::cout << startupText << "\n";
+	AddConsoleLabel(startupText);
 }
 
 // Destruction
@@ -453,6 +518,12 @@ void CubbyGame::Destroy()
 {
 	if (m_instance)
 	{
+		// The enemy flow fields wait for their searches, so they go while the loader is still there
+		m_pEnemyManager->ClearFlowFields();
+
+		// Stop the background loads before the models they are loading into are deleted
+		AssetLoader::GetInstance()->Destroy();
+
 		delete m_pSkybox;
 		delete m_pChunkManager;
 		delete m_pItemManager;
@@ -463,6 +534,8 @@ void CubbyGame::Destroy()
 		delete m_pNPCManager;
 		delete m_pEnemyManager;
 		delete m_pLightingManager;
+		delete m_pShadowCascades;
+		delete m_pReflectionPlanner;
 		delete m_pSceneryManager;
 		delete m_pBlockParticleManager;
 		delete m_pTextEffectsManager;
@@ -479,12 +552,20 @@ void CubbyGame::Destroy()
 		delete m_pCraftingGUI;
 		delete m_pQuestGUI;
 		delete m_pActionBar;
+		delete m_pSpatialGrid;
+		delete m_pNavigationGraph;
 
 		// Destroy the GUI components before we delete the GUI manager object.
 		DestroyGUI();
 		delete m_pGUI;
 		delete m_pRenderer;
 
+		// Shared skeletons are released last, after every character using them has been deleted
+		MS3DModelManager::GetInstance()->Destroy();
+		MS3DAnimatorBatch::GetInstance()->Destroy();
+		ThreadPool::GetInstance()->Destroy();
+		AssetPack::GetInstance()->Destroy();
+
 		SoundManager::GetInstance()->Shutdown();
 
 		m_pCubbyWindow->Destroy();
@@ -671,10 +752,9 @@ void CubbyGame::ResizeWindow(int width, int height)
 
 		// Resize the frame buffers
 		m_pRenderer->CreateFrameBuffer(m_SSAOFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "SSAO", &m_SSAOFrameBuffer);
-		m_pRenderer->CreateFrameBuffer(m_shadowFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 5.0f, "Shadow", &m_shadowFrameBuffer);
 		m_pRenderer->CreateFrameBuffer(m_lightingFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Deferred Lighting", &m_lightingFrameBuffer);
 		m_pRenderer->CreateFrameBuffer(m_transparencyFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Transparency", &m_transparencyFrameBuffer);
-		m_pRenderer->CreateFrameBuffer(m_waterReflectionFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Water Reflection", &m_waterReflectionFrameBuffer);
+		m_pRenderer->CreateFrameBuffer(m_waterReflectionFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, m_pCubbySettings->m_waterReflectionScale, "Water Reflection", &m_waterReflectionFrameBuffer);
 		m_pRenderer->CreateFrameBuffer(m_FXAAFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FXAA", &m_FXAAFrameBuffer);
 		m_pRenderer->CreateFrameBuffer(m_firstPassFullscreenBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 1st Pass", &m_firstPassFullscreenBuffer);
 		m_pRenderer->CreateFrameBuffer(m_secondPassFullscreenBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 2nd Pass", &m_secondPassFullscreenBuffer);
@@ -1364,7 +1444,12 @@ void CubbyGame::SetEnemyTarget()
 		int cursorX = static_cast<int>(m_windowWidth*0.5f);
 		int cursorY = static_cast<int>(m_windowHeight*0.5f);
 
-		Enemy* pEnemy = m_pEnemyManager->GetCursorEnemy(m_pGameCamera, cursorX, cursorY);
+		glm::vec3 rayOrigin;
+		glm::vec3 rayDirection;
+		float rayLength;
+		GetCursorRay(cursorX, cursorY, &rayOrigin, &rayDirection, &rayLength);
+
+		Enemy* pEnemy = m_pEnemyManager->GetCursorEnemy(rayOrigin, rayDirection, std::min(rayLength, ENEMY_TARGET_DISTANCE));
 
 		if (pEnemy != nullptr && pEnemy->GetErase() == false)
 		{
@@ -1552,6 +1637,11 @@ ModsManager* CubbyGame::GetModsManager() const
 	return m_pModsManager;
 }
 
+QubicleBinaryManager* CubbyGame::GetQubicleBinaryManager() const
+{
+	return m_pQubicleBinaryManager;
+}
+
 CharacterGUI* CubbyGame::GetCharacterGUI() const
 {
 	return m_pCharacterGUI;
@@ -34,6 +34,7 @@
 #include <Items/RandomLootManager.h>
 #include <Lighting/LightingManager.h>
 #include <Mods/ModsManager.h>
+#include <NPC/NavigationGraph.h>
 #include <NPC/NPCManager.h>
 #include <Particles/BlockParticleManager.h>
 #include <Player/Player.h>
@@ -41,13 +42,18 @@
 #include <Quests/QuestJournal.h>
 #include <Quests/QuestManager.h>
 #include <Renderer/Camera.h>
+#include <Renderer/ReflectionPlanner.h>
 #include <Renderer/Renderer.h>
+#include <Renderer/ShadowCascades.h>
 #include <Scenery/SceneryManager.h>
 #include <Skybox/Skybox.h>
 #include <Sounds/SoundManager.h>
 #include <Sounds/SoundEffects.h>
 #include <TextEffects/TextEffectsManager.h>
 
+#include <Utils/HitchHistogram.h>
+#include <Utils/SpatialGrid.h>
+
 #include "CubbySettings.h"
 #include "CubbyWindow.h"
 
@@ -205,6 +211,8 @@ public:
 	// Updating
 	void Update();
 	void UpdateNamePicking();
+	// The ray from the near plane through the cursor, pLength is how far it goes to the far plane
+	void GetCursorRay(int cursorX, int cursorY, glm::vec3* pOrigin, glm::vec3* pDirection, float* pLength) const;
 	void UpdatePlayerAlpha(float dt) const;
 	void UpdateLights(float dt);
 	void UpdateGUI(float dt);
@@ -217,15 +225,18 @@ public:
 	void Render();
 	void RenderSkybox() const;
 	void RenderShadows() const;
+	void RenderShadowCasters(bool isNearestCascade) const;
 	void RenderWaterReflections() const;
 	void RenderWater() const;
 	void RenderDeferredLighting() const;
+	void RenderLightVolumes() const;
+	void RenderClusteredLighting() const;
 	void RenderTransparency() const;
 	void RenderSSAOTexture() const;
 	void RenderFXAATexture() const;
 	void RenderFirstPassFullScreen() const;
 	void RenderSecondPassFullScreen() const;
-	void RenderGUI() const;
+	void RenderGUI();
 	void RenderHUD() const;
 	void RenderCinematicLetterBox() const;
 	void RenderCrosshair() const;
@@ -237,6 +248,22 @@ public:
 	void RenderDeferredRenderingPortrait() const;
 	void RenderDebugInformation();
 
+	// Benchmarks
+	void RunBenchmark(std::string benchmarkName);
+	void BenchmarkAnimation();
+	void BenchmarkQubicleImport();
+	void BenchmarkText();
+	void BenchmarkLights();
+	void BenchmarkSpatialGrid();
+	void BenchmarkEntityUpdate();
+	void BenchmarkFlowField();
+	void BenchmarkNavigation();
+	void BenchmarkPicking();
+	void BenchmarkCollision();
+	void BenchmarkChunks();
+	void BenchmarkTimers();
+	void BenchmarkInterpolator();
+
 	// GUI Helper functions
 	bool IsGUIWindowStillDisplayed() const;
 	void CloseAllGUIWindows() const;
@@ -271,6 +298,7 @@ public:
 	InventoryManager* GetInventoryManager() const;
 	RandomLootManager* GetRandomLootManager() const;
 	ModsManager* GetModsManager() const;
+	QubicleBinaryManager* GetQubicleBinaryManager() const;
 	CharacterGUI* GetCharacterGUI() const;
 	QuestGUI* GetQuestGUI() const;
 	HUD* GetHUD() const;
@@ -346,6 +374,12 @@ private:
 	// Projectile manager
 	ProjectileManager* m_pProjectileManager;
 
+	// Spatial grid of the player, NPCs, enemies, items and projectiles
+	SpatialGrid* m_pSpatialGrid;
+
+	// Walkable regions of the loaded chunks, for the NPC paths
+	NavigationGraph* m_pNavigationGraph;
+
 	// Quest manager
 	QuestManager* m_pQuestManager;
 
@@ -430,9 +464,14 @@ private:
 	// Materials
 	unsigned int m_defaultMaterial;
 
+	// Shadow maps
+	ShadowCascades* m_pShadowCascades;
+
+	// Water reflections
+	ReflectionPlanner* m_pReflectionPlanner;
+
 	// Frame buffers
 	unsigned int m_SSAOFrameBuffer;
-	unsigned int m_shadowFrameBuffer;
 	unsigned int m_lightingFrameBuffer;
 	unsigned int m_transparencyFrameBuffer;
 	unsigned int m_waterReflectionFrameBuffer;
@@ -451,6 +490,7 @@ private:
 	unsigned int m_shadowShader;
 	unsigned int m_waterShader;
 	unsigned int m_lightingShader;
+	unsigned int m_clusteredLightingShader;
 	unsigned int m_cubeMapShader;
 	unsigned int m_textureShader;
 	unsigned int m_fxaaShader;
@@ -487,6 +527,10 @@ private:
 #endif //_WIN32
 	float m_deltaTime;
 	float m_fps;
+	HitchHistogram m_hitchHistogram;
+
+	// Draw calls made by the last GUI render
+	int m_numGUIDrawCalls;
 
 	// Initial starting wait timer
 	float m_initialWaitTimer;
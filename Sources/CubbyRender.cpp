@@ -9,6 +9,11 @@
 
 #include <glm/detail/func_geometric.hpp>
 
+#include <Models/MS3DAnimatorBatch.h>
+#include <Models/MS3DModelManager.h>
+#include <Utils/AssetLoader.h>
+#include <Utils/PerformanceTimer.h>
+
 #include "CubbyGame.h"
 
 // Rendering
@@ -31,11 +36,36 @@ void CubbyGame::BeginShaderRender() const
 		m_pRenderer->BeginGLSLShader(m_shadowShader);
 
 		pShader = m_pRenderer->GetShader(m_shadowShader);
-		GLuint shadowMapUniform = glGetUniformLocationARB(pShader->GetProgramObject(), "ShadowMap");
-		m_pRenderer->PrepareShaderTexture(7, shadowMapUniform);
-		m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_shadowFrameBuffer));
-		glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "renderShadow"), m_pCubbySettings->m_shadows);
-		glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "alwaysShadow"), false);
+
+		// Cascade 0 goes on texture unit 7, and the rest count down from there
+		int numCascades = m_pShadowCascades->GetNumCascades();
+		float cascadeScales[ShadowCascades::MAX_CASCADES * 3];
+		float cascadeOffsets[ShadowCascades::MAX_CASCADES * 3];
+		char samplerName[32];
+
+		for (int i = numCascades - 1; i >= 0; --i)
+		{
+			sprintf(samplerName, "ShadowMap%i", i);
+			m_pRenderer->PrepareShaderTexture(7 - i, pShader->GetUniformLocation(samplerName));
+			m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_pShadowCascades->GetFrameBuffer(i)));
+
+			glm::vec3 scale;
+			glm::vec3 offset;
+			m_pShadowCascades->GetShadowMapTransform(i, &scale, &offset);
+			cascadeScales[i * 3] = scale.x;
+			cascadeScales[i * 3 + 1] = scale.y;
+			cascadeScales[i * 3 + 2] = scale.z;
+			cascadeOffsets[i * 3] = offset.x;
+			cascadeOffsets[i * 3 + 1] = offset.y;
+			cascadeOffsets[i * 3 + 2] = offset.z;
+		}
+
+		glUniform1iARB(pShader->GetUniformLocation("numCascades"), numCascades);
+		glUniform3fvARB(pShader->GetUniformLocation("cascadeScale"), numCascades, cascadeScales);
+		glUniform3fvARB(pShader->GetUniformLocation("cascadeOffset"), numCascades, cascadeOffsets);
+		glUniform1fARB(pShader->GetUniformLocation("shadowTexelSize"), 1.0f / m_pShadowCascades->GetMapSize());
+		glUniform1iARB(pShader->GetUniformLocation("renderShadow"), m_pCubbySettings->m_shadows);
+		glUniform1iARB(pShader->GetUniformLocation("alwaysShadow"), false);
 	}
 	else
 	{
@@ -45,7 +75,7 @@ void CubbyGame::BeginShaderRender() const
 	}
 
 	bool fogEnabled = (m_pFrontendManager->GetFrontendScreen() == FrontendScreen::MainMenu) ? false : m_pCubbySettings->m_fogRendering;
-	glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "enableFog"), fogEnabled);
+	glUniform1iARB(pShader->GetUniformLocation("enableFog"), fogEnabled);
 	float fogEnd = m_pChunkManager->GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE;
 	float fogStart = fogEnd - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f;
 	GLfloat fogColor[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
@@ -56,6 +86,9 @@ void CubbyGame::BeginShaderRender() const
 	glFogf(GL_FOG_START, fogStart);
 	glFogf(GL_FOG_END, fogEnd);
 	glEnable(GL_FOG);
+
+	// The same fog for shaders that read it from the frame uniforms
+	m_pRenderer->SetFrameFog(fogEnabled, fogStart, fogEnd, Color(fogColor[0], fogColor[1], fogColor[2], fogColor[3]));
 }
 
 void CubbyGame::EndShaderRender() const
@@ -83,6 +116,10 @@ void CubbyGame::Render()
 	// Begin rendering
 	m_pRenderer->BeginScene(true, true, true);
 
+	// Queue this frame's draws, each pass below draws the packets marked for it
+	m_pRenderer->ClearRenderQueue();
+	m_pChunkManager->SubmitRenderPackets();
+
 	// Shadow rendering to the shadow frame buffer
 	if (m_pCubbySettings->m_shadows)
 	{
@@ -124,7 +161,7 @@ void CubbyGame::Render()
 	}
 
 	// Water reflections
-	if (m_pCubbySettings->m_waterRendering && m_pChunkManager->IsUnderWater(m_pGameCamera->GetPosition()) == false && m_gameMode != GameMode::FrontEnd)
+	if (m_pCubbySettings->m_waterRendering && m_gameMode != GameMode::FrontEnd)
 	{
 		RenderWaterReflections();
 	}
@@ -153,7 +190,7 @@ void CubbyGame::Render()
 	BeginShaderRender();
 	{
 		// Render the chunks
-		m_pChunkManager->Render(false);
+		m_pChunkManager->Render(RenderPass::Normal);
 	}
 	EndShaderRender();
 
@@ -244,7 +281,10 @@ void CubbyGame::Render()
 		m_pEnemyManager->RenderWeaponTrails();
 
 		// Render water
-		RenderWater();
+		if (m_pReflectionPlanner->IsWaterVisible())
+		{
+			RenderWater();
+		}
 	}
 
 	// Debug rendering
@@ -425,7 +465,7 @@ void CubbyGame::RenderSkybox() const
 	m_pRenderer->BeginGLSLShader(m_cubeMapShader);
 
 	glShader* pShader = m_pRenderer->GetShader(m_cubeMapShader);
-	unsigned int cubemapTexture1 = glGetUniformLocationARB(pShader->GetProgramObject(), "cubemap1");
+	unsigned int cubemapTexture1 = pShader->GetUniformLocation("cubemap1");
 	m_pRenderer->PrepareShaderTexture(0, cubemapTexture1);
 	m_pRenderer->BindCubeTexture(m_pSkybox->GetCubeMapTexture1());
 
@@ -452,23 +492,62 @@ void CubbyGame::RenderSkybox() const
 
 void CubbyGame::RenderShadows() const
 {
+	m_pShadowCascades->Update(m_pPlayer->GetCenter(), m_defaultLightPosition, m_defaultLightView, m_pChunkManager->GetLoaderRadius());
+
+	bool isStaticCached = m_pShadowCascades->IsStaticCacheSupported();
+
 	m_pRenderer->PushMatrix();
 
-	m_pRenderer->StartRenderingToFrameBuffer(m_shadowFrameBuffer);
+	m_pRenderer->SetCullMode(CullMode::FRONT);
 	m_pRenderer->SetColorMask(false, false, false, false);
 
-	float loaderRadius = m_pChunkManager->GetLoaderRadius();
-	m_pRenderer->SetupOrthographicProjection(-loaderRadius, loaderRadius, -loaderRadius, loaderRadius, 0.01f, 1000.0f);
-	glm::vec3 lightPos = m_defaultLightPosition + m_pPlayer->GetCenter(); // Make sure our light is always offset from the player
-	m_pRenderer->SetLookAtCamera(glm::vec3(lightPos.x, lightPos.y, lightPos.z), m_pPlayer->GetCenter(), glm::vec3(0.0f, 1.0f, 0.0f));
+	for (int i = 0; i < m_pShadowCascades->GetNumCascades(); ++i)
+	{
+		const RenderCullBox& cullBox = m_pShadowCascades->GetCullBox(i);
 
-	m_pRenderer->PushMatrix();
+		// The chunks only change when one is rebuilt or the cascade moves, so they are kept in the static cache until then
+		if (isStaticCached && m_pShadowCascades->IsStaticCacheDirty(i))
+		{
+			m_pRenderer->StartRenderingToFrameBuffer(m_pShadowCascades->GetStaticFrameBuffer(i));
+			m_pShadowCascades->SetupProjection(i);
 
-	m_pRenderer->SetCullMode(CullMode::FRONT);
+			m_pChunkManager->Render(RenderPass::Shadow, cullBox);
+
+			m_pRenderer->StopRenderingToFrameBuffer(m_pShadowCascades->GetStaticFrameBuffer(i));
+			m_pShadowCascades->SetStaticCacheDrawn(i);
+		}
+
+		m_pRenderer->StartRenderingToFrameBuffer(m_pShadowCascades->GetFrameBuffer(i));
+
+		if (isStaticCached)
+		{
+			m_pRenderer->CopyFrameBufferDepth(m_pShadowCascades->GetStaticFrameBuffer(i), m_pShadowCascades->GetFrameBuffer(i));
+		}
+
+		m_pShadowCascades->SetupProjection(i);
+
+		if (isStaticCached == false)
+		{
+			m_pChunkManager->Render(RenderPass::Shadow, cullBox);
+		}
+
+		// Everything that moves is drawn over the chunks every frame
+		RenderShadowCasters(i == 0);
+
+		m_pRenderer->StopRenderingToFrameBuffer(m_pShadowCascades->GetFrameBuffer(i));
+	}
+
+	// The shadow shader picks a cascade itself, so it only needs positions in the light's view
+	m_pRenderer->SetTextureMatrix(m_pShadowCascades->GetLightViewMatrix());
+
+	m_pRenderer->SetColorMask(true, true, true, true);
+	m_pRenderer->SetCullMode(CullMode::BACK);
 
-	// Render the chunks
-	m_pChunkManager->Render(true);
+	m_pRenderer->PopMatrix();
+}
 
+void CubbyGame::RenderShadowCasters(bool isNearestCascade) const
+{
 	if (m_gameMode != GameMode::FrontEnd)
 	{
 		// Render the player
@@ -482,41 +561,41 @@ void CubbyGame::RenderShadows() const
 	// Enemies
 	m_pEnemyManager->Render(false, true, false, true);
 
-	// Projectiles
-	m_pProjectileManager->Render();
-
 	// Scenery
 	m_pSceneryManager->Render(false, false, true, false, false);
 
 	// Items
 	m_pItemManager->Render(false, false, false, true);
 
-	// Render the block particles
-	m_pBlockParticleManager->Render(false);
-
-	// Render the instanced objects
-	if (m_instanceRender)
+	// Small casters only show up close to the player
+	if (isNearestCascade)
 	{
-		m_pInstanceManager->Render();
-	}
+		// Projectiles
+		m_pProjectileManager->Render();
 
-	m_pRenderer->SetTextureMatrix();
-	m_pRenderer->SetCullMode(CullMode::BACK);
-	
-	m_pRenderer->PopMatrix();
+		// Render the block particles
+		m_pBlockParticleManager->Render(false);
 
-	m_pRenderer->SetColorMask(true, true, true, true);
-	m_pRenderer->StopRenderingToFrameBuffer(m_shadowFrameBuffer);
-	
-	m_pRenderer->PopMatrix();
+		// Render the instanced objects
+		if (m_instanceRender)
+		{
+			m_pInstanceManager->Render();
+		}
+	}
 }
 
 void CubbyGame::RenderWaterReflections() const
 {
-	m_pRenderer->StartRenderingToFrameBuffer(m_waterReflectionFrameBuffer);
+	PerformanceTimer passTimer;
+
+	glm::vec3 waterCenter(m_pPlayer->GetCenter().x, m_pChunkManager->GetWaterHeight(), m_pPlayer->GetCenter().z);
+	bool isUnderWater = m_pChunkManager->IsUnderWater(m_pGameCamera->GetPosition());
 
-	if (m_pChunkManager->IsUnderWater(m_pGameCamera->GetPosition()) == false)
+	// Nothing is drawn when the water is out of view, and at half rate every other frame reprojects the last reflection
+	if (m_pReflectionPlanner->Plan(m_defaultViewport, waterCenter, ChunkManager::WATER_RENDER_DISTANCE, isUnderWater, m_pCubbySettings->m_waterReflectionHalfRate) == ReflectionUpdate::Render)
 	{
+		m_pRenderer->StartRenderingToFrameBuffer(m_waterReflectionFrameBuffer);
+
 		m_pRenderer->PushMatrix();
 		
 		m_pRenderer->SetClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -528,7 +607,7 @@ void CubbyGame::RenderWaterReflections() const
 		m_pRenderer->EnableClipPlane(0, 0.0f, 1.0f, 0.0f, -m_pChunkManager->GetWaterHeight());
 
 		// Render the chunks
-		m_pChunkManager->Render(true);
+		m_pChunkManager->Render(RenderPass::Reflection);
 
 		// Player
 		if (m_gameMode != GameMode::FrontEnd)
@@ -565,8 +644,14 @@ void CubbyGame::RenderWaterReflections() const
 		m_pRenderer->DisableClipPlane(0);
 		
 		m_pRenderer->PopMatrix();
+
+		m_pRenderer->StopRenderingToFrameBuffer(m_waterReflectionFrameBuffer);
+
+		// The water samples the reflection through the camera it was drawn from
+		m_pReflectionPlanner->SetRendered();
 	}
-	m_pRenderer->StopRenderingToFrameBuffer(m_waterReflectionFrameBuffer);
+
+	m_pReflectionPlanner->SetPassTime(passTimer.GetElapsedTime());
 }
 
 void CubbyGame::RenderWater() const
@@ -576,15 +661,21 @@ void CubbyGame::RenderWater() const
 	m_pRenderer->BeginGLSLShader(m_waterShader);
 
 	glShader* pShader = pShader = m_pRenderer->GetShader(m_waterShader);
-	unsigned int reflectionTexture = glGetUniformLocationARB(pShader->GetProgramObject(), "reflectionTexture");
-	unsigned int cubemapTexture = glGetUniformLocationARB(pShader->GetProgramObject(), "cubemap");
+	unsigned int reflectionTexture = pShader->GetUniformLocation("reflectionTexture");
+	unsigned int cubemapTexture = pShader->GetUniformLocation("cubemap");
 	
-	if (m_pChunkManager->IsUnderWater(m_pGameCamera->GetPosition()) == false)
+	if (m_pReflectionPlanner->HasReflection())
 	{
 		glActiveTextureARB(GL_TEXTURE1_ARB);
 		m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_waterReflectionFrameBuffer));
 		glUniform1iARB(reflectionTexture, 1);
 
+		// An older reflection is looked up where it was drawn, rather than where the camera is now
+		float reflectionMatrix[16];
+		m_pReflectionPlanner->GetReflectionMatrix().GetMatrix(reflectionMatrix);
+		glUniformMatrix4fvARB(pShader->GetUniformLocation("reflectionMatrix"), 1, GL_FALSE, reflectionMatrix);
+		glUniform3fARB(pShader->GetUniformLocation("waterOffset"), m_pPlayer->GetCenter().x, 0.0f, m_pPlayer->GetCenter().z);
+
 		glActiveTextureARB(GL_TEXTURE0_ARB);
 		m_pRenderer->BindCubeTexture(m_pSkybox->GetCubeMapTexture1());
 		glUniform1iARB(cubemapTexture, 0);
@@ -601,7 +692,7 @@ void CubbyGame::RenderWater() const
 		glActiveTextureARB(GL_TEXTURE1_ARB);
 	}
 
-	glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "enableFog"), m_pCubbySettings->m_fogRendering);
+	glUniform1iARB(pShader->GetUniformLocation("enableFog"), m_pCubbySettings->m_fogRendering);
 	float fogEnd = m_pChunkManager->GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE;
 	float fogStart = fogEnd - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 2.0f;
 	GLfloat fogColor[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
@@ -648,14 +739,36 @@ void CubbyGame::RenderDeferredLighting() const
 	// Set the look at camera
 	m_pGameCamera->Look();
 
+	// One fullscreen pass over the light clusters, or a sphere drawn for every light
+	if (m_pCubbySettings->m_clusteredLighting && m_clusteredLightingShader != -1 && LightClusters::IsSupported())
+	{
+		RenderClusteredLighting();
+	}
+	else
+	{
+		RenderLightVolumes();
+	}
+
+	m_pRenderer->SetFrontFaceDirection(FrontFaceDirection::CCW);
+	m_pRenderer->DisableTransparency();
+	m_pRenderer->SetCullMode(CullMode::BACK);
+	m_pRenderer->EnableDepthTest(DepthTest::LESS);
+
+	m_pRenderer->StopRenderingToFrameBuffer(m_lightingFrameBuffer);
+
+	m_pRenderer->PopMatrix();
+}
+
+void CubbyGame::RenderLightVolumes() const
+{
 	m_pRenderer->PushMatrix();
 
 	m_pRenderer->BeginGLSLShader(m_lightingShader);
 
 	glShader* pLightShader = m_pRenderer->GetShader(m_lightingShader);
-	unsigned normalsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "normals");
-	unsigned positionssID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "positions");
-	unsigned depthsID = glGetUniformLocationARB(pLightShader->GetProgramObject(), "depths");
+	unsigned normalsID = pLightShader->GetUniformLocation("normals");
+	unsigned positionssID = pLightShader->GetUniformLocation("positions");
+	unsigned depthsID = pLightShader->GetUniformLocation("depths");
 
 	m_pRenderer->PrepareShaderTexture(0, normalsID);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetNormalTextureFromFrameBuffer(m_SSAOFrameBuffer));
@@ -671,6 +784,11 @@ void CubbyGame::RenderDeferredLighting() const
 	pLightShader->setUniform1f("nearZ", 0.01f);
 	pLightShader->setUniform1f("farZ", 1000.0f);
 
+	// Per light uniforms are set by location, so the loop doesn't look their names up
+	GLint radiusLoc = pLightShader->GetUniformLocation("radius");
+	GLint diffuseScaleLoc = pLightShader->GetUniformLocation("diffuseScale");
+	GLint diffuseLightColorLoc = pLightShader->GetUniformLocation("diffuseLightColor");
+
 	for (int i = 0; i < m_pLightingManager->GetNumLights(); ++i)
 	{
 		DynamicLight* pLight = m_pLightingManager->GetLight(i);
@@ -687,14 +805,14 @@ void CubbyGame::RenderDeferredLighting() const
 			m_pRenderer->SetCullMode(CullMode::FRONT);
 		}
 
-		pLightShader->setUniform1f("radius", lightRadius);
-		pLightShader->setUniform1f("diffuseScale", pLight->GetDiffuseScale());
+		pLightShader->setUniform1f(nullptr, lightRadius, radiusLoc);
+		pLightShader->setUniform1f(nullptr, pLight->GetDiffuseScale(), diffuseScaleLoc);
 
 		float r = pLight->GetColor().GetRed();
 		float g = pLight->GetColor().GetGreen();
 		float b = pLight->GetColor().GetBlue();
 		float a = pLight->GetColor().GetAlpha();
-		pLightShader->setUniform4f("diffuseLightColor", r, g, b, a);
+		pLightShader->setUniform4f(nullptr, r, g, b, a, diffuseLightColorLoc);
 
 		m_pRenderer->PushMatrix();
 		
@@ -712,13 +830,68 @@ void CubbyGame::RenderDeferredLighting() const
 	m_pRenderer->EndGLSLShader(m_lightingShader);
 
 	m_pRenderer->PopMatrix();
+}
 
-	m_pRenderer->SetFrontFaceDirection(FrontFaceDirection::CCW);
-	m_pRenderer->DisableTransparency();
-	m_pRenderer->SetCullMode(CullMode::BACK);
-	m_pRenderer->EnableDepthTest(DepthTest::LESS);
+void CubbyGame::RenderClusteredLighting() const
+{
+	// Clusters are built from the camera that Look() has just set up
+	Matrix4 viewMatrix;
+	Matrix4 projectionMatrix;
+	m_pRenderer->GetModelViewMatrix(&viewMatrix);
+	m_pRenderer->GetProjectionMatrix(&projectionMatrix);
 
-	m_pRenderer->StopRenderingToFrameBuffer(m_lightingFrameBuffer);
+	m_pLightingManager->BuildLightClusters(viewMatrix, projectionMatrix);
+	const LightClusters* pLightClusters = m_pLightingManager->GetLightClusters();
+
+	m_pRenderer->PushMatrix();
+
+	m_pRenderer->SetProjectionMode(ProjectionMode::TWO_DIMENSION, m_defaultViewport);
+	m_pRenderer->SetLookAtCamera(glm::vec3(0.0f, 0.0f, 250.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	m_pRenderer->SetCullMode(CullMode::NOCULL);
+
+	m_pRenderer->BeginGLSLShader(m_clusteredLightingShader);
+
+	glShader* pLightShader = m_pRenderer->GetShader(m_clusteredLightingShader);
+
+	m_pRenderer->PrepareShaderTexture(0, pLightShader->GetUniformLocation("normals"));
+	m_pRenderer->BindRawTextureID(m_pRenderer->GetNormalTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+	m_pRenderer->PrepareShaderTexture(1, pLightShader->GetUniformLocation("positions"));
+	m_pRenderer->BindRawTextureID(m_pRenderer->GetPositionTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+	m_pRenderer->PrepareShaderTexture(2, pLightShader->GetUniformLocation("depths"));
+	m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+	// The light, cluster and light index buffers go in the three units after the G-Buffer
+	pLightShader->setUniform1i("lights", 3);
+	pLightShader->setUniform1i("clusters", 4);
+	pLightShader->setUniform1i("lightIndices", 5);
+	pLightClusters->Bind(3);
+
+	pLightShader->setUniform3i("clusterGrid", LightClusters::GRID_X, LightClusters::GRID_Y, LightClusters::GRID_Z);
+	pLightShader->setUniform1f("clusterNearZ", LightClusters::NEAR_Z);
+	pLightShader->setUniform1f("clusterFarZ", LightClusters::FAR_Z);
+
+	pLightShader->setUniform1i("screenWidth", m_windowWidth);
+	pLightShader->setUniform1i("screenHeight", m_windowHeight);
+	pLightShader->setUniform1f("nearZ", 0.01f);
+	pLightShader->setUniform1f("farZ", 1000.0f);
+
+	m_pRenderer->SetRenderMode(RenderMode::SOLID);
+	m_pRenderer->EnableImmediateMode(ImmediateModePrimitive::QUADS);
+	m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
+	m_pRenderer->ImmediateVertex(static_cast<float>(m_windowWidth), 0.0f, 1.0f);
+	m_pRenderer->ImmediateVertex(static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight), 1.0f);
+	m_pRenderer->ImmediateVertex(0.0f, static_cast<float>(m_windowHeight), 1.0f);
+	m_pRenderer->DisableImmediateMode();
+
+	pLightClusters->Unbind(3);
+
+	m_pRenderer->EmptyTextureIndex(2);
+	m_pRenderer->EmptyTextureIndex(1);
+	m_pRenderer->EmptyTextureIndex(0);
+
+	m_pRenderer->EndGLSLShader(m_clusteredLightingShader);
 
 	m_pRenderer->PopMatrix();
 }
@@ -789,23 +962,23 @@ void CubbyGame::RenderSSAOTexture() const
 	m_pRenderer->BeginGLSLShader(m_SSAOShader);
 	glShader* pShader = m_pRenderer->GetShader(m_SSAOShader);
 
-	unsigned int textureID0 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_DepthTexture");
+	unsigned int textureID0 = pShader->GetUniformLocation("bgl_DepthTexture");
 	m_pRenderer->PrepareShaderTexture(0, textureID0);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_SSAOFrameBuffer));
 
-	unsigned int textureID1 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_RenderedTexture");
+	unsigned int textureID1 = pShader->GetUniformLocation("bgl_RenderedTexture");
 	m_pRenderer->PrepareShaderTexture(1, textureID1);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_SSAOFrameBuffer));
 
-	unsigned int textureID2 = glGetUniformLocationARB(pShader->GetProgramObject(), "light");
+	unsigned int textureID2 = pShader->GetUniformLocation("light");
 	m_pRenderer->PrepareShaderTexture(2, textureID2);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_lightingFrameBuffer));
 
-	unsigned int textureID3 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_TransparentTexture");
+	unsigned int textureID3 = pShader->GetUniformLocation("bgl_TransparentTexture");
 	m_pRenderer->PrepareShaderTexture(3, textureID3);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_transparencyFrameBuffer));
 
-	unsigned int textureID4 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_TransparentDepthTexture");
+	unsigned int textureID4 = pShader->GetUniformLocation("bgl_TransparentDepthTexture");
 	m_pRenderer->PrepareShaderTexture(4, textureID4);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_transparencyFrameBuffer));
 
@@ -869,7 +1042,7 @@ void CubbyGame::RenderFXAATexture() const
 	pShader->setUniform1i("screenWidth", m_windowWidth);
 	pShader->setUniform1i("screenHeight", m_windowHeight);
 
-	unsigned int textureID0 = glGetUniformLocationARB(pShader->GetProgramObject(), "texture");
+	unsigned int textureID0 = pShader->GetUniformLocation("texture");
 	m_pRenderer->PrepareShaderTexture(0, textureID0);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_FXAAFrameBuffer));
 
@@ -909,7 +1082,7 @@ void CubbyGame::RenderFirstPassFullScreen() const
 	m_pRenderer->BeginGLSLShader(m_blurHorizontalShader);
 	glShader* pShader = m_pRenderer->GetShader(m_blurHorizontalShader);
 
-	unsigned int textureID0 = glGetUniformLocationARB(pShader->GetProgramObject(), "texture");
+	unsigned int textureID0 = pShader->GetUniformLocation("texture");
 	m_pRenderer->PrepareShaderTexture(0, textureID0);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_firstPassFullscreenBuffer));
 
@@ -954,7 +1127,7 @@ void CubbyGame::RenderSecondPassFullScreen() const
 	m_pRenderer->BeginGLSLShader(m_blurVerticalShader);
 	glShader* pShader = m_pRenderer->GetShader(m_blurVerticalShader);
 
-	unsigned int textureID0 = glGetUniformLocationARB(pShader->GetProgramObject(), "texture");
+	unsigned int textureID0 = pShader->GetUniformLocation("texture");
 	m_pRenderer->PrepareShaderTexture(0, textureID0);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_secondPassFullscreenBuffer));
 
@@ -975,7 +1148,7 @@ void CubbyGame::RenderSecondPassFullScreen() const
 
 	pShader->setUniform1f("blurSize", blurSize);
 
-	glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "applyBlueTint"), applyBlueTint);
+	glUniform1iARB(pShader->GetUniformLocation("applyBlueTint"), applyBlueTint);
 
 	m_pRenderer->SetRenderMode(RenderMode::TEXTURED);
 	m_pRenderer->EnableImmediateMode(ImmediateModePrimitive::QUADS);
@@ -996,8 +1169,10 @@ void CubbyGame::RenderSecondPassFullScreen() const
 	m_pRenderer->PopMatrix();
 }
 
-void CubbyGame::RenderGUI() const
+void CubbyGame::RenderGUI()
 {
+	int numDrawCalls = m_pRenderer->GetNumDrawCalls();
+
 	m_pRenderer->EmptyTextureIndex(0);
 
 	// Render the GUI
@@ -1008,9 +1183,22 @@ void CubbyGame::RenderGUI() const
 
 	m_pRenderer->SetLookAtCamera(glm::vec3(0.0f, 0.0f, 250.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 
+	// Icons from the texture atlas are batched together, everything else flushes the batch before it draws so the GUI keeps its order
+	if (m_pCubbySettings->m_batchGUISprites)
+	{
+		m_pRenderer->BeginSpriteBatch();
+	}
+
 	m_pGUI->Render();
 
+	if (m_pCubbySettings->m_batchGUISprites)
+	{
+		m_pRenderer->EndSpriteBatch();
+	}
+
 	m_pRenderer->PopMatrix();
+
+	m_numGUIDrawCalls = m_pRenderer->GetNumDrawCalls() - numDrawCalls;
 }
 
 void CubbyGame::RenderHUD() const
@@ -1319,12 +1507,12 @@ void CubbyGame::RenderDeferredRenderingPaperDoll() const
 	m_pRenderer->BeginGLSLShader(m_SSAOShader);
 	glShader* pShader = m_pRenderer->GetShader(m_SSAOShader);
 
-	unsigned int textureID = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_DepthTexture");
+	unsigned int textureID = pShader->GetUniformLocation("bgl_DepthTexture");
 	glActiveTextureARB(GL_TEXTURE0_ARB);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_paperdollBuffer));
 	glUniform1iARB(textureID, 0);
 
-	unsigned int textureID2 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_RenderedTexture");
+	unsigned int textureID2 = pShader->GetUniformLocation("bgl_RenderedTexture");
 	glActiveTextureARB(GL_TEXTURE1_ARB);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_paperdollBuffer));
 	glUniform1iARB(textureID2, 1);
@@ -1384,12 +1572,12 @@ void CubbyGame::RenderDeferredRenderingPortrait() const
 	m_pRenderer->BeginGLSLShader(m_SSAOShader);
 	glShader* pShader = m_pRenderer->GetShader(m_SSAOShader);
 
-	unsigned int textureID = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_DepthTexture");
+	unsigned int textureID = pShader->GetUniformLocation("bgl_DepthTexture");
 	glActiveTextureARB(GL_TEXTURE0_ARB);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDepthTextureFromFrameBuffer(m_portraitBuffer));
 	glUniform1iARB(textureID, 0);
 
-	unsigned int textureID2 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_RenderedTexture");
+	unsigned int textureID2 = pShader->GetUniformLocation("bgl_RenderedTexture");
 	glActiveTextureARB(GL_TEXTURE1_ARB);
 	m_pRenderer->BindRawTextureID(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_portraitBuffer));
 	glUniform1iARB(textureID2, 1);
@@ -1465,6 +1653,44 @@ void CubbyGame::RenderDebugInformation()
 	sprintf(projectilesBuff, "Projectiles: %i, Render: %i", m_pProjectileManager->GetNumProjectiles(), m_pProjectileManager->GetNumRenderProjectiles());
 	char instancesBuff[256];
 	sprintf(instancesBuff, "Instance Parents: %i, Instance Objects: %i, Instance Render: %i", m_pInstanceManager->GetNumInstanceParents(), m_pInstanceManager->GetTotalNumInstanceObjects(), m_pInstanceManager->GetTotalNumInstanceRenderObjects());
+	char modelsBuff[256];
+	sprintf(modelsBuff, "Models: %i, Instances: %i, Shared Saving: %.2fMB", m_pQubicleBinaryManager->GetNumUniqueModels(), m_pQubicleBinaryManager->GetNumModelInstances(), m_pQubicleBinaryManager->GetNumBytesSaved() / (1024.0f * 1024.0f));
+	char skeletonsBuff[256];
+	sprintf(skeletonsBuff, "Skeletons: %i (%i refs), Animation Lists: %i (%i refs), Shared Saving: %.2fKB, Last Camp Spawn: %.2fms, %.2fKB", MS3DModelManager::GetInstance()->GetNumModels(), MS3DModelManager::GetInstance()->GetNumModelInstances(), MS3DModelManager::GetInstance()->GetNumAnimationLists(), MS3DModelManager::GetInstance()->GetNumAnimationListInstances(), MS3DModelManager::GetInstance()->GetNumBytesSaved() / 1024.0f, m_pEnemyManager->GetLastEnemyCampSpawnTime(), m_pEnemyManager->GetLastEnemyCampSkeletonMemory() / 1024.0f);
+	char animationBuff[256];
+	sprintf(animationBuff, "Animators: %i, Joints: %i, Pose Update: %.2fms, Full: %i, Reduced: %i, On Demand: %i", MS3DAnimatorBatch::GetInstance()->GetNumAnimators(), MS3DAnimatorBatch::GetInstance()->GetNumJoints(), MS3DAnimatorBatch::GetInstance()->GetFlushTime(), MS3DAnimatorBatch::GetInstance()->GetNumAnimators(AnimationUpdateTier::Full), MS3DAnimatorBatch::GetInstance()->GetNumAnimators(AnimationUpdateTier::Reduced), MS3DAnimatorBatch::GetInstance()->GetNumAnimators(AnimationUpdateTier::OnDemand));
+	char loadingBuff[256];
+	sprintf(loadingBuff, "Loading: %i, Uploading: %i (%i last frame), Hitches: %i/%i frames, 33ms: %i, 50ms: %i, 100ms: %i, 250ms: %i", AssetLoader::GetInstance()->GetNumPendingLoads(), AssetLoader::GetInstance()->GetNumPendingUploads(), AssetLoader::GetInstance()->GetNumUploadsLastFrame(), m_hitchHistogram.GetNumHitches(), m_hitchHistogram.GetNumFrames(), m_hitchHistogram.GetBucketCount(0), m_hitchHistogram.GetBucketCount(1), m_hitchHistogram.GetBucketCount(2), m_hitchHistogram.GetBucketCount(3));
+	char guiBuff[256];
+	sprintf(guiBuff, "GUI Draw Calls: %i, Batched Sprites: %i%s, Atlas Pages: %i", m_numGUIDrawCalls, m_pRenderer->GetNumBatchedSprites(), m_pCubbySettings->m_batchGUISprites ? "" : " (batching off)", m_pRenderer->GetNumTextureAtlasPages());
+	const RenderPassStats& shadowPassStats = m_pRenderer->GetRenderPassStats(RenderPass::Shadow);
+	const RenderPassStats& reflectionPassStats = m_pRenderer->GetRenderPassStats(RenderPass::Reflection);
+	const RenderPassStats& normalPassStats = m_pRenderer->GetRenderPassStats(RenderPass::Normal);
+	char renderQueueBuff[256];
+	sprintf(renderQueueBuff, "Render Queue: %i packets, Shadow: %i draws/%i changes, Reflection: %i draws/%i changes, Normal: %i draws/%i changes", m_pRenderer->GetNumRenderQueuePackets(), shadowPassStats.m_numDrawCalls, shadowPassStats.m_numStateChanges, reflectionPassStats.m_numDrawCalls, reflectionPassStats.m_numStateChanges, normalPassStats.m_numDrawCalls, normalPassStats.m_numStateChanges);
+	int numShaderLookups;
+	int numShaderQueries;
+	m_pRenderer->GetShaderLocationStats(&numShaderLookups, &numShaderQueries);
+	char shaderBuff[256];
+	sprintf(shaderBuff, "Shader Locations: %i lookups, %i driver queries, Frame Uniform Uploads: %i", numShaderLookups, numShaderQueries, m_pRenderer->GetNumFrameUniformUploads());
+	const LightClusters* pLightClusters = m_pLightingManager->GetLightClusters();
+	bool isClusteredLighting = m_pCubbySettings->m_clusteredLighting && m_clusteredLightingShader != -1;
+	char lightingBuff[256];
+	sprintf(lightingBuff, "Dynamic Lights: %i, Light Clusters: %i occupied, %i light indices%s", m_pLightingManager->GetNumLights(), pLightClusters->GetNumOccupiedClusters(), pLightClusters->GetNumLightIndices(), isClusteredLighting ? "" : " (clustering off)");
+	char shadowBuff[128];
+	sprintf(shadowBuff, "Shadow Cascades: %i x %i, Static Redraws: %i%s", m_pShadowCascades->GetNumCascades(), m_pShadowCascades->GetMapSize(), m_pShadowCascades->GetNumStaticRedraws(), m_pShadowCascades->IsStaticCacheSupported() ? "" : " (no static cache)");
+	static const char* reflectionUpdateNames[] = { "skipped", "reused", "drawn" };
+	bool isWaterReflecting = m_pCubbySettings->m_waterRendering && m_gameMode != GameMode::FrontEnd;
+	char waterBuff[128];
+	sprintf(waterBuff, "Water Reflection: %s, %.2fms, %i chunks", isWaterReflecting ? reflectionUpdateNames[static_cast<int>(m_pReflectionPlanner->GetLastUpdate())] : "off", isWaterReflecting ? m_pReflectionPlanner->GetPassTime() : 0.0f, reflectionPassStats.m_numPackets);
+	char textBuff[128];
+	sprintf(textBuff, "Cached Text Meshes: %i, Glyphs: %i", m_pRenderer->GetNumCachedTextMeshes(), m_pRenderer->GetNumGlyphs());
+	SimulationStats simulationStats;
+	simulationStats.Add(m_pEnemyManager->GetSimulationStats());
+	simulationStats.Add(m_pNPCManager->GetSimulationStats());
+	simulationStats.Add(m_pItemManager->GetSimulationStats());
+	char simulationBuff[256];
+	sprintf(simulationBuff, "Simulation: Full %i (%.2fms), Reduced %i, %i ticked (%.2fms), Dormant %i%s", simulationStats.m_numEntities[static_cast<int>(SimulationTier::Full)], simulationStats.m_updateTime[static_cast<int>(SimulationTier::Full)], simulationStats.m_numEntities[static_cast<int>(SimulationTier::Reduced)], simulationStats.m_numReducedTicks, simulationStats.m_updateTime[static_cast<int>(SimulationTier::Reduced)], simulationStats.m_numEntities[static_cast<int>(SimulationTier::Dormant)], m_pCubbySettings->m_simulationLOD ? "" : " (LOD off)");
 
 	char fpsBuff[128];
 	float fpsWidthOffset = 65.0f;
@@ -1506,6 +1732,18 @@ void CubbyGame::RenderDebugInformation()
 		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 7) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, enemiesBuff);
 		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 8) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, projectilesBuff);
 		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 9) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, instancesBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 10) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, modelsBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 11) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, skeletonsBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 12) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, animationBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 13) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, loadingBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 14) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, guiBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 15) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, textBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 16) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, renderQueueBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 17) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, shaderBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 18) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, lightingBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 19) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, shadowBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 20) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, waterBuff);
+		m_pRenderer->RenderFreeTypeText(m_defaultFont, 15.0f, m_windowHeight - (textHeight * 21) - 10.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, simulationBuff);
 	}
 
 	m_pRenderer->RenderFreeTypeText(m_defaultFont, m_windowWidth - fpsWidthOffset, 15.0f, 1.0f, Color(1.0f, 1.0f, 1.0f), 1.0f, fpsBuff);
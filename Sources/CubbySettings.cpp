@@ -35,6 +35,8 @@ void CubbySettings::LoadSettings()
 	m_fullscreen = reader.GetBoolean("Graphics", "FullScreen", false);
 	m_deferredRendering = reader.GetBoolean("Graphics", "DeferredRendering", false);
 	m_shadows = reader.GetBoolean("Graphics", "Shadows", false);
+	m_shadowCascades = reader.GetInteger("Graphics", "ShadowCascades", 3);
+	m_shadowMapSize = reader.GetInteger("Graphics", "ShadowMapSize", 2048);
 	m_blur = reader.GetBoolean("Graphics", "Blur", false);
 	m_ssao = reader.GetBoolean("Graphics", "SSAO", false);
 	m_dynamicLighting = reader.GetBoolean("Graphics", "DynamicLighting", false);
@@ -43,6 +45,8 @@ void CubbySettings::LoadSettings()
 	m_faceMerging = reader.GetBoolean("Graphics", "FaceMerging", false);
 	m_fogRendering = reader.GetBoolean("Graphics", "FogRendering", false);
 	m_waterRendering = reader.GetBoolean("Graphics", "WaterRendering", false);
+	m_waterReflectionScale = static_cast<float>(reader.GetReal("Graphics", "WaterReflectionScale", 0.5f));
+	m_waterReflectionHalfRate = reader.GetBoolean("Graphics", "WaterReflectionHalfRate", false);
 
 	// Landscape generation
 	m_landscapeOctaves = static_cast<float>(reader.GetReal("Landscape", "LandscapeOctaves", 4.0f));
@@ -59,6 +63,12 @@ void CubbySettings::LoadSettings()
 	m_stepUpdating = reader.GetBoolean("Debug", "StepUpdatng", false);
 	m_wireframeRendering = reader.GetBoolean("Debug", "WireframeRendering", false);
 	m_showDebugGUI = reader.GetBoolean("Debug", "ShowDebugGUI", true);
+	m_useAssetPack = reader.GetBoolean("Debug", "UseAssetPack", true);
+	m_batchGUISprites = reader.GetBoolean("Debug", "BatchGUISprites", true);
+	m_clusteredLighting = reader.GetBoolean("Debug", "ClusteredLighting", true);
+	m_enemyFlowFields = reader.GetBoolean("Debug", "EnemyFlowFields", true);
+	m_simulationLOD = reader.GetBoolean("Debug", "SimulationLOD", true);
+	m_simulationLODDistance = static_cast<float>(reader.GetReal("Debug", "SimulationLODDistance", 48.0f));
 	m_gameMode = reader.Get("Debug", "GameMode", "Debug");
 	m_version = reader.Get("Debug", "Version", "1.0");
 }
@@ -91,6 +101,8 @@ void CubbySettings::LoadOptions()
 	m_shadows = reader.GetBoolean("Graphics", "Shadows", false);
 	m_fogRendering = reader.GetBoolean("Graphics", "FogRendering", false);
 	m_waterRendering = reader.GetBoolean("Graphics", "WaterRendering", false);
+	m_lodBias = static_cast<float>(reader.GetReal("Graphics", "LODBias", 1.0f));
+	m_animationLODDistance = static_cast<float>(reader.GetReal("Graphics", "AnimationLODDistance", 48.0f));
 
 	// Sound
 	m_audio = reader.GetBoolean("Sound", "AudioEnabled", true);
@@ -129,6 +141,8 @@ void CubbySettings::SaveOptions() const
 	file << "Shadows=" << (m_shadows ? "True" : "False") << "\n";
 	file << "FogRendering=" << (m_fogRendering ? "True" : "False") << "\n";
 	file << "WaterRendering=" << (m_waterRendering ? "True" : "False") << "\n";
+	file << "LODBias=" << m_lodBias << "\n";
+	file << "AnimationLODDistance=" << m_animationLODDistance << "\n";
 	file << "\n";
 
 	file << "[Sound]\n";
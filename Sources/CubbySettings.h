@@ -60,6 +60,8 @@ struct CubbySettings
 	bool m_fullscreen;
 	bool m_deferredRendering;
 	bool m_shadows;
+	int m_shadowCascades;
+	int m_shadowMapSize;
 	bool m_blur;
 	bool m_ssao;
 	bool m_dynamicLighting;
@@ -68,6 +70,10 @@ struct CubbySettings
 	bool m_faceMerging;
 	bool m_fogRendering;
 	bool m_waterRendering;
+	float m_waterReflectionScale;
+	bool m_waterReflectionHalfRate;
+	float m_lodBias;
+	float m_animationLODDistance;
 
 	// Landscape generation
 	float m_landscapeOctaves;
@@ -84,6 +90,12 @@ struct CubbySettings
 	bool m_wireframeRendering;
 	bool m_stepUpdating;
 	bool m_showDebugGUI;
+	bool m_useAssetPack;
+	bool m_batchGUISprites;
+	bool m_clusteredLighting;
+	bool m_enemyFlowFields;
+	bool m_simulationLOD;
+	float m_simulationLODDistance;
 	std::string m_gameMode;
 	std::string m_version;
 };
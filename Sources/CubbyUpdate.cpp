@@ -7,6 +7,8 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <Models/MS3DAnimatorBatch.h>
+#include <Utils/AssetLoader.h>
 #include <Utils/Interpolator.h>
 #include <Utils/TimeManager.h>
 
@@ -31,6 +33,8 @@ void CubbyGame::Update()
 #endif //_WIN32
 	m_fps = 1.0f / m_deltaTime;
 	m_fpsPreviousTicks = m_fpsCurrentTicks;
+
+	m_hitchHistogram.AddFrame(m_deltaTime * 1000.0f);
 	
 	float maxDeltaTime = 0.25f;
 	if (m_deltaTime > maxDeltaTime)
@@ -39,6 +43,9 @@ void CubbyGame::Update()
 		m_deltaTime = maxDeltaTime;
 	}
 
+	// Upload the models that finished loading in the background, a few milliseconds worth per frame
+	AssetLoader::GetInstance()->ProcessUploads(2.0f);
+
 	// Update interpolator singleton
 	Interpolator::GetInstance()->Update(m_deltaTime);
 
@@ -129,6 +136,12 @@ void CubbyGame::Update()
 			m_pPlayer->Update(m_deltaTime);
 		}
 
+		// Player's place in the spatial grid
+		m_pSpatialGrid->Update(m_pPlayer, SpatialType::Player, m_pPlayer->GetCenter(), m_pPlayer->GetRadius());
+
+		// Evaluate the skeleton poses of every character that animated this frame
+		MS3DAnimatorBatch::GetInstance()->Flush();
+
 		// Camera faked position
 		if (m_cameraMode == CameraMode::MouseRotate || m_cameraMode == CameraMode::AutoCamera || m_cameraMode == CameraMode::NPCDialog)
 		{
@@ -219,37 +232,19 @@ void CubbyGame::Update()
 
 void CubbyGame::UpdateNamePicking()
 {
-	POINT mouse = { GetInstance()->GetWindowCursorX(), (m_windowHeight - GetInstance()->GetWindowCursorY()) };
-
-	// Push attributes
-	glPushAttrib(GL_LIST_BIT | GL_CURRENT_BIT | GL_ENABLE_BIT | GL_TRANSFORM_BIT);
-	// Disabled rendering
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glm::vec3 rayOrigin;
+	glm::vec3 rayDirection;
+	float rayLength;
+	GetCursorRay(GetWindowCursorX(), GetWindowCursorY(), &rayOrigin, &rayDirection, &rayLength);
 
-	// Set the projection mode
-	m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, m_defaultViewport);
+	// Nothing further than the loaded world is rendered
+	float maxDistance = std::min(rayLength, m_pChunkManager->GetLoaderRadius());
 
-	// Init name picking
-	m_pRenderer->InitNameStack();
-
-	// Start name picking
-	m_pRenderer->StartNamePicking(m_defaultViewport, mouse.x, mouse.y);
-
-	// Set the look at camera
-	m_pGameCamera->Look();
-
-	// Different sub-systems render name picking
+	// Different sub-systems pick against their own objects
 	{
-		m_pNPCManager->RenderNamePicking();
+		m_pickedObject = m_pNPCManager->GetRayNamePicking(rayOrigin, rayDirection, maxDistance);
 	}
 
-	// End the name picking
-	m_pickedObject = m_pRenderer->GetPickedObject();
-
-	// Pop attributes
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);   // Enable rendering
-	glPopAttrib();
-
 	if (m_pickedObject != -1)
 	{
 		m_isNamePickingSelected = true;
@@ -260,6 +255,24 @@ void CubbyGame::UpdateNamePicking()
 	}
 }
 
+void CubbyGame::GetCursorRay(int cursorX, int cursorY, glm::vec3* pOrigin, glm::vec3* pDirection, float* pLength) const
+{
+	// Project the cursor into the world
+	m_pRenderer->PushMatrix();
+
+	m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, m_defaultViewport);
+	m_pGameCamera->Look();
+
+	glm::vec3 nearPosition = m_pRenderer->GetWorldProjectionFromScreenCoordinates(cursorX, cursorY, 0.0f);
+	glm::vec3 farPosition = m_pRenderer->GetWorldProjectionFromScreenCoordinates(cursorX, cursorY, 1.0f);
+
+	m_pRenderer->PopMatrix();
+
+	*pOrigin = nearPosition;
+	*pLength = length(farPosition - nearPosition);
+	*pDirection = (farPosition - nearPosition) / *pLength;
+}
+
 void CubbyGame::UpdatePlayerAlpha(float dt) const
 {
 	glm::vec3 toPlayer = ((m_pPlayer->GetCenter() + Player::PLAYER_CENTER_OFFSET) - m_pGameCamera->GetPosition());
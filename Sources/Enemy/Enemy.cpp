@@ -9,6 +9,7 @@
 
 #include <CubbyGame.h>
 
+#include <Blocks/VoxelCollision.h>
 #include <Items/ItemManager.h>
 #include <Lighting/LightingManager.h>
 #include <Maths/3DMaths.h>
@@ -18,10 +19,12 @@
 #include <Sounds/SoundEffects.h>
 #include <Utils/Interpolator.h>
 #include <Utils/Random.h>
+#include <Utils/SpatialGrid.h>
 
 #include "EnemyManager.h"
 #include "EnemySpawner.h"
 #include "Enemy.h"
+#include "FlowField.h"
 
 // Constructor, Destructor
 Enemy::Enemy(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer, LightingManager* pLightingManager, BlockParticleManager* pBlockParticleManager, TextEffectsManager* pTextEffectsManager, ItemManager* pItemManager, ProjectileManager* pProjectileManager, HUD* pHUD, EnemyManager* pEnemyManager, NPCManager* pNPCManager, QubicleBinaryManager* pQubicleBinaryManager, EnemyType enemyType) :
@@ -66,6 +69,7 @@ Enemy::Enemy(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer,
 	m_canJump = true;
 	m_jumpTime = 1.5f;
 	m_jumpTimer = 0.0f;
+	m_isJumpSoundPending = false;
 	m_jumpHeight = 14.5f;
 
 	// Combat
@@ -186,6 +190,7 @@ Enemy::Enemy(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer,
 	m_pVoxelCharacter = new VoxelCharacter(m_pRenderer, m_pQubicleBinaryManager);
 	m_pVoxelCharacter->UnloadCharacter();
 	m_pVoxelCharacter->Reset();
+	m_pVoxelCharacter->SetCreateLODMeshes(true);
 
 	bool useQubicleManager = false;
 	m_pVoxelCharacter->LoadVoxelCharacter(m_typeString.c_str(), qbFileName, ms3dFileName, animListFileName, facesFileName, characterFileName, characterBaseFolder, useQubicleManager);
@@ -366,6 +371,11 @@ glm::vec3 Enemy::GetTargetForward() const
 	return m_targetForward;
 }
 
+VoxelCharacter* Enemy::GetVoxelCharacter() const
+{
+	return m_pVoxelCharacter;
+}
+
 // Setup
 void Enemy::SetupEnemyForType()
 {
@@ -1167,6 +1177,12 @@ void Enemy::RemoveEnemySpawner(EnemySpawner* pSpawner)
 	}
 }
 
+// Simulation LOD
+SimulationLOD* Enemy::GetSimulationLOD()
+{
+	return &m_simulationLOD;
+}
+
 // Animation
 void Enemy::SetAnimationSpeed(float speed, bool onlySetOnCompleteAnimation, AnimationSections section)
 {
@@ -1318,138 +1334,10 @@ void Enemy::ClearChunkCacheForChunk(Chunk* pChunk)
 // Collision
 bool Enemy::CheckCollisions(glm::vec3 positionCheck, glm::vec3 previousPosition, glm::vec3 *pNormal, glm::vec3 *pMovement) const
 {
-	float radius = GetRadius();
-
-	glm::vec3 movementCache = *pMovement;
-
 	// World collisions
-	bool worldCollision = false;
-
-	glm::vec3 floorPosition;
-	if (m_pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
-	{
-		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-		return true;
-	}
-	
-	int blockX, blockY, blockZ;
-	glm::vec3 blockPos;
-	int numChecks = 1 + static_cast<int>(radius / (Chunk::BLOCK_RENDER_SIZE * 2.0f));
-
-	for (int x = -numChecks; x <= numChecks; ++x)
-	{
-		for (int y = -numChecks; y <= numChecks; ++y)
-		{
-			for (int z = -numChecks; z <= numChecks; ++z)
-			{
-				*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-				Chunk* pChunk = GetCachedGridChunkOrFromPosition(positionCheck + glm::vec3((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * y, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * z));
-				bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x), positionCheck.y + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * y), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * z), &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-
-				if (active == false)
-				{
-					if (pChunk == nullptr || pChunk->IsSetup() == false)
-					{
-						*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-						worldCollision = false;
-					}
-				}
-				else if (active == true)
-				{
-					Plane3D planes[6];
-					planes[0] = Plane3D(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[1] = Plane3D(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[2] = Plane3D(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[3] = Plane3D(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[4] = Plane3D(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
-					planes[5] = Plane3D(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
-
-					float distance;
-					int inside = 0;
-					bool insideCache[6];
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - previousPosition;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-							insideCache[i] = false;
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							insideCache[i] = true;
-						}
-						else
-						{
-							// Inside...
-							insideCache[i] = true;
-						}
-					}
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - positionCheck;
-						distance = planes[i].GetPointDistance(pointToCheck);
+	VoxelCollision voxelCollision(m_pChunkManager);
 
-						if (distance < -radius)
-						{
-							// Outside...
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-						else
-						{
-							// Inside...
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-					}
-
-					if (inside == 6)
-					{
-						if (length(*pNormal) <= 1.0f)
-						{
-							if (length(*pNormal) > 0.0f)
-							{
-								*pNormal = normalize(*pNormal);
-							}
-
-							float dotResult = dot(*pNormal, *pMovement);
-							*pNormal *= dotResult;
-
-							*pMovement -= *pNormal;
-
-							worldCollision = true;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	if (worldCollision)
-	{
-		return true;
-	}
-
-	*pMovement = movementCache;
-
-	return false;
+	return voxelCollision.CheckCharacter(positionCheck, previousPosition, GetRadius(), pNormal, pMovement);
 }
 
 bool Enemy::IsBlockInFront() const
@@ -1681,7 +1569,7 @@ void Enemy::Jump(bool jumpUpBlock)
 
 	if (m_enemyType == EnemyType::Mimic)
 	{
-		CubbyGame::GetInstance()->PlaySoundEffect3D(SoundEffect::MimicJump, GetCenter());
+		m_isJumpSoundPending = true;
 	}
 }
 
@@ -1763,6 +1651,9 @@ void Enemy::DoDamage(float amount, Color textColor, glm::vec3 knockbackDirection
 	// Remove sapped
 	SetSapped(false);
 
+	// Being hit from afar still gets a full reaction
+	m_simulationLOD.Wake();
+
 	if (m_damageTimer <= 0.0f)
 	{
 		if (m_aggro == false)
@@ -1919,11 +1810,13 @@ void Enemy::CheckPlayerDamageRadius()
 
 void Enemy::CheckNPCDamageRadius()
 {
-	int numNPCs = m_pNPCManager->GetNumNPCs();
+	// NPCs are in the grid with their attack radius, so this finds every NPC that can reach us
+	std::vector<void*> vpNearbyNPCs;
+	m_pEnemyManager->GetSpatialGrid()->QueryRadius(GetCenter(), m_radius, SpatialGrid::GetTypeBit(SpatialType::NPC), &vpNearbyNPCs);
 
-	for (int i = 0; i < numNPCs; ++i)
+	for (size_t i = 0; i < vpNearbyNPCs.size(); ++i)
 	{
-		NPC *pNPC = m_pNPCManager->GetNPC(i);
+		NPC *pNPC = static_cast<NPC*>(vpNearbyNPCs[i]);
 
 		if (pNPC->NeedErase() == true)
 		{
@@ -2212,6 +2105,7 @@ void Enemy::ConvertIntoOtherEnemyType(EnemyType newEnemyType, float scale)
 
 	m_pVoxelCharacter->UnloadCharacter();
 	m_pVoxelCharacter->Reset();
+	m_pVoxelCharacter->SetCreateLODMeshes(true);
 
 	bool useQubicleManager = (m_enemyType != EnemyType::Doppelganger);
 	m_pVoxelCharacter->LoadVoxelCharacter(m_typeString.c_str(), qbFileName, ms3dFileName, animListFileName, facesFileName, characterFileName, characterBaseFolder, useQubicleManager);
@@ -2265,6 +2159,48 @@ void Enemy::SetNPCDied(NPC* pNPC)
 void Enemy::SetTargetNPC(NPC* pTargetNPC)
 {
 	m_pTargetNPC = pTargetNPC;
+
+	if (m_pTargetNPC != nullptr)
+	{
+		m_simulationLOD.Wake();
+	}
+}
+
+NPC* Enemy::GetTargetNPC() const
+{
+	return m_pTargetNPC;
+}
+
+void Enemy::SetAggro(bool aggro)
+{
+	m_aggro = aggro;
+	m_aggroResetTimer = m_aggroResetTime;
+
+	if (m_aggro)
+	{
+		m_simulationLOD.Wake();
+	}
+}
+
+bool Enemy::IsAggro() const
+{
+	return m_aggro;
+}
+
+bool Enemy::IsChasingOnGround() const
+{
+	if (m_aggro == false || m_spawning || m_sapped)
+	{
+		return false;
+	}
+
+	if (m_enemyType == EnemyType::Bee || m_enemyType == EnemyType::Bat || m_enemyType == EnemyType::Ghost || m_enemyType == EnemyType::Doppelganger)
+	{
+		// Flying enemies go straight for the target
+		return false;
+	}
+
+	return CanMoveTowardsTarget();
 }
 
 // Gameplay
@@ -2379,8 +2315,8 @@ void Enemy::Attack()
 			m_attackEnabledDelayTimer = 0.3f;
 			m_attackRotation = startRotation;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			doAttack = true;
@@ -2395,8 +2331,8 @@ void Enemy::Attack()
 			m_attackEnabledDelayTimer = 0.35f;
 			float attackTime = 0.60f;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
 
 			doAttack = true;
 		}
@@ -2418,7 +2354,7 @@ void Enemy::Attack()
 
 			m_attackEnabledDelayTimer = 0.15f;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 
 			doAttack = true;
 		}
@@ -2430,7 +2366,7 @@ void Enemy::Attack()
 
 			m_attackEnabledDelayTimer = 0.15f;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 
 			doAttack = true;
 		}
@@ -2442,7 +2378,7 @@ void Enemy::Attack()
 
 			m_attackEnabledDelayTimer = 0.15f;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 
 			doAttack = true;
 		}
@@ -2527,8 +2463,8 @@ void Enemy::Attack()
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			// Start weapon trails
@@ -2810,12 +2746,15 @@ void Enemy::CalculateWorldTransformMatrix()
 
 	up = normalize(cross(forward, right));
 
+	// Between ticks a reduced enemy is drawn on its way from the last tick position
+	glm::vec3 renderPosition = m_simulationLOD.GetRenderPosition(m_position);
+
 	float matrix[16] =
 	{
 		right.x, right.y, right.z, 0.0f,
 		up.x, up.y, up.z, 0.0f,
 		forward.x, forward.y, forward.z, 0.0f,
-		m_position.x, m_position.y, m_position.z, 1.0f
+		renderPosition.x, renderPosition.y, renderPosition.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(matrix);
@@ -2892,7 +2831,7 @@ void Enemy::UpdateWeaponLights() const
 						lightPos = rotationMatrix * lightPos;
 
 						// Translate to position
-						lightPos += m_position;
+						lightPos += m_simulationLOD.GetRenderPosition(m_position);
 					}
 
 					float scale = m_pVoxelCharacter->GetCharacterScale();
@@ -2961,7 +2900,7 @@ void Enemy::UpdateWeaponParticleEffects() const
 						particleEffectPos = rotationMatrix * particleEffectPos;
 
 						// Translate to position
-						particleEffectPos += m_position;
+						particleEffectPos += m_simulationLOD.GetRenderPosition(m_position);
 					}
 
 					m_pBlockParticleManager->UpdateParticleEffectPosition(particleEffectID, particleEffectPos, particleEffectPosNoWorldOffset);
@@ -2971,23 +2910,29 @@ void Enemy::UpdateWeaponParticleEffects() const
 	}
 }
 
-void Enemy::Update(float dt)
+void Enemy::UpdateIntegrate(float dt)
 {
 	// Update grid position
 	UpdateGridPosition();
 
-	// Update timers
-	UpdateTimers(dt);
-
-	// Update spawning
-	UpdateSpawning();
-
 	// Update look at point
 	UpdateLookingAndForwardTarget(dt);
 
 	// Update movement
 	UpdateMovement(dt);
 
+	// Update physics
+	UpdatePhysics(dt);
+}
+
+void Enemy::UpdateApply(float dt)
+{
+	// Update timers
+	UpdateTimers(dt);
+
+	// Update spawning
+	UpdateSpawning();
+
 	// Update combat
 	UpdateCombat();
 
@@ -3000,17 +2945,6 @@ void Enemy::Update(float dt)
 	// Check for NPC attack damage
 	CheckNPCDamageRadius();
 
-	if (m_pVoxelCharacter != nullptr)
-	{
-		m_pVoxelCharacter->Update(dt, m_animationSpeed);
-		m_pVoxelCharacter->SetWeaponTrailsOriginMatrix(m_worldMatrix);
-
-		for (int i = 0; i < static_cast<int>(AnimationSections::NumSections); ++i)
-		{
-			m_animationFinished[i] = m_pVoxelCharacter->HasAnimationFinished(static_cast<AnimationSections>(i));
-		}
-	}
-
 	// Reset the canAttack flag if our weapon arm animation is completed
 	if (m_canAttack == false && (m_animationFinished[static_cast<int>(AnimationSections::RightArmHand)] == true) || (m_enemyType == EnemyType::Bee || m_enemyType == EnemyType::Bat || m_enemyType == EnemyType::Ghost || m_enemyType == EnemyType::Doppelganger))
 	{
@@ -3064,9 +2998,6 @@ void Enemy::Update(float dt)
 		m_chargeSpawnVelocity = (normalize(toTarget) * powerAmount) + glm::vec3(0.0f, liftAmount, 0.0f);
 	}
 
-	// Update physics
-	UpdatePhysics(dt);
-
 	// Update the enemy light
 	if (m_enemyType == EnemyType::Doppelganger)
 	{
@@ -3074,6 +3005,30 @@ void Enemy::Update(float dt)
 
 		m_pEnemyParticleEffect->SetPosition(GetCenter() + glm::vec3(0.0f, 0.75f, 0.0f));
 	}
+
+	if (m_isJumpSoundPending)
+	{
+		CubbyGame::GetInstance()->PlaySoundEffect3D(SoundEffect::MimicJump, GetCenter());
+		m_isJumpSoundPending = false;
+	}
+}
+
+void Enemy::UpdateAnimation(float dt)
+{
+	if (m_pVoxelCharacter != nullptr)
+	{
+		// Animation level of detail, from the distance to the camera and the visibility of the last rendered frame
+		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - GetCenter());
+		m_pVoxelCharacter->SetAnimationUpdateTier(VoxelCharacter::CalculateAnimationUpdateTier(m_pVoxelCharacter->IsRenderVisible(), toCamera, CubbyGame::GetInstance()->GetCubbySettings()->m_animationLODDistance));
+
+		m_pVoxelCharacter->Update(dt, m_animationSpeed);
+		m_pVoxelCharacter->SetWeaponTrailsOriginMatrix(m_worldMatrix);
+
+		for (int i = 0; i < static_cast<int>(AnimationSections::NumSections); ++i)
+		{
+			m_animationFinished[i] = m_pVoxelCharacter->HasAnimationFinished(static_cast<AnimationSections>(i));
+		}
+	}
 }
 
 void Enemy::UpdatePhysics(float dt)
@@ -3685,7 +3640,20 @@ void Enemy::UpdateMovement(float dt)
 	}
 	else
 	{
-		LookAtPoint(targetPos);
+		// Ground enemies chasing a target follow the flow field around the walls in the way, until they are in the target's block
+		glm::vec3 steerPos = targetPos;
+		if (IsChasingOnGround())
+		{
+			const FlowField* pFlowField = m_pEnemyManager->GetFlowField(m_pTargetNPC);
+
+			glm::vec3 flowDirection;
+			if (pFlowField != nullptr && pFlowField->GetDirection(GetCenter(), &flowDirection))
+			{
+				steerPos = GetCenter() + flowDirection * 2.0f;
+			}
+		}
+
+		LookAtPoint(steerPos);
 
 		bool shouldStopMovingUntilJump = false;
 		if (IsBlockInFront())
@@ -3717,7 +3685,7 @@ void Enemy::UpdateMovement(float dt)
 				{
 					if (m_movementWaitAfterAttackTimer <= 0.0f)
 					{
-						glm::vec3 toTarget2 = targetPos - m_position;
+						glm::vec3 toTarget2 = steerPos - m_position;
 						glm::vec3 movementDirection = toTarget2;
 						if (m_enemyType != EnemyType::Bee && m_enemyType != EnemyType::Bat && m_enemyType != EnemyType::Ghost && m_enemyType != EnemyType::Doppelganger)
 						{
@@ -14,6 +14,7 @@
 #include <Models/VoxelCharacter.h>
 #include <Projectile/ProjectileManager.h>
 #include <Renderer/Renderer.h>
+#include <Utils/SimulationLOD.h>
 
 // Forward declaration
 class LightingManager;
@@ -87,6 +88,7 @@ public:
 	glm::vec3 GetRightVector() const;
 	glm::vec3 GetUpVector() const;
 	glm::vec3 GetTargetForward() const;
+	VoxelCharacter* GetVoxelCharacter() const;
 
 	// Setup
 	void SetupEnemyForType();
@@ -99,6 +101,9 @@ public:
 	void SetEnemySpawner(EnemySpawner* pSpawner);
 	void RemoveEnemySpawner(EnemySpawner* pSpawner);
 
+	// Simulation LOD
+	SimulationLOD* GetSimulationLOD();
+
 	// Animation
 	void SetAnimationSpeed(float speed, bool onlySetOnCompleteAnimation, AnimationSections section);
 	float GetAnimationSpeed(AnimationSections section);
@@ -142,6 +147,11 @@ public:
 
 	void SetNPCDied(NPC* pNPC);
 	void SetTargetNPC(NPC* pTargetNPC);
+	NPC* GetTargetNPC() const;
+	void SetAggro(bool aggro);
+	bool IsAggro() const;
+	// Walking or jumping after the target, so following the flow field to it
+	bool IsChasingOnGround() const;
 
 	// Gameplay
 	void SetSapped(bool sapped);
@@ -186,7 +196,13 @@ public:
 	// Updating
 	void UpdateWeaponLights() const;
 	void UpdateWeaponParticleEffects() const;
-	void Update(float dt);
+	// Movement and physics. Only changes this enemy and only reads the player, NPCs and the world,
+	// so the enemy manager runs it for every enemy at once on the worker threads.
+	void UpdateIntegrate(float dt);
+	// Everything that reaches other characters or shared managers, run one enemy at a time after UpdateIntegrate()
+	void UpdateApply(float dt);
+	// Every frame, whether or not the enemy ticked, so it animates smoothly at any simulation tier
+	void UpdateAnimation(float dt);
 	void UpdatePhysics(float dt);
 	void UpdateLookingAndForwardTarget(float dt);
 	void UpdateCombat();
@@ -279,6 +295,8 @@ private:
 	float m_jumpTime;
 	float m_jumpTimer;
 	float m_jumpHeight;
+	// Jumps can happen in UpdateIntegrate(), so their sound waits for UpdateApply()
+	bool m_isJumpSoundPending;
 
 	// Look at point
 	bool m_lookAtPoint;
@@ -381,6 +399,9 @@ private:
 	// Cached chunk from grid position
 	Chunk* m_pCachedGridChunk;
 
+	// How often the enemy manager ticks us
+	SimulationLOD m_simulationLOD;
+
 	// Enemy's world matrix
 	Matrix4 m_worldMatrix;
 
@@ -10,19 +10,43 @@
 #include <CubbyGame.h>
 
 #include <Items/ItemManager.h>
+#include <Models/MS3DModelManager.h>
 #include <Player/Player.h>
+#include <Utils/PerformanceTimer.h>
+#include <Utils/SpatialGrid.h>
+#include <Utils/ThreadPool.h>
 
 #include "EnemyManager.h"
+#include "FlowField.h"
 #include <algorithm>
+#include <limits>
+
+// Number of enemies handed to a worker at a time
+const int ENEMY_INTEGRATE_GRAIN_SIZE = 4;
+
+// Flow fields are kept for the player and a few NPCs at most
+const int MAX_ENEMY_CHASE_FIELDS = 4;
+
+// Seconds a flow field is kept after the last enemy stopped following it
+const float ENEMY_CHASE_FIELD_KEEP_TIME = 5.0f;
+
+// Chunks copied into the flow fields per frame, shared between all of them
+const int ENEMY_CHASE_FIELD_CHUNK_SAMPLES = 8;
+
+// Added to the enemies' radii when targeting with the cursor, so it doesn't have to be right on them
+const float ENEMY_CURSOR_PICKING_PADDING = 0.5f;
 
 // Constructor, Destructor
 EnemyManager::EnemyManager(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer) :
 	m_pRenderer(pRenderer), m_pChunkManager(pChunkManager), m_pLightingManager(nullptr),
 	m_pPlayer(pPlayer), m_pBlockParticleManager(nullptr), m_pTextEffectsManager(nullptr),
 	m_pItemManager(nullptr), m_pProjectileManager(nullptr), m_pHUD(nullptr),
-	m_pQubicleBinaryManager(nullptr), m_pNPCManager(nullptr)
+	m_pQubicleBinaryManager(nullptr), m_pNPCManager(nullptr), m_pSpatialGrid(nullptr),
+	m_lastEnemyCampSpawnTime(0.0f), m_lastEnemyCampSkeletonMemory(0)
 {
 	m_numRenderEnemies = 0;
+	m_pIntegrateEnemyList = nullptr;
+	m_flowFieldUpdateTime = 0.0f;
 }
 
 void EnemyManager::SetLightingManager(LightingManager* pLightingManager)
@@ -65,10 +89,21 @@ void EnemyManager::SetNPCManager(NPCManager* pNPCManager)
 	m_pNPCManager = pNPCManager;
 }
 
+void EnemyManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+SpatialGrid* EnemyManager::GetSpatialGrid() const
+{
+	return m_pSpatialGrid;
+}
+
 EnemyManager::~EnemyManager()
 {
 	ClearEnemies();
 	ClearEnemySpawners();
+	ClearFlowFields();
 }
 
 // Clearing
@@ -79,6 +114,8 @@ void EnemyManager::ClearEnemies()
 
 	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
 	{
+		m_pSpatialGrid->Remove(m_vpEnemyList[i]);
+
 		delete m_vpEnemyList[i];
 		m_vpEnemyList[i] = nullptr;
 	}
@@ -164,6 +201,9 @@ Enemy* EnemyManager::CreateEnemy(glm::vec3 position, EnemyType enemyType, float
 
 void EnemyManager::CreateEnemyCamp(glm::vec3 campPosition)
 {
+	PerformanceTimer spawnTimer;
+	unsigned int skeletonMemoryBefore = MS3DModelManager::GetInstance()->GetNumBytesUsed();
+
 	Enemy* pEnemy1 = CreateEnemy(campPosition + glm::vec3(2.0f, 0.0f, 0.0f), EnemyType::NormalSkeleton, 0.08f);
 	pEnemy1->SetRandomTargetMode(false);
 	pEnemy1->SetTargetForwardToLookAtPoint(campPosition);
@@ -182,6 +222,9 @@ void EnemyManager::CreateEnemyCamp(glm::vec3 campPosition)
 
 	Item* pCampFire = m_pItemManager->CreateItem(campPosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 45.0f, 0.0f), "Resources/gamedata/items/CampFire/CampFire.item", ItemType::CampFire, "Camp Fire", false, false, 0.08f);
 	assert(pCampFire != nullptr);
+
+	m_lastEnemyCampSpawnTime = spawnTimer.GetElapsedTime();
+	m_lastEnemyCampSkeletonMemory = MS3DModelManager::GetInstance()->GetNumBytesUsed() - skeletonMemoryBefore;
 }
 
 EnemySpawner* EnemyManager::CreateEnemySpawner(glm::vec3 position, glm::vec3 direction)
@@ -197,6 +240,16 @@ EnemySpawner* EnemyManager::CreateEnemySpawner(glm::vec3 position, glm::vec3 dir
 	return pEnemySpawner;
 }
 
+float EnemyManager::GetLastEnemyCampSpawnTime() const
+{
+	return m_lastEnemyCampSpawnTime;
+}
+
+int EnemyManager::GetLastEnemyCampSkeletonMemory() const
+{
+	return m_lastEnemyCampSkeletonMemory;
+}
+
 // Get number of enemies
 int EnemyManager::GetNumEnemies()
 {
@@ -226,52 +279,20 @@ Enemy* EnemyManager::GetEnemy(int index)
 }
 
 // Get enemy based on cursor position
-Enemy* EnemyManager::GetCursorEnemy(Camera* pGameCamera, int cursorX, int cursorY)
+Enemy* EnemyManager::GetCursorEnemy(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxDistance)
 {
-	// Project the cursor into the world,
-	m_pRenderer->PushMatrix();
-
-	m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, CubbyGame::GetInstance()->GetDefaultViewport());
-	pGameCamera->Look();
-
-	glm::vec3 worldPos1 = m_pRenderer->GetWorldProjectionFromScreenCoordinates(cursorX, cursorY, 0.5f);
-	glm::vec3 worldPos2 = m_pRenderer->GetWorldProjectionFromScreenCoordinates(cursorX, cursorY, 0.9999f);
-	
-	m_pRenderer->PopMatrix();
-
-	// Check if our projected mouse line is colliding with any enemies
-	bool collides = false;
-	int interations = 0;
-	float increments = Chunk::BLOCK_RENDER_SIZE * 0.1f;
-	glm::vec3 worldNormal = normalize(worldPos2 - worldPos1);
-	
-	while (collides == false && interations < 100)
+	if (m_pSpatialGrid == nullptr)
 	{
-		glm::vec3 newPos = worldPos1 + worldNormal * increments;
-
-		m_enemyMutex.lock();
+		return nullptr;
+	}
 
-		for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
-		{
-			Enemy* pEnemy = m_vpEnemyList[i];
+	m_enemyMutex.lock();
 
-			glm::vec3 diff = pEnemy->GetCenter() - newPos;
-			float diffLength = length(diff);
-			
-			if (diffLength < pEnemy->GetRadius() * 2.5f)
-			{
-				m_enemyMutex.unlock();
-				return pEnemy;
-			}
-		}
-		
-		m_enemyMutex.unlock();
+	Enemy* pEnemy = static_cast<Enemy*>(m_pSpatialGrid->QueryRay(rayOrigin, rayDirection, maxDistance, ENEMY_CURSOR_PICKING_PADDING, SpatialGrid::GetTypeBit(SpatialType::Enemy), nullptr, nullptr, nullptr));
 
-		interations++;
-		increments += Chunk::BLOCK_RENDER_SIZE;
-	}
+	m_enemyMutex.unlock();
 
-	return nullptr;
+	return pEnemy;
 }
 
 // Rendering Helpers
@@ -308,11 +329,12 @@ void EnemyManager::RemoveSappedFromEnemies(Enemy* pEnemyToBeSapped)
 // Collision
 void EnemyManager::PushCollisions(Enemy* pPushingEnemy, glm::vec3 position, float radius)
 {
-	m_enemyMutex.lock();
+	std::vector<void*> vpNearbyEnemies;
+	m_pSpatialGrid->QueryRadius(position, radius, SpatialGrid::GetTypeBit(SpatialType::Enemy), &vpNearbyEnemies);
 
-	for (auto iter = m_vpEnemyList.begin(); iter != m_vpEnemyList.end(); ++iter)
+	for (size_t i = 0; i < vpNearbyEnemies.size(); ++i)
 	{
-		Enemy* pEnemy = *iter;
+		Enemy* pEnemy = static_cast<Enemy*>(vpNearbyEnemies[i]);
 
 		if (pEnemy == pPushingEnemy)
 		{
@@ -328,10 +350,10 @@ void EnemyManager::PushCollisions(Enemy* pPushingEnemy, glm::vec3 position, floa
 			pushVector.y = 0.0f;  // Don't push in Y direction
 			pushVector *= lengthResult;
 			pEnemy->SetPosition(pEnemy->GetPosition() - pushVector);
+
+			m_pSpatialGrid->Update(pEnemy, SpatialType::Enemy, pEnemy->GetCenter(), pEnemy->GetRadius());
 		}
 	}
-
-	m_enemyMutex.unlock();
 }
 
 // Updating
@@ -343,11 +365,11 @@ void EnemyManager::UpdateWeaponLights()
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Parked enemies leave their lights where they are
+		if (pEnemy->GetSimulationLOD()->IsAnimating() == false)
+		{
+			continue;
+		}
 
 		pEnemy->UpdateWeaponLights();
 	}
@@ -363,11 +385,10 @@ void EnemyManager::UpdateWeaponParticleEffects()
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		if (pEnemy->GetSimulationLOD()->IsAnimating() == false)
+		{
+			continue;
+		}
 
 		pEnemy->UpdateWeaponParticleEffects();
 	}
@@ -389,6 +410,12 @@ bool NeedErase(Enemy* e)
 
 void EnemyManager::Update(float dt)
 {
+	// With the simulation LOD off everything is ticked every frame
+	CubbySettings* pSettings = CubbyGame::GetInstance()->GetCubbySettings();
+	float reducedDistance = pSettings->m_simulationLOD ? pSettings->m_simulationLODDistance : std::numeric_limits<float>::max();
+	ChunkManager* pLODChunkManager = pSettings->m_simulationLOD ? m_pChunkManager : nullptr;
+	glm::vec3 playerPosition = m_pPlayer->GetCenter();
+
 	// Update all enemy spawners
 	m_enemySpawnerMutex.lock();
 
@@ -401,13 +428,15 @@ void EnemyManager::Update(float dt)
 			pEnemySpawner->SetPosition(m_pPlayer->GetCenter() + pEnemySpawner->GetInitialPosition());
 		}
 
-		// TODO : Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemySpawner->GetPosition()) == false)
-		//{
-		//	continue;
-		//}
+		SimulationLOD* pSimulationLOD = pEnemySpawner->GetSimulationLOD();
+		pSimulationLOD->Update(dt, pEnemySpawner->GetPosition(), playerPosition, reducedDistance, pLODChunkManager);
+
+		if (pSimulationLOD->IsTicking() == false)
+		{
+			continue;
+		}
 
-		pEnemySpawner->Update(dt);
+		pEnemySpawner->Update(pSimulationLOD->GetTickDeltaTime());
 	}
 
 	m_enemySpawnerMutex.unlock();
@@ -429,27 +458,105 @@ void EnemyManager::Update(float dt)
 	// Erase any dead enemies
 	m_enemyMutex.lock();
 
+	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
+	{
+		if (m_vpEnemyList[i]->GetErase() == true)
+		{
+			m_pSpatialGrid->Remove(m_vpEnemyList[i]);
+		}
+	}
+
 	m_vpEnemyList.erase(remove_if(m_vpEnemyList.begin(), m_vpEnemyList.end(), NeedErase), m_vpEnemyList.end());
 
-	// Update all enemies
+	// Pick how often each enemy is simulated from how far it is from the player, only the ones whose tick came up run their AI and physics
+	m_simulationStats.Reset();
+	m_vpFullEnemyList.clear();
+	m_vpReducedEnemyList.clear();
+
 	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		SimulationLOD* pSimulationLOD = pEnemy->GetSimulationLOD();
+		pSimulationLOD->Update(dt, pEnemy->GetCenter(), playerPosition, reducedDistance, pLODChunkManager);
 
-		pEnemy->Update(dt);
+		SimulationTier tier = pSimulationLOD->GetTier();
+		m_simulationStats.m_numEntities[static_cast<int>(tier)]++;
 
-		m_enemyMutex.unlock();
+		if (pSimulationLOD->IsTicking() == false)
+		{
+			continue;
+		}
+
+		if (tier == SimulationTier::Full)
+		{
+			m_vpFullEnemyList.push_back(pEnemy);
+		}
+		else
+		{
+			m_vpReducedEnemyList.push_back(pEnemy);
+			m_simulationStats.m_numReducedTicks++;
+		}
+	}
 
-		// Allow NPCs to push each other away (simple collision).
-		PushCollisions(pEnemy, pEnemy->GetCenter(), pEnemy->GetRadius());
+	UpdateFlowFields(dt);
 
-		m_enemyMutex.lock();
+	EnemyList* pTickingEnemyLists[2] = { &m_vpFullEnemyList, &m_vpReducedEnemyList };
+	int tickingTiers[2] = { static_cast<int>(SimulationTier::Full), static_cast<int>(SimulationTier::Reduced) };
+
+	// Move every ticking enemy at once, each one only changes itself and the rest of the world holds still until they are all done
+	for (int i = 0; i < 2; ++i)
+	{
+		PerformanceTimer timer;
+
+		m_pIntegrateEnemyList = pTickingEnemyLists[i];
+		ThreadPool::GetInstance()->ParallelFor(static_cast<int>(m_pIntegrateEnemyList->size()), ENEMY_INTEGRATE_GRAIN_SIZE, _IntegrateEnemies, this);
+
+		m_simulationStats.m_updateTime[tickingTiers[i]] += timer.GetElapsedTime();
+	}
+
+	// Then combat, damage and spawning one enemy at a time
+	for (int i = 0; i < 2; ++i)
+	{
+		PerformanceTimer timer;
+
+		for (size_t j = 0; j < pTickingEnemyLists[i]->size(); ++j)
+		{
+			Enemy* pEnemy = (*pTickingEnemyLists[i])[j];
+
+			pEnemy->UpdateApply(pEnemy->GetSimulationLOD()->GetTickDeltaTime());
+			pEnemy->GetSimulationLOD()->SetTickPosition(pEnemy->GetPosition());
+
+			m_pSpatialGrid->Update(pEnemy, SpatialType::Enemy, pEnemy->GetCenter(), pEnemy->GetRadius());
+		}
+
+		// Allow enemies to push each other away (simple collision).
+		for (size_t j = 0; j < pTickingEnemyLists[i]->size(); ++j)
+		{
+			Enemy* pEnemy = (*pTickingEnemyLists[i])[j];
+
+			PushCollisions(pEnemy, pEnemy->GetCenter(), pEnemy->GetRadius());
+		}
+
+		m_simulationStats.m_updateTime[tickingTiers[i]] += timer.GetElapsedTime();
+	}
+
+	// Every enemy that isn't parked animates each frame, the ones that didn't tick are drawn between their last two ticks
+	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+		SimulationLOD* pSimulationLOD = pEnemy->GetSimulationLOD();
+
+		if (pSimulationLOD->IsAnimating() == false)
+		{
+			continue;
+		}
+
+		PerformanceTimer timer;
+
+		pEnemy->UpdateAnimation(dt);
+
+		m_simulationStats.m_updateTime[static_cast<int>(pSimulationLOD->GetTier())] += timer.GetElapsedTime();
 	}
 
 	m_enemyMutex.unlock();
@@ -467,6 +574,133 @@ void EnemyManager::Update(float dt)
 	UpdateEnemyProjectileCheck();
 }
 
+void EnemyManager::UpdateFlowFields(float dt)
+{
+	PerformanceTimer timer;
+
+	if (CubbyGame::GetInstance()->GetCubbySettings()->m_enemyFlowFields == false)
+	{
+		ClearFlowFields();
+		m_flowFieldUpdateTime = 0.0f;
+		return;
+	}
+
+	for (size_t i = 0; i < m_chaseFields.size(); ++i)
+	{
+		m_chaseFields[i].m_unusedTime += dt;
+	}
+
+	// One field per target, however many enemies are chasing it
+	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
+	{
+		Enemy* pEnemy = m_vpEnemyList[i];
+
+		if (pEnemy->IsChasingOnGround() == false)
+		{
+			continue;
+		}
+
+		NPC* pTargetNPC = pEnemy->GetTargetNPC();
+
+		auto iter = find_if(m_chaseFields.begin(), m_chaseFields.end(), [pTargetNPC](const EnemyChaseField& chaseField) { return chaseField.m_pTargetNPC == pTargetNPC; });
+		if (iter != m_chaseFields.end())
+		{
+			iter->m_unusedTime = 0.0f;
+		}
+		else if (static_cast<int>(m_chaseFields.size()) < MAX_ENEMY_CHASE_FIELDS)
+		{
+			EnemyChaseField chaseField;
+			chaseField.m_pTargetNPC = pTargetNPC;
+			chaseField.m_pFlowField = new FlowField(m_pChunkManager);
+			chaseField.m_unusedTime = 0.0f;
+
+			m_chaseFields.push_back(chaseField);
+		}
+	}
+
+	for (size_t i = 0; i < m_chaseFields.size();)
+	{
+		if (m_chaseFields[i].m_unusedTime > ENEMY_CHASE_FIELD_KEEP_TIME)
+		{
+			delete m_chaseFields[i].m_pFlowField;
+			m_chaseFields.erase(m_chaseFields.begin() + i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	// Only fields followed this frame move with their target, an NPC nobody chases any more may be gone
+	int numChunkSamples = ENEMY_CHASE_FIELD_CHUNK_SAMPLES;
+
+	for (size_t i = 0; i < m_chaseFields.size(); ++i)
+	{
+		EnemyChaseField& chaseField = m_chaseFields[i];
+
+		if (chaseField.m_unusedTime > 0.0f)
+		{
+			continue;
+		}
+
+		glm::vec3 targetPosition = (chaseField.m_pTargetNPC != nullptr) ? chaseField.m_pTargetNPC->GetCenter() : m_pPlayer->GetCenter();
+		numChunkSamples -= chaseField.m_pFlowField->Update(targetPosition, numChunkSamples);
+	}
+
+	m_flowFieldUpdateTime = timer.GetElapsedTime();
+}
+
+const FlowField* EnemyManager::GetFlowField(NPC* pTargetNPC) const
+{
+	for (size_t i = 0; i < m_chaseFields.size(); ++i)
+	{
+		if (m_chaseFields[i].m_pTargetNPC == pTargetNPC)
+		{
+			return m_chaseFields[i].m_pFlowField;
+		}
+	}
+
+	return nullptr;
+}
+
+void EnemyManager::ClearFlowFields()
+{
+	for (size_t i = 0; i < m_chaseFields.size(); ++i)
+	{
+		delete m_chaseFields[i].m_pFlowField;
+		m_chaseFields[i].m_pFlowField = nullptr;
+	}
+
+	m_chaseFields.clear();
+}
+
+int EnemyManager::GetNumFlowFields() const
+{
+	return static_cast<int>(m_chaseFields.size());
+}
+
+float EnemyManager::GetFlowFieldUpdateTime() const
+{
+	return m_flowFieldUpdateTime;
+}
+
+const SimulationStats& EnemyManager::GetSimulationStats() const
+{
+	return m_simulationStats;
+}
+
+void EnemyManager::_IntegrateEnemies(void* pData, int begin, int end)
+{
+	EnemyManager* pEnemyManager = static_cast<EnemyManager*>(pData);
+
+	for (int i = begin; i < end; ++i)
+	{
+		Enemy* pEnemy = (*pEnemyManager->m_pIntegrateEnemyList)[i];
+
+		pEnemy->UpdateIntegrate(pEnemy->GetSimulationLOD()->GetTickDeltaTime());
+	}
+}
+
 void EnemyManager::UpdateEnemyPlayerAttackCheck()
 {
 	if (m_pPlayer->IsDead() == true)
@@ -485,11 +719,11 @@ void EnemyManager::UpdateEnemyPlayerAttackCheck()
 			continue;
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		m_pPlayer->CheckEnemyDamageRadius(pEnemy);
 	}
@@ -499,6 +733,8 @@ void EnemyManager::UpdateEnemyPlayerAttackCheck()
 
 void EnemyManager::UpdateEnemyProjectileCheck()
 {
+	std::vector<void*> vpNearbyProjectiles;
+
 	m_enemyMutex.lock();
 
 	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
@@ -510,17 +746,26 @@ void EnemyManager::UpdateEnemyProjectileCheck()
 			continue;
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
+
+		// Only the projectiles that can reach the hitbox
+		float hitboxRadius = pEnemy->GetRadius();
+		if (pEnemy->GetProjectileHitboxType() == ProjectileHitboxType::Cube)
+		{
+			hitboxRadius = length(glm::vec3(pEnemy->GetProjectileHitboxXLength(), pEnemy->GetProjectileHitboxYLength(), pEnemy->GetProjectileHitboxZLength()));
+		}
+
+		m_pSpatialGrid->QueryRadius(pEnemy->GetProjectileHitboxCenter(), hitboxRadius, SpatialGrid::GetTypeBit(SpatialType::Projectile), &vpNearbyProjectiles);
 
-		for (int j = 0; j < m_pProjectileManager->GetNumProjectiles(); ++j)
+		for (size_t j = 0; j < vpNearbyProjectiles.size(); ++j)
 		{
-			Projectile* pProjectile = m_pProjectileManager->GetProjectile(j);
+			Projectile* pProjectile = static_cast<Projectile*>(vpNearbyProjectiles[j]);
 
-			if (pProjectile != nullptr && pProjectile->GetErase() == false)
+			if (pProjectile->GetErase() == false)
 			{
 				pEnemy->CheckProjectileDamageRadius(pProjectile);
 			}
@@ -549,27 +794,36 @@ void EnemyManager::Render(bool outline, bool reflection, bool silhouette, bool s
 {
 	m_numRenderEnemies = 0;
 
+	// The main pass also records which enemies are visible, for the animation level of detail
+	bool isVisibilityPass = (reflection == false && silhouette == false && shadow == false);
+
 	m_enemyMutex.lock();
 
 	for (size_t i = 0; i < m_vpEnemyList.size(); ++i)
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
+		VoxelCharacter* pVoxelCharacter = pEnemy->GetVoxelCharacter();
 
 		if (silhouette && pEnemy->GetOutlineRender() == false)
 		{
 			continue; // Don't render silhouette unless we are rendering outline
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		// Fog
 		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pEnemy->GetCenter());
 		if (toCamera > m_pChunkManager->GetLoaderRadius() + (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 5.0f))
 		{
+			if (isVisibilityPass && pVoxelCharacter != nullptr)
+			{
+				pVoxelCharacter->SetRenderVisible(false);
+			}
+
 			continue;
 		}
 		if (toCamera > m_pChunkManager->GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 3.0f)
@@ -577,8 +831,20 @@ void EnemyManager::Render(bool outline, bool reflection, bool silhouette, bool s
 			m_pRenderer->EnableTransparency(BlendFunction::SRC_ALPHA, BlendFunction::ONE_MINUS_SRC_ALPHA);
 		}
 
-		if (shadow || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
+		bool inFrustum = shadow || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius());
+		if (isVisibilityPass && pVoxelCharacter != nullptr)
+		{
+			pVoxelCharacter->SetRenderVisible(inFrustum);
+		}
+
+		if (inFrustum)
 		{
+			// Level of detail
+			if (pVoxelCharacter != nullptr)
+			{
+				pVoxelCharacter->SetRenderLODLevel(QubicleBinary::CalculateLODLevel(toCamera, pEnemy->GetRadius(), CubbyGame::GetInstance()->GetCubbySettings()->m_lodBias));
+			}
+
 			pEnemy->Render(outline, reflection, silhouette);
 
 			m_numRenderEnemies++;
@@ -598,11 +864,11 @@ void EnemyManager::RenderFaces()
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
 		{
@@ -626,11 +892,11 @@ void EnemyManager::RenderOutlineEnemies()
 			continue;
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
 		{
@@ -649,11 +915,11 @@ void EnemyManager::RenderWeaponTrails()
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
 		{
@@ -673,11 +939,11 @@ void EnemyManager::RenderDebug()
 	{
 		Enemy* pEnemy = m_vpEnemyList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pEnemy->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant enemies are parked until their chunk is loaded again
+		if (pEnemy->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pEnemy->GetCenter(), pEnemy->GetRadius()))
 		{
@@ -21,10 +21,22 @@ class ItemManager;
 class ProjectileManager;
 class HUD;
 class NPCManager;
+class SpatialGrid;
+class FlowField;
 
 using EnemyList = std::vector<Enemy*>;
 using EnemySpawnerList = std::vector<EnemySpawner*>;
 
+// A flow field shared by every enemy chasing the same target, the player when m_pTargetNPC is nullptr
+struct EnemyChaseField
+{
+	NPC* m_pTargetNPC;
+	FlowField* m_pFlowField;
+	float m_unusedTime;
+};
+
+using EnemyChaseFieldList = std::vector<EnemyChaseField>;
+
 class EnemyManager
 {
 public:
@@ -40,6 +52,9 @@ public:
 	void SetHUD(HUD* pHUD);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
 	void SetNPCManager(NPCManager* pNPCManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+
+	SpatialGrid* GetSpatialGrid() const;
 
 	// Clearing
 	void ClearEnemies();
@@ -53,13 +68,17 @@ public:
 	void CreateEnemyCamp(glm::vec3 campPosition);
 	EnemySpawner* CreateEnemySpawner(glm::vec3 position, glm::vec3 direction);
 
+	// Spawn metrics for the last enemy camp, time in milliseconds and skeleton memory in bytes
+	float GetLastEnemyCampSpawnTime() const;
+	int GetLastEnemyCampSkeletonMemory() const;
+
 	// Get number of enemies
 	int GetNumEnemies();
 	int GetNumRenderEnemies() const;
 	Enemy* GetEnemy(int index);
 
-	// Get enemy based on cursor position
-	Enemy* GetCursorEnemy(Camera* pGameCamera, int cursorX, int cursorY);
+	// Get enemy based on the ray through the cursor, the nearest one it hits within maxDistance
+	Enemy* GetCursorEnemy(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxDistance);
 
 	// Rendering Helpers
 	void SetWireFrameRender(bool wireframe);
@@ -67,7 +86,17 @@ public:
 	// Gameplay
 	void RemoveSappedFromEnemies(Enemy* pEnemyToBeSapped);
 
-	// Collision
+	// Flow fields, nullptr when no enemy is chasing the target along the ground
+	const FlowField* GetFlowField(NPC* pTargetNPC) const;
+	void ClearFlowFields();
+	int GetNumFlowFields() const;
+	// Milliseconds the main thread spent copying chunks into the flow fields last frame
+	float GetFlowFieldUpdateTime() const;
+
+	// Enemies simulated at each tier last frame
+	const SimulationStats& GetSimulationStats() const;
+
+	// Collision, called with the enemy list locked
 	void PushCollisions(Enemy* pPushingEnemy, glm::vec3 position, float radius);
 
 	// Updating
@@ -89,6 +118,10 @@ public:
 	static const int MAX_NUM_ENEMIES = 15;
 
 private:
+	static void _IntegrateEnemies(void* pData, int begin, int end);
+
+	void UpdateFlowFields(float dt);
+
 	Renderer* m_pRenderer;
 	ChunkManager* m_pChunkManager;
 	LightingManager* m_pLightingManager;
@@ -100,9 +133,20 @@ private:
 	HUD* m_pHUD;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	NPCManager* m_pNPCManager;
+	SpatialGrid* m_pSpatialGrid;
 
 	int m_numRenderEnemies;
 
+	// Enemies ticking this frame at the full and reduced tiers, and the one of them handed to the integrate jobs
+	EnemyList m_vpFullEnemyList;
+	EnemyList m_vpReducedEnemyList;
+	EnemyList* m_pIntegrateEnemyList;
+	SimulationStats m_simulationStats;
+
+	// Enemy camp spawn metrics
+	float m_lastEnemyCampSpawnTime;
+	int m_lastEnemyCampSkeletonMemory;
+
 	// Enemy lists
 	tthread::mutex m_enemyMutex;
 	EnemyList m_vpEnemyList;
@@ -111,6 +155,10 @@ private:
 	// Enemy spawner
 	tthread::mutex m_enemySpawnerMutex;
 	EnemySpawnerList m_vpEnemySpawnerList;
+
+	// Flow fields to the targets being chased
+	EnemyChaseFieldList m_chaseFields;
+	float m_flowFieldUpdateTime;
 };
 
 
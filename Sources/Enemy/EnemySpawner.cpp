@@ -74,6 +74,11 @@ bool EnemySpawner::ShouldFollowPlayer() const
 	return m_followPlayerIntheWorld;
 }
 
+SimulationLOD* EnemySpawner::GetSimulationLOD()
+{
+	return &m_simulationLOD;
+}
+
 // Spawning params
 void EnemySpawner::SetSpawningParams(float initialSpawnDelay, float spawnTimer, int maxNumEnemiesActive, glm::vec3 spawnRandomOffset, bool shouldSpawnOnGround, glm::vec3 groundSpawnOffset, bool followPlayerIntheWorld, bool spawnFullLoaderRange, float minDistanceFromPlayer, Biome biomeSpawn)
 {
@@ -254,13 +259,11 @@ void EnemySpawner::RenderDebug() const
 	m_pRenderer->SetCullMode(CullMode::NOCULL);
 	m_pRenderer->SetLineWidth(1.0f);
 
-	// TODO: Loader culling
-	//if(m_pChunkManager->IsInsideLoader(m_position) == false)
-	//{
-	//m_pRenderer->ImmediateColourAlpha(0.1f, 0.8f, 0.85f, 1.0f);
-	//}
-
-	if (m_spawning && m_canSpawn)
+	if (m_simulationLOD.GetTier() == SimulationTier::Dormant)
+	{
+		m_pRenderer->ImmediateColorAlpha(0.1f, 0.8f, 0.85f, 1.0f);
+	}
+	else if (m_spawning && m_canSpawn)
 	{
 		m_pRenderer->ImmediateColorAlpha(0.1f, 0.8f, 0.05f, 1.0f);
 	}
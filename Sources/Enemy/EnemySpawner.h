@@ -41,6 +41,7 @@ public:
 	void SetFacingDirection(glm::vec3 dir);
 	glm::vec3 GetFacingDirection() const;
 	bool ShouldFollowPlayer() const;
+	SimulationLOD* GetSimulationLOD();
 
 	// Spawning params
 	void SetSpawningParams(float initialSpawnDelay, float spawnTimer, int maxNumEnemiesActive, glm::vec3 spawnRandomOffset, bool shouldSpawnOnGround, glm::vec3 groundSpawnOffset, bool followPlayerIntheWorld, bool spawnFullLoaderRange, float minDistanceFromPlayer, Biome biomeSpawn);
@@ -117,6 +118,9 @@ private:
 
 	// Spawning params
 	float m_spawnCountdownTimer;
+
+	// How often the enemy manager ticks us
+	SimulationLOD m_simulationLOD;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,472 @@
+/*************************************************************************
+> File Name: FlowField.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A map of the walking distance to one target over the loaded blocks
+> 	 around it. Every enemy chasing the target reads the direction to
+> 	 walk in from its own block, instead of searching for a path itself.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Blocks/ChunkManager.h>
+#include <Utils/AssetLoader.h>
+#include <Utils/PerformanceTimer.h>
+
+#include "FlowField.h"
+
+// Size of the field in blocks
+const int FIELD_SIZE_X = FlowField::CHUNKS_XZ * Chunk::CHUNK_SIZE;
+const int FIELD_SIZE_Y = FlowField::CHUNKS_Y * Chunk::CHUNK_SIZE;
+const int FIELD_SIZE_Z = FlowField::CHUNKS_XZ * Chunk::CHUNK_SIZE;
+const int FIELD_NUM_CELLS = FIELD_SIZE_X * FIELD_SIZE_Y * FIELD_SIZE_Z;
+
+// Walking costs, a diagonal step is about one and a half steps along an axis
+const int FLOW_STEP_COST = 2;
+const int FLOW_DIAGONAL_COST = 3;
+const int FLOW_JUMP_COST = 4;
+
+// Enemies drop down ledges up to this many blocks high
+const int FLOW_MAX_DROP = 3;
+
+// A character's center is at most this many blocks above the block it stands in
+const int FLOW_MAX_STAND_DEPTH = 3;
+
+// The search keeps a bucket per cost, only the costs up to the largest step are ever waiting
+const int FLOW_NUM_BUCKETS = 8;
+
+const unsigned short FLOW_UNREACHABLE = 0xFFFF;
+
+// Neighboring columns, each direction is followed by its opposite
+const int FLOW_DIRECTION_X[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+const int FLOW_DIRECTION_Z[8] = { 0, 0, 1, -1, 1, -1, -1, 1 };
+
+static int GetBlockCoordinate(float value)
+{
+	return static_cast<int>(std::floor((value + Chunk::BLOCK_RENDER_SIZE) / (Chunk::BLOCK_RENDER_SIZE * 2.0f)));
+}
+
+static int GetChunkCoordinate(int blockCoordinate)
+{
+	if (blockCoordinate >= 0)
+	{
+		return blockCoordinate / Chunk::CHUNK_SIZE;
+	}
+
+	return -((-blockCoordinate + Chunk::CHUNK_SIZE - 1) / Chunk::CHUNK_SIZE);
+}
+
+static int GetCellIndex(int x, int y, int z)
+{
+	return x + FIELD_SIZE_X * (z + FIELD_SIZE_Z * y);
+}
+
+// Constructor, Destructor
+FlowField::FlowField(ChunkManager* pChunkManager) :
+	m_pChunkManager(pChunkManager), m_originChunkX(0), m_originChunkY(0), m_originChunkZ(0), m_isSolidChanged(false),
+	m_isBuilding(false), m_buildOriginX(0), m_buildOriginY(0), m_buildOriginZ(0), m_buildTargetX(0), m_buildTargetY(0), m_buildTargetZ(0),
+	m_buildTime(0.0f), m_buildNumReachableCells(0),
+	m_fieldOriginX(0), m_fieldOriginY(0), m_fieldOriginZ(0), m_hasField(false),
+	m_numBuilds(0), m_lastBuildTime(0.0f), m_numReachableCells(0)
+{
+	ChunkSlot emptySlot = { nullptr, 0, false };
+	m_chunkSlots.assign(CHUNKS_XZ * CHUNKS_Y * CHUNKS_XZ, emptySlot);
+	m_solid.assign(FIELD_NUM_CELLS, 0);
+}
+
+FlowField::~FlowField()
+{
+	// The loader thread still has the field
+	if (m_isBuilding)
+	{
+		AssetLoader::GetInstance()->WaitForAsset(this);
+	}
+}
+
+int FlowField::Update(const glm::vec3& targetPosition, int maxChunkSamples)
+{
+	int targetX = GetBlockCoordinate(targetPosition.x);
+	int targetY = GetBlockCoordinate(targetPosition.y);
+	int targetZ = GetBlockCoordinate(targetPosition.z);
+
+	int originChunkX = GetChunkCoordinate(targetX) - CHUNKS_XZ / 2;
+	int originChunkY = GetChunkCoordinate(targetY) - CHUNKS_Y / 2;
+	int originChunkZ = GetChunkCoordinate(targetZ) - CHUNKS_XZ / 2;
+
+	if (originChunkX != m_originChunkX || originChunkY != m_originChunkY || originChunkZ != m_originChunkZ)
+	{
+		MoveWindow(originChunkX, originChunkY, originChunkZ);
+	}
+
+	// Copy the chunks that are new to the field or changed since they were copied
+	int numSampled = 0;
+	for (int i = 0; i < static_cast<int>(m_chunkSlots.size()) && numSampled < maxChunkSamples; ++i)
+	{
+		int slotX = i % CHUNKS_XZ;
+		int slotZ = (i / CHUNKS_XZ) % CHUNKS_XZ;
+		int slotY = i / (CHUNKS_XZ * CHUNKS_XZ);
+
+		Chunk* pChunk = m_pChunkManager->GetChunk(m_originChunkX + slotX, m_originChunkY + slotY, m_originChunkZ + slotZ);
+
+		// Chunks that are still being generated count as missing until they are done
+		if (pChunk != nullptr && pChunk->IsSetup() == false)
+		{
+			pChunk = nullptr;
+		}
+
+		const ChunkSlot& slot = m_chunkSlots[i];
+		if (slot.m_isSampled && slot.m_pChunk == pChunk && (pChunk == nullptr || slot.m_numBlockChanges == pChunk->GetNumBlockChanges()))
+		{
+			continue;
+		}
+
+		SampleChunk(i, pChunk);
+		numSampled++;
+	}
+
+	// One search at a time, the enemies keep using the last field until the new one is published
+	bool hasTargetMoved = targetX != m_buildTargetX || targetY != m_buildTargetY || targetZ != m_buildTargetZ;
+
+	if (m_isBuilding == false && (m_isSolidChanged || hasTargetMoved))
+	{
+		m_buildOriginX = m_originChunkX * Chunk::CHUNK_SIZE;
+		m_buildOriginY = m_originChunkY * Chunk::CHUNK_SIZE;
+		m_buildOriginZ = m_originChunkZ * Chunk::CHUNK_SIZE;
+		m_buildTargetX = targetX;
+		m_buildTargetY = targetY;
+		m_buildTargetZ = targetZ;
+		m_buildSolid = m_solid;
+
+		m_isSolidChanged = false;
+		m_isBuilding = true;
+
+		AssetLoader::GetInstance()->QueueLoad(this, _Build, _Publish);
+	}
+
+	return numSampled;
+}
+
+bool FlowField::GetDirection(const glm::vec3& position, glm::vec3* pDirection) const
+{
+	if (m_hasField == false)
+	{
+		return false;
+	}
+
+	int x = GetBlockCoordinate(position.x) - m_fieldOriginX;
+	int y = GetBlockCoordinate(position.y) - m_fieldOriginY;
+	int z = GetBlockCoordinate(position.z) - m_fieldOriginZ;
+
+	if (x < 0 || x >= FIELD_SIZE_X || z < 0 || z >= FIELD_SIZE_Z)
+	{
+		return false;
+	}
+
+	for (int depth = 0; depth <= FLOW_MAX_STAND_DEPTH; ++depth)
+	{
+		int cellY = y - depth;
+		if (cellY < 0 || cellY >= FIELD_SIZE_Y)
+		{
+			continue;
+		}
+
+		unsigned char direction = m_directions[GetCellIndex(x, cellY, z)];
+		if (direction != 0)
+		{
+			*pDirection = normalize(glm::vec3(FLOW_DIRECTION_X[direction - 1], 0.0f, FLOW_DIRECTION_Z[direction - 1]));
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int FlowField::GetNumBuilds() const
+{
+	return m_numBuilds;
+}
+
+float FlowField::GetLastBuildTime() const
+{
+	return m_lastBuildTime;
+}
+
+int FlowField::GetNumReachableCells() const
+{
+	return m_numReachableCells;
+}
+
+bool FlowField::_Build(void* pData)
+{
+	FlowField* pFlowField = static_cast<FlowField*>(pData);
+
+	return pFlowField->Build();
+}
+
+void FlowField::_Publish(void* pData, bool isBuilt)
+{
+	FlowField* pFlowField = static_cast<FlowField*>(pData);
+
+	// No floor under the target, the enemies keep following the last field until the target lands
+	if (isBuilt == false)
+	{
+		pFlowField->m_isBuilding = false;
+		return;
+	}
+
+	pFlowField->Publish();
+}
+
+bool FlowField::Build()
+{
+	PerformanceTimer timer;
+
+	m_buildDistances.assign(FIELD_NUM_CELLS, FLOW_UNREACHABLE);
+	m_buildDirections.assign(FIELD_NUM_CELLS, 0);
+	m_buildNumReachableCells = 0;
+
+	const std::vector<unsigned char>& solid = m_buildSolid;
+
+	auto isEmpty = [&solid](int x, int y, int z)
+	{
+		if (y < 0 || y >= FIELD_SIZE_Y)
+		{
+			return true;
+		}
+
+		return solid[GetCellIndex(x, y, z)] == 0;
+	};
+
+	// A character can stand in an empty block with room for its head above and a solid block below
+	auto isStandable = [&solid, &isEmpty](int x, int y, int z)
+	{
+		return y >= 1 && y < FIELD_SIZE_Y && isEmpty(x, y, z) && isEmpty(x, y + 1, z) && solid[GetCellIndex(x, y - 1, z)] != 0;
+	};
+
+	// The target may be jumping or falling, the search starts from the floor under it
+	int targetX = m_buildTargetX - m_buildOriginX;
+	int targetY = m_buildTargetY - m_buildOriginY;
+	int targetZ = m_buildTargetZ - m_buildOriginZ;
+	int startCell = -1;
+
+	if (targetX >= 0 && targetX < FIELD_SIZE_X && targetZ >= 0 && targetZ < FIELD_SIZE_Z)
+	{
+		for (int depth = 0; depth <= FLOW_MAX_STAND_DEPTH + FLOW_MAX_DROP; ++depth)
+		{
+			if (isStandable(targetX, targetY - depth, targetZ))
+			{
+				startCell = GetCellIndex(targetX, targetY - depth, targetZ);
+				break;
+			}
+		}
+	}
+
+	if (startCell == -1)
+	{
+		m_buildTime = timer.GetElapsedTime();
+		return false;
+	}
+
+	std::vector<int> buckets[FLOW_NUM_BUCKETS];
+	int numQueued = 0;
+
+	// Reaching the cell from the neighboring column in direction
+	auto relax = [this, &buckets, &numQueued, &isStandable](int x, int y, int z, int cost, int direction)
+	{
+		if (cost >= FLOW_UNREACHABLE || isStandable(x, y, z) == false)
+		{
+			return;
+		}
+
+		int cellIndex = GetCellIndex(x, y, z);
+		if (cost < m_buildDistances[cellIndex])
+		{
+			m_buildDistances[cellIndex] = static_cast<unsigned short>(cost);
+			m_buildDirections[cellIndex] = static_cast<unsigned char>(direction + 1);
+
+			buckets[cost % FLOW_NUM_BUCKETS].push_back(cellIndex);
+			numQueued++;
+		}
+	};
+
+	m_buildDistances[startCell] = 0;
+	buckets[0].push_back(startCell);
+	numQueued++;
+
+	// Dijkstra outwards from the target, each cell remembers the step back towards it
+	for (int cost = 0; numQueued > 0; ++cost)
+	{
+		std::vector<int>& bucket = buckets[cost % FLOW_NUM_BUCKETS];
+
+		while (bucket.empty() == false)
+		{
+			int cellIndex = bucket.back();
+			bucket.pop_back();
+			numQueued--;
+
+			// Already reached again for less
+			if (m_buildDistances[cellIndex] != cost)
+			{
+				continue;
+			}
+
+			m_buildNumReachableCells++;
+
+			int x = cellIndex % FIELD_SIZE_X;
+			int z = (cellIndex / FIELD_SIZE_X) % FIELD_SIZE_Z;
+			int y = cellIndex / (FIELD_SIZE_X * FIELD_SIZE_Z);
+
+			for (int direction = 0; direction < 8; ++direction)
+			{
+				int fromX = x + FLOW_DIRECTION_X[direction];
+				int fromZ = z + FLOW_DIRECTION_Z[direction];
+
+				if (fromX < 0 || fromX >= FIELD_SIZE_X || fromZ < 0 || fromZ >= FIELD_SIZE_Z)
+				{
+					continue;
+				}
+
+				// Walking from there is the opposite direction
+				int backDirection = direction ^ 1;
+
+				if (direction >= 4)
+				{
+					// Diagonal steps stay on the level and can't cut the corner of a wall
+					if (isEmpty(fromX, y, z) && isEmpty(fromX, y + 1, z) && isEmpty(x, y, fromZ) && isEmpty(x, y + 1, fromZ))
+					{
+						relax(fromX, y, fromZ, cost + FLOW_DIAGONAL_COST, backDirection);
+					}
+
+					continue;
+				}
+
+				// Walking on the same level
+				relax(fromX, y, fromZ, cost + FLOW_STEP_COST, backDirection);
+
+				// Jumping up a block, with room above the head to jump
+				if (isEmpty(fromX, y + 1, fromZ))
+				{
+					relax(fromX, y - 1, fromZ, cost + FLOW_JUMP_COST, backDirection);
+				}
+
+				// Walking off a ledge, over this column at the ledge's height, and falling down to here
+				for (int drop = 1; drop <= FLOW_MAX_DROP; ++drop)
+				{
+					if (isEmpty(x, y + drop + 1, z) == false)
+					{
+						break;
+					}
+
+					relax(fromX, y + drop, fromZ, cost + FLOW_STEP_COST + drop, backDirection);
+				}
+			}
+		}
+	}
+
+	m_buildTime = timer.GetElapsedTime();
+
+	return true;
+}
+
+void FlowField::Publish()
+{
+	m_directions.swap(m_buildDirections);
+	m_fieldOriginX = m_buildOriginX;
+	m_fieldOriginY = m_buildOriginY;
+	m_fieldOriginZ = m_buildOriginZ;
+	m_hasField = m_buildNumReachableCells > 0;
+
+	m_numBuilds++;
+	m_lastBuildTime = m_buildTime;
+	m_numReachableCells = m_buildNumReachableCells;
+
+	m_isBuilding = false;
+}
+
+void FlowField::MoveWindow(int originChunkX, int originChunkY, int originChunkZ)
+{
+	std::vector<ChunkSlot> oldChunkSlots;
+	std::vector<unsigned char> oldSolid;
+	oldChunkSlots.swap(m_chunkSlots);
+	oldSolid.swap(m_solid);
+
+	ChunkSlot emptySlot = { nullptr, 0, false };
+	m_chunkSlots.assign(oldChunkSlots.size(), emptySlot);
+	m_solid.assign(FIELD_NUM_CELLS, 0);
+
+	// Chunks still inside the field keep their blocks, only the new edge has to be copied from the chunks
+	for (int i = 0; i < static_cast<int>(m_chunkSlots.size()); ++i)
+	{
+		int slotX = i % CHUNKS_XZ;
+		int slotZ = (i / CHUNKS_XZ) % CHUNKS_XZ;
+		int slotY = i / (CHUNKS_XZ * CHUNKS_XZ);
+
+		int oldSlotX = slotX + originChunkX - m_originChunkX;
+		int oldSlotY = slotY + originChunkY - m_originChunkY;
+		int oldSlotZ = slotZ + originChunkZ - m_originChunkZ;
+
+		if (oldSlotX < 0 || oldSlotX >= CHUNKS_XZ || oldSlotY < 0 || oldSlotY >= CHUNKS_Y || oldSlotZ < 0 || oldSlotZ >= CHUNKS_XZ)
+		{
+			continue;
+		}
+
+		const ChunkSlot& oldSlot = oldChunkSlots[oldSlotX + CHUNKS_XZ * (oldSlotZ + CHUNKS_XZ * oldSlotY)];
+		if (oldSlot.m_isSampled == false)
+		{
+			continue;
+		}
+
+		m_chunkSlots[i] = oldSlot;
+
+		for (int y = 0; y < Chunk::CHUNK_SIZE; ++y)
+		{
+			for (int z = 0; z < Chunk::CHUNK_SIZE; ++z)
+			{
+				int oldRow = GetCellIndex(oldSlotX * Chunk::CHUNK_SIZE, oldSlotY * Chunk::CHUNK_SIZE + y, oldSlotZ * Chunk::CHUNK_SIZE + z);
+				int newRow = GetCellIndex(slotX * Chunk::CHUNK_SIZE, slotY * Chunk::CHUNK_SIZE + y, slotZ * Chunk::CHUNK_SIZE + z);
+
+				std::copy(oldSolid.begin() + oldRow, oldSolid.begin() + oldRow + Chunk::CHUNK_SIZE, m_solid.begin() + newRow);
+			}
+		}
+	}
+
+	m_originChunkX = originChunkX;
+	m_originChunkY = originChunkY;
+	m_originChunkZ = originChunkZ;
+
+	m_isSolidChanged = true;
+}
+
+void FlowField::SampleChunk(int slotIndex, Chunk* pChunk)
+{
+	int slotX = slotIndex % CHUNKS_XZ;
+	int slotZ = (slotIndex / CHUNKS_XZ) % CHUNKS_XZ;
+	int slotY = slotIndex / (CHUNKS_XZ * CHUNKS_XZ);
+
+	// Missing chunks are open air, which has no floor to walk on
+	for (int y = 0; y < Chunk::CHUNK_SIZE; ++y)
+	{
+		for (int z = 0; z < Chunk::CHUNK_SIZE; ++z)
+		{
+			int row = GetCellIndex(slotX * Chunk::CHUNK_SIZE, slotY * Chunk::CHUNK_SIZE + y, slotZ * Chunk::CHUNK_SIZE + z);
+
+			for (int x = 0; x < Chunk::CHUNK_SIZE; ++x)
+			{
+				m_solid[row + x] = (pChunk != nullptr && pChunk->GetActive(x, y, z)) ? 1 : 0;
+			}
+		}
+	}
+
+	ChunkSlot& slot = m_chunkSlots[slotIndex];
+	slot.m_pChunk = pChunk;
+	slot.m_numBlockChanges = (pChunk != nullptr) ? pChunk->GetNumBlockChanges() : 0;
+	slot.m_isSampled = true;
+
+	m_isSolidChanged = true;
+}
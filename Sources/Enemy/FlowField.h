@@ -0,0 +1,101 @@
+/*************************************************************************
+> File Name: FlowField.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A map of the walking distance to one target over the loaded blocks
+> 	 around it. Every enemy chasing the target reads the direction to
+> 	 walk in from its own block, instead of searching for a path itself.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_FLOW_FIELD_H
+#define CUBBY_FLOW_FIELD_H
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// Forward declaration
+class Chunk;
+class ChunkManager;
+
+class FlowField
+{
+public:
+	// Constructor, Destructor
+	FlowField(ChunkManager* pChunkManager);
+	~FlowField();
+
+	// Follows the target, copying the blocks of at most maxChunkSamples new or changed chunks, and starts a new
+	// search on a loader thread when the target moved to another block or the blocks changed. Returns the number of chunks copied.
+	int Update(const glm::vec3& targetPosition, int maxChunkSamples);
+
+	// Direction to walk in from position to get closer to the target. False when the position is outside the field,
+	// can't reach the target or is already at it. Only reads the field, so enemies can call it from the worker threads.
+	bool GetDirection(const glm::vec3& position, glm::vec3* pDirection) const;
+
+	// Statistics
+	int GetNumBuilds() const;
+	float GetLastBuildTime() const;
+	int GetNumReachableCells() const;
+
+	// Size of the field in chunks, centered on the target's chunk
+	static const int CHUNKS_XZ = 5;
+	static const int CHUNKS_Y = 3;
+
+private:
+	struct ChunkSlot
+	{
+		Chunk* m_pChunk;
+		unsigned int m_numBlockChanges;
+		bool m_isSampled;
+	};
+
+	static bool _Build(void* pData);
+	static void _Publish(void* pData, bool isBuilt);
+	// False when there is no floor under the target to search from
+	bool Build();
+	void Publish();
+
+	void MoveWindow(int originChunkX, int originChunkY, int originChunkZ);
+	void SampleChunk(int slotIndex, Chunk* pChunk);
+
+	ChunkManager* m_pChunkManager;
+
+	// Blocks around the target, copied from the chunks on the main thread. 1 for solid blocks.
+	int m_originChunkX;
+	int m_originChunkY;
+	int m_originChunkZ;
+	std::vector<ChunkSlot> m_chunkSlots;
+	std::vector<unsigned char> m_solid;
+	bool m_isSolidChanged;
+
+	// The search running on a loader thread, it only touches these until it is published
+	bool m_isBuilding;
+	int m_buildOriginX;
+	int m_buildOriginY;
+	int m_buildOriginZ;
+	int m_buildTargetX;
+	int m_buildTargetY;
+	int m_buildTargetZ;
+	std::vector<unsigned char> m_buildSolid;
+	std::vector<unsigned short> m_buildDistances;
+	std::vector<unsigned char> m_buildDirections;
+	float m_buildTime;
+	int m_buildNumReachableCells;
+
+	// The field the enemies read, the direction out of each block or 0 where the target can't be reached
+	int m_fieldOriginX;
+	int m_fieldOriginY;
+	int m_fieldOriginZ;
+	std::vector<unsigned char> m_directions;
+	bool m_hasField;
+
+	int m_numBuilds;
+	float m_lastBuildTime;
+	int m_numReachableCells;
+};
+
+#endif
@@ -1250,9 +1250,12 @@ void CreateCharacter::SavedNewPresetModel(std::string modelToLoadToCharacter)
 	char modelFile[128];
 	sprintf(modelFile, "%s.qb", modelToLoadToCharacter.c_str());
 
-	QubicleBinary* pNewFile = new QubicleBinary(m_pRenderer);
-	pNewFile->Import(modelFile, true);
+	QubicleBinary* pNewFile = CubbyGame::GetInstance()->GetQubicleBinaryManager()->CreateQubicleBinaryInstance(modelFile);
 	m_pCustomCreationNPC->GetVoxelCharacter()->SwapBodyPart(presetName.c_str(), pNewFile->GetQubicleMatrix(0), true);
+
+	// The swapped in matrix belongs to the character now, the rest of the preset model can go
+	pNewFile->SetNullLinkage(m_pCustomCreationNPC->GetVoxelCharacter()->GetQubicleModel());
+	CubbyGame::GetInstance()->GetQubicleBinaryManager()->DestroyQubicleBinaryInstance(pNewFile);
 }
 
 void CreateCharacter::UpdateCustomCounter(int incrementValue)
@@ -2064,10 +2067,13 @@ void CreateCharacter::PresetButtonPressed(PresetButtonData* presetButtonData)
 		sprintf(presetFile, "Resources/gamedata/models/createcharacter/presets/%s/custom/%s.qb", presetFolderName.c_str(), presetButtonData->m_presetFileName.c_str());
 	}
 	
-	QubicleBinary* pNewFile = new QubicleBinary(m_pRenderer);
-	pNewFile->Import(presetFile, true);
+	QubicleBinary* pNewFile = CubbyGame::GetInstance()->GetQubicleBinaryManager()->CreateQubicleBinaryInstance(presetFile);
 	m_pCustomCreationNPC->GetVoxelCharacter()->SwapBodyPart(presetName.c_str(), pNewFile->GetQubicleMatrix(0), true);
 
+	// The swapped in matrix belongs to the character now, the rest of the preset model can go
+	pNewFile->SetNullLinkage(m_pCustomCreationNPC->GetVoxelCharacter()->GetQubicleModel());
+	CubbyGame::GetInstance()->GetQubicleBinaryManager()->DestroyQubicleBinaryInstance(pNewFile);
+
 	// Load the default settings file
 	char defaultFile[128];
 	if (presetButtonData->m_customPreset == false)
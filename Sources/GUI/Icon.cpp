@@ -250,6 +250,16 @@ void Icon::DrawSelf()
 	{
 		if (m_textureID != -1)
 		{
+			// Atlased icons are drawn together with the rest of the GUI's sprites, leaving the state as drawing it here would
+			m_pRenderer->ImmediateColorAlpha(1.0f, 1.0f, 1.0f, 1.0f);
+			if (m_pRenderer->AddSpriteToBatch(m_textureID, 0.0f, -adjustedPaddingHeight, width, height - adjustedPaddingHeight, GetDepth(), 0.0f, 1.0f, 1.0f, 0.0f))
+			{
+				m_pRenderer->DisableTransparency();
+				m_pRenderer->DisableTexture();
+
+				return;
+			}
+
 			m_pRenderer->PushMatrix();
 
 			m_pRenderer->SetRenderMode(RenderMode::TEXTURED);
@@ -89,7 +89,7 @@ MultiLineTextBox::MultiLineTextBox(Renderer* pRenderer, unsigned int GUIFont, co
 
 MultiLineTextBox::~MultiLineTextBox()
 {
-	TimeManager::GetInstance()->RemoveCountdownTimer(m_pPipeDisplayCountDown);
+	delete m_pPipeDisplayCountDown;
 
 	delete m_pBackgroundIcon;
 
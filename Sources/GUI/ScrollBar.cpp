@@ -166,7 +166,7 @@ ScrollBar::ScrollBar(Renderer* pRenderer, const std::string& leftDefaultTexture,
 
 ScrollBar::~ScrollBar()
 {
-	TimeManager::GetInstance()->RemoveCountdownTimer(m_pArrowButtonUpdate);
+	delete m_pArrowButtonUpdate;
 
 	delete m_pLeftArrowDefault;
 	delete m_pLeftArrowHover;
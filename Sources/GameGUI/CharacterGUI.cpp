@@ -913,17 +913,19 @@ void CharacterGUI::StartEquipHoverAnimation()
 {
 	m_equipHoverXOffset = 0.0f;
 
-	FloatInterpolation* pXPosInterp1;
-	FloatInterpolation* pXPosInterp2;
-	pXPosInterp1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_equipHoverXOffset, m_equipHoverXOffset, m_equipHoverXOffset + 10.0f, 0.5f, 100.0f);
-	pXPosInterp2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_equipHoverXOffset, m_equipHoverXOffset + 10.0f, m_equipHoverXOffset, 0.5f, -100.0f, nullptr, _EquipHoverAnimationFinished, this);
-	Interpolator::GetInstance()->LinkFloatInterpolation(pXPosInterp1, pXPosInterp2);
-	Interpolator::GetInstance()->AddFloatInterpolation(pXPosInterp1);
+	InterpolationHandle xPosInterp1;
+	InterpolationHandle xPosInterp2;
+	xPosInterp1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_equipHoverXOffset, m_equipHoverXOffset, m_equipHoverXOffset + 10.0f, 0.5f, 100.0f);
+	xPosInterp2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_equipHoverXOffset, m_equipHoverXOffset + 10.0f, m_equipHoverXOffset, 0.5f, -100.0f, _EquipHoverAnimationFinished, this);
+	Interpolator::GetInstance()->LinkFloatInterpolation(xPosInterp1, xPosInterp2);
+	Interpolator::GetInstance()->AddFloatInterpolation(xPosInterp1);
+
+	m_equipHoverInterpolation = xPosInterp1;
 }
 
 void CharacterGUI::StopEquipHoverAnimation()
 {
-	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_equipHoverXOffset);
+	Interpolator::GetInstance()->RemoveInterpolation(m_equipHoverInterpolation);
 }
 
 // Tooltips
@@ -16,6 +16,7 @@
 #include <GUI/Icon.h>
 #include <GUI/OpenGLGUI.h>
 #include <Inventory/InventoryManager.h>
+#include <Utils/Interpolator.h>
 
 // Forward declaration
 class FrontendManager;
@@ -235,6 +236,7 @@ private:
 	Icon* m_pEquipHoverIcon;
 	int m_equipHoverXOrigin;
 	float m_equipHoverXOffset;
+	InterpolationHandle m_equipHoverInterpolation;
 
 	// Pressed icons
 	std::vector<CharacterSlotItem*> m_vpInventorySlotItems;
@@ -585,9 +585,9 @@ void HUD::PlayerDied()
 	float deathHeaderDelay = 3.5f;
 	float deathHeaderTimeIn = 0.5f;
 	float deathHeaderWait = 0.5f;
-	FloatInterpolation* deathAlpha1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 0.0f, 0.0f, deathHeaderDelay, 100.0f);
-	FloatInterpolation* deathAlpha2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 0.0f, 1.0f, deathHeaderTimeIn, 100.0f);
-	FloatInterpolation* deathAlpha3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 1.0f, 1.0f, deathHeaderWait, 100.0f, nullptr, _DeathTextFinished, this);
+	InterpolationHandle deathAlpha1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 0.0f, 0.0f, deathHeaderDelay, 100.0f);
+	InterpolationHandle deathAlpha2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 0.0f, 1.0f, deathHeaderTimeIn, 100.0f);
+	InterpolationHandle deathAlpha3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_deathHeaderAlpha, 1.0f, 1.0f, deathHeaderWait, 100.0f, _DeathTextFinished, this);
 	Interpolator::GetInstance()->LinkFloatInterpolation(deathAlpha1, deathAlpha2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(deathAlpha2, deathAlpha3);
 	Interpolator::GetInstance()->AddFloatInterpolation(deathAlpha1);
@@ -615,10 +615,10 @@ void HUD::LevelUp()
 	float levelUpTimeIn = 0.5f;
 	float levelUpWait = 1.5f;
 	float levelUpTimeOut = 0.25f;
-	FloatInterpolation* levelUpAlpha1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 0.0f, 0.0f, levelUpDelay, 100.0f);
-	FloatInterpolation* levelUpAlpha2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 0.0f, 1.0f, levelUpTimeIn, 100.0f);
-	FloatInterpolation* levelUpAlpha3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 1.0f, 1.0f, levelUpWait, 100.0f);
-	FloatInterpolation* levelUpAlpha4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 1.0f, 0.0f, levelUpTimeOut, 100.0f, nullptr, _LevelUpTextFinished, this);
+	InterpolationHandle levelUpAlpha1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 0.0f, 0.0f, levelUpDelay, 100.0f);
+	InterpolationHandle levelUpAlpha2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 0.0f, 1.0f, levelUpTimeIn, 100.0f);
+	InterpolationHandle levelUpAlpha3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 1.0f, 1.0f, levelUpWait, 100.0f);
+	InterpolationHandle levelUpAlpha4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_levelUpAlpha, 1.0f, 0.0f, levelUpTimeOut, 100.0f, _LevelUpTextFinished, this);
 	Interpolator::GetInstance()->LinkFloatInterpolation(levelUpAlpha1, levelUpAlpha2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(levelUpAlpha2, levelUpAlpha3);
 	Interpolator::GetInstance()->LinkFloatInterpolation(levelUpAlpha3, levelUpAlpha4);
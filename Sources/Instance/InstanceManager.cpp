@@ -16,6 +16,7 @@
 #include <algorithm>
 
 #include <Blocks/Chunk.h>
+#include <CubbyGame.h>
 #include <Models/QubicleBinary.h>
 #include <Renderer/Renderer.h>
 
@@ -45,7 +46,7 @@ void InstanceManager::ClearInstanceObjects()
 
 		m_vpInstanceParentList[i]->m_vpInstanceObjectList.clear();
 
-		delete m_vpInstanceParentList[i]->m_pQubicleBinary;
+		CubbyGame::GetInstance()->GetQubicleBinaryManager()->ReleaseQubicleBinaryFile(m_vpInstanceParentList[i]->m_pQubicleBinary);
 
 		delete m_vpInstanceParentList[i];
 		m_vpInstanceParentList[i] = nullptr;
@@ -119,16 +120,15 @@ void InstanceManager::SetupGLBuffers(InstanceParent* pInstanceParent) const
 	pInstanceParent->m_colorBuffer = -1;
 	pInstanceParent->m_matrixBuffer = -1;
 
-	pInstanceParent->m_pQubicleBinary = new QubicleBinary(m_pRenderer);
-	pInstanceParent->m_pQubicleBinary->Import(pInstanceParent->m_modelName.c_str(), true);
+	pInstanceParent->m_pQubicleBinary = CubbyGame::GetInstance()->GetQubicleBinaryManager()->GetQubicleBinaryFile(pInstanceParent->m_modelName.c_str(), false);
 
 	TriangleMesh* pMesh = pInstanceParent->m_pQubicleBinary->GetQubicleMatrix(0)->m_pMesh;
 
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
-	GLint inPosition = glGetAttribLocation(pShader->GetProgramObject(), "in_position");
-	GLint inNormal = glGetAttribLocation(pShader->GetProgramObject(), "in_normal");
-	GLint inColor = glGetAttribLocation(pShader->GetProgramObject(), "in_color");
+	GLint inPosition = pShader->GetAttributeLocation("in_position");
+	GLint inNormal = pShader->GetAttributeLocation("in_normal");
+	GLint inColor = pShader->GetAttributeLocation("in_color");
 
 	glBindFragDataLocation(pShader->GetProgramObject(), 0, "outputColor");
 	glBindFragDataLocation(pShader->GetProgramObject(), 1, "outputPosition");
@@ -234,8 +234,6 @@ InstanceObject* InstanceManager::AddInstanceObject(std::string modelName, glm::v
 		pNewInstanceParent = new InstanceParent();
 
 		pNewInstanceParent->m_modelName = modelName;
-		pNewInstanceParent->m_pQubicleBinary = new QubicleBinary(m_pRenderer);
-		pNewInstanceParent->m_pQubicleBinary->Import(modelName.c_str(), true);
 
 		SetupGLBuffers(pNewInstanceParent);
 
@@ -329,7 +327,7 @@ void InstanceManager::Render()
 {
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
-	GLint inModelMatrix = glGetAttribLocation(pShader->GetProgramObject(), "in_model_matrix");
+	GLint inModelMatrix = pShader->GetAttributeLocation("in_model_matrix");
 
 	for (size_t instanceParentID = 0; instanceParentID < m_vpInstanceParentList.size(); ++instanceParentID)
 	{
@@ -418,16 +416,8 @@ void InstanceManager::Render()
 		// Render the instances
 		m_pRenderer->BeginGLSLShader(m_instanceShader);
 
-		GLint projMatrixLoc = glGetUniformLocation(pShader->GetProgramObject(), "projMatrix");
-		GLint viewMatrixLoc = glGetUniformLocation(pShader->GetProgramObject(), "viewMatrix");
-
-		Matrix4 projMat;
-		Matrix4 viewMat;
-		m_pRenderer->GetProjectionMatrix(&projMat);
-		m_pRenderer->GetModelViewMatrix(&viewMat);
-
-		glUniformMatrix4fv(projMatrixLoc, 1, false, projMat.m_data);
-		glUniformMatrix4fv(viewMatrixLoc, 1, false, viewMat.m_data);
+		// The camera comes from the shared frame uniforms
+		m_pRenderer->UploadFrameUniforms();
 
 		if (m_renderWireFrame)
 		{
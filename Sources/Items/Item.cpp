@@ -13,6 +13,7 @@
 
 #include <algorithm>
 
+#include <Blocks/VoxelCollision.h>
 #include <Lighting/LightingManager.h>
 #include <Maths/3DMaths.h>
 #include <Models/VoxelObject.h>
@@ -194,7 +195,7 @@ void Item::LoadItem(const char* objectFileName)
 	}
 
 	m_pVoxelItem->SetVoxelCharacterParent(nullptr);
-	m_pVoxelItem->LoadWeapon(objectFileName);
+	m_pVoxelItem->LoadWeapon(objectFileName, true, true);
 
 	m_fileName = objectFileName;
 
@@ -274,6 +275,9 @@ glm::vec3 Item::GetPosition() const
 void Item::SetVelocity(glm::vec3 vel)
 {
 	m_velocity = vel;
+
+	// Thrown or knocked items fly at full rate until they settle
+	m_simulationLOD.Wake();
 }
 
 glm::vec3 Item::GetVelocity() const
@@ -460,7 +464,8 @@ void Item::CalculateWorldTransformMatrix()
 {
 	m_worldMatrix.LoadIdentity();
 	m_worldMatrix.SetRotation(DegreeToRadian(m_rotation.x), DegreeToRadian(m_rotation.y), DegreeToRadian(m_rotation.z));
-	m_worldMatrix.SetTranslation(m_position);
+	// Between ticks a reduced item is drawn on its way from the last tick position
+	m_worldMatrix.SetTranslation(m_simulationLOD.GetRenderPosition(m_position));
 
 	for (size_t i = 0; i < m_vpBoundingRegionList.size(); ++i)
 	{
@@ -682,6 +687,12 @@ glm::vec3 Item::GetInteractionPosition() const
 	return GetCenter() + m_interactionPositionOffset;
 }
 
+// Simulation LOD
+SimulationLOD* Item::GetSimulationLOD()
+{
+	return &m_simulationLOD;
+}
+
 // World collision
 void Item::SetWorldCollide(bool collide)
 {
@@ -690,139 +701,10 @@ void Item::SetWorldCollide(bool collide)
 
 bool Item::CheckCollisions(glm::vec3 positionCheck, glm::vec3 previousPosition, glm::vec3* pNormal, glm::vec3* pMovement) const
 {
-	float radius = GetRadius();
-
-	glm::vec3 movementCache = *pMovement;
-
 	// World collisions
-	bool worldCollision = false;
-
-	glm::vec3 floorPosition;
-
-	if (m_pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
-	{
-		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-		return true;
-	}
-
-	int blockX, blockY, blockZ;
-	glm::vec3 blockPos;
-	int numChecks = 1 + static_cast<int>(radius / (Chunk::BLOCK_RENDER_SIZE * 2.0f));
-
-	for (int x = -numChecks; x <= numChecks; x++)
-	{
-		for (int y = -numChecks; y <= numChecks; y++)
-		{
-			for (int z = -numChecks; z <= numChecks; z++)
-			{
-				*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-				Chunk* pChunk = GetCachedGridChunkOrFromPosition(positionCheck + glm::vec3(Chunk::BLOCK_RENDER_SIZE * 2.0f * x, Chunk::BLOCK_RENDER_SIZE * 2.0f * y, Chunk::BLOCK_RENDER_SIZE * 2.0f * z));
-				bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(positionCheck.x + (Chunk::BLOCK_RENDER_SIZE * 2.0f * x), positionCheck.y + (Chunk::BLOCK_RENDER_SIZE * 2.0f * y), positionCheck.z + (Chunk::BLOCK_RENDER_SIZE * 2.0f * z), &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-
-				if (active == false)
-				{
-					if (pChunk == nullptr || pChunk->IsSetup() == false)
-					{
-						*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-						worldCollision = false;
-					}
-				}
-				else if (active == true)
-				{
-					Plane3D planes[6];
-					planes[0] = Plane3D(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[1] = Plane3D(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[2] = Plane3D(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[3] = Plane3D(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[4] = Plane3D(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
-					planes[5] = Plane3D(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
-
-					float distance;
-					int inside = 0;
-					bool insideCache[6];
-
-					for (int i = 0; i < 6; i++)
-					{
-						glm::vec3 pointToCheck = blockPos - previousPosition;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-							insideCache[i] = false;
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							insideCache[i] = true;
-						}
-						else
-						{
-							// Inside...
-							insideCache[i] = true;
-						}
-					}
-
-					for (int i = 0; i < 6; i++)
-					{
-						glm::vec3 pointToCheck = blockPos - positionCheck;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-						else
-						{
-							// Inside...
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-					}
-
-					if (inside == 6)
-					{
-						if (length(*pNormal) <= 1.0f)
-						{
-							if (length(*pNormal) > 0.0f)
-							{
-								*pNormal = normalize(*pNormal);
-							}
-
-							float dotResult = dot(*pNormal, *pMovement);
-							*pNormal *= dotResult;
+	VoxelCollision voxelCollision(m_pChunkManager);
 
-							*pMovement -= *pNormal;
-
-							worldCollision = true;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	if (worldCollision)
-	{
-		return true;
-	}
-
-	*pMovement = movementCache;
-
-	return false;
+	return voxelCollision.CheckCharacter(positionCheck, previousPosition, GetRadius(), pNormal, pMovement);
 }
 
 // Bounding collision region
@@ -1078,6 +960,8 @@ bool Item::IsInteracting() const
 
 void Item::Interact()
 {
+	m_simulationLOD.Wake();
+
 	m_interactCount++;
 
 	bool isNeedErase = false;
@@ -1128,7 +1012,7 @@ void Item::Interact()
 			delete m_pVoxelItem;
 			m_pVoxelItem = new VoxelWeapon(m_pRenderer, m_pQubicleBinaryManager);
 			m_pVoxelItem->SetVoxelCharacterParent(nullptr);
-			m_pVoxelItem->LoadWeapon(itemFileName, false);
+			m_pVoxelItem->LoadWeapon(itemFileName, false, true);
 		}
 	}
 	else
@@ -1294,11 +1178,6 @@ void Item::Update(float dt)
 		return;
 	}
 
-	if (m_pVoxelItem != nullptr)
-	{
-		m_pVoxelItem->Update(dt);
-	}
-
 	// Update grid position
 	UpdateGridPosition();
 
@@ -1347,6 +1226,19 @@ void Item::Update(float dt)
 	UpdatePhysics(dt);
 }
 
+void Item::UpdateAnimation(float dt) const
+{
+	if (m_erase)
+	{
+		return;
+	}
+
+	if (m_pVoxelItem != nullptr)
+	{
+		m_pVoxelItem->Update(dt);
+	}
+}
+
 void Item::UpdatePhysics(float dt)
 {
 	glm::vec3 acceleration = (m_gravityDirection * 9.81f) * 4.0f;
@@ -1474,7 +1366,7 @@ void Item::UpdatePlayerMagnet()
 			{
 				if (m_disappearAnimationStarted == false)
 				{
-					Interpolator::GetInstance()->AddFloatInterpolation(&m_disappearScale, m_disappearScale, 0.0f, 0.5f, -100.0f, nullptr, _PickupAnimationFinished, this);
+					Interpolator::GetInstance()->AddFloatInterpolation(&m_disappearScale, m_disappearScale, 0.0f, 0.5f, -100.0f, _PickupAnimationFinished, this);
 
 					m_disappearAnimationStarted = true;
 				}
@@ -1588,7 +1480,7 @@ void Item::UpdateItemLights() const
 				lightPos = rotationMatrix * lightPos;
 
 				// Translate to position
-				lightPos += m_position;
+				lightPos += m_simulationLOD.GetRenderPosition(m_position);
 			}
 
 			m_pLightingManager->UpdateLightPosition(lightID, lightPos);
@@ -1639,7 +1531,7 @@ void Item::UpdateItemParticleEffects() const
 				particleEffectPos = rotationMatrix * particleEffectPos;
 
 				// Translate to position
-				particleEffectPos += m_position;
+				particleEffectPos += m_simulationLOD.GetRenderPosition(m_position);
 			}
 
 			m_pBlockParticleManager->UpdateParticleEffectPosition(particleEffectID, particleEffectPos, particleEffectPos);
@@ -1648,7 +1540,7 @@ void Item::UpdateItemParticleEffects() const
 }
 
 // Rendering
-void Item::Render(bool outline, bool reflection, bool silhouette) const
+void Item::Render(bool outline, bool reflection, bool silhouette, int lodLevel) const
 {
 	if (m_erase == true)
 	{
@@ -1667,7 +1559,7 @@ void Item::Render(bool outline, bool reflection, bool silhouette) const
 		m_pRenderer->PushMatrix();
 		m_pRenderer->MultiplyWorldMatrix(m_worldMatrix);
 		m_pRenderer->ScaleWorldMatrix(m_renderScale, m_renderScale, m_renderScale);
-		m_pVoxelItem->Render(outline, reflection, silhouette, OutlineColor);
+		m_pVoxelItem->Render(outline, reflection, silhouette, OutlineColor, lodLevel);
 		m_pRenderer->PopMatrix();
 	}
 }
@@ -19,6 +19,7 @@
 #include <Maths/BoundingRegion.h>
 #include <Models/VoxelWeapon.h>
 #include <Particles/BlockParticleManager.h>
+#include <Utils/SimulationLOD.h>
 
 #include "ItemsEnum.h"
 #include "EquipmentEnum.h"
@@ -144,6 +145,9 @@ public:
 	void SetInteractionPositionOffset(glm::vec3 offset);
 	glm::vec3 GetInteractionPosition() const;
 
+	// Simulation LOD
+	SimulationLOD* GetSimulationLOD();
+
 	// World collision
 	void SetWorldCollide(bool collide);
 	bool CheckCollisions(glm::vec3 positionCheck, glm::vec3 previousPosition, glm::vec3* pNormal, glm::vec3* pMovement) const;
@@ -175,6 +179,8 @@ public:
 
 	// Update
 	void Update(float dt);
+	// Every frame, whether or not the item ticked, so it animates smoothly at any simulation tier
+	void UpdateAnimation(float dt) const;
 	void UpdatePhysics(float dt);
 	void UpdateTimers(float dt);
 	void UpdatePlayerMagnet();
@@ -182,7 +188,7 @@ public:
 	void UpdateItemParticleEffects() const;
 
 	// Rendering
-	void Render(bool outline, bool reflection, bool silhouette) const;
+	void Render(bool outline, bool reflection, bool silhouette, int lodLevel = 0) const;
 	void RenderDebug();
 	void RenderCollisionRegions();
 
@@ -260,6 +266,9 @@ private:
 	// Interaction position
 	glm::vec3 m_interactionPositionOffset;
 
+	// How often the item manager ticks us
+	SimulationLOD m_simulationLOD;
+
 	// Pickup animation variables
 	bool m_itemPickup;
 	glm::vec3 m_pickupPos;
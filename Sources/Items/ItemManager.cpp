@@ -12,8 +12,11 @@
 *************************************************************************/
 
 #include <algorithm>
+#include <limits>
 
+#include <Utils/PerformanceTimer.h>
 #include <Utils/Random.h>
+#include <Utils/SpatialGrid.h>
 
 #include "ItemManager.h"
 #include <CubbyGame.h>
@@ -26,7 +29,7 @@ float ItemManager::ITEM_INTERACTION_RADIUS_CHECK = 0.75f;
 ItemManager::ItemManager(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer) :
 	m_pRenderer(pRenderer), m_pChunkManager(pChunkManager), m_pLightingManager(nullptr),
 	m_pBlockParticleManager(nullptr), m_pPlayer(pPlayer),
-	m_pQubicleBinaryManager(nullptr), m_pInventoryManager(nullptr),
+	m_pQubicleBinaryManager(nullptr), m_pInventoryManager(nullptr), m_pNPCManager(nullptr), m_pSpatialGrid(nullptr),
 	m_numRenderItems(0)
 {
 	// Chest
@@ -96,11 +99,18 @@ void ItemManager::SetNPCManager(NPCManager* pNPCManager)
 	m_pNPCManager = pNPCManager;
 }
 
+void ItemManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
 // Deletion
 void ItemManager::ClearItems()
 {
 	for (size_t i = 0; i < m_vpItemList.size(); ++i)
 	{
+		m_pSpatialGrid->Remove(m_vpItemList[i]);
+
 		delete m_vpItemList[i];
 		m_vpItemList[i] = nullptr;
 	}
@@ -273,23 +283,23 @@ int ItemManager::GetNumRenderItems() const
 // Collision detection
 bool ItemManager::CheckCollisions(glm::vec3 center, glm::vec3 previousCenter, float radius, glm::vec3* pNormal, glm::vec3* pMovement)
 {
+	std::vector<void*> vpNearbyItems;
+	m_pSpatialGrid->QueryRadius(m_pPlayer->GetCenter(), radius, SpatialGrid::GetTypeBit(SpatialType::Item), &vpNearbyItems);
+
 	bool colliding = false;
-	for (size_t i = 0; i < m_vpItemList.size() && colliding == false; ++i)
+	for (size_t i = 0; i < vpNearbyItems.size() && colliding == false; ++i)
 	{
-		//if(m_pChunkManager->IsInsideLoader(m_vpItemList[i]->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		Item* pItem = static_cast<Item*>(vpNearbyItems[i]);
 
-		if (m_vpItemList[i]->IsCollisionEnabled())
+		if (pItem->IsCollisionEnabled())
 		{
-			glm::vec3 toPlayer = m_vpItemList[i]->GetCenter() - m_pPlayer->GetCenter();
+			glm::vec3 toPlayer = pItem->GetCenter() - m_pPlayer->GetCenter();
 
-			if (length(toPlayer) < radius + m_vpItemList[i]->GetCollisionRadius())
+			if (length(toPlayer) < radius + pItem->GetCollisionRadius())
 			{
-				m_vpItemList[i]->CalculateWorldTransformMatrix();
+				pItem->CalculateWorldTransformMatrix();
 
-				if (m_vpItemList[i]->IsColliding(center, previousCenter, radius, pNormal, pMovement))
+				if (pItem->IsColliding(center, previousCenter, radius, pNormal, pMovement))
 				{
 					colliding = true;
 				}
@@ -384,6 +394,12 @@ void ItemManager::SetWireFrameRender(bool wireframe)
 // Update
 void ItemManager::Update(float dt)
 {
+	// With the simulation LOD off everything is ticked every frame
+	CubbySettings* pSettings = CubbyGame::GetInstance()->GetCubbySettings();
+	float reducedDistance = pSettings->m_simulationLOD ? pSettings->m_simulationLODDistance : std::numeric_limits<float>::max();
+	ChunkManager* pLODChunkManager = pSettings->m_simulationLOD ? m_pChunkManager : nullptr;
+	glm::vec3 playerPosition = m_pPlayer->GetCenter();
+
 	// Update all item spawners
 	for (size_t i = 0; i < m_vpItemSpawnerList.size(); ++i)
 	{
@@ -394,20 +410,33 @@ void ItemManager::Update(float dt)
 			pItemSpawner->SetPosition(m_pPlayer->GetCenter() + pItemSpawner->GetInitialPosition());
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pItemSpawner->GetPosition()) == false)
-		//{
-		//	continue;
-		//}
+		SimulationLOD* pSimulationLOD = pItemSpawner->GetSimulationLOD();
+		pSimulationLOD->Update(dt, pItemSpawner->GetPosition(), playerPosition, reducedDistance, pLODChunkManager);
+
+		if (pSimulationLOD->IsTicking() == false)
+		{
+			continue;
+		}
 
-		pItemSpawner->Update(dt);
+		pItemSpawner->Update(pSimulationLOD->GetTickDeltaTime());
 	}
 
 	// Remove any items that need to be erased
+	for (size_t i = 0; i < m_vpItemList.size(); ++i)
+	{
+		if (m_vpItemList[i]->IsNeedErase())
+		{
+			m_pSpatialGrid->Remove(m_vpItemList[i]);
+		}
+	}
+
 	m_vpItemList.erase(remove_if(m_vpItemList.begin(), m_vpItemList.end(), IsNeedErasing), m_vpItemList.end());
 
 	UpdateHoverItems();
 
+	// Only the items whose tick came up are simulated, with the time since their last one
+	m_simulationStats.Reset();
+
 	for (size_t i = 0; i < m_vpItemList.size(); ++i)
 	{
 		Item* pItem = m_vpItemList[i];
@@ -417,17 +446,52 @@ void ItemManager::Update(float dt)
 			continue;
 		}
 
-		pItem->Update(dt);
+		SimulationLOD* pSimulationLOD = pItem->GetSimulationLOD();
+		pSimulationLOD->Update(dt, pItem->GetCenter(), playerPosition, reducedDistance, pLODChunkManager);
+
+		int tier = static_cast<int>(pSimulationLOD->GetTier());
+		m_simulationStats.m_numEntities[tier]++;
+
+		if (pSimulationLOD->IsAnimating() == false)
+		{
+			continue;
+		}
+
+		PerformanceTimer timer;
+
+		if (pSimulationLOD->IsTicking())
+		{
+			if (pSimulationLOD->GetTier() == SimulationTier::Reduced)
+			{
+				m_simulationStats.m_numReducedTicks++;
+			}
+
+			pItem->Update(pSimulationLOD->GetTickDeltaTime());
+			pSimulationLOD->SetTickPosition(pItem->GetPosition());
+
+			m_pSpatialGrid->Update(pItem, SpatialType::Item, pItem->GetCenter(), pItem->GetCollisionRadius());
+		}
+
+		// Animated every frame, the items that didn't tick are drawn between their last two ticks
+		pItem->UpdateAnimation(dt);
+
+		m_simulationStats.m_updateTime[tier] += timer.GetElapsedTime();
 	}
 }
 
+const SimulationStats& ItemManager::GetSimulationStats() const
+{
+	return m_simulationStats;
+}
+
 void ItemManager::UpdateItemLights()
 {
 	for (size_t i = 0; i < m_vpItemList.size(); ++i)
 	{
 		Item* pItem = m_vpItemList[i];
 
-		if (pItem->IsNeedErase())
+		// Parked items leave their lights where they are
+		if (pItem->IsNeedErase() || pItem->GetSimulationLOD()->IsAnimating() == false)
 		{
 			continue;
 		}
@@ -442,7 +506,7 @@ void ItemManager::UpdateItemParticleEffects()
 	{
 		Item* pItem = m_vpItemList[i];
 
-		if (pItem->IsNeedErase())
+		if (pItem->IsNeedErase() || pItem->GetSimulationLOD()->IsAnimating() == false)
 		{
 			continue;
 		}
@@ -540,7 +604,10 @@ void ItemManager::Render(bool outline, bool reflection, bool silhouette, bool sh
 
 		if (shadow || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pItem->GetCenter(), pItem->GetRadius()))
 		{
-			pItem->Render(outline, reflection, silhouette);
+			// Level of detail
+			int lodLevel = QubicleBinary::CalculateLODLevel(toCamera, pItem->GetRadius(), CubbyGame::GetInstance()->GetCubbySettings()->m_lodBias);
+
+			pItem->Render(outline, reflection, silhouette, lodLevel);
 
 			m_numRenderItems++;
 		}
@@ -18,6 +18,7 @@
 
 // Forward declaration
 class LightingManager;
+class SpatialGrid;
 
 using ItemSpawnerList = std::vector<ItemSpawner*>;
 
@@ -65,6 +66,7 @@ public:
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
 	void SetInventoryManager(InventoryManager* pInventoryManager);
 	void SetNPCManager(NPCManager* pNPCManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
 
 	// Deletion
 	void ClearItems();
@@ -102,6 +104,9 @@ public:
 	void UpdateItemParticleEffects();
 	void UpdateHoverItems();
 
+	// Items simulated at each tier last frame
+	const SimulationStats& GetSimulationStats() const;
+
 	// Rendering
 	void Render(bool outline, bool reflection, bool silhouette, bool shadow);
 	void RenderDebug();
@@ -123,12 +128,14 @@ private:
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	InventoryManager* m_pInventoryManager;
 	NPCManager* m_pNPCManager;
+	SpatialGrid* m_pSpatialGrid;
 
 	// Counters
 	int m_numRenderItems;
 
 	// Item list
 	ItemList m_vpItemList;
+	SimulationStats m_simulationStats;
 
 	// Item spawner
 	ItemSpawnerList m_vpItemSpawnerList;
@@ -65,6 +65,11 @@ bool ItemSpawner::ShouldFollowPlayer() const
 	return m_followPlayerIntheWorld;
 }
 
+SimulationLOD* ItemSpawner::GetSimulationLOD()
+{
+	return &m_simulationLOD;
+}
+
 // Spawning params
 void ItemSpawner::SetSpawningParams(float initialSpawnDelay, float spawnTimer, int maxNumItemsActive, glm::vec3 spawnRandomOffset, bool shouldSpawnOnGround, glm::vec3 groundSpawnOffset, bool followPlayerIntheWorld, bool spawnFullLoaderRange, float minDistanceFromPlayer, Biome biomeSpawn, float spawnScale)
 {
@@ -263,13 +268,11 @@ void ItemSpawner::RenderDebug() const
 	m_pRenderer->SetCullMode(CullMode::NOCULL);
 	m_pRenderer->SetLineWidth(1.0f);
 
-	// TODO: Loader culling
-	//if(m_pChunkManager->IsInsideLoader(m_position) == false)
-	//{
-	//	m_pRenderer->ImmediateColorAlpha(0.1f, 0.8f, 0.85f, 1.0f);
-	//}
-
-	if (m_spawning && m_canSpawn)
+	if (m_simulationLOD.GetTier() == SimulationTier::Dormant)
+	{
+		m_pRenderer->ImmediateColorAlpha(0.1f, 0.8f, 0.85f, 1.0f);
+	}
+	else if (m_spawning && m_canSpawn)
 	{
 		m_pRenderer->ImmediateColorAlpha(0.1f, 0.8f, 0.05f, 1.0f);
 	}
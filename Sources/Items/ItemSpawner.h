@@ -41,6 +41,7 @@ public:
 	void SetFacingDirection(glm::vec3 dir);
 	glm::vec3 GetFacingDirection() const;
 	bool ShouldFollowPlayer() const;
+	SimulationLOD* GetSimulationLOD();
 
 	// Spawning params
 	void SetSpawningParams(float initialSpawnDelay, float spawnTimer, int maxNumItemsActive, glm::vec3 spawnRandomOffset, bool shouldSpawnOnGround, glm::vec3 groundSpawnOffset, bool followPlayerIntheWorld, bool spawnFullLoaderRange, float minDistanceFromPlayer, Biome biomeSpawn, float spawnScale);
@@ -120,6 +121,9 @@ private:
 
 	// Spawning params
 	float m_spawnCountdownTimer;
+
+	// How often the item manager ticks us
+	SimulationLOD m_simulationLOD;
 };
 
 
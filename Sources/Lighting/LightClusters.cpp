@@ -0,0 +1,260 @@
+/*************************************************************************
+> File Name: LightClusters.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Splits the view frustum into a grid of clusters and lists the dynamic
+> 	 lights that reach each one, so a single fullscreen pass can light
+> 	 every pixel with only the lights near it.
+> Created Time: 2016/09/16
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "LightClusters.h"
+
+const float LightClusters::NEAR_Z = 0.5f;
+const float LightClusters::FAR_Z = 500.0f;
+
+// Texel layouts of the three buffers, in the order they are bound
+static const GLenum BUFFER_FORMATS[3] = { GL_RGBA32F_ARB, GL_RG32UI, GL_R32UI };
+
+// Constructor, Destructor
+LightClusters::LightClusters() :
+	m_numLights(0), m_numOccupiedClusters(0)
+{
+	m_clusterData.resize(NUM_CLUSTERS * 2, 0);
+	m_clusterLights.resize(NUM_CLUSTERS);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		m_buffers[i] = 0;
+		m_textures[i] = 0;
+	}
+}
+
+LightClusters::~LightClusters()
+{
+	if (m_textures[0] != 0)
+	{
+		glDeleteTextures(3, m_textures);
+		glDeleteBuffers(3, m_buffers);
+	}
+}
+
+bool LightClusters::IsSupported()
+{
+	return GLEW_ARB_texture_buffer_object && GLEW_EXT_gpu_shader4 && GLEW_ARB_texture_rg;
+}
+
+void LightClusters::Build(const std::vector<DynamicLight*>& vpLights, const Matrix4& viewMatrix, const Matrix4& projectionMatrix)
+{
+	for (int i = 0; i < NUM_CLUSTERS; ++i)
+	{
+		m_clusterLights[i].clear();
+	}
+
+	m_lightData.clear();
+	m_numLights = 0;
+
+	for (size_t i = 0; i < vpLights.size(); ++i)
+	{
+		DynamicLight* pLight = vpLights[i];
+
+		float radius = pLight->GetRadius();
+		if (radius <= 0.0f)
+		{
+			continue;
+		}
+
+		// Lit around the same point the light volumes are drawn at, half a block up
+		glm::vec3 viewPosition;
+		Matrix4::Multiply(viewMatrix, pLight->GetPosition() + glm::vec3(0.0f, 0.5f, 0.0f), viewPosition);
+
+		// Behind the camera, or past everything the clusters cover
+		if (-viewPosition.z + radius < 0.0f || -viewPosition.z - radius > FAR_Z)
+		{
+			continue;
+		}
+
+		float diffuseScale = pLight->GetDiffuseScale();
+		Color color = pLight->GetColor();
+
+		float lightData[8] = {
+			viewPosition.x, viewPosition.y, viewPosition.z, radius,
+			color.GetRed() * diffuseScale, color.GetGreen() * diffuseScale, color.GetBlue() * diffuseScale, color.GetAlpha() * diffuseScale
+		};
+		m_lightData.insert(m_lightData.end(), lightData, lightData + 8);
+
+		AssignLight(m_numLights, viewPosition, radius, projectionMatrix);
+
+		m_numLights++;
+	}
+
+	// Flatten the per cluster lists into one index list
+	m_lightIndices.clear();
+	m_numOccupiedClusters = 0;
+
+	for (int i = 0; i < NUM_CLUSTERS; ++i)
+	{
+		const std::vector<unsigned int>& clusterLights = m_clusterLights[i];
+
+		m_clusterData[i * 2] = static_cast<unsigned int>(m_lightIndices.size());
+		m_clusterData[i * 2 + 1] = static_cast<unsigned int>(clusterLights.size());
+
+		if (clusterLights.empty() == false)
+		{
+			m_lightIndices.insert(m_lightIndices.end(), clusterLights.begin(), clusterLights.end());
+			m_numOccupiedClusters++;
+		}
+	}
+}
+
+void LightClusters::Upload()
+{
+	if (m_textures[0] == 0)
+	{
+		glGenBuffers(3, m_buffers);
+		glGenTextures(3, m_textures);
+	}
+
+	// Empty buffers still need a texel, so the shader always has something bound
+	static const float emptyLightData[8] = { 0.0f };
+	static const unsigned int emptyLightIndex = 0;
+
+	const void* pData[3] = {
+		m_lightData.empty() ? emptyLightData : &m_lightData[0],
+		&m_clusterData[0],
+		m_lightIndices.empty() ? &emptyLightIndex : &m_lightIndices[0]
+	};
+	size_t dataSize[3] = {
+		m_lightData.empty() ? sizeof(emptyLightData) : m_lightData.size() * sizeof(float),
+		m_clusterData.size() * sizeof(unsigned int),
+		m_lightIndices.empty() ? sizeof(emptyLightIndex) : m_lightIndices.size() * sizeof(unsigned int)
+	};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER_ARB, m_buffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER_ARB, dataSize[i], pData[i], GL_STREAM_DRAW);
+
+		glBindTexture(GL_TEXTURE_BUFFER_ARB, m_textures[i]);
+		glTexBufferARB(GL_TEXTURE_BUFFER_ARB, BUFFER_FORMATS[i], m_buffers[i]);
+	}
+
+	glBindTexture(GL_TEXTURE_BUFFER_ARB, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER_ARB, 0);
+}
+
+void LightClusters::Bind(unsigned int firstTextureIndex) const
+{
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		glActiveTextureARB(GL_TEXTURE0_ARB + firstTextureIndex + i);
+		glBindTexture(GL_TEXTURE_BUFFER_ARB, m_textures[i]);
+	}
+}
+
+void LightClusters::Unbind(unsigned int firstTextureIndex) const
+{
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		glActiveTextureARB(GL_TEXTURE0_ARB + firstTextureIndex + i);
+		glBindTexture(GL_TEXTURE_BUFFER_ARB, 0);
+	}
+}
+
+int LightClusters::GetNumLights() const
+{
+	return m_numLights;
+}
+
+int LightClusters::GetNumLightIndices() const
+{
+	return static_cast<int>(m_lightIndices.size());
+}
+
+int LightClusters::GetNumOccupiedClusters() const
+{
+	return m_numOccupiedClusters;
+}
+
+int LightClusters::GetDepthSlice(float depth)
+{
+	if (depth <= NEAR_Z)
+	{
+		return 0;
+	}
+
+	// Slices get deeper with distance, so near clusters stay small on screen
+	int slice = static_cast<int>(log(depth / NEAR_Z) / log(FAR_Z / NEAR_Z) * GRID_Z);
+
+	return std::min(slice, GRID_Z - 1);
+}
+
+void LightClusters::AssignLight(int lightIndex, const glm::vec3& viewPosition, float radius, const Matrix4& projectionMatrix)
+{
+	// View space looks down -z
+	float minDepth = -viewPosition.z - radius;
+	float maxDepth = -viewPosition.z + radius;
+
+	int minSlice = GetDepthSlice(minDepth);
+	int maxSlice = GetDepthSlice(maxDepth);
+
+	int minTileX = 0;
+	int maxTileX = GRID_X - 1;
+	int minTileY = 0;
+	int maxTileY = GRID_Y - 1;
+
+	// Lights that reach the near plane can cover any part of the screen, otherwise the screen bounds of the sphere's box are used
+	if (minDepth > NEAR_Z)
+	{
+		const float* p = projectionMatrix.m_data;
+
+		float minX = std::numeric_limits<float>::max();
+		float maxX = -std::numeric_limits<float>::max();
+		float minY = std::numeric_limits<float>::max();
+		float maxY = -std::numeric_limits<float>::max();
+
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			float x = viewPosition.x + ((corner & 1) ? radius : -radius);
+			float y = viewPosition.y + ((corner & 2) ? radius : -radius);
+			float z = viewPosition.z + ((corner & 4) ? radius : -radius);
+
+			float clipX = p[0] * x + p[4] * y + p[8] * z + p[12];
+			float clipY = p[1] * x + p[5] * y + p[9] * z + p[13];
+			float clipW = p[3] * x + p[7] * y + p[11] * z + p[15];
+
+			minX = std::min(minX, clipX / clipW);
+			maxX = std::max(maxX, clipX / clipW);
+			minY = std::min(minY, clipY / clipW);
+			maxY = std::max(maxY, clipY / clipW);
+		}
+
+		// Off the side of the screen
+		if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+		{
+			return;
+		}
+
+		minTileX = std::max(0, static_cast<int>((minX + 1.0f) * 0.5f * GRID_X));
+		maxTileX = std::min(GRID_X - 1, static_cast<int>((maxX + 1.0f) * 0.5f * GRID_X));
+		minTileY = std::max(0, static_cast<int>((minY + 1.0f) * 0.5f * GRID_Y));
+		maxTileY = std::min(GRID_Y - 1, static_cast<int>((maxY + 1.0f) * 0.5f * GRID_Y));
+	}
+
+	for (int z = minSlice; z <= maxSlice; ++z)
+	{
+		for (int y = minTileY; y <= maxTileY; ++y)
+		{
+			for (int x = minTileX; x <= maxTileX; ++x)
+			{
+				m_clusterLights[(z * GRID_Y + y) * GRID_X + x].push_back(lightIndex);
+			}
+		}
+	}
+}
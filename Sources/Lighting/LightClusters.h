@@ -0,0 +1,77 @@
+/*************************************************************************
+> File Name: LightClusters.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Splits the view frustum into a grid of clusters and lists the dynamic
+> 	 lights that reach each one, so a single fullscreen pass can light
+> 	 every pixel with only the lights near it.
+> Created Time: 2016/09/16
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_LIGHT_CLUSTERS_H
+#define CUBBY_LIGHT_CLUSTERS_H
+
+#include <GL/glew.h>
+
+#include <Maths/Matrix4.h>
+
+#include <vector>
+
+#include "DynamicLight.h"
+
+class LightClusters
+{
+public:
+	// Constructor, Destructor
+	LightClusters();
+	~LightClusters();
+
+	// Texture buffers are needed to hand the lists to the lighting shader
+	static bool IsSupported();
+
+	// Lights are moved into view space with the view matrix, and sorted into clusters with the projection matrix
+	void Build(const std::vector<DynamicLight*>& vpLights, const Matrix4& viewMatrix, const Matrix4& projectionMatrix);
+	void Upload();
+
+	// Binds the light, cluster and light index buffers to three texture units starting at firstTextureIndex
+	void Bind(unsigned int firstTextureIndex) const;
+	void Unbind(unsigned int firstTextureIndex) const;
+
+	int GetNumLights() const;
+	int GetNumLightIndices() const;
+	int GetNumOccupiedClusters() const;
+
+	// The shader works out clusters the same way, see clustered_lighting.pixel
+	static const int GRID_X = 16;
+	static const int GRID_Y = 9;
+	static const int GRID_Z = 24;
+	static const int NUM_CLUSTERS = GRID_X * GRID_Y * GRID_Z;
+	static const float NEAR_Z;
+	static const float FAR_Z;
+
+	// Slice that a view space depth falls in, depths outside the near and far planes go in the first and last slices
+	static int GetDepthSlice(float depth);
+
+private:
+	void AssignLight(int lightIndex, const glm::vec3& viewPosition, float radius, const Matrix4& projectionMatrix);
+
+	// Per light: view space position and radius, then color already scaled by the light's diffuse scale
+	std::vector<float> m_lightData;
+
+	// Per cluster: offset into m_lightIndices and the number of lights
+	std::vector<unsigned int> m_clusterData;
+	std::vector<unsigned int> m_lightIndices;
+
+	// Scratch lists per cluster, kept between frames to save allocating them again
+	std::vector<std::vector<unsigned int>> m_clusterLights;
+
+	int m_numLights;
+	int m_numOccupiedClusters;
+
+	GLuint m_buffers[3];
+	GLuint m_textures[3];
+};
+
+#endif
@@ -7,20 +7,21 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
-#include <algorithm>
-
 #include "LightingManager.h"
 
 // Constructor, Destructor
 LightingManager::LightingManager(Renderer* pRenderer) :
-	m_pRenderer(pRenderer), m_lightIndexCounter(0)
+	m_pRenderer(pRenderer)
 {
-	
+	m_pLightClusters = new LightClusters();
 }
 
 LightingManager::~LightingManager()
 {
 	ClearLights();
+
+	delete m_pLightClusters;
+	m_pLightClusters = nullptr;
 }
 
 // Getter
@@ -36,16 +37,24 @@ DynamicLight* LightingManager::GetLight(int index)
 	return pLight;
 }
 
+DynamicLight* LightingManager::GetLightFromID(unsigned int lightID)
+{
+	int index = GetLightIndex(lightID);
+	if (index == -1)
+	{
+		return nullptr;
+	}
+
+	return m_vpDynamicLightList[index];
+}
+
 // Clean-up
 void LightingManager::ClearLights()
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	while (m_vpDynamicLightList.empty() == false)
 	{
-		delete m_vpDynamicLightList[i];
-		m_vpDynamicLightList[i] = nullptr;
+		RemoveLightAtIndex(static_cast<int>(m_vpDynamicLightList.size()) - 1);
 	}
-
-	m_vpDynamicLightList.clear();
 }
 
 // Add & Remove light
@@ -57,13 +66,8 @@ void LightingManager::AddLight(glm::vec3 position, float radius, float diffuseMo
 	pNewLight->SetRadius(radius);
 	pNewLight->SetDiffuseScale(diffuseModifier);
 	pNewLight->SetColor(color);
-	pNewLight->SetLightID(m_lightIndexCounter);
 
-	*pID = m_lightIndexCounter;
-
-	m_lightIndexCounter++;
-
-	m_vpDynamicLightList.push_back(pNewLight);
+	*pID = InsertLight(pNewLight);
 }
 
 void LightingManager::AddDyingLight(glm::vec3 position, float radius, float diffuseModifier, Color color, float lifeTime, unsigned int* pID)
@@ -74,128 +78,82 @@ void LightingManager::AddDyingLight(glm::vec3 position, float radius, float diff
 	pNewLight->SetRadius(radius);
 	pNewLight->SetDiffuseScale(diffuseModifier);
 	pNewLight->SetColor(color);
-	pNewLight->SetLightID(m_lightIndexCounter);
 
 	pNewLight->SetLifeTime(lifeTime);
 	pNewLight->SetMaxLifeTime(lifeTime);
 	pNewLight->SetDyingLight(true);
 	
-	*pID = m_lightIndexCounter;
-
-	m_lightIndexCounter++;
-
-	m_vpDynamicLightList.push_back(pNewLight);
+	*pID = InsertLight(pNewLight);
 }
 
 void LightingManager::RemoveLight(unsigned int lightID)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	int index = GetLightIndex(lightID);
+	if (index != -1)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetErase(true);
-		}
+		RemoveLightAtIndex(index);
 	}
-
-	// Remove any lights that need to be erased
-	m_vpDynamicLightList.erase(remove_if(m_vpDynamicLightList.begin(), m_vpDynamicLightList.end(),
-		[](DynamicLight* light)
-	{
-		bool isNeedErase = light->IsNeedErasing();
-
-		if (isNeedErase)
-		{
-			delete light;
-		}
-
-		return isNeedErase;
-	}), m_vpDynamicLightList.end());
 }
 
 // Updates
 void LightingManager::UpdateLight(unsigned int lightID, glm::vec3 position, float radius, float diffuseModifier, Color color)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	DynamicLight* pLight = GetLightFromID(lightID);
+	if (pLight != nullptr)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetPosition(position);
-			m_vpDynamicLightList[i]->SetRadius(radius);
-			m_vpDynamicLightList[i]->SetDiffuseScale(diffuseModifier);
-			m_vpDynamicLightList[i]->SetColor(color);
-
-			return;
-		}
+		pLight->SetPosition(position);
+		pLight->SetRadius(radius);
+		pLight->SetDiffuseScale(diffuseModifier);
+		pLight->SetColor(color);
 	}
 }
 
 void LightingManager::UpdateLightRadius(unsigned int lightID, float radius)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	DynamicLight* pLight = GetLightFromID(lightID);
+	if (pLight != nullptr)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetRadius(radius);
-
-			return;
-		}
+		pLight->SetRadius(radius);
 	}
 }
 
 void LightingManager::UpdateLightDiffuseMultiplier(unsigned int lightID, float diffuseMultiplier)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	DynamicLight* pLight = GetLightFromID(lightID);
+	if (pLight != nullptr)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetDiffuseScale(diffuseMultiplier);
-
-			return;
-		}
+		pLight->SetDiffuseScale(diffuseMultiplier);
 	}
 }
 
 void LightingManager::UpdateLightPosition(unsigned int lightID, glm::vec3 position)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	DynamicLight* pLight = GetLightFromID(lightID);
+	if (pLight != nullptr)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetPosition(position);
-
-			return;
-		}
+		pLight->SetPosition(position);
 	}
 }
 
 void LightingManager::UpdateLightColor(unsigned int lightID, Color color)
 {
-	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
+	DynamicLight* pLight = GetLightFromID(lightID);
+	if (pLight != nullptr)
 	{
-		if (m_vpDynamicLightList[i]->GetLightID() == lightID)
-		{
-			m_vpDynamicLightList[i]->SetColor(color);
-
-			return;
-		}
+		pLight->SetColor(color);
 	}
 }
 
 void LightingManager::Update(float dt)
 {
-	// Remove any lights that need to be erased
-	m_vpDynamicLightList.erase(remove_if(m_vpDynamicLightList.begin(), m_vpDynamicLightList.end(),
-		[](DynamicLight* light)
+	// Remove any lights that need to be erased, backwards since the last light is moved into the gap
+	for (int i = static_cast<int>(m_vpDynamicLightList.size()) - 1; i >= 0; --i)
+	{
+		if (m_vpDynamicLightList[i]->IsNeedErasing())
 		{
-			bool isNeedErase = light->IsNeedErasing();
-
-			if (isNeedErase)
-			{
-				delete light;
-			}
-
-			return isNeedErase;
-		}), m_vpDynamicLightList.end());
+			RemoveLightAtIndex(i);
+		}
+	}
 
 	for (size_t i = 0; i < m_vpDynamicLightList.size(); ++i)
 	{
@@ -203,6 +161,18 @@ void LightingManager::Update(float dt)
 	}
 }
 
+// Light clusters
+void LightingManager::BuildLightClusters(const Matrix4& viewMatrix, const Matrix4& projectionMatrix)
+{
+	m_pLightClusters->Build(m_vpDynamicLightList, viewMatrix, projectionMatrix);
+	m_pLightClusters->Upload();
+}
+
+const LightClusters* LightingManager::GetLightClusters() const
+{
+	return m_pLightClusters;
+}
+
 // Debug
 void LightingManager::DebugRender()
 {
@@ -226,4 +196,71 @@ void LightingManager::DebugRender()
 		m_pRenderer->DrawSphere(lightRadius, 30, 30);
 		m_pRenderer->PopMatrix();
 	}
-}
\ No newline at end of file
+}
+
+unsigned int LightingManager::InsertLight(DynamicLight* pLight)
+{
+	unsigned int slot;
+	if (m_freeLightSlots.empty() == false)
+	{
+		slot = m_freeLightSlots.back();
+		m_freeLightSlots.pop_back();
+	}
+	else
+	{
+		DynamicLightSlot newSlot;
+		newSlot.m_lightIndex = -1;
+		newSlot.m_generation = 0;
+
+		slot = static_cast<unsigned int>(m_lightSlots.size());
+		m_lightSlots.push_back(newSlot);
+	}
+
+	m_lightSlots[slot].m_lightIndex = static_cast<int>(m_vpDynamicLightList.size());
+	m_vpDynamicLightList.push_back(pLight);
+
+	unsigned int lightID = (m_lightSlots[slot].m_generation << LIGHT_SLOT_BITS) | slot;
+	pLight->SetLightID(lightID);
+
+	return lightID;
+}
+
+void LightingManager::RemoveLightAtIndex(int index)
+{
+	DynamicLight* pLight = m_vpDynamicLightList[index];
+	unsigned int slot = pLight->GetLightID() & LIGHT_SLOT_MASK;
+
+	// Old IDs for this slot stop matching once the generation moves on
+	m_lightSlots[slot].m_lightIndex = -1;
+	m_lightSlots[slot].m_generation = (m_lightSlots[slot].m_generation + 1) & (0xFFFFFFFF >> LIGHT_SLOT_BITS);
+	m_freeLightSlots.push_back(slot);
+
+	delete pLight;
+
+	// Fill the gap with the last light
+	int lastIndex = static_cast<int>(m_vpDynamicLightList.size()) - 1;
+	if (index != lastIndex)
+	{
+		m_vpDynamicLightList[index] = m_vpDynamicLightList[lastIndex];
+		m_lightSlots[m_vpDynamicLightList[index]->GetLightID() & LIGHT_SLOT_MASK].m_lightIndex = index;
+	}
+
+	m_vpDynamicLightList.pop_back();
+}
+
+int LightingManager::GetLightIndex(unsigned int lightID) const
+{
+	unsigned int slot = lightID & LIGHT_SLOT_MASK;
+	if (slot >= m_lightSlots.size())
+	{
+		return -1;
+	}
+
+	const DynamicLightSlot& lightSlot = m_lightSlots[slot];
+	if (lightSlot.m_lightIndex == -1 || (lightSlot.m_generation << LIGHT_SLOT_BITS) != (lightID & ~LIGHT_SLOT_MASK))
+	{
+		return -1;
+	}
+
+	return lightSlot.m_lightIndex;
+}
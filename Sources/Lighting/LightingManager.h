@@ -13,10 +13,18 @@
 #include <vector>
 
 #include "DynamicLight.h"
+#include "LightClusters.h"
 #include "Renderer/Renderer.h"
 
 using DynamicLightList = std::vector<DynamicLight*>;
 
+// Light IDs are a slot in the low bits and the slot's generation in the high bits, so IDs of removed lights never find the light that reuses their slot
+struct DynamicLightSlot
+{
+	int m_lightIndex;
+	unsigned int m_generation;
+};
+
 class LightingManager
 {
 public:
@@ -24,9 +32,10 @@ public:
 	LightingManager(Renderer* pRenderer);
 	~LightingManager();
 
-	// Getter
+	// Getter, index is 0 to GetNumLights() - 1 and changes as lights are removed, use the ID to keep hold of a light
 	int GetNumLights() const;
 	DynamicLight* GetLight(int index);
+	DynamicLight* GetLightFromID(unsigned int lightID);
 
 	// Clean-up
 	void ClearLights();
@@ -45,15 +54,32 @@ public:
 
 	void Update(float dt);
 
+	// Light clusters, for lighting every light in one pass
+	void BuildLightClusters(const Matrix4& viewMatrix, const Matrix4& projectionMatrix);
+	const LightClusters* GetLightClusters() const;
+
 	// Debug
 	void DebugRender();
 
+	static const unsigned int LIGHT_SLOT_BITS = 20;
+	static const unsigned int LIGHT_SLOT_MASK = (1 << LIGHT_SLOT_BITS) - 1;
+
 private:
+	// Returns the new light's ID
+	unsigned int InsertLight(DynamicLight* pLight);
+	void RemoveLightAtIndex(int index);
+
+	// -1 if the ID is stale or was never given out
+	int GetLightIndex(unsigned int lightID) const;
+
 	Renderer* m_pRenderer;
 
+	// Packed, so lights can be iterated without gaps, m_lightSlots takes an ID to its index in here
 	DynamicLightList m_vpDynamicLightList;
+	std::vector<DynamicLightSlot> m_lightSlots;
+	std::vector<unsigned int> m_freeLightSlots;
 
-	unsigned int m_lightIndexCounter;
+	LightClusters* m_pLightClusters;
 };
 
 #endif
\ No newline at end of file
@@ -7,24 +7,30 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <algorithm>
 #include <fstream>
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <Utils/AssetPack.h>
+
 #include "MS3DAnimator.h"
+#include "MS3DAnimatorBatch.h"
+#include "MS3DModelManager.h"
 
 // Constructor, Destructor
 MS3DAnimator::MS3DAnimator(Renderer* pRenderer, MS3DModel* pModel) :
 	m_pRenderer(pRenderer), m_pModel(pModel),
 	m_numJointAnimations(0), m_pJointAnimations(nullptr),
-	m_numAnimations(0), m_pAnimations(nullptr),
+	m_pAnimationList(nullptr), m_numAnimations(0), m_pAnimations(nullptr),
 	m_currentAnimationIndex(0), m_currentAnimationStartTime(0.0), m_currentAnimationEndTime(0.0),
 	m_currentAnimationLeftWeaponTrailStartTime(0.0), m_currentAnimationLeftWeaponTrailEndTime(0.0),
 	m_currentAnimationRightWeaponTrailStartTime(0.0), m_currentAnimationRightWeaponTrailEndTime(0.0),
 	m_timer(0.0), m_isLooping(false), m_isPaused(false), m_isLooped(false), m_isFinished(false),
 	m_isBlending(false), m_blendTime(0.0f), m_blendTimer(0.0f),
-	m_blendStartAnimationIndex(0), m_blendEndAnimationIndex(0)
+	m_blendStartAnimationIndex(0), m_blendEndAnimationIndex(0),
+	m_isPoseDirty(false), m_isPoseBlended(false), m_isPoseQueued(false), m_isBoundingBoxDirty(false)
 {
 	// Once we have some model data, create out joint animations
 	CreateJointAnimations();
@@ -35,6 +41,11 @@ MS3DAnimator::MS3DAnimator(Renderer* pRenderer, MS3DModel* pModel) :
 
 MS3DAnimator::~MS3DAnimator()
 {
+	if (m_isPoseQueued)
+	{
+		MS3DAnimatorBatch::GetInstance()->RemoveAnimator(this);
+	}
+
 	m_numJointAnimations = 0;
 	if (m_pJointAnimations != nullptr)
 	{
@@ -43,10 +54,11 @@ MS3DAnimator::~MS3DAnimator()
 	}
 
 	m_numAnimations = 0;
-	if (m_pAnimations != nullptr)
+	m_pAnimations = nullptr;
+	if (m_pAnimationList != nullptr)
 	{
-		delete[] m_pAnimations;
-		m_pAnimations = nullptr;
+		MS3DModelManager::GetInstance()->ReleaseAnimationList(m_pAnimationList);
+		m_pAnimationList = nullptr;
 	}
 }
 
@@ -70,63 +82,81 @@ void MS3DAnimator::CreateJointAnimations()
 	}
 }
 
-bool MS3DAnimator::LoadAnimations(const char *animationFileName)
+bool MS3DAnimator::LoadAnimations(const char* animationFileName)
 {
-	std::ifstream file;
+	AnimationList* pAnimationList = MS3DModelManager::GetInstance()->GetAnimationList(animationFileName, m_pModel);
+
+	if (pAnimationList == nullptr)
+	{
+		return false;
+	}
+
+	if (m_pAnimationList != nullptr)
+	{
+		MS3DModelManager::GetInstance()->ReleaseAnimationList(m_pAnimationList);
+	}
+
+	m_pAnimationList = pAnimationList;
+	m_numAnimations = pAnimationList->m_numAnimations;
+	m_pAnimations = pAnimationList->m_pAnimations;
+
+	return true;
+}
 
-	// Open the file
-	file.open(animationFileName, std::ios::in);
-	if (file.is_open())
+bool MS3DAnimator::ParseAnimations(const char* animationFileName, float animationFPS, int* numAnimations, Animation** pAnimations)
+{
+	// Open the file, from the asset pack if it is packed
+	std::istringstream file;
+	if (AssetPack::GetInstance()->OpenFile(animationFileName, &file))
 	{
 		std::string tempString;
 
 		// Read in the number of animations
-		file >> tempString >> m_numAnimations;
+		file >> tempString >> *numAnimations;
 
 		// Create the animation storage space
-		m_pAnimations = new Animation[m_numAnimations];
+		Animation* pNewAnimations = new Animation[*numAnimations];
 
 		// Read in each animation
-		for (int i = 0; i < m_numAnimations; ++i)
+		for (int i = 0; i < *numAnimations; ++i)
 		{
 			// Animation name
-			file >> tempString >> m_pAnimations[i].animationName;
+			file >> tempString >> pNewAnimations[i].animationName;
 
 			// Looping
-			file >> tempString >> m_pAnimations[i].looping;
+			file >> tempString >> pNewAnimations[i].looping;
 
 			// Start frame
-			file >> tempString >> m_pAnimations[i].startFrame;
+			file >> tempString >> pNewAnimations[i].startFrame;
 
 			// End frame
-			file >> tempString >> m_pAnimations[i].endFrame;
+			file >> tempString >> pNewAnimations[i].endFrame;
 
 			// Blend frame
-			file >> tempString >> m_pAnimations[i].blendFrame;
+			file >> tempString >> pNewAnimations[i].blendFrame;
 
 			// Start right weapon trail
-			file >> tempString >> m_pAnimations[i].startRightWeaponTrailFrame;
+			file >> tempString >> pNewAnimations[i].startRightWeaponTrailFrame;
 
 			// End right weapon trail
-			file >> tempString >> m_pAnimations[i].endRightWeaponTrailFrame;
+			file >> tempString >> pNewAnimations[i].endRightWeaponTrailFrame;
 
 			// Start left weapon trail
-			file >> tempString >> m_pAnimations[i].startLeftWeaponTrailFrame;
+			file >> tempString >> pNewAnimations[i].startLeftWeaponTrailFrame;
 
 			// End left weapon trail
-			file >> tempString >> m_pAnimations[i].endLeftWeaponTrailFrame;
+			file >> tempString >> pNewAnimations[i].endLeftWeaponTrailFrame;
 
 			// Work out the start time and end time
-			m_pAnimations[i].startTime = m_pAnimations[i].startFrame * 1000.0 / m_pModel->m_animationFPS;
-			m_pAnimations[i].endTime = m_pAnimations[i].endFrame * 1000.0 / m_pModel->m_animationFPS;
-			m_pAnimations[i].startRightWeaponTrailTime = m_pAnimations[i].startRightWeaponTrailFrame * 1000.0 / m_pModel->m_animationFPS;
-			m_pAnimations[i].endRightWeaponTrailTime = m_pAnimations[i].endRightWeaponTrailFrame * 1000.0 / m_pModel->m_animationFPS;
-			m_pAnimations[i].startLeftWeaponTrailTime = m_pAnimations[i].startLeftWeaponTrailFrame * 1000.0 / m_pModel->m_animationFPS;
-			m_pAnimations[i].endLeftWeaponTrailTime = m_pAnimations[i].endLeftWeaponTrailFrame * 1000.0 / m_pModel->m_animationFPS;
+			pNewAnimations[i].startTime = pNewAnimations[i].startFrame * 1000.0 / animationFPS;
+			pNewAnimations[i].endTime = pNewAnimations[i].endFrame * 1000.0 / animationFPS;
+			pNewAnimations[i].startRightWeaponTrailTime = pNewAnimations[i].startRightWeaponTrailFrame * 1000.0 / animationFPS;
+			pNewAnimations[i].endRightWeaponTrailTime = pNewAnimations[i].endRightWeaponTrailFrame * 1000.0 / animationFPS;
+			pNewAnimations[i].startLeftWeaponTrailTime = pNewAnimations[i].startLeftWeaponTrailFrame * 1000.0 / animationFPS;
+			pNewAnimations[i].endLeftWeaponTrailTime = pNewAnimations[i].endLeftWeaponTrailFrame * 1000.0 / animationFPS;
 		}
 
-		// Close the file
-		file.close();
+		*pAnimations = pNewAnimations;
 
 		return true;
 	}
@@ -136,6 +166,8 @@ bool MS3DAnimator::LoadAnimations(const char *animationFileName)
 
 void MS3DAnimator::CalculateBoundingBox()
 {
+	EvaluatePose();
+
 	for (int i = 0; i < m_pModel->m_numVertices; i++)
 	{
 		if (m_pModel->m_pVertices[i].boneID == -1)
@@ -198,10 +230,17 @@ void MS3DAnimator::CalculateBoundingBox()
 			}
 		}
 	}
+
+	m_isBoundingBoxDirty = false;
 }
 
 BoundingBox* MS3DAnimator::GetBoundingBox()
 {
+	if (m_isBoundingBoxDirty)
+	{
+		CalculateBoundingBox();
+	}
+
 	return& m_boundingBox;
 }
 
@@ -335,6 +374,8 @@ int MS3DAnimator::GetEndFrame(const char* animationName) const
 
 int MS3DAnimator::GetCurrentFrame() const
 {
+	EvaluatePose();
+
 	Joint* pJoint = &(m_pModel->m_pJoints[0]);
 	JointAnimation* pJointAnimation = &(m_pJointAnimations[0]);
 
@@ -363,6 +404,9 @@ int MS3DAnimator::GetNumKeyframes() const
 // Blending
 void MS3DAnimator::StartBlendAnimation(int startIndex, int endIndex, float blendTime)
 {
+	// The current blend values come from the pending pose
+	EvaluatePose();
+
 	m_isBlending = true;
 	m_isPaused = false;
 	m_isLooped = false;
@@ -555,6 +599,8 @@ void MS3DAnimator::BlendIntoAnimation(const char* animationName, float blendTime
 
 void MS3DAnimator::GetCurrentBlendTranslation(int jointIndex, float* x, float* y, float* z) const
 {
+	EvaluatePose();
+
 	JointAnimation* pJointAnimation = &(m_pJointAnimations[jointIndex]);
 	*x = pJointAnimation->currentBlendTrans[0];
 	*y = pJointAnimation->currentBlendTrans[1];
@@ -563,6 +609,8 @@ void MS3DAnimator::GetCurrentBlendTranslation(int jointIndex, float* x, float* y
 
 void MS3DAnimator::GetCurrentBlendRotation(int jointIndex, float* x, float* y, float* z) const
 {
+	EvaluatePose();
+
 	JointAnimation* pJointAnimation = &(m_pJointAnimations[jointIndex]);
 	*x = pJointAnimation->currentBlendRot[0];
 	*y = pJointAnimation->currentBlendRot[1];
@@ -581,6 +629,8 @@ bool MS3DAnimator::GetLeftWeaponTrailActive() const
 
 void MS3DAnimator::Restart()
 {
+	EvaluatePose();
+
 	for (int i = 0; i < m_numJointAnimations; ++i)
 	{
 		m_pJointAnimations[i].currentRotationKeyframe = m_pJointAnimations[i].currentTranslationKeyframe = 0;
@@ -591,11 +641,15 @@ void MS3DAnimator::Restart()
 
 void MS3DAnimator::SetTimerForStartOfAnimation()
 {
+	EvaluatePose();
+
 	m_timer = m_pAnimations[m_currentAnimationIndex].startTime;
 }
 
 Matrix4 MS3DAnimator::GetBoneMatrix(int index) const
 {
+	EvaluatePose();
+
 	Matrix4& finalMatrix = m_pJointAnimations[index].finalMatrix;
 
 	return finalMatrix;
@@ -604,9 +658,46 @@ Matrix4 MS3DAnimator::GetBoneMatrix(int index) const
 // Update
 void MS3DAnimator::Update(float dt)
 {
+	AdvanceTimer(dt);
+
+	EvaluatePose();
+}
+
+void MS3DAnimator::UpdateDeferred(float dt)
+{
+	AdvanceTimer(dt);
+
+	// The pose is evaluated together with every other queued animator, or on the first read of a bone before that
+	if (m_isPoseQueued == false)
+	{
+		MS3DAnimatorBatch::GetInstance()->AddAnimator(this);
+	}
+}
+
+void MS3DAnimator::AdvanceTimer(float dt, bool updatePose)
+{
+	// Any pose that was not read since the last update is replaced by this one
+	bool wasPoseDirty = m_isPoseDirty;
+	m_isPoseDirty = false;
+
 	if (m_isBlending)
 	{
-		UpdateBlending(dt);
+		if (!m_isPaused)
+		{
+			m_blendTimer += dt;
+		}
+
+		if (m_blendTimer > m_blendTime)
+		{
+			// Finished blending
+			m_isBlending = false;
+			PlayAnimation(m_blendEndAnimationIndex);
+		}
+
+		// The blend pose is still used for the update that finishes the blend
+		m_isPoseBlended = true;
+		m_isPoseDirty = updatePose || wasPoseDirty;
+
 		return;
 	}
 
@@ -632,13 +723,73 @@ void MS3DAnimator::Update(float dt)
 		}
 	}
 
+	m_isPoseBlended = false;
+	m_isPoseDirty = updatePose || wasPoseDirty;
+}
+
+void MS3DAnimator::EvaluatePose() const
+{
+	if (m_isPoseDirty == false)
+	{
+		return;
+	}
+
+	if (m_isPoseBlended)
+	{
+		EvaluateBlendingPose();
+	}
+	else
+	{
+		EvaluateAnimationPose();
+	}
+
+	m_isPoseDirty = false;
+
+	// The bounding box is only recalculated when it is next asked for
+	m_isBoundingBoxDirty = true;
+}
+
+bool MS3DAnimator::IsPoseDirty() const
+{
+	return m_isPoseDirty;
+}
+
+bool MS3DAnimator::IsPoseQueued() const
+{
+	return m_isPoseQueued;
+}
+
+void MS3DAnimator::SetPoseQueued(bool queued)
+{
+	m_isPoseQueued = queued;
+}
+
+int MS3DAnimator::FindKeyframe(const Keyframe* pKeyframes, int numKeyframes, int frame, double time)
+{
+	// The cursor only moves forward while an animation plays, after a restart jump straight to the start of the animation
+	if (frame == 0 && numKeyframes > 8)
+	{
+		return static_cast<int>(std::lower_bound(pKeyframes, pKeyframes + numKeyframes, time,
+			[](const Keyframe& keyframe, double value) { return keyframe.time < value; }) - pKeyframes);
+	}
+
+	while (frame < numKeyframes && pKeyframes[frame].time < time)
+	{
+		frame++;
+	}
+
+	return frame;
+}
+
+void MS3DAnimator::EvaluateAnimationPose() const
+{
 	for (int i = 0; i < m_pModel->m_numJoints; i++)
 	{
 		float transVec[3];
-		float rotVec[3];
+		float rotVec[3] = { 0.0f, 0.0f, 0.0f };
 		Matrix4 transform;
 		int frame;
-		Joint* pJoint = &(m_pModel->m_pJoints[i]);
+		const Joint* pJoint = &(m_pModel->m_pJoints[i]);
 		JointAnimation* pJointAnimation = &(m_pJointAnimations[i]);
 
 		if (pJoint->numRotationKeyframes == 0 && pJoint->numTranslationKeyframes == 0)
@@ -649,11 +800,7 @@ void MS3DAnimator::Update(float dt)
 		}
 
 		// Translation
-		frame = pJointAnimation->currentTranslationKeyframe;
-		while (frame < pJoint->numTranslationKeyframes && pJoint->pTranslationKeyframes[frame].time < m_timer)
-		{
-			frame++;
-		}
+		frame = FindKeyframe(pJoint->pTranslationKeyframes, pJoint->numTranslationKeyframes, pJointAnimation->currentTranslationKeyframe, m_timer);
 		pJointAnimation->currentTranslationKeyframe = frame;
 
 		if (pJoint->numTranslationKeyframes == 0)
@@ -678,7 +825,7 @@ void MS3DAnimator::Update(float dt)
 				const Keyframe& prevFrame = pJoint->pTranslationKeyframes[frame - 1];
 
 				float timeDelta = curFrame.time - prevFrame.time;
-				float interpValue = (m_timer - prevFrame.time) / timeDelta;
+				float interpValue = static_cast<float>((m_timer - prevFrame.time) / timeDelta);
 
 				transVec[0] = prevFrame.parameter[0] + (curFrame.parameter[0] - prevFrame.parameter[0]) * interpValue;
 				transVec[1] = prevFrame.parameter[1] + (curFrame.parameter[1] - prevFrame.parameter[1]) * interpValue;
@@ -687,11 +834,7 @@ void MS3DAnimator::Update(float dt)
 		}
 
 		// Rotation
-		frame = pJointAnimation->currentRotationKeyframe;
-		while (frame < pJoint->numRotationKeyframes && pJoint->pRotationKeyframes[frame].time < m_timer)
-		{
-			frame++;
-		}
+		frame = FindKeyframe(pJoint->pRotationKeyframes, pJoint->numRotationKeyframes, pJointAnimation->currentRotationKeyframe, m_timer);
 		pJointAnimation->currentRotationKeyframe = frame;
 
 		if (pJoint->numRotationKeyframes == 0)
@@ -702,19 +845,15 @@ void MS3DAnimator::Update(float dt)
 		{
 			if (frame == 0)
 			{
-				rotVec[0] = pJoint->pRotationKeyframes[0].parameter[0];
-				rotVec[1] = pJoint->pRotationKeyframes[0].parameter[1];
-				rotVec[2] = pJoint->pRotationKeyframes[0].parameter[2];
+				memcpy(rotVec, pJoint->pRotationKeyframes[0].parameter, sizeof(float) * 3);
 
-				transform.SetRotationRadians(rotVec);
+				transform = pJoint->firstRotation;
 			}
 			else if (frame == pJoint->numRotationKeyframes)
 			{
-				rotVec[0] = pJoint->pRotationKeyframes[frame - 1].parameter[0];
-				rotVec[1] = pJoint->pRotationKeyframes[frame - 1].parameter[1];
-				rotVec[2] = pJoint->pRotationKeyframes[frame - 1].parameter[2];
+				memcpy(rotVec, pJoint->pRotationKeyframes[frame - 1].parameter, sizeof(float) * 3);
 
-				transform.SetRotationRadians(rotVec);
+				transform = pJoint->lastRotation;
 			}
 			else
 			{
@@ -722,15 +861,13 @@ void MS3DAnimator::Update(float dt)
 				const Keyframe& prevFrame = pJoint->pRotationKeyframes[frame - 1];
 
 				float timeDelta = curFrame.time - prevFrame.time;
-				float interpValue = (m_timer - prevFrame.time) / timeDelta;
+				float interpValue = static_cast<float>((m_timer - prevFrame.time) / timeDelta);
 
-				glm::quat q1(glm::vec3(prevFrame.parameter[0], prevFrame.parameter[1], prevFrame.parameter[2]));
-				glm::quat q2(glm::vec3(curFrame.parameter[0], curFrame.parameter[1], curFrame.parameter[2]));
-				glm::quat q3 = slerp(q1, q2, interpValue);
+				// Keyframe quaternions are precomputed by the model, so there is no Euler conversion per frame
+				glm::quat q = slerp(pJoint->pRotationQuaternions[frame - 1], pJoint->pRotationQuaternions[frame], interpValue);
 
-				glm::mat4 trans = mat4_cast(q3);
-				float* pM = value_ptr(trans);
-				transform.SetValues(pM);
+				glm::mat4 trans = mat4_cast(q);
+				transform.SetValues(value_ptr(trans));
 
 				// To preserve blending, since the matrix-to-angles functionality is broken
 				rotVec[0] = prevFrame.parameter[0] + (curFrame.parameter[0] - prevFrame.parameter[0]) * interpValue;
@@ -742,56 +879,25 @@ void MS3DAnimator::Update(float dt)
 		// Combine and create the final animation matrix
 		transform.SetTranslation(transVec);
 
-		Matrix4 relativeFinal(pJoint->relative);
-		relativeFinal.PostMultiply(transform);
-
-		if (pJoint->parent == -1)
-		{
-			pJointAnimation->finalMatrix = relativeFinal;
-		}
-		else
-		{
-			pJointAnimation->finalMatrix = m_pJointAnimations[pJoint->parent].finalMatrix;
-
-			pJointAnimation->finalMatrix.PostMultiply(relativeFinal);
-		}
+		ComposeFinalMatrix(pJoint, pJointAnimation, transform);
 
 		// Also store the current trans and rot values in the start blend variables, in case we want to start a new blend.
-		pJointAnimation->currentBlendTrans[0] = transform.GetTranslationVector().x;
-		pJointAnimation->currentBlendTrans[1] = transform.GetTranslationVector().y;
-		pJointAnimation->currentBlendTrans[2] = transform.GetTranslationVector().z;
-		pJointAnimation->currentBlendRot[0] = rotVec[0];
-		pJointAnimation->currentBlendRot[1] = rotVec[1];
-		pJointAnimation->currentBlendRot[2] = rotVec[2];
+		memcpy(pJointAnimation->currentBlendTrans, transVec, sizeof(float) * 3);
+		memcpy(pJointAnimation->currentBlendRot, rotVec, sizeof(float) * 3);
 	}
-
-	// Also recalculate the bounding box, since vertices *might* now have new positions, given that we have updated all the bones!
-	CalculateBoundingBox();
 }
 
-void MS3DAnimator::UpdateBlending(float dt)
+void MS3DAnimator::EvaluateBlendingPose() const
 {
-	if (!m_isPaused)
-	{
-		m_blendTimer += dt;
-	}
-
-	if (m_blendTimer > m_blendTime)
-	{
-		// Finished blending
-		m_isBlending = false;
-		PlayAnimation(m_blendEndAnimationIndex);
-	}
+	float interpValue = static_cast<float>(m_blendTimer / m_blendTime);
 
 	for (int i = 0; i < m_pModel->m_numJoints; ++i)
 	{
 		float transVec[3];
 		float rotVec[3];
 		Matrix4 transform;
-		Joint *pJoint = &(m_pModel->m_pJoints[i]);
-		JointAnimation *pJointAnimation = &(m_pJointAnimations[i]);
-
-		float interpValue = static_cast<float>(m_blendTimer / m_blendTime);
+		const Joint* pJoint = &(m_pModel->m_pJoints[i]);
+		JointAnimation* pJointAnimation = &(m_pJointAnimations[i]);
 
 		transVec[0] = pJointAnimation->startBlendTrans[0] + (pJointAnimation->endBlendTrans[0] - pJointAnimation->startBlendTrans[0])*interpValue;
 		transVec[1] = pJointAnimation->startBlendTrans[1] + (pJointAnimation->endBlendTrans[1] - pJointAnimation->startBlendTrans[1])*interpValue;
@@ -806,32 +912,33 @@ void MS3DAnimator::UpdateBlending(float dt)
 		glm::quat q3 = slerp(q1, q2, interpValue);
 
 		glm::mat4 trans = mat4_cast(q3);
-		float* pM = value_ptr(trans);
-		transform.SetValues(pM);
+		transform.SetValues(value_ptr(trans));
 
 		transform.SetTranslation(transVec);
 
-		Matrix4 relativeFinal(pJoint->relative);
-		relativeFinal.PostMultiply(transform);
+		ComposeFinalMatrix(pJoint, pJointAnimation, transform);
 
-		if (pJoint->parent == -1)
-		{
-			pJointAnimation->finalMatrix = relativeFinal;
-		}
-		else
-		{
-			pJointAnimation->finalMatrix = m_pJointAnimations[pJoint->parent].finalMatrix;
+		// Also store the current trans and rot values in the start blend variables, in case we want to start a new blend.
+		memcpy(pJointAnimation->currentBlendTrans, transVec, sizeof(float) * 3);
+		memcpy(pJointAnimation->currentBlendRot, rotVec, sizeof(float) * 3);
+	}
+}
 
-			pJointAnimation->finalMatrix.PostMultiply(relativeFinal);
-		}
+void MS3DAnimator::ComposeFinalMatrix(const Joint* pJoint, JointAnimation* pJointAnimation, Matrix4& transform) const
+{
+	Matrix4 relativeFinal(pJoint->relative);
+	relativeFinal.PostMultiply(transform);
 
-		// Also store the current trans and rot values in the start blend variables, in case we want to start a new blend.
-		pJointAnimation->currentBlendTrans[0] = transform.GetTranslationVector().x;
-		pJointAnimation->currentBlendTrans[1] = transform.GetTranslationVector().y;
-		pJointAnimation->currentBlendTrans[2] = transform.GetTranslationVector().z;
-		pJointAnimation->currentBlendRot[0] = rotVec[0];
-		pJointAnimation->currentBlendRot[1] = rotVec[1];
-		pJointAnimation->currentBlendRot[2] = rotVec[2];
+	if (pJoint->parent == -1)
+	{
+		pJointAnimation->finalMatrix = relativeFinal;
+	}
+	else
+	{
+		// Parents always come before their children in the joint list
+		pJointAnimation->finalMatrix = m_pJointAnimations[pJoint->parent].finalMatrix;
+
+		pJointAnimation->finalMatrix.PostMultiply(relativeFinal);
 	}
 }
 
@@ -858,6 +965,8 @@ void MS3DAnimator::Render(bool isMesh, bool isNormal, bool isBone, bool isBoundi
 
 void MS3DAnimator::RenderMesh() const
 {
+	EvaluatePose();
+
 	// Draw by group
 	for (int i = 0; i < m_pModel->m_numMeshes; ++i)
 	{
@@ -922,6 +1031,8 @@ void MS3DAnimator::RenderMesh() const
 
 void MS3DAnimator::RenderNormals() const
 {
+	EvaluatePose();
+
 	// Make the color cyan
 	glColor3ub(0, 255, 255);
 
@@ -986,6 +1097,8 @@ void MS3DAnimator::RenderNormals() const
 
 void MS3DAnimator::RenderBones() const
 {
+	EvaluatePose();
+
 	// Make the color white
 	glColor3ub(255, 255, 255);
 
@@ -1024,6 +1137,11 @@ void MS3DAnimator::RenderBones() const
 
 void MS3DAnimator::RenderBoundingBox()
 {
+	if (m_isBoundingBoxDirty)
+	{
+		CalculateBoundingBox();
+	}
+
 	m_pRenderer->PushMatrix();
 	m_pRenderer->ImmediateColorAlpha(1.0f, 1.0f, 0.0f, 1.0f);
 
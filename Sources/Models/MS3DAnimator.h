@@ -14,6 +14,8 @@
 
 #include "MS3DModel.h"
 
+struct AnimationList;
+
 // Joint animation structure
 typedef struct JointAnimation
 {
@@ -66,6 +68,7 @@ public:
 	void CreateJointAnimations();
 
 	bool LoadAnimations(const char* animationFileName);
+	static bool ParseAnimations(const char* animationFileName, float animationFPS, int* numAnimations, Animation** pAnimations);
 
 	void CalculateBoundingBox();
 	BoundingBox* GetBoundingBox();
@@ -108,7 +111,15 @@ public:
 
 	// Update
 	void Update(float dt);
-	void UpdateBlending(float dt);
+	void UpdateDeferred(float dt);
+	// Advances the animation timers, without updatePose the last evaluated pose is kept
+	void AdvanceTimer(float dt, bool updatePose = true);
+
+	// Pose evaluation, only does work when the timer has advanced since the last evaluation
+	void EvaluatePose() const;
+	bool IsPoseDirty() const;
+	bool IsPoseQueued() const;
+	void SetPoseQueued(bool queued);
 
 	// Rendering
 	void Render(bool isMesh, bool isNormal, bool isBone, bool isBoundingBox);
@@ -118,6 +129,12 @@ public:
 	void RenderBoundingBox();
 
 private:
+	static int FindKeyframe(const Keyframe* pKeyframes, int numKeyframes, int frame, double time);
+
+	void EvaluateAnimationPose() const;
+	void EvaluateBlendingPose() const;
+	void ComposeFinalMatrix(const Joint* pJoint, JointAnimation* pJointAnimation, Matrix4& transform) const;
+
 	Renderer* m_pRenderer;
 
 	// The MS3D model for this animator
@@ -127,9 +144,10 @@ private:
 	int m_numJointAnimations;
 	JointAnimation* m_pJointAnimations;
 
-	// Animations
+	// Animations, shared with every other animator using the same animation file
+	AnimationList* m_pAnimationList;
 	int m_numAnimations;
-	Animation* m_pAnimations;
+	const Animation* m_pAnimations;
 
 	// Current playing animation
 	int m_currentAnimationIndex;
@@ -158,8 +176,14 @@ private:
 	int m_blendStartAnimationIndex;
 	int m_blendEndAnimationIndex;
 
+	// Deferred pose evaluation
+	mutable bool m_isPoseDirty;
+	bool m_isPoseBlended;
+	bool m_isPoseQueued;
+
 	// Bounding box
 	BoundingBox m_boundingBox;
+	mutable bool m_isBoundingBoxDirty;
 };
 
 #endif
\ No newline at end of file
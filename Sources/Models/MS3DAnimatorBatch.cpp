@@ -0,0 +1,146 @@
+/*************************************************************************
+> File Name: MS3DAnimatorBatch.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Gathers every animator whose timer advanced this frame and evaluates
+> 	 their poses together, split across the worker threads.
+> Created Time: 2016/07/02
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+
+#include <Utils/PerformanceTimer.h>
+#include <Utils/ThreadPool.h>
+
+#include "MS3DAnimatorBatch.h"
+
+// Number of animators handed to a worker at a time
+const int ANIMATOR_BATCH_GRAIN_SIZE = 16;
+
+// Initialize the singleton instance
+MS3DAnimatorBatch* MS3DAnimatorBatch::m_instance = nullptr;
+
+MS3DAnimatorBatch* MS3DAnimatorBatch::GetInstance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new MS3DAnimatorBatch;
+	}
+
+	return m_instance;
+}
+
+void MS3DAnimatorBatch::Destroy()
+{
+	if (m_instance)
+	{
+		for (size_t i = 0; i < m_vpQueuedAnimators.size(); ++i)
+		{
+			m_vpQueuedAnimators[i]->SetPoseQueued(false);
+		}
+		m_vpQueuedAnimators.clear();
+
+		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+MS3DAnimatorBatch::MS3DAnimatorBatch() :
+	m_numAnimators(0), m_numJoints(0), m_flushTime(0.0f)
+{
+	for (int i = 0; i < static_cast<int>(AnimationUpdateTier::NumTiers); ++i)
+	{
+		m_numTierAnimators[i] = 0;
+		m_numLastTierAnimators[i] = 0;
+	}
+}
+
+void MS3DAnimatorBatch::AddAnimator(MS3DAnimator* pAnimator)
+{
+	if (pAnimator->IsPoseQueued())
+	{
+		return;
+	}
+
+	pAnimator->SetPoseQueued(true);
+	m_vpQueuedAnimators.push_back(pAnimator);
+}
+
+void MS3DAnimatorBatch::RemoveAnimator(MS3DAnimator* pAnimator)
+{
+	pAnimator->SetPoseQueued(false);
+	m_vpQueuedAnimators.erase(remove(m_vpQueuedAnimators.begin(), m_vpQueuedAnimators.end(), pAnimator), m_vpQueuedAnimators.end());
+}
+
+void MS3DAnimatorBatch::Flush()
+{
+	PerformanceTimer timer;
+	timer.Start();
+
+	// Poses that were already read this frame have been evaluated on demand, so only gather the ones still pending
+	MS3DAnimatorList vpDirtyAnimators;
+	vpDirtyAnimators.reserve(m_vpQueuedAnimators.size());
+
+	m_numJoints = 0;
+	for (size_t i = 0; i < m_vpQueuedAnimators.size(); ++i)
+	{
+		MS3DAnimator* pAnimator = m_vpQueuedAnimators[i];
+		pAnimator->SetPoseQueued(false);
+
+		if (pAnimator->IsPoseDirty())
+		{
+			vpDirtyAnimators.push_back(pAnimator);
+			m_numJoints += pAnimator->GetModel()->GetNumJoints();
+		}
+	}
+	m_vpQueuedAnimators.clear();
+
+	// Each animator only writes its own joint animations and reads the shared, immutable skeleton
+	ThreadPool::GetInstance()->ParallelFor(static_cast<int>(vpDirtyAnimators.size()), ANIMATOR_BATCH_GRAIN_SIZE, _EvaluatePoses, &vpDirtyAnimators);
+
+	m_numAnimators = static_cast<int>(vpDirtyAnimators.size());
+	m_flushTime = timer.GetElapsedTime();
+
+	for (int i = 0; i < static_cast<int>(AnimationUpdateTier::NumTiers); ++i)
+	{
+		m_numLastTierAnimators[i] = m_numTierAnimators[i];
+		m_numTierAnimators[i] = 0;
+	}
+}
+
+void MS3DAnimatorBatch::_EvaluatePoses(void* pData, int begin, int end)
+{
+	MS3DAnimatorList* pAnimators = static_cast<MS3DAnimatorList*>(pData);
+
+	for (int i = begin; i < end; ++i)
+	{
+		(*pAnimators)[i]->EvaluatePose();
+	}
+}
+
+void MS3DAnimatorBatch::CountAnimators(AnimationUpdateTier tier, int numAnimators)
+{
+	m_numTierAnimators[static_cast<int>(tier)] += numAnimators;
+}
+
+int MS3DAnimatorBatch::GetNumAnimators() const
+{
+	return m_numAnimators;
+}
+
+int MS3DAnimatorBatch::GetNumAnimators(AnimationUpdateTier tier) const
+{
+	return m_numLastTierAnimators[static_cast<int>(tier)];
+}
+
+int MS3DAnimatorBatch::GetNumJoints() const
+{
+	return m_numJoints;
+}
+
+float MS3DAnimatorBatch::GetFlushTime() const
+{
+	return m_flushTime;
+}
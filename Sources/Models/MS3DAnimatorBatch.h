@@ -0,0 +1,74 @@
+/*************************************************************************
+> File Name: MS3DAnimatorBatch.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Gathers every animator whose timer advanced this frame and evaluates
+> 	 their poses together, split across the worker threads.
+> Created Time: 2016/07/02
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_MS3D_ANIMATOR_BATCH_H
+#define CUBBY_MS3D_ANIMATOR_BATCH_H
+
+#include <vector>
+
+#include "MS3DAnimator.h"
+
+using MS3DAnimatorList = std::vector<MS3DAnimator*>;
+
+// How much of a character's animation is updated. Reduced characters skip their facial animation, OnDemand characters
+// only evaluate their pose when something reads a bone.
+enum class AnimationUpdateTier
+{
+	Full = 0,
+	Reduced,
+	OnDemand,
+	NumTiers,
+};
+
+class MS3DAnimatorBatch
+{
+public:
+	static MS3DAnimatorBatch* GetInstance();
+	void Destroy();
+
+	void AddAnimator(MS3DAnimator* pAnimator);
+	void RemoveAnimator(MS3DAnimator* pAnimator);
+
+	// Evaluates the poses of all queued animators
+	void Flush();
+
+	// Animation update tier counters, gathered during the frame and published by Flush()
+	void CountAnimators(AnimationUpdateTier tier, int numAnimators);
+
+	// Statistics for the last flush
+	int GetNumAnimators() const;
+	int GetNumAnimators(AnimationUpdateTier tier) const;
+	int GetNumJoints() const;
+	float GetFlushTime() const;
+
+private:
+	MS3DAnimatorBatch();
+	MS3DAnimatorBatch(const MS3DAnimatorBatch&) = delete;
+	MS3DAnimatorBatch(MS3DAnimatorBatch&&) = delete;
+	MS3DAnimatorBatch& operator=(const MS3DAnimatorBatch&) = delete;
+	MS3DAnimatorBatch& operator=(MS3DAnimatorBatch&&) = delete;
+
+	static void _EvaluatePoses(void* pData, int begin, int end);
+
+	MS3DAnimatorList m_vpQueuedAnimators;
+
+	int m_numAnimators;
+	int m_numJoints;
+	float m_flushTime;
+
+	int m_numTierAnimators[static_cast<int>(AnimationUpdateTier::NumTiers)];
+	int m_numLastTierAnimators[static_cast<int>(AnimationUpdateTier::NumTiers)];
+
+	// Singleton instance
+	static MS3DAnimatorBatch* m_instance;
+};
+
+#endif
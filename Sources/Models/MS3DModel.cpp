@@ -9,6 +9,8 @@
 
 #include <fstream>
 
+#include <Utils/AssetPack.h>
+
 #include "MS3DModel.h"
 
 // Constructor, Destructor
@@ -69,6 +71,7 @@ MS3DModel::~MS3DModel()
 	{
 		delete[] m_pJoints[i].pRotationKeyframes;
 		delete[] m_pJoints[i].pTranslationKeyframes;
+		delete[] m_pJoints[i].pRotationQuaternions;
 	}
 
 	m_numJoints = 0;
@@ -82,14 +85,21 @@ MS3DModel::~MS3DModel()
 // Load
 bool MS3DModel::LoadModel(const char *modelFileName, bool isStatic)
 {
+	// Packed models are read out of the asset pack
+	std::vector<unsigned char> packData;
+	bool isPacked = AssetPack::GetInstance()->ReadFileData(modelFileName, &packData);
+
 	std::ifstream inputFile;
 
 	// Open the file
-	inputFile.open(modelFileName, std::ios::in | std::ios::binary);
-	if (inputFile.fail())
+	if (isPacked == false)
 	{
-		std::cerr << "Couldn't open the model file." << std::endl;
-		return false;
+		inputFile.open(modelFileName, std::ios::in | std::ios::binary);
+		if (inputFile.fail())
+		{
+			std::cerr << "Couldn't open the model file." << std::endl;
+			return false;
+		}
 	}
 
 	char pathTemp[PATH_MAX + 1];
@@ -111,15 +121,27 @@ bool MS3DModel::LoadModel(const char *modelFileName, bool isStatic)
 		pathTemp[pathLength++] = '/';
 	}
 
-	inputFile.seekg(0, std::ios::end);
-	long fileSize = static_cast<long>(inputFile.tellg());
-	inputFile.seekg(0, std::ios::beg);
+	long fileSize;
+	byte* pBuffer;
 
-	byte* pBuffer = new byte[fileSize];
+	if (isPacked)
+	{
+		fileSize = static_cast<long>(packData.size());
+		pBuffer = new byte[fileSize];
+		memcpy(pBuffer, packData.data(), fileSize);
+	}
+	else
+	{
+		inputFile.seekg(0, std::ios::end);
+		fileSize = static_cast<long>(inputFile.tellg());
+		inputFile.seekg(0, std::ios::beg);
 
-	// Read the whole file into pBuffer
-	inputFile.read(reinterpret_cast<char*>(pBuffer), fileSize);
-	inputFile.close();
+		pBuffer = new byte[fileSize];
+
+		// Read the whole file into pBuffer
+		inputFile.read(reinterpret_cast<char*>(pBuffer), fileSize);
+		inputFile.close();
+	}
 
 	// Now go through each byte of the file with *pPtr
 	byte* pPtr = pBuffer;
@@ -306,6 +328,7 @@ bool MS3DModel::LoadModel(const char *modelFileName, bool isStatic)
 		m_pJoints[i].parent = parentIndex;
 		m_pJoints[i].numRotationKeyframes = pJoint->numRotationKeyframes;
 		m_pJoints[i].pRotationKeyframes = new Keyframe[pJoint->numRotationKeyframes];
+		m_pJoints[i].pRotationQuaternions = new glm::quat[pJoint->numRotationKeyframes];
 		m_pJoints[i].numTranslationKeyframes = pJoint->numTranslationKeyframes;
 		m_pJoints[i].pTranslationKeyframes = new Keyframe[pJoint->numTranslationKeyframes];
 
@@ -432,6 +455,11 @@ void MS3DModel::SetJointKeyframe(int jointIndex, int keyframeIndex, float time,
 	keyframe.jointIndex = jointIndex;
 	keyframe.time = time;
 	memcpy(keyframe.parameter, parameter, sizeof(float) * 3);
+
+	if (isRotation)
+	{
+		m_pJoints[jointIndex].pRotationQuaternions[keyframeIndex] = glm::quat(glm::vec3(parameter[0], parameter[1], parameter[2]));
+	}
 }
 
 void MS3DModel::SetupJoints() const
@@ -443,6 +471,12 @@ void MS3DModel::SetupJoints() const
 		joint.relative.AddRotationByRadians(joint.localRotation);
 		joint.relative.AddTranslation(joint.localTranslation);
 
+		if (joint.numRotationKeyframes > 0)
+		{
+			joint.firstRotation.SetRotationRadians(joint.pRotationKeyframes[0].parameter);
+			joint.lastRotation.SetRotationRadians(joint.pRotationKeyframes[joint.numRotationKeyframes - 1].parameter);
+		}
+
 		if (joint.parent != -1)
 		{
 			joint.absolute = m_pJoints[joint.parent].absolute;
@@ -556,6 +590,37 @@ BoundingBox* MS3DModel::GetBoundingBox()
 	return &m_boundingBox;
 }
 
+// Animation
+float MS3DModel::GetAnimationFPS() const
+{
+	return m_animationFPS;
+}
+
+unsigned int MS3DModel::GetMemorySize() const
+{
+	unsigned int memorySize = sizeof(MS3DModel);
+
+	memorySize += m_numVertices * sizeof(Vertex);
+	memorySize += m_numTriangles * sizeof(Triangle);
+	memorySize += m_numMaterials * sizeof(MaterialModel);
+	memorySize += m_numMeshes * sizeof(Mesh);
+
+	for (int i = 0; i < m_numMeshes; ++i)
+	{
+		memorySize += m_pMeshes[i].numTriangles * sizeof(int);
+	}
+
+	memorySize += m_numJoints * sizeof(Joint);
+
+	for (int i = 0; i < m_numJoints; ++i)
+	{
+		memorySize += (m_pJoints[i].numRotationKeyframes + m_pJoints[i].numTranslationKeyframes) * sizeof(Keyframe);
+		memorySize += m_pJoints[i].numRotationKeyframes * sizeof(glm::quat);
+	}
+
+	return memorySize;
+}
+
 // Bones
 int MS3DModel::GetBoneIndex(const char* boneName) const
 {
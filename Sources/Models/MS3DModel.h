@@ -22,6 +22,8 @@
 	#error You must byte-align these structures with the appropriate compiler directives
 #endif
 
+#include <glm/gtc/quaternion.hpp>
+
 #include "../Renderer/Renderer.h"
 #include "BoundingBox.h"
 
@@ -146,6 +148,10 @@ typedef struct Joint
 	Keyframe* pTranslationKeyframes;
 	Keyframe* pRotationKeyframes;
 
+	// Rotation keyframes converted to quaternions at load time, and the first and last keyframe as matrices
+	glm::quat* pRotationQuaternions;
+	Matrix4 firstRotation, lastRotation;
+
 	int parent;
 
 	char name[32];
@@ -171,6 +177,12 @@ public:
 	void CalculateBoundingBox();
 	BoundingBox* GetBoundingBox();
 
+	// Animation
+	float GetAnimationFPS() const;
+
+	// Memory usage of the skeleton and mesh data, in bytes
+	unsigned int GetMemorySize() const;
+
 	// Bones
 	int GetBoneIndex(const char* boneName) const;
 	const char* GetNameFromBoneIndex(int boneIndex) const;
@@ -0,0 +1,202 @@
+/*************************************************************************
+> File Name: MS3DModelManager.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose: Shared cache for Milk Shape 3D skeletons and animation lists.
+> Created Time: 2016/07/02
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include "MS3DModelManager.h"
+
+// Initialize the singleton instance
+MS3DModelManager* MS3DModelManager::m_instance = nullptr;
+
+MS3DModelManager* MS3DModelManager::GetInstance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new MS3DModelManager;
+	}
+
+	return m_instance;
+}
+
+void MS3DModelManager::Destroy()
+{
+	if (m_instance)
+	{
+		for (auto iter = m_modelCache.begin(); iter != m_modelCache.end(); ++iter)
+		{
+			delete iter->second.m_pModel;
+			iter->second.m_pModel = nullptr;
+		}
+
+		m_modelCache.clear();
+
+		for (auto iter = m_animationListCache.begin(); iter != m_animationListCache.end(); ++iter)
+		{
+			delete[] iter->second->m_pAnimations;
+			delete iter->second;
+		}
+
+		m_animationListCache.clear();
+
+		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+// Skeletons
+MS3DModel* MS3DModelManager::GetMS3DModel(Renderer* pRenderer, const char* modelFileName)
+{
+	auto iter = m_modelCache.find(modelFileName);
+
+	if (iter == m_modelCache.end())
+	{
+		MS3DModel* pNewModel = new MS3DModel(pRenderer);
+		pNewModel->LoadModel(modelFileName);
+
+		MS3DModelCacheEntry newEntry;
+		newEntry.m_pModel = pNewModel;
+		newEntry.m_referenceCount = 0;
+
+		iter = m_modelCache.insert(std::make_pair(std::string(modelFileName), newEntry)).first;
+	}
+
+	iter->second.m_referenceCount++;
+
+	return iter->second.m_pModel;
+}
+
+void MS3DModelManager::ReleaseMS3DModel(MS3DModel* pModel)
+{
+	// Unreferenced skeletons stay cached, so respawning the same enemy type doesn't parse the file again
+	for (auto iter = m_modelCache.begin(); iter != m_modelCache.end(); ++iter)
+	{
+		if (iter->second.m_pModel == pModel)
+		{
+			if (iter->second.m_referenceCount > 0)
+			{
+				iter->second.m_referenceCount--;
+			}
+
+			return;
+		}
+	}
+}
+
+// Animation lists
+AnimationList* MS3DModelManager::GetAnimationList(const char* animationFileName, MS3DModel* pModel)
+{
+	// Keyframe times are converted using the animation FPS of the model, so that is part of the key
+	std::string key = std::string(animationFileName) + "@" + std::to_string(pModel->GetAnimationFPS());
+
+	auto iter = m_animationListCache.find(key);
+
+	if (iter == m_animationListCache.end())
+	{
+		int numAnimations = 0;
+		Animation* pAnimations = nullptr;
+
+		if (MS3DAnimator::ParseAnimations(animationFileName, pModel->GetAnimationFPS(), &numAnimations, &pAnimations) == false)
+		{
+			return nullptr;
+		}
+
+		AnimationList* pNewAnimationList = new AnimationList();
+		pNewAnimationList->m_numAnimations = numAnimations;
+		pNewAnimationList->m_pAnimations = pAnimations;
+		pNewAnimationList->m_referenceCount = 0;
+
+		iter = m_animationListCache.insert(std::make_pair(key, pNewAnimationList)).first;
+	}
+
+	iter->second->m_referenceCount++;
+
+	return iter->second;
+}
+
+void MS3DModelManager::ReleaseAnimationList(AnimationList* pAnimationList)
+{
+	if (pAnimationList != nullptr && pAnimationList->m_referenceCount > 0)
+	{
+		pAnimationList->m_referenceCount--;
+	}
+}
+
+// Statistics
+int MS3DModelManager::GetNumModels() const
+{
+	return m_modelCache.size();
+}
+
+int MS3DModelManager::GetNumModelInstances() const
+{
+	int numInstances = 0;
+
+	for (auto iter = m_modelCache.begin(); iter != m_modelCache.end(); ++iter)
+	{
+		numInstances += iter->second.m_referenceCount;
+	}
+
+	return numInstances;
+}
+
+int MS3DModelManager::GetNumAnimationLists() const
+{
+	return m_animationListCache.size();
+}
+
+int MS3DModelManager::GetNumAnimationListInstances() const
+{
+	int numInstances = 0;
+
+	for (auto iter = m_animationListCache.begin(); iter != m_animationListCache.end(); ++iter)
+	{
+		numInstances += iter->second->m_referenceCount;
+	}
+
+	return numInstances;
+}
+
+unsigned int MS3DModelManager::GetNumBytesUsed() const
+{
+	unsigned int bytesUsed = 0;
+
+	for (auto iter = m_modelCache.begin(); iter != m_modelCache.end(); ++iter)
+	{
+		bytesUsed += iter->second.m_pModel->GetMemorySize();
+	}
+
+	for (auto iter = m_animationListCache.begin(); iter != m_animationListCache.end(); ++iter)
+	{
+		bytesUsed += sizeof(AnimationList) + iter->second->m_numAnimations * sizeof(Animation);
+	}
+
+	return bytesUsed;
+}
+
+unsigned int MS3DModelManager::GetNumBytesSaved() const
+{
+	unsigned int bytesSaved = 0;
+
+	// Every extra reference would otherwise have loaded its own copy
+	for (auto iter = m_modelCache.begin(); iter != m_modelCache.end(); ++iter)
+	{
+		if (iter->second.m_referenceCount > 1)
+		{
+			bytesSaved += (iter->second.m_referenceCount - 1) * iter->second.m_pModel->GetMemorySize();
+		}
+	}
+
+	for (auto iter = m_animationListCache.begin(); iter != m_animationListCache.end(); ++iter)
+	{
+		if (iter->second->m_referenceCount > 1)
+		{
+			bytesSaved += (iter->second->m_referenceCount - 1) * iter->second->m_numAnimations * sizeof(Animation);
+		}
+	}
+
+	return bytesSaved;
+}
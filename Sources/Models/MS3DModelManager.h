@@ -0,0 +1,70 @@
+/*************************************************************************
+> File Name: MS3DModelManager.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose: Shared cache for Milk Shape 3D skeletons and animation lists.
+> Created Time: 2016/07/02
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_MS3D_MODEL_MANAGER_H
+#define CUBBY_MS3D_MODEL_MANAGER_H
+
+#include <unordered_map>
+
+#include "MS3DAnimator.h"
+
+struct MS3DModelCacheEntry
+{
+	MS3DModel* m_pModel;
+	int m_referenceCount;
+};
+
+// Immutable animation clips, shared between every animator that loads the same file
+struct AnimationList
+{
+	int m_numAnimations;
+	Animation* m_pAnimations;
+	int m_referenceCount;
+};
+
+using MS3DModelCache = std::unordered_map<std::string, MS3DModelCacheEntry>;
+using AnimationListCache = std::unordered_map<std::string, AnimationList*>;
+
+class MS3DModelManager
+{
+public:
+	static MS3DModelManager* GetInstance();
+	void Destroy();
+
+	// Skeletons
+	MS3DModel* GetMS3DModel(Renderer* pRenderer, const char* modelFileName);
+	void ReleaseMS3DModel(MS3DModel* pModel);
+
+	// Animation lists
+	AnimationList* GetAnimationList(const char* animationFileName, MS3DModel* pModel);
+	void ReleaseAnimationList(AnimationList* pAnimationList);
+
+	// Statistics
+	int GetNumModels() const;
+	int GetNumModelInstances() const;
+	int GetNumAnimationLists() const;
+	int GetNumAnimationListInstances() const;
+	unsigned int GetNumBytesUsed() const;
+	unsigned int GetNumBytesSaved() const;
+
+private:
+	MS3DModelManager() = default;
+	MS3DModelManager(const MS3DModelManager&) = delete;
+	MS3DModelManager(MS3DModelManager&&) = delete;
+	MS3DModelManager& operator=(const MS3DModelManager&) = delete;
+	MS3DModelManager& operator=(MS3DModelManager&&) = delete;
+
+	MS3DModelCache m_modelCache;
+	AnimationListCache m_animationListCache;
+
+	// Singleton instance
+	static MS3DModelManager* m_instance;
+};
+
+#endif
@@ -7,6 +7,11 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <algorithm>
+#include <limits>
+
+#include <Utils/AssetPack.h>
+
 #include "QubicleBinary.h"
 #include "VoxelCharacter.h"
 
@@ -16,6 +21,9 @@
 #endif
 
 const float QubicleBinary::BLOCK_RENDER_SIZE = 0.5f;
+const float QubicleBinary::LOD1_DISTANCE = 16.0f;
+const float QubicleBinary::LOD2_DISTANCE = 32.0f;
+
 
 // Constructor, Destructor
 QubicleBinary::QubicleBinary(Renderer* pRenderer) :
@@ -23,7 +31,7 @@ QubicleBinary::QubicleBinary(Renderer* pRenderer) :
 	m_colorFormat(0), m_zAxisOrientation(0), m_compressed(0), m_visibilityMaskEncoded(0), m_numMatrices(0),
 	m_isRenderWireFrame(false), m_meshAlpha(1.0f),
 	m_isSingleMeshColor(false), m_meshSingleColorR(1.0f), m_meshSingleColorG(1.0f), m_meshSingleColorB(1.0f),
-	m_materialID(0)
+	m_materialID(0), m_isCreateLODMeshes(false), m_isLODMeshesRequested(false)
 {
 	Reset();
 
@@ -74,8 +82,14 @@ void QubicleBinary::ClearMatrices()
 			continue;
 		}
 
-		m_pRenderer->ClearMesh(m_vpMatrices[i]->m_pMesh);
-		m_vpMatrices[i]->m_pMesh = nullptr;
+		// Matrices that were decoded but never meshed don't have a render mesh yet
+		if (m_vpMatrices[i]->m_pMesh != nullptr)
+		{
+			m_pRenderer->ClearMesh(m_vpMatrices[i]->m_pMesh);
+			m_vpMatrices[i]->m_pMesh = nullptr;
+		}
+
+		ClearLODMeshes(m_vpMatrices[i]);
 
 		delete[] m_vpMatrices[i]->m_pColor;
 
@@ -109,6 +123,16 @@ std::string QubicleBinary::GetFileName() const
 	return m_fileName;
 }
 
+void QubicleBinary::SetFileName(const char* fileName)
+{
+	m_fileName = fileName;
+}
+
+bool QubicleBinary::IsLoaded() const
+{
+	return m_isLoaded;
+}
+
 unsigned int QubicleBinary::GetMaterial() const
 {
 	return m_materialID;
@@ -144,133 +168,319 @@ void QubicleBinary::GetMatrixPosition(int index, int* aX, int* aY, int* aZ)
 	*aZ = m_vpMatrices[index]->m_matrixPosZ;
 }
 
-bool QubicleBinary::Import(const char* fileName, bool faceMerging)
+bool QubicleBinary::Import(const char* fileName, bool faceMerging, bool createLODMeshes)
 {
 	m_fileName = fileName;
 
-	char qbFilename[256];
-	sprintf(qbFilename, fileName);;
+	if (Decode(fileName) == false)
+	{
+		return false;
+	}
+
+	return FinishImport(faceMerging, createLODMeshes);
+}
+
+bool QubicleBinary::PrepareImport(const char* fileName, bool faceMerging, bool createLODMeshes)
+{
+	if (Decode(fileName) == false)
+	{
+		return false;
+	}
+
+	m_isCreateLODMeshes = createLODMeshes;
+
+	BuildMesh(faceMerging);
+
+	return true;
+}
+
+bool QubicleBinary::CompleteImport()
+{
+	UploadMesh();
+
+	m_isLoaded = true;
+
+	// Someone asked for the LOD meshes while we were still loading without them
+	if (m_isLODMeshesRequested)
+	{
+		m_isLODMeshesRequested = false;
+		RequestLODMeshes();
+	}
+
+	return true;
+}
+
+bool QubicleBinary::Decode(const char* fileName)
+{
+	// Packed models are read out of the asset pack and decoded from memory
+	std::vector<unsigned char> packData;
+
+	if (AssetPack::GetInstance()->ReadFileData(fileName, &packData))
+	{
+		return packData.empty() == false && DecodeFromMemory(&packData[0], packData.size());
+	}
 
 	FILE* pQBfile = nullptr;
-	fopen_s(&pQBfile, qbFilename, "rb");
+	fopen_s(&pQBfile, fileName, "rb");
+
+	if (pQBfile == nullptr)
+	{
+		return false;
+	}
+
+	// Read the whole file in one go, the matrices are then decoded straight out of memory
+	fseek(pQBfile, 0, SEEK_END);
+	long fileSize = ftell(pQBfile);
+	fseek(pQBfile, 0, SEEK_SET);
+
+	std::vector<unsigned char> fileData(fileSize > 0 ? fileSize : 0);
+	bool isRead = fileSize > 0 && fread(&fileData[0], fileSize, 1, pQBfile) == 1;
+
+	fclose(pQBfile);
 
+	if (isRead == false)
+	{
+		return false;
+	}
+
+	return DecodeFromMemory(&fileData[0], fileData.size());
+}
+
+// Bounds checked read from the in-memory file, advancing the read offset
+static bool ReadQubicleData(const unsigned char* pData, size_t dataSize, size_t* pOffset, void* pDest, size_t numBytes)
+{
+	if (numBytes > dataSize - *pOffset)
+	{
+		return false;
+	}
+
+	memcpy(pDest, pData + *pOffset, numBytes);
+	*pOffset += numBytes;
+
+	return true;
+}
+
+bool QubicleBinary::DecodeFromMemory(const unsigned char* pData, size_t dataSize)
+{
 	const unsigned int CODEFLAG = 2;
 	const unsigned int NEXTSLICEFLAG = 6;
 
-	if (pQBfile != nullptr)
+	size_t offset = 0;
+
+	bool isValid =
+		ReadQubicleData(pData, dataSize, &offset, &m_version[0], sizeof(char) * 4) &&
+		ReadQubicleData(pData, dataSize, &offset, &m_colorFormat, sizeof(unsigned int)) &&
+		ReadQubicleData(pData, dataSize, &offset, &m_zAxisOrientation, sizeof(unsigned int)) &&
+		ReadQubicleData(pData, dataSize, &offset, &m_compressed, sizeof(unsigned int)) &&
+		ReadQubicleData(pData, dataSize, &offset, &m_visibilityMaskEncoded, sizeof(unsigned int)) &&
+		ReadQubicleData(pData, dataSize, &offset, &m_numMatrices, sizeof(unsigned int));
+
+	QubicleMatrixList vpDecodedMatrices;
+
+	for (unsigned int i = 0; isValid && i < m_numMatrices; ++i)
 	{
-		fread(&m_version[0], sizeof(char) * 4, 1, pQBfile) == 1;
-		fread(&m_colorFormat, sizeof(unsigned int), 1, pQBfile) == 1;
-		fread(&m_zAxisOrientation, sizeof(unsigned int), 1, pQBfile) == 1;
-		fread(&m_compressed, sizeof(unsigned int), 1, pQBfile) == 1;
-		fread(&m_visibilityMaskEncoded, sizeof(unsigned int), 1, pQBfile) == 1;
-		fread(&m_numMatrices, sizeof(unsigned int), 1, pQBfile) == 1;
+		QubicleMatrix* pNewMatrix = new QubicleMatrix();
+		vpDecodedMatrices.push_back(pNewMatrix);
 
-		for (unsigned int i = 0; i < m_numMatrices; ++i)
+		isValid = ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_nameLength, sizeof(char));
+		if (isValid == false)
 		{
-			QubicleMatrix* pNewMatrix = new QubicleMatrix();
+			break;
+		}
 
-			fread(static_cast<char*>(&pNewMatrix->m_nameLength), sizeof(char), 1, pQBfile) == 1;
-			pNewMatrix->m_name = new char[pNewMatrix->m_nameLength + 1];
-			fread(&pNewMatrix->m_name[0], sizeof(char) * pNewMatrix->m_nameLength, 1, pQBfile) == 1;
-			pNewMatrix->m_name[pNewMatrix->m_nameLength] = 0;
+		unsigned char nameLength = static_cast<unsigned char>(pNewMatrix->m_nameLength);
+		pNewMatrix->m_name = new char[nameLength + 1];
+		pNewMatrix->m_name[0] = 0;
 
-			fread(&pNewMatrix->m_matrixSizeX, sizeof(unsigned int), 1, pQBfile) == 1;
-			fread(&pNewMatrix->m_matrixSizeY, sizeof(unsigned int), 1, pQBfile) == 1;
-			fread(&pNewMatrix->m_matrixSizeZ, sizeof(unsigned int), 1, pQBfile) == 1;
+		isValid =
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_name[0], sizeof(char) * nameLength) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixSizeX, sizeof(unsigned int)) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixSizeY, sizeof(unsigned int)) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixSizeZ, sizeof(unsigned int)) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixPosX, sizeof(int)) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixPosY, sizeof(int)) &&
+			ReadQubicleData(pData, dataSize, &offset, &pNewMatrix->m_matrixPosZ, sizeof(int));
+		if (isValid == false)
+		{
+			break;
+		}
 
-			fread(&pNewMatrix->m_matrixPosX, sizeof(int), 1, pQBfile) == 1;
-			fread(&pNewMatrix->m_matrixPosY, sizeof(int), 1, pQBfile) == 1;
-			fread(&pNewMatrix->m_matrixPosZ, sizeof(int), 1, pQBfile) == 1;
+		pNewMatrix->m_name[nameLength] = 0;
 
-			pNewMatrix->m_boneIndex = -1;
-			pNewMatrix->m_pMesh = nullptr;
+		pNewMatrix->m_boneIndex = -1;
+		pNewMatrix->m_pMesh = nullptr;
 
-			pNewMatrix->m_scale = 1.0f;
-			pNewMatrix->m_offsetX = 0.0f;
-			pNewMatrix->m_offsetY = 0.0f;
-			pNewMatrix->m_offsetZ = 0.0f;
+		pNewMatrix->m_scale = 1.0f;
+		pNewMatrix->m_offsetX = 0.0f;
+		pNewMatrix->m_offsetY = 0.0f;
+		pNewMatrix->m_offsetZ = 0.0f;
 
-			pNewMatrix->m_isRemoved = false;
-			
-			pNewMatrix->m_pColor = new unsigned int[pNewMatrix->m_matrixSizeX * pNewMatrix->m_matrixSizeY * pNewMatrix->m_matrixSizeZ];
+		pNewMatrix->m_isRemoved = false;
 
-			if (m_compressed == 0)
+		size_t sliceSize = static_cast<size_t>(pNewMatrix->m_matrixSizeX) * pNewMatrix->m_matrixSizeY;
+		size_t numVoxels = sliceSize * pNewMatrix->m_matrixSizeZ;
+
+		if (m_compressed == 0)
+		{
+			// Voxels are stored x, then y, then z, the same layout as m_pColor, so the matrix is one block copy
+			if (numVoxels > (dataSize - offset) / sizeof(unsigned int))
 			{
-				for (unsigned int z = 0; z < pNewMatrix->m_matrixSizeZ; ++z)
+				isValid = false;
+				break;
+			}
+
+			pNewMatrix->m_pColor = new unsigned int[numVoxels];
+			ReadQubicleData(pData, dataSize, &offset, pNewMatrix->m_pColor, numVoxels * sizeof(unsigned int));
+		}
+		else
+		{
+			pNewMatrix->m_pColor = new unsigned int[numVoxels];
+
+			for (unsigned int z = 0; isValid && z < pNewMatrix->m_matrixSizeZ; ++z)
+			{
+				// Each slice is run length encoded linearly, x then y, so runs are filled straight into the slice
+				unsigned int* pSlice = pNewMatrix->m_pColor + z * sliceSize;
+				size_t index = 0;
+
+				while (true)
 				{
-					for (unsigned int y = 0; y < pNewMatrix->m_matrixSizeY; ++y)
+					unsigned int data = 0;
+					if (ReadQubicleData(pData, dataSize, &offset, &data, sizeof(unsigned int)) == false)
 					{
-						for (unsigned int x = 0; x < pNewMatrix->m_matrixSizeX; ++x)
-						{
-							unsigned int color = 0;
-							fread(&color, sizeof(unsigned int), 1, pQBfile) == 1;
+						isValid = false;
+						break;
+					}
+
+					if (data == NEXTSLICEFLAG)
+					{
+						break;
+					}
 
-							pNewMatrix->m_pColor[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = color;
+					unsigned int count = 1;
+					if (data == CODEFLAG)
+					{
+						if (ReadQubicleData(pData, dataSize, &offset, &count, sizeof(unsigned int)) == false ||
+							ReadQubicleData(pData, dataSize, &offset, &data, sizeof(unsigned int)) == false)
+						{
+							isValid = false;
+							break;
 						}
 					}
+
+					if (count > sliceSize - index)
+					{
+						isValid = false;
+						break;
+					}
+
+					std::fill_n(pSlice + index, count, data);
+					index += count;
 				}
 			}
-			else
-			{
-				unsigned int z = 0;
+		}
+	}
 
-				while (z < pNewMatrix->m_matrixSizeZ)
-				{
-					unsigned int index = 0;
+	if (isValid == false)
+	{
+		for (size_t i = 0; i < vpDecodedMatrices.size(); ++i)
+		{
+			delete[] vpDecodedMatrices[i]->m_name;
+			delete[] vpDecodedMatrices[i]->m_pColor;
+			delete vpDecodedMatrices[i];
+		}
 
-					while (true)
-					{
-						unsigned int data = 0;
-						fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
+		m_numMatrices = 0;
 
-						if (data == NEXTSLICEFLAG)
-							break;
-						
-						if (data == CODEFLAG)
-						{
-							unsigned int count = 0;
-							fread(&count, sizeof(unsigned int), 1, pQBfile) == 1;
-							fread(&data, sizeof(unsigned int), 1, pQBfile) == 1;
+		std::cout << "QubicleBinary::DecodeFromMemory() failed, corrupt qubicle binary data in " << m_fileName << std::endl;
 
-							for (unsigned int j = 0; j < count; ++j)
-							{
-								unsigned int x = index % pNewMatrix->m_matrixSizeX;
-								unsigned int y = index / pNewMatrix->m_matrixSizeX;
+		return false;
+	}
 
-								pNewMatrix->m_pColor[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = data;
+	m_vpMatrices.insert(m_vpMatrices.end(), vpDecodedMatrices.begin(), vpDecodedMatrices.end());
 
-								index++;
-							}
-						}
-						else
-						{
-							unsigned int x = index % pNewMatrix->m_matrixSizeX;
-							unsigned int y = index / pNewMatrix->m_matrixSizeX;
+	return true;
+}
 
-							pNewMatrix->m_pColor[x + pNewMatrix->m_matrixSizeX * (y + pNewMatrix->m_matrixSizeY * z)] = data;
+bool QubicleBinary::FinishImport(bool faceMerging, bool createLODMeshes)
+{
+	m_isCreateLODMeshes = createLODMeshes;
 
-							index++;
-						}
-					}
+	CreateMesh(faceMerging);
 
-					z++;
-				}
-			}
+	m_isLoaded = true;
+
+	return true;
+}
+
+bool QubicleBinary::ImportFromBinary(QubicleBinary* pSource, bool faceMerging, bool createLODMeshes)
+{
+	// Only the decoded voxel data is copied, so off the main thread the source's meshes may not be uploaded yet
+	if (pSource == nullptr || pSource->m_vpMatrices.empty())
+	{
+		return false;
+	}
+
+	m_fileName = pSource->m_fileName;
+	m_isCreateLODMeshes = createLODMeshes;
+
+	m_version[0] = pSource->m_version[0];
+	m_version[1] = pSource->m_version[1];
+	m_version[2] = pSource->m_version[2];
+	m_version[3] = pSource->m_version[3];
+	m_colorFormat = pSource->m_colorFormat;
+	m_zAxisOrientation = pSource->m_zAxisOrientation;
+	m_compressed = pSource->m_compressed;
+	m_visibilityMaskEncoded = pSource->m_visibilityMaskEncoded;
+	m_numMatrices = 0;
+
+	// Copy the already decoded voxel data, so we don't need to parse the file again
+	for (size_t i = 0; i < pSource->m_vpMatrices.size(); ++i)
+	{
+		QubicleMatrix* pSourceMatrix = pSource->m_vpMatrices[i];
 
-			m_vpMatrices.push_back(pNewMatrix);
+		if (pSourceMatrix == nullptr)
+		{
+			continue;
 		}
 
-		fclose(pQBfile);
+		QubicleMatrix* pNewMatrix = new QubicleMatrix();
 
-		CreateMesh(faceMerging);
+		pNewMatrix->m_nameLength = pSourceMatrix->m_nameLength;
+		pNewMatrix->m_name = new char[pNewMatrix->m_nameLength + 1];
+		memcpy(pNewMatrix->m_name, pSourceMatrix->m_name, pNewMatrix->m_nameLength);
+		pNewMatrix->m_name[pNewMatrix->m_nameLength] = 0;
 
-		m_isLoaded = true;
+		pNewMatrix->m_matrixSizeX = pSourceMatrix->m_matrixSizeX;
+		pNewMatrix->m_matrixSizeY = pSourceMatrix->m_matrixSizeY;
+		pNewMatrix->m_matrixSizeZ = pSourceMatrix->m_matrixSizeZ;
 
-		return true;
+		pNewMatrix->m_matrixPosX = pSourceMatrix->m_matrixPosX;
+		pNewMatrix->m_matrixPosY = pSourceMatrix->m_matrixPosY;
+		pNewMatrix->m_matrixPosZ = pSourceMatrix->m_matrixPosZ;
+
+		pNewMatrix->m_boneIndex = pSourceMatrix->m_boneIndex;
+		pNewMatrix->m_pMesh = nullptr;
+
+		pNewMatrix->m_scale = pSourceMatrix->m_scale;
+		pNewMatrix->m_offsetX = pSourceMatrix->m_offsetX;
+		pNewMatrix->m_offsetY = pSourceMatrix->m_offsetY;
+		pNewMatrix->m_offsetZ = pSourceMatrix->m_offsetZ;
+
+		pNewMatrix->m_isRemoved = pSourceMatrix->m_isRemoved;
+
+		unsigned int numVoxels = pNewMatrix->m_matrixSizeX * pNewMatrix->m_matrixSizeY * pNewMatrix->m_matrixSizeZ;
+		pNewMatrix->m_pColor = new unsigned int[numVoxels];
+		memcpy(pNewMatrix->m_pColor, pSourceMatrix->m_pColor, sizeof(unsigned int) * numVoxels);
+
+		m_vpMatrices.push_back(pNewMatrix);
+		m_numMatrices++;
 	}
 
-	return false;
+	CreateMesh(faceMerging);
+
+	m_isLoaded = true;
+
+	return true;
 }
 
 bool QubicleBinary::Export(const char* fileName)
@@ -424,6 +634,11 @@ bool QubicleBinary::GetSingleMeshColor(float* r, float* g, float* b, float* a) c
 	return m_isSingleMeshColor;
 }
 
+float QubicleBinary::GetMeshAlpha() const
+{
+	return m_meshAlpha;
+}
+
 bool QubicleBinary::GetActive(int matrixIndex, int x, int y, int z)
 {
 	QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
@@ -438,6 +653,14 @@ void QubicleBinary::SetMeshAlpha(float alpha)
 	for (unsigned int i = 0; i < m_vpMatrices.size(); ++i)
 	{
 		m_pRenderer->ModifyMeshAlpha(alpha, m_vpMatrices[i]->m_pMesh);
+
+		for (int j = 0; j < QUBICLE_NUM_LOD_MESHES; ++j)
+		{
+			if (m_vpMatrices[i]->m_pLODMesh[j] != nullptr)
+			{
+				m_pRenderer->ModifyMeshAlpha(alpha, m_vpMatrices[i]->m_pLODMesh[j]);
+			}
+		}
 	}
 }
 
@@ -451,6 +674,14 @@ void QubicleBinary::SetMeshSingleColor(float r, float g, float b)
 	for (unsigned int i = 0; i < m_vpMatrices.size(); ++i)
 	{
 		m_pRenderer->ModifyMeshColor(r, g, b, m_vpMatrices[i]->m_pMesh);
+
+		for (int j = 0; j < QUBICLE_NUM_LOD_MESHES; ++j)
+		{
+			if (m_vpMatrices[i]->m_pLODMesh[j] != nullptr)
+			{
+				m_pRenderer->ModifyMeshColor(r, g, b, m_vpMatrices[i]->m_pLODMesh[j]);
+			}
+		}
 	}
 }
 
@@ -486,6 +717,12 @@ bool IsMergedZPositive(int* merged, int x, int y, int z, int width, int height)
 }
 
 void QubicleBinary::CreateMesh(bool doFaceMerging)
+{
+	BuildMesh(doFaceMerging);
+	UploadMesh();
+}
+
+void QubicleBinary::BuildMesh(bool doFaceMerging)
 {
 	for (unsigned int matrixIndex = 0; matrixIndex < m_vpMatrices.size(); matrixIndex++)
 	{
@@ -753,11 +990,35 @@ void QubicleBinary::CreateMesh(bool doFaceMerging)
 			}
 		}
 
-		m_pRenderer->FinishMesh(-1, m_materialID, pMatrix->m_pMesh);
-
 		// Delete the merged array
 		delete[] merged;
 	}
+
+	if (m_isCreateLODMeshes)
+	{
+		CreateLODMeshes();
+	}
+}
+
+void QubicleBinary::UploadMesh()
+{
+	for (unsigned int i = 0; i < m_vpMatrices.size(); ++i)
+	{
+		QubicleMatrix* pMatrix = m_vpMatrices[i];
+
+		if (pMatrix->m_pMesh != nullptr)
+		{
+			m_pRenderer->FinishMesh(-1, m_materialID, pMatrix->m_pMesh);
+		}
+
+		for (int j = 0; j < QUBICLE_NUM_LOD_MESHES; ++j)
+		{
+			if (pMatrix->m_pLODMesh[j] != nullptr)
+			{
+				m_pRenderer->FinishMesh(-1, m_materialID, pMatrix->m_pLODMesh[j]);
+			}
+		}
+	}
 }
 
 void QubicleBinary::RebuildMesh(bool doFaceMerging)
@@ -766,11 +1027,291 @@ void QubicleBinary::RebuildMesh(bool doFaceMerging)
 	{
 		m_pRenderer->ClearMesh(m_vpMatrices[i]->m_pMesh);
 		m_vpMatrices[i]->m_pMesh = nullptr;
+
+		ClearLODMeshes(m_vpMatrices[i]);
 	}
 
 	CreateMesh(doFaceMerging);
 }
 
+// Level of detail
+void QubicleBinary::SetCreateLODMeshes(bool createLODMeshes)
+{
+	m_isCreateLODMeshes = createLODMeshes;
+}
+
+bool QubicleBinary::IsCreateLODMeshes() const
+{
+	return m_isCreateLODMeshes;
+}
+
+void QubicleBinary::RequestLODMeshes()
+{
+	// A background load may still be meshing, so wait until it has been uploaded before touching the meshes
+	if (m_isLoaded == false)
+	{
+		m_isLODMeshesRequested = true;
+		return;
+	}
+
+	if (m_isCreateLODMeshes)
+	{
+		return;
+	}
+
+	m_isCreateLODMeshes = true;
+
+	CreateLODMeshes();
+
+	for (unsigned int i = 0; i < m_vpMatrices.size(); ++i)
+	{
+		for (int j = 0; j < QUBICLE_NUM_LOD_MESHES; ++j)
+		{
+			if (m_vpMatrices[i]->m_pLODMesh[j] != nullptr)
+			{
+				m_pRenderer->FinishMesh(-1, m_materialID, m_vpMatrices[i]->m_pLODMesh[j]);
+			}
+		}
+	}
+}
+
+void QubicleBinary::CreateLODMeshes()
+{
+	for (unsigned int matrixIndex = 0; matrixIndex < m_vpMatrices.size(); ++matrixIndex)
+	{
+		for (int lodLevel = 1; lodLevel <= QUBICLE_NUM_LOD_MESHES; ++lodLevel)
+		{
+			CreateLODMesh(m_vpMatrices[matrixIndex], lodLevel);
+		}
+	}
+}
+
+void QubicleBinary::CreateLODMesh(QubicleMatrix* pMatrix, int lodLevel)
+{
+	// Each LOD level halves the voxel resolution of the matrix
+	int lodScale = 1 << lodLevel;
+
+	int sizeX = (pMatrix->m_matrixSizeX + lodScale - 1) / lodScale;
+	int sizeY = (pMatrix->m_matrixSizeY + lodScale - 1) / lodScale;
+	int sizeZ = (pMatrix->m_matrixSizeZ + lodScale - 1) / lodScale;
+
+	unsigned int* pLODColor = new unsigned int[sizeX * sizeY * sizeZ];
+
+	unsigned int* pCellColors = new unsigned int[lodScale * lodScale * lodScale];
+	int* pCellCounts = new int[lodScale * lodScale * lodScale];
+
+	// Majority color downsampling, a LOD voxel stays active if any of its source voxels are active so thin parts don't disappear
+	for (int cellX = 0; cellX < sizeX; ++cellX)
+	{
+		for (int cellY = 0; cellY < sizeY; ++cellY)
+		{
+			for (int cellZ = 0; cellZ < sizeZ; ++cellZ)
+			{
+				int numCellColors = 0;
+
+				for (int x = cellX * lodScale; x < (cellX + 1) * lodScale && x < static_cast<int>(pMatrix->m_matrixSizeX); ++x)
+				{
+					for (int y = cellY * lodScale; y < (cellY + 1) * lodScale && y < static_cast<int>(pMatrix->m_matrixSizeY); ++y)
+					{
+						for (int z = cellZ * lodScale; z < (cellZ + 1) * lodScale && z < static_cast<int>(pMatrix->m_matrixSizeZ); ++z)
+						{
+							if (pMatrix->GetActive(x, y, z) == false)
+							{
+								continue;
+							}
+
+							unsigned int color = pMatrix->GetColorCompact(x, y, z);
+
+							int colorIndex = 0;
+							while (colorIndex < numCellColors && pCellColors[colorIndex] != color)
+							{
+								colorIndex++;
+							}
+
+							if (colorIndex == numCellColors)
+							{
+								pCellColors[numCellColors] = color;
+								pCellCounts[numCellColors] = 0;
+								numCellColors++;
+							}
+
+							pCellCounts[colorIndex]++;
+						}
+					}
+				}
+
+				unsigned int majorityColor = 0;
+				int majorityCount = 0;
+
+				for (int i = 0; i < numCellColors; ++i)
+				{
+					if (pCellCounts[i] > majorityCount)
+					{
+						majorityColor = pCellColors[i];
+						majorityCount = pCellCounts[i];
+					}
+				}
+
+				pLODColor[cellX + sizeX * (cellY + sizeY * cellZ)] = majorityColor;
+			}
+		}
+	}
+
+	delete[] pCellColors;
+	delete[] pCellCounts;
+
+	TriangleMesh* pMesh = pMatrix->m_pLODMesh[lodLevel - 1];
+	if (pMesh == nullptr)
+	{
+		pMesh = m_pRenderer->CreateMesh(MeshType::Textured);
+		pMatrix->m_pLODMesh[lodLevel - 1] = pMesh;
+	}
+
+	for (int cellX = 0; cellX < sizeX; ++cellX)
+	{
+		for (int cellY = 0; cellY < sizeY; ++cellY)
+		{
+			for (int cellZ = 0; cellZ < sizeZ; ++cellZ)
+			{
+				unsigned int color = pLODColor[cellX + sizeX * (cellY + sizeY * cellZ)];
+
+				if ((color & 0xFF000000) == 0)
+				{
+					continue;
+				}
+
+				float r = (color & 0x000000FF) / 255.0f;
+				float g = ((color & 0x0000FF00) >> 8) / 255.0f;
+				float b = ((color & 0x00FF0000) >> 16) / 255.0f;
+
+				if (m_isSingleMeshColor)
+				{
+					r = m_meshSingleColorR;
+					g = m_meshSingleColorG;
+					b = m_meshSingleColorB;
+				}
+
+				// The LOD voxel covers the same space as the source voxels, clamped to the matrix bounds
+				float minX = cellX * lodScale - BLOCK_RENDER_SIZE;
+				float minY = cellY * lodScale - BLOCK_RENDER_SIZE;
+				float minZ = cellZ * lodScale - BLOCK_RENDER_SIZE;
+				float maxX = ((cellX + 1) * lodScale < static_cast<int>(pMatrix->m_matrixSizeX) ? (cellX + 1) * lodScale : pMatrix->m_matrixSizeX) - BLOCK_RENDER_SIZE;
+				float maxY = ((cellY + 1) * lodScale < static_cast<int>(pMatrix->m_matrixSizeY) ? (cellY + 1) * lodScale : pMatrix->m_matrixSizeY) - BLOCK_RENDER_SIZE;
+				float maxZ = ((cellZ + 1) * lodScale < static_cast<int>(pMatrix->m_matrixSizeZ) ? (cellZ + 1) * lodScale : pMatrix->m_matrixSizeZ) - BLOCK_RENDER_SIZE;
+
+				glm::vec3 p1(minX, minY, maxZ);
+				glm::vec3 p2(maxX, minY, maxZ);
+				glm::vec3 p3(maxX, maxY, maxZ);
+				glm::vec3 p4(minX, maxY, maxZ);
+				glm::vec3 p5(maxX, minY, minZ);
+				glm::vec3 p6(minX, minY, minZ);
+				glm::vec3 p7(minX, maxY, minZ);
+				glm::vec3 p8(maxX, maxY, minZ);
+
+				// Front
+				if (cellZ == sizeZ - 1 || (pLODColor[cellX + sizeX * (cellY + sizeY * (cellZ + 1))] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p1, p2, p3, p4, glm::vec3(0.0f, 0.0f, 1.0f), r, g, b);
+				}
+
+				// Back
+				if (cellZ == 0 || (pLODColor[cellX + sizeX * (cellY + sizeY * (cellZ - 1))] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p5, p6, p7, p8, glm::vec3(0.0f, 0.0f, -1.0f), r, g, b);
+				}
+
+				// Right
+				if (cellX == sizeX - 1 || (pLODColor[(cellX + 1) + sizeX * (cellY + sizeY * cellZ)] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p2, p5, p8, p3, glm::vec3(1.0f, 0.0f, 0.0f), r, g, b);
+				}
+
+				// Left
+				if (cellX == 0 || (pLODColor[(cellX - 1) + sizeX * (cellY + sizeY * cellZ)] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p6, p1, p4, p7, glm::vec3(-1.0f, 0.0f, 0.0f), r, g, b);
+				}
+
+				// Top
+				if (cellY == sizeY - 1 || (pLODColor[cellX + sizeX * ((cellY + 1) + sizeY * cellZ)] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p4, p3, p8, p7, glm::vec3(0.0f, 1.0f, 0.0f), r, g, b);
+				}
+
+				// Bottom
+				if (cellY == 0 || (pLODColor[cellX + sizeX * ((cellY - 1) + sizeY * cellZ)] & 0xFF000000) == 0)
+				{
+					AddLODFace(pMesh, p6, p5, p2, p1, glm::vec3(0.0f, -1.0f, 0.0f), r, g, b);
+				}
+			}
+		}
+	}
+
+	delete[] pLODColor;
+}
+
+void QubicleBinary::ClearLODMeshes(QubicleMatrix* pMatrix) const
+{
+	for (int i = 0; i < QUBICLE_NUM_LOD_MESHES; ++i)
+	{
+		if (pMatrix->m_pLODMesh[i] != nullptr)
+		{
+			m_pRenderer->ClearMesh(pMatrix->m_pLODMesh[i]);
+			pMatrix->m_pLODMesh[i] = nullptr;
+		}
+	}
+}
+
+
+int QubicleBinary::CalculateLODLevel(float distanceToCamera, float radius, float lodBias)
+{
+	// A LOD bias of zero (or less) disables the LOD meshes
+	if (lodBias <= 0.0f)
+	{
+		return 0;
+	}
+
+	// Scale the LOD distance by the object size, so larger objects keep their detail for longer
+	float lodDistance = distanceToCamera / ((radius < 1.0f ? 1.0f : radius) * lodBias);
+
+	if (lodDistance > LOD2_DISTANCE)
+	{
+		return 2;
+	}
+	if (lodDistance > LOD1_DISTANCE)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+void QubicleBinary::AddLODFace(TriangleMesh* pMesh, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, glm::vec3 p4, glm::vec3 normal, float r, float g, float b) const
+{
+	unsigned int v1 = m_pRenderer->AddVertexToMesh(p1, normal, r, g, b, 1.0f, pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+	unsigned int v2 = m_pRenderer->AddVertexToMesh(p2, normal, r, g, b, 1.0f, pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+	unsigned int v3 = m_pRenderer->AddVertexToMesh(p3, normal, r, g, b, 1.0f, pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+	unsigned int v4 = m_pRenderer->AddVertexToMesh(p4, normal, r, g, b, 1.0f, pMesh);
+	m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+	m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+	m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+}
+
+TriangleMesh* QubicleBinary::GetRenderMesh(QubicleMatrix* pMatrix, int lodLevel) const
+{
+	// Models without LOD meshes always draw at full detail
+	if (lodLevel > 0 && lodLevel <= QUBICLE_NUM_LOD_MESHES && pMatrix->m_pLODMesh[lodLevel - 1] != nullptr)
+	{
+		return pMatrix->m_pLODMesh[lodLevel - 1];
+	}
+
+	return pMatrix->m_pMesh;
+}
+
 #pragma warning(push)
 #pragma warning(disable:4018)
 
@@ -1095,6 +1636,41 @@ void QubicleBinary::UpdateMergedSide(int* merged, int matrixIndex, int blockX, i
 
 #pragma warning(pop)
 
+unsigned int QubicleBinary::GetMemorySize() const
+{
+	unsigned int memorySize = sizeof(QubicleBinary);
+
+	for (size_t i = 0; i < m_vpMatrices.size(); ++i)
+	{
+		QubicleMatrix* pMatrix = m_vpMatrices[i];
+
+		if (pMatrix == nullptr)
+		{
+			continue;
+		}
+
+		memorySize += sizeof(QubicleMatrix) + pMatrix->m_nameLength + 1;
+		memorySize += sizeof(unsigned int) * pMatrix->m_matrixSizeX * pMatrix->m_matrixSizeY * pMatrix->m_matrixSizeZ;
+
+		TriangleMesh* pMeshes[QUBICLE_NUM_LOD_MESHES + 1] = { pMatrix->m_pMesh, pMatrix->m_pLODMesh[0], pMatrix->m_pLODMesh[1] };
+
+		for (int j = 0; j < QUBICLE_NUM_LOD_MESHES + 1; ++j)
+		{
+			if (pMeshes[j] == nullptr)
+			{
+				continue;
+			}
+
+			memorySize += sizeof(TriangleMesh);
+			memorySize += pMeshes[j]->vertices.size() * (sizeof(MeshVertex) + sizeof(MeshVertex*));
+			memorySize += pMeshes[j]->textureCoordinates.size() * (sizeof(MeshTextureCoordinate) + sizeof(MeshTextureCoordinate*));
+			memorySize += pMeshes[j]->triangles.size() * (sizeof(MeshTriangle) + sizeof(MeshTriangle*));
+		}
+	}
+
+	return memorySize;
+}
+
 int QubicleBinary::GetNumMatrices() const
 {
 	return m_numMatrices;
@@ -1266,6 +1842,75 @@ std::string QubicleBinary::GetSubSelectionName(unsigned int pickingID)
 	return "";
 }
 
+int QubicleBinary::GetSubSelectionRayPicking(const glm::vec3& origin, const glm::vec3& direction, float* pDistance)
+{
+	if (m_isLoaded == false)
+	{
+		return -1;
+	}
+
+	int pickingID = -1;
+	float nearestDistance = 0.0f;
+
+	for (unsigned int i = 0; i < m_numMatrices; ++i)
+	{
+		QubicleMatrix* pMatrix = m_vpMatrices[i];
+
+		if (pMatrix->m_isRemoved == true)
+		{
+			continue;
+		}
+
+		// Into the matrix's own space, where its blocks fill a box one unit per block. The distance along the ray is the same in both spaces.
+		Matrix4 inverseModelMatrix = pMatrix->m_modelMatrix.GetInverse();
+		glm::vec3 localOrigin;
+		glm::vec3 localEnd;
+		Matrix4::Multiply(inverseModelMatrix, origin, localOrigin);
+		Matrix4::Multiply(inverseModelMatrix, origin + direction, localEnd);
+		glm::vec3 localDirection = localEnd - localOrigin;
+
+		glm::vec3 boxMin = glm::vec3(-BLOCK_RENDER_SIZE);
+		glm::vec3 boxMax = glm::vec3(pMatrix->m_matrixSizeX - BLOCK_RENDER_SIZE, pMatrix->m_matrixSizeY - BLOCK_RENDER_SIZE, pMatrix->m_matrixSizeZ - BLOCK_RENDER_SIZE);
+
+		float enter = 0.0f;
+		float exit = std::numeric_limits<float>::max();
+		bool isHit = true;
+
+		for (int axis = 0; axis < 3 && isHit; ++axis)
+		{
+			if (std::abs(localDirection[axis]) < 0.000001f)
+			{
+				isHit = localOrigin[axis] >= boxMin[axis] && localOrigin[axis] <= boxMax[axis];
+				continue;
+			}
+
+			float axisEnter = (boxMin[axis] - localOrigin[axis]) / localDirection[axis];
+			float axisExit = (boxMax[axis] - localOrigin[axis]) / localDirection[axis];
+			if (axisEnter > axisExit)
+			{
+				std::swap(axisEnter, axisExit);
+			}
+
+			enter = std::max(enter, axisEnter);
+			exit = std::min(exit, axisExit);
+			isHit = enter <= exit;
+		}
+
+		if (isHit && (pickingID == -1 || enter < nearestDistance))
+		{
+			pickingID = SUBSELECTION_NAMEPICKING_OFFSET + i;
+			nearestDistance = enter;
+		}
+	}
+
+	if (pickingID != -1)
+	{
+		*pDistance = nearestDistance;
+	}
+
+	return pickingID;
+}
+
 // Rendering modes
 void QubicleBinary::SetWireFrameRender(bool wireframe)
 {
@@ -1273,7 +1918,7 @@ void QubicleBinary::SetWireFrameRender(bool wireframe)
 }
 
 //Rendering
-void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor)
+void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel)
 {
 	m_pRenderer->PushMatrix();
 
@@ -1351,11 +1996,11 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 		if (renderOutline || silhouette)
 		{
 			m_pRenderer->EndMeshRender();
-			m_pRenderer->RenderMeshNoColor(m_vpMatrices[i]->m_pMesh);
+			m_pRenderer->RenderMeshNoColor(GetRenderMesh(m_vpMatrices[i], lodLevel));
 		}
 		else
 		{
-			m_pRenderer->MeshStaticBufferRender(m_vpMatrices[i]->m_pMesh);
+			m_pRenderer->MeshStaticBufferRender(GetRenderMesh(m_vpMatrices[i], lodLevel));
 		}
 
 		if (m_meshAlpha < 1.0f)
@@ -1381,7 +2026,7 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 	m_pRenderer->PopMatrix();
 }
 
-void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Color outlineColor, bool subSelectionNamePicking)
+void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Color outlineColor, bool subSelectionNamePicking, int lodLevel)
 {
 	if (pVoxelCharacter == nullptr)
 	{
@@ -1585,11 +2230,11 @@ void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter*
 		if (renderOutline || silhouette)
 		{
 			m_pRenderer->EndMeshRender();
-			m_pRenderer->RenderMeshNoColor(m_vpMatrices[i]->m_pMesh);
+			m_pRenderer->RenderMeshNoColor(GetRenderMesh(m_vpMatrices[i], lodLevel));
 		}
 		else
 		{
-			m_pRenderer->MeshStaticBufferRender(m_vpMatrices[i]->m_pMesh);
+			m_pRenderer->MeshStaticBufferRender(GetRenderMesh(m_vpMatrices[i], lodLevel));
 		}
 
 		if (m_meshAlpha < 1.0f)
@@ -32,6 +32,9 @@ bool IsMergedYPositive(int* merged, int x, int y, int z, int width, int height);
 bool IsMergedZNegative(int* merged, int x, int y, int z, int width, int height);
 bool IsMergedZPositive(int* merged, int x, int y, int z, int width, int height);
 
+// Number of downsampled meshes that can be created for each matrix, on top of the full resolution mesh
+const int QUBICLE_NUM_LOD_MESHES = 2;
+
 struct QubicleMatrix
 {
 	QubicleMatrix() :
@@ -40,7 +43,7 @@ struct QubicleMatrix
 		m_matrixPosX(0), m_matrixPosY(0), m_matrixPosZ(0),
 		m_pColor(nullptr), m_boneIndex(0), m_scale(0),
 		m_offsetX(0.0f), m_offsetY(0.0f), m_offsetZ(0.0f),
-		m_isRemoved(false), m_pMesh(nullptr)
+		m_isRemoved(false), m_pMesh(nullptr), m_pLODMesh{ nullptr, nullptr }
 	{
 	}
 
@@ -101,6 +104,7 @@ struct QubicleMatrix
 	bool m_isRemoved;
 
 	TriangleMesh* m_pMesh;
+	TriangleMesh* m_pLODMesh[QUBICLE_NUM_LOD_MESHES];
 };
 
 using QubicleMatrixList = std::vector<QubicleMatrix*>;
@@ -120,6 +124,9 @@ public:
 	void Reset();
 
 	std::string GetFileName() const;
+	void SetFileName(const char* fileName);
+
+	bool IsLoaded() const;
 
 	unsigned int GetMaterial() const;
 
@@ -128,21 +135,47 @@ public:
 	int GetMatrixIndexForName(const char* matrixName);
 	void GetMatrixPosition(int index, int* aX, int* aY, int* aZ);
 
-	bool Import(const char* fileName, bool faceMerging);
+	bool Import(const char* fileName, bool faceMerging, bool createLODMeshes = false);
+	// Decoding only reads the voxel data and doesn't touch the renderer, so it can run on a loader thread.
+	// FinishImport() then builds the meshes on the render thread.
+	bool Decode(const char* fileName);
+	bool DecodeFromMemory(const unsigned char* pData, size_t dataSize);
+	bool FinishImport(bool faceMerging, bool createLODMeshes = false);
+	// Background import, PrepareImport() decodes and builds the meshes on a loader thread, CompleteImport() uploads them on the render thread
+	bool PrepareImport(const char* fileName, bool faceMerging, bool createLODMeshes = false);
+	bool CompleteImport();
+	bool ImportFromBinary(QubicleBinary* pSource, bool faceMerging, bool createLODMeshes = false);
 	bool Export(const char* fileName);
 
 	void GetColor(int matrixIndex, int x, int y, int z, float* r, float* g, float* b, float* a);
 	unsigned int GetColorCompact(int matrixIndex, int x, int y, int z);
 	bool GetSingleMeshColor(float* r, float* g, float* b, float* a) const;
+	float GetMeshAlpha() const;
 	bool GetActive(int matrixIndex, int x, int y, int z);
 
 	void SetMeshAlpha(float alpha);
 	void SetMeshSingleColor(float r, float g, float b);
 
 	void CreateMesh(bool doFaceMerging);
+	// BuildMesh() only fills in the CPU side meshes, UploadMesh() sends them to the GPU
+	void BuildMesh(bool doFaceMerging);
+	void UploadMesh();
 	void RebuildMesh(bool doFaceMerging);
 	void UpdateMergedSide(int* merged, int matrixIndex, int blockX, int blockY, int blockZ, int width, int height, glm::vec3* p1, glm::vec3* p2, glm::vec3* p3, glm::vec3* p4, int startX, int startY, int maxX, int maxY, bool isPositive, bool zFace, bool xFace, bool yFace);
 
+	// Level of detail, only models that are drawn from a distance need the LOD meshes
+	void SetCreateLODMeshes(bool createLODMeshes);
+	bool IsCreateLODMeshes() const;
+	// Adds the LOD meshes to a model that was imported without them, once it has finished loading
+	void RequestLODMeshes();
+	void CreateLODMeshes();
+	void CreateLODMesh(QubicleMatrix* pMatrix, int lodLevel);
+	void ClearLODMeshes(QubicleMatrix* pMatrix) const;
+	static int CalculateLODLevel(float distanceToCamera, float radius, float lodBias);
+
+	// Memory usage of the voxel data and meshes, in bytes
+	unsigned int GetMemorySize() const;
+
 	int GetNumMatrices() const;
 	QubicleMatrix* GetQubicleMatrix(int index);
 	QubicleMatrix* GetQubicleMatrix(const char* matrixName);
@@ -163,13 +196,16 @@ public:
 
 	// Sub selection
 	std::string GetSubSelectionName(unsigned int pickingID);
+	// Sub selection picking ID of the nearest matrix the ray hits, tested against the box of each matrix where it was last
+	// rendered. Returns -1 when the ray misses every matrix, otherwise pDistance is set to the distance along the ray.
+	int GetSubSelectionRayPicking(const glm::vec3& origin, const glm::vec3& direction, float* pDistance);
 
 	// Rendering modes
 	void SetWireFrameRender(bool wireframe);
 
-	// Rendering
-	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlixneColor);
-	void RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Color outlineColor, bool subSelectionNamePicking);
+	// Rendering, lodLevel 0 is the full detail mesh
+	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel = 0);
+	void RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Color outlineColor, bool subSelectionNamePicking, int lodLevel = 0);
 	void RenderSingleMatrix(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, std::string matrixName, bool renderOutline, bool silhouette, Color outlineColor);
 	void RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale = true, bool useTranslate = true);
 	void RenderPaperdoll(MS3DAnimator* pSkeletonLeft, MS3DAnimator* pSkeletonRight, VoxelCharacter* pVoxelCharacter);
@@ -177,8 +213,13 @@ public:
 
 	static const float BLOCK_RENDER_SIZE;
 	static const int SUBSELECTION_NAMEPICKING_OFFSET = 10000000;
+	static const float LOD1_DISTANCE;
+	static const float LOD2_DISTANCE;
 
 private:
+	void AddLODFace(TriangleMesh* pMesh, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, glm::vec3 p4, glm::vec3 normal, float r, float g, float b) const;
+	TriangleMesh* GetRenderMesh(QubicleMatrix* pMatrix, int lodLevel) const;
+
 	Renderer* m_pRenderer;
 
 	// Loaded flag
@@ -212,6 +253,10 @@ private:
 
 	// Material
 	unsigned int m_materialID;
+
+	// Level of detail
+	bool m_isCreateLODMeshes;
+	bool m_isLODMeshesRequested;
 };
 
 
@@ -7,9 +7,30 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <Utils/AssetLoader.h>
+
 #include "QubicleBinaryManager.h"
 
-QubicleBinaryManager::QubicleBinaryManager(Renderer* pRenderer)
+// Loader thread half of a background load, decodes the file and builds the meshes
+static bool LoadQubicleBinaryAsync(void* pAsset)
+{
+	QubicleBinary* pQubicleBinary = static_cast<QubicleBinary*>(pAsset);
+	std::string fileName = pQubicleBinary->GetFileName();
+
+	return pQubicleBinary->PrepareImport(fileName.c_str(), true, pQubicleBinary->IsCreateLODMeshes());
+}
+
+// Main thread half of a background load, uploads the meshes
+static void UploadQubicleBinaryAsync(void* pAsset, bool isLoaded)
+{
+	if (isLoaded)
+	{
+		static_cast<QubicleBinary*>(pAsset)->CompleteImport();
+	}
+}
+
+QubicleBinaryManager::QubicleBinaryManager(Renderer* pRenderer) :
+	m_numPrivateInstances(0)
 {
 	m_pRenderer = pRenderer;
 }
@@ -21,40 +42,287 @@ QubicleBinaryManager::~QubicleBinaryManager()
 
 void QubicleBinaryManager::ClearQubicleBinaryList()
 {
-	for (unsigned int i = 0; i < m_vpQubicleBinaryList.size(); ++i)
+	m_qubicleBinaryCacheMutex.lock();
+
+	for (auto iter = m_qubicleBinaryCache.begin(); iter != m_qubicleBinaryCache.end(); ++iter)
 	{
-		delete m_vpQubicleBinaryList[i];
-		m_vpQubicleBinaryList[i] = nullptr;
+		delete iter->second.m_pQubicleBinary;
+		iter->second.m_pQubicleBinary = nullptr;
 	}
 
-	m_vpQubicleBinaryList.clear();
+	m_qubicleBinaryCache.clear();
+
+	m_qubicleBinaryCacheMutex.unlock();
 }
 
-QubicleBinary* QubicleBinaryManager::GetQubicleBinaryFile(const char* fileName, bool refreshModel)
+QubicleBinary* QubicleBinaryManager::GetQubicleBinaryFile(const char* fileName, bool refreshModel, bool createLODMeshes)
 {
-	for (unsigned int i = 0; i < m_vpQubicleBinaryList.size(); ++i)
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = m_qubicleBinaryCache.find(fileName);
+
+	bool isNewFile = iter == m_qubicleBinaryCache.end();
+	if (isNewFile)
 	{
-		if (strcmp(m_vpQubicleBinaryList[i]->GetFileName().c_str(), fileName) == 0)
-		{
-			if (refreshModel)
-			{
-				m_vpQubicleBinaryList[i]->Reset();
-				m_vpQubicleBinaryList[i]->Import(fileName, true);
-			}
+		// Only registered while holding the lock, the import is waited for below so other models can be got meanwhile.
+		// Anyone else asking for it before it is ready waits for the same load.
+		AddQubicleBinaryFileAsync(fileName, createLODMeshes);
+		iter = m_qubicleBinaryCache.find(fileName);
+	}
 
-			return m_vpQubicleBinaryList[i];
-		}
+	iter->second.m_referenceCount++;
+
+	QubicleBinary* pQubicleBinary = iter->second.m_pQubicleBinary;
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	// Loads it here if no loader thread has started on it yet, without the lock so the other threads can use the cache meanwhile
+	WaitForQubicleBinaryFile(pQubicleBinary);
+
+	if (refreshModel && isNewFile == false)
+	{
+		bool isCreateLODMeshes = createLODMeshes || pQubicleBinary->IsCreateLODMeshes();
+		pQubicleBinary->Reset();
+		pQubicleBinary->Import(fileName, true, isCreateLODMeshes);
+	}
+
+	if (createLODMeshes)
+	{
+		pQubicleBinary->RequestLODMeshes();
+	}
+
+	return pQubicleBinary;
+}
+
+QubicleBinary* QubicleBinaryManager::GetQubicleBinaryFileAsync(const char* fileName, bool createLODMeshes)
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = m_qubicleBinaryCache.find(fileName);
+
+	if (iter == m_qubicleBinaryCache.end())
+	{
+		AddQubicleBinaryFileAsync(fileName, createLODMeshes);
+		iter = m_qubicleBinaryCache.find(fileName);
+	}
+	else if (createLODMeshes)
+	{
+		// Already cached without them, they are added once the model has loaded
+		iter->second.m_pQubicleBinary->RequestLODMeshes();
+	}
+
+	iter->second.m_referenceCount++;
+
+	QubicleBinary* pQubicleBinary = iter->second.m_pQubicleBinary;
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	return pQubicleBinary;
+}
+
+void QubicleBinaryManager::PrefetchQubicleBinaryFile(const char* fileName)
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	if (m_qubicleBinaryCache.find(fileName) == m_qubicleBinaryCache.end())
+	{
+		AddQubicleBinaryFileAsync(fileName, false);
+	}
+
+	m_qubicleBinaryCacheMutex.unlock();
+}
+
+void QubicleBinaryManager::WaitForQubicleBinaryFile(QubicleBinary* pQubicleBinary) const
+{
+	if (pQubicleBinary != nullptr && pQubicleBinary->IsLoaded() == false)
+	{
+		AssetLoader::GetInstance()->WaitForAsset(pQubicleBinary);
+	}
+}
+
+QubicleBinary* QubicleBinaryManager::AddQubicleBinaryFileAsync(const char* fileName, bool createLODMeshes)
+{
+	// The model goes in the cache straight away, so later requests for the same file share the load
+	QubicleBinary* pNewQubicleBinary = new QubicleBinary(m_pRenderer);
+	pNewQubicleBinary->SetFileName(fileName);
+	pNewQubicleBinary->SetCreateLODMeshes(createLODMeshes);
+
+	QubicleBinaryCacheEntry newEntry;
+	newEntry.m_pQubicleBinary = pNewQubicleBinary;
+	newEntry.m_referenceCount = 0;
+
+	m_qubicleBinaryCache[fileName] = newEntry;
+
+	AssetLoader::GetInstance()->QueueLoad(pNewQubicleBinary, LoadQubicleBinaryAsync, UploadQubicleBinaryAsync);
+
+	return pNewQubicleBinary;
+}
+
+void QubicleBinaryManager::ReleaseQubicleBinaryFile(QubicleBinary* pQubicleBinary)
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = FindCacheEntry(pQubicleBinary);
+
+	// Unreferenced models stay cached until ClearQubicleBinaryList(), their matrices can still be lent out to characters
+	if (iter != m_qubicleBinaryCache.end() && iter->second.m_referenceCount > 0)
+	{
+		iter->second.m_referenceCount--;
 	}
 
-	return AddQubicleBinaryFile(fileName);
+	m_qubicleBinaryCacheMutex.unlock();
+}
+
+void QubicleBinaryManager::RefreshQubicleBinaryFile(const char* fileName)
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = m_qubicleBinaryCache.find(fileName);
+	QubicleBinary* pQubicleBinary = iter != m_qubicleBinaryCache.end() ? iter->second.m_pQubicleBinary : nullptr;
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	if (pQubicleBinary != nullptr)
+	{
+		WaitForQubicleBinaryFile(pQubicleBinary);
+
+		bool isCreateLODMeshes = pQubicleBinary->IsCreateLODMeshes();
+		pQubicleBinary->Reset();
+		pQubicleBinary->Import(fileName, true, isCreateLODMeshes);
+	}
 }
 
-QubicleBinary* QubicleBinaryManager::AddQubicleBinaryFile(const char* fileName)
+QubicleBinary* QubicleBinaryManager::CreateQubicleBinaryInstance(const char* fileName, bool createLODMeshes)
 {
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = m_qubicleBinaryCache.find(fileName);
+
+	if (iter == m_qubicleBinaryCache.end())
+	{
+		AddQubicleBinaryFileAsync(fileName, false);
+		iter = m_qubicleBinaryCache.find(fileName);
+	}
+
+	QubicleBinary* pSourceQubicleBinary = iter->second.m_pQubicleBinary;
+
+	m_numPrivateInstances++;
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	WaitForQubicleBinaryFile(pSourceQubicleBinary);
+
 	QubicleBinary* pNewQubicleBinary = new QubicleBinary(m_pRenderer);
-	pNewQubicleBinary->Import(fileName, true);
+	pNewQubicleBinary->ImportFromBinary(pSourceQubicleBinary, true, createLODMeshes);
+
+	return pNewQubicleBinary;
+}
+
+void QubicleBinaryManager::DestroyQubicleBinaryInstance(QubicleBinary* pQubicleBinary)
+{
+	if (pQubicleBinary == nullptr)
+	{
+		return;
+	}
+
+	m_qubicleBinaryCacheMutex.lock();
+	m_numPrivateInstances--;
+	m_qubicleBinaryCacheMutex.unlock();
+
+	delete pQubicleBinary;
+}
+
+QubicleBinary* QubicleBinaryManager::DetachQubicleBinaryFile(QubicleBinary* pQubicleBinary)
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	auto iter = FindCacheEntry(pQubicleBinary);
+
+	if (iter == m_qubicleBinaryCache.end())
+	{
+		m_qubicleBinaryCacheMutex.unlock();
+
+		return pQubicleBinary;
+	}
+
+	// The cached model stays behind even when we were its only user, so the next request doesn't go back to the disk
+	if (iter->second.m_referenceCount > 0)
+	{
+		iter->second.m_referenceCount--;
+	}
+
+	m_numPrivateInstances++;
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	WaitForQubicleBinaryFile(pQubicleBinary);
 
-	m_vpQubicleBinaryList.push_back(pNewQubicleBinary);
+	QubicleBinary* pNewQubicleBinary = new QubicleBinary(m_pRenderer);
+	pNewQubicleBinary->ImportFromBinary(pQubicleBinary, true, pQubicleBinary->IsCreateLODMeshes());
 
 	return pNewQubicleBinary;
-}
\ No newline at end of file
+}
+
+// Statistics
+int QubicleBinaryManager::GetNumUniqueModels()
+{
+	m_qubicleBinaryCacheMutex.lock();
+	int numUniqueModels = static_cast<int>(m_qubicleBinaryCache.size());
+	m_qubicleBinaryCacheMutex.unlock();
+
+	return numUniqueModels;
+}
+
+int QubicleBinaryManager::GetNumModelInstances()
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	int numInstances = m_numPrivateInstances;
+
+	for (auto iter = m_qubicleBinaryCache.begin(); iter != m_qubicleBinaryCache.end(); ++iter)
+	{
+		numInstances += iter->second.m_referenceCount;
+	}
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	return numInstances;
+}
+
+unsigned int QubicleBinaryManager::GetNumBytesSaved()
+{
+	m_qubicleBinaryCacheMutex.lock();
+
+	unsigned int bytesSaved = 0;
+
+	// Every extra reference to a cached model would otherwise have been its own copy
+	for (auto iter = m_qubicleBinaryCache.begin(); iter != m_qubicleBinaryCache.end(); ++iter)
+	{
+		// Models that are still loading in the background can't be touched yet
+		if (iter->second.m_referenceCount > 1 && iter->second.m_pQubicleBinary->IsLoaded())
+		{
+			bytesSaved += (iter->second.m_referenceCount - 1) * iter->second.m_pQubicleBinary->GetMemorySize();
+		}
+	}
+
+	m_qubicleBinaryCacheMutex.unlock();
+
+	return bytesSaved;
+}
+
+QubicleBinaryCache::iterator QubicleBinaryManager::FindCacheEntry(QubicleBinary* pQubicleBinary)
+{
+	if (pQubicleBinary == nullptr)
+	{
+		return m_qubicleBinaryCache.end();
+	}
+
+	auto iter = m_qubicleBinaryCache.find(pQubicleBinary->GetFileName());
+
+	if (iter != m_qubicleBinaryCache.end() && iter->second.m_pQubicleBinary == pQubicleBinary)
+	{
+		return iter;
+	}
+
+	return m_qubicleBinaryCache.end();
+}
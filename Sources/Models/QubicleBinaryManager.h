@@ -10,9 +10,19 @@
 #ifndef CUBBY_QUBICLE_BINARY_MANAGER_H
 #define CUBBY_QUBICLE_BINARY_MANAGER_H
 
+#include <unordered_map>
+
+#include <tinythread/tinythread.h>
+
 #include "QubicleBinary.h"
 
-using QubicleBinaryList = std::vector<QubicleBinary*>;
+struct QubicleBinaryCacheEntry
+{
+	QubicleBinary* m_pQubicleBinary;
+	int m_referenceCount;
+};
+
+using QubicleBinaryCache = std::unordered_map<std::string, QubicleBinaryCacheEntry>;
 
 class QubicleBinaryManager
 {
@@ -23,15 +33,46 @@ public:
 
 	void ClearQubicleBinaryList();
 
-	// Getter
-	QubicleBinary* GetQubicleBinaryFile(const char* fileName, bool refreshModel);
+	// Getter, createLODMeshes adds the LOD meshes for models that are drawn from a distance. Returns once the model is loaded,
+	// off the main thread like WaitForQubicleBinaryFile() that is the voxel data and the meshes are uploaded later.
+	QubicleBinary* GetQubicleBinaryFile(const char* fileName, bool refreshModel, bool createLODMeshes = false);
+
+	// Background loading, the returned model can't be used until IsLoaded() is true or WaitForQubicleBinaryFile() has been called.
+	// Off the main thread the wait only covers the voxel data, the meshes are still uploaded later by the main thread.
+	QubicleBinary* GetQubicleBinaryFileAsync(const char* fileName, bool createLODMeshes = false);
+	void PrefetchQubicleBinaryFile(const char* fileName);
+	void WaitForQubicleBinaryFile(QubicleBinary* pQubicleBinary) const;
 
 	// Operations
-	QubicleBinary* AddQubicleBinaryFile(const char* fileName);
+	void ReleaseQubicleBinaryFile(QubicleBinary* pQubicleBinary);
+	void RefreshQubicleBinaryFile(const char* fileName);
+
+	// Private instances, created from the cached voxel data instead of parsing the file again
+	QubicleBinary* CreateQubicleBinaryInstance(const char* fileName, bool createLODMeshes = false);
+	void DestroyQubicleBinaryInstance(QubicleBinary* pQubicleBinary);
+
+	// Copy-on-write, returns a model that the caller owns and is free to modify
+	QubicleBinary* DetachQubicleBinaryFile(QubicleBinary* pQubicleBinary);
+
+	// Statistics
+	int GetNumUniqueModels();
+	int GetNumModelInstances();
+	unsigned int GetNumBytesSaved();
 
 private:
+	// The cache lock must be held when adding a file, the file is only queued for loading so the lock is held briefly
+	QubicleBinary* AddQubicleBinaryFileAsync(const char* fileName, bool createLODMeshes);
+
+	QubicleBinaryCache::iterator FindCacheEntry(QubicleBinary* pQubicleBinary);
+
 	Renderer* m_pRenderer;
-	QubicleBinaryList m_vpQubicleBinaryList;
+
+	// Models are requested from the chunk threads as well as the main thread
+	QubicleBinaryCache m_qubicleBinaryCache;
+	tthread::mutex m_qubicleBinaryCacheMutex;
+
+	// Number of privately owned models that are alive
+	int m_numPrivateInstances;
 };
 
-#endif
\ No newline at end of file
+#endif
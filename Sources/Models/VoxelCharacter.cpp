@@ -7,19 +7,22 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 
 #include <glm/detail/func_geometric.hpp>
 
+#include <Utils/AssetPack.h>
 #include <Utils/Interpolator.h>
 #include <Utils/Random.h>
 
+#include "MS3DModelManager.h"
 #include "VoxelCharacter.h"
 
 // Constructor, Destructor
 VoxelCharacter::VoxelCharacter(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager) :
-	m_pRenderer(pRenderer), m_pQubicleBinaryManager(pQubicleBinaryManager)
+	m_pRenderer(pRenderer), m_pQubicleBinaryManager(pQubicleBinaryManager), m_isCreateLODMeshes(false)
 {
 	
 	Reset();
@@ -39,6 +42,11 @@ void VoxelCharacter::Reset()
 
 	m_updateAnimator = true;
 
+	m_animationUpdateTier = AnimationUpdateTier::Full;
+	m_isRenderVisible = true;
+
+	m_renderLODLevel = 0;
+
 	m_renderRightWeapon = false;
 	m_renderLeftWeapon = false;
 
@@ -68,8 +76,8 @@ void VoxelCharacter::Reset()
 	m_isBreathingAnimationStarted = false;
 	m_breathingBodyYOffset = 0.0f;
 	m_breathingHandsYOffset = 0.0f;
-	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_breathingBodyYOffset);
-	Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_breathingHandsYOffset);
+	Interpolator::GetInstance()->RemoveInterpolation(m_breathingBodyYInterpolation);
+	Interpolator::GetInstance()->RemoveInterpolation(m_breathingHandsYInterpolation);
 	m_breathingAnimationInitialWaitTime = GetRandomNumber(0, 100, 2) * 0.01f;
 
 	// Facial expressions
@@ -136,17 +144,15 @@ void VoxelCharacter::LoadVoxelCharacter(const char* characterType, const char* q
 	// Qubicle model
 	if (useQubicleManager)
 	{
-		m_pVoxelModel = m_pQubicleBinaryManager->GetQubicleBinaryFile(qbFileName, false);
+		m_pVoxelModel = m_pQubicleBinaryManager->GetQubicleBinaryFile(qbFileName, false, m_isCreateLODMeshes);
 	}
 	else
 	{
-		m_pVoxelModel = new QubicleBinary(m_pRenderer);
-		m_pVoxelModel->Import(qbFileName, true);
+		m_pVoxelModel = m_pQubicleBinaryManager->CreateQubicleBinaryInstance(qbFileName, m_isCreateLODMeshes);
 	}
 
-	// MS3d model
-	m_pCharacterModel = new MS3DModel(m_pRenderer);
-	m_pCharacterModel->LoadModel(modelFileName);
+	// MS3d model, the skeleton and keyframes are shared between all characters using the same file
+	m_pCharacterModel = MS3DModelManager::GetInstance()->GetMS3DModel(m_pRenderer, modelFileName);
 
 	// Animators
 	for (int i = 0; i < static_cast<int>(AnimationSections::NumSections); ++i)
@@ -185,6 +191,12 @@ void VoxelCharacter::SaveVoxelCharacter(const char* qbFileName, const char* face
 	// Qubicle model
 	m_pVoxelModel->Export(qbFileName);
 
+	// Make sure the cached copy doesn't go stale, a shared model already matches what we just saved
+	if (m_usingQubicleManager == false)
+	{
+		m_pQubicleBinaryManager->RefreshQubicleBinaryFile(qbFileName);
+	}
+
 	// Faces
 	SaveFaces(facesFileName);
 
@@ -196,13 +208,17 @@ void VoxelCharacter::UnloadCharacter()
 {
 	if (m_isLoaded)
 	{
-		if (m_usingQubicleManager == false)
+		if (m_usingQubicleManager)
 		{
-			delete m_pVoxelModel;
+			m_pQubicleBinaryManager->ReleaseQubicleBinaryFile(m_pVoxelModel);
+		}
+		else
+		{
+			m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pVoxelModel);
 		}
 
 		m_pVoxelModel = nullptr;
-		delete m_pCharacterModel;
+		MS3DModelManager::GetInstance()->ReleaseMS3DModel(m_pCharacterModel);
 		m_pCharacterModel = nullptr;
 		for (int i = 0; i < static_cast<int>(AnimationSections::NumSections); ++i)
 		{
@@ -255,12 +271,10 @@ void VoxelCharacter::RebuildVoxelModel(bool faceMerge) const
 // Faces
 bool VoxelCharacter::LoadFaces(const char* characterType, const char* facesFileName, const char* charactersBaseFolder)
 {
-	std::ifstream file;
-
-	// Open the file
-	file.open(facesFileName, std::ios::in);
+	// Open the file, from the asset pack if it is packed
+	std::istringstream file;
 
-	if (file.is_open())
+	if (AssetPack::GetInstance()->OpenFile(facesFileName, &file))
 	{
 		std::string tempString;
 		int textureWidth, textureHeight, textureWidth2, textureHeight2;
@@ -323,8 +337,6 @@ bool VoxelCharacter::LoadFaces(const char* characterType, const char* facesFileN
 			m_pRenderer->LoadTexture(talkingMouthFileName, &textureWidth, &textureHeight, &textureWidth2, &textureHeight2, &m_pTalkingAnimations[i].talkingAnimationTexture);
 		}
 
-		file.close();
-
 		m_isLoadedFaces = true;
 
 		return true;
@@ -436,12 +448,10 @@ void VoxelCharacter::ModifyEyesTextures(const char* charactersBaseFolder, const
 // Character file
 void VoxelCharacter::LoadCharacterFile(const char* characterFileName)
 {
-	std::ifstream file;
-
-	// Open the file
-	file.open(characterFileName, std::ios::in);
+	// Open the file, from the asset pack if it is packed
+	std::istringstream file;
 
-	if (file.is_open())
+	if (AssetPack::GetInstance()->OpenFile(characterFileName, &file))
 	{
 		std::string tempString;
 		int numModifiers;
@@ -468,8 +478,6 @@ void VoxelCharacter::LoadCharacterFile(const char* characterFileName)
 
 			m_pVoxelModel->SetScaleAndOffsetForMatrix(matrixName.c_str(), scale, xOffset, yOffset, zOffset);
 		}
-
-		file.close();
 	}
 }
 
@@ -501,12 +509,10 @@ void VoxelCharacter::SaveCharacterFile(const char* characterFileName) const
 
 void VoxelCharacter::ResetMatrixParamsFromCharacterFile(const char* characterFileName, const char* matrixToReset) const
 {
-	std::ifstream file;
-
-	// Open the file
-	file.open(characterFileName, std::ios::in);
+	// Open the file, from the asset pack if it is packed
+	std::istringstream file;
 
-	if (file.is_open())
+	if (AssetPack::GetInstance()->OpenFile(characterFileName, &file))
 	{
 		std::string tempString;
 		int numModifiers;
@@ -529,13 +535,9 @@ void VoxelCharacter::ResetMatrixParamsFromCharacterFile(const char* characterFil
 			{
 				m_pVoxelModel->SetScaleAndOffsetForMatrix(matrixName.c_str(), scale, xOffset, yOffset, zOffset);
 
-				file.close();
-
 				return;
 			}
 		}
-
-		file.close();
 	}
 }
 
@@ -651,6 +653,58 @@ void VoxelCharacter::SetUpdateAnimator(bool update)
 	m_updateAnimator = update;
 }
 
+// Animation level of detail
+AnimationUpdateTier VoxelCharacter::CalculateAnimationUpdateTier(bool visible, float distanceToCamera, float reducedDistance)
+{
+	if (visible == false)
+	{
+		return AnimationUpdateTier::OnDemand;
+	}
+
+	if (distanceToCamera > reducedDistance)
+	{
+		return AnimationUpdateTier::Reduced;
+	}
+
+	return AnimationUpdateTier::Full;
+}
+
+void VoxelCharacter::SetAnimationUpdateTier(AnimationUpdateTier tier)
+{
+	m_animationUpdateTier = tier;
+}
+
+AnimationUpdateTier VoxelCharacter::GetAnimationUpdateTier() const
+{
+	return m_animationUpdateTier;
+}
+
+void VoxelCharacter::SetRenderVisible(bool visible)
+{
+	m_isRenderVisible = visible;
+}
+
+bool VoxelCharacter::IsRenderVisible() const
+{
+	return m_isRenderVisible;
+}
+
+// Mesh level of detail
+void VoxelCharacter::SetCreateLODMeshes(bool createLODMeshes)
+{
+	m_isCreateLODMeshes = createLODMeshes;
+}
+
+void VoxelCharacter::SetRenderLODLevel(int lodLevel)
+{
+	m_renderLODLevel = lodLevel;
+}
+
+int VoxelCharacter::GetRenderLODLevel() const
+{
+	return m_renderLODLevel;
+}
+
 Matrix4 VoxelCharacter::GetBoneMatrix(AnimationSections section, int index) const
 {
 	if (m_isLoaded)
@@ -786,6 +840,11 @@ void VoxelCharacter::SetMeshAlpha(float alpha, bool force)
 
 	if (m_pVoxelModel)
 	{
+		if (m_characterAlpha != m_pVoxelModel->GetMeshAlpha())
+		{
+			DetachSharedModel();
+		}
+
 		m_pVoxelModel->SetMeshAlpha(m_characterAlpha);
 	}
 
@@ -806,10 +865,18 @@ void VoxelCharacter::SetMeshAlpha(float alpha, bool force)
 	}
 }
 
-void VoxelCharacter::SetMeshSingleColor(float r, float g, float b) const
+void VoxelCharacter::SetMeshSingleColor(float r, float g, float b)
 {
 	if (m_pVoxelModel)
 	{
+		float currentR, currentG, currentB, currentA;
+		bool isSingleColor = m_pVoxelModel->GetSingleMeshColor(&currentR, &currentG, &currentB, &currentA);
+
+		if (isSingleColor == false || r != currentR || g != currentG || b != currentB)
+		{
+			DetachSharedModel();
+		}
+
 		m_pVoxelModel->SetMeshSingleColor(r, g, b);
 	}
 
@@ -830,6 +897,15 @@ void VoxelCharacter::SetMeshSingleColor(float r, float g, float b) const
 	}
 }
 
+void VoxelCharacter::DetachSharedModel()
+{
+	if (m_usingQubicleManager)
+	{
+		m_pVoxelModel = m_pQubicleBinaryManager->DetachQubicleBinaryFile(m_pVoxelModel);
+		m_usingQubicleManager = false;
+	}
+}
+
 // Breathing animation
 void VoxelCharacter::SetBreathingAnimationEnabled(bool enable)
 {
@@ -850,24 +926,28 @@ void VoxelCharacter::StartBreathAnimation()
 {
 	m_isBreathingAnimationStarted = true;
 
-	FloatInterpolation* bodyYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.35f, 1.5f, 100.0f);
-	FloatInterpolation* bodyYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.35f, 0.175f, 0.0f);
-	FloatInterpolation* bodyYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.0f, 1.5f, -100.0f);
-	FloatInterpolation* bodyYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.0f, 0.05f, 0.0f, nullptr, _BreathAnimationFinished, this);
+	InterpolationHandle bodyYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.35f, 1.5f, 100.0f);
+	InterpolationHandle bodyYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.35f, 0.175f, 0.0f);
+	InterpolationHandle bodyYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.0f, 1.5f, -100.0f);
+	InterpolationHandle bodyYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.0f, 0.05f, 0.0f, _BreathAnimationFinished, this);
 	Interpolator::GetInstance()->LinkFloatInterpolation(bodyYInterpolation1, bodyYInterpolation2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(bodyYInterpolation2, bodyYInterpolation3);
 	Interpolator::GetInstance()->LinkFloatInterpolation(bodyYInterpolation3, bodyYInterpolation4);
 
-	FloatInterpolation* handsYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.0f, 0.5f, 0.0f);
-	FloatInterpolation* handsYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.75f, 1.25f, 100.0f);
-	FloatInterpolation* handsYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.75f, 0.125f, 0.0f);
-	FloatInterpolation* handsYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.0f, 1.5f, -100.0f);
+	InterpolationHandle handsYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.0f, 0.5f, 0.0f);
+	InterpolationHandle handsYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.75f, 1.25f, 100.0f);
+	InterpolationHandle handsYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.75f, 0.125f, 0.0f);
+	InterpolationHandle handsYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.0f, 1.5f, -100.0f);
 	Interpolator::GetInstance()->LinkFloatInterpolation(handsYInterpolation1, handsYInterpolation2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(handsYInterpolation2, handsYInterpolation3);
 	Interpolator::GetInstance()->LinkFloatInterpolation(handsYInterpolation3, handsYInterpolation4);
 
 	Interpolator::GetInstance()->AddFloatInterpolation(bodyYInterpolation1);
 	Interpolator::GetInstance()->AddFloatInterpolation(handsYInterpolation1);
+
+	// The chains run under their first interpolations, so these handles stop the whole breath
+	m_breathingBodyYInterpolation = bodyYInterpolation1;
+	m_breathingHandsYInterpolation = handsYInterpolation1;
 }
 
 float VoxelCharacter::GetBreathingAnimationOffsetForBone(int boneIndex) const
@@ -1587,6 +1667,11 @@ std::string VoxelCharacter::GetSubSelectionName(int pickingID) const
 	return m_pVoxelModel->GetSubSelectionName(pickingID);
 }
 
+int VoxelCharacter::GetSubSelectionRayPicking(const glm::vec3& origin, const glm::vec3& direction, float* pDistance) const
+{
+	return m_pVoxelModel->GetSubSelectionRayPicking(origin, direction, pDistance);
+}
+
 // Update
 void VoxelCharacter::Update(float dt, float animationSpeed[static_cast<int>(AnimationSections::NumSections)])
 {
@@ -1595,28 +1680,43 @@ void VoxelCharacter::Update(float dt, float animationSpeed[static_cast<int>(Anim
 		return;
 	}
 
+	// Animation timers always advance, so gameplay sees the same animation state at every tier. An off-screen character
+	// doesn't queue its pose, it is only evaluated if something reads a bone, such as the shadow pass or a hit test.
+	bool queuePose = m_animationUpdateTier != AnimationUpdateTier::OnDemand;
+
 	// Update skeleton animation
+	int numAnimatorsUpdated = 0;
 	for (int i = 0; i < static_cast<int>(AnimationSections::NumSections); ++i)
 	{
 		if (m_pCharacterAnimator[i] != nullptr)
 		{
 			if (m_updateAnimator)
 			{
-				m_pCharacterAnimator[i]->Update(dt * animationSpeed[i]);
+				if (queuePose)
+				{
+					m_pCharacterAnimator[i]->UpdateDeferred(dt * animationSpeed[i]);
+				}
+				else
+				{
+					m_pCharacterAnimator[i]->AdvanceTimer(dt * animationSpeed[i]);
+				}
+
+				numAnimatorsUpdated++;
 			}
 		}
 	}
+	MS3DAnimatorBatch::GetInstance()->CountAnimators(m_animationUpdateTier, numAnimatorsUpdated);
 
 	// Update paperdoll animator
 	if (m_updateAnimator)
 	{
 		if (m_pCharacterAnimatorPaperdollLeft != nullptr)
 		{
-			m_pCharacterAnimatorPaperdollLeft->Update(dt);
+			m_pCharacterAnimatorPaperdollLeft->UpdateDeferred(dt);
 		}
 		if (m_pCharacterAnimatorPaperdollRight != nullptr)
 		{
-			m_pCharacterAnimatorPaperdollRight->Update(dt);
+			m_pCharacterAnimatorPaperdollRight->UpdateDeferred(dt);
 		}
 	}
 
@@ -1634,8 +1734,8 @@ void VoxelCharacter::Update(float dt, float animationSpeed[static_cast<int>(Anim
 		}
 	}
 
-	// Facial animation
-	if (m_isLoadedFaces)
+	// Facial animation, too small to see on distant characters
+	if (m_isLoadedFaces && m_animationUpdateTier == AnimationUpdateTier::Full)
 	{
 		if (m_isWinkAnimationEnabled || m_wink == true)
 		{
@@ -1746,7 +1846,7 @@ void VoxelCharacter::Render(bool renderOutline, bool reflection, bool silhouette
 	{
 		m_pRenderer->PushMatrix();
 		m_pRenderer->ScaleWorldMatrix(m_characterScale, m_characterScale, m_characterScale);
-		m_pVoxelModel->RenderWithAnimator(m_pCharacterAnimator, this, renderOutline, reflection, silhouette, outlineColor, subSelectionNamePicking);
+		m_pVoxelModel->RenderWithAnimator(m_pCharacterAnimator, this, renderOutline, reflection, silhouette, outlineColor, subSelectionNamePicking, m_renderLODLevel);
 		m_pRenderer->PopMatrix();
 	}
 }
@@ -1939,7 +2039,7 @@ void VoxelCharacter::RenderWeapons(bool renderOutline, bool reflection, bool sil
 				m_pRenderer->PushMatrix();
 				
 				m_pRenderer->ScaleWorldMatrix(m_characterScale, m_characterScale, m_characterScale);
-				m_pLeftWeapon->Render(renderOutline, reflection, silhouette, outlineColor);
+				m_pLeftWeapon->Render(renderOutline, reflection, silhouette, outlineColor, m_renderLODLevel);
 				
 				m_pRenderer->PopMatrix();
 			}
@@ -1955,7 +2055,7 @@ void VoxelCharacter::RenderWeapons(bool renderOutline, bool reflection, bool sil
 				m_pRenderer->PushMatrix();
 
 				m_pRenderer->ScaleWorldMatrix(m_characterScale, m_characterScale, m_characterScale);
-				m_pRightWeapon->Render(renderOutline, reflection, silhouette, outlineColor);
+				m_pRightWeapon->Render(renderOutline, reflection, silhouette, outlineColor, m_renderLODLevel);
 				
 				m_pRenderer->PopMatrix();
 			}
@@ -10,6 +10,9 @@
 #ifndef CUBBY_VOXEL_CHARACTER_H
 #define CUBBY_VOXEL_CHARACTER_H
 
+#include <Utils/Interpolator.h>
+
+#include "MS3DAnimatorBatch.h"
 #include "QubicleBinaryManager.h"
 #include "VoxelWeapon.h"
 
@@ -98,6 +101,19 @@ public:
 
 	// Setup animator and bones
 	void SetUpdateAnimator(bool update);
+
+	// Animation level of detail
+	static AnimationUpdateTier CalculateAnimationUpdateTier(bool visible, float distanceToCamera, float reducedDistance);
+	void SetAnimationUpdateTier(AnimationUpdateTier tier);
+	AnimationUpdateTier GetAnimationUpdateTier() const;
+	void SetRenderVisible(bool visible);
+	bool IsRenderVisible() const;
+
+	// Mesh level of detail, LOD meshes are only built for characters that asked for them before loading
+	void SetCreateLODMeshes(bool createLODMeshes);
+	void SetRenderLODLevel(int lodLevel);
+	int GetRenderLODLevel() const;
+
 	Matrix4 GetBoneMatrix(AnimationSections section, int index) const;
 	Matrix4 GetBoneMatrix(AnimationSections section, const char* boneName) const;
 	Matrix4 GetBoneMatrixPaperdoll(int index, bool left) const;
@@ -114,7 +130,7 @@ public:
 	void SetRenderRightWeapon(bool render);
 	void SetRenderLeftWeapon(bool render);
 	void SetMeshAlpha(float alpha, bool force = false);
-	void SetMeshSingleColor(float r, float g, float b) const;
+	void SetMeshSingleColor(float r, float g, float b);
 
 	// Breathing animation
 	void SetBreathingAnimationEnabled(bool enable);
@@ -209,6 +225,7 @@ public:
 
 	// Sub selection of individual body parts
 	std::string GetSubSelectionName(int pickingID) const;
+	int GetSubSelectionRayPicking(const glm::vec3& origin, const glm::vec3& direction, float* pDistance) const;
 
 	// Update
 	void Update(float dt, float animationSpeed[static_cast<int>(AnimationSections::NumSections)]);
@@ -234,6 +251,9 @@ protected:
 	void BreathAnimationFinished();
 
 private:
+	// Copy-on-write, make sure we don't modify a model that is shared with other characters
+	void DetachSharedModel();
+
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 
@@ -243,6 +263,14 @@ private:
 
 	// Flag for updating the animator
 	bool m_updateAnimator;
+
+	// Animation level of detail, visibility comes from the last rendered frame
+	AnimationUpdateTier m_animationUpdateTier;
+	bool m_isRenderVisible;
+
+	// Mesh level of detail
+	bool m_isCreateLODMeshes;
+	int m_renderLODLevel;
 	
 	// Flags to control weapon rendering
 	bool m_renderRightWeapon;
@@ -269,6 +297,8 @@ private:
 	float m_breathingBodyYOffset;
 	float m_breathingHandsYOffset;
 	float m_breathingAnimationInitialWaitTime;
+	InterpolationHandle m_breathingBodyYInterpolation;
+	InterpolationHandle m_breathingHandsYInterpolation;
 
 	// Facial expression	
 	int m_numFacialExpressions;
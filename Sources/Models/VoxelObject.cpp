@@ -12,6 +12,7 @@
 // Constructor, Destructor
 
 VoxelObject::VoxelObject() :
+	m_pRenderer(nullptr), m_pQubicleBinaryManager(nullptr),
 	m_isUsingQubicleManager(false)
 {
 	Reset();
@@ -42,11 +43,15 @@ void VoxelObject::Reset()
 // Rebuild
 void VoxelObject::RebuildVoxelModel(bool faceMerge) const
 {
+	WaitForModel();
+
 	m_pVoxelModel->RebuildMesh(faceMerge);
 }
 
 QubicleBinary* VoxelObject::GetQubicleModel() const
 {
+	WaitForModel();
+
 	return m_pVoxelModel;
 }
 
@@ -57,6 +62,8 @@ Matrix4 VoxelObject::GetModelMatrix(int qubicleMatrixIndex) const
 		return Matrix4();
 	}
 
+	WaitForModel();
+
 	return m_pVoxelModel->GetModelMatrix(qubicleMatrixIndex);
 }
 
@@ -67,6 +74,8 @@ glm::vec3 VoxelObject::GetCenter() const
 		return glm::vec3(0.0f, 0.0f, 0.0f);
 	}
 
+	WaitForModel();
+
 	glm::vec3 centerPos;
 	
 	for (int i = 0; i < m_pVoxelModel->GetNumMatrices(); ++i)
@@ -83,7 +92,7 @@ glm::vec3 VoxelObject::GetCenter() const
 	return centerPos;
 }
 
-void VoxelObject::LoadObject(const char* qbFileName, bool useManager)
+void VoxelObject::LoadObject(const char* qbFileName, bool useManager, bool createLODMeshes)
 {
 	m_isUsingQubicleManager = useManager;
 
@@ -91,12 +100,12 @@ void VoxelObject::LoadObject(const char* qbFileName, bool useManager)
 	{
 		if (useManager)
 		{
-			m_pVoxelModel = m_pQubicleBinaryManager->GetQubicleBinaryFile(qbFileName, false);
+			// Shared models are loaded in the background, anything that needs the voxel data waits for it in WaitForModel()
+			m_pVoxelModel = m_pQubicleBinaryManager->GetQubicleBinaryFileAsync(qbFileName, createLODMeshes);
 		}
 		else
 		{
-			m_pVoxelModel = new QubicleBinary(m_pRenderer);
-			m_pVoxelModel->Import(qbFileName, true);
+			m_pVoxelModel = m_pQubicleBinaryManager->CreateQubicleBinaryInstance(qbFileName, createLODMeshes);
 		}
 	}
 
@@ -107,9 +116,13 @@ void VoxelObject::UnloadObject()
 {
 	if (m_isLoaded)
 	{
-		if (m_isUsingQubicleManager == false)
+		if (m_isUsingQubicleManager)
+		{
+			m_pQubicleBinaryManager->ReleaseQubicleBinaryFile(m_pVoxelModel);
+		}
+		else
 		{
-			delete m_pVoxelModel;
+			m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pVoxelModel);
 		}
 
 		m_pVoxelModel = nullptr;
@@ -127,32 +140,67 @@ void VoxelObject::SetWireFrameRender(bool isWireframe) const
 	}
 }
 
-void VoxelObject::SetMeshAlpha(float alpha) const
+void VoxelObject::SetMeshAlpha(float alpha)
 {
 	if (m_pVoxelModel != nullptr)
 	{
+		WaitForModel();
+
+		if (alpha != m_pVoxelModel->GetMeshAlpha())
+		{
+			DetachSharedModel();
+		}
+
 		m_pVoxelModel->SetMeshAlpha(alpha);
 	}
 }
 
-void VoxelObject::SetMeshSingleColor(float r, float g, float b) const
+void VoxelObject::SetMeshSingleColor(float r, float g, float b)
 {
 	if (m_pVoxelModel != nullptr)
 	{
+		WaitForModel();
+
+		float currentR, currentG, currentB, currentA;
+		bool isSingleColor = m_pVoxelModel->GetSingleMeshColor(&currentR, &currentG, &currentB, &currentA);
+
+		if (isSingleColor == false || r != currentR || g != currentG || b != currentB)
+		{
+			DetachSharedModel();
+		}
+
 		m_pVoxelModel->SetMeshSingleColor(r, g, b);
 	}
 }
 
+void VoxelObject::WaitForModel() const
+{
+	if (m_isUsingQubicleManager && m_pVoxelModel != nullptr)
+	{
+		m_pQubicleBinaryManager->WaitForQubicleBinaryFile(m_pVoxelModel);
+	}
+}
+
+void VoxelObject::DetachSharedModel()
+{
+	if (m_isUsingQubicleManager)
+	{
+		m_pVoxelModel = m_pQubicleBinaryManager->DetachQubicleBinaryFile(m_pVoxelModel);
+		m_isUsingQubicleManager = false;
+	}
+}
+
 // ReSharper disable once CppMemberFunctionMayBeStatic
 void VoxelObject::Update(float dt) const
 {
 	// Do nothing
 }
 
-void VoxelObject::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor) const
+void VoxelObject::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel) const
 {
-	if (m_pVoxelModel != nullptr)
+	// Nothing is drawn in place of the model until the background load has been uploaded
+	if (m_pVoxelModel != nullptr && m_pVoxelModel->IsLoaded())
 	{
-		m_pVoxelModel->Render(renderOutline, reflection, silhouette, outlineColor);
+		m_pVoxelModel->Render(renderOutline, reflection, silhouette, outlineColor, lodLevel);
 	}
 }
\ No newline at end of file
@@ -32,18 +32,24 @@ public:
 
 	glm::vec3 GetCenter() const;
 
-	void LoadObject(const char* qbFileName, bool useManager = true);
+	void LoadObject(const char* qbFileName, bool useManager = true, bool createLODMeshes = false);
 	void UnloadObject();
 
 	// Rendering modes
 	void SetWireFrameRender(bool isWireframe) const;
-	void SetMeshAlpha(float alpha) const;
-	void SetMeshSingleColor(float r, float g, float b) const;
+	void SetMeshAlpha(float alpha);
+	void SetMeshSingleColor(float r, float g, float b);
 
 	void Update(float dt) const;
-	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor) const;
+	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel = 0) const;
 
 private:
+	// Finishes loading the model straight away if it is still loading in the background
+	void WaitForModel() const;
+
+	// Copy-on-write, make sure we don't modify a model that is shared with other objects
+	void DetachSharedModel();
+
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 
@@ -10,6 +10,7 @@
 #include <fstream>
 
 #include <Maths/3DMaths.h>
+#include <Utils/AssetPack.h>
 
 #include "VoxelObject.h"
 #include "VoxelWeapon.h"
@@ -81,14 +82,12 @@ void VoxelWeapon::RebuildVoxelModel(bool faceMerge) const
 	}
 }
 
-void VoxelWeapon::LoadWeapon(const char* weaponFileName, bool useManager)
+void VoxelWeapon::LoadWeapon(const char* weaponFileName, bool useManager, bool createLODMeshes)
 {
-	std::ifstream file;
+	// Open the file, from the asset pack if it is packed
+	std::istringstream file;
 
-	// Open the file
-	file.open(weaponFileName, std::ios::in);
-
-	if (file.is_open())
+	if (AssetPack::GetInstance()->OpenFile(weaponFileName, &file))
 	{
 		std::string tempString;
 
@@ -112,7 +111,7 @@ void VoxelWeapon::LoadWeapon(const char* weaponFileName, bool useManager)
 			m_pAnimatedSections[i].pVoxelObject->SetQubicleBinaryManager(m_pQubicleBinaryManager);
 
 			file >> tempString >> m_pAnimatedSections[i].fileName;
-			m_pAnimatedSections[i].pVoxelObject->LoadObject(m_pAnimatedSections[i].fileName.c_str(), useManager);
+			m_pAnimatedSections[i].pVoxelObject->LoadObject(m_pAnimatedSections[i].fileName.c_str(), useManager, createLODMeshes);
 
 			file >> tempString >> m_pAnimatedSections[i].renderScale;
 
@@ -292,8 +291,6 @@ void VoxelWeapon::LoadWeapon(const char* weaponFileName, bool useManager)
 		file >> tempString >> m_weaponRadius;
 
 		m_isLoaded = true;
-
-		file.close();
 	}
 }
 
@@ -1395,7 +1392,7 @@ void VoxelWeapon::Update(float dt) const
 }
 
 // Rendering
-void VoxelWeapon::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor) const
+void VoxelWeapon::Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel) const
 {
 	m_pRenderer->PushMatrix();
 
@@ -1501,7 +1498,7 @@ void VoxelWeapon::Render(bool renderOutline, bool reflection, bool silhouette, C
 
 		m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].translateX, m_pAnimatedSections[i].translateY, m_pAnimatedSections[i].translateZ);
 
-		m_pAnimatedSections[i].pVoxelObject->Render(renderOutline, reflection, silhouette, outlineColor);
+		m_pAnimatedSections[i].pVoxelObject->Render(renderOutline, reflection, silhouette, outlineColor, lodLevel);
 
 		// Store the animated section position, since light might be attached to it
 		if (reflection == false)
@@ -141,7 +141,7 @@ public:
 	// Rebuild
 	void RebuildVoxelModel(bool faceMerge) const;
 
-	void LoadWeapon(const char* weaponFileName, bool useManager = true);
+	void LoadWeapon(const char* weaponFileName, bool useManager = true, bool createLODMeshes = false);
 	void SaveWeapon(const char* weaponFileName) const;
 	void UnloadWeapon();
 
@@ -198,7 +198,7 @@ public:
 	void Update(float dt) const;
 
 	// Rendering
-	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor) const;
+	void Render(bool renderOutline, bool reflection, bool silhouette, Color outlineColor, int lodLevel = 0) const;
 	void RenderPaperdoll() const;
 	void RenderWeaponTrails() const;
 
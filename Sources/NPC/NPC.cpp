@@ -14,6 +14,7 @@
 
 #include <CubbyGame.h>
 
+#include <Blocks/VoxelCollision.h>
 #include <Items/ItemManager.h>
 #include <Lighting/LightingManager.h>
 #include <Maths/3DMaths.h>
@@ -23,8 +24,21 @@
 #include <Utils/Interpolator.h>
 #include <Utils/Random.h>
 
+#include "NavigationGraph.h"
 #include "NPC.h"
 
+// Targets closer than this are steered at straight, without a path
+const float NPC_NAVIGATION_MIN_PATH_DISTANCE = 4.0f;
+
+// A new path is found when the target moves this far from the end of the old one
+const float NPC_NAVIGATION_REPATH_DISTANCE = 2.0f;
+
+// Paths are found again at most this often when the blocks changed or there was no path
+const float NPC_NAVIGATION_REPATH_TIME = 1.0f;
+
+// How close to a point of the path counts as reaching it
+const float NPC_NAVIGATION_POINT_RADIUS = 0.75f;
+
 // Constructor, Destructor
 NPC::NPC(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer, LightingManager* pLightingManager, BlockParticleManager* pBlockParticleManager, TextEffectsManager* pTextEffectsManager, ItemManager* pItemManager, ProjectileManager* pProjectileManager, EnemyManager* pEnemyManager, QubicleBinaryManager* pQubicleBinaryManager, std::string name, std::string typeName, std::string modelName, bool characterSelectScreen, bool useQubicleManager) :
 	m_pRenderer(pRenderer), m_pChunkManager(pChunkManager), m_pLightingManager(pLightingManager), m_pPlayer(pPlayer),
@@ -36,7 +50,9 @@ NPC::NPC(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer, Ligh
 	m_name = name;
 
 	m_pVoxelCharacter = new VoxelCharacter(m_pRenderer, m_pQubicleBinaryManager);
-	m_pCharacterBackup = new QubicleBinary(m_pRenderer);
+	// Only NPCs out in the world are drawn far enough away to use the LOD meshes
+	m_pVoxelCharacter->SetCreateLODMeshes(characterSelectScreen == false);
+	m_pCharacterBackup = nullptr;
 
 	m_radius = 1.0f;
 
@@ -137,6 +153,14 @@ NPC::NPC(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer, Ligh
 
 	m_currentWaypointIndex = 0;
 
+	// Navigation
+	m_pNavigationGraph = nullptr;
+	m_navigationPathIndex = 0;
+	m_navigationPathVersion = 0;
+	m_hasNavigationPath = false;
+	m_isNavigationPathRequested = false;
+	m_navigationRepathTimer = 0.0f;
+
 	// Jumping
 	m_canJump = true;
 	m_jumpTime = 1.0f;
@@ -215,11 +239,10 @@ NPC::NPC(Renderer* pRenderer, ChunkManager* pChunkManager, Player* pPlayer, Ligh
 
 	if (m_pCharacterBackup != nullptr)
 	{
-		delete m_pCharacterBackup;
-		m_pCharacterBackup = new QubicleBinary(m_pRenderer);
+		m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pCharacterBackup);
 	}
 
-	m_pCharacterBackup->Import(qbFilename, true);
+	m_pCharacterBackup = m_pQubicleBinaryManager->CreateQubicleBinaryInstance(qbFilename);
 
 	UpdateRadius();
 }
@@ -240,7 +263,7 @@ NPC::~NPC()
 	delete m_pVoxelCharacter;
 	if (m_pCharacterBackup != nullptr)
 	{
-		delete m_pCharacterBackup;
+		m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pCharacterBackup);
 	}
 }
 
@@ -249,6 +272,11 @@ void NPC::SetLightingManager(LightingManager* pLightingManager)
 	m_pLightingManager = pLightingManager;
 }
 
+void NPC::SetNavigationGraph(NavigationGraph* pNavigationGraph)
+{
+	m_pNavigationGraph = pNavigationGraph;
+}
+
 void NPC::SetErase(bool erase)
 {
 	m_erase = erase;
@@ -382,6 +410,12 @@ PlayerClass NPC::GetPlayerClass() const
 	return m_selectedClass;
 }
 
+// Simulation LOD
+SimulationLOD* NPC::GetSimulationLOD()
+{
+	return &m_simulationLOD;
+}
+
 // Combat type
 void NPC::SetNPCCombatType(NPCCombatType combatType, bool setWeaponModel)
 {
@@ -1362,6 +1396,22 @@ void NPC::Jump()
 void NPC::SetTargetPosition(glm::vec3 pos)
 {
 	m_targetPosition = pos;
+
+	if (m_pNavigationGraph == nullptr)
+	{
+		return;
+	}
+
+	// Ask for a path when the target moved away from where the last one leads,
+	// or now and then when the blocks have changed since or there was no path
+	bool hasGoalMoved = length(pos - m_navigationGoal) > NPC_NAVIGATION_REPATH_DISTANCE;
+	bool isPathOld = m_navigationRepathTimer <= 0.0f && (m_hasNavigationPath == false || m_navigationPathVersion != m_pNavigationGraph->GetVersion());
+
+	if (hasGoalMoved || isPathOld)
+	{
+		m_navigationGoal = pos;
+		m_isNavigationPathRequested = true;
+	}
 }
 
 WayPoint* NPC::AddWaypoint(glm::vec3 pos, float xLength, float yLength, float zLength)
@@ -1399,7 +1449,7 @@ void NPC::StartWaypointNavigation(size_t waypointIndex)
 {
 	if (m_vpWayPointList.size() > 0 && waypointIndex < m_vpWayPointList.size())
 	{
-		m_targetPosition = m_vpWayPointList[waypointIndex]->m_position;
+		SetTargetPosition(m_vpWayPointList[waypointIndex]->m_position);
 		m_currentWaypointIndex = waypointIndex;
 		m_NPCState = NPCState::MovingToWayPoint;
 	}
@@ -1450,9 +1500,37 @@ bool NPC::HasReachedTargetPosition() const
 	return m_hasReachedTargetPosition;
 }
 
+glm::vec3 NPC::GetNavigationSteerPosition()
+{
+	if (m_pTargetEnemy != nullptr || m_hasNavigationPath == false)
+	{
+		return m_targetPosition;
+	}
+
+	// Move on to the next point once this one is reached
+	while (m_navigationPathIndex < m_navigationPath.size())
+	{
+		glm::vec3 toPoint = m_navigationPath[m_navigationPathIndex] - GetCenter();
+		toPoint.y = 0.0f;
+
+		if (length(toPoint) > NPC_NAVIGATION_POINT_RADIUS)
+		{
+			// Points are on the blocks stood in, look ahead at head height instead of down at them
+			return glm::vec3(m_navigationPath[m_navigationPathIndex].x, GetCenter().y, m_navigationPath[m_navigationPathIndex].z);
+		}
+
+		m_navigationPathIndex++;
+	}
+
+	return m_targetPosition;
+}
+
 // Combat
 void NPC::DoDamage(float amount, Color textColor, glm::vec3 knockbackDirection, float knockbackAmount, bool createParticleHit)
 {
+	// Being hit from afar still gets a full reaction
+	m_simulationLOD.Wake();
+
 	if (m_damageTimer <= 0.0f)
 	{
 		m_health -= amount;
@@ -1767,8 +1845,8 @@ void NPC::Attack()
 			m_attackEnabled = true;
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			// Start weapon trails
@@ -1812,7 +1890,7 @@ void NPC::Attack()
 			m_attackDelayTime = 1.35f + GetRandomNumber(-100, 50, 2) * 0.005f;
 
 			m_attackEnabledDelayTimer = 0.15f;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 
 			doAttack = true;
 		}
@@ -1840,7 +1918,7 @@ void NPC::Attack()
 			SetAnimationSpeed(1.5f, true, AnimationSections::FullBody);
 
 			m_attackDelayTime = 0.75f + GetRandomNumber(-50, 50, 2) * 0.005f;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, _AttackEnabledDelayTimerFinished, this);
 
 			m_canAttack = false;
 
@@ -1934,6 +2012,8 @@ void NPC::SetTargetEnemy(Enemy* pEnemy)
 
 	if (m_pTargetEnemy != nullptr)
 	{
+		m_simulationLOD.Wake();
+
 		if (m_NPCCombatType == NPCCombatType::Archer || m_NPCCombatType == NPCCombatType::Staff || m_NPCCombatType == NPCCombatType::FireballHands)
 		{
 			StopMoving();
@@ -2129,139 +2209,10 @@ void NPC::ClearChunkCacheForChunk(Chunk* pChunk)
 // Collision
 bool NPC::CheckCollisions(glm::vec3 positionCheck, glm::vec3 previousPosition, glm::vec3 *pNormal, glm::vec3 *pMovement) const
 {
-	float radius = GetRadius();
-
-	glm::vec3 movementCache = *pMovement;
-
 	// World collisions
-	bool worldCollision = false;
-
-	int blockX, blockY, blockZ;
-	glm::vec3 blockPos;
+	VoxelCollision voxelCollision(m_pChunkManager);
 
-	glm::vec3 floorPosition;
-	if (m_pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
-	{
-		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-		return true;
-	}
-
-	int numChecks = 1 + static_cast<int>(radius / (Chunk::BLOCK_RENDER_SIZE* 2.0f));
-		
-	for (int x = -numChecks; x <= numChecks; ++x)
-	{
-		for (int y = -numChecks; y <= numChecks; ++y)
-		{
-			for (int z = -numChecks; z <= numChecks; ++z)
-			{
-				*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-				Chunk* pChunk = GetCachedGridChunkOrFromPosition(positionCheck + glm::vec3((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * y, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * z));
-				bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x), positionCheck.y + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * y), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * z), &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-
-				if (active == false)
-				{
-					if (pChunk == nullptr || pChunk->IsSetup() == false)
-					{
-						*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-						worldCollision = false;
-					}
-				}
-				else if (active == true)
-				{
-					Plane3D planes[6];
-					planes[0] = Plane3D(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[1] = Plane3D(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[2] = Plane3D(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[3] = Plane3D(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[4] = Plane3D(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
-					planes[5] = Plane3D(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
-
-					float distance;
-					int inside = 0;
-					bool insideCache[6];
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - previousPosition;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-							insideCache[i] = false;
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							insideCache[i] = true;
-						}
-						else
-						{
-							// Inside...
-							insideCache[i] = true;
-						}
-					}
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - positionCheck;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-						else
-						{
-							// Inside...
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-					}
-
-					if (inside == 6)
-					{
-						if (length(*pNormal) <= 1.0f)
-						{
-							if (length(*pNormal) > 0.0f)
-							{
-								*pNormal = normalize(*pNormal);
-							}
-
-							float dotResult = dot(*pNormal, *pMovement);
-							*pNormal *= dotResult;
-
-							*pMovement -= *pNormal;
-
-							worldCollision = true;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	if (worldCollision)
-	{
-		return true;
-	}
-
-	*pMovement = movementCache;
-
-	return false;
+	return voxelCollision.CheckCharacter(positionCheck, previousPosition, GetRadius(), pNormal, pMovement);
 }
 
 bool NPC::IsBlockInFront() const
@@ -2340,12 +2291,15 @@ void NPC::CalculateWorldTransformMatrix()
 
 	up = normalize(cross(forward, right));
 
+	// Between ticks a reduced NPC is drawn on its way from the last tick position
+	glm::vec3 renderPosition = m_simulationLOD.GetRenderPosition(m_position);
+
 	float matrix[16] =
 	{
 		right.x, right.y, right.z, 0.0f,
 		up.x, up.y, up.z, 0.0f,
 		forward.x, forward.y, forward.z, 0.0f,
-		m_position.x, m_position.y, m_position.z, 1.0f
+		renderPosition.x, renderPosition.y, renderPosition.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(matrix);
@@ -2446,7 +2400,7 @@ void NPC::UpdateWeaponLights() const
 						lightPos = rotationMatrix * lightPos;
 
 						// Translate to position
-						lightPos += m_position;
+						lightPos += m_simulationLOD.GetRenderPosition(m_position);
 					}
 
 					float scale = m_pVoxelCharacter->GetCharacterScale();
@@ -2515,7 +2469,7 @@ void NPC::UpdateWeaponParticleEffects() const
 						particleEffectPos = rotationMatrix * particleEffectPos;
 
 						// Translate to position
-						particleEffectPos += m_position;
+						particleEffectPos += m_simulationLOD.GetRenderPosition(m_position);
 					}
 
 					m_pBlockParticleManager->UpdateParticleEffectPosition(particleEffectID, particleEffectPos, particleEffectPosNoWorldOffset);
@@ -2816,7 +2770,8 @@ void NPC::UpdateMovement(float dt)
 
 		if (m_pTargetEnemy != nullptr)
 		{
-			SetTargetPosition(m_pTargetEnemy->GetCenter());
+			// Fights are close, the enemy is chased straight without a path
+			m_targetPosition = m_pTargetEnemy->GetCenter();
 			radius = m_pTargetEnemy->GetRadius();
 		}
 		else
@@ -2875,7 +2830,10 @@ void NPC::UpdateMovement(float dt)
 	}
 	else
 	{
-		LookAtPoint(m_targetPosition);
+		// Walk along the path around the blocks in the way, it ends at the target
+		glm::vec3 steerPosition = GetNavigationSteerPosition();
+
+		LookAtPoint(steerPosition);
 
 		bool shouldStopMovingUntilJump = false;
 		if (IsBlockInFront())
@@ -2896,7 +2854,7 @@ void NPC::UpdateMovement(float dt)
 				if ((m_NPCCombatType != NPCCombatType::Archer && m_NPCCombatType != NPCCombatType::Staff && m_NPCCombatType != NPCCombatType::FireballHands) || m_pTargetEnemy == nullptr)
 				{
 					glm::vec3 toTarget = m_targetPosition - m_position;
-					glm::vec3 movementDirection = toTarget;
+					glm::vec3 movementDirection = steerPosition - m_position;
 					movementDirection.y = 0.0f;
 					movementDirection = normalize(movementDirection);
 
@@ -2940,6 +2898,32 @@ void NPC::UpdateMovement(float dt)
 	}
 }
 
+void NPC::UpdateNavigationPath()
+{
+	if (m_isNavigationPathRequested == false || m_pNavigationGraph == nullptr)
+	{
+		return;
+	}
+
+	m_isNavigationPathRequested = false;
+	m_navigationRepathTimer = NPC_NAVIGATION_REPATH_TIME;
+	m_navigationPathVersion = m_pNavigationGraph->GetVersion();
+	m_navigationPathIndex = 0;
+
+	glm::vec3 toGoal = m_navigationGoal - GetCenter();
+	toGoal.y = 0.0f;
+
+	if (length(toGoal) < NPC_NAVIGATION_MIN_PATH_DISTANCE)
+	{
+		m_navigationPath.clear();
+		m_hasNavigationPath = false;
+
+		return;
+	}
+
+	m_hasNavigationPath = m_pNavigationGraph->FindPath(GetCenter(), m_navigationGoal, &m_navigationPath);
+}
+
 void NPC::UpdateNPCState(float dt)
 {
 	switch (m_NPCState)
@@ -3022,7 +3006,7 @@ void NPC::UpdatePhysics(float dt)
 	m_previousPosition = GetCenter();
 }
 
-void NPC::Update(float dt)
+void NPC::UpdateIntegrate(float dt)
 {
 	// Update grid position
 	UpdateGridPosition();
@@ -3033,6 +3017,15 @@ void NPC::Update(float dt)
 	// Update look at point
 	UpdateLookingAndForwardTarget(dt);
 
+	// Update physics
+	UpdatePhysics(dt);
+}
+
+void NPC::UpdateApply(float dt)
+{
+	// Find the path asked for while moving, the graph's search state is shared so it is one NPC at a time
+	UpdateNavigationPath();
+
 	// Update NPC state
 	UpdateNPCState(dt);
 
@@ -3048,9 +3041,16 @@ void NPC::Update(float dt)
 
 	// Update timers
 	UpdateTimers(dt);
+}
 
+void NPC::UpdateAnimation(float dt)
+{
 	if (m_pVoxelCharacter != nullptr)
 	{
+		// Animation level of detail, from the distance to the camera and the visibility of the last rendered frame
+		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - GetCenter());
+		m_pVoxelCharacter->SetAnimationUpdateTier(VoxelCharacter::CalculateAnimationUpdateTier(m_pVoxelCharacter->IsRenderVisible(), toCamera, CubbyGame::GetInstance()->GetCubbySettings()->m_animationLODDistance));
+
 		m_pVoxelCharacter->Update(dt, m_animationSpeed);
 		m_pVoxelCharacter->SetWeaponTrailsOriginMatrix(m_worldMatrix);
 
@@ -3059,9 +3059,6 @@ void NPC::Update(float dt)
 			m_animationFinished[i] = m_pVoxelCharacter->HasAnimationFinished(static_cast<AnimationSections>(i));
 		}
 	}
-
-	// Update physics
-	UpdatePhysics(dt);
 }
 
 void NPC::UpdateScreenCoordinates2d(Camera* pCamera)
@@ -3177,6 +3174,12 @@ void NPC::UpdateTimers(float dt)
 	{
 		m_knockbackTimer -= dt;
 	}
+
+	// Navigation path timer
+	if (m_navigationRepathTimer > 0.0f)
+	{
+		m_navigationRepathTimer -= dt;
+	}
 }
 
 void NPC::Render(bool outline, bool reflection, bool silhouette) const
@@ -3340,6 +3343,27 @@ void NPC::RenderWaypointsDebug()
 		m_pRenderer->DisableImmediateMode();
 	}
 
+	// The rest of the navigation path
+	if (m_hasNavigationPath && m_navigationPathIndex < m_navigationPath.size())
+	{
+		m_pRenderer->SetRenderMode(RenderMode::SOLID);
+		m_pRenderer->SetLineWidth(2.0f);
+		m_pRenderer->EnableImmediateMode(ImmediateModePrimitive::LINES);
+
+		m_pRenderer->ImmediateColorAlpha(0.0f, 1.0f, 0.0f, 1.0f);
+
+		glm::vec3 lineStart = GetCenter();
+		for (size_t i = m_navigationPathIndex; i < m_navigationPath.size(); ++i)
+		{
+			m_pRenderer->ImmediateVertex(lineStart.x, lineStart.y, lineStart.z);
+			m_pRenderer->ImmediateVertex(m_navigationPath[i].x, m_navigationPath[i].y, m_navigationPath[i].z);
+
+			lineStart = m_navigationPath[i];
+		}
+
+		m_pRenderer->DisableImmediateMode();
+	}
+
 	for (size_t i = 0; i < m_vpWayPointList.size(); ++i)
 	{
 		float length = m_vpWayPointList[i]->m_xLength;
@@ -3495,19 +3519,6 @@ void NPC::RenderSubSelectionNormal() const
 	m_pRenderer->PopMatrix();
 }
 
-void NPC::RenderSubSelectionNamePicking() const
-{
-	m_pRenderer->PushMatrix();
-
-	m_pRenderer->MultiplyWorldMatrix(m_worldMatrix);
-
-	Color outlineColor(1.0f, 1.0f, 0.0f, 1.0f);
-
-	m_pVoxelCharacter->Render(false, false, false, outlineColor, true);
-
-	m_pRenderer->PopMatrix();
-}
-
 void NPC::RenderProjectileHitboxDebug() const
 {
 	m_pRenderer->PushMatrix();
@@ -17,6 +17,7 @@
 #include <Models/VoxelCharacter.h>
 #include <Player/PlayerClass.h>
 #include <Projectile/ProjectileManager.h>
+#include <Utils/SimulationLOD.h>
 
 // Forward declaration
 class LightingManager;
@@ -25,6 +26,7 @@ class TextEffectsManager;
 class ItemManager;
 class Enemy;
 class EnemyManager;
+class NavigationGraph;
 
 enum class NPCState
 {
@@ -63,6 +65,7 @@ public:
 	~NPC();
 
 	void SetLightingManager(LightingManager* pLightingManager);
+	void SetNavigationGraph(NavigationGraph* pNavigationGraph);
 
 	void SetErase(bool erase);
 	bool NeedErase() const;
@@ -93,6 +96,9 @@ public:
 	void SetPlayerClass(PlayerClass selectedClass);
 	PlayerClass GetPlayerClass() const;
 
+	// Simulation LOD
+	SimulationLOD* GetSimulationLOD();
+
 	// Combat type
 	void SetNPCCombatType(NPCCombatType combatType, bool setWeaponModel);
 
@@ -145,6 +151,8 @@ public:
 	void SetForwards(glm::vec3 dir);
 	void SetTargetForwards(glm::vec3 dir);
 	bool HasReachedTargetPosition() const;
+	// The next point of the path to the target, or the target itself when there is no path to follow
+	glm::vec3 GetNavigationSteerPosition();
 
 	// Combat
 	void DoDamage(float amount, Color textColor, glm::vec3 knockbackDirection, float knockbackAmount, bool createParticleHit);
@@ -217,9 +225,16 @@ public:
 	void UpdateMeleeCombat();
 	void UpdateRangedCombat(float dt);
 	void UpdateMovement(float dt);
+	void UpdateNavigationPath();
 	void UpdateNPCState(float dt);
 	void UpdatePhysics(float dt);
-	void Update(float dt);
+	// Movement and physics. Only changes this NPC and only reads the player, enemies and the world,
+	// so the NPC manager runs it for every NPC at once on the worker threads.
+	void UpdateIntegrate(float dt);
+	// State, combat and damage, run one NPC at a time after UpdateIntegrate()
+	void UpdateApply(float dt);
+	// Every frame, whether or not the NPC ticked, so it animates smoothly at any simulation tier
+	void UpdateAnimation(float dt);
 	void UpdateScreenCoordinates2d(Camera* pCamera);
 	void UpdateSubSelectionNamePicking(int pickingId, bool mousePressed);
 	void UpdateAggroRadius();
@@ -234,7 +249,6 @@ public:
 	void RenderWaypointsDebug();
 	void RenderSubSelection(bool outline, bool silhouette) const;
 	void RenderSubSelectionNormal() const;
-	void RenderSubSelectionNamePicking() const;
 	void RenderProjectileHitboxDebug() const;
 	void RenderAggroRadiusDebug() const;
 	void RenderMovementPositionDebug() const;
@@ -322,6 +336,16 @@ private:
 	WayPointList m_vpWayPointList;
 	size_t m_currentWaypointIndex;
 
+	// Navigation, the path is asked for while moving and found in UpdateApply()
+	NavigationGraph* m_pNavigationGraph;
+	std::vector<glm::vec3> m_navigationPath;
+	size_t m_navigationPathIndex;
+	glm::vec3 m_navigationGoal;
+	unsigned int m_navigationPathVersion;
+	bool m_hasNavigationPath;
+	bool m_isNavigationPathRequested;
+	float m_navigationRepathTimer;
+
 	// Movement params
 	float m_movementSpeed;
 	float m_maxMovementSpeed;
@@ -409,6 +433,9 @@ private:
 	// Cached chunk from grid position
 	Chunk* m_pCachedGridChunk;
 
+	// How often the NPC manager ticks us
+	SimulationLOD m_simulationLOD;
+
 	// Rendering modes
 	bool m_outlineRender;
 	bool m_hoverRender;
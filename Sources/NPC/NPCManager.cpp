@@ -10,21 +10,36 @@
 *************************************************************************/
 
 #include <Player/Player.h>
+#include <Utils/PerformanceTimer.h>
+#include <Utils/SpatialGrid.h>
+#include <Utils/ThreadPool.h>
 
+#include "NavigationGraph.h"
 #include "NPCManager.h"
 #include <CubbyGame.h>
 #include <algorithm>
+#include <limits>
 
 // Constants
 float NPCManager::NPC_INTERACTION_DISTANCE = 4.5f;
 float NPCManager::NPC_INTERACTION_RADIUS_CHECK = 0.65f;
 
+// Number of NPCs handed to a worker at a time
+const int NPC_INTEGRATE_GRAIN_SIZE = 4;
+
+// Changed chunks the navigation graph rebuilds each frame
+const int NPC_NAVIGATION_CHUNKS_PER_UPDATE = 4;
+
+// Body parts reach outside the NPC's sphere in the spatial grid, picking grows the spheres by this much to keep them inside
+const float NPC_RAY_PICKING_PADDING = 1.0f;
+
 // Constructor, Destructor
 NPCManager::NPCManager(Renderer* pRenderer, ChunkManager* pChunkManager) :
 	m_pRenderer(pRenderer), m_pChunkManager(pChunkManager),
 	m_pLightingManager(nullptr), m_pPlayer(nullptr), m_pBlockParticleManager(nullptr),
 	m_pTextEffectsManager(nullptr), m_pItemManager(nullptr), m_pProjectileManager(nullptr),
-	m_pQubicleBinaryManager(nullptr), m_pEnemyManager(nullptr), m_numRenderNPCs(0)
+	m_pQubicleBinaryManager(nullptr), m_pEnemyManager(nullptr), m_pSpatialGrid(nullptr), m_pNavigationGraph(nullptr), m_numRenderNPCs(0),
+	m_pIntegrateNPCList(nullptr)
 {
 
 }
@@ -83,6 +98,25 @@ void NPCManager::SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryMan
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
 }
 
+void NPCManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
+void NPCManager::SetNavigationGraph(NavigationGraph* pNavigationGraph)
+{
+	m_pNavigationGraph = pNavigationGraph;
+
+	m_NPCMutex.lock();
+
+	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
+	{
+		m_vpNPCList[i]->SetNavigationGraph(m_pNavigationGraph);
+	}
+
+	m_NPCMutex.unlock();
+}
+
 // Clearing
 void NPCManager::ClearNPCs()
 {
@@ -90,6 +124,8 @@ void NPCManager::ClearNPCs()
 
 	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
 	{
+		m_pSpatialGrid->Remove(m_vpNPCList[i]);
+
 		delete m_vpNPCList[i];
 		m_vpNPCList[i] = nullptr;
 	}
@@ -131,6 +167,7 @@ NPC* NPCManager::CreateNPC(const char* name, std::string typeName, std::string m
 	NPC* pNewNPC = new NPC(m_pRenderer, m_pChunkManager, m_pPlayer, m_pLightingManager, m_pBlockParticleManager, m_pTextEffectsManager, m_pItemManager, m_pProjectileManager, m_pEnemyManager, m_pQubicleBinaryManager, name, typeName, modelName, characterSelectScreen, useQubicleManager);
 
 	pNewNPC->SetLightingManager(m_pLightingManager);
+	pNewNPC->SetNavigationGraph(m_pNavigationGraph);
 	pNewNPC->SetPosition(position);
 
 	float randomScaleAddition = 0.0f;
@@ -176,6 +213,8 @@ void NPCManager::DeleteNPC(std::string name)
 	// Delete
 	if (pDeleteObject != nullptr)
 	{
+		m_pSpatialGrid->Remove(pDeleteObject);
+
 		delete pDeleteObject;
 	}
 }
@@ -248,11 +287,12 @@ void NPCManager::SetEnemyDied(Enemy* pEnemy)
 // Collision
 void NPCManager::PushCollisions(NPC* pPushingNPC, glm::vec3 position, float radius)
 {
-	m_NPCMutex.lock();
+	std::vector<void*> vpNearbyNPCs;
+	m_pSpatialGrid->QueryRadius(position, radius, SpatialGrid::GetTypeBit(SpatialType::NPC), &vpNearbyNPCs);
 
-	for (auto iter = m_vpNPCList.begin(); iter != m_vpNPCList.end(); ++iter)
+	for (size_t i = 0; i < vpNearbyNPCs.size(); ++i)
 	{
-		NPC* pNPC = *iter;
+		NPC* pNPC = static_cast<NPC*>(vpNearbyNPCs[i]);
 
 		if (pNPC == pPushingNPC)
 		{
@@ -273,10 +313,10 @@ void NPCManager::PushCollisions(NPC* pPushingNPC, glm::vec3 position, float radi
 			pushVector.y = 0.0f;  // Don't push in Y direction
 			pushVector *= lengthValue;
 			pNPC->SetPosition(pNPC->GetPosition() - pushVector);
+
+			UpdateSpatialGrid(pNPC);
 		}
 	}
-
-	m_NPCMutex.unlock();
 }
 
 // Interaction
@@ -328,6 +368,45 @@ void NPCManager::SetWireFrameRender(bool wireframe)
 	m_NPCMutex.unlock();
 }
 
+int NPCManager::GetRayNamePicking(const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+{
+	if (m_pSpatialGrid == nullptr)
+	{
+		return -1;
+	}
+
+	m_NPCMutex.lock();
+
+	float distance;
+	NPC* pNPC = static_cast<NPC*>(m_pSpatialGrid->QueryRay(origin, direction, maxDistance, NPC_RAY_PICKING_PADDING, SpatialGrid::GetTypeBit(SpatialType::NPC), _RayPickNPC, nullptr, &distance));
+
+	int pickingID = -1;
+	if (pNPC != nullptr)
+	{
+		if (pNPC->GetSubSelectionRender())
+		{
+			pickingID = pNPC->GetVoxelCharacter()->GetSubSelectionRayPicking(origin, direction, &distance);
+		}
+		else
+		{
+			auto iter = std::find(m_vpNPCList.begin(), m_vpNPCList.end(), pNPC);
+			pickingID = Player::PLAYER_NAME_PICKING + 100 + static_cast<int>(iter - m_vpNPCList.begin());
+		}
+	}
+
+	m_NPCMutex.unlock();
+
+	return pickingID;
+}
+
+bool NPCManager::_RayPickNPC(void* /*pData*/, void* pObject, const glm::vec3& origin, const glm::vec3& direction, float* pDistance)
+{
+	NPC* pNPC = static_cast<NPC*>(pObject);
+
+	// The body parts where the NPC was last rendered
+	return pNPC->GetVoxelCharacter()->GetSubSelectionRayPicking(origin, direction, pDistance) != -1;
+}
+
 // Updating
 void NPCManager::UpdateNamePickingSelection(int pickingID)
 {
@@ -440,11 +519,11 @@ void NPCManager::UpdateWeaponLights()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Parked NPCs leave their lights where they are
+		if (pNPC->GetSimulationLOD()->IsAnimating() == false)
+		{
+			continue;
+		}
 
 		pNPC->UpdateWeaponLights();
 	}
@@ -460,11 +539,10 @@ void NPCManager::UpdateWeaponParticleEffects()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO : Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		if (pNPC->GetSimulationLOD()->IsAnimating() == false)
+		{
+			continue;
+		}
 
 		pNPC->UpdateWeaponParticleEffects();
 	}
@@ -489,6 +567,14 @@ void NPCManager::Update(float dt)
 	// Remove any NPC that need to be erased
 	m_NPCMutex.lock();
 
+	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
+	{
+		if (m_vpNPCList[i]->NeedErase() == true)
+		{
+			m_pSpatialGrid->Remove(m_vpNPCList[i]);
+		}
+	}
+
 	m_vpNPCList.erase(remove_if(m_vpNPCList.begin(), m_vpNPCList.end(), NPCNeedsErase), m_vpNPCList.end());
 	
 	m_NPCMutex.unlock();
@@ -496,27 +582,110 @@ void NPCManager::Update(float dt)
 	// Update the mouse hover NPC selection
 	UpdateHoverNPCs();
 
+	// Catch the navigation graph up with the chunks that changed, the NPCs only read it while they move
+	if (m_pNavigationGraph != nullptr)
+	{
+		m_pNavigationGraph->Update(NPC_NAVIGATION_CHUNKS_PER_UPDATE);
+	}
+
 	// Update all NPCs
 	m_NPCMutex.lock();
 
+	// Pick how often each NPC is simulated from how far it is from the player, only the ones whose tick came up run their AI and physics.
+	// With the simulation LOD off, and for the front-end NPCs, everything is ticked every frame.
+	CubbySettings* pSettings = CubbyGame::GetInstance()->GetCubbySettings();
+	glm::vec3 playerPosition = m_pPlayer->GetCenter();
+
+	m_simulationStats.Reset();
+	m_vpFullNPCList.clear();
+	m_vpReducedNPCList.clear();
+
 	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		bool useSimulationLOD = pSettings->m_simulationLOD && pNPC->IsFrontEndNPC() == false;
+		float reducedDistance = useSimulationLOD ? pSettings->m_simulationLODDistance : std::numeric_limits<float>::max();
+		ChunkManager* pLODChunkManager = useSimulationLOD ? m_pChunkManager : nullptr;
 
-		pNPC->Update(dt);
+		SimulationLOD* pSimulationLOD = pNPC->GetSimulationLOD();
+		pSimulationLOD->Update(dt, pNPC->GetCenter(), playerPosition, reducedDistance, pLODChunkManager);
 
-		m_NPCMutex.unlock();
+		SimulationTier tier = pSimulationLOD->GetTier();
+		m_simulationStats.m_numEntities[static_cast<int>(tier)]++;
+
+		if (pSimulationLOD->IsTicking() == false)
+		{
+			continue;
+		}
+
+		if (tier == SimulationTier::Full)
+		{
+			m_vpFullNPCList.push_back(pNPC);
+		}
+		else
+		{
+			m_vpReducedNPCList.push_back(pNPC);
+			m_simulationStats.m_numReducedTicks++;
+		}
+	}
+
+	NPCList* pTickingNPCLists[2] = { &m_vpFullNPCList, &m_vpReducedNPCList };
+	int tickingTiers[2] = { static_cast<int>(SimulationTier::Full), static_cast<int>(SimulationTier::Reduced) };
+
+	// Move every ticking NPC at once, each one only changes itself and the rest of the world holds still until they are all done
+	for (int i = 0; i < 2; ++i)
+	{
+		PerformanceTimer timer;
+
+		m_pIntegrateNPCList = pTickingNPCLists[i];
+		ThreadPool::GetInstance()->ParallelFor(static_cast<int>(m_pIntegrateNPCList->size()), NPC_INTEGRATE_GRAIN_SIZE, _IntegrateNPCs, this);
+
+		m_simulationStats.m_updateTime[tickingTiers[i]] += timer.GetElapsedTime();
+	}
+
+	// Then state, combat and damage one NPC at a time
+	for (int i = 0; i < 2; ++i)
+	{
+		PerformanceTimer timer;
+
+		for (size_t j = 0; j < pTickingNPCLists[i]->size(); ++j)
+		{
+			NPC* pNPC = (*pTickingNPCLists[i])[j];
+
+			pNPC->UpdateApply(pNPC->GetSimulationLOD()->GetTickDeltaTime());
+			pNPC->GetSimulationLOD()->SetTickPosition(pNPC->GetPosition());
+
+			UpdateSpatialGrid(pNPC);
+		}
 
 		// Allow NPCs to push each other away (simple collision).
-		PushCollisions(pNPC, pNPC->GetCenter(), pNPC->GetRadius());
+		for (size_t j = 0; j < pTickingNPCLists[i]->size(); ++j)
+		{
+			NPC* pNPC = (*pTickingNPCLists[i])[j];
+
+			PushCollisions(pNPC, pNPC->GetCenter(), pNPC->GetRadius());
+		}
 
-		m_NPCMutex.lock();
+		m_simulationStats.m_updateTime[tickingTiers[i]] += timer.GetElapsedTime();
+	}
+
+	// Every NPC that isn't parked animates each frame, the ones that didn't tick are drawn between their last two ticks
+	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
+	{
+		NPC* pNPC = m_vpNPCList[i];
+		SimulationLOD* pSimulationLOD = pNPC->GetSimulationLOD();
+
+		if (pSimulationLOD->IsAnimating() == false)
+		{
+			continue;
+		}
+
+		PerformanceTimer timer;
+
+		pNPC->UpdateAnimation(dt);
+
+		m_simulationStats.m_updateTime[static_cast<int>(pSimulationLOD->GetTier())] += timer.GetElapsedTime();
 	}
 
 	m_NPCMutex.unlock();
@@ -531,6 +700,23 @@ void NPCManager::Update(float dt)
 	UpdateNPCProjectileCheck();
 }
 
+void NPCManager::_IntegrateNPCs(void* pData, int begin, int end)
+{
+	NPCManager* pNPCManager = static_cast<NPCManager*>(pData);
+
+	for (int i = begin; i < end; ++i)
+	{
+		NPC* pNPC = (*pNPCManager->m_pIntegrateNPCList)[i];
+
+		pNPC->UpdateIntegrate(pNPC->GetSimulationLOD()->GetTickDeltaTime());
+	}
+}
+
+const SimulationStats& NPCManager::GetSimulationStats() const
+{
+	return m_simulationStats;
+}
+
 void NPCManager::UpdateScreenCoordinates2d(Camera* pCamera)
 {
 	m_NPCMutex.lock();
@@ -539,11 +725,11 @@ void NPCManager::UpdateScreenCoordinates2d(Camera* pCamera)
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		pNPC->UpdateScreenCoordinates2d(pCamera);
 	}
@@ -553,7 +739,6 @@ void NPCManager::UpdateScreenCoordinates2d(Camera* pCamera)
 
 void NPCManager::UpdateHoverNPCs()
 {
-	// Check if any item are within interaction range
 	m_NPCMutex.lock();
 
 	for (auto iter = m_vpNPCList.begin(); iter != m_vpNPCList.end(); ++iter)
@@ -564,6 +749,15 @@ void NPCManager::UpdateHoverNPCs()
 		{
 			pNPC->SetOutlineRender(false);
 		}
+	}
+
+	// Check if any NPCs are within interaction range, in front of the player
+	std::vector<void*> vpNearbyNPCs;
+	m_pSpatialGrid->QueryCone(m_pPlayer->GetCenter(), normalize(m_pPlayer->GetForwardVector()), NPC_INTERACTION_RADIUS_CHECK, NPC_INTERACTION_DISTANCE, SpatialGrid::GetTypeBit(SpatialType::NPC), &vpNearbyNPCs);
+
+	for (size_t i = 0; i < vpNearbyNPCs.size(); ++i)
+	{
+		NPC* pNPC = static_cast<NPC*>(vpNearbyNPCs[i]);
 
 		if (pNPC->GetState() == NPCState::Combat)
 		{
@@ -593,6 +787,8 @@ void NPCManager::UpdateHoverNPCs()
 
 void NPCManager::UpdateNPCProjectileCheck()
 {
+	std::vector<void*> vpNearbyProjectiles;
+
 	m_NPCMutex.lock();
 
 	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
@@ -604,17 +800,26 @@ void NPCManager::UpdateNPCProjectileCheck()
 			continue;
 		}
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
+
+		// Only the projectiles that can reach the hitbox
+		float hitboxRadius = pNPC->GetRadius();
+		if (pNPC->GetProjectileHitboxType() == ProjectileHitboxType::Cube)
+		{
+			hitboxRadius = length(glm::vec3(pNPC->GetProjectileHitboxXLength(), pNPC->GetProjectileHitboxYLength(), pNPC->GetProjectileHitboxZLength()));
+		}
+
+		m_pSpatialGrid->QueryRadius(pNPC->GetProjectileHitboxCenter(), hitboxRadius, SpatialGrid::GetTypeBit(SpatialType::Projectile), &vpNearbyProjectiles);
 
-		for (int j = 0; j < m_pProjectileManager->GetNumProjectiles(); ++j)
+		for (size_t j = 0; j < vpNearbyProjectiles.size(); ++j)
 		{
-			Projectile* pProjectile = m_pProjectileManager->GetProjectile(j);
+			Projectile* pProjectile = static_cast<Projectile*>(vpNearbyProjectiles[j]);
 
-			if (pProjectile != nullptr && pProjectile->GetErase() == false)
+			if (pProjectile->GetErase() == false)
 			{
 				pNPC->CheckProjectileDamageRadius(pProjectile);
 			}
@@ -624,6 +829,11 @@ void NPCManager::UpdateNPCProjectileCheck()
 	m_NPCMutex.unlock();
 }
 
+void NPCManager::UpdateSpatialGrid(NPC* pNPC)
+{
+	m_pSpatialGrid->Update(pNPC, SpatialType::NPC, pNPC->GetCenter(), std::max(pNPC->GetRadius(), pNPC->GetAttackRadius()));
+}
+
 void NPCManager::CalculateWorldTransformMatrix()
 {
 	m_NPCMutex.lock();
@@ -641,16 +851,26 @@ void NPCManager::CalculateWorldTransformMatrix()
 // Rendering
 void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool renderOnlyOutline, bool renderOnlyNormal, bool shadow)
 {
+	// The main pass also records which NPCs are visible, for the animation level of detail
+	bool isVisibilityPass = (reflection == false && silhouette == false && shadow == false);
+
 	m_NPCMutex.lock();
 
 	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
 	{
 		NPC* pNPC = m_vpNPCList[i];
+		VoxelCharacter* pVoxelCharacter = pNPC->GetVoxelCharacter();
 
 		if (pNPC->GetSubSelectionRender())
 		{
 			// If we are sub selecting this NPC parts, render this in a different flow
-			if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
+			bool inFrustum = m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius());
+			if (isVisibilityPass && pVoxelCharacter != nullptr)
+			{
+				pVoxelCharacter->SetRenderVisible(inFrustum);
+			}
+
+			if (inFrustum)
 			{
 				pNPC->RenderSubSelection(false, true);
 			}
@@ -671,16 +891,21 @@ void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool ren
 				continue;
 			}
 
-			// TODO: Loader radius culling
-			//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-			//{
-			//	continue;
-			//}
+			// Dormant NPCs are parked until their chunk is loaded again
+			if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+			{
+				continue;
+			}
 
 			// Fog
 			float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pNPC->GetCenter());
 			if (toCamera > m_pChunkManager->GetLoaderRadius() + (Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 5.0f))
 			{
+				if (isVisibilityPass && pVoxelCharacter != nullptr)
+				{
+					pVoxelCharacter->SetRenderVisible(false);
+				}
+
 				continue;
 			}
 			if (toCamera > m_pChunkManager->GetLoaderRadius() - Chunk::CHUNK_SIZE * Chunk::BLOCK_RENDER_SIZE * 3.0f)
@@ -690,8 +915,20 @@ void NPCManager::Render(bool outline, bool reflection, bool silhouette, bool ren
 
 			if (pNPC->GetSubSelectionRender() == false)
 			{
-				if (shadow || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
+				bool inFrustum = shadow || m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius());
+				if (isVisibilityPass && pVoxelCharacter != nullptr)
+				{
+					pVoxelCharacter->SetRenderVisible(inFrustum);
+				}
+
+				if (inFrustum)
 				{
+					// Level of detail
+					if (pVoxelCharacter != nullptr)
+					{
+						pVoxelCharacter->SetRenderLODLevel(QubicleBinary::CalculateLODLevel(toCamera, pNPC->GetRadius(), CubbyGame::GetInstance()->GetCubbySettings()->m_lodBias));
+					}
+
 					pNPC->Render(outline, reflection, silhouette);
 
 					m_numRenderNPCs++;
@@ -713,11 +950,11 @@ void NPCManager::RenderFaces()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		// Fog
 		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pNPC->GetCenter());
@@ -749,11 +986,11 @@ void NPCManager::RenderWeaponTrails()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		// Fog
 		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pNPC->GetCenter());
@@ -777,42 +1014,6 @@ void NPCManager::RenderWeaponTrails()
 	m_NPCMutex.unlock();
 }
 
-void NPCManager::RenderNamePicking()
-{
-	m_NPCMutex.lock();
-
-	for (size_t i = 0; i < m_vpNPCList.size(); ++i)
-	{
-		NPC* pNPC = m_vpNPCList[i];
-
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
-
-		if (pNPC->GetSubSelectionRender())
-		{
-			// If we are sub selecting this NPC parts, render the name picking separately
-			if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
-			{
-				pNPC->RenderSubSelectionNamePicking();
-			}
-		}
-		else
-		{
-			if (m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pNPC->GetCenter(), pNPC->GetRadius()))
-			{
-				m_pRenderer->LoadNameOntoStack(Player::PLAYER_NAME_PICKING + 100 + i);
-				pNPC->Render(false, false, false);
-				m_pRenderer->EndNameStack();
-			}
-		}
-	}
-	
-	m_NPCMutex.unlock();
-}
-
 void NPCManager::RenderOutlineNPCs()
 {
 	m_NPCMutex.lock();
@@ -836,11 +1037,11 @@ void NPCManager::RenderOutlineNPCs()
 				continue;
 			}
 
-			// TODO: Loader radius culling
-			//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-			//{
-			//	continue;
-			//}
+			// Dormant NPCs are parked until their chunk is loaded again
+			if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+			{
+				continue;
+			}
 
 			// Fog
 			float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pNPC->GetCenter());
@@ -873,11 +1074,11 @@ void NPCManager::RenderSubSelectionNPCs()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (pNPC->GetSubSelectionRender())
 		{
@@ -899,11 +1100,11 @@ void NPCManager::RenderSubSelectionNormalNPCs()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (pNPC->GetSubSelectionRender())
 		{
@@ -925,11 +1126,11 @@ void NPCManager::RenderSubSelectionOverlayNPCs()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		if (pNPC->GetSubSelectionRender())
 		{
@@ -951,11 +1152,11 @@ void NPCManager::RenderDebug()
 	{
 		NPC* pNPC = m_vpNPCList[i];
 
-		// TODO: Loader radius culling
-		//if(m_pChunkManager->IsInsideLoader(pNPC->GetCenter()) == false)
-		//{
-		//	continue;
-		//}
+		// Dormant NPCs are parked until their chunk is loaded again
+		if (pNPC->GetSimulationLOD()->GetTier() == SimulationTier::Dormant)
+		{
+			continue;
+		}
 
 		// Fog
 		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pNPC->GetCenter());
@@ -22,6 +22,8 @@ class TextEffectsManager;
 class ItemManager;
 class ProjectileManager;
 class EnemyManager;
+class SpatialGrid;
+class NavigationGraph;
 
 class NPCManager
 {
@@ -38,6 +40,8 @@ public:
 	void SetProjectileManager(ProjectileManager* pProjectileManager);
 	void SetEnemyManager(EnemyManager* pEnemyManager);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
+	void SetNavigationGraph(NavigationGraph* pNavigationGraph);
 
 	// Clearing
 	void ClearNPCs();
@@ -57,7 +61,7 @@ public:
 	// Enemy Died
 	void SetEnemyDied(Enemy* pEnemy);
 
-	// Collision
+	// Collision, called with the NPC list locked
 	void PushCollisions(NPC* pPushingNPC, glm::vec3 position, float radius);
 
 	// Interaction
@@ -66,6 +70,9 @@ public:
 	// Rendering Helpers
 	void SetWireFrameRender(bool wireframe);
 
+	// Name picking ID of the NPC, or of the body part of a sub selection NPC, nearest along the ray. -1 when there is none.
+	int GetRayNamePicking(const glm::vec3& origin, const glm::vec3& direction, float maxDistance);
+
 	// Updating
 	void UpdateNamePickingSelection(int pickingID);
 	void UpdateHoverNamePickingSelection(int pickingID);
@@ -75,13 +82,15 @@ public:
 	void UpdateScreenCoordinates2d(Camera* pCamera);
 	void UpdateHoverNPCs();
 	void UpdateNPCProjectileCheck();
+
+	// NPCs simulated at each tier last frame
+	const SimulationStats& GetSimulationStats() const;
 	void CalculateWorldTransformMatrix();
 
 	// Rendering
 	void Render(bool outline, bool reflection, bool silhouette, bool renderOnlyOutline, bool renderOnlyNormal, bool shadow);
 	void RenderFaces();
 	void RenderWeaponTrails();
-	void RenderNamePicking();
 	void RenderOutlineNPCs();
 	void RenderSubSelectionNPCs();
 	void RenderSubSelectionNormalNPCs();
@@ -93,6 +102,12 @@ public:
 	static float NPC_INTERACTION_RADIUS_CHECK;
 
 private:
+	// NPCs are in the spatial grid with their attack reach, so enemies can find the NPCs that can hit them
+	void UpdateSpatialGrid(NPC* pNPC);
+
+	static void _IntegrateNPCs(void* pData, int begin, int end);
+	static bool _RayPickNPC(void* pData, void* pObject, const glm::vec3& origin, const glm::vec3& direction, float* pDistance);
+
 	Renderer* m_pRenderer;
 	ChunkManager* m_pChunkManager;
 	LightingManager* m_pLightingManager;
@@ -103,9 +118,17 @@ private:
 	ProjectileManager* m_pProjectileManager;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	EnemyManager* m_pEnemyManager;
+	SpatialGrid* m_pSpatialGrid;
+	NavigationGraph* m_pNavigationGraph;
 
 	int m_numRenderNPCs;
 
+	// NPCs ticking this frame at the full and reduced tiers, and the one of them handed to the integrate jobs
+	NPCList m_vpFullNPCList;
+	NPCList m_vpReducedNPCList;
+	NPCList* m_pIntegrateNPCList;
+	SimulationStats m_simulationStats;
+
 	// NPC List
 	tthread::mutex m_NPCMutex;
 	NPCList m_vpNPCList;
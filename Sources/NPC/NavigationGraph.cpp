@@ -0,0 +1,1220 @@
+/*************************************************************************
+> File Name: NavigationGraph.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 The blocks a character can stand in, grouped into connected regions
+> 	 per chunk and linked to the regions of the neighboring chunks. NPCs
+> 	 search the regions first and only walk the blocks along the way.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+#include <Blocks/ChunkManager.h>
+
+#include "NavigationGraph.h"
+
+const int NAVIGATION_CHUNK_CELLS = Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE;
+
+// The blocks sampled for a chunk reach one below it, for the floor of its bottom layer,
+// and two above it, for the head room of its top layer
+const int NAVIGATION_SAMPLE_BELOW = 1;
+const int NAVIGATION_SAMPLE_HEIGHT = Chunk::CHUNK_SIZE + 3;
+
+// Each block keeps its region in the low bits, and whether there is room above the head to step up or down from it
+const unsigned char NAVIGATION_REGION_MASK = 0x7F;
+const unsigned char NAVIGATION_CELL_TALL = 0x80;
+
+// Marks the blocks that are walkable but not in a region yet, blocks left over past the last region are not walkable
+const unsigned char NAVIGATION_REGION_UNASSIGNED = NAVIGATION_REGION_MASK;
+const int NAVIGATION_MAX_REGIONS = NAVIGATION_REGION_MASK - 1;
+
+// A character's center is at most this many blocks above the block it stands in
+const int NAVIGATION_MAX_STAND_DEPTH = 3;
+
+// Goals searched for this many times get a path tree
+const int NAVIGATION_SHARED_GOAL_REQUESTS = 3;
+const int NAVIGATION_MAX_PATH_TREES = 16;
+const int NAVIGATION_MAX_GOAL_REQUESTS = 256;
+
+// Longest straight line a smoothed path takes, in blocks
+const int NAVIGATION_MAX_SMOOTH_DISTANCE = 16;
+
+// Chunk coordinates are packed into 21 bits each
+const int NAVIGATION_KEY_BITS = 21;
+const int NAVIGATION_KEY_OFFSET = 1 << (NAVIGATION_KEY_BITS - 1);
+const long long NAVIGATION_KEY_MASK = (1LL << NAVIGATION_KEY_BITS) - 1;
+
+const int NAVIGATION_DIRECTION_X[4] = { 1, -1, 0, 0 };
+const int NAVIGATION_DIRECTION_Z[4] = { 0, 0, 1, -1 };
+
+static int GetBlockCoordinate(float value)
+{
+	return static_cast<int>(std::floor((value + Chunk::BLOCK_RENDER_SIZE) / (Chunk::BLOCK_RENDER_SIZE * 2.0f)));
+}
+
+static int GetChunkCoordinate(int blockCoordinate)
+{
+	if (blockCoordinate >= 0)
+	{
+		return blockCoordinate / Chunk::CHUNK_SIZE;
+	}
+
+	return -((-blockCoordinate + Chunk::CHUNK_SIZE - 1) / Chunk::CHUNK_SIZE);
+}
+
+static int GetLocalIndex(int x, int y, int z)
+{
+	return x + Chunk::CHUNK_SIZE * (z + Chunk::CHUNK_SIZE * y);
+}
+
+static glm::vec3 GetCellPosition(const NavigationCell& cell)
+{
+	return glm::vec3(static_cast<float>(cell.x), static_cast<float>(cell.y), static_cast<float>(cell.z)) * (Chunk::BLOCK_RENDER_SIZE * 2.0f);
+}
+
+// Constructor, Destructor
+NavigationGraph::NavigationGraph(ChunkManager* pChunkManager) :
+	m_pChunkManager(pChunkManager), m_blockFunction(nullptr), m_pBlockData(nullptr),
+	m_numNodes(0), m_version(0), m_numQueries(0), m_searchStamp(0), m_cellStamp(0)
+{
+	m_cellParents.assign(NAVIGATION_CHUNK_CELLS, 0);
+	m_cellStamps.assign(NAVIGATION_CHUNK_CELLS, 0);
+}
+
+NavigationGraph::~NavigationGraph()
+{
+	for (auto iter = m_chunks.begin(); iter != m_chunks.end(); ++iter)
+	{
+		delete iter->second;
+	}
+
+	m_chunks.clear();
+}
+
+void NavigationGraph::SetBlockFunction(NavigationBlockFunction blockFunction, void* pBlockData)
+{
+	m_blockFunction = blockFunction;
+	m_pBlockData = pBlockData;
+}
+
+void NavigationGraph::QueueChunk(int chunkX, int chunkY, int chunkZ)
+{
+	m_queueMutex.lock();
+
+	// The chunks above and below stand on this chunk's top layer or need its bottom layer for head room
+	m_queuedChunks.insert(GetChunkKey(chunkX, chunkY - 1, chunkZ));
+	m_queuedChunks.insert(GetChunkKey(chunkX, chunkY, chunkZ));
+	m_queuedChunks.insert(GetChunkKey(chunkX, chunkY + 1, chunkZ));
+
+	m_queueMutex.unlock();
+}
+
+int NavigationGraph::Update(int maxChunks)
+{
+	int numRebuilt = 0;
+
+	while (numRebuilt < maxChunks)
+	{
+		m_queueMutex.lock();
+
+		if (m_queuedChunks.empty())
+		{
+			m_queueMutex.unlock();
+			break;
+		}
+
+		long long key = *m_queuedChunks.begin();
+		m_queuedChunks.erase(m_queuedChunks.begin());
+
+		m_queueMutex.unlock();
+
+		int chunkX, chunkY, chunkZ;
+		GetChunkFromKey(key, &chunkX, &chunkY, &chunkZ);
+
+		RebuildChunk(chunkX, chunkY, chunkZ);
+		numRebuilt++;
+	}
+
+	return numRebuilt;
+}
+
+bool NavigationGraph::FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>* pPath, bool useCache)
+{
+	pPath->clear();
+	m_numQueries++;
+
+	NavigationCell startCell;
+	NavigationCell goalCell;
+	if (FindStandingCell(start, &startCell) == false || FindStandingCell(goal, &goalCell) == false)
+	{
+		return false;
+	}
+
+	int startNode = GetCellNode(startCell);
+	int goalNode = GetCellNode(goalCell);
+
+	std::vector<int> nodePath;
+	bool isFound = useCache ? FindCachedNodePath(startNode, goalNode, &nodePath) : FindNodePath(startNode, goalNode, &nodePath);
+
+	if (isFound == false)
+	{
+		return false;
+	}
+
+	// Walk the blocks of each region on the way, from where it was entered to the way out into the next one.
+	// Most regions can be crossed in a straight line, only the others are searched block by block.
+	std::vector<NavigationCell> cells;
+	cells.push_back(startCell);
+
+	auto walkRegion = [this, &cells](int nodeIndex, const NavigationCell& from, const NavigationCell& to)
+	{
+		if (IsWalkableLine(from, to))
+		{
+			if (from.x != to.x || from.y != to.y || from.z != to.z)
+			{
+				cells.push_back(to);
+			}
+
+			return true;
+		}
+
+		return FindRegionCells(nodeIndex, from, to, &cells);
+	};
+
+	NavigationCell currentCell = startCell;
+	for (size_t i = 0; i + 1 < nodePath.size(); ++i)
+	{
+		const NavigationEdge* pEdge = FindEdge(nodePath[i], nodePath[i + 1]);
+
+		if (walkRegion(nodePath[i], currentCell, pEdge->m_fromCell) == false)
+		{
+			return false;
+		}
+
+		cells.push_back(pEdge->m_toCell);
+		currentCell = pEdge->m_toCell;
+	}
+
+	if (walkRegion(nodePath.back(), currentCell, goalCell) == false)
+	{
+		return false;
+	}
+
+	SmoothPath(cells, pPath);
+
+	return true;
+}
+
+unsigned int NavigationGraph::GetVersion() const
+{
+	return m_version;
+}
+
+int NavigationGraph::GetNumChunks() const
+{
+	return static_cast<int>(m_chunks.size());
+}
+
+int NavigationGraph::GetNumNodes() const
+{
+	return m_numNodes;
+}
+
+int NavigationGraph::GetNumEdges() const
+{
+	int numEdges = 0;
+
+	for (size_t i = 0; i < m_nodes.size(); ++i)
+	{
+		numEdges += static_cast<int>(m_nodes[i].m_edges.size());
+	}
+
+	// Every edge is stored on both of its nodes
+	return numEdges / 2;
+}
+
+int NavigationGraph::GetNumQueuedChunks()
+{
+	m_queueMutex.lock();
+	int numQueuedChunks = static_cast<int>(m_queuedChunks.size());
+	m_queueMutex.unlock();
+
+	return numQueuedChunks;
+}
+
+int NavigationGraph::GetNumCachedGoals() const
+{
+	return static_cast<int>(m_pathTrees.size());
+}
+
+long long NavigationGraph::GetChunkKey(int chunkX, int chunkY, int chunkZ) const
+{
+	long long packedX = (static_cast<long long>(chunkX) + NAVIGATION_KEY_OFFSET) & NAVIGATION_KEY_MASK;
+	long long packedY = (static_cast<long long>(chunkY) + NAVIGATION_KEY_OFFSET) & NAVIGATION_KEY_MASK;
+	long long packedZ = (static_cast<long long>(chunkZ) + NAVIGATION_KEY_OFFSET) & NAVIGATION_KEY_MASK;
+
+	return (packedX << (NAVIGATION_KEY_BITS * 2)) | (packedY << NAVIGATION_KEY_BITS) | packedZ;
+}
+
+void NavigationGraph::GetChunkFromKey(long long key, int* pChunkX, int* pChunkY, int* pChunkZ) const
+{
+	*pChunkX = static_cast<int>((key >> (NAVIGATION_KEY_BITS * 2)) & NAVIGATION_KEY_MASK) - NAVIGATION_KEY_OFFSET;
+	*pChunkY = static_cast<int>((key >> NAVIGATION_KEY_BITS) & NAVIGATION_KEY_MASK) - NAVIGATION_KEY_OFFSET;
+	*pChunkZ = static_cast<int>(key & NAVIGATION_KEY_MASK) - NAVIGATION_KEY_OFFSET;
+}
+
+bool NavigationGraph::SampleChunk(int chunkX, int chunkY, int chunkZ, std::vector<unsigned char>* pSolid) const
+{
+	pSolid->assign(Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE * NAVIGATION_SAMPLE_HEIGHT, 0);
+
+	if (m_blockFunction != nullptr)
+	{
+		int baseX = chunkX * Chunk::CHUNK_SIZE;
+		int baseY = chunkY * Chunk::CHUNK_SIZE;
+		int baseZ = chunkZ * Chunk::CHUNK_SIZE;
+
+		for (int y = -NAVIGATION_SAMPLE_BELOW; y < NAVIGATION_SAMPLE_HEIGHT - NAVIGATION_SAMPLE_BELOW; ++y)
+		{
+			for (int z = 0; z < Chunk::CHUNK_SIZE; ++z)
+			{
+				for (int x = 0; x < Chunk::CHUNK_SIZE; ++x)
+				{
+					(*pSolid)[GetLocalIndex(x, y + NAVIGATION_SAMPLE_BELOW, z)] = m_blockFunction(m_pBlockData, baseX + x, baseY + y, baseZ + z) ? 1 : 0;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Chunks that are still being generated count as missing until they are done
+	Chunk* pChunk = m_pChunkManager->GetChunk(chunkX, chunkY, chunkZ);
+	if (pChunk == nullptr || pChunk->IsSetup() == false)
+	{
+		return false;
+	}
+
+	Chunk* pChunkBelow = m_pChunkManager->GetChunk(chunkX, chunkY - 1, chunkZ);
+	Chunk* pChunkAbove = m_pChunkManager->GetChunk(chunkX, chunkY + 1, chunkZ);
+
+	for (int y = -NAVIGATION_SAMPLE_BELOW; y < NAVIGATION_SAMPLE_HEIGHT - NAVIGATION_SAMPLE_BELOW; ++y)
+	{
+		Chunk* pLayerChunk = pChunk;
+		int layerY = y;
+
+		if (y < 0)
+		{
+			pLayerChunk = pChunkBelow;
+			layerY = y + Chunk::CHUNK_SIZE;
+		}
+		else if (y >= Chunk::CHUNK_SIZE)
+		{
+			pLayerChunk = pChunkAbove;
+			layerY = y - Chunk::CHUNK_SIZE;
+		}
+
+		// A missing chunk below has no floor to stand on, a missing chunk above is open air
+		if (pLayerChunk == nullptr || pLayerChunk->IsSetup() == false)
+		{
+			continue;
+		}
+
+		for (int z = 0; z < Chunk::CHUNK_SIZE; ++z)
+		{
+			for (int x = 0; x < Chunk::CHUNK_SIZE; ++x)
+			{
+				(*pSolid)[GetLocalIndex(x, y + NAVIGATION_SAMPLE_BELOW, z)] = pLayerChunk->GetActive(x, layerY, z) ? 1 : 0;
+			}
+		}
+	}
+
+	return true;
+}
+
+void NavigationGraph::RebuildChunk(int chunkX, int chunkY, int chunkZ)
+{
+	long long key = GetChunkKey(chunkX, chunkY, chunkZ);
+
+	auto iter = m_chunks.find(key);
+	if (iter != m_chunks.end())
+	{
+		RemoveChunk(iter->second);
+
+		delete iter->second;
+		m_chunks.erase(iter);
+	}
+
+	m_version++;
+
+	std::vector<unsigned char> solid;
+	if (SampleChunk(chunkX, chunkY, chunkZ, &solid) == false)
+	{
+		return;
+	}
+
+	auto isSolid = [&solid](int x, int y, int z)
+	{
+		return solid[GetLocalIndex(x, y + NAVIGATION_SAMPLE_BELOW, z)] != 0;
+	};
+
+	// A character can stand in an empty block with room for its head above and a solid block below
+	std::vector<unsigned char> cells(NAVIGATION_CHUNK_CELLS, 0);
+	int numWalkableCells = 0;
+
+	for (int y = 0; y < Chunk::CHUNK_SIZE; ++y)
+	{
+		for (int z = 0; z < Chunk::CHUNK_SIZE; ++z)
+		{
+			for (int x = 0; x < Chunk::CHUNK_SIZE; ++x)
+			{
+				if (isSolid(x, y - 1, z) && isSolid(x, y, z) == false && isSolid(x, y + 1, z) == false)
+				{
+					cells[GetLocalIndex(x, y, z)] = NAVIGATION_REGION_UNASSIGNED | (isSolid(x, y + 2, z) ? 0 : NAVIGATION_CELL_TALL);
+					numWalkableCells++;
+				}
+			}
+		}
+	}
+
+	if (numWalkableCells == 0)
+	{
+		return;
+	}
+
+	ChunkNavigation* pChunkNavigation = new ChunkNavigation();
+	pChunkNavigation->m_chunkX = chunkX;
+	pChunkNavigation->m_chunkY = chunkY;
+	pChunkNavigation->m_chunkZ = chunkZ;
+
+	// Flood the walkable blocks into regions, the blocks of a region can all be walked to from each other without leaving the chunk
+	std::vector<int>& queue = m_cellQueue;
+
+	for (int i = 0; i < NAVIGATION_CHUNK_CELLS && static_cast<int>(pChunkNavigation->m_regionNodes.size()) < NAVIGATION_MAX_REGIONS; ++i)
+	{
+		if ((cells[i] & NAVIGATION_REGION_MASK) != NAVIGATION_REGION_UNASSIGNED)
+		{
+			continue;
+		}
+
+		int region = static_cast<int>(pChunkNavigation->m_regionNodes.size()) + 1;
+		cells[i] = (cells[i] & NAVIGATION_CELL_TALL) | static_cast<unsigned char>(region);
+
+		queue.clear();
+		queue.push_back(i);
+
+		glm::vec3 cellSum;
+
+		for (size_t q = 0; q < queue.size(); ++q)
+		{
+			int cellIndex = queue[q];
+			int x = cellIndex % Chunk::CHUNK_SIZE;
+			int z = (cellIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE;
+			int y = cellIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+
+			cellSum += glm::vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+
+			for (int direction = 0; direction < 4; ++direction)
+			{
+				int neighborX = x + NAVIGATION_DIRECTION_X[direction];
+				int neighborZ = z + NAVIGATION_DIRECTION_Z[direction];
+
+				if (neighborX < 0 || neighborX >= Chunk::CHUNK_SIZE || neighborZ < 0 || neighborZ >= Chunk::CHUNK_SIZE)
+				{
+					continue;
+				}
+
+				for (int stepY = -1; stepY <= 1; ++stepY)
+				{
+					int neighborY = y + stepY;
+
+					if (neighborY < 0 || neighborY >= Chunk::CHUNK_SIZE)
+					{
+						continue;
+					}
+
+					int neighborIndex = GetLocalIndex(neighborX, neighborY, neighborZ);
+					if ((cells[neighborIndex] & NAVIGATION_REGION_MASK) != NAVIGATION_REGION_UNASSIGNED)
+					{
+						continue;
+					}
+
+					// Stepping up or down needs room for the head over the lower block
+					if ((stepY == 1 && (cells[cellIndex] & NAVIGATION_CELL_TALL) == 0) || (stepY == -1 && (cells[neighborIndex] & NAVIGATION_CELL_TALL) == 0))
+					{
+						continue;
+					}
+
+					cells[neighborIndex] = (cells[neighborIndex] & NAVIGATION_CELL_TALL) | static_cast<unsigned char>(region);
+					queue.push_back(neighborIndex);
+				}
+			}
+		}
+
+		// The region's node sits on its block closest to the middle of the region
+		glm::vec3 cellMiddle = cellSum / static_cast<float>(queue.size());
+		int centerIndex = queue[0];
+		float centerDistance = -1.0f;
+
+		for (size_t q = 0; q < queue.size(); ++q)
+		{
+			int cellIndex = queue[q];
+			glm::vec3 cellPosition(static_cast<float>(cellIndex % Chunk::CHUNK_SIZE), static_cast<float>(cellIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE)), static_cast<float>((cellIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE));
+			glm::vec3 toMiddle = cellPosition - cellMiddle;
+			float distance = dot(toMiddle, toMiddle);
+
+			if (centerDistance < 0.0f || distance < centerDistance)
+			{
+				centerIndex = cellIndex;
+				centerDistance = distance;
+			}
+		}
+
+		NavigationCell centerCell;
+		centerCell.x = chunkX * Chunk::CHUNK_SIZE + centerIndex % Chunk::CHUNK_SIZE;
+		centerCell.y = chunkY * Chunk::CHUNK_SIZE + centerIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+		centerCell.z = chunkZ * Chunk::CHUNK_SIZE + (centerIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE;
+
+		int nodeIndex = AllocateNode();
+		NavigationNode& node = m_nodes[nodeIndex];
+		node.m_pChunk = pChunkNavigation;
+		node.m_region = region;
+		node.m_center = GetCellPosition(centerCell);
+
+		pChunkNavigation->m_regionNodes.push_back(nodeIndex);
+	}
+
+	// Blocks past the last region are left out of the graph
+	for (int i = 0; i < NAVIGATION_CHUNK_CELLS; ++i)
+	{
+		if ((cells[i] & NAVIGATION_REGION_MASK) == NAVIGATION_REGION_UNASSIGNED)
+		{
+			cells[i] = 0;
+		}
+	}
+
+	pChunkNavigation->m_cells.swap(cells);
+	m_chunks[key] = pChunkNavigation;
+
+	ConnectChunk(pChunkNavigation);
+}
+
+void NavigationGraph::RemoveChunk(ChunkNavigation* pChunkNavigation)
+{
+	for (size_t i = 0; i < pChunkNavigation->m_regionNodes.size(); ++i)
+	{
+		int nodeIndex = pChunkNavigation->m_regionNodes[i];
+		const std::vector<NavigationEdge>& edges = m_nodes[nodeIndex].m_edges;
+
+		// The neighboring regions stay, only their way back into this chunk goes
+		for (size_t j = 0; j < edges.size(); ++j)
+		{
+			std::vector<NavigationEdge>& neighborEdges = m_nodes[edges[j].m_toNode].m_edges;
+
+			neighborEdges.erase(std::remove_if(neighborEdges.begin(), neighborEdges.end(), [nodeIndex](const NavigationEdge& edge)
+			{
+				return edge.m_toNode == nodeIndex;
+			}), neighborEdges.end());
+		}
+
+		FreeNode(nodeIndex);
+	}
+
+	pChunkNavigation->m_regionNodes.clear();
+}
+
+void NavigationGraph::ConnectChunk(ChunkNavigation* pChunkNavigation)
+{
+	struct NavigationCrossing
+	{
+		int m_fromNode;
+		int m_toNode;
+		NavigationCell m_fromCell;
+		NavigationCell m_toCell;
+	};
+
+	std::vector<NavigationCrossing> crossings;
+
+	int baseX = pChunkNavigation->m_chunkX * Chunk::CHUNK_SIZE;
+	int baseY = pChunkNavigation->m_chunkY * Chunk::CHUNK_SIZE;
+	int baseZ = pChunkNavigation->m_chunkZ * Chunk::CHUNK_SIZE;
+
+	// Every step out of the chunk onto a walkable block of another chunk
+	for (int cellIndex = 0; cellIndex < NAVIGATION_CHUNK_CELLS; ++cellIndex)
+	{
+		unsigned char cell = pChunkNavigation->m_cells[cellIndex];
+		if (cell == 0)
+		{
+			continue;
+		}
+
+		int x = cellIndex % Chunk::CHUNK_SIZE;
+		int z = (cellIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE;
+		int y = cellIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+
+		for (int direction = 0; direction < 4; ++direction)
+		{
+			int neighborX = x + NAVIGATION_DIRECTION_X[direction];
+			int neighborZ = z + NAVIGATION_DIRECTION_Z[direction];
+
+			for (int stepY = -1; stepY <= 1; ++stepY)
+			{
+				int neighborY = y + stepY;
+
+				bool isInsideChunk = neighborX >= 0 && neighborX < Chunk::CHUNK_SIZE && neighborY >= 0 && neighborY < Chunk::CHUNK_SIZE && neighborZ >= 0 && neighborZ < Chunk::CHUNK_SIZE;
+				if (isInsideChunk)
+				{
+					continue;
+				}
+
+				unsigned char neighborCell = GetCell(baseX + neighborX, baseY + neighborY, baseZ + neighborZ);
+				if (neighborCell == 0)
+				{
+					continue;
+				}
+
+				if ((stepY == 1 && (cell & NAVIGATION_CELL_TALL) == 0) || (stepY == -1 && (neighborCell & NAVIGATION_CELL_TALL) == 0))
+				{
+					continue;
+				}
+
+				NavigationCrossing crossing;
+				crossing.m_fromCell.x = baseX + x;
+				crossing.m_fromCell.y = baseY + y;
+				crossing.m_fromCell.z = baseZ + z;
+				crossing.m_toCell.x = baseX + neighborX;
+				crossing.m_toCell.y = baseY + neighborY;
+				crossing.m_toCell.z = baseZ + neighborZ;
+				crossing.m_fromNode = pChunkNavigation->m_regionNodes[(cell & NAVIGATION_REGION_MASK) - 1];
+				crossing.m_toNode = GetCellNode(crossing.m_toCell);
+
+				crossings.push_back(crossing);
+			}
+		}
+	}
+
+	std::sort(crossings.begin(), crossings.end(), [](const NavigationCrossing& crossing1, const NavigationCrossing& crossing2)
+	{
+		return crossing1.m_fromNode < crossing2.m_fromNode || (crossing1.m_fromNode == crossing2.m_fromNode && crossing1.m_toNode < crossing2.m_toNode);
+	});
+
+	// One edge per pair of regions, through the crossing closest to the middle of all their crossings
+	size_t groupStart = 0;
+	while (groupStart < crossings.size())
+	{
+		size_t groupEnd = groupStart;
+		glm::vec3 crossingSum;
+
+		while (groupEnd < crossings.size() && crossings[groupEnd].m_fromNode == crossings[groupStart].m_fromNode && crossings[groupEnd].m_toNode == crossings[groupStart].m_toNode)
+		{
+			crossingSum += GetCellPosition(crossings[groupEnd].m_fromCell);
+			groupEnd++;
+		}
+
+		glm::vec3 crossingMiddle = crossingSum / static_cast<float>(groupEnd - groupStart);
+		size_t bestCrossing = groupStart;
+		float bestDistance = -1.0f;
+
+		for (size_t i = groupStart; i < groupEnd; ++i)
+		{
+			glm::vec3 toMiddle = GetCellPosition(crossings[i].m_fromCell) - crossingMiddle;
+			float distance = dot(toMiddle, toMiddle);
+
+			if (bestDistance < 0.0f || distance < bestDistance)
+			{
+				bestCrossing = i;
+				bestDistance = distance;
+			}
+		}
+
+		const NavigationCrossing& crossing = crossings[bestCrossing];
+		float cost = GetEdgeCost(m_nodes[crossing.m_fromNode], crossing.m_fromCell, crossing.m_toCell, m_nodes[crossing.m_toNode]);
+
+		NavigationEdge edge;
+		edge.m_toNode = crossing.m_toNode;
+		edge.m_cost = cost;
+		edge.m_fromCell = crossing.m_fromCell;
+		edge.m_toCell = crossing.m_toCell;
+		m_nodes[crossing.m_fromNode].m_edges.push_back(edge);
+
+		NavigationEdge backEdge;
+		backEdge.m_toNode = crossing.m_fromNode;
+		backEdge.m_cost = cost;
+		backEdge.m_fromCell = crossing.m_toCell;
+		backEdge.m_toCell = crossing.m_fromCell;
+		m_nodes[crossing.m_toNode].m_edges.push_back(backEdge);
+
+		groupStart = groupEnd;
+	}
+}
+
+int NavigationGraph::AllocateNode()
+{
+	int nodeIndex;
+
+	if (m_freeNodes.empty())
+	{
+		nodeIndex = static_cast<int>(m_nodes.size());
+
+		NavigationNode node;
+		node.m_pChunk = nullptr;
+		node.m_region = 0;
+		node.m_generation = 0;
+		m_nodes.push_back(node);
+	}
+	else
+	{
+		nodeIndex = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+
+	// Path trees remember the generation, so they can tell a reused node from the one they were built with
+	m_nodes[nodeIndex].m_generation++;
+	m_numNodes++;
+
+	return nodeIndex;
+}
+
+void NavigationGraph::FreeNode(int nodeIndex)
+{
+	m_nodes[nodeIndex].m_pChunk = nullptr;
+	m_nodes[nodeIndex].m_edges.clear();
+
+	m_freeNodes.push_back(nodeIndex);
+	m_numNodes--;
+}
+
+unsigned char NavigationGraph::GetCell(int x, int y, int z) const
+{
+	int chunkX = GetChunkCoordinate(x);
+	int chunkY = GetChunkCoordinate(y);
+	int chunkZ = GetChunkCoordinate(z);
+
+	auto iter = m_chunks.find(GetChunkKey(chunkX, chunkY, chunkZ));
+	if (iter == m_chunks.end())
+	{
+		return 0;
+	}
+
+	return iter->second->m_cells[GetLocalIndex(x - chunkX * Chunk::CHUNK_SIZE, y - chunkY * Chunk::CHUNK_SIZE, z - chunkZ * Chunk::CHUNK_SIZE)];
+}
+
+int NavigationGraph::GetCellNode(const NavigationCell& cell) const
+{
+	int chunkX = GetChunkCoordinate(cell.x);
+	int chunkY = GetChunkCoordinate(cell.y);
+	int chunkZ = GetChunkCoordinate(cell.z);
+
+	auto iter = m_chunks.find(GetChunkKey(chunkX, chunkY, chunkZ));
+	if (iter == m_chunks.end())
+	{
+		return -1;
+	}
+
+	const ChunkNavigation* pChunkNavigation = iter->second;
+	int region = pChunkNavigation->m_cells[GetLocalIndex(cell.x - chunkX * Chunk::CHUNK_SIZE, cell.y - chunkY * Chunk::CHUNK_SIZE, cell.z - chunkZ * Chunk::CHUNK_SIZE)] & NAVIGATION_REGION_MASK;
+
+	if (region == 0)
+	{
+		return -1;
+	}
+
+	return pChunkNavigation->m_regionNodes[region - 1];
+}
+
+bool NavigationGraph::FindStandingCell(const glm::vec3& position, NavigationCell* pCell) const
+{
+	int x = GetBlockCoordinate(position.x);
+	int y = GetBlockCoordinate(position.y);
+	int z = GetBlockCoordinate(position.z);
+
+	// Characters may be jumping or sunk into the block they stand in
+	for (int depth = -1; depth <= NAVIGATION_MAX_STAND_DEPTH; ++depth)
+	{
+		if (GetCell(x, y - depth, z) != 0)
+		{
+			pCell->x = x;
+			pCell->y = y - depth;
+			pCell->z = z;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool NavigationGraph::FindStep(const NavigationCell& from, int toX, int toZ, NavigationCell* pTo) const
+{
+	// Only one of the three blocks in a column can be walkable, each needs the one below it solid and the one above it empty
+	for (int stepY = -1; stepY <= 1; ++stepY)
+	{
+		unsigned char cell = GetCell(toX, from.y + stepY, toZ);
+		if (cell == 0)
+		{
+			continue;
+		}
+
+		if ((stepY == 1 && (GetCell(from.x, from.y, from.z) & NAVIGATION_CELL_TALL) == 0) || (stepY == -1 && (cell & NAVIGATION_CELL_TALL) == 0))
+		{
+			return false;
+		}
+
+		pTo->x = toX;
+		pTo->y = from.y + stepY;
+		pTo->z = toZ;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool NavigationGraph::IsWalkableLine(const NavigationCell& from, const NavigationCell& to) const
+{
+	int distanceX = to.x - from.x;
+	int distanceZ = to.z - from.z;
+	int numSteps = std::max(std::abs(distanceX), std::abs(distanceZ));
+
+	// One step per block along the longer axis, the shorter axis moves at most one block per step
+	NavigationCell currentCell = from;
+	for (int i = 1; i <= numSteps; ++i)
+	{
+		float ratio = static_cast<float>(i) / static_cast<float>(numSteps);
+		int x = static_cast<int>(std::floor(from.x + distanceX * ratio + 0.5f));
+		int z = static_cast<int>(std::floor(from.z + distanceZ * ratio + 0.5f));
+
+		NavigationCell nextCell;
+
+		if (x != currentCell.x && z != currentCell.z)
+		{
+			// Crossing a corner, the blocks on both sides have to be walkable too so the character doesn't catch on a wall
+			NavigationCell sideCellX;
+			NavigationCell sideCellZ;
+
+			if (FindStep(currentCell, x, currentCell.z, &sideCellX) == false || FindStep(currentCell, currentCell.x, z, &sideCellZ) == false)
+			{
+				return false;
+			}
+
+			if (FindStep(sideCellX, x, z, &nextCell) == false)
+			{
+				return false;
+			}
+		}
+		else if (FindStep(currentCell, x, z, &nextCell) == false)
+		{
+			return false;
+		}
+
+		currentCell = nextCell;
+	}
+
+	return currentCell.y == to.y;
+}
+
+float NavigationGraph::GetEdgeCost(const NavigationNode& fromNode, const NavigationCell& fromCell, const NavigationCell& toCell, const NavigationNode& toNode) const
+{
+	glm::vec3 fromPosition = GetCellPosition(fromCell);
+	glm::vec3 toPosition = GetCellPosition(toCell);
+
+	return length(fromPosition - fromNode.m_center) + length(toPosition - fromPosition) + length(toNode.m_center - toPosition);
+}
+
+const NavigationGraph::NavigationEdge* NavigationGraph::FindEdge(int fromNode, int toNode) const
+{
+	const std::vector<NavigationEdge>& edges = m_nodes[fromNode].m_edges;
+
+	for (size_t i = 0; i < edges.size(); ++i)
+	{
+		if (edges[i].m_toNode == toNode)
+		{
+			return &edges[i];
+		}
+	}
+
+	return nullptr;
+}
+
+bool NavigationGraph::FindNodePath(int startNode, int goalNode, std::vector<int>* pNodePath)
+{
+	pNodePath->clear();
+
+	if (m_searchStamps.size() < m_nodes.size())
+	{
+		m_searchCosts.resize(m_nodes.size());
+		m_searchParents.resize(m_nodes.size());
+		m_searchStamps.resize(m_nodes.size(), 0);
+	}
+
+	m_searchStamp++;
+	if (m_searchStamp == 0)
+	{
+		std::fill(m_searchStamps.begin(), m_searchStamps.end(), 0);
+		m_searchStamp = 1;
+	}
+
+	const glm::vec3& goalCenter = m_nodes[goalNode].m_center;
+
+	using OpenNode = std::pair<float, int>;
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> openNodes;
+
+	m_searchStamps[startNode] = m_searchStamp;
+	m_searchCosts[startNode] = 0.0f;
+	m_searchParents[startNode] = -1;
+	openNodes.push(OpenNode(length(goalCenter - m_nodes[startNode].m_center), startNode));
+
+	// A* over the regions, the straight line between the region centers never costs more than the edges
+	bool isFound = false;
+	while (openNodes.empty() == false)
+	{
+		OpenNode openNode = openNodes.top();
+		openNodes.pop();
+
+		int nodeIndex = openNode.second;
+		if (nodeIndex == goalNode)
+		{
+			isFound = true;
+			break;
+		}
+
+		const NavigationNode& node = m_nodes[nodeIndex];
+
+		// Already reached again for less
+		if (openNode.first > m_searchCosts[nodeIndex] + length(goalCenter - node.m_center) + 0.001f)
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < node.m_edges.size(); ++i)
+		{
+			const NavigationEdge& edge = node.m_edges[i];
+			float cost = m_searchCosts[nodeIndex] + edge.m_cost;
+
+			if (m_searchStamps[edge.m_toNode] != m_searchStamp || cost < m_searchCosts[edge.m_toNode])
+			{
+				m_searchStamps[edge.m_toNode] = m_searchStamp;
+				m_searchCosts[edge.m_toNode] = cost;
+				m_searchParents[edge.m_toNode] = nodeIndex;
+
+				openNodes.push(OpenNode(cost + length(goalCenter - m_nodes[edge.m_toNode].m_center), edge.m_toNode));
+			}
+		}
+	}
+
+	if (isFound == false)
+	{
+		return false;
+	}
+
+	for (int nodeIndex = goalNode; nodeIndex != -1; nodeIndex = m_searchParents[nodeIndex])
+	{
+		pNodePath->push_back(nodeIndex);
+	}
+
+	std::reverse(pNodePath->begin(), pNodePath->end());
+
+	return true;
+}
+
+bool NavigationGraph::FindCachedNodePath(int startNode, int goalNode, std::vector<int>* pNodePath)
+{
+	NavigationPathTree* pTree = nullptr;
+
+	for (size_t i = 0; i < m_pathTrees.size(); ++i)
+	{
+		if (m_pathTrees[i].m_goalNode == goalNode && m_pathTrees[i].m_goalGeneration == m_nodes[goalNode].m_generation)
+		{
+			pTree = &m_pathTrees[i];
+			break;
+		}
+	}
+
+	if (pTree == nullptr)
+	{
+		// A tree costs a search of the whole graph, it only pays off for goals that many NPCs head to
+		long long goalKey = (static_cast<long long>(m_nodes[goalNode].m_generation) << 32) | static_cast<long long>(goalNode);
+		int numRequests = ++m_goalRequests[goalKey];
+
+		if (numRequests < NAVIGATION_SHARED_GOAL_REQUESTS)
+		{
+			if (static_cast<int>(m_goalRequests.size()) > NAVIGATION_MAX_GOAL_REQUESTS)
+			{
+				m_goalRequests.clear();
+			}
+
+			return FindNodePath(startNode, goalNode, pNodePath);
+		}
+
+		m_goalRequests.erase(goalKey);
+
+		// Replace the tree used longest ago
+		if (static_cast<int>(m_pathTrees.size()) < NAVIGATION_MAX_PATH_TREES)
+		{
+			m_pathTrees.push_back(NavigationPathTree());
+			pTree = &m_pathTrees.back();
+		}
+		else
+		{
+			pTree = &m_pathTrees[0];
+
+			for (size_t i = 1; i < m_pathTrees.size(); ++i)
+			{
+				if (m_pathTrees[i].m_lastUsed < pTree->m_lastUsed)
+				{
+					pTree = &m_pathTrees[i];
+				}
+			}
+		}
+
+		pTree->m_goalNode = goalNode;
+		pTree->m_goalGeneration = m_nodes[goalNode].m_generation;
+		BuildPathTree(pTree);
+	}
+
+	pTree->m_lastUsed = m_numQueries;
+
+	if (FollowPathTree(*pTree, startNode, pNodePath))
+	{
+		return true;
+	}
+
+	// The blocks changed since the tree was built, the way may have moved or the start may be new
+	if (pTree->m_version != m_version)
+	{
+		BuildPathTree(pTree);
+
+		return FollowPathTree(*pTree, startNode, pNodePath);
+	}
+
+	return false;
+}
+
+bool NavigationGraph::FollowPathTree(const NavigationPathTree& tree, int startNode, std::vector<int>* pNodePath) const
+{
+	pNodePath->clear();
+
+	int nodeIndex = startNode;
+	for (size_t i = 0; i <= tree.m_nextNodes.size(); ++i)
+	{
+		// Nodes added or reused since the tree was built aren't in it
+		if (nodeIndex >= static_cast<int>(tree.m_nextNodes.size()) || m_nodes[nodeIndex].m_pChunk == nullptr || tree.m_nodeGenerations[nodeIndex] != m_nodes[nodeIndex].m_generation)
+		{
+			return false;
+		}
+
+		pNodePath->push_back(nodeIndex);
+
+		if (nodeIndex == tree.m_goalNode)
+		{
+			return true;
+		}
+
+		int nextNode = tree.m_nextNodes[nodeIndex];
+		if (nextNode < 0 || FindEdge(nodeIndex, nextNode) == nullptr)
+		{
+			return false;
+		}
+
+		nodeIndex = nextNode;
+	}
+
+	return false;
+}
+
+void NavigationGraph::BuildPathTree(NavigationPathTree* pTree)
+{
+	if (m_searchStamps.size() < m_nodes.size())
+	{
+		m_searchCosts.resize(m_nodes.size());
+		m_searchParents.resize(m_nodes.size());
+		m_searchStamps.resize(m_nodes.size(), 0);
+	}
+
+	m_searchStamp++;
+	if (m_searchStamp == 0)
+	{
+		std::fill(m_searchStamps.begin(), m_searchStamps.end(), 0);
+		m_searchStamp = 1;
+	}
+
+	pTree->m_version = m_version;
+	pTree->m_nextNodes.assign(m_nodes.size(), -1);
+	pTree->m_nodeGenerations.resize(m_nodes.size());
+
+	for (size_t i = 0; i < m_nodes.size(); ++i)
+	{
+		pTree->m_nodeGenerations[i] = m_nodes[i].m_generation;
+	}
+
+	using OpenNode = std::pair<float, int>;
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> openNodes;
+
+	int goalNode = pTree->m_goalNode;
+	m_searchStamps[goalNode] = m_searchStamp;
+	m_searchCosts[goalNode] = 0.0f;
+	pTree->m_nextNodes[goalNode] = goalNode;
+	openNodes.push(OpenNode(0.0f, goalNode));
+
+	// Dijkstra outwards from the goal, the edges cost the same both ways so each node's parent is its next step to the goal
+	while (openNodes.empty() == false)
+	{
+		OpenNode openNode = openNodes.top();
+		openNodes.pop();
+
+		int nodeIndex = openNode.second;
+		if (openNode.first > m_searchCosts[nodeIndex])
+		{
+			continue;
+		}
+
+		const NavigationNode& node = m_nodes[nodeIndex];
+
+		for (size_t i = 0; i < node.m_edges.size(); ++i)
+		{
+			const NavigationEdge& edge = node.m_edges[i];
+			float cost = m_searchCosts[nodeIndex] + edge.m_cost;
+
+			if (m_searchStamps[edge.m_toNode] != m_searchStamp || cost < m_searchCosts[edge.m_toNode])
+			{
+				m_searchStamps[edge.m_toNode] = m_searchStamp;
+				m_searchCosts[edge.m_toNode] = cost;
+				pTree->m_nextNodes[edge.m_toNode] = nodeIndex;
+
+				openNodes.push(OpenNode(cost, edge.m_toNode));
+			}
+		}
+	}
+}
+
+bool NavigationGraph::FindRegionCells(int nodeIndex, const NavigationCell& from, const NavigationCell& to, std::vector<NavigationCell>* pCells)
+{
+	const NavigationNode& node = m_nodes[nodeIndex];
+	const ChunkNavigation* pChunkNavigation = node.m_pChunk;
+
+	int baseX = pChunkNavigation->m_chunkX * Chunk::CHUNK_SIZE;
+	int baseY = pChunkNavigation->m_chunkY * Chunk::CHUNK_SIZE;
+	int baseZ = pChunkNavigation->m_chunkZ * Chunk::CHUNK_SIZE;
+
+	int fromIndex = GetLocalIndex(from.x - baseX, from.y - baseY, from.z - baseZ);
+	int toIndex = GetLocalIndex(to.x - baseX, to.y - baseY, to.z - baseZ);
+
+	m_cellStamp++;
+	if (m_cellStamp == 0)
+	{
+		std::fill(m_cellStamps.begin(), m_cellStamps.end(), 0);
+		m_cellStamp = 1;
+	}
+
+	// Breadth first from the far end inside the region, so following the parents from the near end walks forwards
+	std::vector<int>& queue = m_cellQueue;
+	queue.clear();
+	queue.push_back(toIndex);
+	m_cellStamps[toIndex] = m_cellStamp;
+	m_cellParents[toIndex] = -1;
+
+	const std::vector<unsigned char>& cells = pChunkNavigation->m_cells;
+	bool isFound = fromIndex == toIndex;
+
+	for (size_t q = 0; q < queue.size() && isFound == false; ++q)
+	{
+		int cellIndex = queue[q];
+		int x = cellIndex % Chunk::CHUNK_SIZE;
+		int z = (cellIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE;
+		int y = cellIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+
+		for (int direction = 0; direction < 4 && isFound == false; ++direction)
+		{
+			int neighborX = x + NAVIGATION_DIRECTION_X[direction];
+			int neighborZ = z + NAVIGATION_DIRECTION_Z[direction];
+
+			if (neighborX < 0 || neighborX >= Chunk::CHUNK_SIZE || neighborZ < 0 || neighborZ >= Chunk::CHUNK_SIZE)
+			{
+				continue;
+			}
+
+			for (int stepY = -1; stepY <= 1; ++stepY)
+			{
+				int neighborY = y + stepY;
+
+				if (neighborY < 0 || neighborY >= Chunk::CHUNK_SIZE)
+				{
+					continue;
+				}
+
+				int neighborIndex = GetLocalIndex(neighborX, neighborY, neighborZ);
+				if ((cells[neighborIndex] & NAVIGATION_REGION_MASK) != node.m_region || m_cellStamps[neighborIndex] == m_cellStamp)
+				{
+					continue;
+				}
+
+				if ((stepY == 1 && (cells[cellIndex] & NAVIGATION_CELL_TALL) == 0) || (stepY == -1 && (cells[neighborIndex] & NAVIGATION_CELL_TALL) == 0))
+				{
+					continue;
+				}
+
+				m_cellStamps[neighborIndex] = m_cellStamp;
+				m_cellParents[neighborIndex] = static_cast<short>(cellIndex);
+				queue.push_back(neighborIndex);
+
+				if (neighborIndex == fromIndex)
+				{
+					isFound = true;
+					break;
+				}
+			}
+		}
+	}
+
+	if (isFound == false)
+	{
+		return false;
+	}
+
+	for (int cellIndex = fromIndex; cellIndex != toIndex; )
+	{
+		cellIndex = m_cellParents[cellIndex];
+
+		NavigationCell cell;
+		cell.x = baseX + cellIndex % Chunk::CHUNK_SIZE;
+		cell.y = baseY + cellIndex / (Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE);
+		cell.z = baseZ + (cellIndex / Chunk::CHUNK_SIZE) % Chunk::CHUNK_SIZE;
+		pCells->push_back(cell);
+	}
+
+	return true;
+}
+
+void NavigationGraph::SmoothPath(const std::vector<NavigationCell>& cells, std::vector<glm::vec3>* pPath) const
+{
+	pPath->clear();
+
+	if (cells.empty())
+	{
+		return;
+	}
+
+	// Pull the path straight, keeping only the blocks where the straight line from the last kept block stops being walkable
+	size_t anchor = 0;
+	for (size_t i = anchor + 2; i < cells.size(); ++i)
+	{
+		int distance = std::max(std::abs(cells[i].x - cells[anchor].x), std::abs(cells[i].z - cells[anchor].z));
+
+		if (distance <= NAVIGATION_MAX_SMOOTH_DISTANCE && IsWalkableLine(cells[anchor], cells[i]))
+		{
+			continue;
+		}
+
+		anchor = i - 1;
+		pPath->push_back(GetCellPosition(cells[anchor]));
+	}
+
+	pPath->push_back(GetCellPosition(cells.back()));
+}
@@ -0,0 +1,165 @@
+/*************************************************************************
+> File Name: NavigationGraph.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 The blocks a character can stand in, grouped into connected regions
+> 	 per chunk and linked to the regions of the neighboring chunks. NPCs
+> 	 search the regions first and only walk the blocks along the way.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_NAVIGATION_GRAPH_H
+#define CUBBY_NAVIGATION_GRAPH_H
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <tinythread/tinythread.h>
+
+// Forward declaration
+class ChunkManager;
+
+// Answers whether the block at the block coordinates is solid, for graphs built from something other than the loaded chunks
+using NavigationBlockFunction = bool(*)(void* pData, int x, int y, int z);
+
+struct NavigationCell
+{
+	int x;
+	int y;
+	int z;
+};
+
+class NavigationGraph
+{
+public:
+	// Constructor, Destructor
+	NavigationGraph(ChunkManager* pChunkManager);
+	~NavigationGraph();
+
+	// Reads the blocks from the function instead of the chunk manager
+	void SetBlockFunction(NavigationBlockFunction blockFunction, void* pBlockData);
+
+	// Marks the chunk as changed, called from the chunk updating thread when a chunk is set up, rebuilt or unloaded
+	void QueueChunk(int chunkX, int chunkY, int chunkZ);
+
+	// Rebuilds the regions of at most maxChunks queued chunks, on the main thread. Returns the number rebuilt.
+	int Update(int maxChunks);
+
+	// Fills pPath with the points to walk through from start to goal, not including start. Goals that have been asked for
+	// by several searches get a tree of the way to them from everywhere, so later searches for them only follow it.
+	bool FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>* pPath, bool useCache = true);
+
+	// Changes every time a chunk is rebuilt, paths found before may go through blocks that have changed since
+	unsigned int GetVersion() const;
+
+	// Statistics
+	int GetNumChunks() const;
+	int GetNumNodes() const;
+	int GetNumEdges() const;
+	int GetNumQueuedChunks();
+	int GetNumCachedGoals() const;
+
+private:
+	// Per chunk, the region each block belongs to
+	struct ChunkNavigation
+	{
+		int m_chunkX;
+		int m_chunkY;
+		int m_chunkZ;
+		std::vector<unsigned char> m_cells;
+		std::vector<int> m_regionNodes;
+	};
+
+	// A way from one region into the next, through the last block on this side and the first block on the other
+	struct NavigationEdge
+	{
+		int m_toNode;
+		float m_cost;
+		NavigationCell m_fromCell;
+		NavigationCell m_toCell;
+	};
+
+	struct NavigationNode
+	{
+		// nullptr while the node is free
+		ChunkNavigation* m_pChunk;
+		int m_region;
+		unsigned int m_generation;
+		glm::vec3 m_center;
+		std::vector<NavigationEdge> m_edges;
+	};
+
+	// The next node towards one goal from every node that can reach it
+	struct NavigationPathTree
+	{
+		int m_goalNode;
+		unsigned int m_goalGeneration;
+		unsigned int m_version;
+		unsigned int m_lastUsed;
+		std::vector<int> m_nextNodes;
+		std::vector<unsigned int> m_nodeGenerations;
+	};
+
+	long long GetChunkKey(int chunkX, int chunkY, int chunkZ) const;
+	void GetChunkFromKey(long long key, int* pChunkX, int* pChunkY, int* pChunkZ) const;
+
+	// Building
+	bool SampleChunk(int chunkX, int chunkY, int chunkZ, std::vector<unsigned char>* pSolid) const;
+	void RebuildChunk(int chunkX, int chunkY, int chunkZ);
+	void RemoveChunk(ChunkNavigation* pChunkNavigation);
+	void ConnectChunk(ChunkNavigation* pChunkNavigation);
+	int AllocateNode();
+	void FreeNode(int nodeIndex);
+
+	// Blocks
+	unsigned char GetCell(int x, int y, int z) const;
+	int GetCellNode(const NavigationCell& cell) const;
+	bool FindStandingCell(const glm::vec3& position, NavigationCell* pCell) const;
+	bool FindStep(const NavigationCell& from, int toX, int toZ, NavigationCell* pTo) const;
+	bool IsWalkableLine(const NavigationCell& from, const NavigationCell& to) const;
+
+	// Searching
+	float GetEdgeCost(const NavigationNode& fromNode, const NavigationCell& fromCell, const NavigationCell& toCell, const NavigationNode& toNode) const;
+	const NavigationEdge* FindEdge(int fromNode, int toNode) const;
+	bool FindNodePath(int startNode, int goalNode, std::vector<int>* pNodePath);
+	bool FindCachedNodePath(int startNode, int goalNode, std::vector<int>* pNodePath);
+	bool FollowPathTree(const NavigationPathTree& tree, int startNode, std::vector<int>* pNodePath) const;
+	void BuildPathTree(NavigationPathTree* pTree);
+	bool FindRegionCells(int nodeIndex, const NavigationCell& from, const NavigationCell& to, std::vector<NavigationCell>* pCells);
+	void SmoothPath(const std::vector<NavigationCell>& cells, std::vector<glm::vec3>* pPath) const;
+
+	ChunkManager* m_pChunkManager;
+	NavigationBlockFunction m_blockFunction;
+	void* m_pBlockData;
+
+	// Chunks waiting to be rebuilt, filled by the chunk updating thread
+	tthread::mutex m_queueMutex;
+	std::set<long long> m_queuedChunks;
+
+	std::unordered_map<long long, ChunkNavigation*> m_chunks;
+	std::vector<NavigationNode> m_nodes;
+	std::vector<int> m_freeNodes;
+	int m_numNodes;
+	unsigned int m_version;
+
+	// Shared paths to the goals searched for most
+	std::vector<NavigationPathTree> m_pathTrees;
+	std::unordered_map<long long, int> m_goalRequests;
+	unsigned int m_numQueries;
+
+	// Search state, reused between searches
+	std::vector<float> m_searchCosts;
+	std::vector<int> m_searchParents;
+	std::vector<unsigned int> m_searchStamps;
+	unsigned int m_searchStamp;
+	std::vector<short> m_cellParents;
+	std::vector<unsigned int> m_cellStamps;
+	unsigned int m_cellStamp;
+	std::vector<int> m_cellQueue;
+};
+
+#endif
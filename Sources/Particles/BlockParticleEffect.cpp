@@ -9,6 +9,8 @@
 
 #include <fstream>
 
+#include <Utils/AssetPack.h>
+
 #include "BlockParticleEffect.h"
 #include "BlockParticleEmitter.h"
 #include "BlockParticleManager.h"
@@ -55,12 +57,10 @@ glm::vec3 BlockParticleEffect::GetPosition() const
 
 void BlockParticleEffect::Import(const char* fileName)
 {
-	std::ifstream importFile;
-
-	// Open the file
-	importFile.open(fileName, std::ios::in);
+	// Open the file, from the asset pack if it is packed
+	std::istringstream importFile;
 
-	if (importFile.is_open())
+	if (AssetPack::GetInstance()->OpenFile(fileName, &importFile))
 	{
 		std::string tempString;
 
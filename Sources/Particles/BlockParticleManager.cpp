@@ -161,8 +161,8 @@ void BlockParticleManager::SetupGLBuffers()
 	{
 		glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
-		GLint inPosition = glGetAttribLocation(pShader->GetProgramObject(), "in_position");
-		GLint inNormal = glGetAttribLocation(pShader->GetProgramObject(), "in_normal");
+		GLint inPosition = pShader->GetAttributeLocation("in_position");
+		GLint inNormal = pShader->GetAttributeLocation("in_normal");
 		// GLint inColor = glGetAttribLocation(pShader->GetProgramObject(), "in_color");
 		// GLint inModelMatrix = glGetAttribLocation(pShader->GetProgramObject(), "in_model_matrix");
 
@@ -939,8 +939,8 @@ void BlockParticleManager::RenderInstanced(bool noWorldOffset)
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
 	// GLint inPosition = glGetAttribLocation(pShader->GetProgramObject(), "in_position");
-	GLint inColor = glGetAttribLocation(pShader->GetProgramObject(), "in_color");
-	GLint inModelMatrix = glGetAttribLocation(pShader->GetProgramObject(), "in_model_matrix");
+	GLint inColor = pShader->GetAttributeLocation("in_color");
+	GLint inModelMatrix = pShader->GetAttributeLocation("in_model_matrix");
 
 	int numBlockParticles = m_vpBlockParticlesList.size();
 	int numBlockParticlesRender = GetNumRenderableParticles(noWorldOffset);
@@ -1098,23 +1098,8 @@ void BlockParticleManager::RenderInstanced(bool noWorldOffset)
 	// Render the block particle instances
 	m_pRenderer->BeginGLSLShader(m_instanceShader);
 
-	GLint projMatrixLoc = glGetUniformLocation(pShader->GetProgramObject(), "projMatrix");
-	GLint viewMatrixLoc = glGetUniformLocation(pShader->GetProgramObject(), "viewMatrix");
-
-	Matrix4 projMat;
-	Matrix4 viewMat;
-	m_pRenderer->GetProjectionMatrix(&projMat);
-	m_pRenderer->GetModelViewMatrix(&viewMat);
-
-	glUniformMatrix4fv(projMatrixLoc, 1, false, projMat.m_data);
-	glUniformMatrix4fv(viewMatrixLoc, 1, false, viewMat.m_data);
-
-	// GLint inLightPosition = glGetUniformLocation(pShader->GetProgramObject(), "in_light_position");
-	// GLint inLightConstA = glGetUniformLocation(pShader->GetProgramObject(), "in_light_const_a");
-	// GLint inLightLinearA = glGetUniformLocation(pShader->GetProgramObject(), "in_light_linear_a");
-	// GLint inLightQuadA = glGetUniformLocation(pShader->GetProgramObject(), "in_light_quad_a");
-	// GLint inLightAmbient = glGetUniformLocation(pShader->GetProgramObject(), "in_light_ambient");
-	// GLint inLightDiffuse = glGetUniformLocation(pShader->GetProgramObject(), "in_light_diffuse");
+	// The camera comes from the shared frame uniforms
+	m_pRenderer->UploadFrameUniforms();
 
 	if (m_renderWireFrame)
 	{
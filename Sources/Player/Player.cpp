@@ -11,6 +11,7 @@
 
 #include <CubbyGame.h>
 
+#include <Blocks/VoxelCollision.h>
 #include <Items/ItemManager.h>
 #include <Maths/3DMaths.h>
 #include <Models/VoxelObject.h>
@@ -33,7 +34,7 @@ Player::Player(Renderer* pRenderer, ChunkManager* pChunkManager, QubicleBinaryMa
 {
 	// Create voxel character
 	m_pVoxelCharacter = new VoxelCharacter(m_pRenderer, m_pQubicleBinaryManager);
-	m_pCharacterBackup = new QubicleBinary(m_pRenderer);
+	m_pCharacterBackup = nullptr;
 
 	// Reset player
 	ResetPlayer();
@@ -58,7 +59,7 @@ Player::~Player()
 
 	if (m_pCharacterBackup != nullptr)
 	{
-		delete m_pCharacterBackup;
+		m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pCharacterBackup);
 	}
 }
 
@@ -382,6 +383,12 @@ float Player::GetRotation() const
 // Loading
 void Player::LoadCharacter(std::string characterName, bool fromCharacterSelectScreen)
 {
+	// Body parts lent out from the backup are owned by the character model from now on
+	if (m_pCharacterBackup != nullptr && m_pVoxelCharacter->GetQubicleModel() != nullptr)
+	{
+		m_pCharacterBackup->SetNullLinkage(m_pVoxelCharacter->GetQubicleModel());
+	}
+
 	m_pVoxelCharacter->UnloadCharacter();
 	m_pVoxelCharacter->Reset();
 
@@ -414,7 +421,7 @@ void Player::LoadCharacter(std::string characterName, bool fromCharacterSelectSc
 		sprintf(characterFileName, "Resources/gamedata/models/%s/%s.character", m_type.c_str(), m_modelName.c_str());
 	}
 
-	m_pVoxelCharacter->LoadVoxelCharacter(m_type.c_str(), qbFileName, ms3dFileName, animListFileName, facesFileName, characterFileName, characterBaseFolder, true);
+	m_pVoxelCharacter->LoadVoxelCharacter(m_type.c_str(), qbFileName, ms3dFileName, animListFileName, facesFileName, characterFileName, characterBaseFolder, false);
 
 	m_pVoxelCharacter->SetBreathingAnimationEnabled(true);
 	m_pVoxelCharacter->SetWinkAnimationEnabled(true);
@@ -426,11 +433,10 @@ void Player::LoadCharacter(std::string characterName, bool fromCharacterSelectSc
 
 	if (m_pCharacterBackup != nullptr)
 	{
-		delete m_pCharacterBackup;
-		m_pCharacterBackup = new QubicleBinary(m_pRenderer);
+		m_pQubicleBinaryManager->DestroyQubicleBinaryInstance(m_pCharacterBackup);
 	}
 
-	m_pCharacterBackup->Import(qbFileName, true);
+	m_pCharacterBackup = m_pQubicleBinaryManager->CreateQubicleBinaryInstance(qbFileName);
 
 	UpdateRadius();
 }
@@ -1111,154 +1117,8 @@ bool Player::CheckCollisions(glm::vec3 positionCheck, glm::vec3 previousPosition
 	bool itemCollision = m_pItemManager->CheckCollisions(positionCheck, previousPosition, radius, pNormal, pMovement);
 
 	// World collision
-	bool worldCollision = false;
-
-	glm::vec3 floorPosition;
-	if (m_pChunkManager->FindClosestFloor(positionCheck, &floorPosition) == false)
-	{
-		*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-		return true;
-	}
-	
-	int blockX, blockY, blockZ;
-	glm::vec3 blockPos;
-	int blockXAbove, blockYAbove, blockZAbove;
-	glm::vec3 blockPosAbove;
-	int numChecks = 1 + static_cast<int>(radius / (Chunk::BLOCK_RENDER_SIZE * 2.0f));
-	bool canAllStepUp = false;
-	bool firstStepUp = true;
-	for (int x = -numChecks; x <= numChecks; ++x)
-	{
-		for (int y = -numChecks; y <= numChecks; ++y)
-		{
-			for (int z = -numChecks; z <= numChecks; ++z)
-			{
-				*pNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-				Chunk* pChunk = GetCachedGridChunkOrFromPosition(positionCheck + glm::vec3((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * y, (Chunk::BLOCK_RENDER_SIZE * 2.0f) * z));
-				bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x), positionCheck.y + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * y), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * z), &blockPos, &blockX, &blockY, &blockZ, &pChunk);
-
-				if (active == false)
-				{
-					if (pChunk == nullptr || pChunk->IsSetup() == false)
-					{
-						*pMovement = glm::vec3(0.0f, 0.0f, 0.0f);
-						worldCollision = true;
-					}
-				}
-				else if (active == true)
-				{
-					Plane3D planes[6];
-					planes[0] = Plane3D(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[1] = Plane3D(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-Chunk::BLOCK_RENDER_SIZE, 0.0f, 0.0f));
-					planes[2] = Plane3D(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[3] = Plane3D(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -Chunk::BLOCK_RENDER_SIZE, 0.0f));
-					planes[4] = Plane3D(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, Chunk::BLOCK_RENDER_SIZE));
-					planes[5] = Plane3D(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -Chunk::BLOCK_RENDER_SIZE));
-
-					float distance;
-					int inside = 0;
-					bool insideCache[6];
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - previousPosition;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-							insideCache[i] = false;
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							insideCache[i] = true;
-						}
-						else
-						{
-							// Inside...
-							insideCache[i] = true;
-						}
-					}
-
-					for (int i = 0; i < 6; ++i)
-					{
-						glm::vec3 pointToCheck = blockPos - positionCheck;
-						distance = planes[i].GetPointDistance(pointToCheck);
-
-						if (distance < -radius)
-						{
-							// Outside...
-						}
-						else if (distance < radius)
-						{
-							// Intersecting..
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-						else
-						{
-							// Inside...
-							inside++;
-							if (insideCache[i] == false)
-							{
-								*pNormal += planes[i].m_normal;
-							}
-						}
-					}
-
-					if (inside == 6)
-					{
-						if (y == 0) // We only want to check on the same y-level as the players position.
-						{
-							glm::vec3 posCheck1 = glm::vec3(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x), positionCheck.y + (Chunk::BLOCK_RENDER_SIZE * 2.0f), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * z));
-							glm::vec3 posCheck2 = glm::vec3(positionCheck.x + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * x), positionCheck.y + (Chunk::BLOCK_RENDER_SIZE * 4.0f), positionCheck.z + ((Chunk::BLOCK_RENDER_SIZE * 2.0f) * z));
-
-							Chunk* pChunkAbove = GetCachedGridChunkOrFromPosition(glm::vec3(posCheck1.x, posCheck1.y, posCheck1.z));
-							bool activeAbove = m_pChunkManager->GetBlockActiveFrom3DPosition(posCheck1.x, posCheck1.y, posCheck1.z, &blockPosAbove, &blockXAbove, &blockYAbove, &blockZAbove, &pChunkAbove);
-							Chunk* pChunkAbove2 = GetCachedGridChunkOrFromPosition(glm::vec3(posCheck2.x, posCheck2.y, posCheck2.z));
-							bool activeAbove2 = m_pChunkManager->GetBlockActiveFrom3DPosition(posCheck2.x, posCheck2.y, posCheck2.z, &blockPosAbove, &blockXAbove, &blockYAbove, &blockZAbove, &pChunkAbove2);
-
-							if ((activeAbove == false) && (activeAbove2 == false))
-							{
-								if (firstStepUp)
-								{
-									canAllStepUp = true;
-								}
-							}
-							else
-							{
-								canAllStepUp = false;
-							}
-
-							firstStepUp = false;
-						}
-
-						if (length(*pNormal) <= 1.0f)
-						{
-							if (length(*pNormal) > 0.0f)
-							{
-								*pNormal = normalize(*pNormal);
-							}
-
-							float dotResult = dot(*pNormal, *pMovement);
-							*pNormal *= dotResult;
-
-							*pMovement -= *pNormal;
-
-							worldCollision = true;
-						}
-					}
-				}
-			}
-		}
-
-		*pStepUpBlock = canAllStepUp;
-	}
+	VoxelCollision voxelCollision(m_pChunkManager);
+	bool worldCollision = voxelCollision.CheckCharacter(positionCheck, previousPosition, radius, pNormal, pMovement, pStepUpBlock);
 
 	if (itemCollision)
 	{
@@ -1552,7 +1412,7 @@ glm::vec3 Player::MoveAbsolute(glm::vec3 direction, const float speed, bool shou
 							m_stepUpAnimationYAmount = 0.0f;
 							m_stepUpAnimationPrevious = 0.0f;
 							m_stepUpAnimationYOffset = 0.0f;
-							Interpolator::GetInstance()->AddFloatInterpolation(&m_stepUpAnimationYAmount, 0.0f, (Chunk::BLOCK_RENDER_SIZE * 2.2f), 0.1f, 0.0f, nullptr, _StepUpAnimationFinished, this);
+							Interpolator::GetInstance()->AddFloatInterpolation(&m_stepUpAnimationYAmount, 0.0f, (Chunk::BLOCK_RENDER_SIZE * 2.2f), 0.1f, 0.0f, _StepUpAnimationFinished, this);
 							Interpolator::GetInstance()->AddFloatInterpolation(&m_stepUpAnimationYOffset, (Chunk::BLOCK_RENDER_SIZE * 2.2f), 0.0f, 0.125f, -100.0f);
 						}
 					}
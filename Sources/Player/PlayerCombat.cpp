@@ -65,7 +65,7 @@ void Player::PressAttack()
 				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::FullBody, true, AnimationSections::FullBody, "SwordAttack1", 0.01f);
 				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::RightArmHand, false, AnimationSections::RightArmHand, "SwordAttack1", 0.01f);
 
-				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.22f, 0.22f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.22f, 0.22f, 0.0f, _AttackAnimationTimerFinished, this);
 
 				m_canAttackRight = false;
 				m_canThrowWeapon = false;
@@ -93,7 +93,7 @@ void Player::PressAttack()
 
 				m_canInteruptCombatAnim = false;
 
-				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.2f, 0.2f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.2f, 0.2f, 0.0f, _AttackAnimationTimerFinished, this);
 
 				m_magic -= 10.0f;
 				CubbyGame::GetInstance()->GetHUD()->UpdatePlayerData();
@@ -112,7 +112,7 @@ void Player::PressAttack()
 			m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::FullBody, true, AnimationSections::FullBody, "SwordAttack2", 0.01f);
 			m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::RightArmHand, false, AnimationSections::RightArmHand, "SwordAttack2", 0.01f);
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.25f, 0.25f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.25f, 0.25f, 0.0f, _AttackAnimationTimerFinished, this);
 
 			m_canAttackRight = false;
 		}
@@ -129,7 +129,7 @@ void Player::PressAttack()
 		{
 			m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::RightArmHand, false, AnimationSections::RightArmHand, "SwordAttack2", 0.01f);
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, _AttackAnimationTimerFinished, this);
 
 			m_canInteruptCombatAnim = true;
 
@@ -143,8 +143,8 @@ void Player::PressAttack()
 			m_attackEnabled = true;
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			m_canAttackRight = false;
@@ -153,7 +153,7 @@ void Player::PressAttack()
 		{
 			m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::LeftArmHand, false, AnimationSections::LeftArmHand, "SwordAttack2", 0.01f);
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, nullptr, _AttackAnimationTimerFinished_Alternative, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, _AttackAnimationTimerFinished_Alternative, this);
 
 			m_canInteruptCombatAnim = true;
 
@@ -167,8 +167,8 @@ void Player::PressAttack()
 			m_attackEnabled = true;
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			m_canAttackLeft = false;
@@ -195,7 +195,7 @@ void Player::PressAttack()
 
 			m_canInteruptCombatAnim = false;
 
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.4f, 0.4f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.4f, 0.4f, 0.0f, _AttackAnimationTimerFinished, this);
 
 			m_canAttackRight = false;
 		}
@@ -223,8 +223,8 @@ void Player::PressAttack()
 			m_attackEnabled = true;
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 
 			m_canAttackRight = false;
@@ -291,8 +291,8 @@ void Player::PressAttack()
 			m_attackEnabled = true;
 			m_attackEnabledTimer = 0.0f;
 			m_attackRotation = startRotation;
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, nullptr, _AttackEnabledTimerFinished, this);
-			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, nullptr, _AttackEnabledDelayTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledTimer, 0.0f, attackTime, attackTime, 0.0f, _AttackEnabledTimerFinished, this);
+			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackEnabledDelayTimer, m_attackEnabledDelayTimer, 0.0f, m_attackEnabledDelayTimer, 0.0f, _AttackEnabledDelayTimerFinished, this);
 			Interpolator::GetInstance()->AddFloatInterpolation(&m_attackRotation, startRotation, endRotation, attackTime, easingRotation);
 		}
 	}
@@ -319,7 +319,7 @@ void Player::PressAttack()
 			{
 				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::RightArmHand, false, AnimationSections::RightArmHand, "HandSpellCastRight", 0.01f);
 
-				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, nullptr, _AttackAnimationTimerFinished, this);
+				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, _AttackAnimationTimerFinished, this);
 
 				m_magic -= 5.0f;
 				CubbyGame::GetInstance()->GetHUD()->UpdatePlayerData();
@@ -330,7 +330,7 @@ void Player::PressAttack()
 			{
 				m_pVoxelCharacter->BlendIntoAnimation(AnimationSections::LeftArmHand, false, AnimationSections::LeftArmHand, "HandSpellCastLeft", 0.01f);
 
-				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, nullptr, _AttackAnimationTimerFinished_Alternative, this);
+				Interpolator::GetInstance()->AddFloatInterpolation(&m_animationTimer, 0.0f, 0.3f, 0.3f, 0.0f, _AttackAnimationTimerFinished_Alternative, this);
 
 				m_magic -= 5.0f;
 				CubbyGame::GetInstance()->GetHUD()->UpdatePlayerData();
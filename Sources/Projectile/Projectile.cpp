@@ -7,6 +7,7 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <Blocks/VoxelCollision.h>
 #include <Lighting/LightingManager.h>
 #include <Maths/3DMaths.h>
 #include <Models/VoxelObject.h>
@@ -39,6 +40,9 @@ Projectile::~Projectile()
 {
 	m_pVoxeProjectile->StopWeaponTrails();
 
+	// The curve timer would otherwise carry on writing to us, and call us back
+	Interpolator::GetInstance()->RemoveInterpolation(m_curveTimerInterpolation);
+
 	UnloadEffectsAndLights();
 
 	if (m_pVoxeProjectile != nullptr)
@@ -317,7 +321,7 @@ void Projectile::SetProjectileCurveParams(glm::vec3 forward, glm::vec3 target, f
 	m_curveTimer = curveTime;
 	m_rightCurve = true;
 
-	Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, m_curveTime, 0.0f, m_curveTime, 0.0f, nullptr, _RightCurveTimerFinished, this);
+	m_curveTimerInterpolation = Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, m_curveTime, 0.0f, m_curveTime, 0.0f, _RightCurveTimerFinished, this);
 }
 
 void Projectile::SetWorldCollisionEnabled(bool enabled)
@@ -551,6 +555,9 @@ void Projectile::Update(float dt)
 
 	glm::vec3 acceleration = (m_gravityDirection * 9.81f) * m_gravityMultiplier;
 
+	// Where this step starts, so the blocks passed through on the way are checked and not only the one it ends in
+	glm::vec3 startPosition = m_position;
+
 	if (m_returnToPlayer)
 	{
 		float t = 1.0f - (m_curveTimer / m_curveTime);
@@ -583,15 +590,15 @@ void Projectile::Update(float dt)
 
 	if (m_worldCollisionEnabled)
 	{
-		glm::vec3 floorPosition;
+		VoxelCollision voxelCollision(m_pChunkManager);
 
-		if (m_pChunkManager->FindClosestFloor(GetCenter(), &floorPosition) == false)
+		if (voxelCollision.HasFloor(GetCenter()) == false)
 		{
 			if (m_returnToPlayer)
 			{
 				if (m_returningDirectToPlayer == false)
 				{
-					Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_curveTimer);
+					Interpolator::GetInstance()->RemoveInterpolation(m_curveTimerInterpolation);
 
 					// Go straight back to player
 					m_bezierStartLeft = m_pPlayer->GetCenter();
@@ -601,7 +608,7 @@ void Projectile::Update(float dt)
 					m_curveTimer = 0.0f;
 					m_rightCurve = false;
 
-					Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
+					m_curveTimerInterpolation = Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
 
 					m_returningDirectToPlayer = true;
 				}
@@ -613,19 +620,15 @@ void Projectile::Update(float dt)
 		}
 		else
 		{
-			int blockX, blockY, blockZ;
-			glm::vec3 blockPos;
-
-			Chunk* pChunk = GetCachedGridChunkOrFromPosition(m_position);
-			bool active = m_pChunkManager->GetBlockActiveFrom3DPosition(m_position.x, m_position.y, m_position.z, &blockPos, &blockX, &blockY, &blockZ, &pChunk);
+			float hitFraction;
 
-			if (pChunk != nullptr && active == true)
+			if (voxelCollision.SweepPoint(startPosition, m_position, &hitFraction))
 			{
 				if (m_returnToPlayer)
 				{
 					if (m_returningDirectToPlayer == false)
 					{
-						Interpolator::GetInstance()->RemoveFloatInterpolationByVariable(&m_curveTimer);
+						Interpolator::GetInstance()->RemoveInterpolation(m_curveTimerInterpolation);
 
 						// Go straight back to player
 						m_bezierStartLeft = m_pPlayer->GetCenter();
@@ -635,15 +638,15 @@ void Projectile::Update(float dt)
 						m_curveTimer = 0.0f;
 						m_rightCurve = false;
 
-						Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
+						m_curveTimerInterpolation = Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
 
 						m_returningDirectToPlayer = true;
 					}
 				}
 				else
 				{
-					// Roll back the integration, since we will intersect the block otherwise
-					m_position -= m_velocity * dt;
+					// Stop where the block was hit, since we will intersect the block otherwise
+					m_position = startPosition + (m_position - startPosition) * hitFraction;
 
 					m_velocity = glm::vec3(0.0f, 0.0f, 0.0f);
 
@@ -866,5 +869,5 @@ void Projectile::RightCurveTimerFinished()
 	m_curveTimer = 0.0f;
 	m_rightCurve = false;
 
-	Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
+	m_curveTimerInterpolation = Interpolator::GetInstance()->AddFloatInterpolation(&m_curveTimer, 0.0f, m_curveTime, m_curveTime, 0.0f);
 }
@@ -12,6 +12,7 @@
 
 #include <Blocks/ChunkManager.h>
 #include <Models/VoxelWeapon.h>
+#include <Utils/Interpolator.h>
 
 // Forward declaration
 class LightingManager;
@@ -167,6 +168,7 @@ private:
 	float m_catchTimer;
 	float m_curveTimer;
 	float m_curveTime;
+	InterpolationHandle m_curveTimerInterpolation;
 	bool m_rightCurve;
 	bool m_returningDirectToPlayer;
 
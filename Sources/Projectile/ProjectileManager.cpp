@@ -11,13 +11,15 @@
 
 #include "CubbyGame.h"
 
+#include <Utils/SpatialGrid.h>
+
 #include "ProjectileManager.h"
 
 // Constructor, Destructor
 ProjectileManager::ProjectileManager(Renderer* pRenderer, ChunkManager* pChunkManager) :
 	m_pRenderer(pRenderer), m_pChunkManager(pChunkManager), m_pLightingManager(nullptr),
 	m_pBlockParticleManager(nullptr), m_pQubicleBinaryManager(nullptr),
-	m_pGameWindow(nullptr), m_pPlayer(nullptr),
+	m_pGameWindow(nullptr), m_pPlayer(nullptr), m_pSpatialGrid(nullptr),
 	m_numRenderProjectiles(0)
 {
 
@@ -48,6 +50,11 @@ void ProjectileManager::SetPlayer(Player* pPlayer)
 	m_pPlayer = pPlayer;
 }
 
+void ProjectileManager::SetSpatialGrid(SpatialGrid* pSpatialGrid)
+{
+	m_pSpatialGrid = pSpatialGrid;
+}
+
 // Clearing
 void ProjectileManager::ClearProjectiles()
 {
@@ -56,6 +63,8 @@ void ProjectileManager::ClearProjectiles()
 
 	for (size_t i = 0; i < m_vpProjectileList.size(); ++i)
 	{
+		m_pSpatialGrid->Remove(m_vpProjectileList[i]);
+
 		delete m_vpProjectileList[i];
 		m_vpProjectileList[i] = nullptr;
 	}
@@ -202,6 +211,13 @@ void ProjectileManager::Update(float dt)
 
 	// Remove any projectiles that need to be erased
 	m_projectileMutex.lock();
+	for (size_t i = 0; i < m_vpProjectileList.size(); ++i)
+	{
+		if (m_vpProjectileList[i]->GetErase())
+		{
+			m_pSpatialGrid->Remove(m_vpProjectileList[i]);
+		}
+	}
 	m_vpProjectileList.erase(remove_if(m_vpProjectileList.begin(), m_vpProjectileList.end(), IsProjectileNeedsErasing), m_vpProjectileList.end());
 	m_projectileMutex.unlock();
 
@@ -213,6 +229,8 @@ void ProjectileManager::Update(float dt)
 		Projectile* pProjectile = m_vpProjectileList[i];
 
 		pProjectile->Update(dt);
+
+		m_pSpatialGrid->Update(pProjectile, SpatialType::Projectile, pProjectile->GetCenter(), pProjectile->GetRadius());
 	}
 
 	m_projectileMutex.unlock();
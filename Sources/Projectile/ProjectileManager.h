@@ -20,6 +20,7 @@
 // Forward declaration
 class LightingManager;
 class GameWindow;
+class SpatialGrid;
 
 using ProjectileList = std::vector<Projectile*>;
 
@@ -34,6 +35,7 @@ public:
 	void SetBlockParticleManager(BlockParticleManager* pBlockParticleManager);
 	void SetQubicleBinaryManager(QubicleBinaryManager* pQubicleBinaryManager);
 	void SetPlayer(Player* pPlayer);
+	void SetSpatialGrid(SpatialGrid* pSpatialGrid);
 
 	// Clearing
 	void ClearProjectiles();
@@ -72,6 +74,7 @@ private:
 	QubicleBinaryManager* m_pQubicleBinaryManager;
 	GameWindow* m_pGameWindow;
 	Player* m_pPlayer;
+	SpatialGrid* m_pSpatialGrid;
 
 	int m_numRenderProjectiles;
 
@@ -0,0 +1,299 @@
+/*************************************************************************
+> File Name: AtlasFont.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A FreeType font whose glyphs live in the shared glyph atlas. Strings
+> 	 are turned into runs of quads once and kept, so text that doesn't
+> 	 change is never laid out again.
+> Created Time: 2016/09/14
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <iostream>
+
+#include "AtlasFont.h"
+
+// Drawn instead of characters the font doesn't have
+const unsigned int REPLACEMENT_CODE_POINT = '?';
+
+// Constructor, Destructor
+AtlasFont::AtlasFont(GlyphAtlas* pGlyphAtlas) :
+	m_pGlyphAtlas(pGlyphAtlas), m_isCreated(false), m_library(nullptr), m_face(nullptr), m_size(0), m_noAutoHint(false)
+{
+
+}
+
+AtlasFont::~AtlasFont()
+{
+	m_glyphs.clear();
+	m_textMeshes.clear();
+
+	if (m_isCreated)
+	{
+		FT_Done_Face(m_face);
+		FT_Done_FreeType(m_library);
+	}
+}
+
+bool AtlasFont::Create(const char* fontName, int size, bool noAutoHint)
+{
+	if (FT_Init_FreeType(&m_library))
+	{
+		std::cout << "ERROR: Could not initialize FreeType for font: " << fontName << std::endl;
+		return false;
+	}
+
+	if (FT_New_Face(m_library, fontName, 0, &m_face))
+	{
+		std::cout << "ERROR: Could not open font: " << fontName << std::endl;
+		FT_Done_FreeType(m_library);
+		return false;
+	}
+
+	FT_Set_Pixel_Sizes(m_face, 0, size);
+
+	m_size = size;
+	m_noAutoHint = noAutoHint;
+	m_isCreated = true;
+
+	// Printable ASCII is always wanted, anything else is loaded the first time it is drawn
+	for (unsigned int codePoint = 32; codePoint < 127; ++codePoint)
+	{
+		GetGlyph(codePoint);
+	}
+
+	return true;
+}
+
+const AtlasTextMesh* AtlasFont::GetTextMesh(const char* text)
+{
+	std::string key(text);
+
+	auto iter = m_textMeshes.find(key);
+	if (iter != m_textMeshes.end())
+	{
+		return &iter->second;
+	}
+
+	if (static_cast<int>(m_textMeshes.size()) >= MAX_TEXT_MESHES)
+	{
+		m_textMeshes.clear();
+	}
+
+	AtlasTextMesh* pTextMesh = &m_textMeshes[key];
+
+	int penX = 0;
+	const char* pText = text;
+	while (*pText != '\0')
+	{
+		const AtlasGlyph* pGlyph = GetGlyph(DecodeUTF8(&pText));
+		if (pGlyph == nullptr)
+		{
+			continue;
+		}
+
+		if (pGlyph->m_hasBitmap)
+		{
+			float x1 = penX + pGlyph->m_x1;
+			float x2 = penX + pGlyph->m_x2;
+			const GlyphAtlasRegion& region = pGlyph->m_region;
+
+			// The bitmap's first row is the top of the glyph
+			SpriteVertex vertices[4] = {
+				{ x1, pGlyph->m_y1, 0.0f, region.m_s1, region.m_t2, 1.0f, 1.0f, 1.0f, 1.0f },
+				{ x2, pGlyph->m_y1, 0.0f, region.m_s2, region.m_t2, 1.0f, 1.0f, 1.0f, 1.0f },
+				{ x2, pGlyph->m_y2, 0.0f, region.m_s2, region.m_t1, 1.0f, 1.0f, 1.0f, 1.0f },
+				{ x1, pGlyph->m_y2, 0.0f, region.m_s1, region.m_t1, 1.0f, 1.0f, 1.0f, 1.0f },
+			};
+			pTextMesh->m_vertices.insert(pTextMesh->m_vertices.end(), vertices, vertices + 4);
+		}
+
+		penX += pGlyph->m_advance;
+	}
+
+	pTextMesh->m_width = penX;
+
+	return pTextMesh;
+}
+
+int AtlasFont::GetTextWidth(const char* text)
+{
+	auto iter = m_textMeshes.find(text);
+	if (iter != m_textMeshes.end())
+	{
+		return iter->second.m_width;
+	}
+
+	// Measuring only needs the advances, so it doesn't build a mesh
+	int width = 0;
+	const char* pText = text;
+	while (*pText != '\0')
+	{
+		const AtlasGlyph* pGlyph = GetGlyph(DecodeUTF8(&pText));
+		if (pGlyph != nullptr)
+		{
+			width += pGlyph->m_advance;
+		}
+	}
+
+	return width;
+}
+
+int AtlasFont::GetSize() const
+{
+	return m_size;
+}
+
+int AtlasFont::GetAscent() const
+{
+	if (m_isCreated == false)
+	{
+		return 0;
+	}
+
+	return m_face->size->metrics.ascender >> 6;
+}
+
+int AtlasFont::GetDescent() const
+{
+	if (m_isCreated == false)
+	{
+		return 0;
+	}
+
+	return m_face->size->metrics.descender >> 6;
+}
+
+void AtlasFont::ClearTextMeshes()
+{
+	m_textMeshes.clear();
+}
+
+int AtlasFont::GetNumTextMeshes() const
+{
+	return static_cast<int>(m_textMeshes.size());
+}
+
+unsigned int AtlasFont::DecodeUTF8(const char** ppText)
+{
+	const unsigned char* pText = reinterpret_cast<const unsigned char*>(*ppText);
+	unsigned int codePoint = pText[0];
+	int numContinuationBytes;
+
+	if (codePoint < 0x80)
+	{
+		numContinuationBytes = 0;
+	}
+	else if ((codePoint & 0xE0) == 0xC0)
+	{
+		codePoint &= 0x1F;
+		numContinuationBytes = 1;
+	}
+	else if ((codePoint & 0xF0) == 0xE0)
+	{
+		codePoint &= 0x0F;
+		numContinuationBytes = 2;
+	}
+	else if ((codePoint & 0xF8) == 0xF0)
+	{
+		codePoint &= 0x07;
+		numContinuationBytes = 3;
+	}
+	else
+	{
+		// A stray continuation byte or an invalid lead byte
+		*ppText += 1;
+		return 0xFFFD;
+	}
+
+	for (int i = 1; i <= numContinuationBytes; ++i)
+	{
+		if ((pText[i] & 0xC0) != 0x80)
+		{
+			// Truncated sequence, carry on from the byte that broke it
+			*ppText += i;
+			return 0xFFFD;
+		}
+
+		codePoint = (codePoint << 6) | (pText[i] & 0x3F);
+	}
+
+	*ppText += numContinuationBytes + 1;
+
+	return codePoint;
+}
+
+const AtlasGlyph* AtlasFont::GetGlyph(unsigned int codePoint)
+{
+	auto iter = m_glyphs.find(codePoint);
+	if (iter != m_glyphs.end())
+	{
+		return &iter->second;
+	}
+
+	if (m_isCreated == false)
+	{
+		return nullptr;
+	}
+
+	AtlasGlyph glyph;
+	if (LoadGlyph(codePoint, &glyph) == false)
+	{
+		if (codePoint == REPLACEMENT_CODE_POINT)
+		{
+			return nullptr;
+		}
+
+		// Remember the fallback under this code point too, so the font isn't asked again
+		const AtlasGlyph* pReplacement = GetGlyph(REPLACEMENT_CODE_POINT);
+		if (pReplacement == nullptr)
+		{
+			return nullptr;
+		}
+
+		glyph = *pReplacement;
+	}
+
+	return &(m_glyphs[codePoint] = glyph);
+}
+
+bool AtlasFont::LoadGlyph(unsigned int codePoint, AtlasGlyph* pGlyph)
+{
+	FT_UInt glyphIndex = FT_Get_Char_Index(m_face, codePoint);
+	if (glyphIndex == 0 && codePoint != 0)
+	{
+		return false;
+	}
+
+	FT_Int32 loadFlags = FT_LOAD_RENDER;
+	if (m_noAutoHint)
+	{
+		loadFlags |= FT_LOAD_NO_AUTOHINT;
+	}
+
+	if (FT_Load_Glyph(m_face, glyphIndex, loadFlags))
+	{
+		return false;
+	}
+
+	FT_GlyphSlot slot = m_face->glyph;
+	const FT_Bitmap& bitmap = slot->bitmap;
+
+	pGlyph->m_hasBitmap = bitmap.width > 0 && bitmap.rows > 0;
+	pGlyph->m_x1 = static_cast<float>(slot->bitmap_left);
+	pGlyph->m_y1 = static_cast<float>(slot->bitmap_top - static_cast<int>(bitmap.rows));
+	pGlyph->m_x2 = static_cast<float>(slot->bitmap_left + static_cast<int>(bitmap.width));
+	pGlyph->m_y2 = static_cast<float>(slot->bitmap_top);
+	pGlyph->m_advance = slot->advance.x >> 6;
+
+	if (pGlyph->m_hasBitmap)
+	{
+		if (m_pGlyphAtlas->AddGlyph(bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch, &pGlyph->m_region) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
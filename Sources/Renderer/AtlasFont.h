@@ -0,0 +1,90 @@
+/*************************************************************************
+> File Name: AtlasFont.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A FreeType font whose glyphs live in the shared glyph atlas. Strings
+> 	 are turned into runs of quads once and kept, so text that doesn't
+> 	 change is never laid out again.
+> Created Time: 2016/09/14
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_ATLAS_FONT_H
+#define CUBBY_ATLAS_FONT_H
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GlyphAtlas.h"
+#include "SpriteBatch.h"
+
+struct AtlasGlyph
+{
+	// False for glyphs with nothing to draw, like spaces
+	bool m_hasBitmap;
+
+	// Quad relative to the pen position, y is up
+	float m_x1, m_y1;
+	float m_x2, m_y2;
+
+	GlyphAtlasRegion m_region;
+
+	int m_advance;
+};
+
+// A laid out string, four vertices per visible glyph, starting from the origin
+struct AtlasTextMesh
+{
+	std::vector<SpriteVertex> m_vertices;
+	int m_width;
+};
+
+class AtlasFont
+{
+public:
+	// Constructor, Destructor
+	AtlasFont(GlyphAtlas* pGlyphAtlas);
+	~AtlasFont();
+
+	bool Create(const char* fontName, int size, bool noAutoHint);
+
+	// Text is UTF-8, the returned mesh stays valid until the next call
+	const AtlasTextMesh* GetTextMesh(const char* text);
+	int GetTextWidth(const char* text);
+
+	int GetSize() const;
+	int GetAscent() const;
+	int GetDescent() const;
+
+	void ClearTextMeshes();
+	int GetNumTextMeshes() const;
+
+	// Reads one code point and moves the text on past it, malformed bytes give the replacement character
+	static unsigned int DecodeUTF8(const char** ppText);
+
+	// Once this many strings are cached the cache is started again, so strings that keep changing can't grow it forever
+	static const int MAX_TEXT_MESHES = 1024;
+
+private:
+	const AtlasGlyph* GetGlyph(unsigned int codePoint);
+	bool LoadGlyph(unsigned int codePoint, AtlasGlyph* pGlyph);
+
+	GlyphAtlas* m_pGlyphAtlas;
+
+	bool m_isCreated;
+	FT_Library m_library;
+	FT_Face m_face;
+
+	int m_size;
+	bool m_noAutoHint;
+
+	std::unordered_map<unsigned int, AtlasGlyph> m_glyphs;
+	std::unordered_map<std::string, AtlasTextMesh> m_textMeshes;
+};
+
+#endif
@@ -233,6 +233,8 @@ glShader::glShader()
 	is_linked = false;
 	_mM = false;
 	_noshader = true;
+	_numLocationLookups = 0;
+	_numLocationQueries = 0;
 
 	if (!useGLSL)
 	{
@@ -350,6 +352,7 @@ bool glShader::link(void)
 	if (linked)
 	{
 		is_linked = true;
+		cacheLocations();
 		return true;
 	}
 	else
@@ -1002,19 +1005,145 @@ bool glShader::setUniformMatrix4fv(const GLcharARB* varname, GLsizei count, GLbo
 
 GLint glShader::GetUniformLocation(const GLcharARB *name)
 {
+	_numLocationLookups++;
+
+	std::unordered_map<std::string, GLint>::iterator iter = _uniformLocations.find(name);
+	if (iter != _uniformLocations.end())
+		return iter->second;
+
+	// Not an active uniform, ask once and remember the answer (usually -1) so the error is only printed once
 	GLint loc;
 
+	_numLocationQueries++;
 	loc = glGetUniformLocation(ProgramObject, name);
 	if (loc == -1)
 	{
 		cout << "Error: can't find uniform variable \"" << name << "\"\n";
 	}
 	CHECK_GL_ERROR();
+
+	_uniformLocations[name] = loc;
 	return loc;
 }
 
 //-----------------------------------------------------------------------------
 
+GLint glShader::GetAttributeLocation(const GLcharARB *name)
+{
+	_numLocationLookups++;
+
+	std::unordered_map<std::string, GLint>::iterator iter = _attributeLocations.find(name);
+	if (iter != _attributeLocations.end())
+		return iter->second;
+
+	GLint loc;
+
+	_numLocationQueries++;
+	loc = glGetAttribLocation(ProgramObject, name);
+	if (loc == -1)
+	{
+		cout << "Error: can't find attribute variable \"" << name << "\"\n";
+	}
+	CHECK_GL_ERROR();
+
+	_attributeLocations[name] = loc;
+	return loc;
+}
+
+//-----------------------------------------------------------------------------
+
+bool glShader::BindUniformBlock(const GLcharARB *name, GLuint bindingPoint)
+{
+	if (!useGLSL || !is_linked) return false;
+	if (!GLEW_ARB_uniform_buffer_object) return false;
+
+	GLuint blockIndex = glGetUniformBlockIndex(ProgramObject, name);
+	if (blockIndex == GL_INVALID_INDEX)
+		return false;
+
+	glUniformBlockBinding(ProgramObject, blockIndex, bindingPoint);
+	CHECK_GL_ERROR();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void glShader::GetLocationStats(int* pNumLookups, int* pNumQueries) const
+{
+	*pNumLookups = _numLocationLookups;
+	*pNumQueries = _numLocationQueries;
+}
+
+void glShader::ResetLocationStats(void)
+{
+	_numLocationLookups = 0;
+	_numLocationQueries = 0;
+}
+//-----------------------------------------------------------------------------
+
+void glShader::cacheLocations(void)
+{
+	_uniformLocations.clear();
+	_attributeLocations.clear();
+
+	GLint numUniforms = 0;
+	GLint maxUniformLength = 0;
+	glGetProgramiv(ProgramObject, GL_ACTIVE_UNIFORMS, &numUniforms);
+	glGetProgramiv(ProgramObject, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformLength);
+
+	GLint numAttributes = 0;
+	GLint maxAttributeLength = 0;
+	glGetProgramiv(ProgramObject, GL_ACTIVE_ATTRIBUTES, &numAttributes);
+	glGetProgramiv(ProgramObject, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxAttributeLength);
+	CHECK_GL_ERROR();
+
+	std::vector<GLcharARB> name(std::max(maxUniformLength, maxAttributeLength) + 1);
+
+	for (GLint i = 0; i < numUniforms; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ProgramObject, i, static_cast<GLsizei>(name.size()), &length, &size, &type, &name[0]);
+
+		std::string uniformName(&name[0], length);
+
+		// Uniform block members have no location of their own
+		GLint loc = glGetUniformLocation(ProgramObject, uniformName.c_str());
+		if (loc == -1)
+			continue;
+
+		_uniformLocations[uniformName] = loc;
+
+		// Arrays are reported as "name[0]", but are looked up as "name" too
+		if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+		{
+			_uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = loc;
+		}
+	}
+
+	for (GLint i = 0; i < numAttributes; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveAttrib(ProgramObject, i, static_cast<GLsizei>(name.size()), &length, &size, &type, &name[0]);
+
+		std::string attributeName(&name[0], length);
+
+		// Built-in attributes (gl_Vertex etc.) have no location
+		GLint loc = glGetAttribLocation(ProgramObject, attributeName.c_str());
+		if (loc == -1)
+			continue;
+
+		_attributeLocations[attributeName] = loc;
+	}
+	CHECK_GL_ERROR();
+}
+
+//-----------------------------------------------------------------------------
+
 void glShader::getUniformfv(const GLcharARB* varname, GLfloat* values, GLint index)
 {
 	if (!useGLSL) return;
@@ -39,6 +39,8 @@ Make sure to check extension "GL_EXT_geometry_shader4" before using Geometry sha
 //#include "glslSettings.h"
 #include <vector>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 #define GLEW_STATIC 
 
 #include "GL/glew.h"
@@ -139,7 +141,12 @@ public:
 	void       SetOutputPrimitiveType(int nOutputPrimitiveType); //!< Set the output primitive type for the geometry shader
 	void       SetVerticesOut(int nVerticesOut);                 //!< Set the maximal number of vertices the geometry shader can output
 
-	GLint       GetUniformLocation(const GLcharARB *name);  //!< Retrieve Location (index) of a Uniform Variable
+	GLint       GetUniformLocation(const GLcharARB *name);  //!< Retrieve Location (index) of a Uniform Variable, from the table built when the program was linked
+	GLint       GetAttributeLocation(const GLcharARB *name);  //!< Retrieve Location (index) of a Vertex Attribute, from the table built when the program was linked
+	bool        BindUniformBlock(const GLcharARB *name, GLuint bindingPoint);  //!< Attach a Uniform Block to a Uniform Buffer binding point \return false if the program has no such block
+
+	void        GetLocationStats(int* pNumLookups, int* pNumQueries) const;  //!< Location lookups asked for, and how many of them had to go to the driver, since the last reset
+	void        ResetLocationStats(void);
 
 															// Submitting Uniform Variables. You can set varname to 0 and specifiy index retrieved with GetUniformLocation (best performance)
 	bool       setUniform1f(const GLcharARB* varname, GLfloat v0, GLint index = -1);  //!< Specify value of uniform variable. \param varname The name of the uniform variable.
@@ -268,6 +275,13 @@ private:
 
 	bool        _bUsesGeometryShader;
 
+	void        cacheLocations(void);                // Fill the location tables from the linked program
+
+	std::unordered_map<std::string, GLint> _uniformLocations;
+	std::unordered_map<std::string, GLint> _attributeLocations;
+	int         _numLocationLookups;
+	int         _numLocationQueries;
+
 	int         _nInputPrimitiveType;
 	int         _nOutputPrimitiveType;
 	int         _nVerticesOut;
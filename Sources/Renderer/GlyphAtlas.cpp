@@ -0,0 +1,118 @@
+/*************************************************************************
+> File Name: GlyphAtlas.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A single texture that every font renders its glyphs into, so any
+> 	 text, in any font, can be drawn from the same texture.
+> Created Time: 2016/09/14
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include "GlyphAtlas.h"
+
+// Constructor, Destructor
+GlyphAtlas::GlyphAtlas() :
+	m_textureID(0), m_shelfX(0), m_shelfY(0), m_shelfHeight(0), m_numGlyphs(0)
+{
+	// The texture is created with the first glyph, once there is a context
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	if (m_textureID != 0)
+	{
+		glDeleteTextures(1, &m_textureID);
+		m_textureID = 0;
+	}
+}
+
+bool GlyphAtlas::AddGlyph(const unsigned char* pCoverage, int width, int height, int pitch, GlyphAtlasRegion* pRegion)
+{
+	int paddedWidth = width + PADDING * 2;
+	int paddedHeight = height + PADDING * 2;
+
+	if (paddedWidth > TEXTURE_SIZE || paddedHeight > TEXTURE_SIZE)
+	{
+		return false;
+	}
+
+	// Start a new shelf if the glyph doesn't fit on the end of the current one
+	if (m_shelfX + paddedWidth > TEXTURE_SIZE || m_shelfY + std::max(m_shelfHeight, paddedHeight) > TEXTURE_SIZE)
+	{
+		if (m_shelfY + m_shelfHeight + paddedHeight > TEXTURE_SIZE)
+		{
+			// The atlas is full
+			return false;
+		}
+
+		m_shelfX = 0;
+		m_shelfY += m_shelfHeight;
+		m_shelfHeight = 0;
+	}
+
+	int x = m_shelfX;
+	int y = m_shelfY;
+
+	m_shelfX += paddedWidth;
+	m_shelfHeight = std::max(m_shelfHeight, paddedHeight);
+
+	if (m_textureID == 0)
+	{
+		CreateTexture();
+	}
+
+	// Luminance is always full, the glyph's coverage goes in alpha so the text takes the vertex color
+	std::vector<unsigned char> texels(paddedWidth * paddedHeight * 2, 0);
+	for (int i = 0; i < paddedWidth * paddedHeight; ++i)
+	{
+		texels[i * 2] = 255;
+	}
+	for (int row = 0; row < height; ++row)
+	{
+		for (int column = 0; column < width; ++column)
+		{
+			texels[((row + PADDING) * paddedWidth + column + PADDING) * 2 + 1] = pCoverage[row * pitch + column];
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, &texels[0]);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	float textureSize = static_cast<float>(TEXTURE_SIZE);
+
+	pRegion->m_s1 = (x + PADDING) / textureSize;
+	pRegion->m_t1 = (y + PADDING) / textureSize;
+	pRegion->m_s2 = (x + PADDING + width) / textureSize;
+	pRegion->m_t2 = (y + PADDING + height) / textureSize;
+
+	m_numGlyphs++;
+
+	return true;
+}
+
+GLuint GlyphAtlas::GetTextureID() const
+{
+	return m_textureID;
+}
+
+int GlyphAtlas::GetNumGlyphs() const
+{
+	return m_numGlyphs;
+}
+
+void GlyphAtlas::CreateTexture()
+{
+	glGenTextures(1, &m_textureID);
+	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, TEXTURE_SIZE, TEXTURE_SIZE, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
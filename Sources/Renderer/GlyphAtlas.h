@@ -0,0 +1,55 @@
+/*************************************************************************
+> File Name: GlyphAtlas.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A single texture that every font renders its glyphs into, so any
+> 	 text, in any font, can be drawn from the same texture.
+> Created Time: 2016/09/14
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_GLYPH_ATLAS_H
+#define CUBBY_GLYPH_ATLAS_H
+
+#include <GL/glew.h>
+
+// Where a glyph's bitmap ended up in the atlas
+struct GlyphAtlasRegion
+{
+	float m_s1, m_t1;
+	float m_s2, m_t2;
+};
+
+class GlyphAtlas
+{
+public:
+	// Constructor, Destructor
+	GlyphAtlas();
+	~GlyphAtlas();
+
+	// Copies an 8-bit coverage bitmap into the atlas, returns false once the atlas is full
+	bool AddGlyph(const unsigned char* pCoverage, int width, int height, int pitch, GlyphAtlasRegion* pRegion);
+
+	GLuint GetTextureID() const;
+	int GetNumGlyphs() const;
+
+	static const int TEXTURE_SIZE = 2048;
+
+	// Glyphs are surrounded by empty texels, so filtering at the edges never picks up a neighbour
+	static const int PADDING = 1;
+
+private:
+	void CreateTexture();
+
+	GLuint m_textureID;
+
+	// Shelf packing, glyphs are placed left to right along the current shelf
+	int m_shelfX;
+	int m_shelfY;
+	int m_shelfHeight;
+
+	int m_numGlyphs;
+};
+
+#endif
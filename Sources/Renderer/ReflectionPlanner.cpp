@@ -0,0 +1,93 @@
+/*************************************************************************
+> File Name: ReflectionPlanner.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Decides each frame whether the water reflection is drawn, kept from
+> 	 an earlier frame or not needed at all, and remembers the camera it
+> 	 was last drawn from so an old reflection can be reprojected.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include "ReflectionPlanner.h"
+
+// Constructor, Destructor
+ReflectionPlanner::ReflectionPlanner(Renderer* pRenderer) :
+	m_pRenderer(pRenderer), m_isWaterVisible(false), m_hasReflection(false), m_isRenderedLastFrame(false),
+	m_lastUpdate(ReflectionUpdate::Skip), m_passTime(0.0f)
+{
+
+}
+
+ReflectionPlanner::~ReflectionPlanner()
+{
+
+}
+
+ReflectionUpdate ReflectionPlanner::Plan(unsigned int viewportID, const glm::vec3& waterCenter, float halfSize, bool isUnderWater, bool isHalfRate)
+{
+	m_isWaterVisible = m_pRenderer->CubeInFrustum(viewportID, waterCenter, halfSize, 0.0f, halfSize) != 0;
+
+	if (m_isWaterVisible == false || isUnderWater)
+	{
+		// Whatever was drawn before is too old to reproject once the water comes back
+		m_hasReflection = false;
+		m_lastUpdate = ReflectionUpdate::Skip;
+	}
+	else if (isHalfRate && m_hasReflection && m_isRenderedLastFrame)
+	{
+		m_lastUpdate = ReflectionUpdate::Reuse;
+	}
+	else
+	{
+		m_lastUpdate = ReflectionUpdate::Render;
+	}
+
+	m_isRenderedLastFrame = m_lastUpdate == ReflectionUpdate::Render;
+
+	return m_lastUpdate;
+}
+
+void ReflectionPlanner::SetRendered()
+{
+	Matrix4 viewMatrix;
+	Matrix4 projectionMatrix;
+	m_pRenderer->GetModelViewMatrix(&viewMatrix);
+	m_pRenderer->GetProjectionMatrix(&projectionMatrix);
+
+	// Projection applied after the view
+	Matrix4::Multiply(viewMatrix, projectionMatrix, m_reflectionMatrix);
+
+	m_hasReflection = true;
+}
+
+void ReflectionPlanner::SetPassTime(float passTime)
+{
+	m_passTime = passTime;
+}
+
+bool ReflectionPlanner::IsWaterVisible() const
+{
+	return m_isWaterVisible;
+}
+
+bool ReflectionPlanner::HasReflection() const
+{
+	return m_hasReflection;
+}
+
+const Matrix4& ReflectionPlanner::GetReflectionMatrix() const
+{
+	return m_reflectionMatrix;
+}
+
+ReflectionUpdate ReflectionPlanner::GetLastUpdate() const
+{
+	return m_lastUpdate;
+}
+
+float ReflectionPlanner::GetPassTime() const
+{
+	return m_passTime;
+}
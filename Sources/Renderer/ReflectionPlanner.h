@@ -0,0 +1,65 @@
+/*************************************************************************
+> File Name: ReflectionPlanner.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Decides each frame whether the water reflection is drawn, kept from
+> 	 an earlier frame or not needed at all, and remembers the camera it
+> 	 was last drawn from so an old reflection can be reprojected.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_REFLECTION_PLANNER_H
+#define CUBBY_REFLECTION_PLANNER_H
+
+#include "Renderer.h"
+
+enum class ReflectionUpdate
+{
+	// The water isn't in view, or the camera is under it
+	Skip = 0,
+	// The last reflection is reprojected instead of drawing a new one
+	Reuse,
+	Render,
+};
+
+class ReflectionPlanner
+{
+public:
+	// Constructor, Destructor
+	ReflectionPlanner(Renderer* pRenderer);
+	~ReflectionPlanner();
+
+	// The water is a square of halfSize around waterCenter, tested against the viewport's frustum.
+	// At half rate a new reflection is only drawn every other frame.
+	ReflectionUpdate Plan(unsigned int viewportID, const glm::vec3& waterCenter, float halfSize, bool isUnderWater, bool isHalfRate);
+
+	// Call once the reflection is drawn, with the camera's view and projection still loaded
+	void SetRendered();
+	void SetPassTime(float passTime);
+
+	bool IsWaterVisible() const;
+	bool HasReflection() const;
+
+	// The view projection the reflection was drawn with
+	const Matrix4& GetReflectionMatrix() const;
+
+	ReflectionUpdate GetLastUpdate() const;
+	// Milliseconds spent in the reflection pass this frame
+	float GetPassTime() const;
+
+private:
+	Renderer* m_pRenderer;
+
+	bool m_isWaterVisible;
+	bool m_hasReflection;
+	bool m_isRenderedLastFrame;
+
+	Matrix4 m_reflectionMatrix;
+
+	ReflectionUpdate m_lastUpdate;
+	float m_passTime;
+};
+
+#endif
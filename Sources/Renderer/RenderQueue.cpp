@@ -0,0 +1,121 @@
+/*************************************************************************
+> File Name: RenderQueue.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Draw packets submitted once a frame, and sorted so each render pass
+> 	 draws them with as few state changes as possible.
+> Created Time: 2016/09/15
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+
+#include "RenderQueue.h"
+
+// Constructor, Destructor
+RenderQueue::RenderQueue()
+{
+	m_packets.reserve(4096);
+}
+
+RenderQueue::~RenderQueue()
+{
+	Clear();
+}
+
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+	m_sortKeys.clear();
+	m_sortedPackets.clear();
+}
+
+void RenderQueue::Submit(const RenderPacket& packet)
+{
+	m_packets.push_back(packet);
+}
+
+const std::vector<const RenderPacket*>& RenderQueue::GetSortedPackets(RenderPass pass)
+{
+	unsigned int passBit = GetPassBit(pass);
+
+	m_sortKeys.clear();
+	for (size_t i = 0; i < m_packets.size(); ++i)
+	{
+		if ((m_packets[i].m_passMask & passBit) != 0)
+		{
+			m_sortKeys.push_back(std::make_pair(GetSortKey(m_packets[i]), &m_packets[i]));
+		}
+	}
+
+	// Stable, so packets that share every key keep the order they were submitted in
+	std::stable_sort(m_sortKeys.begin(), m_sortKeys.end(), [](const std::pair<unsigned long long, const RenderPacket*>& a, const std::pair<unsigned long long, const RenderPacket*>& b)
+	{
+		return a.first < b.first;
+	});
+
+	m_sortedPackets.clear();
+	for (size_t i = 0; i < m_sortKeys.size(); ++i)
+	{
+		m_sortedPackets.push_back(m_sortKeys[i].second);
+	}
+
+	return m_sortedPackets;
+}
+
+int RenderQueue::GetNumPackets() const
+{
+	return static_cast<int>(m_packets.size());
+}
+
+unsigned long long RenderQueue::GetSignature(RenderPass pass, const RenderCullBox& cullBox) const
+{
+	unsigned int passBit = GetPassBit(pass);
+	unsigned long long signature = 0;
+
+	for (size_t i = 0; i < m_packets.size(); ++i)
+	{
+		if ((m_packets[i].m_passMask & passBit) == 0 || IsInCullBox(m_packets[i], cullBox) == false)
+		{
+			continue;
+		}
+
+		// Static buffer IDs are never handed out twice, so a rebuilt mesh always changes the sum. Mixed first so the order packets were submitted in doesn't matter.
+		unsigned long long mixed = m_packets[i].m_staticBufferID + 0x9E3779B97F4A7C15ULL;
+		mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+		mixed = mixed ^ (mixed >> 31);
+
+		signature += mixed;
+	}
+
+	return signature;
+}
+
+unsigned int RenderQueue::GetPassBit(RenderPass pass)
+{
+	return 1 << static_cast<unsigned int>(pass);
+}
+
+bool RenderQueue::IsInCullBox(const RenderPacket& packet, const RenderCullBox& cullBox)
+{
+	glm::vec3 center;
+	Matrix4::Multiply(cullBox.m_viewMatrix, packet.m_center, center);
+
+	// The box around the bounding sphere, which is close enough for chunk sized packets
+	return center.x + packet.m_radius >= cullBox.m_min.x && center.x - packet.m_radius <= cullBox.m_max.x &&
+		center.y + packet.m_radius >= cullBox.m_min.y && center.y - packet.m_radius <= cullBox.m_max.y &&
+		center.z + packet.m_radius >= cullBox.m_min.z && center.z - packet.m_radius <= cullBox.m_max.z;
+}
+
+unsigned long long RenderQueue::GetSortKey(const RenderPacket& packet)
+{
+	// [transparent:1][shader:15][material:16][mesh:32], the -1 shader and material sort first
+	unsigned long long transparent = packet.m_isTransparent ? 1 : 0;
+	unsigned long long shader = (packet.m_shaderID + 1) & 0x7FFF;
+	unsigned long long material = (packet.m_materialID + 1) & 0xFFFF;
+	unsigned long long mesh = packet.m_staticBufferID;
+
+	return (transparent << 63) | (shader << 48) | (material << 32) | mesh;
+}
@@ -0,0 +1,99 @@
+/*************************************************************************
+> File Name: RenderQueue.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Draw packets submitted once a frame, and sorted so each render pass
+> 	 draws them with as few state changes as possible.
+> Created Time: 2016/09/15
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_RENDER_QUEUE_H
+#define CUBBY_RENDER_QUEUE_H
+
+#include <Maths/Matrix4.h>
+
+#include <vector>
+
+enum class RenderPass
+{
+	Shadow = 0,
+	Reflection,
+	Outline,
+	Silhouette,
+	Normal,
+
+	NumPasses,
+};
+
+struct RenderPacket
+{
+	// Static buffer of the mesh to draw, and the material and shader to draw it with. A shader of -1 uses whatever the pass has bound.
+	unsigned int m_staticBufferID;
+	unsigned int m_materialID;
+	int m_shaderID;
+
+	// Which passes draw this packet, see RenderQueue::GetPassBit()
+	unsigned int m_passMask;
+
+	Matrix4 m_worldMatrix;
+
+	// Transparent packets are drawn after the opaque ones in each pass
+	bool m_isTransparent;
+
+	// The world matrix is also put onto the shadow texture matrix, for meshes drawn with the shadow shaders
+	bool m_isShadowReceiver;
+
+	// Bounding sphere, for passes that cull against a viewport
+	glm::vec3 m_center;
+	float m_radius;
+};
+
+// A box in a view space, for passes drawn with an orthographic projection instead of through a viewport
+struct RenderCullBox
+{
+	Matrix4 m_viewMatrix;
+	glm::vec3 m_min;
+	glm::vec3 m_max;
+};
+
+struct RenderPassStats
+{
+	int m_numPackets;
+	int m_numDrawCalls;
+	int m_numStateChanges;
+};
+
+class RenderQueue
+{
+public:
+	// Constructor, Destructor
+	RenderQueue();
+	~RenderQueue();
+
+	void Clear();
+	void Submit(const RenderPacket& packet);
+
+	// The packets drawn in a pass, sorted by transparency, shader, material and then mesh
+	const std::vector<const RenderPacket*>& GetSortedPackets(RenderPass pass);
+
+	int GetNumPackets() const;
+
+	// Changes whenever a packet drawn in the pass starts or stops overlapping the box, or its mesh is rebuilt
+	unsigned long long GetSignature(RenderPass pass, const RenderCullBox& cullBox) const;
+
+	static unsigned int GetPassBit(RenderPass pass);
+	static bool IsInCullBox(const RenderPacket& packet, const RenderCullBox& cullBox);
+
+private:
+	static unsigned long long GetSortKey(const RenderPacket& packet);
+
+	std::vector<RenderPacket> m_packets;
+
+	// Scratch space for sorting, kept between frames to save allocating it again
+	std::vector<std::pair<unsigned long long, const RenderPacket*>> m_sortKeys;
+	std::vector<const RenderPacket*> m_sortedPackets;
+};
+
+#endif
@@ -50,8 +50,14 @@ Renderer::Renderer(int width, int height, int depthBits, int stencilBits) :
 	m_clipNear(0.1f), m_clipFar(10000.0f),
 	m_primitiveMode(static_cast<unsigned int>(PrimitiveMode::TRIANGLES)),
 	m_cullMode(CullMode::NOCULL),
-	m_quadratic(gluNewQuadric()), m_activeViewport(-1), m_projection(nullptr)
+	m_quadratic(gluNewQuadric()), m_activeViewport(-1),
+	m_frameUniformBuffer(0), m_projection(nullptr)
 {
+	m_pTextureAtlas = new TextureAtlas();
+	m_pSpriteBatch = new SpriteBatch();
+	m_pGlyphAtlas = new GlyphAtlas();
+	m_pRenderQueue = new RenderQueue();
+
 	// Is depth buffer needed?
 	if (depthBits > 0)
 	{
@@ -81,9 +87,12 @@ Renderer::Renderer(int width, int height, int depthBits, int stencilBits) :
 	gluQuadricNormals(m_quadratic, GLU_SMOOTH);
 	gluQuadricTexture(m_quadratic, GL_TRUE);
 
+	// Frame uniforms, the buffer is created with the first upload
+	memset(&m_frameUniforms, 0, sizeof(FrameUniforms));
+	memset(&m_uploadedFrameUniforms, 0, sizeof(FrameUniforms));
+
 	// Rendered information
-	m_numRenderedVertices = 0;
-	m_numRenderedFaces = 0;
+	ResetRenderedStats();
 
 	InitOpenGLExtensions();
 }
@@ -134,6 +143,15 @@ Renderer::~Renderer()
 	}
 	m_textures.clear();
 
+	// Delete the texture atlas and sprite batch
+	delete m_pTextureAtlas;
+	m_pTextureAtlas = nullptr;
+	m_textureAtlasRegions.clear();
+	delete m_pSpriteBatch;
+	m_pSpriteBatch = nullptr;
+	delete m_pRenderQueue;
+	m_pRenderQueue = nullptr;
+
 	// Delete the lights
 	for (i = 0; i < m_lights.size(); ++i)
 	{
@@ -142,13 +160,15 @@ Renderer::~Renderer()
 	}
 	m_lights.clear();
 
-	// Delete the FreeType fonts
+	// Delete the FreeType fonts, and then the glyph atlas they share
 	for (i = 0; i < m_freetypeFonts.size(); ++i)
 	{
 		delete m_freetypeFonts[i];
 		m_freetypeFonts[i] = nullptr;
 	}
 	m_freetypeFonts.clear();
+	delete m_pGlyphAtlas;
+	m_pGlyphAtlas = nullptr;
 
 	// Delete the frame buffers
 	for (i = 0; i < m_frameBuffers.size(); ++i)
@@ -166,6 +186,13 @@ Renderer::~Renderer()
 	}
 	m_shaders.clear();
 
+	// Delete the frame uniform buffer
+	if (m_frameUniformBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_frameUniformBuffer);
+		m_frameUniformBuffer = 0;
+	}
+
 	// Delete the quadratic drawer
 	gluDeleteQuadric(m_quadratic);
 }
@@ -376,6 +403,8 @@ void Renderer::SetPrimitiveMode(PrimitiveMode mode)
 
 void Renderer::SetCullMode(CullMode mode)
 {
+	FlushSpriteBatch();
+
 	m_cullMode = mode;
 
 	switch (mode)
@@ -424,6 +453,8 @@ void Renderer::SetFrontFaceDirection(FrontFaceDirection direction)
 // Projection
 bool Renderer::SetProjectionMode(ProjectionMode mode, int viewPort)
 {
+	FlushSpriteBatch();
+
 	Viewport* pViewport = m_viewports[viewPort];
 	glViewport(pViewport->left, pViewport->bottom, pViewport->width, pViewport->height);
 
@@ -453,6 +484,8 @@ bool Renderer::SetProjectionMode(ProjectionMode mode, int viewPort)
 
 void Renderer::SetViewProjection()
 {
+	FlushSpriteBatch();
+
 	glMatrixMode(GL_PROJECTION);
 	MultiplyViewProjection();
 	glMatrixMode(GL_MODELVIEW);
@@ -465,6 +498,8 @@ void Renderer::MultiplyViewProjection()
 
 void Renderer::SetupOrthographicProjection(float left, float right, float bottom, float top, float zNear, float zFar)
 {
+	FlushSpriteBatch();
+
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 	glOrtho(left, right, bottom, top, zNear, zFar);
@@ -527,6 +562,8 @@ void Renderer::EndScene()
 
 void Renderer::SetColorMask(bool red, bool green, bool blue, bool alpha)
 {
+	FlushSpriteBatch();
+
 	glColorMask(red, green, blue, alpha);
 }
 
@@ -674,6 +711,20 @@ void Renderer::SetTextureMatrix()
 	glMatrixMode(GL_MODELVIEW);
 }
 
+void Renderer::SetTextureMatrix(const Matrix4& matrix)
+{
+	float m[16];
+	matrix.GetMatrix(m);
+
+	glMatrixMode(GL_TEXTURE);
+	glActiveTextureARB(GL_TEXTURE7);
+
+	glLoadMatrixf(m);
+
+	// Go back to normal matrix mode
+	glMatrixMode(GL_MODELVIEW);
+}
+
 void Renderer::PushTextureMatrix()
 {
 	glMatrixMode(GL_TEXTURE);
@@ -690,12 +741,16 @@ void Renderer::PopTextureMatrix()
 // Scissor testing
 void Renderer::EnableScissorTest(int x, int y, int width, int height)
 {
+	FlushSpriteBatch();
+
 	glEnable(GL_SCISSOR_TEST);
 	glScissor(x, y, width, height);
 }
 
 void Renderer::DisableScissorTest()
 {
+	FlushSpriteBatch();
+
 	glDisable(GL_SCISSOR_TEST);
 }
 
@@ -736,9 +791,34 @@ void Renderer::GetScreenCoordinatesFromWorldPosition(glm::vec3 pos, int* x, int*
 	*y = static_cast<int>(winY);
 }
 
+void Renderer::GetScreenCoordinatesFromWorldPositions(const glm::vec3* pPositions, int numPositions, int* pX, int* pY)
+{
+	// NOTE : Projection and camera must be set before calling this function, the same as GetScreenCoordinatesFromWorldPosition()
+
+	GLdouble modelViewMatrix[16];
+	glGetDoublev(GL_MODELVIEW_MATRIX, modelViewMatrix);
+
+	GLdouble projectionMatrix[16];
+	glGetDoublev(GL_PROJECTION_MATRIX, projectionMatrix);
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	for (int i = 0; i < numPositions; ++i)
+	{
+		GLdouble winX, winY, winZ;
+		gluProject(pPositions[i].x, pPositions[i].y, pPositions[i].z, modelViewMatrix, projectionMatrix, viewport, &winX, &winY, &winZ);
+
+		pX[i] = static_cast<int>(winX);
+		pY[i] = static_cast<int>(winY);
+	}
+}
+
 // Clip planes
 void Renderer::EnableClipPlane(unsigned int index, double eq1, double eq2, double eq3, double eq4)
 {
+	FlushSpriteBatch();
+
 	double plane[] = { eq1, eq2, eq3, eq4 };
 	glClipPlane(GL_CLIP_PLANE0 + index, plane);
 	glEnable(GL_CLIP_PLANE0 + index);
@@ -746,6 +826,8 @@ void Renderer::EnableClipPlane(unsigned int index, double eq1, double eq2, doubl
 
 void Renderer::DisableClipPlane(unsigned int index)
 {
+	FlushSpriteBatch();
+
 	glDisable(GL_CLIP_PLANE0);
 }
 
@@ -815,6 +897,8 @@ void Renderer::DisableVectorNormalize()
 // Depth testing
 void Renderer::EnableDepthTest(DepthTest testFunction)
 {
+	FlushSpriteBatch();
+
 	glEnable(GL_DEPTH_TEST);
 
 	glDepthFunc(GetDepthTest(testFunction));
@@ -822,6 +906,8 @@ void Renderer::EnableDepthTest(DepthTest testFunction)
 
 void Renderer::DisableDepthTest()
 {
+	FlushSpriteBatch();
+
 	glDisable(GL_DEPTH_TEST);
 }
 
@@ -862,17 +948,23 @@ GLenum Renderer::GetDepthTest(DepthTest test)
 
 void Renderer::EnableDepthWrite()
 {
+	FlushSpriteBatch();
+
 	glDepthMask(GL_TRUE);
 }
 
 void Renderer::DisableDepthWrite()
 {
+	FlushSpriteBatch();
+
 	glDepthMask(GL_FALSE);
 }
 
 // Immediate mode
 void Renderer::EnableImmediateMode(ImmediateModePrimitive mode)
 {
+	FlushSpriteBatch();
+
 	GLenum glMode = GL_POINTS;
 
 	switch (mode)
@@ -945,6 +1037,8 @@ void Renderer::ImmediateColorAlpha(float r, float g, float b, float a)
 void Renderer::DisableImmediateMode()
 {
 	glEnd();
+
+	m_numDrawCalls++;
 }
 
 // Drawing helpers
@@ -1039,10 +1133,10 @@ void Renderer::DrawSphericalSector(float radius, float angle, int sectors, int p
 // Text rendering
 bool Renderer::CreateFreeTypeFont(const char* fontName, int fontSize, unsigned int* pID, bool noAutoHint)
 {
-	FreeTypeFont* font = new FreeTypeFont();
+	AtlasFont* font = new AtlasFont(m_pGlyphAtlas);
 
-	// Build the new FreeType font
-	font->BuildFont(fontName, fontSize);
+	// Build the new FreeType font, its glyphs go into the glyph atlas
+	font->Create(fontName, fontSize, noAutoHint);
 
 	// Push this font onto the list of fonts and return the ID
 	m_freetypeFonts.push_back(font);
@@ -1063,23 +1157,82 @@ bool Renderer::RenderFreeTypeText(unsigned int fontID, float x, float y, float z
 		return false;
 	}
 
-	// Loop through variable argument list and add them to the string
-	va_start(ap, inText);
-	vsprintf(outText, inText, ap);
-	va_end(ap);
+	// Only format strings need formatting, most text is drawn as it is given
+	const char* text = inText;
+	if (strchr(inText, '%') != nullptr)
+	{
+		// Loop through variable argument list and add them to the string
+		va_start(ap, inText);
+		vsnprintf(outText, sizeof(outText), inText, ap);
+		va_end(ap);
+
+		text = outText;
+	}
+
+	return RenderFreeTypeString(fontID, x, y, z, color, scale, text);
+}
+
+bool Renderer::RenderFreeTypeString(unsigned int fontID, float x, float y, float z, Color color, float scale, const char* text)
+{
+	if (text == nullptr)
+	{
+		return false;
+	}
 
-	glColor4fv(color.GetRGBA());
+	AtlasFont* pFont = m_freetypeFonts[fontID];
+	const AtlasTextMesh* pTextMesh = pFont->GetTextMesh(text);
+	if (pTextMesh->m_vertices.empty())
+	{
+		return true;
+	}
 
 	// Add on the descent value, so we don't draw letters with underhang out of bounds. (e.g - g, y, q and p)
-	y -= GetFreeTypeTextDescent(fontID);
+	y -= pFont->GetDescent();
 
 	// HACK : The descent has rounding errors and is usually off by about 1 pixel
 	y -= 1;
 
-	glPushMatrix();
-	glTranslatef(x, y, 0);
-	m_freetypeFonts[fontID]->DrawString(outText, scale);
-	glPopMatrix();
+	// Text is scaled about its middle
+	float centerX = pTextMesh->m_width * 0.5f;
+	float centerY = pFont->GetSize() * 0.5f;
+
+	// The cached mesh starts at the origin, it is placed and moved into eye space here so it can share a draw with other text
+	Matrix4 modelView;
+	GetModelViewMatrix(&modelView);
+
+	const float* rgba = color.GetRGBA();
+	size_t numVertices = pTextMesh->m_vertices.size();
+	m_textVertices.resize(numVertices);
+	for (size_t i = 0; i < numVertices; ++i)
+	{
+		const SpriteVertex& source = pTextMesh->m_vertices[i];
+		SpriteVertex& destination = m_textVertices[i];
+
+		glm::vec3 position(x + centerX + (source.x - centerX) * scale, y + centerY + (source.y - centerY) * scale, 0.0f);
+		glm::vec3 eyePosition;
+		Matrix4::Multiply(modelView, position, eyePosition);
+
+		destination.x = eyePosition.x;
+		destination.y = eyePosition.y;
+		destination.z = eyePosition.z;
+		destination.u = source.u;
+		destination.v = source.v;
+		destination.r = rgba[0];
+		destination.g = rgba[1];
+		destination.b = rgba[2];
+		destination.a = rgba[3];
+	}
+
+	if (m_pSpriteBatch->AddQuads(m_pGlyphAtlas->GetTextureID(), SpriteType::Text, &m_textVertices[0], static_cast<int>(numVertices)))
+	{
+		m_numDrawCalls++;
+	}
+
+	// Outside of a sprite batch the text is drawn straight away
+	if (m_pSpriteBatch->IsActive() == false)
+	{
+		FlushSpriteBatch();
+	}
 
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -1096,17 +1249,23 @@ int Renderer::GetFreeTypeTextWidth(unsigned int fontID, const char* inText, ...)
 		return 0;
 	}
 
-	// Loop through variable argument list and add them to the string
-	va_start(ap, inText);
-	vsprintf(outText, inText, ap);
-	va_end(ap);
+	const char* text = inText;
+	if (strchr(inText, '%') != nullptr)
+	{
+		// Loop through variable argument list and add them to the string
+		va_start(ap, inText);
+		vsnprintf(outText, sizeof(outText), inText, ap);
+		va_end(ap);
+
+		text = outText;
+	}
 
-	return m_freetypeFonts[fontID]->GetTextWidth(outText);
+	return m_freetypeFonts[fontID]->GetTextWidth(text);
 }
 
 int Renderer::GetFreeTypeTextHeight(unsigned int fontID, const char* inText, ...)
 {
-	return m_freetypeFonts[fontID]->GetCharHeight('a');
+	return m_freetypeFonts[fontID]->GetSize();
 }
 
 int Renderer::GetFreeTypeTextAscent(unsigned int fontID)
@@ -1119,6 +1278,30 @@ int Renderer::GetFreeTypeTextDescent(unsigned int fontID)
 	return m_freetypeFonts[fontID]->GetDescent();
 }
 
+int Renderer::GetNumCachedTextMeshes() const
+{
+	int numTextMeshes = 0;
+	for (size_t i = 0; i < m_freetypeFonts.size(); ++i)
+	{
+		numTextMeshes += m_freetypeFonts[i]->GetNumTextMeshes();
+	}
+
+	return numTextMeshes;
+}
+
+int Renderer::GetNumGlyphs() const
+{
+	return m_pGlyphAtlas->GetNumGlyphs();
+}
+
+void Renderer::ClearTextMeshCaches()
+{
+	for (size_t i = 0; i < m_freetypeFonts.size(); ++i)
+	{
+		m_freetypeFonts[i]->ClearTextMeshes();
+	}
+}
+
 // Lighting
 bool Renderer::CreateLight(const Color& ambient, const Color& diffuse, const Color& specular, glm::vec3& position, glm::vec3& direction, float exponent, float cutoff, float cAtten, float lAtten, float qAtten, bool point, bool spot, unsigned int* pID)
 {
@@ -1189,6 +1372,23 @@ void Renderer::EnableLight(unsigned int id, unsigned int lightNumber)
 	if (m_lights[id])
 	{
 		m_lights[id]->Apply(lightNumber);
+
+		// The first light is also the one in the frame uniforms
+		if (lightNumber == 0)
+		{
+			const Light* pLight = m_lights[id];
+
+			memcpy(m_frameUniforms.m_lightAmbient, pLight->GetAmbient().GetRGBA(), 4 * sizeof(float));
+			memcpy(m_frameUniforms.m_lightDiffuse, pLight->GetDiffuse().GetRGBA(), 4 * sizeof(float));
+			m_frameUniforms.m_lightPosition[0] = pLight->GetPosition().x;
+			m_frameUniforms.m_lightPosition[1] = pLight->GetPosition().y;
+			m_frameUniforms.m_lightPosition[2] = pLight->GetPosition().z;
+			m_frameUniforms.m_lightPosition[3] = pLight->GetPoint() ? 1.0f : 0.0f;
+			m_frameUniforms.m_lightAttenuation[0] = pLight->GetConstantAttenuation();
+			m_frameUniforms.m_lightAttenuation[1] = pLight->GetLinearAttenuation();
+			m_frameUniforms.m_lightAttenuation[2] = pLight->GetQuadraticAttenuation();
+			m_frameUniforms.m_lightAttenuation[3] = 0.0f;
+		}
 	}
 }
 
@@ -1304,11 +1504,20 @@ bool Renderer::LoadTexture(std::string fileName, int* width, int* height, int* w
 
 	// Texture hasn't already been loaded, create and load it!
 	Texture* pTexture = new Texture();
-	pTexture->Load(fileName, width, height, widthPower2, heightPower2, false);
+	bool isLoaded = pTexture->Load(fileName, width, height, widthPower2, heightPower2, false);
 
 	// Push the vertex array onto the list
 	m_textures.push_back(pTexture);
 
+	// Small GUI and item textures are also copied into the atlas, so the GUI can batch them
+	TextureAtlasRegion atlasRegion;
+	atlasRegion.m_page = -1;
+	if (isLoaded && TextureAtlas::IsAtlasTexture(fileName, *width, *height))
+	{
+		m_pTextureAtlas->AddTexture(pTexture, &atlasRegion);
+	}
+	m_textureAtlasRegions.push_back(atlasRegion);
+
 	// Return the vertex array ID
 	*pID = m_textures.size() - 1;
 
@@ -1324,6 +1533,9 @@ bool Renderer::RefreshTexture(unsigned int id)
 
 	pTexture->Load(pTexture->GetFileName(), &width, &height, &widthPower2, &heightPower2, true);
 
+	// The atlas still holds the old texels, so draw this one on its own from now on
+	m_textureAtlasRegions[id].m_page = -1;
+
 	return true;
 }
 
@@ -1383,6 +1595,10 @@ void Renderer::GenerateEmptyTexture(unsigned int *pID)
 	// Push the vertex array onto the list
 	m_textures.push_back(pTexture);
 
+	TextureAtlasRegion atlasRegion;
+	atlasRegion.m_page = -1;
+	m_textureAtlasRegions.push_back(atlasRegion);
+
 	// Return the vertex array ID
 	*pID = m_textures.size() - 1;
 }
@@ -1397,6 +1613,11 @@ void Renderer::SetTextureData(unsigned int id, int width, int height, unsigned c
 	glDisable(GL_TEXTURE_2D);
 }
 
+int Renderer::GetNumTextureAtlasPages() const
+{
+	return m_pTextureAtlas->GetNumPages();
+}
+
 // Cube textures
 bool Renderer::LoadCubeTexture(int* width, int* height, std::string front, std::string back, std::string top, std::string bottom, std::string left, std::string right, unsigned int* pID) const
 {
@@ -1459,6 +1680,276 @@ void Renderer::DisableCubeTexture() const
 	glDisable(GL_TEXTURE_CUBE_MAP);
 }
 
+// Sprite batching
+void Renderer::BeginSpriteBatch()
+{
+	m_pSpriteBatch->Begin();
+}
+
+void Renderer::EndSpriteBatch()
+{
+	if (m_pSpriteBatch->End())
+	{
+		m_numDrawCalls++;
+	}
+}
+
+bool Renderer::AddSpriteToBatch(unsigned int textureID, float x1, float y1, float x2, float y2, float z, float s1, float t1, float s2, float t2)
+{
+	if (m_pSpriteBatch->IsActive() == false || textureID >= m_textureAtlasRegions.size() || m_textureAtlasRegions[textureID].m_page == -1)
+	{
+		return false;
+	}
+
+	const TextureAtlasRegion& region = m_textureAtlasRegions[textureID];
+
+	// Move the texture coordinates into the texture's region of its page
+	float regionWidth = region.m_s2 - region.m_s1;
+	float regionHeight = region.m_t2 - region.m_t1;
+	float pageS1 = region.m_s1 + s1 * regionWidth;
+	float pageS2 = region.m_s1 + s2 * regionWidth;
+	float pageT1 = region.m_t1 + t1 * regionHeight;
+	float pageT2 = region.m_t1 + t2 * regionHeight;
+
+	// Sprites from different parts of the GUI end up in the same draw, so they are moved into eye space here
+	Matrix4 modelView;
+	GetModelViewMatrix(&modelView);
+
+	glm::vec3 corners[4];
+	Matrix4::Multiply(modelView, glm::vec3(x1, y1, z), corners[0]);
+	Matrix4::Multiply(modelView, glm::vec3(x2, y1, z), corners[1]);
+	Matrix4::Multiply(modelView, glm::vec3(x2, y2, z), corners[2]);
+	Matrix4::Multiply(modelView, glm::vec3(x1, y2, z), corners[3]);
+
+	SpriteVertex vertices[4] = {
+		{ corners[0].x, corners[0].y, corners[0].z, pageS1, pageT1, 1.0f, 1.0f, 1.0f, 1.0f },
+		{ corners[1].x, corners[1].y, corners[1].z, pageS2, pageT1, 1.0f, 1.0f, 1.0f, 1.0f },
+		{ corners[2].x, corners[2].y, corners[2].z, pageS2, pageT2, 1.0f, 1.0f, 1.0f, 1.0f },
+		{ corners[3].x, corners[3].y, corners[3].z, pageS1, pageT2, 1.0f, 1.0f, 1.0f, 1.0f },
+	};
+
+	if (m_pSpriteBatch->AddSprite(m_pTextureAtlas->GetPageTextureID(region.m_page), vertices))
+	{
+		m_numDrawCalls++;
+	}
+
+	m_numBatchedSprites++;
+
+	return true;
+}
+
+void Renderer::FlushSpriteBatch()
+{
+	if (m_pSpriteBatch->Flush())
+	{
+		m_numDrawCalls++;
+	}
+}
+
+// Render queue
+void Renderer::ClearRenderQueue()
+{
+	m_pRenderQueue->Clear();
+}
+
+void Renderer::SubmitRenderPacket(const RenderPacket& packet)
+{
+	m_pRenderQueue->Submit(packet);
+}
+
+int Renderer::RenderQueuePass(RenderPass pass, int cullViewportID)
+{
+	return RenderQueuePackets(pass, cullViewportID, nullptr, false, 0.0f);
+}
+
+int Renderer::RenderQueuePass(RenderPass pass, const RenderCullBox& cullBox)
+{
+	return RenderQueuePackets(pass, -1, &cullBox, false, 0.0f);
+}
+
+int Renderer::RenderQueueMirroredPass(RenderPass pass, int cullViewportID, float mirrorHeight)
+{
+	return RenderQueuePackets(pass, cullViewportID, nullptr, true, mirrorHeight);
+}
+
+unsigned long long Renderer::GetRenderQueueSignature(RenderPass pass, const RenderCullBox& cullBox) const
+{
+	return m_pRenderQueue->GetSignature(pass, cullBox);
+}
+
+int Renderer::RenderQueuePackets(RenderPass pass, int cullViewportID, const RenderCullBox* pCullBox, bool isMirrored, float mirrorHeight)
+{
+	FlushSpriteBatch();
+
+	SetPrimitiveMode(PrimitiveMode::TRIANGLES);
+
+	RenderPassStats& stats = m_renderPassStats[static_cast<int>(pass)];
+	const std::vector<const RenderPacket*>& packets = m_pRenderQueue->GetSortedPackets(pass);
+
+	// State is only changed between packets when it differs, packets sharing a mesh are drawn one after the other from the same arrays
+	bool isTransparent = false;
+	int shaderID = -1;
+	unsigned int materialID = -1;
+	const VertexArray* pBoundVertexArray = nullptr;
+	int numDrawn = 0;
+
+	m_vertexArraysMutex.lock();
+
+	for (size_t i = 0; i < packets.size(); ++i)
+	{
+		const RenderPacket* pPacket = packets[i];
+
+		glm::vec3 cullCenter = pPacket->m_center;
+		if (isMirrored)
+		{
+			if (cullCenter.y + pPacket->m_radius < mirrorHeight)
+			{
+				continue;
+			}
+
+			cullCenter.y = mirrorHeight * 2.0f - cullCenter.y;
+		}
+
+		if (cullViewportID != -1 && SphereInFrustum(cullViewportID, cullCenter, pPacket->m_radius) == false)
+		{
+			continue;
+		}
+		if (pCullBox != nullptr && RenderQueue::IsInCullBox(*pPacket, *pCullBox) == false)
+		{
+			continue;
+		}
+
+		// The mesh may have been deleted since it was submitted
+		if (pPacket->m_staticBufferID >= m_vertexArrays.size() || m_vertexArrays[pPacket->m_staticBufferID] == nullptr)
+		{
+			continue;
+		}
+		const VertexArray* pVertexArray = m_vertexArrays[pPacket->m_staticBufferID];
+
+		if (pPacket->m_isTransparent != isTransparent)
+		{
+			if (pPacket->m_isTransparent)
+			{
+				EnableTransparency(BlendFunction::SRC_ALPHA, BlendFunction::ONE_MINUS_SRC_ALPHA);
+			}
+			else
+			{
+				DisableTransparency();
+			}
+
+			isTransparent = pPacket->m_isTransparent;
+			stats.m_numStateChanges++;
+		}
+
+		if (pPacket->m_shaderID != shaderID)
+		{
+			if (shaderID != -1)
+			{
+				EndGLSLShader(shaderID);
+			}
+			if (pPacket->m_shaderID != -1)
+			{
+				BeginGLSLShader(pPacket->m_shaderID);
+			}
+
+			shaderID = pPacket->m_shaderID;
+			stats.m_numStateChanges++;
+		}
+
+		if (pPacket->m_materialID != materialID)
+		{
+			if (pPacket->m_materialID != -1)
+			{
+				m_materials[pPacket->m_materialID]->Apply();
+			}
+
+			materialID = pPacket->m_materialID;
+			stats.m_numStateChanges++;
+		}
+
+		if (pVertexArray != pBoundVertexArray)
+		{
+			if (pVertexArray->textureID != -1 && (pVertexArray->type == VertexType::POSITION_NORMAL_UV || pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR))
+			{
+				BindTexture(pVertexArray->textureID);
+			}
+
+			SetVertexArrayPointers(pVertexArray);
+
+			pBoundVertexArray = pVertexArray;
+			stats.m_numStateChanges++;
+		}
+
+		PushMatrix();
+		MultiplyWorldMatrix(pPacket->m_worldMatrix);
+
+		if (pPacket->m_isShadowReceiver)
+		{
+			// The same as drawing the mesh on its own, the shadow lookup needs the model matrix on the texture matrix
+			Matrix4 worldMatrix;
+			GetModelMatrix(&worldMatrix);
+
+			PushTextureMatrix();
+			MultiplyWorldMatrix(worldMatrix);
+		}
+
+		if (pVertexArray->numIndices != 0)
+		{
+			glDrawElements(GL_TRIANGLES, pVertexArray->numIndices, GL_UNSIGNED_INT, pVertexArray->pIndices);
+		}
+		else
+		{
+			glDrawArrays(GL_TRIANGLES, 0, pVertexArray->numVertices);
+		}
+
+		if (pPacket->m_isShadowReceiver)
+		{
+			PopTextureMatrix();
+		}
+
+		PopMatrix();
+
+		m_numRenderedVertices += pVertexArray->numVertices;
+		m_numRenderedFaces += pVertexArray->numIndices / 3;
+		m_numDrawCalls++;
+		stats.m_numDrawCalls++;
+
+		numDrawn++;
+	}
+
+	m_vertexArraysMutex.unlock();
+
+	if (pBoundVertexArray != nullptr)
+	{
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_NORMAL_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+	if (shaderID != -1)
+	{
+		EndGLSLShader(shaderID);
+	}
+	if (isTransparent)
+	{
+		DisableTransparency();
+	}
+
+	stats.m_numPackets += numDrawn;
+
+	return numDrawn;
+}
+
+int Renderer::GetNumRenderQueuePackets() const
+{
+	return m_pRenderQueue->GetNumPackets();
+}
+
+const RenderPassStats& Renderer::GetRenderPassStats(RenderPass pass) const
+{
+	return m_renderPassStats[static_cast<int>(pass)];
+}
+
 // Vertex buffers
 bool Renderer::CreateStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVertices, int nTextureCoordinates, int nIndices, const void* pVertices, const void* pTextureCoordinates, const unsigned int* pIndices, unsigned int* pID)
 {
@@ -1627,6 +2118,8 @@ void Renderer::DeleteStaticBuffer(unsigned int id)
 
 bool Renderer::RenderStaticBuffer(unsigned int id)
 {
+	FlushSpriteBatch();
+
 	m_vertexArraysMutex.lock();
 
 	if (id >= m_vertexArrays.size())
@@ -1679,41 +2172,7 @@ bool Renderer::RenderStaticBuffer(unsigned int id)
 			}
 		}
 
-		// Calculate the stride
-		GLsizei totalStride = GetStride(pVertexArray->type);
-
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(3, GL_FLOAT, totalStride, pVertexArray->pVertexArray);
-
-		if (pVertexArray->type == VertexType::POSITION_NORMAL || pVertexArray->type == VertexType::POSITION_NORMAL_UV || pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR || pVertexArray->type == VertexType::POSITION_NORMAL_COLOR)
-		{
-			glEnableClientState(GL_NORMAL_ARRAY);
-			glNormalPointer(GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
-		}
-
-		if (pVertexArray->type == VertexType::POSITION_NORMAL_UV || pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR)
-		{
-			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glTexCoordPointer(2, GL_FLOAT, 0, pVertexArray->pTextureCoordinates);
-		}
-
-		if (pVertexArray->type == VertexType::POSITION_DIFFUSE_ALPHA)
-		{
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
-		}
-
-		if (pVertexArray->type == VertexType::POSITION_DIFFUSE)
-		{
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(3, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
-		}
-
-		if (pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR || pVertexArray->type == VertexType::POSITION_NORMAL_COLOR)
-		{
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[6]);
-		}
+		SetVertexArrayPointers(pVertexArray);
 
 		if (pVertexArray->numIndices != 0)
 		{
@@ -1729,6 +2188,8 @@ bool Renderer::RenderStaticBuffer(unsigned int id)
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 		glDisableClientState(GL_COLOR_ARRAY);
 
+		m_numDrawCalls++;
+
 		rendered = true;
 	}
 
@@ -1737,8 +2198,49 @@ bool Renderer::RenderStaticBuffer(unsigned int id)
 	return rendered;
 }
 
+void Renderer::SetVertexArrayPointers(const VertexArray* pVertexArray) const
+{
+	// Calculate the stride
+	GLsizei totalStride = GetStride(pVertexArray->type);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, totalStride, pVertexArray->pVertexArray);
+
+	if (pVertexArray->type == VertexType::POSITION_NORMAL || pVertexArray->type == VertexType::POSITION_NORMAL_UV || pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR || pVertexArray->type == VertexType::POSITION_NORMAL_COLOR)
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
+	}
+
+	if (pVertexArray->type == VertexType::POSITION_NORMAL_UV || pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, 0, pVertexArray->pTextureCoordinates);
+	}
+
+	if (pVertexArray->type == VertexType::POSITION_DIFFUSE_ALPHA)
+	{
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
+	}
+
+	if (pVertexArray->type == VertexType::POSITION_DIFFUSE)
+	{
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(3, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[3]);
+	}
+
+	if (pVertexArray->type == VertexType::POSITION_NORMAL_UV_COLOR || pVertexArray->type == VertexType::POSITION_NORMAL_COLOR)
+	{
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, totalStride, &pVertexArray->pVertexArray[6]);
+	}
+}
+
 bool Renderer::RenderStaticBufferNoColor(unsigned int id)
 {
+	FlushSpriteBatch();
+
 	m_vertexArraysMutex.lock();
 
 	if (id >= m_vertexArrays.size())
@@ -1822,6 +2324,8 @@ bool Renderer::RenderStaticBufferNoColor(unsigned int id)
 		glDisableClientState(GL_NORMAL_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
+		m_numDrawCalls++;
+
 		rendered = true;
 	}
 
@@ -1832,6 +2336,8 @@ bool Renderer::RenderStaticBufferNoColor(unsigned int id)
 
 bool Renderer::RenderFromArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVertices, int nTextureCoordinates, int nIndices, const void* pVertices, const void* pTextureCoordinates, const unsigned int* pIndices)
 {
+	FlushSpriteBatch();
+
 	if ((type != VertexType::POSITION_DIFFUSE_ALPHA) && (type != VertexType::POSITION_DIFFUSE))
 	{
 		if (materialID != -1)
@@ -1922,6 +2428,8 @@ bool Renderer::RenderFromArray(VertexType type, unsigned int materialID, unsigne
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
 
+	m_numDrawCalls++;
+
 	return true;
 }
 
@@ -2535,6 +3043,8 @@ int Renderer::GetFrameBufferIndex(std::string name)
 
 void Renderer::StartRenderingToFrameBuffer(unsigned int frameBufferID)
 {
+	FlushSpriteBatch();
+
 	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffers[frameBufferID]->fbo);
 	glPushAttrib(GL_VIEWPORT_BIT);
 	glViewport(0, 0, static_cast<int>(m_frameBuffers[frameBufferID]->width * m_frameBuffers[frameBufferID]->viewportScale), static_cast<int>(m_frameBuffers[frameBufferID]->height * m_frameBuffers[frameBufferID]->viewportScale));
@@ -2557,9 +3067,16 @@ void Renderer::StartRenderingToFrameBuffer(unsigned int frameBufferID)
 	glActiveTextureARB(GL_TEXTURE0_ARB);
 	glEnable(GL_TEXTURE_2D);
 
-	// Specify what to render an start acquiring
-	GLenum buffers[] = { GL_COLOR_ATTACHMENT0_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_COLOR_ATTACHMENT2_EXT };
-	glDrawBuffers(3, buffers);
+	// Specify what to render an start acquiring, depth only frame buffers have no color attachments to draw to
+	if (m_frameBuffers[frameBufferID]->diffuseTexture != -1)
+	{
+		GLenum buffers[] = { GL_COLOR_ATTACHMENT0_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_COLOR_ATTACHMENT2_EXT };
+		glDrawBuffers(3, buffers);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+	}
 }
 
 void Renderer::StopRenderingToFrameBuffer(unsigned int frameBufferID) const
@@ -2568,6 +3085,33 @@ void Renderer::StopRenderingToFrameBuffer(unsigned int frameBufferID) const
 	glPopAttrib();
 }
 
+bool Renderer::CopyFrameBufferDepth(unsigned int sourceFrameBufferID, unsigned int destinationFrameBufferID) const
+{
+	if (GLEW_EXT_framebuffer_blit == false)
+	{
+		return false;
+	}
+
+	FrameBuffer* pSource = m_frameBuffers[sourceFrameBufferID];
+	FrameBuffer* pDestination = m_frameBuffers[destinationFrameBufferID];
+
+	int sourceWidth = static_cast<int>(pSource->width * pSource->viewportScale);
+	int sourceHeight = static_cast<int>(pSource->height * pSource->viewportScale);
+	int destinationWidth = static_cast<int>(pDestination->width * pDestination->viewportScale);
+	int destinationHeight = static_cast<int>(pDestination->height * pDestination->viewportScale);
+
+	glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, pSource->fbo);
+	glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, pDestination->fbo);
+
+	// Depth can only be blitted between buffers of the same size, with nearest filtering
+	glBlitFramebufferEXT(0, 0, sourceWidth, sourceHeight, 0, 0, destinationWidth, destinationHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+	// Leave the destination bound for drawing into, as after StartRenderingToFrameBuffer()
+	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, pDestination->fbo);
+
+	return true;
+}
+
 unsigned int Renderer::GetDiffuseTextureFromFrameBuffer(unsigned int frameBufferID)
 {
 	return m_frameBuffers[frameBufferID]->diffuseTexture;
@@ -2593,6 +3137,21 @@ void Renderer::ResetRenderedStats()
 {
 	m_numRenderedVertices = 0;
 	m_numRenderedFaces = 0;
+	m_numDrawCalls = 0;
+	m_numBatchedSprites = 0;
+	m_numFrameUniformUploads = 0;
+
+	for (size_t i = 0; i < m_shaders.size(); ++i)
+	{
+		m_shaders[i]->ResetLocationStats();
+	}
+
+	for (int i = 0; i < static_cast<int>(RenderPass::NumPasses); ++i)
+	{
+		m_renderPassStats[i].m_numPackets = 0;
+		m_renderPassStats[i].m_numDrawCalls = 0;
+		m_renderPassStats[i].m_numStateChanges = 0;
+	}
 }
 
 int Renderer::GetNumRenderedVertices()
@@ -2605,6 +3164,16 @@ int Renderer::GetNumRenderedFaces()
 	return m_numRenderedFaces;
 }
 
+int Renderer::GetNumDrawCalls()
+{
+	return m_numDrawCalls;
+}
+
+int Renderer::GetNumBatchedSprites()
+{
+	return m_numBatchedSprites;
+}
+
 // Shaders
 bool Renderer::LoadGLSLShader(const char* vertexFile, const char* fragmentFile, unsigned int* pID)
 {
@@ -2616,6 +3185,9 @@ bool Renderer::LoadGLSLShader(const char* vertexFile, const char* fragmentFile,
 
 	if (pShader != nullptr)
 	{
+		// Shaders that use the shared frame uniforms read them from the one buffer
+		pShader->BindUniformBlock("FrameUniforms", FRAME_UNIFORMS_BINDING);
+
 		// Push the vertex array onto the list
 		m_shaders.push_back(pShader);
 
@@ -2632,11 +3204,15 @@ bool Renderer::LoadGLSLShader(const char* vertexFile, const char* fragmentFile,
 
 void Renderer::BeginGLSLShader(unsigned int shaderID)
 {
+	FlushSpriteBatch();
+
 	m_shaders[shaderID]->begin();
 }
 
 void Renderer::EndGLSLShader(unsigned int shaderID)
 {
+	FlushSpriteBatch();
+
 	m_shaders[shaderID]->end();
 }
 
@@ -2645,6 +3221,77 @@ glShader* Renderer::GetShader(unsigned int shaderID)
 	return m_shaders[shaderID];
 }
 
+void Renderer::GetShaderLocationStats(int* pNumLookups, int* pNumQueries) const
+{
+	*pNumLookups = 0;
+	*pNumQueries = 0;
+
+	for (size_t i = 0; i < m_shaders.size(); ++i)
+	{
+		int numLookups;
+		int numQueries;
+		m_shaders[i]->GetLocationStats(&numLookups, &numQueries);
+
+		*pNumLookups += numLookups;
+		*pNumQueries += numQueries;
+	}
+}
+
+// Frame uniforms
+void Renderer::SetFrameFog(bool enabled, float start, float end, const Color& color)
+{
+	memcpy(m_frameUniforms.m_fogColor, color.GetRGBA(), 4 * sizeof(float));
+	m_frameUniforms.m_fogParams[0] = start;
+	m_frameUniforms.m_fogParams[1] = end;
+	m_frameUniforms.m_fogParams[2] = enabled ? 1.0f : 0.0f;
+	m_frameUniforms.m_fogParams[3] = 0.0f;
+}
+
+void Renderer::UploadFrameUniforms()
+{
+	if (GLEW_ARB_uniform_buffer_object == false)
+	{
+		return;
+	}
+
+	glGetFloatv(GL_MODELVIEW_MATRIX, m_frameUniforms.m_viewMatrix);
+	glGetFloatv(GL_PROJECTION_MATRIX, m_frameUniforms.m_projectionMatrix);
+
+	if (m_frameUniformBuffer == 0)
+	{
+		glGenBuffers(1, &m_frameUniformBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), &m_frameUniforms, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		// The binding stays put, every shader's block was pointed at it when it was loaded
+		glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, m_frameUniformBuffer);
+
+		memcpy(&m_uploadedFrameUniforms, &m_frameUniforms, sizeof(FrameUniforms));
+		m_numFrameUniformUploads++;
+
+		return;
+	}
+
+	// Most draws in a pass share the camera, so nothing needs sending again
+	if (memcmp(&m_uploadedFrameUniforms, &m_frameUniforms, sizeof(FrameUniforms)) == 0)
+	{
+		return;
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &m_frameUniforms);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	memcpy(&m_uploadedFrameUniforms, &m_frameUniforms, sizeof(FrameUniforms));
+	m_numFrameUniformUploads++;
+}
+
+int Renderer::GetNumFrameUniformUploads() const
+{
+	return m_numFrameUniformUploads;
+}
+
 #ifdef _DEBUG
 #pragma warning(pop)
 #endif
\ No newline at end of file
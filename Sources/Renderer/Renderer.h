@@ -12,7 +12,6 @@
 
 #include "GLSL.h"
 
-#include <freetype/freetypefont.h>
 #include <GL/glew.h>
 #include <tinythread/tinythread.h>
 
@@ -20,13 +19,18 @@
 #include <Maths/Bezier4.h>
 #include <Maths/Matrix4.h>
 
+#include "AtlasFont.h"
 #include "Color.h"
 #include "FrameBuffer.h"
 #include "Frustum.h"
+#include "GlyphAtlas.h"
 #include "Light.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
 #include "VertexArray.h"
 #include "Viewport.h"
 
@@ -147,6 +151,19 @@ struct UVCoordinate
 	float u, v;			// Texture coordinates.
 };
 
+// Laid out to match the std140 FrameUniforms block in the shaders, so everything is a mat4 or a vec4
+struct FrameUniforms
+{
+	float m_viewMatrix[16];
+	float m_projectionMatrix[16];
+	float m_lightAmbient[4];
+	float m_lightDiffuse[4];
+	float m_lightPosition[4];
+	float m_lightAttenuation[4];	// Constant, linear, quadratic.
+	float m_fogColor[4];
+	float m_fogParams[4];			// Start, end, enabled.
+};
+
 class Renderer
 {
 public:
@@ -203,6 +220,8 @@ public:
 
 	// Texture matrix manipulations
 	void SetTextureMatrix();
+	// Loads the matrix as it is, for shaders that work out their own projection from it
+	void SetTextureMatrix(const Matrix4& matrix);
 	void PushTextureMatrix();
 	void PopTextureMatrix();
 
@@ -213,6 +232,8 @@ public:
 	// Screen projection
 	glm::vec3 GetWorldProjectionFromScreenCoordinates(int x, int y, float z) const;
 	void GetScreenCoordinatesFromWorldPosition(glm::vec3 position, int* x, int* y);
+	// The same, for many positions at once, the matrices are only read back the one time
+	void GetScreenCoordinatesFromWorldPositions(const glm::vec3* pPositions, int numPositions, int* pX, int* pY);
 
 	// Clip planes
 	void EnableClipPlane(unsigned int index, double eq1, double eq2, double eq3, double eq4);
@@ -262,10 +283,15 @@ public:
 	// Text rendering
 	bool CreateFreeTypeFont(const char* fontName, int fontSize, unsigned int* pID, bool noAutoHint = false);
 	bool RenderFreeTypeText(unsigned int fontID, float x, float y, float z, Color color, float scale, const char *inText, ...);
+	// Draws the text as it is, without formatting. The text is UTF-8.
+	bool RenderFreeTypeString(unsigned int fontID, float x, float y, float z, Color color, float scale, const char* text);
 	int GetFreeTypeTextWidth(unsigned int fontID, const char* inText, ...);
 	int GetFreeTypeTextHeight(unsigned int fontID, const char* inText, ...);
 	int GetFreeTypeTextAscent(unsigned int fontID);
 	int GetFreeTypeTextDescent(unsigned int fontID);
+	int GetNumCachedTextMeshes() const;
+	int GetNumGlyphs() const;
+	void ClearTextMeshCaches();
 
 	// Lighting
 	bool CreateLight(const Color& ambient, const Color& diffuse, const Color& specular, glm::vec3& position, glm::vec3& direction, float exponent, float cutoff, float cAtten, float lAtten, float qAtten, bool point, bool spot, unsigned int* pID);
@@ -301,6 +327,7 @@ public:
 	void BindRawTextureID(unsigned int textureID) const;
 	void GenerateEmptyTexture(unsigned int* pID);
 	void SetTextureData(unsigned int id, int width, int height, unsigned char* texData);
+	int GetNumTextureAtlasPages() const;
 
 	// Cube textures
 	bool LoadCubeTexture(int* width, int* height, std::string front, std::string back, std::string top, std::string bottom, std::string left, std::string right, unsigned int* pID) const;
@@ -308,6 +335,25 @@ public:
 	void EmptyCubeTextureIndex(unsigned int textureIndex) const;
 	void DisableCubeTexture() const;
 
+	// Sprite batching, atlased textures drawn between BeginSpriteBatch() and EndSpriteBatch() are merged into as few draws as possible
+	void BeginSpriteBatch();
+	void EndSpriteBatch();
+	// Queues a textured quad using the current world matrix, texture coordinates are in the texture's own 0-1 range. Returns false if the texture is not atlased or no batch has begun, and the caller should draw it itself.
+	bool AddSpriteToBatch(unsigned int textureID, float x1, float y1, float x2, float y2, float z, float s1, float t1, float s2, float t2);
+
+	// Render queue, packets are submitted once a frame and each pass draws the ones marked for it, relative to the current world matrix
+	void ClearRenderQueue();
+	void SubmitRenderPacket(const RenderPacket& packet);
+	// Culls against the viewport's frustum unless cullViewportID is -1, returns the number of packets drawn
+	int RenderQueuePass(RenderPass pass, int cullViewportID);
+	// Culls against a box in the box's own view space instead, for orthographic passes such as shadow maps
+	int RenderQueuePass(RenderPass pass, const RenderCullBox& cullBox);
+	// Drawn through a mirror in the horizontal plane at mirrorHeight. Packets under the plane are dropped, and the rest are culled at their reflected position.
+	int RenderQueueMirroredPass(RenderPass pass, int cullViewportID, float mirrorHeight);
+	unsigned long long GetRenderQueueSignature(RenderPass pass, const RenderCullBox& cullBox) const;
+	int GetNumRenderQueuePackets() const;
+	const RenderPassStats& GetRenderPassStats(RenderPass pass) const;
+
 	// Vertex buffers
 	bool CreateStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVertices, int nTextureCoordinates, int nIndices, const void* pVertices, const void* pTextureCoordinates, const unsigned int* pIndices, unsigned int* pID);
 	bool RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned int materialID, unsigned int textureID, int nVertices, int nTextureCoordinates, int nIndices, const void* pVertices, const void* pTextureCoordinates, const unsigned int* pIndices);
@@ -316,6 +362,7 @@ public:
 	bool RenderStaticBufferNoColor(unsigned int id);
 	bool RenderFromArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVertices, int nTextureCoordinates, int nIndices, const void* pVertices, const void* pTextureCoordinates, const unsigned int* pIndices);
 	unsigned int GetStride(VertexType type) const;
+	void SetVertexArrayPointers(const VertexArray* pVertexArray) const;
 
 	// Mesh
 	TriangleMesh* CreateMesh(MeshType meshType) const;
@@ -355,6 +402,8 @@ public:
 	int GetFrameBufferIndex(std::string name);
 	void StartRenderingToFrameBuffer(unsigned int frameBufferID);
 	void StopRenderingToFrameBuffer(unsigned int frameBufferID) const;
+	// Copies the depth of one frame buffer into another of the same size, returns false if frame buffer blits aren't supported
+	bool CopyFrameBufferDepth(unsigned int sourceFrameBufferID, unsigned int destinationFrameBufferID) const;
 	unsigned int GetDiffuseTextureFromFrameBuffer(unsigned int frameBufferID);
 	unsigned int GetPositionTextureFromFrameBuffer(unsigned int frameBufferID);
 	unsigned int GetNormalTextureFromFrameBuffer(unsigned int frameBufferID);
@@ -364,12 +413,24 @@ public:
 	void ResetRenderedStats();
 	int GetNumRenderedVertices();
 	int GetNumRenderedFaces();
+	int GetNumDrawCalls();
+	int GetNumBatchedSprites();
 
 	// Shaders
 	bool LoadGLSLShader(const char* vertexFile, const char* fragmentFile, unsigned int* pID);
 	void BeginGLSLShader(unsigned int shaderID);
 	void EndGLSLShader(unsigned int shaderID);
 	glShader* GetShader(unsigned int shaderID);
+	// Uniform and attribute location lookups made by every shader since the stats were reset, and how many had to ask the driver
+	void GetShaderLocationStats(int* pNumLookups, int* pNumQueries) const;
+
+	// Frame uniforms, shared by every shader that declares the FrameUniforms block
+	void SetFrameFog(bool enabled, float start, float end, const Color& color);
+	// Takes the current projection and modelview matrices, and only uploads when something has changed since the last upload
+	void UploadFrameUniforms();
+	int GetNumFrameUniformUploads() const;
+
+	static const unsigned int FRAME_UNIFORMS_BINDING = 0;
 	
 private:
 	// Window's width and height
@@ -408,11 +469,26 @@ private:
 	// Textures
 	std::vector<Texture*> m_textures;
 
+	// Texture atlas, m_textureAtlasRegions is indexed by texture id
+	TextureAtlas* m_pTextureAtlas;
+	std::vector<TextureAtlasRegion> m_textureAtlasRegions;
+
+	// Sprite batching
+	void FlushSpriteBatch();
+	SpriteBatch* m_pSpriteBatch;
+
+	// Render queue
+	int RenderQueuePackets(RenderPass pass, int cullViewportID, const RenderCullBox* pCullBox, bool isMirrored, float mirrorHeight);
+	RenderQueue* m_pRenderQueue;
+	RenderPassStats m_renderPassStats[static_cast<int>(RenderPass::NumPasses)];
+
 	// Lights
 	std::vector<Light*> m_lights;
 
-	// Fonts
-	std::vector<FreeTypeFont*> m_freetypeFonts;
+	// Fonts, every font's glyphs share the one glyph atlas texture
+	std::vector<AtlasFont*> m_freetypeFonts;
+	GlyphAtlas* m_pGlyphAtlas;
+	std::vector<SpriteVertex> m_textVertices;
 
 	// Vertex arrays, for storing static vertex data
 	std::vector<VertexArray*> m_vertexArrays;
@@ -424,11 +500,19 @@ private:
 	// Rendered information
 	int m_numRenderedVertices;
 	int m_numRenderedFaces;
+	int m_numDrawCalls;
+	int m_numBatchedSprites;
 
 	// Shaders
 	glShaderManager m_shaderManager;
 	std::vector<glShader*> m_shaders;
 
+	// Frame uniforms
+	FrameUniforms m_frameUniforms;
+	FrameUniforms m_uploadedFrameUniforms;
+	GLuint m_frameUniformBuffer;
+	int m_numFrameUniformUploads;
+
 	// Matrices
 	Matrix4* m_projection;
 	Matrix4 m_view;
@@ -0,0 +1,212 @@
+/*************************************************************************
+> File Name: ShadowCascades.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Nested orthographic shadow maps around the player, sharing one light
+> 	 view. The chunks in each cascade are drawn into a cache that is only
+> 	 redrawn when they change, and copied in under the moving casters.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "ShadowCascades.h"
+
+// Each cascade covers this many times the area of the one inside it
+const float CASCADE_SPLIT_SCALE = 3.0f;
+
+// Cascades move in steps of this fraction of their size, so the static cache isn't redrawn for every texel the player moves
+const float CASCADE_SNAP_FRACTION = 0.125f;
+
+// Casters this far towards the light from the largest cascade still throw shadows into it
+const float CASCADE_DEPTH_SCALE = 2.0f;
+
+// Constructor, Destructor
+ShadowCascades::ShadowCascades(Renderer* pRenderer) :
+	m_pRenderer(pRenderer), m_numCascades(0), m_mapSize(0), m_isStaticCacheSupported(false), m_numStaticRedraws(0)
+{
+	for (int i = 0; i < MAX_CASCADES; ++i)
+	{
+		m_cascades[i].m_frameBuffer = -1;
+		m_cascades[i].m_staticFrameBuffer = -1;
+		m_cascades[i].m_isStaticCached = false;
+		m_cascades[i].m_staticSignature = 0;
+		m_cascades[i].m_isStaticDirty = true;
+	}
+}
+
+ShadowCascades::~ShadowCascades()
+{
+	// The frame buffers belong to the renderer
+}
+
+bool ShadowCascades::Create(int numCascades, int mapSize)
+{
+	m_numCascades = std::max(1, std::min(numCascades, static_cast<int>(MAX_CASCADES)));
+	m_mapSize = mapSize;
+
+	// Without blits the chunks are just drawn into every cascade every frame
+	m_isStaticCacheSupported = GLEW_EXT_framebuffer_blit != 0;
+
+	bool isCreated = true;
+	char frameBufferName[64];
+
+	for (int i = 0; i < m_numCascades; ++i)
+	{
+		sprintf(frameBufferName, "Shadow Cascade %i", i);
+		isCreated &= m_pRenderer->CreateFrameBuffer(-1, false, false, false, true, m_mapSize, m_mapSize, 1.0f, frameBufferName, &m_cascades[i].m_frameBuffer);
+
+		if (m_isStaticCacheSupported)
+		{
+			sprintf(frameBufferName, "Shadow Cascade %i Static", i);
+			isCreated &= m_pRenderer->CreateFrameBuffer(-1, false, false, false, true, m_mapSize, m_mapSize, 1.0f, frameBufferName, &m_cascades[i].m_staticFrameBuffer);
+		}
+	}
+
+	return isCreated;
+}
+
+void ShadowCascades::Update(const glm::vec3& focus, const glm::vec3& lightPosition, const glm::vec3& lightTarget, float radius)
+{
+	m_numStaticRedraws = 0;
+
+	// The light view is anchored in the world rather than following the player, so the chunks stay put in it while the player moves
+	glm::vec3 forward = normalize(lightTarget - lightPosition);
+	glm::vec3 up = std::fabs(forward.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 side = normalize(cross(forward, up));
+	up = cross(side, forward);
+
+	Matrix4 lightViewMatrix;
+	float* m = lightViewMatrix.m_data;
+	m[0] = side.x;		m[4] = side.y;		m[8] = side.z;		m[12] = -dot(side, lightPosition);
+	m[1] = up.x;		m[5] = up.y;		m[9] = up.z;		m[13] = -dot(up, lightPosition);
+	m[2] = -forward.x;	m[6] = -forward.y;	m[10] = -forward.z;	m[14] = dot(forward, lightPosition);
+	m[3] = 0.0f;		m[7] = 0.0f;		m[11] = 0.0f;		m[15] = 1.0f;
+
+	bool hasLightMoved = Matrix4::Equal(lightViewMatrix, m_lightViewMatrix) == false;
+	m_lightViewMatrix = lightViewMatrix;
+
+	glm::vec3 lightSpaceFocus;
+	Matrix4::Multiply(m_lightViewMatrix, focus, lightSpaceFocus);
+
+	float depthExtent = radius * CASCADE_DEPTH_SCALE;
+
+	for (int i = 0; i < m_numCascades; ++i)
+	{
+		Cascade* pCascade = &m_cascades[i];
+
+		float cascadeRadius = radius / std::pow(CASCADE_SPLIT_SCALE, static_cast<float>(m_numCascades - 1 - i));
+
+		// Snapped to whole texels, so shadow edges don't shimmer as the cascade moves
+		float texelSize = (cascadeRadius * 2.0f) / m_mapSize;
+		float snapSize = std::max(texelSize, std::floor(cascadeRadius * CASCADE_SNAP_FRACTION / texelSize) * texelSize);
+
+		glm::vec3 center;
+		center.x = std::floor(lightSpaceFocus.x / snapSize + 0.5f) * snapSize;
+		center.y = std::floor(lightSpaceFocus.y / snapSize + 0.5f) * snapSize;
+		center.z = std::floor(lightSpaceFocus.z / snapSize + 0.5f) * snapSize;
+
+		pCascade->m_left = center.x - cascadeRadius;
+		pCascade->m_right = center.x + cascadeRadius;
+		pCascade->m_bottom = center.y - cascadeRadius;
+		pCascade->m_top = center.y + cascadeRadius;
+		pCascade->m_near = -center.z - depthExtent;
+		pCascade->m_far = -center.z + depthExtent;
+
+		pCascade->m_cullBox.m_viewMatrix = m_lightViewMatrix;
+		pCascade->m_cullBox.m_min = glm::vec3(pCascade->m_left, pCascade->m_bottom, -pCascade->m_far);
+		pCascade->m_cullBox.m_max = glm::vec3(pCascade->m_right, pCascade->m_top, -pCascade->m_near);
+
+		if (m_isStaticCacheSupported)
+		{
+			unsigned long long signature = m_pRenderer->GetRenderQueueSignature(RenderPass::Shadow, pCascade->m_cullBox);
+
+			pCascade->m_isStaticDirty = pCascade->m_isStaticCached == false || hasLightMoved ||
+				pCascade->m_staticCenter != center || pCascade->m_staticSignature != signature;
+
+			pCascade->m_staticCenter = center;
+			pCascade->m_staticSignature = signature;
+		}
+	}
+}
+
+int ShadowCascades::GetNumCascades() const
+{
+	return m_numCascades;
+}
+
+int ShadowCascades::GetMapSize() const
+{
+	return m_mapSize;
+}
+
+const Matrix4& ShadowCascades::GetLightViewMatrix() const
+{
+	return m_lightViewMatrix;
+}
+
+const RenderCullBox& ShadowCascades::GetCullBox(int cascade) const
+{
+	return m_cascades[cascade].m_cullBox;
+}
+
+unsigned int ShadowCascades::GetFrameBuffer(int cascade) const
+{
+	return m_cascades[cascade].m_frameBuffer;
+}
+
+void ShadowCascades::SetupProjection(int cascade) const
+{
+	const Cascade& c = m_cascades[cascade];
+
+	m_pRenderer->SetupOrthographicProjection(c.m_left, c.m_right, c.m_bottom, c.m_top, c.m_near, c.m_far);
+	m_pRenderer->SetWorldMatrix(m_lightViewMatrix);
+}
+
+void ShadowCascades::GetShadowMapTransform(int cascade, glm::vec3* pScale, glm::vec3* pOffset) const
+{
+	const Cascade& c = m_cascades[cascade];
+
+	// The orthographic projection followed by the move from [-1, 1] to [0, 1], the light looks down -z
+	pScale->x = 1.0f / (c.m_right - c.m_left);
+	pScale->y = 1.0f / (c.m_top - c.m_bottom);
+	pScale->z = -1.0f / (c.m_far - c.m_near);
+
+	pOffset->x = -c.m_left / (c.m_right - c.m_left);
+	pOffset->y = -c.m_bottom / (c.m_top - c.m_bottom);
+	pOffset->z = -c.m_near / (c.m_far - c.m_near);
+}
+
+bool ShadowCascades::IsStaticCacheSupported() const
+{
+	return m_isStaticCacheSupported;
+}
+
+bool ShadowCascades::IsStaticCacheDirty(int cascade) const
+{
+	return m_cascades[cascade].m_isStaticDirty;
+}
+
+unsigned int ShadowCascades::GetStaticFrameBuffer(int cascade) const
+{
+	return m_cascades[cascade].m_staticFrameBuffer;
+}
+
+void ShadowCascades::SetStaticCacheDrawn(int cascade)
+{
+	m_cascades[cascade].m_isStaticCached = true;
+	m_cascades[cascade].m_isStaticDirty = false;
+
+	m_numStaticRedraws++;
+}
+
+int ShadowCascades::GetNumStaticRedraws() const
+{
+	return m_numStaticRedraws;
+}
@@ -0,0 +1,90 @@
+/*************************************************************************
+> File Name: ShadowCascades.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Nested orthographic shadow maps around the player, sharing one light
+> 	 view. The chunks in each cascade are drawn into a cache that is only
+> 	 redrawn when they change, and copied in under the moving casters.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_SHADOW_CASCADES_H
+#define CUBBY_SHADOW_CASCADES_H
+
+#include "Renderer.h"
+
+class ShadowCascades
+{
+public:
+	// Constructor, Destructor
+	ShadowCascades(Renderer* pRenderer);
+	~ShadowCascades();
+
+	// Creates the depth frame buffers, the number of cascades is clamped between 1 and MAX_CASCADES
+	bool Create(int numCascades, int mapSize);
+
+	// Fits the cascades around the focus point, the largest covering radius, as seen from lightPosition looking at lightTarget.
+	// Needs this frame's render packets, a cascade whose chunks have changed since they were cached is marked dirty.
+	void Update(const glm::vec3& focus, const glm::vec3& lightPosition, const glm::vec3& lightTarget, float radius);
+
+	int GetNumCascades() const;
+	int GetMapSize() const;
+	const Matrix4& GetLightViewMatrix() const;
+	const RenderCullBox& GetCullBox(int cascade) const;
+	unsigned int GetFrameBuffer(int cascade) const;
+
+	// Loads the cascade's orthographic projection and the light view, ready for drawing casters into it
+	void SetupProjection(int cascade) const;
+
+	// Scale and offset that take a light view position to the cascade's shadow map coordinates and depth
+	void GetShadowMapTransform(int cascade, glm::vec3* pScale, glm::vec3* pOffset) const;
+
+	// Static geometry cache, only used when frame buffer depth can be copied
+	bool IsStaticCacheSupported() const;
+	bool IsStaticCacheDirty(int cascade) const;
+	unsigned int GetStaticFrameBuffer(int cascade) const;
+	void SetStaticCacheDrawn(int cascade);
+
+	// How many caches were redrawn since the last Update()
+	int GetNumStaticRedraws() const;
+
+	static const int MAX_CASCADES = 4;
+
+private:
+	struct Cascade
+	{
+		unsigned int m_frameBuffer;
+		unsigned int m_staticFrameBuffer;
+
+		// Orthographic bounds in light view space, the near and far planes are distances along the light's view direction
+		float m_left;
+		float m_right;
+		float m_bottom;
+		float m_top;
+		float m_near;
+		float m_far;
+
+		RenderCullBox m_cullBox;
+
+		// What the static cache was last drawn with
+		bool m_isStaticCached;
+		glm::vec3 m_staticCenter;
+		unsigned long long m_staticSignature;
+		bool m_isStaticDirty;
+	};
+
+	Renderer* m_pRenderer;
+
+	Cascade m_cascades[MAX_CASCADES];
+	int m_numCascades;
+	int m_mapSize;
+
+	Matrix4 m_lightViewMatrix;
+
+	bool m_isStaticCacheSupported;
+	int m_numStaticRedraws;
+};
+
+#endif
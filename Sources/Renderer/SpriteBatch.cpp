@@ -0,0 +1,115 @@
+/*************************************************************************
+> File Name: SpriteBatch.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Collects textured 2D quads that share an atlas page and draws them
+> 	 with a single call. The renderer flushes it before anything else is
+> 	 drawn, so the GUI's draw order is kept.
+> Created Time: 2016/09/13
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include "SpriteBatch.h"
+
+// Constructor, Destructor
+SpriteBatch::SpriteBatch() :
+	m_isActive(false), m_pageTextureID(0), m_type(SpriteType::Sprite)
+{
+	m_vertices.reserve(4096);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+	m_vertices.clear();
+}
+
+void SpriteBatch::Begin()
+{
+	m_isActive = true;
+}
+
+bool SpriteBatch::End()
+{
+	bool isFlushed = Flush();
+
+	m_isActive = false;
+
+	return isFlushed;
+}
+
+bool SpriteBatch::IsActive() const
+{
+	return m_isActive;
+}
+
+bool SpriteBatch::AddSprite(GLuint pageTextureID, const SpriteVertex* pVertices)
+{
+	return AddQuads(pageTextureID, SpriteType::Sprite, pVertices, 4);
+}
+
+bool SpriteBatch::AddQuads(GLuint pageTextureID, SpriteType type, const SpriteVertex* pVertices, int numVertices)
+{
+	bool isFlushed = false;
+
+	if (pageTextureID != m_pageTextureID || type != m_type)
+	{
+		isFlushed = Flush();
+		m_pageTextureID = pageTextureID;
+		m_type = type;
+	}
+
+	m_vertices.insert(m_vertices.end(), pVertices, pVertices + numVertices);
+
+	return isFlushed;
+}
+
+bool SpriteBatch::Flush()
+{
+	if (m_vertices.empty())
+	{
+		return false;
+	}
+
+	glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_POLYGON_BIT | GL_LIGHTING_BIT);
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+	// The vertices are already in eye space
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glDisable(GL_LIGHTING);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, m_pageTextureID);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	if (m_type == SpriteType::Text)
+	{
+		glDisable(GL_DEPTH_TEST);
+	}
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(SpriteVertex), &m_vertices[0].x);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteVertex), &m_vertices[0].u);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glColorPointer(4, GL_FLOAT, sizeof(SpriteVertex), &m_vertices[0].r);
+	glDisableClientState(GL_NORMAL_ARRAY);
+
+	glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(m_vertices.size()));
+
+	glPopMatrix();
+	glPopClientAttrib();
+	glPopAttrib();
+
+	m_vertices.clear();
+
+	return true;
+}
+
+int SpriteBatch::GetNumQueuedSprites() const
+{
+	return static_cast<int>(m_vertices.size()) / 4;
+}
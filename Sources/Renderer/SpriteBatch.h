@@ -0,0 +1,64 @@
+/*************************************************************************
+> File Name: SpriteBatch.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Collects textured 2D quads that share an atlas page and draws them
+> 	 with a single call. The renderer flushes it before anything else is
+> 	 drawn, so the GUI's draw order is kept.
+> Created Time: 2016/09/13
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_SPRITE_BATCH_H
+#define CUBBY_SPRITE_BATCH_H
+
+#include <GL/glew.h>
+
+#include <vector>
+
+struct SpriteVertex
+{
+	float x, y, z;		// Position, in eye space.
+	float u, v;			// Texture coordinates, in the atlas page.
+	float r, g, b, a;	// Vertex color.
+};
+
+enum class SpriteType
+{
+	Sprite,
+	Text,		// Drawn without depth testing, the same as the rest of the text.
+};
+
+class SpriteBatch
+{
+public:
+	// Constructor, Destructor
+	SpriteBatch();
+	~SpriteBatch();
+
+	// Sprites are only collected between Begin() and End(), End() draws whatever is left
+	void Begin();
+	bool End();
+	bool IsActive() const;
+
+	// Four corners in eye space, in quad order. Queuing a sprite from a different page flushes the previous ones first.
+	bool AddSprite(GLuint pageTextureID, const SpriteVertex* pVertices);
+
+	// Several quads at once, four vertices each. Changing the page or the type flushes the previous ones first.
+	bool AddQuads(GLuint pageTextureID, SpriteType type, const SpriteVertex* pVertices, int numVertices);
+
+	// Draws the queued sprites, returns true if anything was drawn. Leaves the GL state as it found it.
+	bool Flush();
+
+	int GetNumQueuedSprites() const;
+
+private:
+	bool m_isActive;
+
+	GLuint m_pageTextureID;
+	SpriteType m_type;
+	std::vector<SpriteVertex> m_vertices;
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*************************************************************************
+> File Name: TextureAtlas.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Packs the small GUI and item textures into a few large pages as they
+> 	 are loaded, so the GUI can draw icons from many files without
+> 	 switching textures.
+> Created Time: 2016/09/13
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+
+#include "TextureAtlas.h"
+#include "Texture.h"
+
+// Constructor, Destructor
+TextureAtlas::TextureAtlas()
+{
+	// Pages are created as they are needed
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	for (size_t i = 0; i < m_pages.size(); ++i)
+	{
+		glDeleteTextures(1, &m_pages[i].m_textureID);
+	}
+	m_pages.clear();
+}
+
+bool TextureAtlas::IsAtlasTexture(const std::string& fileName, int width, int height)
+{
+	if (width <= 0 || height <= 0 || width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE)
+	{
+		return false;
+	}
+
+	std::string path = fileName;
+	std::replace(path.begin(), path.end(), '\\', '/');
+
+	return path.find("textures/gui/") != std::string::npos || path.find("textures/items/") != std::string::npos;
+}
+
+bool TextureAtlas::AddTexture(const Texture* pTexture, TextureAtlasRegion* pRegion)
+{
+	pRegion->m_page = -1;
+
+	int width = pTexture->GetWidth();
+	int height = pTexture->GetHeight();
+	int paddedWidth = width + PADDING * 2;
+	int paddedHeight = height + PADDING * 2;
+
+	int page;
+	int x;
+	int y;
+	if (AllocateRegion(paddedWidth, paddedHeight, &page, &x, &y) == false)
+	{
+		return false;
+	}
+
+	// Read the texels back from the texture that was just loaded
+	std::vector<unsigned char> texels(width * height * 4);
+	glBindTexture(GL_TEXTURE_2D, pTexture->GetID());
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0]);
+
+	std::vector<unsigned char> paddedTexels(paddedWidth * paddedHeight * 4);
+	for (int paddedY = 0; paddedY < paddedHeight; ++paddedY)
+	{
+		int sourceY = std::min(std::max(paddedY - PADDING, 0), height - 1);
+
+		for (int paddedX = 0; paddedX < paddedWidth; ++paddedX)
+		{
+			int sourceX = std::min(std::max(paddedX - PADDING, 0), width - 1);
+
+			const unsigned char* pSource = &texels[(sourceY * width + sourceX) * 4];
+			unsigned char* pDestination = &paddedTexels[(paddedY * paddedWidth + paddedX) * 4];
+
+			pDestination[0] = pSource[0];
+			pDestination[1] = pSource[1];
+			pDestination[2] = pSource[2];
+			pDestination[3] = pSource[3];
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_pages[page].m_textureID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, &paddedTexels[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	float pageSize = static_cast<float>(PAGE_SIZE);
+
+	pRegion->m_page = page;
+	pRegion->m_s1 = (x + PADDING) / pageSize;
+	pRegion->m_t1 = (y + PADDING) / pageSize;
+	pRegion->m_s2 = (x + PADDING + width) / pageSize;
+	pRegion->m_t2 = (y + PADDING + height) / pageSize;
+
+	return true;
+}
+
+GLuint TextureAtlas::GetPageTextureID(int page) const
+{
+	return m_pages[page].m_textureID;
+}
+
+int TextureAtlas::GetNumPages() const
+{
+	return static_cast<int>(m_pages.size());
+}
+
+bool TextureAtlas::AllocateRegion(int width, int height, int* pPage, int* pX, int* pY)
+{
+	if (width > PAGE_SIZE || height > PAGE_SIZE)
+	{
+		return false;
+	}
+
+	for (int i = 0; i <= static_cast<int>(m_pages.size()); ++i)
+	{
+		if (i == static_cast<int>(m_pages.size()))
+		{
+			CreatePage();
+		}
+
+		TextureAtlasPage* pAtlasPage = &m_pages[i];
+
+		// Start a new shelf if the texture doesn't fit on the end of the current one
+		if (pAtlasPage->m_shelfX + width > PAGE_SIZE || pAtlasPage->m_shelfY + std::max(pAtlasPage->m_shelfHeight, height) > PAGE_SIZE)
+		{
+			if (pAtlasPage->m_shelfY + pAtlasPage->m_shelfHeight + height > PAGE_SIZE)
+			{
+				// This page is full
+				continue;
+			}
+
+			pAtlasPage->m_shelfX = 0;
+			pAtlasPage->m_shelfY += pAtlasPage->m_shelfHeight;
+			pAtlasPage->m_shelfHeight = 0;
+		}
+
+		*pPage = i;
+		*pX = pAtlasPage->m_shelfX;
+		*pY = pAtlasPage->m_shelfY;
+
+		pAtlasPage->m_shelfX += width;
+		pAtlasPage->m_shelfHeight = std::max(pAtlasPage->m_shelfHeight, height);
+
+		return true;
+	}
+
+	return false;
+}
+
+int TextureAtlas::CreatePage()
+{
+	TextureAtlasPage page;
+	page.m_shelfX = 0;
+	page.m_shelfY = 0;
+	page.m_shelfHeight = 0;
+
+	glGenTextures(1, &page.m_textureID);
+	glBindTexture(GL_TEXTURE_2D, page.m_textureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	m_pages.push_back(page);
+
+	return static_cast<int>(m_pages.size()) - 1;
+}
@@ -0,0 +1,70 @@
+/*************************************************************************
+> File Name: TextureAtlas.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Packs the small GUI and item textures into a few large pages as they
+> 	 are loaded, so the GUI can draw icons from many files without
+> 	 switching textures.
+> Created Time: 2016/09/13
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_TEXTURE_ATLAS_H
+#define CUBBY_TEXTURE_ATLAS_H
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+class Texture;
+
+// Where a texture ended up, m_page is -1 if the texture is not in the atlas
+struct TextureAtlasRegion
+{
+	int m_page;
+	float m_s1, m_t1;
+	float m_s2, m_t2;
+};
+
+struct TextureAtlasPage
+{
+	GLuint m_textureID;
+
+	// Shelf packing, textures are placed left to right along the current shelf
+	int m_shelfX;
+	int m_shelfY;
+	int m_shelfHeight;
+};
+
+class TextureAtlas
+{
+public:
+	// Constructor, Destructor
+	TextureAtlas();
+	~TextureAtlas();
+
+	// Only textures from the gui and items folders that are small enough are packed
+	static bool IsAtlasTexture(const std::string& fileName, int width, int height);
+
+	// Copies a loaded texture into a page, returns false if it could not be packed
+	bool AddTexture(const Texture* pTexture, TextureAtlasRegion* pRegion);
+
+	GLuint GetPageTextureID(int page) const;
+	int GetNumPages() const;
+
+	static const int PAGE_SIZE = 2048;
+	static const int MAX_TEXTURE_SIZE = 512;
+
+	// Each texture's edge texels are repeated into this border, so nearest sampling at the edges never picks up a neighbour
+	static const int PADDING = 1;
+
+private:
+	bool AllocateRegion(int width, int height, int* pPage, int* pX, int* pY);
+	int CreatePage();
+
+	std::vector<TextureAtlasPage> m_pages;
+};
+
+#endif
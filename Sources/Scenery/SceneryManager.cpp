@@ -7,6 +7,8 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <CubbyGame.h>
+
 #include "SceneryManager.h"
 
 // Constructor, Destructor
@@ -26,6 +28,8 @@ void SceneryManager::ClearSceneryObjects()
 {
 	for (size_t i = 0; i < m_vpSceneryObjectList.size(); ++i)
 	{
+		CubbyGame::GetInstance()->GetQubicleBinaryManager()->ReleaseQubicleBinaryFile(m_vpSceneryObjectList[i]->m_pQubicleBinaryFile);
+
 		delete m_vpSceneryObjectList[i];
 		m_vpSceneryObjectList[i] = nullptr;
 	}
@@ -70,8 +74,7 @@ SceneryObject* SceneryManager::AddSceneryObject(std::string name, std::string fi
 {
 	// TODO: Should add back in duplicate name check?
 	
-	QubicleBinary* pQubicleBinaryFile = new QubicleBinary(m_pRenderer);
-	pQubicleBinaryFile->Import(fileName.c_str(), true);
+	QubicleBinary* pQubicleBinaryFile = CubbyGame::GetInstance()->GetQubicleBinaryManager()->GetQubicleBinaryFile(fileName.c_str(), false, true);
 
 	return AddSceneryObject(name, fileName, pos, worldFileOffset, importDirection, parentImportDirection, pQubicleBinaryFile, static_cast<float>(pQubicleBinaryFile->GetQubicleMatrix(0)->m_matrixSizeX), static_cast<float>(pQubicleBinaryFile->GetQubicleMatrix(0)->m_matrixSizeY), static_cast<float>(pQubicleBinaryFile->GetQubicleMatrix(0)->m_matrixSizeZ), scale, rotation);
 }
@@ -95,7 +98,8 @@ SceneryObject* SceneryManager::AddSceneryObject(std::string name, std::string fi
 	pNewSceneryObject->m_scale = scale;
 	pNewSceneryObject->m_rotation = rotation;
 
-	pNewSceneryObject->m_radius = 1.0f;
+	// Bounding sphere around the object origin, which sits at the base of the model
+	pNewSceneryObject->m_radius = glm::length(glm::vec3(length * 0.5f, height, width * 0.5f)) * scale;
 
 	pNewSceneryObject->m_canSelect = true;
 	pNewSceneryObject->m_outlineRender = false;
@@ -130,6 +134,8 @@ void SceneryManager::DeleteSceneryObject(std::string name)
 	// Delete
 	if (pDeleteObject != nullptr)
 	{
+		CubbyGame::GetInstance()->GetQubicleBinaryManager()->ReleaseQubicleBinaryFile(pDeleteObject->m_pQubicleBinaryFile);
+
 		delete pDeleteObject;
 	}
 }
@@ -214,8 +220,19 @@ void SceneryManager::Render(bool reflection, bool silhouette, bool shadow, bool
 			continue;
 		}
 
+		glm::vec3 pos = pSceneryObject->m_worldFileOffset + pSceneryObject->m_positionOffset;
+
+		if (shadow == false && reflection == false && m_pRenderer->SphereInFrustum(CubbyGame::GetInstance()->GetDefaultViewport(), pos, pSceneryObject->m_radius) == false)
+		{
+			continue;
+		}
+
+		// Level of detail
+		float toCamera = length(CubbyGame::GetInstance()->GetGameCamera()->GetPosition() - pos);
+		int lodLevel = QubicleBinary::CalculateLODLevel(toCamera, pSceneryObject->m_radius, CubbyGame::GetInstance()->GetCubbySettings()->m_lodBias);
+
 		bool renderBounding = false;
-		RenderSceneryObject(pSceneryObject, false, reflection, silhouette, renderBounding, shadow);
+		RenderSceneryObject(pSceneryObject, false, reflection, silhouette, renderBounding, shadow, lodLevel);
 
 		m_numRenderScenery++;
 	}
@@ -242,7 +259,7 @@ void SceneryManager::RenderDebug()
 	}
 }
 
-void SceneryManager::RenderSceneryObject(SceneryObject* pSceneryObject, bool outline, bool reflection, bool silhouette, bool boundingBox, bool shadow) const
+void SceneryManager::RenderSceneryObject(SceneryObject* pSceneryObject, bool outline, bool reflection, bool silhouette, bool boundingBox, bool shadow, int lodLevel) const
 {
 	m_pRenderer->PushMatrix();
 
@@ -321,7 +338,7 @@ void SceneryManager::RenderSceneryObject(SceneryObject* pSceneryObject, bool out
 
 	m_pRenderer->ImmediateColorAlpha(1.0f, 1.0f, 1.0f, 1.0f);
 
-	pSceneryObject->m_pQubicleBinaryFile->Render(outline, reflection, silhouette, outlineColor);
+	pSceneryObject->m_pQubicleBinaryFile->Render(outline, reflection, silhouette, outlineColor, lodLevel);
 
 	if (boundingBox)
 	{
@@ -387,6 +404,6 @@ void SceneryManager::RenderOutlineScenery()
 			continue;
 		}
 
-		RenderSceneryObject(pSceneryObject, true, false, false, false, false);
+		RenderSceneryObject(pSceneryObject, true, false, false, false, false, 0);
 	}
 }
\ No newline at end of file
@@ -73,7 +73,7 @@ public:
 	// Rendering
 	void Render(bool reflection, bool silhouette, bool shadow, bool renderOnlyOutline, bool renderOnlyNormal);
 	void RenderDebug();
-	void RenderSceneryObject(SceneryObject* pSceneryObject, bool outline, bool reflection, bool silhouette, bool boundingBox, bool shadow) const;
+	void RenderSceneryObject(SceneryObject* pSceneryObject, bool outline, bool reflection, bool silhouette, bool boundingBox, bool shadow, int lodLevel) const;
 	void RenderOutlineScenery();
 
 private:
@@ -7,6 +7,8 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <algorithm>
+
 #include <Utils/Random.h>
 #include <Utils/Interpolator.h>
 
@@ -14,7 +16,7 @@
 
 // Constructor, Destructor
 TextEffectsManager::TextEffectsManager(Renderer* pRenderer) :
-	m_pRenderer(pRenderer), m_pCamera(nullptr)
+	m_pRenderer(pRenderer), m_pCamera(nullptr), m_isBatching(true)
 {
 
 }
@@ -41,6 +43,16 @@ void TextEffectsManager::SetCamera(Camera* pCamera)
 	m_pCamera = pCamera;
 }
 
+void TextEffectsManager::SetBatching(bool isBatching)
+{
+	m_isBatching = isBatching;
+}
+
+bool TextEffectsManager::IsBatching() const
+{
+	return m_isBatching;
+}
+
 AnimatedText* TextEffectsManager::CreateTextEffect(unsigned int fontID, unsigned int outlineFontID, unsigned int viewportID, TextDrawMode drawMode, TextEffect effect, TextDrawStyle drawStyle, glm::vec3 position, Color color, Color outlineColor, const std::string& text, float lifeTime)
 {
 	AnimatedText* pEffect = new AnimatedText();
@@ -208,11 +220,12 @@ void TextEffectsManager::Update(float deltaTime)
 
 void TextEffectsManager::Render()
 {
-	m_pRenderer->PushMatrix();
-
-	// Render all effects
 	m_animatedTextMutexLock.lock();
 
+	// Work out where every text goes before drawing any of them, so they can all be drawn in one 2D pass
+	m_vpRenderTextList.clear();
+	m_vRenderPositions.clear();
+
 	for (auto iter = m_vpAnimatedTextList.begin(); iter != m_vpAnimatedTextList.end(); ++iter)
 	{
 		AnimatedText* pAnimatedText = *iter;
@@ -223,56 +236,138 @@ void TextEffectsManager::Render()
 			continue;
 		}
 
-		glm::vec3 pTextPosition;
-		if (pAnimatedText->m_drawMode == TextDrawMode::Screen2D)
-		{
-			pTextPosition = pAnimatedText->m_position;
-		}
-		else if (pAnimatedText->m_drawMode == TextDrawMode::Screen3D)
+		if (pAnimatedText->m_drawMode == TextDrawMode::Screen3D)
 		{
 			if (m_pRenderer->PointInFrustum(pAnimatedText->m_viewportID, pAnimatedText->m_position) == false)
 			{
 				continue;
 			}
+		}
 
-			m_pRenderer->PushMatrix();
+		m_vpRenderTextList.push_back(pAnimatedText);
+		m_vRenderPositions.push_back(pAnimatedText->m_position);
+	}
 
-			m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, pAnimatedText->m_viewportID);
-			m_pCamera->Look();
+	ProjectScreen3DPositions();
 
-			int winX, winY;
-			m_pRenderer->GetScreenCoordinatesFromWorldPosition(pAnimatedText->m_position, &winX, &winY);
+	m_pRenderer->PushMatrix();
 
-			m_pRenderer->PopMatrix();
+	if (m_isBatching)
+	{
+		m_pRenderer->BeginSpriteBatch();
+	}
 
-			pTextPosition = glm::vec3(static_cast<float>(winX) - pAnimatedText->GetTextWidth() / 2, static_cast<float>(winY), 0.0f);
-		}
-		else if (pAnimatedText->m_drawMode == TextDrawMode::World3D)
+	// The 2D projection is only set up again when the viewport changes
+	int viewportID = -1;
+
+	for (size_t i = 0; i < m_vpRenderTextList.size(); ++i)
+	{
+		AnimatedText* pAnimatedText = m_vpRenderTextList[i];
+		glm::vec3 textPosition = m_vRenderPositions[i];
+
+		bool isWorld3D = pAnimatedText->m_drawMode == TextDrawMode::World3D;
+		if (isWorld3D || static_cast<int>(pAnimatedText->m_viewportID) != viewportID)
 		{
-			m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, pAnimatedText->m_viewportID);
-			m_pCamera->Look();
+			if (viewportID != -1)
+			{
+				m_pRenderer->PopMatrix();
+				viewportID = -1;
+			}
 
-			pTextPosition = pAnimatedText->m_position;
-		}
+			m_pRenderer->PushMatrix();
 
-		m_pRenderer->PushMatrix();
-		
-		m_pRenderer->SetRenderMode(RenderMode::SOLID);
-		m_pRenderer->SetProjectionMode(ProjectionMode::TWO_DIMENSION, pAnimatedText->m_viewportID);
-		m_pRenderer->SetLookAtCamera(glm::vec3(0.0f, 0.0f, 250.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			if (isWorld3D)
+			{
+				m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, pAnimatedText->m_viewportID);
+				m_pCamera->Look();
+			}
+
+			m_pRenderer->SetRenderMode(RenderMode::SOLID);
+			m_pRenderer->SetProjectionMode(ProjectionMode::TWO_DIMENSION, pAnimatedText->m_viewportID);
+			m_pRenderer->SetLookAtCamera(glm::vec3(0.0f, 0.0f, 250.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+			viewportID = pAnimatedText->m_viewportID;
+		}
 
 		// Draw styles
-		m_pRenderer->RenderFreeTypeText(pAnimatedText->m_fontID, pTextPosition.x, pTextPosition.y, 0.0f, pAnimatedText->m_color, pAnimatedText->m_scale, "%s", pAnimatedText->GetText().c_str());
+		m_pRenderer->RenderFreeTypeString(pAnimatedText->m_fontID, textPosition.x, textPosition.y, 0.0f, pAnimatedText->m_color, pAnimatedText->m_scale, pAnimatedText->GetText().c_str());
 
 		if (pAnimatedText->m_drawStyle == TextDrawStyle::Outline)
 		{
-			m_pRenderer->RenderFreeTypeText(pAnimatedText->m_outlineFontID, pTextPosition.x, pTextPosition.y, 0.0f, pAnimatedText->m_outlineColor, pAnimatedText->m_scale, "%s", pAnimatedText->GetText().c_str());
+			m_pRenderer->RenderFreeTypeString(pAnimatedText->m_outlineFontID, textPosition.x, textPosition.y, 0.0f, pAnimatedText->m_outlineColor, pAnimatedText->m_scale, pAnimatedText->GetText().c_str());
+		}
+
+		if (isWorld3D)
+		{
+			// World text has the camera in its matrix, so the next text starts again
+			m_pRenderer->PopMatrix();
+			viewportID = -1;
 		}
+	}
 
+	if (m_isBatching)
+	{
+		m_pRenderer->EndSpriteBatch();
+	}
+
+	if (viewportID != -1)
+	{
 		m_pRenderer->PopMatrix();
 	}
 
 	m_animatedTextMutexLock.unlock();
 
 	m_pRenderer->PopMatrix();
-}
\ No newline at end of file
+}
+
+void TextEffectsManager::ProjectScreen3DPositions()
+{
+	// Screen3D texts are projected a viewport at a time, with the camera set up once for all of them
+	std::vector<unsigned int> projectedViewports;
+
+	for (size_t i = 0; i < m_vpRenderTextList.size(); ++i)
+	{
+		AnimatedText* pAnimatedText = m_vpRenderTextList[i];
+		if (pAnimatedText->m_drawMode != TextDrawMode::Screen3D)
+		{
+			continue;
+		}
+
+		unsigned int viewportID = pAnimatedText->m_viewportID;
+		if (std::find(projectedViewports.begin(), projectedViewports.end(), viewportID) != projectedViewports.end())
+		{
+			continue;
+		}
+		projectedViewports.push_back(viewportID);
+
+		m_vProjectPositions.clear();
+		m_vProjectIndices.clear();
+		for (size_t j = i; j < m_vpRenderTextList.size(); ++j)
+		{
+			if (m_vpRenderTextList[j]->m_drawMode == TextDrawMode::Screen3D && m_vpRenderTextList[j]->m_viewportID == viewportID)
+			{
+				m_vProjectPositions.push_back(m_vRenderPositions[j]);
+				m_vProjectIndices.push_back(static_cast<int>(j));
+			}
+		}
+
+		int numPositions = static_cast<int>(m_vProjectPositions.size());
+		m_vProjectX.resize(numPositions);
+		m_vProjectY.resize(numPositions);
+
+		m_pRenderer->PushMatrix();
+
+		m_pRenderer->SetProjectionMode(ProjectionMode::PERSPECTIVE, viewportID);
+		m_pCamera->Look();
+
+		m_pRenderer->GetScreenCoordinatesFromWorldPositions(&m_vProjectPositions[0], numPositions, &m_vProjectX[0], &m_vProjectY[0]);
+
+		m_pRenderer->PopMatrix();
+
+		for (int j = 0; j < numPositions; ++j)
+		{
+			int index = m_vProjectIndices[j];
+			m_vRenderPositions[index] = glm::vec3(static_cast<float>(m_vProjectX[j]) - m_vpRenderTextList[index]->GetTextWidth() / 2, static_cast<float>(m_vProjectY[j]), 0.0f);
+		}
+	}
+}
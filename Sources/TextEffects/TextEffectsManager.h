@@ -28,17 +28,33 @@ public:
 
 	void SetCamera(Camera* pCamera);
 
+	// When batching, all of the text is drawn together from the glyph atlas instead of one draw per string
+	void SetBatching(bool isBatching);
+	bool IsBatching() const;
+
 	AnimatedText* CreateTextEffect(unsigned int fontID, unsigned int outlineFontID, unsigned int viewportID, TextDrawMode drawMode, TextEffect effect, TextDrawStyle drawStyle, glm::vec3 position, Color color, Color outlineColor, const std::string& text, float lifeTime);
 
 	void Update(float deltaTime);
 	void Render();
 
 private:
+	void ProjectScreen3DPositions();
+
 	Renderer* m_pRenderer;
 	Camera* m_pCamera;
 
 	tthread::mutex m_animatedTextMutexLock;
 	AnimatedTextList m_vpAnimatedTextList;
+
+	bool m_isBatching;
+
+	// The texts being drawn this frame and where they go, kept between frames to save allocating them again
+	AnimatedTextList m_vpRenderTextList;
+	std::vector<glm::vec3> m_vRenderPositions;
+	std::vector<glm::vec3> m_vProjectPositions;
+	std::vector<int> m_vProjectIndices;
+	std::vector<int> m_vProjectX;
+	std::vector<int> m_vProjectY;
 };
 
 
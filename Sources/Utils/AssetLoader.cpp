@@ -0,0 +1,241 @@
+/*************************************************************************
+> File Name: AssetLoader.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Loads assets in the background. Files are parsed and meshed on the
+> 	 loader threads, then handed back to the main thread, which publishes
+> 	 a limited amount of them every frame.
+> Created Time: 2016/09/11
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+
+#include "AssetLoader.h"
+#include "PerformanceTimer.h"
+
+// Initialize the singleton instance
+AssetLoader* AssetLoader::m_instance = nullptr;
+
+AssetLoader* AssetLoader::GetInstance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new AssetLoader;
+	}
+
+	return m_instance;
+}
+
+void AssetLoader::Destroy()
+{
+	if (m_instance)
+	{
+		// Loader threads finish the asset they are working on, anything still queued is dropped
+		m_loadMutex.lock();
+		m_isRunning = false;
+		m_loadQueue.clear();
+		m_loadCondition.notify_all();
+		m_loadMutex.unlock();
+
+		for (size_t i = 0; i < m_vpLoaderThreads.size(); ++i)
+		{
+			m_vpLoaderThreads[i]->join();
+			delete m_vpLoaderThreads[i];
+			m_vpLoaderThreads[i] = nullptr;
+		}
+		m_vpLoaderThreads.clear();
+
+		m_uploadQueue.clear();
+
+		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+AssetLoader::AssetLoader() :
+	m_isRunning(true), m_numUploadsLastFrame(0), m_mainThreadID(tthread::this_thread::get_id())
+{
+	for (int i = 0; i < NUM_LOADER_THREADS; ++i)
+	{
+		m_vpLoaderThreads.push_back(new tthread::thread(_LoaderThread, this));
+	}
+}
+
+void AssetLoader::QueueLoad(void* pAsset, AssetLoadFunction loadFunction, AssetUploadFunction uploadFunction)
+{
+	AssetLoadJob job;
+	job.m_pAsset = pAsset;
+	job.m_loadFunction = loadFunction;
+	job.m_uploadFunction = uploadFunction;
+	job.m_isLoaded = false;
+
+	m_loadMutex.lock();
+	m_loadQueue.push_back(job);
+	m_loadCondition.notify_one();
+	m_loadMutex.unlock();
+}
+
+void AssetLoader::WaitForAsset(void* pAsset)
+{
+	m_loadMutex.lock();
+
+	auto loadIter = std::find_if(m_loadQueue.begin(), m_loadQueue.end(), [pAsset](const AssetLoadJob& job) { return job.m_pAsset == pAsset; });
+	if (loadIter != m_loadQueue.end())
+	{
+		// Nobody has started on it yet, so it is quicker to load it here than to wait for a loader thread. It is marked as
+		// loading like on a loader thread, so anyone else waiting for it waits for us.
+		AssetLoadJob job = *loadIter;
+		m_loadQueue.erase(loadIter);
+		m_vpLoadingAssets.push_back(job.m_pAsset);
+		m_loadMutex.unlock();
+
+		job.m_isLoaded = job.m_loadFunction(job.m_pAsset);
+
+		m_loadMutex.lock();
+		m_vpLoadingAssets.erase(std::find(m_vpLoadingAssets.begin(), m_vpLoadingAssets.end(), job.m_pAsset));
+		m_uploadQueue.push_back(job);
+		m_loadFinishedCondition.notify_all();
+	}
+
+	while (IsAssetLoading(pAsset))
+	{
+		m_loadFinishedCondition.wait(m_loadMutex);
+	}
+
+	// The upload may use the GL context, so other threads only wait for the load and the main thread uploads it later
+	if (IsMainThread() == false)
+	{
+		m_loadMutex.unlock();
+		return;
+	}
+
+	auto uploadIter = std::find_if(m_uploadQueue.begin(), m_uploadQueue.end(), [pAsset](const AssetLoadJob& job) { return job.m_pAsset == pAsset; });
+	if (uploadIter == m_uploadQueue.end())
+	{
+		// Not queued, or already uploaded
+		m_loadMutex.unlock();
+		return;
+	}
+
+	AssetLoadJob job = *uploadIter;
+	m_uploadQueue.erase(uploadIter);
+	m_loadMutex.unlock();
+
+	job.m_uploadFunction(job.m_pAsset, job.m_isLoaded);
+}
+
+void AssetLoader::ProcessUploads(float maxUploadTime)
+{
+	PerformanceTimer timer;
+
+	m_numUploadsLastFrame = 0;
+
+	while (m_numUploadsLastFrame == 0 || timer.GetElapsedTime() < maxUploadTime)
+	{
+		m_loadMutex.lock();
+		if (m_uploadQueue.empty())
+		{
+			m_loadMutex.unlock();
+			break;
+		}
+
+		AssetLoadJob job = m_uploadQueue.front();
+		m_uploadQueue.pop_front();
+		m_loadMutex.unlock();
+
+		job.m_uploadFunction(job.m_pAsset, job.m_isLoaded);
+
+		m_numUploadsLastFrame++;
+	}
+}
+
+void AssetLoader::Flush()
+{
+	m_loadMutex.lock();
+	while (m_loadQueue.empty() == false || m_vpLoadingAssets.empty() == false)
+	{
+		m_loadFinishedCondition.wait(m_loadMutex);
+	}
+
+	std::deque<AssetLoadJob> uploadQueue;
+	uploadQueue.swap(m_uploadQueue);
+	m_loadMutex.unlock();
+
+	for (size_t i = 0; i < uploadQueue.size(); ++i)
+	{
+		uploadQueue[i].m_uploadFunction(uploadQueue[i].m_pAsset, uploadQueue[i].m_isLoaded);
+	}
+}
+
+// Statistics
+int AssetLoader::GetNumPendingLoads()
+{
+	m_loadMutex.lock();
+	int numPendingLoads = static_cast<int>(m_loadQueue.size() + m_vpLoadingAssets.size());
+	m_loadMutex.unlock();
+
+	return numPendingLoads;
+}
+
+int AssetLoader::GetNumPendingUploads()
+{
+	m_loadMutex.lock();
+	int numPendingUploads = static_cast<int>(m_uploadQueue.size());
+	m_loadMutex.unlock();
+
+	return numPendingUploads;
+}
+
+int AssetLoader::GetNumUploadsLastFrame() const
+{
+	return m_numUploadsLastFrame;
+}
+
+void AssetLoader::_LoaderThread(void* pData)
+{
+	AssetLoader* pAssetLoader = static_cast<AssetLoader*>(pData);
+	pAssetLoader->LoaderThread();
+}
+
+void AssetLoader::LoaderThread()
+{
+	while (true)
+	{
+		m_loadMutex.lock();
+		while (m_isRunning && m_loadQueue.empty())
+		{
+			m_loadCondition.wait(m_loadMutex);
+		}
+
+		if (m_isRunning == false)
+		{
+			m_loadMutex.unlock();
+			break;
+		}
+
+		AssetLoadJob job = m_loadQueue.front();
+		m_loadQueue.pop_front();
+		m_vpLoadingAssets.push_back(job.m_pAsset);
+		m_loadMutex.unlock();
+
+		job.m_isLoaded = job.m_loadFunction(job.m_pAsset);
+
+		m_loadMutex.lock();
+		m_vpLoadingAssets.erase(std::find(m_vpLoadingAssets.begin(), m_vpLoadingAssets.end(), job.m_pAsset));
+		m_uploadQueue.push_back(job);
+		m_loadFinishedCondition.notify_all();
+		m_loadMutex.unlock();
+	}
+}
+
+bool AssetLoader::IsAssetLoading(void* pAsset) const
+{
+	return std::find(m_vpLoadingAssets.begin(), m_vpLoadingAssets.end(), pAsset) != m_vpLoadingAssets.end();
+}
+
+bool AssetLoader::IsMainThread() const
+{
+	return tthread::this_thread::get_id() == m_mainThreadID;
+}
@@ -0,0 +1,95 @@
+/*************************************************************************
+> File Name: AssetLoader.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 Loads assets in the background. Files are parsed and meshed on the
+> 	 loader threads, then handed back to the main thread, which publishes
+> 	 a limited amount of them every frame.
+> Created Time: 2016/09/11
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_ASSET_LOADER_H
+#define CUBBY_ASSET_LOADER_H
+
+#include <deque>
+#include <vector>
+
+#include <tinythread/tinythread.h>
+
+// Runs on a loader thread and must not use the GPU, returns false if the asset failed to load
+using AssetLoadFunction = bool(*)(void* pAsset);
+// Always runs on the main thread, once the load function has finished
+using AssetUploadFunction = void(*)(void* pAsset, bool isLoaded);
+
+struct AssetLoadJob
+{
+	void* m_pAsset;
+	AssetLoadFunction m_loadFunction;
+	AssetUploadFunction m_uploadFunction;
+	bool m_isLoaded;
+};
+
+class AssetLoader
+{
+public:
+	static AssetLoader* GetInstance();
+	void Destroy();
+
+	// Queues an asset, pAsset is the handle the caller uses to wait for it
+	void QueueLoad(void* pAsset, AssetLoadFunction loadFunction, AssetUploadFunction uploadFunction);
+
+	// Blocks until the asset is loaded, loading it on the calling thread if no loader thread has started on it yet.
+	// The main thread also uploads it, any other thread leaves the upload queued for the main thread.
+	void WaitForAsset(void* pAsset);
+
+	// Main thread only. Uploads finished assets, stopping once maxUploadTime milliseconds have been used. At least one
+	// asset is uploaded per call. The renderer draws meshes from client side vertex arrays, so FinishMesh() is the
+	// whole cost of making a mesh drawable and there is no separate GL transfer for the budget to miss.
+	void ProcessUploads(float maxUploadTime);
+
+	// Main thread only. Blocks until every queued asset has been loaded and uploaded
+	void Flush();
+
+	// Statistics
+	int GetNumPendingLoads();
+	int GetNumPendingUploads();
+	int GetNumUploadsLastFrame() const;
+
+private:
+	AssetLoader();
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader(AssetLoader&&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+	AssetLoader& operator=(AssetLoader&&) = delete;
+
+	static void _LoaderThread(void* pData);
+	void LoaderThread();
+
+	bool IsAssetLoading(void* pAsset) const;
+	bool IsMainThread() const;
+
+	static const int NUM_LOADER_THREADS = 2;
+
+	std::vector<tthread::thread*> m_vpLoaderThreads;
+	tthread::mutex m_loadMutex;
+	tthread::condition_variable m_loadCondition;
+	tthread::condition_variable m_loadFinishedCondition;
+	bool m_isRunning;
+
+	// Waiting for a loader thread, being loaded and waiting for the main thread to upload
+	std::deque<AssetLoadJob> m_loadQueue;
+	std::vector<void*> m_vpLoadingAssets;
+	std::deque<AssetLoadJob> m_uploadQueue;
+
+	int m_numUploadsLastFrame;
+
+	// The loader is created by the main thread at startup, and only that thread runs the upload functions
+	tthread::thread::id m_mainThreadID;
+
+	// Singleton instance
+	static AssetLoader* m_instance;
+};
+
+#endif
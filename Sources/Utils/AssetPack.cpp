@@ -0,0 +1,346 @@
+/*************************************************************************
+> File Name: AssetPack.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A single indexed file holding the whole gamedata tree, baked offline
+> 	 with "Cubby -bakepack". Files are read out of the pack when it has
+> 	 them and from the loose files otherwise, or when the loose file was
+> 	 edited after the pack was baked, so mods and edits keep working.
+> Created Time: 2016/09/12
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "AssetPack.h"
+#include "FileUtils.h"
+
+static const char PACK_MAGIC[4] = { 'C', 'B', 'P', 'K' };
+static const unsigned int PACK_ALIGNMENT = 16;
+
+// Initialize the singleton instance
+AssetPack* AssetPack::m_instance = nullptr;
+
+AssetPack* AssetPack::GetInstance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new AssetPack;
+	}
+
+	return m_instance;
+}
+
+void AssetPack::Destroy()
+{
+	if (m_instance)
+	{
+		Close();
+
+		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+AssetPack::AssetPack() :
+	m_pPackFile(nullptr), m_packModifiedTime(0), m_numPackReads(0), m_numLooseReads(0)
+{
+}
+
+static bool ReadWholeFile(const char* fileName, std::vector<unsigned char>* pData)
+{
+	FILE* pFile = nullptr;
+	fopen_s(&pFile, fileName, "rb");
+
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	pData->resize(fileSize > 0 ? fileSize : 0);
+	bool isRead = fileSize <= 0 || fread(&(*pData)[0], fileSize, 1, pFile) == 1;
+
+	fclose(pFile);
+
+	return isRead;
+}
+
+bool AssetPack::Bake(const char* directoryName, const char* packFileName)
+{
+	std::vector<std::string> fileNames = ListFilesInDirectoryRecursive(directoryName, "");
+	std::sort(fileNames.begin(), fileNames.end());
+
+	// Work out where each file's data goes, after the header and index
+	unsigned int indexSize = sizeof(PACK_MAGIC) + sizeof(unsigned int) * 2;
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		indexSize += sizeof(unsigned int) * 3 + static_cast<unsigned int>(fileNames[i].length());
+	}
+
+	std::vector<AssetPackEntry> entries;
+	std::vector<std::vector<unsigned char>> fileDatas;
+	unsigned int dataOffset = (indexSize + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		std::vector<unsigned char> fileData;
+		if (ReadWholeFile(fileNames[i].c_str(), &fileData) == false)
+		{
+			std::cout << "AssetPack::Bake() can't read '" << fileNames[i] << "'\n";
+			return false;
+		}
+
+		AssetPackEntry entry;
+		entry.m_offset = dataOffset;
+		entry.m_size = static_cast<unsigned int>(fileData.size());
+
+		dataOffset = (dataOffset + entry.m_size + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+
+		entries.push_back(entry);
+		fileDatas.push_back(fileData);
+	}
+
+	FILE* pPackFile = nullptr;
+	fopen_s(&pPackFile, packFileName, "wb");
+
+	if (pPackFile == nullptr)
+	{
+		std::cout << "AssetPack::Bake() can't write '" << packFileName << "'\n";
+		return false;
+	}
+
+	unsigned int version = PACK_VERSION;
+	unsigned int numFiles = static_cast<unsigned int>(fileNames.size());
+
+	fwrite(PACK_MAGIC, sizeof(PACK_MAGIC), 1, pPackFile);
+	fwrite(&version, sizeof(unsigned int), 1, pPackFile);
+	fwrite(&numFiles, sizeof(unsigned int), 1, pPackFile);
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		unsigned int pathLength = static_cast<unsigned int>(fileNames[i].length());
+
+		fwrite(&pathLength, sizeof(unsigned int), 1, pPackFile);
+		fwrite(fileNames[i].c_str(), pathLength, 1, pPackFile);
+		fwrite(&entries[i].m_offset, sizeof(unsigned int), 1, pPackFile);
+		fwrite(&entries[i].m_size, sizeof(unsigned int), 1, pPackFile);
+	}
+
+	const unsigned char padding[PACK_ALIGNMENT] = { 0 };
+	long position = ftell(pPackFile);
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		fwrite(padding, entries[i].m_offset - position, 1, pPackFile);
+
+		if (entries[i].m_size > 0)
+		{
+			fwrite(&fileDatas[i][0], entries[i].m_size, 1, pPackFile);
+		}
+
+		position = entries[i].m_offset + entries[i].m_size;
+	}
+
+	fclose(pPackFile);
+
+	std::cout << "Baked " << numFiles << " files into '" << packFileName << "', " << position << " bytes\n";
+
+	return true;
+}
+
+bool AssetPack::Open(const char* packFileName)
+{
+	Close();
+
+	fopen_s(&m_pPackFile, packFileName, "rb");
+
+	if (m_pPackFile == nullptr || GetFileModifiedTime(packFileName, &m_packModifiedTime) == false)
+	{
+		Close();
+		return false;
+	}
+
+	fseek(m_pPackFile, 0, SEEK_END);
+	long packFileSize = ftell(m_pPackFile);
+	fseek(m_pPackFile, 0, SEEK_SET);
+
+	size_t packSize = packFileSize > 0 ? static_cast<size_t>(packFileSize) : 0;
+
+	char magic[sizeof(PACK_MAGIC)];
+	unsigned int version = 0;
+	unsigned int numFiles = 0;
+
+	if (fread(magic, sizeof(magic), 1, m_pPackFile) != 1 || memcmp(magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 ||
+		fread(&version, sizeof(unsigned int), 1, m_pPackFile) != 1 || fread(&numFiles, sizeof(unsigned int), 1, m_pPackFile) != 1)
+	{
+		std::cout << "'" << packFileName << "' is not an asset pack\n";
+		Close();
+		return false;
+	}
+
+	if (version != PACK_VERSION)
+	{
+		std::cout << "'" << packFileName << "' is version " << version << ", expected " << PACK_VERSION << ", rebake it with -bakepack\n";
+		Close();
+		return false;
+	}
+
+	std::string path;
+
+	for (unsigned int i = 0; i < numFiles; ++i)
+	{
+		unsigned int pathLength = 0;
+		AssetPackEntry entry;
+
+		if (fread(&pathLength, sizeof(unsigned int), 1, m_pPackFile) != 1 || pathLength > packSize)
+		{
+			break;
+		}
+
+		path.resize(pathLength);
+		if (pathLength > 0 && fread(&path[0], pathLength, 1, m_pPackFile) != 1)
+		{
+			break;
+		}
+
+		if (fread(&entry.m_offset, sizeof(unsigned int), 1, m_pPackFile) != 1 || fread(&entry.m_size, sizeof(unsigned int), 1, m_pPackFile) != 1)
+		{
+			break;
+		}
+
+		if (entry.m_offset > packSize || entry.m_size > packSize - entry.m_offset)
+		{
+			break;
+		}
+
+		m_index[path] = entry;
+	}
+
+	if (m_index.size() != numFiles)
+	{
+		std::cout << "'" << packFileName << "' is corrupt, using loose files\n";
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetPack::Close()
+{
+	m_index.clear();
+
+	if (m_pPackFile != nullptr)
+	{
+		fclose(m_pPackFile);
+		m_pPackFile = nullptr;
+	}
+}
+
+bool AssetPack::IsOpen() const
+{
+	return m_pPackFile != nullptr;
+}
+
+bool AssetPack::ReadFileData(const char* fileName, std::vector<unsigned char>* pData) const
+{
+	if (m_index.empty())
+	{
+		return false;
+	}
+
+	auto iter = m_index.find(GetPackPath(fileName));
+
+	if (iter == m_index.end())
+	{
+		return false;
+	}
+
+	// Edited since the pack was baked, the pack's copy is stale
+	time_t looseModifiedTime;
+	if (GetFileModifiedTime(fileName, &looseModifiedTime) && looseModifiedTime > m_packModifiedTime)
+	{
+		return false;
+	}
+
+	pData->resize(iter->second.m_size);
+
+	bool isRead = true;
+
+	if (iter->second.m_size > 0)
+	{
+		m_packFileMutex.lock();
+		isRead = fseek(m_pPackFile, iter->second.m_offset, SEEK_SET) == 0 && fread(&(*pData)[0], iter->second.m_size, 1, m_pPackFile) == 1;
+		m_packFileMutex.unlock();
+	}
+
+	if (isRead == false)
+	{
+		std::cout << "AssetPack::ReadFileData() can't read '" << fileName << "' from the pack\n";
+		pData->clear();
+		return false;
+	}
+
+	m_numPackReads.fetch_add(1);
+
+	return true;
+}
+
+bool AssetPack::OpenFile(const char* fileName, std::istringstream* pStream) const
+{
+	std::vector<unsigned char> packData;
+
+	if (ReadFileData(fileName, &packData))
+	{
+		pStream->str(std::string(packData.begin(), packData.end()));
+		return true;
+	}
+
+	std::ifstream file;
+	file.open(fileName, std::ios::in | std::ios::binary);
+
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	pStream->str(contents.str());
+
+	m_numLooseReads.fetch_add(1);
+
+	return true;
+}
+
+// Statistics
+int AssetPack::GetNumFiles() const
+{
+	return static_cast<int>(m_index.size());
+}
+
+int AssetPack::GetNumPackReads() const
+{
+	return m_numPackReads.load();
+}
+
+int AssetPack::GetNumLooseReads() const
+{
+	return m_numLooseReads.load();
+}
+
+std::string AssetPack::GetPackPath(const char* fileName)
+{
+	std::string packPath = fileName;
+	std::replace(packPath.begin(), packPath.end(), '\\', '/');
+
+	return packPath;
+}
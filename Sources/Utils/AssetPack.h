@@ -0,0 +1,93 @@
+/*************************************************************************
+> File Name: AssetPack.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A single indexed file holding the whole gamedata tree, baked offline
+> 	 with "Cubby -bakepack". Files are read out of the pack when it has
+> 	 them and from the loose files otherwise, or when the loose file was
+> 	 edited after the pack was baked, so mods and edits keep working.
+> Created Time: 2016/09/12
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_ASSET_PACK_H
+#define CUBBY_ASSET_PACK_H
+
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tinythread/tinythread.h>
+
+// Pack layout, all values little endian:
+//   "CBPK", version, number of files
+//   per file: path length, path, data offset, data size
+//   file data, each file starting on a 16 byte boundary
+struct AssetPackEntry
+{
+	unsigned int m_offset;
+	unsigned int m_size;
+};
+
+using AssetPackIndex = std::unordered_map<std::string, AssetPackEntry>;
+
+class AssetPack
+{
+public:
+	static AssetPack* GetInstance();
+	void Destroy();
+
+	// Offline bake of every file under directoryName
+	static bool Bake(const char* directoryName, const char* packFileName);
+
+	bool Open(const char* packFileName);
+	void Close();
+	bool IsOpen() const;
+
+	// Reads a packed file into pData, only that file's bytes are read from the pack. Returns false if the file is not in the pack,
+	// or the loose file is newer than the pack, so the caller reads the loose file instead.
+	bool ReadFileData(const char* fileName, std::vector<unsigned char>* pData) const;
+
+	// Stream over a file's contents, from the pack or the loose file, used by the text formats
+	bool OpenFile(const char* fileName, std::istringstream* pStream) const;
+
+	// Statistics
+	int GetNumFiles() const;
+	int GetNumPackReads() const;
+	int GetNumLooseReads() const;
+
+	static const unsigned int PACK_VERSION = 1;
+
+private:
+	AssetPack();
+	AssetPack(const AssetPack&) = delete;
+	AssetPack(AssetPack&&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+	AssetPack& operator=(AssetPack&&) = delete;
+
+	static std::string GetPackPath(const char* fileName);
+
+	// Only the index is kept in memory, the pack stays open and each file is read out of it when asked for
+	FILE* m_pPackFile;
+	AssetPackIndex m_index;
+
+	// When the pack was baked, loose files written since then are used instead of the packed ones
+	time_t m_packModifiedTime;
+
+	// The loader threads read at the same time, the seek and read go together
+	mutable tthread::mutex m_packFileMutex;
+
+	// Counted by the loader threads as they read, so they are atomic
+	mutable std::atomic<int> m_numPackReads;
+	mutable std::atomic<int> m_numLooseReads;
+
+	// Singleton instance
+	static AssetPack* m_instance;
+};
+
+#endif
@@ -13,124 +13,167 @@
 #include "TimeManager.h"
 #include "CountdownTimer.h"
 
-// Constructor, Destructor
-CountdownTimer::CountdownTimer()
+// The elapsed time only moves on while the countdown is running
+static float GetCountdownElapsedTime(const CountdownTimerState* pState)
 {
-	TimeManager::GetInstance()->AddCountdownTimer(this);
-
-	m_elapsedTime = 0.0f;
-	m_timeOutTime = 0.0f;
-
-	m_callback = nullptr;
-	m_pCallbackData = nullptr;
-
-	m_started = false;
+	if (pState->m_started && pState->m_paused == false)
+	{
+		return static_cast<float>(TimeManager::GetInstance()->GetTime() - pState->m_startTime);
+	}
 
-	m_paused = true;
+	return pState->m_elapsedTime;
+}
 
-	m_finished = false;
+// Constructor, Destructor
+CountdownTimer::CountdownTimer()
+{
+	m_handle = TimeManager::GetInstance()->CreateCountdownTimer();
 }
 
 CountdownTimer::~CountdownTimer()
 {
-	//TimeManager::GetInstance()->RemoveCountdownTimer(this);
+	TimeManager::GetInstance()->DestroyCountdownTimer(m_handle);
 }
 
 void CountdownTimer::SetCallBackFunction(std::function<void(void*)> func)
 {
-	m_callback = func;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return;
+	}
+
+	pState->m_callback = func;
 }
 
 void CountdownTimer::SetCallBackData(void* pData)
 {
-	m_pCallbackData = pData;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return;
+	}
+
+	pState->m_pCallbackData = pData;
 }
 
 void CountdownTimer::StartCountdown()
 {
-	m_elapsedTime = 0.0f;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return;
+	}
+
+	pState->m_elapsedTime = 0.0f;
+	pState->m_startTime = TimeManager::GetInstance()->GetTime();
+
+	pState->m_paused = false;
 
-	m_paused = false;
+	pState->m_finished = false;
 
-	m_finished = false;
+	pState->m_started = true;
 
-	m_started = true;
+	TimeManager::GetInstance()->RescheduleCountdownTimer(m_handle);
 }
 
 void CountdownTimer::ResetCountdown()
 {
-	m_elapsedTime = 0.0f;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return;
+	}
+
+	pState->m_elapsedTime = 0.0f;
+	pState->m_startTime = TimeManager::GetInstance()->GetTime();
 
-	m_finished = false;
+	pState->m_finished = false;
+
+	TimeManager::GetInstance()->RescheduleCountdownTimer(m_handle);
 }
 
 void CountdownTimer::PauseCountdown()
 {
-	m_paused = true;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr || pState->m_paused)
+	{
+		return;
+	}
+
+	pState->m_elapsedTime = GetCountdownElapsedTime(pState);
+	pState->m_paused = true;
+
+	TimeManager::GetInstance()->RescheduleCountdownTimer(m_handle);
 }
 
 void CountdownTimer::ResumeCountdown()
 {
-	m_paused = false;
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr || pState->m_paused == false)
+	{
+		return;
+	}
+
+	pState->m_startTime = TimeManager::GetInstance()->GetTime() - pState->m_elapsedTime;
+	pState->m_paused = false;
+
+	TimeManager::GetInstance()->RescheduleCountdownTimer(m_handle);
 }
 
 bool CountdownTimer::IsPaused() const
 {
-	return m_paused;
+	const CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return true;
+	}
+
+	return pState->m_paused;
 }
 
 float CountdownTimer::GetElapsedTime() const
 {
-	return m_elapsedTime;
+	const CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return 0.0f;
+	}
+
+	return GetCountdownElapsedTime(pState);
 }
 
 float CountdownTimer::GetRemainingTime() const
 {
-	return m_timeOutTime - m_elapsedTime;
+	const CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return 0.0f;
+	}
+
+	return pState->m_timeOutTime - GetCountdownElapsedTime(pState);
 }
 
 void CountdownTimer::SetCountdownTime(float timeOut)
 {
-	m_timeOutTime = timeOut;
-}
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
+	{
+		return;
+	}
 
-void CountdownTimer::SetLooping(bool loop)
-{
-	m_looping = loop;
+	pState->m_timeOutTime = timeOut;
+
+	TimeManager::GetInstance()->RescheduleCountdownTimer(m_handle);
 }
 
-void CountdownTimer::UpdateCountdown(float dt)
+void CountdownTimer::SetLooping(bool loop)
 {
-	if (!m_started)
+	CountdownTimerState* pState = TimeManager::GetInstance()->GetCountdownTimer(m_handle);
+	if (pState == nullptr)
 	{
 		return;
 	}
 
-	if (!m_paused)
-	{
-		m_elapsedTime += dt;
-	}
-
-	if (m_elapsedTime >= m_timeOutTime)
-	{
-		if (!m_finished)
-		{
-			// We have reached our countdown time, call our function callback
-			if (m_callback)
-			{
-				m_callback(m_pCallbackData);
-			}
-
-			if (m_looping)
-			{
-				// If we are a looping timer, then just reset the elapsed time
-				m_elapsedTime = 0.0f;
-			}
-			else
-			{
-				// We are not looping, so set our finished flag
-				m_finished = true;
-			}
-		}
-	}
-}
+	pState->m_looping = loop;
+}
\ No newline at end of file
@@ -15,6 +15,16 @@
 
 #include <functional>
 
+// A timer in the time manager's pool. The generation changes when the timer is destroyed, so an old handle finds nothing.
+struct CountdownTimerHandle
+{
+	CountdownTimerHandle() : m_index(-1), m_generation(0) {}
+
+	int m_index;
+	unsigned int m_generation;
+};
+
+// Owns a timer in the time manager, which keeps its state and only calls it back when it is due
 class CountdownTimer
 {
 public:
@@ -39,20 +49,11 @@ public:
 
 	void SetLooping(bool loop);
 
-	void UpdateCountdown(float dt);
-
 private:
-	float m_elapsedTime;
-
-	float m_timeOutTime;
-
-	bool m_started;
-	bool m_looping;
-	bool m_paused;
-	bool m_finished;
+	CountdownTimer(const CountdownTimer&) = delete;
+	CountdownTimer& operator=(const CountdownTimer&) = delete;
 
-	std::function<void(void*)> m_callback;
-	void* m_pCallbackData;
+	CountdownTimerHandle m_handle;
 };
 
 #endif
\ No newline at end of file
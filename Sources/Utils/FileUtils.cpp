@@ -7,6 +7,9 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #ifdef _WIN32
 #include <windows.h>
 #elif __linux__
@@ -96,3 +99,84 @@ std::vector<std::string> ListFilesInDirectory(std::string directoryName)
 	return listFileNames;
 #endif //_WIN32
 }
+
+std::vector<std::string> ListFilesInDirectoryRecursive(std::string directoryName, std::string extension)
+{
+	std::vector<std::string> listFileNames;
+	std::vector<std::string> listDirectories;
+	listDirectories.push_back(directoryName);
+
+	while (listDirectories.empty() == false)
+	{
+		std::string directory = listDirectories.back();
+		listDirectories.pop_back();
+
+#ifdef _WIN32
+		WIN32_FIND_DATA findFileData;
+		std::string searchPath = directory + "/*";
+		std::wstring wideStr = std::wstring(searchPath.begin(), searchPath.end());
+		HANDLE hFind = FindFirstFile(wideStr.c_str(), &findFileData);
+
+		if (hFind == INVALID_HANDLE_VALUE)
+		{
+			continue;
+		}
+
+		do
+		{
+			std::string fileName = wchar_tTostring(findFileData.cFileName);
+			bool isDirectory = (findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#elif __linux__
+		DIR* dp;
+		struct dirent* dirp;
+		if ((dp = opendir(directory.c_str())) == nullptr)
+		{
+			continue;
+		}
+
+		while ((dirp = readdir(dp)) != nullptr)
+		{
+			std::string fileName = dirp->d_name;
+			bool isDirectory = dirp->d_type == DT_DIR;
+#endif //_WIN32
+
+			if (fileName == "." || fileName == "..")
+			{
+				continue;
+			}
+
+			if (isDirectory)
+			{
+				listDirectories.push_back(directory + "/" + fileName);
+			}
+			else if (fileName.length() >= extension.length() && fileName.compare(fileName.length() - extension.length(), extension.length(), extension) == 0)
+			{
+				listFileNames.push_back(directory + "/" + fileName);
+			}
+#ifdef _WIN32
+		} while (FindNextFile(hFind, &findFileData));
+
+		FindClose(hFind);
+#elif __linux__
+		}
+
+		closedir(dp);
+#endif //_WIN32
+	}
+
+	return listFileNames;
+}
+
+bool GetFileModifiedTime(const char* fileName, time_t* pModifiedTime)
+{
+	struct stat fileStatus;
+
+	if (stat(fileName, &fileStatus) != 0)
+	{
+		return false;
+	}
+
+	*pModifiedTime = fileStatus.st_mtime;
+
+	return true;
+}
@@ -10,6 +10,7 @@
 #ifndef CUBBY_FILE_UTILS_H
 #define CUBBY_FILE_UTILS_H
 
+#include <ctime>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -26,5 +27,9 @@
 std::string wchar_tTostring(const wchar_t* wchar);
 wchar_t* stringTowchar_t(const std::string& str);
 std::vector<std::string> ListFilesInDirectory(std::string directoryName);
+// Full paths of every file under directoryName, and its sub folders, that ends with extension
+std::vector<std::string> ListFilesInDirectoryRecursive(std::string directoryName, std::string extension);
+// Last time the file was written, false if it doesn't exist
+bool GetFileModifiedTime(const char* fileName, time_t* pModifiedTime);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*************************************************************************
+> File Name: HitchHistogram.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose: Counts the frames that took longer than 33ms, by how long they took.
+> Created Time: 2016/09/11
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_HITCH_HISTOGRAM_H
+#define CUBBY_HITCH_HISTOGRAM_H
+
+class HitchHistogram
+{
+public:
+	static const int NUM_BUCKETS = 4;
+
+	HitchHistogram()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		for (int i = 0; i < NUM_BUCKETS; ++i)
+		{
+			m_bucketCounts[i] = 0;
+		}
+
+		m_numFrames = 0;
+	}
+
+	// Frame time in milliseconds
+	void AddFrame(float frameTime)
+	{
+		m_numFrames++;
+
+		for (int i = NUM_BUCKETS - 1; i >= 0; --i)
+		{
+			if (frameTime > GetBucketStart(i))
+			{
+				m_bucketCounts[i]++;
+				break;
+			}
+		}
+	}
+
+	// Buckets are [33, 50), [50, 100), [100, 250) and 250ms or more
+	static float GetBucketStart(int bucket)
+	{
+		static const float bucketStarts[NUM_BUCKETS] = { 33.0f, 50.0f, 100.0f, 250.0f };
+
+		return bucketStarts[bucket];
+	}
+
+	int GetBucketCount(int bucket) const
+	{
+		return m_bucketCounts[bucket];
+	}
+
+	int GetNumHitches() const
+	{
+		int numHitches = 0;
+
+		for (int i = 0; i < NUM_BUCKETS; ++i)
+		{
+			numHitches += m_bucketCounts[i];
+		}
+
+		return numHitches;
+	}
+
+	int GetNumFrames() const
+	{
+		return m_numFrames;
+	}
+
+private:
+	int m_bucketCounts[NUM_BUCKETS];
+	int m_numFrames;
+};
+
+#endif
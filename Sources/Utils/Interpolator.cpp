@@ -7,38 +7,12 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
-#include <algorithm>
-
-#include <glm/detail/type_vec3.hpp>
-#include <Maths/Bezier3.h>
-
 #include "Interpolator.h"
 
 #pragma comment (lib, "Winmm.lib")
 
-bool NeedsErasingFloat(FloatInterpolation* f)
-{
-	bool needsErase = f->erase;
-
-	if (needsErase == true)
-	{
-		delete f;
-	}
-
-	return needsErase;
-}
-
-bool NeedsErasingInt(IntInterpolation* i)
-{
-	bool needsErase = i->erase;
-
-	if (needsErase == true)
-	{
-		delete i;
-	}
-
-	return needsErase;
-}
+// Stopped interpolations are only cleared out of the running arrays once they are this much of them, so the ones still running aren't moved every update
+const float INTERPOLATION_STOPPED_RATIO_TO_REMOVE = 0.25f;
 
 // Initialize the singleton instance
 Interpolator* Interpolator::m_instance = nullptr;
@@ -59,494 +33,481 @@ void Interpolator::Destroy()
 	{
 		ClearInterpolators();
 		delete m_instance;
+		m_instance = nullptr;
 	}
 }
 
 void Interpolator::ClearInterpolators()
 {
-	// Float
-	for (unsigned int i = 0; i < m_vpFloatInterpolations.size(); ++i)
+	// Free the slots rather than dropping the pool, so the handles still around find nothing
+	for (unsigned int i = 0; i < m_interpolations.size(); ++i)
 	{
-		FloatInterpolation* pNext = m_vpFloatInterpolations[i]->pNextInterpolation;
-		while (pNext != nullptr)
+		if (m_interpolations[i].isAlive)
 		{
-			FloatInterpolation* pThisOne = pNext;
-			pNext = pNext->pNextInterpolation;
-
-			if (pThisOne->variable != nullptr)
-			{
-				delete pThisOne;
-				pThisOne->variable = nullptr;
-				pThisOne->pNextInterpolation = nullptr;
-			}
-		}
-
-		if (m_vpFloatInterpolations[i]->variable != nullptr)
-		{
-			delete m_vpFloatInterpolations[i];
-			m_vpFloatInterpolations[i]->variable = nullptr;
-			m_vpFloatInterpolations[i]->pNextInterpolation = nullptr;
-			m_vpFloatInterpolations[i] = nullptr;
+			FreeInterpolation(static_cast<int>(i));
 		}
 	}
-	m_vpFloatInterpolations.clear();
 
-	for (unsigned int i = 0; i < m_vpCreateFloatInterpolations.size(); ++i)
-	{
-		FloatInterpolation* pNext = m_vpCreateFloatInterpolations[i]->pNextInterpolation;
-		while (pNext != nullptr)
-		{
-			FloatInterpolation* pThisOne = pNext;
-			pNext = pNext->pNextInterpolation;
+	m_pendingInterpolations.clear();
+
+	m_runningSlots.clear();
+	m_runningFloatVariables.clear();
+	m_runningIntVariables.clear();
+	m_runningStarts.clear();
+	m_runningDifferences.clear();
+	m_runningEaseControls.clear();
+	m_runningTimes.clear();
+	m_runningElapsed.clear();
+	m_runningValues.clear();
+	m_numStoppedInterpolations = 0;
+}
 
-			if (pThisOne->variable != nullptr)
-			{
-				delete pThisOne;
-				pThisOne->variable = nullptr;
-				pThisOne->pNextInterpolation = nullptr;
-			}
-		}
+InterpolationHandle Interpolator::CreateFloatInterpolation(float* val, float start, float end, float time, float easing, FunctionCallback callback, void* data)
+{
+	return CreateInterpolation(val, nullptr, start, end, time, easing, callback, data);
+}
 
-		if (m_vpCreateFloatInterpolations[i]->variable != nullptr)
-		{
-			delete m_vpCreateFloatInterpolations[i];
-			m_vpCreateFloatInterpolations[i]->variable = nullptr;
-			m_vpCreateFloatInterpolations[i]->pNextInterpolation = nullptr;
-			m_vpCreateFloatInterpolations[i] = nullptr;
-		}
-	}
-	m_vpCreateFloatInterpolations.clear();
+void Interpolator::LinkFloatInterpolation(const InterpolationHandle& first, const InterpolationHandle& second)
+{
+	LinkInterpolation(first, second);
+}
 
-	// Int
-	for (unsigned int i = 0; i < m_vpIntInterpolations.size(); ++i)
-	{
-		IntInterpolation* pNext = m_vpIntInterpolations[i]->pNextInterpolation;
-		while (pNext != nullptr)
-		{
-			IntInterpolation* pThisOne = pNext;
-			pNext = pNext->pNextInterpolation;
+void Interpolator::AddFloatInterpolation(const InterpolationHandle& interpolation)
+{
+	AddInterpolation(interpolation);
+}
 
-			if (pThisOne->variable != nullptr)
-			{
-				delete pThisOne;
-				pThisOne->variable = nullptr;
-				pThisOne->pNextInterpolation = nullptr;
-			}
-		}
+InterpolationHandle Interpolator::AddFloatInterpolation(float* val, float start, float end, float time, float easing, FunctionCallback callback, void* data)
+{
+	InterpolationHandle floatInterp = CreateFloatInterpolation(val, start, end, time, easing, callback, data);
+	AddFloatInterpolation(floatInterp);
+
+	return floatInterp;
+}
 
-		if (m_vpIntInterpolations[i]->variable != nullptr)
+void Interpolator::RemoveFloatInterpolationByVariable(float* val)
+{
+	// Creation list
+	for (unsigned int i = 0; i < m_pendingInterpolations.size(); ++i)
+	{
+		const InterpolationHandle& interpolation = m_pendingInterpolations[i];
+		if (IsValid(interpolation) && m_interpolations[interpolation.m_index].pFloatVariable == val)
 		{
-			delete m_vpIntInterpolations[i];
-			m_vpIntInterpolations[i]->variable = nullptr;
-			m_vpIntInterpolations[i]->pNextInterpolation = nullptr;
-			m_vpIntInterpolations[i] = nullptr;
+			RemoveInterpolation(interpolation);
 		}
 	}
-	m_vpIntInterpolations.clear();
 
-	for (unsigned int i = 0; i < m_vpCreateIntInterpolations.size(); ++i)
+	// Running list
+	for (unsigned int i = 0; i < m_runningSlots.size(); ++i)
 	{
-		IntInterpolation* pNext = m_vpCreateIntInterpolations[i]->pNextInterpolation;
-		while (pNext != nullptr)
+		if (m_runningSlots[i] != -1 && m_runningFloatVariables[i] == val)
 		{
-			IntInterpolation* pThisOne = pNext;
-			pNext = pNext->pNextInterpolation;
-
-			if (pThisOne->variable != nullptr)
-			{
-				delete pThisOne;
-				pThisOne->variable = nullptr;
-				pThisOne->pNextInterpolation = nullptr;
-			}
-		}
+			InterpolationHandle interpolation;
+			interpolation.m_index = m_runningSlots[i];
+			interpolation.m_generation = m_interpolations[m_runningSlots[i]].generation;
 
-		if (m_vpCreateIntInterpolations[i]->variable != nullptr)
-		{
-			delete m_vpCreateIntInterpolations[i];
-			m_vpCreateIntInterpolations[i]->variable = nullptr;
-			m_vpCreateIntInterpolations[i]->pNextInterpolation = nullptr;
-			m_vpCreateIntInterpolations[i] = nullptr;
+			RemoveInterpolation(interpolation);
 		}
 	}
-	m_vpCreateIntInterpolations.clear();
 }
 
-FloatInterpolation* Interpolator::CreateFloatInterpolation(float* val, float start, float end, float time, float easing, FloatInterpolation* next, FunctionCallback callback, void* data) const
+InterpolationHandle Interpolator::CreateIntInterpolation(int* val, int start, int end, float time, float easing, FunctionCallback callback, void* data)
 {
-	FloatInterpolation* floatInterp = new FloatInterpolation();
-	floatInterp->variable = val;
-	floatInterp->start = start;
-	floatInterp->end = end;
-	floatInterp->time = time;
-
-	floatInterp->easing = easing;
-
-	floatInterp->pNextInterpolation = next;
-
-	floatInterp->elapsed = 0.0f;
-	floatInterp->erase = false;
-
-	floatInterp->callback = callback;
-	floatInterp->pCallbackData = data;
-
-	return floatInterp;
+	return CreateInterpolation(nullptr, val, static_cast<float>(start), static_cast<float>(end), time, easing, callback, data);
 }
 
-void Interpolator::LinkFloatInterpolation(FloatInterpolation* first, FloatInterpolation* second) const
+void Interpolator::LinkIntInterpolation(const InterpolationHandle& first, const InterpolationHandle& second)
 {
-	first->pNextInterpolation = second;
+	LinkInterpolation(first, second);
 }
 
-void Interpolator::AddFloatInterpolation(FloatInterpolation* interpolation)
+void Interpolator::AddIntInterpolation(const InterpolationHandle& interpolation)
 {
-	// Reset the elapsed time
-	interpolation->elapsed = 0.0f;
-
-	// Rest the erase flag
-	interpolation->erase = false;
-
-	m_vpCreateFloatInterpolations.push_back(interpolation);
+	AddInterpolation(interpolation);
 }
 
-void Interpolator::AddFloatInterpolation(float* val, float start, float end, float time, float easing, FloatInterpolation* next, FunctionCallback callback, void* data)
+InterpolationHandle Interpolator::AddIntInterpolation(int* val, int start, int end, float time, float easing, FunctionCallback callback, void* data)
 {
-	FloatInterpolation* floatInterp = CreateFloatInterpolation(val, start, end, time, easing, next, callback, data);
-	AddFloatInterpolation(floatInterp);
+	InterpolationHandle intInterp = CreateIntInterpolation(val, start, end, time, easing, callback, data);
+	AddIntInterpolation(intInterp);
+
+	return intInterp;
 }
 
-void Interpolator::RemoveFloatInterpolationByVariable(float* val)
+void Interpolator::RemoveIntInterpolationByVariable(int* val)
 {
 	// Creation list
-	FloatInterpolationList vpRemoveCreateFloatInterpolations;
-	for (unsigned int i = 0; i < m_vpCreateFloatInterpolations.size(); ++i)
+	for (unsigned int i = 0; i < m_pendingInterpolations.size(); ++i)
 	{
-		FloatInterpolation* pInterpolator = m_vpCreateFloatInterpolations[i];
-		if (pInterpolator->variable == val)
+		const InterpolationHandle& interpolation = m_pendingInterpolations[i];
+		if (IsValid(interpolation) && m_interpolations[interpolation.m_index].pIntVariable == val)
 		{
-			vpRemoveCreateFloatInterpolations.push_back(pInterpolator);
+			RemoveInterpolation(interpolation);
 		}
 	}
-	for (unsigned int i = 0; i < vpRemoveCreateFloatInterpolations.size(); ++i)
-	{
-		RemoveCreateFloatInterpolation(vpRemoveCreateFloatInterpolations[i]);
-	}
 
-	// Normal list
-	FloatInterpolationList vpRemoveFloatInterpolations;
-	for (unsigned int i = 0; i < m_vpFloatInterpolations.size(); ++i)
+	// Running list
+	for (unsigned int i = 0; i < m_runningSlots.size(); ++i)
 	{
-		FloatInterpolation* pInterpolator = m_vpFloatInterpolations[i];
-		if (pInterpolator->variable == val)
+		if (m_runningSlots[i] != -1 && m_runningIntVariables[i] == val)
 		{
-			vpRemoveFloatInterpolations.push_back(pInterpolator);
+			InterpolationHandle interpolation;
+			interpolation.m_index = m_runningSlots[i];
+			interpolation.m_generation = m_interpolations[m_runningSlots[i]].generation;
+
+			RemoveInterpolation(interpolation);
 		}
 	}
-	for (unsigned int i = 0; i < vpRemoveFloatInterpolations.size(); ++i)
-	{
-		RemoveFloatInterpolation(vpRemoveFloatInterpolations[i]);
-	}
 }
 
-IntInterpolation* Interpolator::CreateIntInterpolation(int* val, int start, int end, float time, float easing, IntInterpolation* next, FunctionCallback callback, void* data) const
+void Interpolator::RemoveInterpolation(const InterpolationHandle& interpolation)
 {
-	IntInterpolation* intInterp = new IntInterpolation();
-	intInterp->variable = val;
-	intInterp->start = start;
-	intInterp->end = end;
-	intInterp->time = time;
+	InterpolationHandle remove = interpolation;
 
-	intInterp->easing = easing;
+	// Free the chain along with it, the ones after it would never start
+	while (IsValid(remove))
+	{
+		InterpolationHandle next = m_interpolations[remove.m_index].next;
+		FreeInterpolation(remove.m_index);
 
-	intInterp->pNextInterpolation = next;
+		remove = next;
+	}
+}
 
-	intInterp->elapsed = 0.0f;
-	intInterp->erase = false;
+bool Interpolator::IsInterpolating(const InterpolationHandle& interpolation) const
+{
+	return IsValid(interpolation);
+}
 
-	intInterp->callback = callback;
-	intInterp->pCallbackData = data;
+int Interpolator::GetNumInterpolations() const
+{
+	return m_numInterpolations;
+}
 
-	return intInterp;
+void Interpolator::SetPaused(bool pause)
+{
+	m_paused = pause;
 }
 
-void Interpolator::LinkIntInterpolation(IntInterpolation* first, IntInterpolation* second) const
+bool Interpolator::IsPaused() const
 {
-	first->pNextInterpolation = second;
+	return m_paused;
 }
 
-void Interpolator::AddIntInterpolation(IntInterpolation* interpolation)
+void Interpolator::Update(float dt)
 {
-	// Reset the elapsed time
-	interpolation->elapsed = 0.0f;
+	// Remove any interpolations that finished or were removed, once there are enough of them
+	RemoveStoppedInterpolations();
 
-	// Rest the erase flag
-	interpolation->erase = false;
+	// Add any interpolators in the create list
+	StartPendingInterpolations();
 
-	m_vpCreateIntInterpolations.push_back(interpolation);
+	if (m_paused == false)
+	{
+		UpdateRunningInterpolations(dt);
+	}
 }
 
-void Interpolator::AddIntInterpolation(int* val, int start, int end, float time, float easing, IntInterpolation* next, FunctionCallback callback, void* data)
+Interpolator::Interpolator() :
+	m_firstFreeInterpolation(-1), m_numInterpolations(0), m_numStoppedInterpolations(0)
 {
-	IntInterpolation* intInterp = CreateIntInterpolation(val, start, end, time, easing, next, callback, data);
-
-	AddIntInterpolation(intInterp);
+	m_paused = false;
 }
 
-void Interpolator::RemoveIntInterpolationByVariable(int* val)
+bool Interpolator::IsValid(const InterpolationHandle& interpolation) const
 {
-	// Creation list
-	IntInterpolationList vpRemoveCreateIntInterpolations;
-	for (unsigned int i = 0; i < m_vpCreateIntInterpolations.size(); ++i)
+	if (interpolation.m_index < 0 || interpolation.m_index >= static_cast<int>(m_interpolations.size()))
 	{
-		IntInterpolation* pInterpolator = m_vpCreateIntInterpolations[i];
-		if (pInterpolator->variable == val)
-		{
-			vpRemoveCreateIntInterpolations.push_back(pInterpolator);
-		}
-	}
-	for (unsigned int i = 0; i < vpRemoveCreateIntInterpolations.size(); ++i)
-	{
-		RemoveCreateIntInterpolation(vpRemoveCreateIntInterpolations[i]);
+		return false;
 	}
 
-	// Normal list
-	IntInterpolationList vpRemoveIntInterpolations;
-	for (unsigned int i = 0; i < m_vpIntInterpolations.size(); ++i)
+	const Interpolation& slot = m_interpolations[interpolation.m_index];
+
+	return slot.isAlive && slot.generation == interpolation.m_generation;
+}
+
+InterpolationHandle Interpolator::CreateInterpolation(float* pFloatVariable, int* pIntVariable, float start, float end, float time, float easing, FunctionCallback callback, void* data)
+{
+	int index;
+
+	if (m_firstFreeInterpolation != -1)
 	{
-		IntInterpolation* pInterpolator = m_vpIntInterpolations[i];
-		if (pInterpolator->variable == val)
-		{
-			vpRemoveIntInterpolations.push_back(pInterpolator);
-		}
+		index = m_firstFreeInterpolation;
+		m_firstFreeInterpolation = m_interpolations[index].next.m_index;
 	}
-	for (unsigned int i = 0; i < vpRemoveIntInterpolations.size(); ++i)
+	else
 	{
-		RemoveIntInterpolation(vpRemoveIntInterpolations[i]);
+		index = static_cast<int>(m_interpolations.size());
+		m_interpolations.push_back(Interpolation());
+		m_interpolations[index].generation = 0;
 	}
+
+	Interpolation* pInterpolation = &m_interpolations[index];
+	pInterpolation->pFloatVariable = pFloatVariable;
+	pInterpolation->pIntVariable = pIntVariable;
+	pInterpolation->start = start;
+	pInterpolation->end = end;
+	pInterpolation->time = time;
+
+	pInterpolation->easing = easing;
+
+	pInterpolation->next = InterpolationHandle();
+
+	pInterpolation->callback = callback;
+	pInterpolation->pCallbackData = data;
+
+	pInterpolation->isAlive = true;
+	pInterpolation->isPending = false;
+	pInterpolation->runningIndex = -1;
+
+	m_numInterpolations++;
+
+	InterpolationHandle interpolation;
+	interpolation.m_index = index;
+	interpolation.m_generation = pInterpolation->generation;
+
+	return interpolation;
 }
 
-void Interpolator::SetPaused(bool pause)
+void Interpolator::LinkInterpolation(const InterpolationHandle& first, const InterpolationHandle& second)
 {
-	m_paused = pause;
+	if (IsValid(first) == false)
+	{
+		return;
+	}
+
+	m_interpolations[first.m_index].next = second;
 }
 
-bool Interpolator::IsPaused() const
+void Interpolator::AddInterpolation(const InterpolationHandle& interpolation)
 {
-	return m_paused;
+	if (IsValid(interpolation) == false)
+	{
+		return;
+	}
+
+	Interpolation* pInterpolation = &m_interpolations[interpolation.m_index];
+	if (pInterpolation->isPending || pInterpolation->runningIndex != -1)
+	{
+		return;
+	}
+
+	pInterpolation->isPending = true;
+	m_pendingInterpolations.push_back(interpolation);
 }
 
-void Interpolator::Update(float dt)
+void Interpolator::FreeInterpolation(int index)
 {
-	UpdateFloatInterpolators(dt);
-	UpdateIntInterpolators(dt);
+	Interpolation* pInterpolation = &m_interpolations[index];
+
+	if (pInterpolation->runningIndex != -1)
+	{
+		m_runningSlots[pInterpolation->runningIndex] = -1;
+		m_numStoppedInterpolations++;
+	}
+
+	pInterpolation->callback = nullptr;
+	pInterpolation->isAlive = false;
+	pInterpolation->isPending = false;
+	pInterpolation->runningIndex = -1;
+	pInterpolation->generation++;
+
+	pInterpolation->next.m_index = m_firstFreeInterpolation;
+	m_firstFreeInterpolation = index;
+
+	m_numInterpolations--;
 }
 
-void Interpolator::UpdateFloatInterpolators(float delta)
+void Interpolator::StartPendingInterpolations()
 {
-	// Add any interpolators in the create list
-	for (unsigned int i = 0; i < m_vpCreateFloatInterpolations.size(); ++i)
+	for (unsigned int i = 0; i < m_pendingInterpolations.size(); ++i)
 	{
-		FloatInterpolation* pInterpolator = m_vpCreateFloatInterpolations[i];
+		const InterpolationHandle& interpolation = m_pendingInterpolations[i];
+		if (IsValid(interpolation) == false || m_interpolations[interpolation.m_index].isPending == false)
+		{
+			continue;
+		}
 
-		m_vpFloatInterpolations.push_back(pInterpolator);
+		Interpolation* pInterpolation = &m_interpolations[interpolation.m_index];
+		pInterpolation->isPending = false;
+		pInterpolation->runningIndex = static_cast<int>(m_runningSlots.size());
+
+		// The ease curve is a bezier from (0, 0) to (1, 1), whose control point is only needed for its y
+		// NOTE: 0 = linear, 100 = full acceleration, -100 = full deceleration.
+		float easeControl = 1.0f - ((pInterpolation->easing * 0.005f) + 0.5f);
+
+		m_runningSlots.push_back(interpolation.m_index);
+		m_runningFloatVariables.push_back(pInterpolation->pFloatVariable);
+		m_runningIntVariables.push_back(pInterpolation->pIntVariable);
+		m_runningStarts.push_back(pInterpolation->start);
+		m_runningDifferences.push_back(pInterpolation->end - pInterpolation->start);
+		m_runningEaseControls.push_back(easeControl);
+		m_runningTimes.push_back(pInterpolation->time);
+		m_runningElapsed.push_back(0.0f);
+		m_runningValues.push_back(pInterpolation->start);
 	}
-	m_vpCreateFloatInterpolations.clear();
 
-	// Remove any interpolations that need to be erased
-	m_vpFloatInterpolations.erase(remove_if(m_vpFloatInterpolations.begin(), m_vpFloatInterpolations.end(), NeedsErasingFloat), m_vpFloatInterpolations.end());
+	m_pendingInterpolations.clear();
+}
 
-	if (m_paused == false)
+void Interpolator::RemoveStoppedInterpolations()
+{
+	if (m_numStoppedInterpolations == 0 || m_numStoppedInterpolations < static_cast<int>(m_runningSlots.size() * INTERPOLATION_STOPPED_RATIO_TO_REMOVE))
 	{
-		FloatInterpolationList m_vpNextFloatInterpolationsAddList;
+		return;
+	}
 
-		// Update the float interpolations
-		for (unsigned int i = 0; i < m_vpFloatInterpolations.size(); ++i)
-		{
-			FloatInterpolation* pInterpolator = m_vpFloatInterpolations[i];
-			if (pInterpolator != nullptr)
-			{
-				if (pInterpolator->elapsed < pInterpolator->time)
-				{
-					float* pVar = pInterpolator->variable;
-					if (pVar == nullptr)
-					{
-						continue;
-					}
-
-					float timeRatio = pInterpolator->elapsed / pInterpolator->time;
-					float diff = static_cast<float>(pInterpolator->end - pInterpolator->start);
-
-					// Create a bezier curve to represent the acceleration/deceleration curve of the animation
-					// NOTE: 0 = linear, 100 = full acceleration, -100 = full deceleration.
-					float x = (pInterpolator->easing * 0.005f) + 0.5f;
-					float y = 1.0f - x;
-
-					glm::vec3 start = glm::vec3(0.0f, 0.0f, 0.0f);
-					glm::vec3 end = glm::vec3(1.0f, 1.0f, 0.0f);
-					glm::vec3 control = glm::vec3(x, y, 0.0f);
-
-					Bezier3 easeBezier = Bezier3(start, end, control);
-					glm::vec3 vectorT = easeBezier.GetInterpolatedPoint(timeRatio);
-
-					// Get our real T value that we are going to use to interpolate
-					float realT = vectorT.y;
-
-					// Set the variable value
-					*pVar = pInterpolator->start + (diff * realT);
-
-					pInterpolator->elapsed += delta;
-				}
-				else
-				{
-					float* pVar = pInterpolator->variable;
-					if (pVar == nullptr)
-					{
-						continue;
-					}
-
-					*pVar = pInterpolator->end;
-
-					// If we have a callback, do it
-					if (pInterpolator->callback != nullptr)
-					{
-						pInterpolator->callback(pInterpolator->pCallbackData);
-					}
-
-					// Are we chained to start another float interpolator?
-					if (pInterpolator->pNextInterpolation != nullptr)
-					{
-						m_vpNextFloatInterpolationsAddList.push_back(pInterpolator->pNextInterpolation);
-					}
-
-					// Erase this interpolator since we have finished
-					pInterpolator->erase = true;
-				}
-			}
+	// Keeps the order the interpolations were added in, so the ones on the same variable still write in that order
+	unsigned int numRunning = 0;
 
+	for (unsigned int i = 0; i < m_runningSlots.size(); ++i)
+	{
+		if (m_runningSlots[i] == -1)
+		{
+			continue;
 		}
 
-		// Add any chained interpolators to the list
-		for (unsigned int j = 0; j < m_vpNextFloatInterpolationsAddList.size(); ++j)
+		if (numRunning != i)
 		{
-			FloatInterpolation* pInterpolator = m_vpNextFloatInterpolationsAddList[j];
-			AddFloatInterpolation(pInterpolator);
+			m_runningSlots[numRunning] = m_runningSlots[i];
+			m_runningFloatVariables[numRunning] = m_runningFloatVariables[i];
+			m_runningIntVariables[numRunning] = m_runningIntVariables[i];
+			m_runningStarts[numRunning] = m_runningStarts[i];
+			m_runningDifferences[numRunning] = m_runningDifferences[i];
+			m_runningEaseControls[numRunning] = m_runningEaseControls[i];
+			m_runningTimes[numRunning] = m_runningTimes[i];
+			m_runningElapsed[numRunning] = m_runningElapsed[i];
+			m_runningValues[numRunning] = m_runningValues[i];
+
+			m_interpolations[m_runningSlots[numRunning]].runningIndex = static_cast<int>(numRunning);
 		}
+
+		numRunning++;
 	}
+
+	m_runningSlots.resize(numRunning);
+	m_runningFloatVariables.resize(numRunning);
+	m_runningIntVariables.resize(numRunning);
+	m_runningStarts.resize(numRunning);
+	m_runningDifferences.resize(numRunning);
+	m_runningEaseControls.resize(numRunning);
+	m_runningTimes.resize(numRunning);
+	m_runningElapsed.resize(numRunning);
+	m_runningValues.resize(numRunning);
+
+	m_numStoppedInterpolations = 0;
 }
 
-void Interpolator::UpdateIntInterpolators(float delta)
+void Interpolator::UpdateRunningInterpolations(float delta)
 {
-	// Add any interpolators in the create list
-	for (unsigned int i = 0; i < m_vpCreateIntInterpolations.size(); ++i)
+	int numRunning = static_cast<int>(m_runningSlots.size());
+
+	const float* pStarts = m_runningStarts.data();
+	const float* pDifferences = m_runningDifferences.data();
+	const float* pEaseControls = m_runningEaseControls.data();
+	const float* pTimes = m_runningTimes.data();
+	const float* pElapsed = m_runningElapsed.data();
+	float* pValues = m_runningValues.data();
+
+	// Work out all the values first, this loop only writes one array and has no branches or calls, so it can be vectorized.
+	// The value of a finished interpolation isn't used, it is set to its end instead.
+	for (int i = 0; i < numRunning; ++i)
 	{
-		IntInterpolation* pInterpolator = m_vpCreateIntInterpolations[i];
+		float timeRatio = pElapsed[i] / pTimes[i];
+		float realT = (2.0f * timeRatio * (1.0f - timeRatio) * pEaseControls[i]) + (timeRatio * timeRatio);
 
-		m_vpIntInterpolations.push_back(pInterpolator);
+		pValues[i] = pStarts[i] + (pDifferences[i] * realT);
 	}
-	m_vpCreateIntInterpolations.clear();
 
-	// Remove any interpolations that need to be erased
-	m_vpIntInterpolations.erase(remove_if(m_vpIntInterpolations.begin(), m_vpIntInterpolations.end(), NeedsErasingInt), m_vpIntInterpolations.end());
+	InterpolationHandleList chainedInterpolations;
 
-	if (m_paused == false)
+	// Then write them out, and finish the ones that are done
+	for (int i = 0; i < numRunning; ++i)
 	{
-		IntInterpolationList m_vpNextIntInterpolationsAddList;
+		int index = m_runningSlots[i];
+		if (index == -1)
+		{
+			continue;
+		}
 
-		// Update the int interpolations
-		for (unsigned int i = 0; i < m_vpIntInterpolations.size(); ++i)
+		if (m_runningElapsed[i] < m_runningTimes[i])
 		{
-			IntInterpolation* pInterpolator = m_vpIntInterpolations[i];
-			if (pInterpolator != nullptr)
+			// Set the variable value
+			if (m_runningFloatVariables[i] != nullptr)
 			{
-				if (pInterpolator->elapsed < pInterpolator->time)
-				{
-					int* pVar = pInterpolator->variable;
-					if (pVar == nullptr)
-					{
-						continue;
-					}
-
-					float timeRatio = pInterpolator->elapsed / pInterpolator->time;
-					float diff = static_cast<float>(pInterpolator->end - pInterpolator->start);
-
-					// Create a bezier curve to represent the acceleration/deceleration curve of the animation
-					// NOTE: 0 = linear, 100 = full acceleration, -100 = full deceleration.
-					float x = (pInterpolator->easing * 0.005f) + 0.5f;
-					float y = 1.0f - x;
-
-					glm::vec3 start = glm::vec3(0.0f, 0.0f, 0.0f);
-					glm::vec3 end = glm::vec3(1.0f, 1.0f, 0.0f);
-					glm::vec3 control = glm::vec3(x, y, 0.0f);
-
-					Bezier3 easeBezier = Bezier3(start, end, control);
-					glm::vec3 vectorT = easeBezier.GetInterpolatedPoint(timeRatio);
-
-					// Get our real T value that we are going to use to interpolate
-					float realT = vectorT.y;
-
-					// Set the variable value
-					*pVar = static_cast<int>(pInterpolator->start + (diff * realT));
-
-					pInterpolator->elapsed += delta;
-				}
-				else
-				{
-					int* pVar = pInterpolator->variable;
-					if (pVar == nullptr)
-					{
-						continue;
-					}
-
-					*pVar = pInterpolator->end;
-
-					// If we have a callback, do it
-					if (pInterpolator->callback != nullptr)
-					{
-						pInterpolator->callback(pInterpolator->pCallbackData);
-					}
-
-					// Are we chained to start another int interpolator?
-					if (pInterpolator->pNextInterpolation != nullptr)
-					{
-						m_vpNextIntInterpolationsAddList.push_back(pInterpolator->pNextInterpolation);
-					}
-
-					// Erase this interpolator since we have finished
-					pInterpolator->erase = true;
-				}
+				*m_runningFloatVariables[i] = m_runningValues[i];
 			}
+			else
+			{
+				*m_runningIntVariables[i] = static_cast<int>(m_runningValues[i]);
+			}
+
+			m_runningElapsed[i] += delta;
 
+			continue;
 		}
 
-		// Add any chained interpolators to the list
-		for (unsigned int j = 0; j < m_vpNextIntInterpolationsAddList.size(); ++j)
+		Interpolation* pInterpolation = &m_interpolations[index];
+
+		if (pInterpolation->pFloatVariable != nullptr)
 		{
-			IntInterpolation* pInterpolator = m_vpNextIntInterpolationsAddList[j];
-			AddIntInterpolation(pInterpolator);
+			*pInterpolation->pFloatVariable = pInterpolation->end;
+		}
+		else
+		{
+			*pInterpolation->pIntVariable = static_cast<int>(pInterpolation->end);
 		}
-	}
-}
 
-Interpolator::Interpolator()
-{
-	m_paused = false;
-}
+		// Stopped before the callback, which may remove it or add others that move the pool
+		m_runningSlots[i] = -1;
+		pInterpolation->runningIndex = -1;
+		m_numStoppedInterpolations++;
 
-void Interpolator::RemoveCreateFloatInterpolation(FloatInterpolation* interpolation)
-{
-	m_vpCreateFloatInterpolations.erase(remove(m_vpCreateFloatInterpolations.begin(), m_vpCreateFloatInterpolations.end(), interpolation), m_vpCreateFloatInterpolations.end());
-}
+		InterpolationHandle interpolation;
+		interpolation.m_index = index;
+		interpolation.m_generation = pInterpolation->generation;
 
-void Interpolator::RemoveFloatInterpolation(FloatInterpolation* aInterpolation)
-{
-	m_vpFloatInterpolations.erase(remove(m_vpFloatInterpolations.begin(), m_vpFloatInterpolations.end(), aInterpolation), m_vpFloatInterpolations.end());
-}
+		// If we have a callback, do it
+		FunctionCallback callback = pInterpolation->callback;
+		if (callback != nullptr)
+		{
+			callback(pInterpolation->pCallbackData);
+		}
 
-void Interpolator::RemoveCreateIntInterpolation(IntInterpolation* interpolation)
-{
-	m_vpCreateIntInterpolations.erase(remove(m_vpCreateIntInterpolations.begin(), m_vpCreateIntInterpolations.end(), interpolation), m_vpCreateIntInterpolations.end());
-}
+		if (IsValid(interpolation) == false)
+		{
+			continue;
+		}
 
-void Interpolator::RemoveIntInterpolation(IntInterpolation* aInterpolation)
-{
-	m_vpIntInterpolations.erase(remove(m_vpIntInterpolations.begin(), m_vpIntInterpolations.end(), aInterpolation), m_vpIntInterpolations.end());
+		// Are we chained to start another interpolation? It carries on in this slot, so the first handle still covers the chain.
+		InterpolationHandle next = m_interpolations[index].next;
+		if (IsValid(next) && next.m_index != index)
+		{
+			Interpolation& current = m_interpolations[index];
+			Interpolation& chained = m_interpolations[next.m_index];
+
+			current.pFloatVariable = chained.pFloatVariable;
+			current.pIntVariable = chained.pIntVariable;
+			current.start = chained.start;
+			current.end = chained.end;
+			current.time = chained.time;
+			current.easing = chained.easing;
+			current.next = chained.next;
+			current.callback = chained.callback;
+			current.pCallbackData = chained.pCallbackData;
+
+			FreeInterpolation(next.m_index);
+
+			m_interpolations[index].isPending = true;
+			chainedInterpolations.push_back(interpolation);
+		}
+		else
+		{
+			// Erase this interpolator since we have finished
+			FreeInterpolation(index);
+		}
+	}
+
+	// Add any chained interpolators to the list, they start on the next update after the ones the callbacks added
+	m_pendingInterpolations.insert(m_pendingInterpolations.end(), chainedInterpolations.begin(), chainedInterpolations.end());
 }
\ No newline at end of file
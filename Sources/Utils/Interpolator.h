@@ -15,93 +15,111 @@
 
 using FunctionCallback = std::function<void(void*)>;
 
-struct FloatInterpolation
+// An interpolation in the interpolator's pool. The generation changes when the interpolation finishes or is removed, so an
+// old handle finds nothing. A chain runs in the slot of its first interpolation, so that handle covers all of it.
+struct InterpolationHandle
 {
-	float* variable;
+	InterpolationHandle() : m_index(-1), m_generation(0) {}
 
-	float start;
-	float end;
-	float time;
-
-	float easing;
-
-	float elapsed;
-
-	bool erase;
-
-	FloatInterpolation* pNextInterpolation;
-
-	FunctionCallback callback;
-	void* pCallbackData;
+	int m_index;
+	unsigned int m_generation;
 };
 
-struct IntInterpolation
+// A float or int variable moved from start to end, only one of the variables is set
+struct Interpolation
 {
-	int* variable;
+	float* pFloatVariable;
+	int* pIntVariable;
 
-	int start;
-	int end;
+	float start;
+	float end;
 	float time;
 
 	float easing;
 
-	float elapsed;
-
-	bool erase;
-
-	IntInterpolation* pNextInterpolation;
+	InterpolationHandle next;
 
 	FunctionCallback callback;
 	void* pCallbackData;
+
+	unsigned int generation;
+	bool isAlive;
+	bool isPending;
+
+	// Where it is in the running arrays, -1 when it isn't running
+	int runningIndex;
 };
 
-using FloatInterpolationList = std::vector<FloatInterpolation*>;
-using IntInterpolationList = std::vector<IntInterpolation*>;
+using InterpolationList = std::vector<Interpolation>;
+using InterpolationHandleList = std::vector<InterpolationHandle>;
 
 class Interpolator
 {
 public:
+	// An interpolator of its own keeps its interpolations apart from the game's, as the benchmarks need
+	Interpolator();
+
 	static Interpolator* GetInstance();
 	void Destroy();
 
 	void ClearInterpolators();
 
-	FloatInterpolation* CreateFloatInterpolation(float* val, float start, float end, float time, float easing, FloatInterpolation* next = nullptr, FunctionCallback callback = nullptr, void* data = nullptr) const;
-	void LinkFloatInterpolation(FloatInterpolation* first, FloatInterpolation* second) const;
-	void AddFloatInterpolation(FloatInterpolation* interpolation);
-	void AddFloatInterpolation(float* val, float start, float end, float time, float easing, FloatInterpolation* next = nullptr, FunctionCallback callback = nullptr, void* data = nullptr);
+	// Created interpolations wait until they are added or the one linked before them finishes
+	InterpolationHandle CreateFloatInterpolation(float* val, float start, float end, float time, float easing, FunctionCallback callback = nullptr, void* data = nullptr);
+	void LinkFloatInterpolation(const InterpolationHandle& first, const InterpolationHandle& second);
+	void AddFloatInterpolation(const InterpolationHandle& interpolation);
+	InterpolationHandle AddFloatInterpolation(float* val, float start, float end, float time, float easing, FunctionCallback callback = nullptr, void* data = nullptr);
 	void RemoveFloatInterpolationByVariable(float* val);
 
-	IntInterpolation* CreateIntInterpolation(int* val, int start, int end, float time, float easing, IntInterpolation* next = nullptr, FunctionCallback callback = nullptr, void* data = nullptr) const;
-	void LinkIntInterpolation(IntInterpolation* first, IntInterpolation* second) const;
-	void AddIntInterpolation(IntInterpolation* interpolation);
-	void AddIntInterpolation(int* val, int start, int end, float time, float easing, IntInterpolation* next = nullptr, FunctionCallback callback = nullptr, void* data = nullptr);
+	InterpolationHandle CreateIntInterpolation(int* val, int start, int end, float time, float easing, FunctionCallback callback = nullptr, void* data = nullptr);
+	void LinkIntInterpolation(const InterpolationHandle& first, const InterpolationHandle& second);
+	void AddIntInterpolation(const InterpolationHandle& interpolation);
+	InterpolationHandle AddIntInterpolation(int* val, int start, int end, float time, float easing, FunctionCallback callback = nullptr, void* data = nullptr);
 	void RemoveIntInterpolationByVariable(int* val);
 
+	// Stops the interpolation and everything chained after it, without calling back. Does nothing once it has finished.
+	void RemoveInterpolation(const InterpolationHandle& interpolation);
+	bool IsInterpolating(const InterpolationHandle& interpolation) const;
+	int GetNumInterpolations() const;
+
 	void SetPaused(bool pause);
 	bool IsPaused() const;
 
 	void Update(float dt);
-	void UpdateFloatInterpolators(float delta);
-	void UpdateIntInterpolators(float delta);
-
-protected:
-	Interpolator();
 
 private:
-	void RemoveCreateFloatInterpolation(FloatInterpolation* interpolation);
-	void RemoveFloatInterpolation(FloatInterpolation* interpolation);
-
-	void RemoveCreateIntInterpolation(IntInterpolation* interpolation);
-	void RemoveIntInterpolation(IntInterpolation* interpolation);
-
-	// A dynamic array of our float interpolation variables
-	FloatInterpolationList m_vpFloatInterpolations;
-	FloatInterpolationList m_vpCreateFloatInterpolations;
-
-	// A dynamic array of our int interpolation variables
-	IntInterpolationList m_vpIntInterpolations;
-	IntInterpolationList m_vpCreateIntInterpolations;
+	bool IsValid(const InterpolationHandle& interpolation) const;
+
+	InterpolationHandle CreateInterpolation(float* pFloatVariable, int* pIntVariable, float start, float end, float time, float easing, FunctionCallback callback, void* data);
+	void LinkInterpolation(const InterpolationHandle& first, const InterpolationHandle& second);
+	void AddInterpolation(const InterpolationHandle& interpolation);
+	void FreeInterpolation(int index);
+
+	void StartPendingInterpolations();
+	void RemoveStoppedInterpolations();
+	void UpdateRunningInterpolations(float delta);
+
+	// Pool of the interpolations, the first free slot links to the next through its next handle
+	InterpolationList m_interpolations;
+	int m_firstFreeInterpolation;
+	int m_numInterpolations;
+
+	// Added since the last update, they start on the next one
+	InterpolationHandleList m_pendingInterpolations;
+
+	// The running interpolations side by side, so they are all updated in one pass. The slot is -1 once it has stopped.
+	std::vector<int> m_runningSlots;
+	std::vector<float*> m_runningFloatVariables;
+	std::vector<int*> m_runningIntVariables;
+	std::vector<float> m_runningStarts;
+	std::vector<float> m_runningDifferences;
+	std::vector<float> m_runningEaseControls;
+	std::vector<float> m_runningTimes;
+	std::vector<float> m_runningElapsed;
+	std::vector<float> m_runningValues;
+
+	// Stopped ones still in the running arrays
+	int m_numStoppedInterpolations;
 
 	// Singleton instance
 	static Interpolator *m_instance;
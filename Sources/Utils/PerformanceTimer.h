@@ -0,0 +1,59 @@
+/*************************************************************************
+> File Name: PerformanceTimer.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose: High resolution timer for measuring how long a piece of code takes.
+> Created Time: 2016/08/07
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_PERFORMANCE_TIMER_H
+#define CUBBY_PERFORMANCE_TIMER_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif //_WIN32
+
+class PerformanceTimer
+{
+public:
+	PerformanceTimer()
+	{
+		Start();
+	}
+
+	void Start()
+	{
+		m_startTime = GetCurrentTimeInSeconds();
+	}
+
+	// Elapsed time since Start(), in milliseconds
+	float GetElapsedTime() const
+	{
+		return static_cast<float>((GetCurrentTimeInSeconds() - m_startTime) * 1000.0);
+	}
+
+	static double GetCurrentTimeInSeconds()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER ticks;
+		LARGE_INTEGER ticksPerSecond;
+		QueryPerformanceCounter(&ticks);
+		QueryPerformanceFrequency(&ticksPerSecond);
+
+		return static_cast<double>(ticks.QuadPart) / static_cast<double>(ticksPerSecond.QuadPart);
+#else
+		struct timeval tm;
+		gettimeofday(&tm, nullptr);
+
+		return static_cast<double>(tm.tv_sec) + static_cast<double>(tm.tv_usec) / 1000000.0;
+#endif //_WIN32
+	}
+
+private:
+	double m_startTime;
+};
+
+#endif
@@ -0,0 +1,166 @@
+/*************************************************************************
+> File Name: SimulationLOD.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 How often an entity is simulated, from the distance to the player.
+> 	 Entities near the player update every frame, ones further away run
+> 	 their AI and physics a few times a second with the time gathered in
+> 	 between while still animating and moving on screen every frame, and
+> 	 ones in chunks that are not loaded are parked until woken.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <Blocks/ChunkManager.h>
+
+#include "Random.h"
+#include "SimulationLOD.h"
+
+// Seconds between the ticks of the reduced tier
+const float SIMULATION_REDUCED_TICK_INTERVAL = 0.1f;
+
+// Longest step an entity is ever updated with, so the physics stays stable after a long gap
+const float SIMULATION_MAX_TICK_DELTA_TIME = 0.2f;
+
+// Seconds an entity stays at the full tier after it is woken
+const float SIMULATION_WAKE_TIME = 3.0f;
+
+SimulationStats::SimulationStats()
+{
+	Reset();
+}
+
+void SimulationStats::Reset()
+{
+	for (int i = 0; i < static_cast<int>(SimulationTier::NumTiers); ++i)
+	{
+		m_numEntities[i] = 0;
+		m_updateTime[i] = 0.0f;
+	}
+
+	m_numReducedTicks = 0;
+}
+
+void SimulationStats::Add(const SimulationStats& stats)
+{
+	for (int i = 0; i < static_cast<int>(SimulationTier::NumTiers); ++i)
+	{
+		m_numEntities[i] += stats.m_numEntities[i];
+		m_updateTime[i] += stats.m_updateTime[i];
+	}
+
+	m_numReducedTicks += stats.m_numReducedTicks;
+}
+
+// Constructor, Destructor
+SimulationLOD::SimulationLOD() :
+	m_tier(SimulationTier::Full), m_wakeTimer(0.0f), m_tickDeltaTime(0.0f), m_isTicking(false), m_hasTickPosition(false),
+	m_isChunkChecked(false), m_isChunkLoaded(true), m_chunkLoadVersion(0)
+{
+	// Start somewhere in the interval, so the entities far away don't all tick on the same frame
+	m_tickTimer = GetRandomNumber(0, 100, 0) * 0.01f * SIMULATION_REDUCED_TICK_INTERVAL;
+}
+
+SimulationLOD::~SimulationLOD()
+{
+
+}
+
+void SimulationLOD::Wake()
+{
+	m_wakeTimer = SIMULATION_WAKE_TIME;
+	m_isChunkChecked = false;
+}
+
+void SimulationLOD::Update(float dt, const glm::vec3& position, const glm::vec3& playerPosition, float reducedDistance, ChunkManager* pChunkManager)
+{
+	float distance = length(position - playerPosition);
+
+	if (m_wakeTimer > 0.0f)
+	{
+		m_wakeTimer -= dt;
+		m_tier = SimulationTier::Full;
+		m_isChunkChecked = false;
+	}
+	else if (pChunkManager != nullptr && distance > pChunkManager->GetLoaderRadius())
+	{
+		// The chunk is only looked up again when the loaded chunks have changed
+		unsigned int chunkLoadVersion = pChunkManager->GetChunkLoadVersion();
+		if (m_isChunkChecked == false || chunkLoadVersion != m_chunkLoadVersion)
+		{
+			Chunk* pChunk = pChunkManager->GetChunkFromPosition(position.x, position.y, position.z);
+
+			m_isChunkLoaded = pChunk != nullptr;
+			m_chunkLoadVersion = chunkLoadVersion;
+			m_isChunkChecked = true;
+		}
+
+		m_tier = m_isChunkLoaded ? SimulationTier::Reduced : SimulationTier::Dormant;
+	}
+	else
+	{
+		m_tier = distance > reducedDistance ? SimulationTier::Reduced : SimulationTier::Full;
+		m_isChunkChecked = false;
+	}
+
+	m_isTicking = false;
+
+	if (m_tier == SimulationTier::Dormant)
+	{
+		// Parked with the chunk, no time passes until it is back
+		m_tickTimer = 0.0f;
+		return;
+	}
+
+	m_tickTimer += dt;
+
+	if (m_tier == SimulationTier::Full || m_tickTimer >= SIMULATION_REDUCED_TICK_INTERVAL)
+	{
+		m_tickDeltaTime = m_tickTimer < SIMULATION_MAX_TICK_DELTA_TIME ? m_tickTimer : SIMULATION_MAX_TICK_DELTA_TIME;
+		m_tickTimer = 0.0f;
+		m_isTicking = true;
+	}
+}
+
+SimulationTier SimulationLOD::GetTier() const
+{
+	return m_tier;
+}
+
+bool SimulationLOD::IsAnimating() const
+{
+	return m_tier != SimulationTier::Dormant;
+}
+
+bool SimulationLOD::IsTicking() const
+{
+	return m_isTicking;
+}
+
+float SimulationLOD::GetTickDeltaTime() const
+{
+	return m_tickDeltaTime;
+}
+
+void SimulationLOD::SetTickPosition(const glm::vec3& position)
+{
+	m_previousTickPosition = m_hasTickPosition ? m_tickPosition : position;
+	m_tickPosition = position;
+	m_hasTickPosition = true;
+}
+
+glm::vec3 SimulationLOD::GetRenderPosition(const glm::vec3& position) const
+{
+	if (m_tier != SimulationTier::Reduced || m_hasTickPosition == false)
+	{
+		return position;
+	}
+
+	float tickFraction = m_tickTimer < SIMULATION_REDUCED_TICK_INTERVAL ? m_tickTimer / SIMULATION_REDUCED_TICK_INTERVAL : 1.0f;
+
+	// What is left of the last tick's movement, anything that moved the entity outside of a tick shows straight away
+	return position + (m_previousTickPosition - m_tickPosition) * (1.0f - tickFraction);
+}
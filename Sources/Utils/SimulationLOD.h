@@ -0,0 +1,92 @@
+/*************************************************************************
+> File Name: SimulationLOD.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 How often an entity is simulated, from the distance to the player.
+> 	 Entities near the player update every frame, ones further away run
+> 	 their AI and physics a few times a second with the time gathered in
+> 	 between while still animating and moving on screen every frame, and
+> 	 ones in chunks that are not loaded are parked until woken.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_SIMULATION_LOD_H
+#define CUBBY_SIMULATION_LOD_H
+
+#include <glm/vec3.hpp>
+
+// Forward declaration
+class ChunkManager;
+
+enum class SimulationTier
+{
+	Full = 0,
+	Reduced,
+	Dormant,
+	NumTiers,
+};
+
+// Counts and update times of the entities a manager simulated in the last frame
+struct SimulationStats
+{
+	SimulationStats();
+
+	void Reset();
+	void Add(const SimulationStats& stats);
+
+	int m_numEntities[static_cast<int>(SimulationTier::NumTiers)];
+	// Reduced entities whose tick came up this frame
+	int m_numReducedTicks;
+	// Milliseconds spent updating the entities of each tier
+	float m_updateTime[static_cast<int>(SimulationTier::NumTiers)];
+};
+
+class SimulationLOD
+{
+public:
+	// Constructor, Destructor
+	SimulationLOD();
+	~SimulationLOD();
+
+	// Simulates the entity every frame for a while whatever the distance, on damage, aggro, interaction and the like
+	void Wake();
+
+	// Picks the tier and whether the entity ticks this frame. reducedDistance is how far from the player it stops
+	// updating every frame. Beyond the loader radius it is parked when the chunk it is in is not loaded, and only looked
+	// at again when woken or when a chunk is loaded or unloaded. pChunkManager may be nullptr to never park it.
+	void Update(float dt, const glm::vec3& position, const glm::vec3& playerPosition, float reducedDistance, ChunkManager* pChunkManager);
+
+	SimulationTier GetTier() const;
+	// Not parked, so its animation, lights and effects are updated every frame even when it doesn't tick
+	bool IsAnimating() const;
+	bool IsTicking() const;
+	// The time since the last tick, for the entity to update with
+	float GetTickDeltaTime() const;
+
+	// The entity's position after each of its ticks
+	void SetTickPosition(const glm::vec3& position);
+	// Where to draw the entity at position. A reduced entity is drawn between its last two tick positions, by how far
+	// the next tick has come, so it moves every frame a tick behind instead of jumping a few times a second.
+	glm::vec3 GetRenderPosition(const glm::vec3& position) const;
+
+private:
+	SimulationTier m_tier;
+
+	float m_wakeTimer;
+	float m_tickTimer;
+	float m_tickDeltaTime;
+	bool m_isTicking;
+
+	glm::vec3 m_previousTickPosition;
+	glm::vec3 m_tickPosition;
+	bool m_hasTickPosition;
+
+	// Whether the chunk was loaded when last checked beyond the loader radius, and the chunk load version then
+	bool m_isChunkChecked;
+	bool m_isChunkLoaded;
+	unsigned int m_chunkLoadVersion;
+};
+
+#endif
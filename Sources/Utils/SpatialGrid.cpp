@@ -0,0 +1,437 @@
+/*************************************************************************
+> File Name: SpatialGrid.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A uniform hash grid shared by every moving object in the world, so
+> 	 collision, damage and hover checks only look at the objects in the
+> 	 cells near them instead of the whole list.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <glm/detail/func_geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SpatialGrid.h"
+
+// Cell coordinates are packed into 21 bits each
+const int CELL_COORDINATE_BITS = 21;
+const int CELL_COORDINATE_OFFSET = 1 << (CELL_COORDINATE_BITS - 1);
+const long long CELL_COORDINATE_MASK = (1LL << CELL_COORDINATE_BITS) - 1;
+
+// Constructor, Destructor
+SpatialGrid::SpatialGrid(float cellSize) :
+	m_cellSize(cellSize), m_inverseCellSize(1.0f / cellSize), m_maxRadius(0.0f)
+{
+
+}
+
+SpatialGrid::~SpatialGrid()
+{
+	Clear();
+}
+
+unsigned int SpatialGrid::GetTypeBit(SpatialType type)
+{
+	return 1u << static_cast<unsigned int>(type);
+}
+
+void SpatialGrid::Update(void* pObject, SpatialType type, const glm::vec3& position, float radius)
+{
+	m_maxRadius = std::max(m_maxRadius, radius);
+
+	auto iter = m_objectEntries.find(pObject);
+	if (iter == m_objectEntries.end())
+	{
+		int entryIndex;
+		if (m_freeEntries.empty())
+		{
+			entryIndex = static_cast<int>(m_entries.size());
+			m_entries.push_back(Entry());
+		}
+		else
+		{
+			entryIndex = m_freeEntries.back();
+			m_freeEntries.pop_back();
+		}
+
+		Entry* pEntry = &m_entries[entryIndex];
+		pEntry->m_pObject = pObject;
+		pEntry->m_type = type;
+		pEntry->m_position = position;
+		pEntry->m_radius = radius;
+		pEntry->m_cellKey = GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.y), GetCellCoordinate(position.z));
+
+		AddToCell(entryIndex);
+
+		m_objectEntries[pObject] = entryIndex;
+
+		return;
+	}
+
+	int entryIndex = iter->second;
+	Entry* pEntry = &m_entries[entryIndex];
+	pEntry->m_position = position;
+	pEntry->m_radius = radius;
+
+	long long cellKey = GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.y), GetCellCoordinate(position.z));
+	if (cellKey != pEntry->m_cellKey)
+	{
+		RemoveFromCell(entryIndex);
+		pEntry->m_cellKey = cellKey;
+		AddToCell(entryIndex);
+	}
+}
+
+void SpatialGrid::Remove(void* pObject)
+{
+	auto iter = m_objectEntries.find(pObject);
+	if (iter == m_objectEntries.end())
+	{
+		return;
+	}
+
+	int entryIndex = iter->second;
+	RemoveFromCell(entryIndex);
+
+	m_entries[entryIndex].m_pObject = nullptr;
+	m_freeEntries.push_back(entryIndex);
+
+	m_objectEntries.erase(iter);
+}
+
+void SpatialGrid::Clear()
+{
+	m_entries.clear();
+	m_freeEntries.clear();
+	m_objectEntries.clear();
+	m_cells.clear();
+
+	m_maxRadius = 0.0f;
+}
+
+template <typename Test>
+void SpatialGrid::VisitBox(const glm::vec3& boxMin, const glm::vec3& boxMax, unsigned int typeMask, Test test, std::vector<void*>* pResults) const
+{
+	pResults->clear();
+
+	if (m_objectEntries.empty())
+	{
+		return;
+	}
+
+	int minX = GetCellCoordinate(boxMin.x - m_maxRadius);
+	int minY = GetCellCoordinate(boxMin.y - m_maxRadius);
+	int minZ = GetCellCoordinate(boxMin.z - m_maxRadius);
+	int maxX = GetCellCoordinate(boxMax.x + m_maxRadius);
+	int maxY = GetCellCoordinate(boxMax.y + m_maxRadius);
+	int maxZ = GetCellCoordinate(boxMax.z + m_maxRadius);
+
+	long long numBoxCells = static_cast<long long>(maxX - minX + 1) * (maxY - minY + 1) * (maxZ - minZ + 1);
+
+	if (numBoxCells > static_cast<long long>(m_cells.size()))
+	{
+		// Large queries walk the occupied cells instead of the empty space between them
+		for (auto cellIter = m_cells.begin(); cellIter != m_cells.end(); ++cellIter)
+		{
+			const std::vector<int>& cell = cellIter->second;
+
+			for (size_t i = 0; i < cell.size(); ++i)
+			{
+				const Entry& entry = m_entries[cell[i]];
+
+				if ((GetTypeBit(entry.m_type) & typeMask) != 0 && test(entry))
+				{
+					pResults->push_back(entry.m_pObject);
+				}
+			}
+		}
+
+		return;
+	}
+
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int z = minZ; z <= maxZ; ++z)
+			{
+				auto cellIter = m_cells.find(GetCellKey(x, y, z));
+				if (cellIter == m_cells.end())
+				{
+					continue;
+				}
+
+				const std::vector<int>& cell = cellIter->second;
+
+				for (size_t i = 0; i < cell.size(); ++i)
+				{
+					const Entry& entry = m_entries[cell[i]];
+
+					if ((GetTypeBit(entry.m_type) & typeMask) != 0 && test(entry))
+					{
+						pResults->push_back(entry.m_pObject);
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename Visit>
+void SpatialGrid::VisitCells(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, Visit visit) const
+{
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int z = minZ; z <= maxZ; ++z)
+			{
+				auto cellIter = m_cells.find(GetCellKey(x, y, z));
+				if (cellIter == m_cells.end())
+				{
+					continue;
+				}
+
+				const std::vector<int>& cell = cellIter->second;
+
+				for (size_t i = 0; i < cell.size(); ++i)
+				{
+					visit(m_entries[cell[i]]);
+				}
+			}
+		}
+	}
+}
+
+void SpatialGrid::QueryRadius(const glm::vec3& center, float radius, unsigned int typeMask, std::vector<void*>* pResults) const
+{
+	VisitBox(center - glm::vec3(radius), center + glm::vec3(radius), typeMask, [&center, radius](const Entry& entry)
+	{
+		glm::vec3 toEntry = entry.m_position - center;
+		float reach = radius + entry.m_radius;
+
+		return dot(toEntry, toEntry) <= reach * reach;
+	}, pResults);
+}
+
+void SpatialGrid::QuerySegment(const glm::vec3& start, const glm::vec3& end, float radius, unsigned int typeMask, std::vector<void*>* pResults) const
+{
+	glm::vec3 segment = end - start;
+	float segmentLengthSquared = dot(segment, segment);
+
+	glm::vec3 boxMin = glm::vec3(std::min(start.x, end.x), std::min(start.y, end.y), std::min(start.z, end.z)) - glm::vec3(radius);
+	glm::vec3 boxMax = glm::vec3(std::max(start.x, end.x), std::max(start.y, end.y), std::max(start.z, end.z)) + glm::vec3(radius);
+
+	VisitBox(boxMin, boxMax, typeMask, [&start, &segment, segmentLengthSquared, radius](const Entry& entry)
+	{
+		// Closest point on the segment to the entry
+		float t = 0.0f;
+		if (segmentLengthSquared > 0.0f)
+		{
+			t = std::max(0.0f, std::min(1.0f, dot(entry.m_position - start, segment) / segmentLengthSquared));
+		}
+
+		glm::vec3 toEntry = entry.m_position - (start + segment * t);
+		float reach = radius + entry.m_radius;
+
+		return dot(toEntry, toEntry) <= reach * reach;
+	}, pResults);
+}
+
+void SpatialGrid::QueryCone(const glm::vec3& apex, const glm::vec3& direction, float cosHalfAngle, float range, unsigned int typeMask, std::vector<void*>* pResults) const
+{
+	float halfAngle = std::acos(std::max(-1.0f, std::min(1.0f, cosHalfAngle)));
+
+	VisitBox(apex - glm::vec3(range), apex + glm::vec3(range), typeMask, [&apex, &direction, halfAngle, range](const Entry& entry)
+	{
+		glm::vec3 toEntry = entry.m_position - apex;
+		float distance = length(toEntry);
+
+		if (distance > range + entry.m_radius)
+		{
+			return false;
+		}
+
+		if (distance <= entry.m_radius)
+		{
+			return true;
+		}
+
+		// The sphere reaches into the cone if its center is within the half angle plus the angle the sphere covers
+		float angle = std::acos(std::max(-1.0f, std::min(1.0f, dot(toEntry, direction) / distance)));
+
+		return angle <= halfAngle + std::asin(entry.m_radius / distance);
+	}, pResults);
+}
+
+void* SpatialGrid::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float padding, unsigned int typeMask, SpatialRayFunction rayFunction, void* pRayData, float* pDistance) const
+{
+	void* pNearest = nullptr;
+	float nearestDistance = maxDistance;
+
+	if (m_objectEntries.empty())
+	{
+		return nullptr;
+	}
+
+	auto visit = [&](const Entry& entry)
+	{
+		if ((GetTypeBit(entry.m_type) & typeMask) == 0)
+		{
+			return;
+		}
+
+		glm::vec3 fromEntry = origin - entry.m_position;
+		float reach = entry.m_radius + padding;
+		float b = dot(fromEntry, direction);
+		float c = dot(fromEntry, fromEntry) - reach * reach;
+
+		// Starting outside the sphere and pointing away from it
+		if (c > 0.0f && b > 0.0f)
+		{
+			return;
+		}
+
+		float discriminant = b * b - c;
+		if (discriminant < 0.0f)
+		{
+			return;
+		}
+
+		float distance = std::max(0.0f, -b - std::sqrt(discriminant));
+		if (distance >= nearestDistance)
+		{
+			return;
+		}
+
+		if (rayFunction != nullptr && (rayFunction(pRayData, entry.m_pObject, origin, direction, &distance) == false || distance >= nearestDistance))
+		{
+			return;
+		}
+
+		pNearest = entry.m_pObject;
+		nearestDistance = distance;
+	};
+
+	// A sphere the ray passes through is at most this many cells from the cell the ray is in at that point
+	int reachCells = static_cast<int>(std::ceil((m_maxRadius + padding) * m_inverseCellSize));
+
+	int x = GetCellCoordinate(origin.x);
+	int y = GetCellCoordinate(origin.y);
+	int z = GetCellCoordinate(origin.z);
+
+	int stepX = direction.x < 0.0f ? -1 : 1;
+	int stepY = direction.y < 0.0f ? -1 : 1;
+	int stepZ = direction.z < 0.0f ? -1 : 1;
+
+	// Distance along the ray to the next cell boundary on each axis, and between boundaries
+	float infinity = std::numeric_limits<float>::max();
+	float nextX = direction.x != 0.0f ? ((x + (stepX > 0 ? 1 : 0)) * m_cellSize - origin.x) / direction.x : infinity;
+	float nextY = direction.y != 0.0f ? ((y + (stepY > 0 ? 1 : 0)) * m_cellSize - origin.y) / direction.y : infinity;
+	float nextZ = direction.z != 0.0f ? ((z + (stepZ > 0 ? 1 : 0)) * m_cellSize - origin.z) / direction.z : infinity;
+	float deltaX = direction.x != 0.0f ? m_cellSize / std::abs(direction.x) : infinity;
+	float deltaY = direction.y != 0.0f ? m_cellSize / std::abs(direction.y) : infinity;
+	float deltaZ = direction.z != 0.0f ? m_cellSize / std::abs(direction.z) : infinity;
+
+	VisitCells(x - reachCells, y - reachCells, z - reachCells, x + reachCells, y + reachCells, z + reachCells, visit);
+
+	// Every step only visits the slab of cells that came into reach, so each cell is looked at once.
+	// Any hit nearer than the cell the ray has reached would already have been found.
+	for (;;)
+	{
+		float cellDistance = std::min(nextX, std::min(nextY, nextZ));
+		if (cellDistance > nearestDistance)
+		{
+			break;
+		}
+
+		if (nextX <= nextY && nextX <= nextZ)
+		{
+			x += stepX;
+			nextX += deltaX;
+
+			int slabX = x + stepX * reachCells;
+			VisitCells(slabX, y - reachCells, z - reachCells, slabX, y + reachCells, z + reachCells, visit);
+		}
+		else if (nextY <= nextZ)
+		{
+			y += stepY;
+			nextY += deltaY;
+
+			int slabY = y + stepY * reachCells;
+			VisitCells(x - reachCells, slabY, z - reachCells, x + reachCells, slabY, z + reachCells, visit);
+		}
+		else
+		{
+			z += stepZ;
+			nextZ += deltaZ;
+
+			int slabZ = z + stepZ * reachCells;
+			VisitCells(x - reachCells, y - reachCells, slabZ, x + reachCells, y + reachCells, slabZ, visit);
+		}
+	}
+
+	if (pNearest != nullptr && pDistance != nullptr)
+	{
+		*pDistance = nearestDistance;
+	}
+
+	return pNearest;
+}
+
+int SpatialGrid::GetNumObjects() const
+{
+	return static_cast<int>(m_objectEntries.size());
+}
+
+int SpatialGrid::GetNumCells() const
+{
+	return static_cast<int>(m_cells.size());
+}
+
+long long SpatialGrid::GetCellKey(int x, int y, int z) const
+{
+	long long packedX = (static_cast<long long>(x) + CELL_COORDINATE_OFFSET) & CELL_COORDINATE_MASK;
+	long long packedY = (static_cast<long long>(y) + CELL_COORDINATE_OFFSET) & CELL_COORDINATE_MASK;
+	long long packedZ = (static_cast<long long>(z) + CELL_COORDINATE_OFFSET) & CELL_COORDINATE_MASK;
+
+	return (packedX << (CELL_COORDINATE_BITS * 2)) | (packedY << CELL_COORDINATE_BITS) | packedZ;
+}
+
+int SpatialGrid::GetCellCoordinate(float value) const
+{
+	return static_cast<int>(std::floor(value * m_inverseCellSize));
+}
+
+void SpatialGrid::AddToCell(int entryIndex)
+{
+	Entry* pEntry = &m_entries[entryIndex];
+
+	std::vector<int>& cell = m_cells[pEntry->m_cellKey];
+	pEntry->m_cellSlot = static_cast<int>(cell.size());
+	cell.push_back(entryIndex);
+}
+
+void SpatialGrid::RemoveFromCell(int entryIndex)
+{
+	Entry* pEntry = &m_entries[entryIndex];
+
+	auto cellIter = m_cells.find(pEntry->m_cellKey);
+	std::vector<int>& cell = cellIter->second;
+
+	// Move the last entry of the cell into the gap
+	int movedEntryIndex = cell.back();
+	cell[pEntry->m_cellSlot] = movedEntryIndex;
+	m_entries[movedEntryIndex].m_cellSlot = pEntry->m_cellSlot;
+	cell.pop_back();
+
+	if (cell.empty())
+	{
+		m_cells.erase(cellIter);
+	}
+}
@@ -0,0 +1,101 @@
+/*************************************************************************
+> File Name: SpatialGrid.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A uniform hash grid shared by every moving object in the world, so
+> 	 collision, damage and hover checks only look at the objects in the
+> 	 cells near them instead of the whole list.
+> Created Time: 2016/09/17
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_SPATIAL_GRID_H
+#define CUBBY_SPATIAL_GRID_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+enum class SpatialType
+{
+	Player = 0,
+	NPC,
+	Enemy,
+	Item,
+	Projectile,
+};
+
+// Refines a QueryRay hit against the object's own shape, which must lie inside its sphere. pDistance comes in as the distance
+// where the ray enters the sphere and goes out as the distance to the shape. Returns false when the ray misses the shape.
+using SpatialRayFunction = bool(*)(void* pData, void* pObject, const glm::vec3& origin, const glm::vec3& direction, float* pDistance);
+
+class SpatialGrid
+{
+public:
+	// Constructor, Destructor
+	SpatialGrid(float cellSize = 4.0f);
+	~SpatialGrid();
+
+	static unsigned int GetTypeBit(SpatialType type);
+
+	// Adds the object the first time it is seen, afterwards only moves it to a new cell when it crosses into one
+	void Update(void* pObject, SpatialType type, const glm::vec3& position, float radius);
+	void Remove(void* pObject);
+	void Clear();
+
+	// Queries fill pResults with the objects of the types in typeMask whose spheres touch the query shape.
+	// The shape test is against each object's own radius, callers still do their exact test on the results.
+	void QueryRadius(const glm::vec3& center, float radius, unsigned int typeMask, std::vector<void*>* pResults) const;
+	void QuerySegment(const glm::vec3& start, const glm::vec3& end, float radius, unsigned int typeMask, std::vector<void*>* pResults) const;
+	// direction must be normalized, the cone spreads acos(cosHalfAngle) either side of it
+	void QueryCone(const glm::vec3& apex, const glm::vec3& direction, float cosHalfAngle, float range, unsigned int typeMask, std::vector<void*>* pResults) const;
+
+	// The nearest object of the types in typeMask whose sphere, grown by padding, the ray hits within maxDistance, or nullptr.
+	// Walks the cells along the ray in order and stops at the first hit, so the cost depends on the distance to it and not on the
+	// number of objects. direction must be normalized, rayFunction may be nullptr to stop at the spheres.
+	void* QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float padding, unsigned int typeMask, SpatialRayFunction rayFunction, void* pRayData, float* pDistance) const;
+
+	int GetNumObjects() const;
+	int GetNumCells() const;
+
+private:
+	struct Entry
+	{
+		void* m_pObject;
+		SpatialType m_type;
+		glm::vec3 m_position;
+		float m_radius;
+		long long m_cellKey;
+		// Index into the cell's entry list
+		int m_cellSlot;
+	};
+
+	long long GetCellKey(int x, int y, int z) const;
+	int GetCellCoordinate(float value) const;
+
+	void AddToCell(int entryIndex);
+	void RemoveFromCell(int entryIndex);
+
+	// Calls test on every entry in the cells overlapping the box, or on every entry when that is fewer cells to visit
+	template <typename Test>
+	void VisitBox(const glm::vec3& boxMin, const glm::vec3& boxMax, unsigned int typeMask, Test test, std::vector<void*>* pResults) const;
+
+	// Calls visit on every entry in the cells from min to max inclusive
+	template <typename Visit>
+	void VisitCells(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, Visit visit) const;
+
+	float m_cellSize;
+	float m_inverseCellSize;
+
+	// Objects are only stored in the cell their position is in, so queries are padded by the largest radius seen
+	float m_maxRadius;
+
+	std::vector<Entry> m_entries;
+	std::vector<int> m_freeEntries;
+	std::unordered_map<void*, int> m_objectEntries;
+	std::unordered_map<long long, std::vector<int>> m_cells;
+};
+
+#endif
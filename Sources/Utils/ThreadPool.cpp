@@ -0,0 +1,200 @@
+/*************************************************************************
+> File Name: ThreadPool.cpp
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A small pool of persistent worker threads, used to split per-frame
+> 	 work into ranges that are processed in parallel. The calling thread
+> 	 also works on the ranges and returns once every range is done.
+> Created Time: 2016/08/07
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+// Initialize the singleton instance
+ThreadPool* ThreadPool::m_instance = nullptr;
+
+ThreadPool* ThreadPool::GetInstance()
+{
+	if (m_instance == nullptr)
+	{
+		m_instance = new ThreadPool;
+	}
+
+	return m_instance;
+}
+
+void ThreadPool::Destroy()
+{
+	if (m_instance)
+	{
+		m_jobMutex.lock();
+		m_isRunning = false;
+		m_jobCondition.notify_all();
+		m_jobMutex.unlock();
+
+		for (size_t i = 0; i < m_vpWorkerThreads.size(); ++i)
+		{
+			m_vpWorkerThreads[i]->join();
+			delete m_vpWorkerThreads[i];
+			m_vpWorkerThreads[i] = nullptr;
+		}
+		m_vpWorkerThreads.clear();
+
+		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+ThreadPool::ThreadPool() :
+	m_isRunning(true),
+	m_jobFunction(nullptr), m_pJobData(nullptr), m_jobCount(0), m_jobGrainSize(1),
+	m_jobGeneration(0), m_numActiveWorkers(0), m_numJobWorkers(0), m_maxJobWorkers(0),
+	m_nextJobIndex(0), m_numJobItemsRemaining(0)
+{
+	// Leave one hardware thread for the main thread, which also takes part in every job
+	int numHardwareThreads = static_cast<int>(tthread::thread::hardware_concurrency());
+	int numWorkerThreads = std::max(numHardwareThreads - 1, 0);
+
+	for (int i = 0; i < numWorkerThreads; ++i)
+	{
+		m_vpWorkerThreads.push_back(new tthread::thread(_WorkerThread, this));
+	}
+
+	m_maxJobWorkers = numWorkerThreads;
+}
+
+int ThreadPool::GetNumThreads() const
+{
+	return static_cast<int>(m_vpWorkerThreads.size()) + 1;
+}
+
+void ThreadPool::SetMaxThreads(int maxThreads)
+{
+	m_jobMutex.lock();
+	m_maxJobWorkers = std::max(0, std::min(maxThreads - 1, static_cast<int>(m_vpWorkerThreads.size())));
+	m_jobMutex.unlock();
+}
+
+int ThreadPool::GetMaxThreads() const
+{
+	return m_maxJobWorkers + 1;
+}
+
+void ThreadPool::ParallelFor(int count, int grainSize, ThreadPoolJobFunction function, void* pData)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	grainSize = std::max(grainSize, 1);
+
+	// Not worth waking the workers up
+	if (count <= grainSize || m_maxJobWorkers == 0)
+	{
+		function(pData, 0, count);
+		return;
+	}
+
+	m_jobMutex.lock();
+
+	// A worker that woke up late for the previous job may still be leaving RunJob()
+	while (m_numActiveWorkers > 0)
+	{
+		m_jobFinishedCondition.wait(m_jobMutex);
+	}
+
+	m_jobFunction = function;
+	m_pJobData = pData;
+	m_jobCount = count;
+	m_jobGrainSize = grainSize;
+	m_nextJobIndex = 0;
+	m_numJobItemsRemaining = count;
+	m_numJobWorkers = 0;
+	m_jobGeneration++;
+
+	m_jobCondition.notify_all();
+	m_jobMutex.unlock();
+
+	RunJob();
+
+	m_jobMutex.lock();
+	while (m_numJobItemsRemaining > 0 || m_numActiveWorkers > 0)
+	{
+		m_jobFinishedCondition.wait(m_jobMutex);
+	}
+	m_jobMutex.unlock();
+}
+
+void ThreadPool::_WorkerThread(void* pData)
+{
+	ThreadPool* pThreadPool = static_cast<ThreadPool*>(pData);
+	pThreadPool->WorkerThread();
+}
+
+void ThreadPool::WorkerThread()
+{
+	unsigned int lastGeneration = 0;
+
+	while (true)
+	{
+		m_jobMutex.lock();
+		while (m_isRunning && m_jobGeneration == lastGeneration)
+		{
+			m_jobCondition.wait(m_jobMutex);
+		}
+
+		if (m_isRunning == false)
+		{
+			m_jobMutex.unlock();
+			break;
+		}
+
+		lastGeneration = m_jobGeneration;
+
+		// Sit this job out if enough workers have already joined it
+		if (m_numJobWorkers >= m_maxJobWorkers)
+		{
+			m_jobMutex.unlock();
+			continue;
+		}
+
+		m_numJobWorkers++;
+		m_numActiveWorkers++;
+		m_jobMutex.unlock();
+
+		RunJob();
+
+		m_jobMutex.lock();
+		m_numActiveWorkers--;
+		m_jobFinishedCondition.notify_all();
+		m_jobMutex.unlock();
+	}
+}
+
+void ThreadPool::RunJob()
+{
+	while (true)
+	{
+		int begin = m_nextJobIndex.fetch_add(m_jobGrainSize);
+		if (begin >= m_jobCount)
+		{
+			break;
+		}
+
+		int end = std::min(begin + m_jobGrainSize, m_jobCount);
+		m_jobFunction(m_pJobData, begin, end);
+
+		// The last range to finish wakes up the calling thread
+		if (m_numJobItemsRemaining.fetch_sub(end - begin) == end - begin)
+		{
+			m_jobMutex.lock();
+			m_jobFinishedCondition.notify_all();
+			m_jobMutex.unlock();
+		}
+	}
+}
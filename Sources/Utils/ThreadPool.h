@@ -0,0 +1,74 @@
+/*************************************************************************
+> File Name: ThreadPool.h
+> Project Name: Cubby
+> Author: Chan-Ho Chris Ohk
+> Purpose
+> 	 A small pool of persistent worker threads, used to split per-frame
+> 	 work into ranges that are processed in parallel. The calling thread
+> 	 also works on the ranges and returns once every range is done.
+> Created Time: 2016/08/07
+> Copyright (c) 2016, Chan-Ho Chris Ohk
+*************************************************************************/
+
+#ifndef CUBBY_THREAD_POOL_H
+#define CUBBY_THREAD_POOL_H
+
+#include <atomic>
+#include <vector>
+
+#include <tinythread/tinythread.h>
+
+// Processes the items [begin, end) of a parallel job
+using ThreadPoolJobFunction = void(*)(void* pData, int begin, int end);
+
+class ThreadPool
+{
+public:
+	static ThreadPool* GetInstance();
+	void Destroy();
+
+	int GetNumThreads() const;
+
+	// Limits how many threads, the calling thread included, work on each job. Used to measure scaling.
+	void SetMaxThreads(int maxThreads);
+	int GetMaxThreads() const;
+
+	// Runs function over [0, count) in ranges of grainSize items, blocks until all ranges are processed
+	void ParallelFor(int count, int grainSize, ThreadPoolJobFunction function, void* pData);
+
+private:
+	ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	static void _WorkerThread(void* pData);
+	void WorkerThread();
+
+	void RunJob();
+
+	std::vector<tthread::thread*> m_vpWorkerThreads;
+	tthread::mutex m_jobMutex;
+	tthread::condition_variable m_jobCondition;
+	tthread::condition_variable m_jobFinishedCondition;
+	bool m_isRunning;
+
+	// Current job, only changed while no worker is inside RunJob()
+	ThreadPoolJobFunction m_jobFunction;
+	void* m_pJobData;
+	int m_jobCount;
+	int m_jobGrainSize;
+	unsigned int m_jobGeneration;
+	int m_numActiveWorkers;
+	// Workers that joined the current job, and how many are allowed to
+	int m_numJobWorkers;
+	int m_maxJobWorkers;
+	std::atomic<int> m_nextJobIndex;
+	std::atomic<int> m_numJobItemsRemaining;
+
+	// Singleton instance
+	static ThreadPool* m_instance;
+};
+
+#endif
@@ -10,13 +10,26 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
-#include <algorithm>
+#include <cmath>
 
 #include "TimeManager.h"
 
+// Ticks of the countdown timer wheel in a second, the finest a timer is scheduled at
+const double COUNTDOWN_TIMER_TICKS_PER_SECOND = 1000.0;
+
 // Initialize the singleton instance
 TimeManager* TimeManager::m_instance = nullptr;
 
+TimeManager::TimeManager() :
+	m_firstFreeCountdownTimer(-1), m_numCountdownTimers(0), m_numScheduledCountdownTimers(0),
+	m_time(0.0), m_currentTick(0), m_nextTick(1)
+{
+	for (int i = 0; i < WHEEL_NUM_LEVELS * WHEEL_NUM_BUCKETS + 1; ++i)
+	{
+		m_wheelBuckets[i] = -1;
+	}
+}
+
 TimeManager* TimeManager::GetInstance()
 {
 	if (m_instance == nullptr)
@@ -31,44 +44,362 @@ void TimeManager::Destroy()
 {
 	if (m_instance)
 	{
-		for (size_t i = 0; i < m_vpCountdownTimers.size(); ++i)
-		{
-			delete m_vpCountdownTimers[i];
-			m_vpCountdownTimers[i] = nullptr;
-		}
-
-		m_vpCountdownTimers.clear();
+		m_countdownTimerSlots.clear();
 
 		delete m_instance;
+		m_instance = nullptr;
+	}
+}
+
+CountdownTimerHandle TimeManager::CreateCountdownTimer()
+{
+	int index;
+
+	if (m_firstFreeCountdownTimer != -1)
+	{
+		index = m_firstFreeCountdownTimer;
+		m_firstFreeCountdownTimer = m_countdownTimerSlots[index].m_next;
+	}
+	else
+	{
+		index = static_cast<int>(m_countdownTimerSlots.size());
+		m_countdownTimerSlots.push_back(CountdownTimerSlot());
+		m_countdownTimerSlots[index].m_generation = 0;
+	}
+
+	CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+	pSlot->m_isAlive = true;
+	pSlot->m_dueTick = 0;
+	pSlot->m_bucket = -1;
+	pSlot->m_previous = -1;
+	pSlot->m_next = -1;
+
+	CountdownTimerState* pState = &pSlot->m_state;
+	pState->m_timeOutTime = 0.0f;
+	pState->m_elapsedTime = 0.0f;
+	pState->m_startTime = m_time;
+	pState->m_started = false;
+	pState->m_looping = false;
+	pState->m_paused = true;
+	pState->m_finished = false;
+	pState->m_callback = nullptr;
+	pState->m_pCallbackData = nullptr;
+
+	m_numCountdownTimers++;
+
+	CountdownTimerHandle handle;
+	handle.m_index = index;
+	handle.m_generation = pSlot->m_generation;
+
+	return handle;
+}
+
+void TimeManager::DestroyCountdownTimer(const CountdownTimerHandle& handle)
+{
+	if (IsValid(handle) == false)
+	{
+		return;
 	}
+
+	FreeCountdownTimer(handle.m_index);
+}
+
+CountdownTimerState* TimeManager::GetCountdownTimer(const CountdownTimerHandle& handle)
+{
+	if (IsValid(handle) == false)
+	{
+		return nullptr;
+	}
+
+	return &m_countdownTimerSlots[handle.m_index].m_state;
+}
+
+const CountdownTimerState* TimeManager::GetCountdownTimer(const CountdownTimerHandle& handle) const
+{
+	if (IsValid(handle) == false)
+	{
+		return nullptr;
+	}
+
+	return &m_countdownTimerSlots[handle.m_index].m_state;
+}
+
+void TimeManager::RescheduleCountdownTimer(const CountdownTimerHandle& handle)
+{
+	if (IsValid(handle) == false)
+	{
+		return;
+	}
+
+	ScheduleCountdownTimer(handle.m_index);
 }
 
 bool TimeManager::HasCountdownTimers() const
 {
-	return m_vpCountdownTimers.size() > 0;
+	return m_numCountdownTimers > 0;
 }
 
-void TimeManager::AddCountdownTimer(CountdownTimer* countdownTimer)
+int TimeManager::GetNumCountdownTimers() const
 {
-	m_vpCountdownTimers.push_back(countdownTimer);
+	return m_numCountdownTimers;
 }
 
-void TimeManager::RemoveCountdownTimer(CountdownTimer* countdownTimer)
+int TimeManager::GetNumScheduledCountdownTimers() const
 {
-	m_vpCountdownTimers.erase(remove(m_vpCountdownTimers.begin(), m_vpCountdownTimers.end(), countdownTimer), m_vpCountdownTimers.end());
+	return m_numScheduledCountdownTimers;
 }
 
 void TimeManager::RemoveCountdownTimers()
 {
-	m_vpCountdownTimers.clear();
+	for (size_t i = 0; i < m_countdownTimerSlots.size(); ++i)
+	{
+		if (m_countdownTimerSlots[i].m_isAlive)
+		{
+			FreeCountdownTimer(static_cast<int>(i));
+		}
+	}
+}
+
+double TimeManager::GetTime() const
+{
+	return m_time;
 }
 
 // Update
 void TimeManager::Update(float dt)
 {
-	// Also update all our countdown timers
-	for (auto iter = m_vpCountdownTimers.begin(); iter != m_vpCountdownTimers.end(); ++iter)
+	m_time += dt;
+	m_currentTick = static_cast<unsigned long long>(std::floor(m_time * COUNTDOWN_TIMER_TICKS_PER_SECOND));
+
+	// Go through the buckets of the ticks this frame covers, only the timers in them are due
+	while (m_nextTick <= m_currentTick)
+	{
+		if (m_numScheduledCountdownTimers == 0)
+		{
+			m_nextTick = m_currentTick + 1;
+			break;
+		}
+
+		unsigned long long tick = m_nextTick;
+
+		// Bring the timers of the higher levels down as the wheel comes round to their bucket
+		for (int level = 1; level < WHEEL_NUM_LEVELS; ++level)
+		{
+			int shift = WHEEL_BUCKET_BITS * level;
+			if ((tick & ((1ULL << shift) - 1)) != 0)
+			{
+				break;
+			}
+
+			CascadeBucket(level * WHEEL_NUM_BUCKETS + static_cast<int>((tick >> shift) & (WHEEL_NUM_BUCKETS - 1)));
+		}
+
+		m_nextTick = tick + 1;
+
+		// Move the bucket to the firing list, so the timers the callbacks start or destroy never touch the list being gone through
+		int firingBucket = WHEEL_NUM_LEVELS * WHEEL_NUM_BUCKETS;
+		int bucket = static_cast<int>(tick & (WHEEL_NUM_BUCKETS - 1));
+
+		m_wheelBuckets[firingBucket] = m_wheelBuckets[bucket];
+		m_wheelBuckets[bucket] = -1;
+
+		for (int index = m_wheelBuckets[firingBucket]; index != -1; index = m_countdownTimerSlots[index].m_next)
+		{
+			m_countdownTimerSlots[index].m_bucket = firingBucket;
+		}
+
+		while (m_wheelBuckets[firingBucket] != -1)
+		{
+			int index = m_wheelBuckets[firingBucket];
+			UnlinkCountdownTimer(index);
+
+			CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+
+			// Further away than the wheel reaches, it waited in the last level and goes round again
+			if (pSlot->m_dueTick > tick)
+			{
+				LinkCountdownTimer(index, pSlot->m_dueTick);
+				continue;
+			}
+
+			// Done before the callback, which may change or destroy the timer, and create others that move the pool
+			CountdownTimerState* pState = &pSlot->m_state;
+			std::function<void(void*)> callback = pState->m_callback;
+			void* pCallbackData = pState->m_pCallbackData;
+
+			if (pState->m_looping)
+			{
+				// If we are a looping timer, then the countdown starts again from this frame
+				if (pState->m_paused)
+				{
+					pState->m_elapsedTime = 0.0f;
+				}
+				else
+				{
+					pState->m_startTime = m_time;
+				}
+
+				ScheduleCountdownTimer(index);
+			}
+			else
+			{
+				// We are not looping, so set our finished flag
+				pState->m_finished = true;
+			}
+
+			// We have reached our countdown time, call our function callback
+			if (callback)
+			{
+				callback(pCallbackData);
+			}
+		}
+	}
+}
+
+bool TimeManager::IsValid(const CountdownTimerHandle& handle) const
+{
+	if (handle.m_index < 0 || handle.m_index >= static_cast<int>(m_countdownTimerSlots.size()))
+	{
+		return false;
+	}
+
+	const CountdownTimerSlot& slot = m_countdownTimerSlots[handle.m_index];
+
+	return slot.m_isAlive && slot.m_generation == handle.m_generation;
+}
+
+void TimeManager::FreeCountdownTimer(int index)
+{
+	CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+
+	if (pSlot->m_bucket != -1)
+	{
+		UnlinkCountdownTimer(index);
+	}
+
+	pSlot->m_state.m_callback = nullptr;
+	pSlot->m_isAlive = false;
+	pSlot->m_generation++;
+
+	pSlot->m_next = m_firstFreeCountdownTimer;
+	m_firstFreeCountdownTimer = index;
+
+	m_numCountdownTimers--;
+}
+
+void TimeManager::ScheduleCountdownTimer(int index)
+{
+	CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+
+	if (pSlot->m_bucket != -1)
+	{
+		UnlinkCountdownTimer(index);
+	}
+
+	const CountdownTimerState& state = pSlot->m_state;
+	if (state.m_started == false || state.m_finished)
+	{
+		return;
+	}
+
+	// A paused timer doesn't count down, but still fires once its countdown time is lowered to what has already elapsed
+	if (state.m_paused)
 	{
-		(*iter)->UpdateCountdown(dt);
+		if (state.m_elapsedTime >= state.m_timeOutTime)
+		{
+			LinkCountdownTimer(index, m_currentTick + 1);
+		}
+
+		return;
+	}
+
+	double dueTime = state.m_startTime + state.m_timeOutTime;
+	double dueTickTime = std::ceil(dueTime * COUNTDOWN_TIMER_TICKS_PER_SECOND);
+
+	// Never this frame, a timer started from a callback fires on the next update at the earliest
+	unsigned long long dueTick = m_currentTick + 1;
+	if (dueTickTime > static_cast<double>(dueTick))
+	{
+		dueTick = static_cast<unsigned long long>(dueTickTime);
+	}
+
+	LinkCountdownTimer(index, dueTick);
+}
+
+void TimeManager::LinkCountdownTimer(int index, unsigned long long dueTick)
+{
+	CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+	pSlot->m_dueTick = dueTick;
+
+	// The level is from how far away the tick is, the bucket in it from the tick itself
+	unsigned long long placeTick = dueTick;
+	unsigned long long maxDelta = (1ULL << (WHEEL_BUCKET_BITS * WHEEL_NUM_LEVELS)) - 1;
+	if (placeTick - m_nextTick > maxDelta)
+	{
+		placeTick = m_nextTick + maxDelta;
+	}
+
+	int level = 0;
+	while (level < WHEEL_NUM_LEVELS - 1 && placeTick - m_nextTick >= (1ULL << (WHEEL_BUCKET_BITS * (level + 1))))
+	{
+		level++;
+	}
+
+	int bucket = level * WHEEL_NUM_BUCKETS + static_cast<int>((placeTick >> (WHEEL_BUCKET_BITS * level)) & (WHEEL_NUM_BUCKETS - 1));
+
+	pSlot->m_bucket = bucket;
+	pSlot->m_previous = -1;
+	pSlot->m_next = m_wheelBuckets[bucket];
+
+	if (m_wheelBuckets[bucket] != -1)
+	{
+		m_countdownTimerSlots[m_wheelBuckets[bucket]].m_previous = index;
+	}
+
+	m_wheelBuckets[bucket] = index;
+
+	m_numScheduledCountdownTimers++;
+}
+
+void TimeManager::UnlinkCountdownTimer(int index)
+{
+	CountdownTimerSlot* pSlot = &m_countdownTimerSlots[index];
+
+	if (pSlot->m_previous != -1)
+	{
+		m_countdownTimerSlots[pSlot->m_previous].m_next = pSlot->m_next;
+	}
+	else
+	{
+		m_wheelBuckets[pSlot->m_bucket] = pSlot->m_next;
+	}
+
+	if (pSlot->m_next != -1)
+	{
+		m_countdownTimerSlots[pSlot->m_next].m_previous = pSlot->m_previous;
+	}
+
+	pSlot->m_bucket = -1;
+	pSlot->m_previous = -1;
+	pSlot->m_next = -1;
+
+	m_numScheduledCountdownTimers--;
+}
+
+void TimeManager::CascadeBucket(int bucket)
+{
+	int index = m_wheelBuckets[bucket];
+	m_wheelBuckets[bucket] = -1;
+
+	while (index != -1)
+	{
+		int next = m_countdownTimerSlots[index].m_next;
+
+		m_countdownTimerSlots[index].m_bucket = -1;
+		m_numScheduledCountdownTimers--;
+
+		LinkCountdownTimer(index, m_countdownTimerSlots[index].m_dueTick);
+
+		index = next;
 	}
 }
\ No newline at end of file
@@ -17,31 +17,99 @@
 
 #include "CountdownTimer.h"
 
-using CountdownTimerList = std::vector<CountdownTimer*>;
+// What a countdown timer is set to, kept in the time manager's pool
+struct CountdownTimerState
+{
+	float m_timeOutTime;
+
+	// The elapsed time while paused or not started, otherwise the time the countdown started from
+	float m_elapsedTime;
+	double m_startTime;
+
+	bool m_started;
+	bool m_looping;
+	bool m_paused;
+	bool m_finished;
+
+	std::function<void(void*)> m_callback;
+	void* m_pCallbackData;
+};
 
 class TimeManager
 {
 public:
+	// A manager of its own keeps its timers and time apart from the game's, as the benchmarks need
+	TimeManager();
+
 	static TimeManager* GetInstance();
 	void Destroy();
 
+	// Countdown timers. The state is nullptr for a handle whose timer has been destroyed, and
+	// only stays valid until the next timer is created.
+	CountdownTimerHandle CreateCountdownTimer();
+	void DestroyCountdownTimer(const CountdownTimerHandle& handle);
+	CountdownTimerState* GetCountdownTimer(const CountdownTimerHandle& handle);
+	const CountdownTimerState* GetCountdownTimer(const CountdownTimerHandle& handle) const;
+	// Puts the timer on the wheel at the time it is due, or takes it off when it is not counting down, after its state was changed
+	void RescheduleCountdownTimer(const CountdownTimerHandle& handle);
 	bool HasCountdownTimers() const;
-	void AddCountdownTimer(CountdownTimer* countdownTimer);
-	void RemoveCountdownTimer(CountdownTimer* countdownTimer);
+	int GetNumCountdownTimers() const;
+	int GetNumScheduledCountdownTimers() const;
 	void RemoveCountdownTimers();
 
+	// Seconds the countdown timers have been updated for
+	double GetTime() const;
+
 	// Update
 	void Update(float dt);
 
 private:
-	TimeManager() = default;
 	TimeManager(const TimeManager&) = delete;
 	TimeManager(TimeManager&&) = delete;
 	TimeManager& operator=(const TimeManager&) = delete;
 	TimeManager& operator=(TimeManager&&) = delete;
 
-	// A dynamic array of our countdown timers
-	CountdownTimerList m_vpCountdownTimers;
+	struct CountdownTimerSlot
+	{
+		CountdownTimerState m_state;
+		unsigned int m_generation;
+		bool m_isAlive;
+
+		// The tick the timer fires on, and the wheel bucket it is in, -1 when it isn't on the wheel
+		unsigned long long m_dueTick;
+		int m_bucket;
+
+		// Links of the bucket's list, or of the free list
+		int m_previous;
+		int m_next;
+	};
+
+	bool IsValid(const CountdownTimerHandle& handle) const;
+
+	void FreeCountdownTimer(int index);
+	void ScheduleCountdownTimer(int index);
+	void LinkCountdownTimer(int index, unsigned long long dueTick);
+	void UnlinkCountdownTimer(int index);
+	void CascadeBucket(int bucket);
+
+	// Each level of the wheel has this many buckets, and a bucket of a level spans all the buckets of the level below
+	static const int WHEEL_BUCKET_BITS = 8;
+	static const int WHEEL_NUM_BUCKETS = 1 << WHEEL_BUCKET_BITS;
+	static const int WHEEL_NUM_LEVELS = 4;
+
+	// Pool of the countdown timers, the first free slot links to the next
+	std::vector<CountdownTimerSlot> m_countdownTimerSlots;
+	int m_firstFreeCountdownTimer;
+	int m_numCountdownTimers;
+	int m_numScheduledCountdownTimers;
+
+	// First timer of each bucket of the wheel and of the timers firing this tick, -1 when empty
+	int m_wheelBuckets[WHEEL_NUM_LEVELS * WHEEL_NUM_BUCKETS + 1];
+
+	double m_time;
+	// The tick m_time is in, and the next tick whose bucket the wheel goes through
+	unsigned long long m_currentTick;
+	unsigned long long m_nextTick;
 
 	// Singleton instance
 	static TimeManager* m_instance;
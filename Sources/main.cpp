@@ -10,6 +10,10 @@
 > Copyright (c) 2016, Chan-Ho Chris Ohk
 *************************************************************************/
 
+#include <cstring>
+
+#include <Utils/AssetPack.h>
+
 #include "CubbyGame.h"
 
 #if defined(WIN32) || defined(_WIN32)
@@ -20,8 +24,15 @@ extern "C" { int NvOptimusEnablement = 1; }
 extern "C" { int AmdPowerXpressRequestHighPerformance = 1; }
 #endif
 
-int main()
+int main(int argc, char* argv[])
 {
+	// "Cubby -bakepack" rebuilds the asset pack from the loose gamedata files and exits
+	if (argc > 1 && strcmp(argv[1], "-bakepack") == 0)
+	{
+		bool isBaked = AssetPack::Bake("Resources/gamedata", "Resources/gamedata.pack");
+		exit(isBaked ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
 	// Load the settings
 	CubbySettings* pCubbySettings = new CubbySettings();
 	pCubbySettings->LoadSettings();